@@ -4,6 +4,7 @@
 #include <stdio.h>
 
 #include "device/device.h"
+#include "scene/binary.h"
 #include "scene/camera.h"
 #include "scene/integrator.h"
 #include "scene/scene.h"
@@ -47,6 +48,7 @@ struct Options {
   bool quiet;
   bool show_help, interactive, pause;
   string output_filepath;
+  string binary_filepath;
   string output_pass;
 } options;
 
@@ -98,14 +100,20 @@ static void scene_init()
 {
   options.scene = options.session->scene;
 
-  /* Read XML or USD */
+  /* Read XML, binary or USD */
+  const string filepath_lower = string_to_lower(options.filepath);
+  if (string_endswith(filepath_lower, ".cyb")) {
+    if (!scene_read_binary(options.scene, options.filepath)) {
+      fprintf(stderr, "Failed to read scene from %s\n", options.filepath.c_str());
+      exit(EXIT_FAILURE);
+    }
+  }
 #ifdef WITH_USD
-  if (!string_endswith(string_to_lower(options.filepath), ".xml")) {
+  else if (!string_endswith(filepath_lower, ".xml")) {
     HD_CYCLES_NS::HdCyclesFileReader::read(options.session, options.filepath.c_str());
   }
-  else
 #endif
-  {
+  else {
     xml_read_file(options.scene, options.filepath.c_str());
   }
 
@@ -121,6 +129,11 @@ static void scene_init()
 
   /* Calculate Viewplane */
   options.scene->camera->compute_auto_viewplane();
+
+  /* Convert to binary, before rendering modifies the shader graphs. */
+  if (!options.binary_filepath.empty()) {
+    scene_write_binary(options.scene, options.binary_filepath);
+  }
 }
 
 static void session_init()
@@ -150,10 +163,12 @@ static void session_init()
   /* load scene */
   scene_init();
 
-  /* add pass for output. */
-  Pass *pass = options.scene->create_node<Pass>();
-  pass->set_name(ustring(options.output_pass.c_str()));
-  pass->set_type(PASS_COMBINED);
+  /* add pass for output, unless the scene file has it already. */
+  if (!Pass::find(options.scene->passes, options.output_pass)) {
+    Pass *pass = options.scene->create_node<Pass>();
+    pass->set_name(ustring(options.output_pass.c_str()));
+    pass->set_type(PASS_COMBINED);
+  }
 
   options.session->reset(options.session_params, session_buffer_params());
   options.session->start();
@@ -384,7 +399,7 @@ static void options_parse(int argc, const char **argv)
   bool help = false, profile = false, debug = false, version = false;
   int verbosity = 1;
 
-  ap.options("Usage: cycles [options] file.xml",
+  ap.options("Usage: cycles [options] file.xml|file.cyb",
              "%*",
              files_parse,
              "",
@@ -408,9 +423,15 @@ static void options_parse(int argc, const char **argv)
              "--output %s",
              &options.output_filepath,
              "File path to write output image",
+             "--write-binary %s",
+             &options.binary_filepath,
+             "File path to write the scene to in binary format, for faster loading",
              "--threads %d",
              &options.session_params.threads,
              "CPU Rendering Threads",
+             "--numa",
+             &options.session_params.use_numa,
+             "Split CPU rendering into one work per NUMA node",
              "--width  %d",
              &options.width,
              "Window width in pixel",
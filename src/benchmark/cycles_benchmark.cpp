@@ -0,0 +1,382 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+/* Benchmark suite which renders a set of canonical procedural scenes and writes timing and
+ * memory measurements as JSON, optionally comparing them against results of a previous run. */
+
+#include <stdio.h>
+
+#include "device/device.h"
+#include "scene/camera.h"
+#include "scene/film.h"
+#include "scene/integrator.h"
+#include "scene/pass.h"
+#include "scene/scene.h"
+#include "scene/stats.h"
+#include "session/buffers.h"
+#include "session/session.h"
+
+#include "util/args.h"
+#include "util/foreach.h"
+#include "util/guarded_allocator.h"
+#include "util/log.h"
+#include "util/path.h"
+#include "util/string.h"
+#include "util/version.h"
+
+#include "benchmark/report.h"
+#include "benchmark/scenes.h"
+
+CCL_NAMESPACE_BEGIN
+
+struct BenchmarkOptions {
+  string device_name = "CPU";
+  string scene_names;
+  string output_filepath = "cycles_benchmark.json";
+  string baseline_filepath;
+  int width = 640;
+  int height = 360;
+  int samples = 16;
+  int threads = 0;
+  float tolerance = 0.05f;
+  bool profile = true;
+  bool list = false;
+};
+
+/* Profiler samples every millisecond on every rendering thread. */
+static const double PROFILER_SAMPLE_TIME = 0.001;
+
+static void collect_profiler_times(const NamedNestedSampleStats &stats,
+                                   const string &parent,
+                                   map<string, double> &times)
+{
+  foreach (const NamedNestedSampleStats &entry, stats.entries) {
+    if (entry.sum_samples == 0) {
+      continue;
+    }
+    const string name = parent.empty() ? entry.name : parent + "/" + entry.name;
+    times[name] = entry.sum_samples * PROFILER_SAMPLE_TIME;
+    collect_profiler_times(entry, name, times);
+  }
+}
+
+static void collect_update_times(const char *manager,
+                                 const UpdateTimeStats &stats,
+                                 BenchmarkResult &result)
+{
+  if (stats.times.entries.empty()) {
+    return;
+  }
+
+  map<string, double> &times = result.scene_update[manager];
+  foreach (const NamedTimeEntry &entry, stats.times.entries) {
+    times[entry.name] += entry.time;
+  }
+}
+
+static void collect_scene_update_stats(const SceneUpdateStats &stats, BenchmarkResult &result)
+{
+  collect_update_times("geometry", stats.geometry, result);
+  collect_update_times("image", stats.image, result);
+  collect_update_times("light", stats.light, result);
+  collect_update_times("object", stats.object, result);
+  collect_update_times("background", stats.background, result);
+  collect_update_times("camera", stats.camera, result);
+  collect_update_times("film", stats.film, result);
+  collect_update_times("integrator", stats.integrator, result);
+  collect_update_times("osl", stats.osl, result);
+  collect_update_times("particles", stats.particles, result);
+  collect_update_times("scene", stats.scene, result);
+  collect_update_times("svm", stats.svm, result);
+  collect_update_times("tables", stats.tables, result);
+  collect_update_times("procedurals", stats.procedurals, result);
+
+  result.scene_update_time = stats.scene.times.total_time;
+
+  foreach (const NamedTimeEntry &entry, stats.geometry.times.entries) {
+    if (entry.name.find("BVH") != string::npos) {
+      result.bvh_build_time += entry.time;
+    }
+  }
+}
+
+static BenchmarkResult benchmark_scene_render(const BenchmarkScene &benchmark_scene,
+                                              const BenchmarkOptions &options,
+                                              const DeviceInfo &device_info)
+{
+  SessionParams session_params;
+  session_params.device = device_info;
+  session_params.background = true;
+  session_params.samples = options.samples;
+  session_params.threads = options.threads;
+  session_params.use_profiling = options.profile;
+
+  SceneParams scene_params;
+
+  Session *session = new Session(session_params, scene_params);
+  Scene *scene = session->scene;
+
+  {
+    thread_scoped_lock scene_lock(scene->mutex);
+
+    scene->enable_update_stats();
+
+    /* Fixed seed and sample count, so that runs are comparable to each other. */
+    Integrator *integrator = scene->integrator;
+    integrator->set_seed(0);
+    integrator->set_aa_samples(options.samples);
+    integrator->set_use_adaptive_sampling(false);
+
+    benchmark_scene.create(scene);
+
+    scene->camera->set_full_width(options.width);
+    scene->camera->set_full_height(options.height);
+    scene->camera->compute_auto_viewplane();
+
+    Pass *pass = scene->create_node<Pass>();
+    pass->set_name(ustring("combined"));
+    pass->set_type(PASS_COMBINED);
+  }
+
+  BufferParams buffer_params;
+  buffer_params.width = options.width;
+  buffer_params.height = options.height;
+  buffer_params.full_width = options.width;
+  buffer_params.full_height = options.height;
+
+  session->reset(session_params, buffer_params);
+  session->start();
+  session->wait();
+
+  BenchmarkResult result;
+  result.name = benchmark_scene.name;
+  result.width = options.width;
+  result.height = options.height;
+  result.samples = options.samples;
+
+  double total_time, render_time;
+  session->progress.get_time(total_time, render_time);
+  result.render_time = render_time;
+  if (render_time > 0.0) {
+    result.samples_per_second = options.samples / render_time;
+    result.pixel_samples_per_second = double(options.width) * options.height * options.samples /
+                                      render_time;
+  }
+
+  if (scene->update_stats) {
+    collect_scene_update_stats(*scene->update_stats, result);
+  }
+
+  result.device_memory_peak = session->stats.mem_peak;
+  result.host_memory_peak = util_guarded_get_mem_peak();
+
+  if (options.profile) {
+    RenderStats render_stats;
+    session->collect_statistics(&render_stats);
+    if (render_stats.has_profiling) {
+      render_stats.kernel.update_sum();
+      collect_profiler_times(render_stats.kernel, "", result.profiler);
+    }
+  }
+
+  delete session;
+
+  return result;
+}
+
+static bool options_parse(int argc, const char **argv, BenchmarkOptions &options)
+{
+  /* List devices for which support is compiled in. */
+  string device_names = "";
+  foreach (DeviceType type, Device::available_types()) {
+    if (device_names != "") {
+      device_names += ", ";
+    }
+    device_names += Device::string_from_type(type);
+  }
+
+  bool no_profile = false;
+  bool help = false;
+
+  ArgParse ap;
+  ap.options("Usage: cycles_benchmark [options]",
+             "--device %s",
+             &options.device_name,
+             ("Device to render with: " + device_names).c_str(),
+             "--scene %s",
+             &options.scene_names,
+             "Comma separated list of scenes to render, all scenes by default",
+             "--list",
+             &options.list,
+             "List available scenes",
+             "--width %d",
+             &options.width,
+             "Render width in pixels",
+             "--height %d",
+             &options.height,
+             "Render height in pixels",
+             "--samples %d",
+             &options.samples,
+             "Number of samples to render",
+             "--threads %d",
+             &options.threads,
+             "CPU rendering threads",
+             "--no-profile",
+             &no_profile,
+             "Do not collect kernel profiler statistics",
+             "--output %s",
+             &options.output_filepath,
+             "File path to write JSON results to",
+             "--baseline %s",
+             &options.baseline_filepath,
+             "JSON results of a previous run to compare against",
+             "--tolerance %f",
+             &options.tolerance,
+             "Relative change of a metric which is considered to be a regression",
+             "--help",
+             &help,
+             "Print help message",
+             NULL);
+
+  if (ap.parse(argc, argv) < 0) {
+    fprintf(stderr, "%s\n", ap.geterror().c_str());
+    ap.usage();
+    return false;
+  }
+
+  if (help) {
+    ap.usage();
+    exit(EXIT_SUCCESS);
+  }
+
+  options.profile = !no_profile;
+
+  if (options.width <= 0 || options.height <= 0) {
+    fprintf(stderr, "Invalid resolution: %dx%d\n", options.width, options.height);
+    return false;
+  }
+  if (options.samples <= 0) {
+    fprintf(stderr, "Invalid number of samples: %d\n", options.samples);
+    return false;
+  }
+
+  return true;
+}
+
+static int benchmark_main(int argc, const char **argv)
+{
+  BenchmarkOptions options;
+  if (!options_parse(argc, argv, options)) {
+    return EXIT_FAILURE;
+  }
+
+  const vector<BenchmarkScene> &all_scenes = benchmark_scenes();
+
+  if (options.list) {
+    printf("Scenes:\n");
+    foreach (const BenchmarkScene &benchmark_scene, all_scenes) {
+      printf("    %-20s%s\n", benchmark_scene.name.c_str(), benchmark_scene.description.c_str());
+    }
+    return EXIT_SUCCESS;
+  }
+
+  /* Select scenes. */
+  vector<const BenchmarkScene *> scenes;
+  if (options.scene_names.empty()) {
+    foreach (const BenchmarkScene &benchmark_scene, all_scenes) {
+      scenes.push_back(&benchmark_scene);
+    }
+  }
+  else {
+    vector<string> names;
+    string_split(names, options.scene_names, ",");
+    foreach (const string &name, names) {
+      const BenchmarkScene *found = nullptr;
+      foreach (const BenchmarkScene &benchmark_scene, all_scenes) {
+        if (benchmark_scene.name == name) {
+          found = &benchmark_scene;
+        }
+      }
+      if (!found) {
+        fprintf(stderr, "Unknown scene: %s\n", name.c_str());
+        return EXIT_FAILURE;
+      }
+      scenes.push_back(found);
+    }
+  }
+
+  /* Find device. */
+  const DeviceType device_type = Device::type_from_string(options.device_name.c_str());
+  const vector<DeviceInfo> devices = Device::available_devices(DEVICE_MASK(device_type));
+  if (device_type == DEVICE_NONE || devices.empty()) {
+    fprintf(stderr, "Unknown device: %s\n", options.device_name.c_str());
+    return EXIT_FAILURE;
+  }
+  const DeviceInfo &device_info = devices.front();
+
+  /* Read baseline before rendering, so that an invalid file is reported early. */
+  map<string, double> baseline;
+  if (!options.baseline_filepath.empty()) {
+    string baseline_json;
+    if (!path_read_text(options.baseline_filepath, baseline_json) ||
+        !benchmark_json_read_metrics(baseline_json, baseline))
+    {
+      fprintf(stderr, "Failed to read baseline: %s\n", options.baseline_filepath.c_str());
+      return EXIT_FAILURE;
+    }
+  }
+
+  /* Render. */
+  vector<BenchmarkResult> results;
+  foreach (const BenchmarkScene *benchmark_scene, scenes) {
+    fprintf(stderr, "Rendering %s...\n", benchmark_scene->name.c_str());
+    results.push_back(benchmark_scene_render(*benchmark_scene, options, device_info));
+
+    const BenchmarkResult &result = results.back();
+    fprintf(stderr,
+            "  update %.3fs (BVH %.3fs), render %.3fs, %.2f samples/s\n",
+            result.scene_update_time,
+            result.bvh_build_time,
+            result.render_time,
+            result.samples_per_second);
+  }
+
+  /* Write results. */
+  BenchmarkRunInfo info;
+  info.version = CYCLES_VERSION_STRING;
+  info.device = device_info.description;
+  info.threads = options.threads;
+
+  string json = benchmark_results_to_json(info, results);
+  if (!path_write_text(options.output_filepath, json)) {
+    fprintf(stderr, "Failed to write results: %s\n", options.output_filepath.c_str());
+    return EXIT_FAILURE;
+  }
+  fprintf(stderr, "Results written to %s\n", options.output_filepath.c_str());
+
+  /* Compare against baseline. */
+  if (!options.baseline_filepath.empty()) {
+    bool has_regression = false;
+    const string report = benchmark_compare(
+        results, baseline, options.tolerance, has_regression);
+    fprintf(stderr, "\n%s", report.c_str());
+
+    if (has_regression) {
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+CCL_NAMESPACE_END
+
+using namespace ccl;
+
+int main(int argc, const char **argv)
+{
+  util_logging_init(argv[0]);
+  path_init();
+
+  return benchmark_main(argc, argv);
+}
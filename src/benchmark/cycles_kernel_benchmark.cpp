@@ -0,0 +1,671 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+/* Microbenchmarks of individual parts of the CPU kernel: ray traversal over a fixed BVH, SVM node
+ * evaluation and BSDF evaluation and sampling. Every benchmark runs for all microarchitectures of
+ * the kernel supported by the CPU, and reports the average time per operation. */
+
+#include <functional>
+#include <stdio.h>
+#include <string.h>
+
+#include "device/cpu/kernel_thread_globals.h"
+#include "device/device.h"
+#include "scene/camera.h"
+#include "scene/integrator.h"
+#include "scene/pass.h"
+#include "scene/scene.h"
+#include "session/buffers.h"
+#include "session/session.h"
+
+#include "kernel/integrator/state.h"
+
+#include "util/args.h"
+#include "util/foreach.h"
+#include "util/hash.h"
+#include "util/log.h"
+#include "util/path.h"
+#include "util/string.h"
+#include "util/system.h"
+#include "util/time.h"
+#include "util/unique_ptr.h"
+#include "util/version.h"
+
+#include "benchmark/kernel_benchmark.h"
+#include "benchmark/report.h"
+#include "benchmark/scenes.h"
+
+CCL_NAMESPACE_BEGIN
+
+struct KernelBenchmarkOptions {
+  string filter;
+  string output_filepath = "cycles_kernel_benchmark.json";
+  string baseline_filepath;
+  string bvh_layout = "bvh2";
+  /* Resolution of the grid of camera rays. */
+  int resolution = 256;
+  /* Number of shading points in a batch. */
+  int num_shading_points = 1024;
+  /* Minimum time to run every benchmark for, in seconds. */
+  float min_time = 0.25f;
+  float tolerance = 0.05f;
+  bool list = false;
+};
+
+/* Scene which has been synchronized to the CPU device, with kernel globals to run the benchmark
+ * entry points with. */
+class KernelBenchmarkScene {
+ public:
+  KernelBenchmarkScene(const BenchmarkScene &benchmark_scene,
+                       const KernelBenchmarkOptions &options,
+                       const DeviceInfo &device_info)
+  {
+    SessionParams session_params;
+    session_params.device = device_info;
+    session_params.background = true;
+    session_params.samples = 1;
+    session_params.threads = 1;
+
+    SceneParams scene_params;
+    scene_params.bvh_layout = (options.bvh_layout == "embree") ? BVH_LAYOUT_EMBREE :
+                                                                 BVH_LAYOUT_BVH2;
+
+    session_ = new Session(session_params, scene_params);
+    Scene *scene = session_->scene;
+
+    {
+      thread_scoped_lock scene_lock(scene->mutex);
+
+      scene->integrator->set_seed(0);
+      benchmark_scene.create(scene);
+
+      scene->camera->set_full_width(options.resolution);
+      scene->camera->set_full_height(options.resolution);
+      scene->camera->compute_auto_viewplane();
+
+      Pass *pass = scene->create_node<Pass>();
+      pass->set_name(ustring("combined"));
+      pass->set_type(PASS_COMBINED);
+    }
+
+    /* Render a single tiny frame, which uploads all scene data to the device. */
+    BufferParams buffer_params;
+    buffer_params.width = 8;
+    buffer_params.height = 8;
+    buffer_params.full_width = 8;
+    buffer_params.full_height = 8;
+
+    session_->reset(session_params, buffer_params);
+    session_->start();
+    session_->wait();
+
+    session_->device->get_cpu_kernel_thread_globals(kernel_thread_globals_);
+
+    rays_create(options.resolution);
+  }
+
+  ~KernelBenchmarkScene()
+  {
+    kernel_thread_globals_.clear();
+    delete session_;
+  }
+
+  const KernelGlobalsCPU *kernel_globals() const
+  {
+    return &kernel_thread_globals_[0];
+  }
+
+  /* Camera rays through a jittered grid of the view. */
+  vector<Ray> rays;
+
+ protected:
+  void rays_create(const int resolution)
+  {
+    const Camera *camera = session_->scene->camera;
+    const Transform cameratoworld = camera->get_matrix();
+    const float tan_half_fov = tanf(camera->get_fov() * 0.5f);
+
+    rays.resize(resolution * resolution);
+    for (int y = 0; y < resolution; y++) {
+      for (int x = 0; x < resolution; x++) {
+        const uint index = y * resolution + x;
+        const float u = (x + hash_uint2_to_float(index, 0)) / resolution * 2.0f - 1.0f;
+        const float v = (y + hash_uint2_to_float(index, 1)) / resolution * 2.0f - 1.0f;
+
+        Ray &ray = rays[index];
+        ray.P = transform_point(&cameratoworld, zero_float3());
+        ray.D = normalize(transform_direction(
+            &cameratoworld, make_float3(u * tan_half_fov, v * tan_half_fov, 1.0f)));
+        ray.tmin = 0.0f;
+        ray.tmax = FLT_MAX;
+        ray.time = 0.5f;
+        ray.self.object = OBJECT_NONE;
+        ray.self.prim = PRIM_NONE;
+        ray.self.light_object = OBJECT_NONE;
+        ray.self.light_prim = PRIM_NONE;
+#ifdef __RAY_DIFFERENTIALS__
+        ray.dP = 0.0f;
+        ray.dD = 0.0f;
+#endif
+      }
+    }
+  }
+
+  Session *session_;
+  vector<CPUKernelThreadGlobals> kernel_thread_globals_;
+};
+
+/* Run the function repeatedly for at least the minimum time, returns the time per operation. The
+ * function returns the number of operations it performed. */
+static KernelBenchmarkResult benchmark_run(const string &name,
+                                           const KernelBenchmarkFunctions &functions,
+                                           const KernelBenchmarkOptions &options,
+                                           const function<uint64_t()> &run)
+{
+  /* Warm up caches. */
+  run();
+
+  uint64_t num_ops = 0;
+  const double start_time = time_dt();
+  double elapsed_time = 0.0;
+  do {
+    num_ops += run();
+    elapsed_time = time_dt() - start_time;
+  } while (elapsed_time < options.min_time);
+
+  KernelBenchmarkResult result;
+  result.name = name;
+  result.uarch = functions.uarch_name;
+  result.num_ops = num_ops;
+  result.ns_per_op = (num_ops) ? elapsed_time * 1e9 / num_ops : 0.0;
+  return result;
+}
+
+static void benchmark_print(const KernelBenchmarkResult &result)
+{
+  fprintf(stderr,
+          "  %-36s %-8s %10.2f ns/op\n",
+          result.name.c_str(),
+          result.uarch.c_str(),
+          result.ns_per_op);
+}
+
+static bool benchmark_filter(const KernelBenchmarkOptions &options, const string &name)
+{
+  return options.filter.empty() || name.find(options.filter) != string::npos;
+}
+
+/* Shading points of the rays which hit the surface, as a batch of shader data. */
+class KernelBenchmarkShadingPoints {
+ public:
+  KernelBenchmarkShadingPoints(const KernelBenchmarkScene &scene,
+                               const KernelBenchmarkFunctions &functions,
+                               const int num_shading_points)
+  {
+    const KernelGlobalsCPU *kg = scene.kernel_globals();
+
+    vector<Intersection> isects(scene.rays.size());
+    functions.intersect_closest(kg, scene.rays.data(), isects.data(), scene.rays.size());
+
+    for (size_t i = 0; i < scene.rays.size() && rays.size() < num_shading_points; i++) {
+      if (isects[i].prim != PRIM_NONE) {
+        rays.push_back(scene.rays[i]);
+        hits.push_back(isects[i]);
+      }
+    }
+
+    sd.resize(rays.size());
+    functions.shader_setup(kg, rays.data(), hits.data(), sd.data(), sd.size());
+
+    memset(&state, 0, sizeof(state));
+  }
+
+  vector<Ray> rays;
+  vector<Intersection> hits;
+  vector<ShaderData> sd;
+  IntegratorStateCPU state;
+};
+
+static void benchmark_intersect(const KernelBenchmarkOptions &options,
+                                const DeviceInfo &device_info,
+                                const vector<KernelBenchmarkFunctions> &all_functions,
+                                vector<KernelBenchmarkResult> &results)
+{
+  foreach (const BenchmarkScene &benchmark_scene, benchmark_scenes()) {
+    const string name = "intersect_closest/" + benchmark_scene.name;
+    if (!benchmark_filter(options, name)) {
+      continue;
+    }
+
+    KernelBenchmarkScene scene(benchmark_scene, options, device_info);
+    const KernelGlobalsCPU *kg = scene.kernel_globals();
+    vector<Intersection> isects(scene.rays.size());
+
+    foreach (const KernelBenchmarkFunctions &functions, all_functions) {
+      results.push_back(benchmark_run(name, functions, options, [&]() {
+        functions.intersect_closest(kg, scene.rays.data(), isects.data(), scene.rays.size());
+        return uint64_t(scene.rays.size());
+      }));
+      benchmark_print(results.back());
+    }
+  }
+}
+
+static void benchmark_svm(const KernelBenchmarkOptions &options,
+                          const DeviceInfo &device_info,
+                          const vector<KernelBenchmarkFunctions> &all_functions,
+                          vector<KernelBenchmarkResult> &results)
+{
+  foreach (const BenchmarkScene &benchmark_scene, benchmark_node_scenes()) {
+    const string name = "svm/" + benchmark_scene.name;
+    if (!benchmark_filter(options, name)) {
+      continue;
+    }
+
+    KernelBenchmarkScene scene(benchmark_scene, options, device_info);
+    const KernelGlobalsCPU *kg = scene.kernel_globals();
+
+    foreach (const KernelBenchmarkFunctions &functions, all_functions) {
+      KernelBenchmarkShadingPoints points(scene, functions, options.num_shading_points);
+      results.push_back(benchmark_run(name, functions, options, [&]() {
+        functions.shader_eval(kg, &points.state, points.sd.data(), points.sd.size());
+        return uint64_t(points.sd.size());
+      }));
+      benchmark_print(results.back());
+    }
+  }
+}
+
+static void benchmark_bsdf(const KernelBenchmarkOptions &options,
+                           const DeviceInfo &device_info,
+                           const vector<KernelBenchmarkFunctions> &all_functions,
+                           vector<KernelBenchmarkResult> &results)
+{
+  foreach (const BenchmarkScene &benchmark_scene, benchmark_bsdf_scenes()) {
+    const string eval_name = "bsdf_eval/" + benchmark_scene.name;
+    const string sample_name = "bsdf_sample/" + benchmark_scene.name;
+    if (!benchmark_filter(options, eval_name) && !benchmark_filter(options, sample_name)) {
+      continue;
+    }
+
+    KernelBenchmarkScene scene(benchmark_scene, options, device_info);
+    const KernelGlobalsCPU *kg = scene.kernel_globals();
+
+    foreach (const KernelBenchmarkFunctions &functions, all_functions) {
+      KernelBenchmarkShadingPoints points(scene, functions, options.num_shading_points);
+      functions.shader_eval(kg, &points.state, points.sd.data(), points.sd.size());
+
+      /* Random directions in the hemisphere of the normal, and random numbers for sampling. */
+      vector<float3> wo(points.sd.size());
+      vector<float2> rand(points.sd.size());
+      for (size_t i = 0; i < points.sd.size(); i++) {
+        const float3 N = points.sd[i].N;
+        float3 D = make_float3(hash_uint2_to_float(i, 2) * 2.0f - 1.0f,
+                               hash_uint2_to_float(i, 3) * 2.0f - 1.0f,
+                               hash_uint2_to_float(i, 4) * 2.0f - 1.0f);
+        wo[i] = normalize(N + D * 0.9f);
+        rand[i] = make_float2(hash_uint2_to_float(i, 5), hash_uint2_to_float(i, 6));
+      }
+
+      float checksum = 0.0f;
+      if (benchmark_filter(options, eval_name)) {
+        results.push_back(benchmark_run(eval_name, functions, options, [&]() {
+          return uint64_t(functions.bsdf_eval(
+              kg, points.sd.data(), wo.data(), points.sd.size(), &checksum));
+        }));
+        benchmark_print(results.back());
+      }
+      if (benchmark_filter(options, sample_name)) {
+        results.push_back(benchmark_run(sample_name, functions, options, [&]() {
+          return uint64_t(functions.bsdf_sample(
+              kg, points.sd.data(), rand.data(), points.sd.size(), &checksum));
+        }));
+        benchmark_print(results.back());
+      }
+      VLOG_DEBUG << "Checksum of " << benchmark_scene.name << ": " << checksum;
+    }
+  }
+}
+
+/* Rhino noise procedurals in the order of RhinoProceduralNoiseType. */
+static const char *rhino_noise_type_names[] = {"perlin",
+                                               "value",
+                                               "perlin_plus_value",
+                                               "simplex",
+                                               "sparse_convolution",
+                                               "lattice_convolution",
+                                               "wards_hermite",
+                                               "aaltonen"};
+static const int num_rhino_noise_types = sizeof(rhino_noise_type_names) /
+                                         sizeof(*rhino_noise_type_names);
+
+/* Largest difference between the scalar and vectorized Rhino noises that is accepted. Kernels
+ * compiled without FMA give bitwise identical results. With FMA, the compiler may contract the
+ * multiplies and adds of the scalar and vector code differently, which changes the last bits. */
+static const float rhino_noise_tolerance = 1e-5f;
+
+/* Rhino noise evaluated without and with vector lanes. Returns the number of points evaluated
+ * with vector lanes. */
+struct RhinoNoiseBenchmark {
+  string name;
+  std::function<int(const KernelBenchmarkFunctions &functions,
+                    const KernelGlobalsCPU *kg,
+                    bool use_simd,
+                    const vector<float3> &P,
+                    vector<float> &values)>
+      run;
+};
+
+static vector<RhinoNoiseBenchmark> rhino_noise_benchmarks()
+{
+  vector<RhinoNoiseBenchmark> benchmarks;
+
+  /* Single octave, four points at a time. */
+  for (int noise_type = 0; noise_type < num_rhino_noise_types; noise_type++) {
+    benchmarks.push_back(
+        {string("rhino_noise/") + rhino_noise_type_names[noise_type],
+         [noise_type](const KernelBenchmarkFunctions &functions,
+                      const KernelGlobalsCPU *kg,
+                      const bool use_simd,
+                      const vector<float3> &P,
+                      vector<float> &values) {
+           return functions.rhino_noise(
+               kg, noise_type, 1, 1.0f, use_simd, P.data(), values.data(), P.size());
+         }});
+  }
+
+  /* Multiple octaves, four octaves at a time. An odd number of octaves evaluates the last octave
+   * without vector lanes. */
+  const struct {
+    int num_octaves;
+    float roughness;
+  } octave_settings[] = {{6, 0.5f}, {5, 0.8f}};
+
+  for (const auto &settings : octave_settings) {
+    for (int noise_type = 0; noise_type < num_rhino_noise_types; noise_type++) {
+      benchmarks.push_back(
+          {string_printf("rhino_noise/%s/octaves_%d_roughness_%.1f",
+                         rhino_noise_type_names[noise_type],
+                         settings.num_octaves,
+                         double(settings.roughness)),
+           [noise_type, settings](const KernelBenchmarkFunctions &functions,
+                                  const KernelGlobalsCPU *kg,
+                                  const bool use_simd,
+                                  const vector<float3> &P,
+                                  vector<float> &values) {
+             return functions.rhino_noise(kg,
+                                          noise_type,
+                                          settings.num_octaves,
+                                          settings.roughness,
+                                          use_simd,
+                                          P.data(),
+                                          values.data(),
+                                          P.size());
+           }});
+    }
+
+    benchmarks.push_back(
+        {string_printf("rhino_fbm/octaves_%d_roughness_%.1f",
+                       settings.num_octaves,
+                       double(settings.roughness)),
+         [settings](const KernelBenchmarkFunctions &functions,
+                    const KernelGlobalsCPU *kg,
+                    const bool use_simd,
+                    const vector<float3> &P,
+                    vector<float> &values) {
+           return functions.rhino_fbm(kg,
+                                      settings.num_octaves,
+                                      settings.roughness,
+                                      use_simd,
+                                      P.data(),
+                                      values.data(),
+                                      P.size());
+         }});
+  }
+
+  return benchmarks;
+}
+
+/* Every Rhino noise evaluated without and with vector lanes. Both have to give the same result
+ * within rhino_noise_tolerance, returns false if they do not. */
+static bool benchmark_rhino_noise(const KernelBenchmarkOptions &options,
+                                  const DeviceInfo &device_info,
+                                  const vector<KernelBenchmarkFunctions> &all_functions,
+                                  vector<KernelBenchmarkResult> &results)
+{
+  /* Points spanning many cells of the noise lattices. */
+  vector<float3> P(options.num_shading_points);
+  for (size_t i = 0; i < P.size(); i++) {
+    P[i] = make_float3(hash_uint2_to_float(i, 7) * 16.0f - 8.0f,
+                       hash_uint2_to_float(i, 8) * 16.0f - 8.0f,
+                       hash_uint2_to_float(i, 9) * 16.0f - 8.0f);
+  }
+  vector<float> scalar_values(P.size());
+  vector<float> simd_values(P.size());
+
+  /* The scene is only needed for the noise tables, which every Rhino scene uploads. */
+  unique_ptr<KernelBenchmarkScene> scene;
+  bool identical = true;
+
+  for (const RhinoNoiseBenchmark &benchmark : rhino_noise_benchmarks()) {
+    const string scalar_name = benchmark.name + "/scalar";
+    const string simd_name = benchmark.name + "/simd";
+    if (!benchmark_filter(options, scalar_name) && !benchmark_filter(options, simd_name)) {
+      continue;
+    }
+
+    if (!scene) {
+      foreach (const BenchmarkScene &benchmark_scene, benchmark_node_scenes()) {
+        if (benchmark_scene.name == "rhino_noise") {
+          scene = make_unique<KernelBenchmarkScene>(benchmark_scene, options, device_info);
+        }
+      }
+    }
+    const KernelGlobalsCPU *kg = scene->kernel_globals();
+
+    foreach (const KernelBenchmarkFunctions &functions, all_functions) {
+      results.push_back(benchmark_run(scalar_name, functions, options, [&]() {
+        benchmark.run(functions, kg, false, P, scalar_values);
+        return uint64_t(P.size());
+      }));
+      benchmark_print(results.back());
+      const double scalar_ns_per_op = results.back().ns_per_op;
+
+      int num_simd = 0;
+      results.push_back(benchmark_run(simd_name, functions, options, [&]() {
+        num_simd = benchmark.run(functions, kg, true, P, simd_values);
+        return uint64_t(P.size());
+      }));
+      benchmark_print(results.back());
+      const double simd_ns_per_op = results.back().ns_per_op;
+
+      int num_mismatch = 0;
+      float max_difference = 0.0f;
+      for (size_t i = 0; i < P.size(); i++) {
+        if (scalar_values[i] != simd_values[i]) {
+          num_mismatch++;
+          max_difference = max(max_difference, fabsf(scalar_values[i] - simd_values[i]));
+        }
+      }
+
+      fprintf(stderr,
+              "  %-44s %-8s %6.2fx speedup, %d of %d points vectorized, %d mismatches "
+              "(max difference %g, tolerance %g)\n",
+              benchmark.name.c_str(),
+              functions.uarch_name,
+              (simd_ns_per_op > 0.0) ? scalar_ns_per_op / simd_ns_per_op : 0.0,
+              num_simd,
+              int(P.size()),
+              num_mismatch,
+              double(max_difference),
+              double(rhino_noise_tolerance));
+
+      if (!(max_difference <= rhino_noise_tolerance)) {
+        fprintf(stderr,
+                "%s differs between scalar and SIMD by %g, more than the tolerance of %g\n",
+                benchmark.name.c_str(),
+                double(max_difference),
+                double(rhino_noise_tolerance));
+        identical = false;
+      }
+    }
+  }
+
+  return identical;
+}
+
+static bool options_parse(int argc, const char **argv, KernelBenchmarkOptions &options)
+{
+  bool help = false;
+
+  ArgParse ap;
+  ap.options("Usage: cycles_kernel_benchmark [options]",
+             "--filter %s",
+             &options.filter,
+             "Only run benchmarks which names contain the given string",
+             "--list",
+             &options.list,
+             "List available benchmarks",
+             "--bvh-layout %s",
+             &options.bvh_layout,
+             "BVH to traverse: bvh2, embree",
+             "--resolution %d",
+             &options.resolution,
+             "Resolution of the grid of camera rays",
+             "--shading-points %d",
+             &options.num_shading_points,
+             "Number of shading points in a batch",
+             "--min-time %f",
+             &options.min_time,
+             "Minimum time to run every benchmark for, in seconds",
+             "--output %s",
+             &options.output_filepath,
+             "File path to write JSON results to",
+             "--baseline %s",
+             &options.baseline_filepath,
+             "JSON results of a previous run to compare against",
+             "--tolerance %f",
+             &options.tolerance,
+             "Relative slowdown which is considered to be a regression",
+             "--help",
+             &help,
+             "Print help message",
+             NULL);
+
+  if (ap.parse(argc, argv) < 0) {
+    fprintf(stderr, "%s\n", ap.geterror().c_str());
+    ap.usage();
+    return false;
+  }
+
+  if (help) {
+    ap.usage();
+    exit(EXIT_SUCCESS);
+  }
+
+  if (!(options.bvh_layout == "bvh2" || options.bvh_layout == "embree")) {
+    fprintf(stderr, "Unknown BVH layout: %s\n", options.bvh_layout.c_str());
+    return false;
+  }
+  if (options.resolution <= 0 || options.num_shading_points <= 0) {
+    fprintf(stderr, "Invalid number of rays or shading points\n");
+    return false;
+  }
+
+  return true;
+}
+
+static int kernel_benchmark_main(int argc, const char **argv)
+{
+  KernelBenchmarkOptions options;
+  if (!options_parse(argc, argv, options)) {
+    return EXIT_FAILURE;
+  }
+
+  if (options.list) {
+    printf("Benchmarks:\n");
+    foreach (const BenchmarkScene &benchmark_scene, benchmark_scenes()) {
+      printf("    intersect_closest/%s\n", benchmark_scene.name.c_str());
+    }
+    foreach (const BenchmarkScene &benchmark_scene, benchmark_node_scenes()) {
+      printf("    svm/%s\n", benchmark_scene.name.c_str());
+    }
+    foreach (const BenchmarkScene &benchmark_scene, benchmark_bsdf_scenes()) {
+      printf("    bsdf_eval/%s\n", benchmark_scene.name.c_str());
+      printf("    bsdf_sample/%s\n", benchmark_scene.name.c_str());
+    }
+    for (const RhinoNoiseBenchmark &benchmark : rhino_noise_benchmarks()) {
+      printf("    %s/scalar\n", benchmark.name.c_str());
+      printf("    %s/simd\n", benchmark.name.c_str());
+    }
+    return EXIT_SUCCESS;
+  }
+
+  const vector<DeviceInfo> devices = Device::available_devices(DEVICE_MASK_CPU);
+  if (devices.empty()) {
+    fprintf(stderr, "CPU device is not available\n");
+    return EXIT_FAILURE;
+  }
+  const DeviceInfo &device_info = devices.front();
+
+  map<string, double> baseline;
+  if (!options.baseline_filepath.empty()) {
+    string baseline_json;
+    if (!path_read_text(options.baseline_filepath, baseline_json) ||
+        !benchmark_json_read_metrics(baseline_json, baseline))
+    {
+      fprintf(stderr, "Failed to read baseline: %s\n", options.baseline_filepath.c_str());
+      return EXIT_FAILURE;
+    }
+  }
+
+  const vector<KernelBenchmarkFunctions> functions = kernel_benchmark_functions();
+
+  vector<KernelBenchmarkResult> results;
+  benchmark_intersect(options, device_info, functions, results);
+  benchmark_svm(options, device_info, functions, results);
+  benchmark_bsdf(options, device_info, functions, results);
+  const bool rhino_noise_identical = benchmark_rhino_noise(
+      options, device_info, functions, results);
+
+  BenchmarkRunInfo info;
+  info.version = CYCLES_VERSION_STRING;
+  info.device = system_cpu_brand_string();
+  info.threads = 1;
+
+  string json = kernel_benchmark_results_to_json(info, results);
+  if (!path_write_text(options.output_filepath, json)) {
+    fprintf(stderr, "Failed to write results: %s\n", options.output_filepath.c_str());
+    return EXIT_FAILURE;
+  }
+  fprintf(stderr, "Results written to %s\n", options.output_filepath.c_str());
+
+  if (!rhino_noise_identical) {
+    return EXIT_FAILURE;
+  }
+
+  if (!options.baseline_filepath.empty()) {
+    bool has_regression = false;
+    const string report = kernel_benchmark_compare(
+        results, baseline, options.tolerance, has_regression);
+    fprintf(stderr, "\n%s", report.c_str());
+
+    if (has_regression) {
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+CCL_NAMESPACE_END
+
+using namespace ccl;
+
+int main(int argc, const char **argv)
+{
+  util_logging_init(argv[0]);
+  path_init();
+
+  return kernel_benchmark_main(argc, argv);
+}
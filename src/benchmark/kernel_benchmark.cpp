@@ -0,0 +1,54 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#include "benchmark/kernel_benchmark.h"
+
+#include "util/debug.h"
+#include "util/optimization.h"
+#include "util/system.h"
+
+CCL_NAMESPACE_BEGIN
+
+#define KERNEL_BENCHMARK_FUNCTIONS(uarch_name, arch) \
+  { \
+    uarch_name, KERNEL_NAME_EVAL(arch, benchmark_intersect_closest), \
+        KERNEL_NAME_EVAL(arch, benchmark_shader_setup), \
+        KERNEL_NAME_EVAL(arch, benchmark_shader_eval), \
+        KERNEL_NAME_EVAL(arch, benchmark_bsdf_eval), \
+        KERNEL_NAME_EVAL(arch, benchmark_bsdf_sample), \
+        KERNEL_NAME_EVAL(arch, benchmark_rhino_noise), \
+        KERNEL_NAME_EVAL(arch, benchmark_rhino_fbm) \
+  }
+
+vector<KernelBenchmarkFunctions> kernel_benchmark_functions()
+{
+  /* Same selection of the microarchitectures as in CPUKernelFunction, except that all of the
+   * supported ones are returned and not only the best one. */
+  vector<KernelBenchmarkFunctions> functions;
+
+  functions.push_back(KERNEL_BENCHMARK_FUNCTIONS("default", cpu));
+
+#ifdef WITH_CYCLES_OPTIMIZED_KERNEL_SSE2
+  if (DebugFlags().cpu.has_sse2() && system_cpu_support_sse2()) {
+    functions.push_back(KERNEL_BENCHMARK_FUNCTIONS("SSE2", cpu_sse2));
+  }
+#endif
+
+#ifdef WITH_CYCLES_OPTIMIZED_KERNEL_SSE41
+  if (DebugFlags().cpu.has_sse41() && system_cpu_support_sse41()) {
+    functions.push_back(KERNEL_BENCHMARK_FUNCTIONS("SSE4.1", cpu_sse41));
+  }
+#endif
+
+#ifdef WITH_CYCLES_OPTIMIZED_KERNEL_AVX2
+  if (DebugFlags().cpu.has_avx2() && system_cpu_support_avx2()) {
+    functions.push_back(KERNEL_BENCHMARK_FUNCTIONS("AVX2", cpu_avx2));
+  }
+#endif
+
+  return functions;
+}
+
+#undef KERNEL_BENCHMARK_FUNCTIONS
+
+CCL_NAMESPACE_END
@@ -0,0 +1,74 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#pragma once
+
+/* Kernel Microbenchmark Interface */
+
+#include "kernel/device/cpu/kernel.h"
+
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+#define KERNEL_ARCH cpu
+#include "benchmark/kernel_benchmark_arch.h"
+
+#define KERNEL_ARCH cpu_sse2
+#include "benchmark/kernel_benchmark_arch.h"
+
+#define KERNEL_ARCH cpu_sse41
+#include "benchmark/kernel_benchmark_arch.h"
+
+#define KERNEL_ARCH cpu_avx2
+#include "benchmark/kernel_benchmark_arch.h"
+
+/* Microbenchmark entry points of a single CPU microarchitecture. */
+struct KernelBenchmarkFunctions {
+  const char *uarch_name;
+
+  int (*intersect_closest)(const KernelGlobalsCPU *kg,
+                           const Ray *rays,
+                           Intersection *isects,
+                           const int num);
+  void (*shader_setup)(const KernelGlobalsCPU *kg,
+                       const Ray *rays,
+                       const Intersection *isects,
+                       ShaderData *sd,
+                       const int num);
+  int (*shader_eval)(const KernelGlobalsCPU *kg,
+                     const IntegratorStateCPU *state,
+                     ShaderData *sd,
+                     const int num);
+  int (*bsdf_eval)(const KernelGlobalsCPU *kg,
+                   ShaderData *sd,
+                   const float3 *wo,
+                   const int num,
+                   float *checksum);
+  int (*bsdf_sample)(const KernelGlobalsCPU *kg,
+                     ShaderData *sd,
+                     const float2 *rand,
+                     const int num,
+                     float *checksum);
+  int (*rhino_noise)(const KernelGlobalsCPU *kg,
+                     const int noise_type,
+                     const int num_octaves,
+                     const float roughness,
+                     const bool use_simd,
+                     const float3 *P,
+                     float *values,
+                     const int num);
+  int (*rhino_fbm)(const KernelGlobalsCPU *kg,
+                   const int num_octaves,
+                   const float roughness,
+                   const bool use_simd,
+                   const float3 *P,
+                   float *values,
+                   const int num);
+};
+
+/* Get entry points of all microarchitectures which are compiled in and supported by the CPU,
+ * in the same order of preference as the render kernels use, the best one being the last. */
+vector<KernelBenchmarkFunctions> kernel_benchmark_functions();
+
+CCL_NAMESPACE_END
@@ -0,0 +1,67 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+/* Templated declaration of the kernel microbenchmark entry points of a single CPU
+ * microarchitecture. Every entry point processes a batch of elements, so that the overhead of the
+ * call is negligible compared to the measured work. */
+
+/* Intersect rays with the scene, returns the number of rays which hit a primitive. */
+int KERNEL_FUNCTION_FULL_NAME(benchmark_intersect_closest)(const KernelGlobalsCPU *kg,
+                                                           const Ray *rays,
+                                                           Intersection *isects,
+                                                           const int num);
+
+/* Initialize shader data from the intersection of a ray. Hits are expected to be valid. */
+void KERNEL_FUNCTION_FULL_NAME(benchmark_shader_setup)(const KernelGlobalsCPU *kg,
+                                                       const Ray *rays,
+                                                       const Intersection *isects,
+                                                       ShaderData *sd,
+                                                       const int num);
+
+/* Run the SVM surface shader of the shader data, returns the total number of closures. */
+int KERNEL_FUNCTION_FULL_NAME(benchmark_shader_eval)(const KernelGlobalsCPU *kg,
+                                                     const IntegratorStateCPU *state,
+                                                     ShaderData *sd,
+                                                     const int num);
+
+/* Evaluate and sample all BSDF closures of the shader data. Returns the number of evaluated or
+ * sampled closures, and accumulates the result into the checksum so that the work can not be
+ * optimized away. */
+int KERNEL_FUNCTION_FULL_NAME(benchmark_bsdf_eval)(const KernelGlobalsCPU *kg,
+                                                   ShaderData *sd,
+                                                   const float3 *wo,
+                                                   const int num,
+                                                   float *checksum);
+int KERNEL_FUNCTION_FULL_NAME(benchmark_bsdf_sample)(const KernelGlobalsCPU *kg,
+                                                     ShaderData *sd,
+                                                     const float2 *rand,
+                                                     const int num,
+                                                     float *checksum);
+
+/* Evaluate a Rhino noise procedural at every point. A single octave is evaluated four points at a
+ * time with SIMD, if the microarchitecture has a vectorized version of the noise. With more
+ * octaves, the weighted average of the octaves of the noise texture is evaluated with the octaves
+ * four at a time with SIMD, and one at a time without. Octaves are two times the frequency of the
+ * previous one, and their weight is multiplied by the roughness.
+ * Returns the number of points which were evaluated with vector lanes. */
+int KERNEL_FUNCTION_FULL_NAME(benchmark_rhino_noise)(const KernelGlobalsCPU *kg,
+                                                     const int noise_type,
+                                                     const int num_octaves,
+                                                     const float roughness,
+                                                     const bool use_simd,
+                                                     const float3 *P,
+                                                     float *values,
+                                                     const int num);
+
+/* Evaluate Rhino fBm with the given number of octaves at every point. With SIMD the octaves are
+ * evaluated four at a time, without one at a time.
+ * Returns the number of points which were evaluated with vector lanes. */
+int KERNEL_FUNCTION_FULL_NAME(benchmark_rhino_fbm)(const KernelGlobalsCPU *kg,
+                                                   const int num_octaves,
+                                                   const float roughness,
+                                                   const bool use_simd,
+                                                   const float3 *P,
+                                                   float *values,
+                                                   const int num);
+
+#undef KERNEL_ARCH
@@ -0,0 +1,264 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+/* Templated implementation of the kernel microbenchmark entry points.
+ *
+ * Similar to the CPU kernel itself, the .cpp files set the optimization flags of a particular
+ * microarchitecture and include this file. */
+
+#pragma once
+
+// clang-format off
+#include "kernel/device/cpu/compat.h"
+
+#ifndef KERNEL_STUB
+#    include "kernel/device/cpu/globals.h"
+#    include "kernel/device/cpu/image.h"
+
+#    include "kernel/integrator/state.h"
+#    include "kernel/integrator/state_flow.h"
+#    include "kernel/integrator/state_util.h"
+
+#    include "kernel/integrator/init_from_camera.h"
+#    include "kernel/integrator/init_from_bake.h"
+#    include "kernel/integrator/intersect_closest.h"
+#    include "kernel/integrator/intersect_shadow.h"
+#    include "kernel/integrator/intersect_subsurface.h"
+#    include "kernel/integrator/intersect_volume_stack.h"
+#    include "kernel/integrator/shade_background.h"
+#    include "kernel/integrator/shade_light.h"
+#    include "kernel/integrator/shade_shadow.h"
+#    include "kernel/integrator/shade_surface.h"
+#else
+#  define STUB_ASSERT(arch, name) \
+    assert(!(#name " benchmark stub for architecture " #arch " was called!"))
+#endif   /* KERNEL_STUB */
+// clang-format on
+
+CCL_NAMESPACE_BEGIN
+
+int KERNEL_FUNCTION_FULL_NAME(benchmark_intersect_closest)(const KernelGlobalsCPU *kg,
+                                                           const Ray *rays,
+                                                           Intersection *isects,
+                                                           const int num)
+{
+#ifdef KERNEL_STUB
+  STUB_ASSERT(KERNEL_ARCH, benchmark_intersect_closest);
+  return 0;
+#else
+  int num_hits = 0;
+  for (int i = 0; i < num; i++) {
+    num_hits += scene_intersect(kg, &rays[i], PATH_RAY_CAMERA, &isects[i]);
+  }
+  return num_hits;
+#endif
+}
+
+void KERNEL_FUNCTION_FULL_NAME(benchmark_shader_setup)(const KernelGlobalsCPU *kg,
+                                                       const Ray *rays,
+                                                       const Intersection *isects,
+                                                       ShaderData *sd,
+                                                       const int num)
+{
+#ifdef KERNEL_STUB
+  STUB_ASSERT(KERNEL_ARCH, benchmark_shader_setup);
+#else
+  for (int i = 0; i < num; i++) {
+    shader_setup_from_ray(kg, &sd[i], &rays[i], &isects[i]);
+  }
+#endif
+}
+
+int KERNEL_FUNCTION_FULL_NAME(benchmark_shader_eval)(const KernelGlobalsCPU *kg,
+                                                     const IntegratorStateCPU *state,
+                                                     ShaderData *sd,
+                                                     const int num)
+{
+#ifdef KERNEL_STUB
+  STUB_ASSERT(KERNEL_ARCH, benchmark_shader_eval);
+  return 0;
+#else
+  int num_closures = 0;
+  for (int i = 0; i < num; i++) {
+    surface_shader_eval<KERNEL_FEATURE_NODE_MASK_SURFACE>(
+        kg, state, &sd[i], nullptr, PATH_RAY_CAMERA);
+    num_closures += sd[i].num_closure;
+  }
+  return num_closures;
+#endif
+}
+
+int KERNEL_FUNCTION_FULL_NAME(benchmark_bsdf_eval)(const KernelGlobalsCPU *kg,
+                                                   ShaderData *sd,
+                                                   const float3 *wo,
+                                                   const int num,
+                                                   float *checksum)
+{
+#ifdef KERNEL_STUB
+  STUB_ASSERT(KERNEL_ARCH, benchmark_bsdf_eval);
+  return 0;
+#else
+  int num_evals = 0;
+  float sum = 0.0f;
+  for (int i = 0; i < num; i++) {
+    for (int j = 0; j < sd[i].num_closure; j++) {
+      const ShaderClosure *sc = &sd[i].closure[j];
+      if (!CLOSURE_IS_BSDF(sc->type)) {
+        continue;
+      }
+      float pdf;
+      const Spectrum eval = bsdf_eval(kg, &sd[i], sc, wo[i], &pdf);
+      sum += reduce_add(eval) + pdf;
+      num_evals++;
+    }
+  }
+  *checksum += sum;
+  return num_evals;
+#endif
+}
+
+int KERNEL_FUNCTION_FULL_NAME(benchmark_bsdf_sample)(const KernelGlobalsCPU *kg,
+                                                     ShaderData *sd,
+                                                     const float2 *rand,
+                                                     const int num,
+                                                     float *checksum)
+{
+#ifdef KERNEL_STUB
+  STUB_ASSERT(KERNEL_ARCH, benchmark_bsdf_sample);
+  return 0;
+#else
+  int num_samples = 0;
+  float sum = 0.0f;
+  for (int i = 0; i < num; i++) {
+    for (int j = 0; j < sd[i].num_closure; j++) {
+      const ShaderClosure *sc = &sd[i].closure[j];
+      if (!CLOSURE_IS_BSDF(sc->type)) {
+        continue;
+      }
+      Spectrum eval;
+      float3 wo;
+      float pdf, eta;
+      float2 sampled_roughness;
+      bsdf_sample(
+          kg, &sd[i], sc, rand[i].x, rand[i].y, &eval, &wo, &pdf, &sampled_roughness, &eta);
+      sum += reduce_add(eval) + pdf;
+      num_samples++;
+    }
+  }
+  *checksum += sum;
+  return num_samples;
+#endif
+}
+
+int KERNEL_FUNCTION_FULL_NAME(benchmark_rhino_noise)(const KernelGlobalsCPU *kg,
+                                                     const int noise_type,
+                                                     const int num_octaves,
+                                                     const float roughness,
+                                                     const bool use_simd,
+                                                     const float3 *P,
+                                                     float *values,
+                                                     const int num)
+{
+#ifdef KERNEL_STUB
+  STUB_ASSERT(KERNEL_ARCH, benchmark_rhino_noise);
+  return 0;
+#else
+  const RhinoProceduralNoiseType type = (RhinoProceduralNoiseType)noise_type;
+
+  if (num_octaves > 1) {
+    if (use_simd) {
+      /* Octaves of the noise texture, which are evaluated four at a time. */
+      for (int i = 0; i < num; i++) {
+        values[i] = noise_texture_octaves(
+            kg, P[i], type, RHINO_SPEC_SYNTH_FRACTAL_SUM, num_octaves, 2.0f, roughness);
+      }
+#  ifdef __KERNEL_SSE__
+      return (noise_texture_has_simd(type)) ? num : 0;
+#  else
+      return 0;
+#  endif
+    }
+
+    /* Same sum of octaves as noise_texture_octaves(), one octave at a time. */
+    for (int i = 0; i < num; i++) {
+      float total_value = 0.0f, total_weight = 0.0f;
+      float freq = 1.0f, weight = 1.0f;
+      for (int o = 0; o < num_octaves; o++) {
+        const float fo = float(o);
+        total_value += weight * noise_texture_value(kg,
+                                                    type,
+                                                    P[i].x * freq + fo,
+                                                    P[i].y * freq + fo * 2.0f,
+                                                    P[i].z * freq - fo);
+        total_weight += weight;
+        freq *= 2.0f;
+        weight *= roughness;
+      }
+      values[i] = total_value / total_weight;
+    }
+    return 0;
+  }
+
+  int i = 0;
+#  ifdef __KERNEL_SSE__
+  if (use_simd && noise_texture_has_simd(type)) {
+    for (; i + 4 <= num; i += 4) {
+      const float4 x = make_float4(P[i].x, P[i + 1].x, P[i + 2].x, P[i + 3].x);
+      const float4 y = make_float4(P[i].y, P[i + 1].y, P[i + 2].y, P[i + 3].y);
+      const float4 z = make_float4(P[i].z, P[i + 1].z, P[i + 2].z, P[i + 3].z);
+      const float4 value = noise_texture_value(kg, type, x, y, z);
+      values[i + 0] = value.x;
+      values[i + 1] = value.y;
+      values[i + 2] = value.z;
+      values[i + 3] = value.w;
+    }
+  }
+#  endif
+  const int num_simd = i;
+  for (; i < num; i++) {
+    values[i] = noise_texture_value(kg, type, P[i].x, P[i].y, P[i].z);
+  }
+  return num_simd;
+#endif
+}
+
+int KERNEL_FUNCTION_FULL_NAME(benchmark_rhino_fbm)(const KernelGlobalsCPU *kg,
+                                                   const int num_octaves,
+                                                   const float roughness,
+                                                   const bool use_simd,
+                                                   const float3 *P,
+                                                   float *values,
+                                                   const int num)
+{
+#ifdef KERNEL_STUB
+  STUB_ASSERT(KERNEL_ARCH, benchmark_rhino_fbm);
+  return 0;
+#else
+  if (use_simd) {
+    /* Octaves of fBm, which are evaluated four at a time. */
+    for (int i = 0; i < num; i++) {
+      values[i] = fbm(kg, P[i], false, roughness, num_octaves);
+    }
+#  ifdef __KERNEL_SSE__
+    return (num_octaves > 1) ? num : 0;
+#  else
+    return 0;
+#  endif
+  }
+
+  /* Same sum of octaves as fbm(), one octave at a time. */
+  for (int i = 0; i < num; i++) {
+    float sum = 0.0f, lambda = 1.0f, o = 1.0f;
+    for (int j = 0; j < num_octaves; j++) {
+      const float3 lambda_p = lambda * P[i];
+      sum += o * noise3(kg, lambda_p.x, lambda_p.y, lambda_p.z);
+      lambda *= 1.99f;
+      o *= roughness;
+    }
+    values[i] = sum;
+  }
+  return 0;
+#endif
+}
+
+CCL_NAMESPACE_END
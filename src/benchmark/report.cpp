@@ -0,0 +1,446 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#include "benchmark/report.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+#include "util/math.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* --------------------------------------------------------------------
+ * JSON writing.
+ */
+
+static string json_string(const string &value)
+{
+  string result = "\"";
+  for (const char c : value) {
+    switch (c) {
+      case '"':
+        result += "\\\"";
+        break;
+      case '\\':
+        result += "\\\\";
+        break;
+      case '\n':
+        result += "\\n";
+        break;
+      case '\t':
+        result += "\\t";
+        break;
+      default:
+        if ((unsigned char)c < 0x20) {
+          result += string_printf("\\u%04x", c);
+        }
+        else {
+          result += c;
+        }
+        break;
+    }
+  }
+  return result + "\"";
+}
+
+static string json_number(const double value)
+{
+  return string_printf("%.9g", value);
+}
+
+static string json_indent(const int level)
+{
+  return string(level * 2, ' ');
+}
+
+static string json_time_map(const map<string, double> &times, const int level)
+{
+  string result = "{";
+  bool first = true;
+  for (const auto &it : times) {
+    result += first ? "\n" : ",\n";
+    result += json_indent(level + 1) + json_string(it.first) + ": " + json_number(it.second);
+    first = false;
+  }
+  if (!first) {
+    result += "\n" + json_indent(level);
+  }
+  return result + "}";
+}
+
+static string json_result(const BenchmarkResult &result, const int level)
+{
+  const string indent = json_indent(level + 1);
+
+  string json = "{\n";
+  json += indent + "\"width\": " + to_string(result.width) + ",\n";
+  json += indent + "\"height\": " + to_string(result.height) + ",\n";
+  json += indent + "\"samples\": " + to_string(result.samples) + ",\n";
+  json += indent + "\"scene_update_time\": " + json_number(result.scene_update_time) + ",\n";
+  json += indent + "\"bvh_build_time\": " + json_number(result.bvh_build_time) + ",\n";
+  json += indent + "\"render_time\": " + json_number(result.render_time) + ",\n";
+  json += indent + "\"samples_per_second\": " + json_number(result.samples_per_second) + ",\n";
+  json += indent + "\"pixel_samples_per_second\": " +
+          json_number(result.pixel_samples_per_second) + ",\n";
+  json += indent + "\"device_memory_peak\": " + to_string(result.device_memory_peak) + ",\n";
+  json += indent + "\"host_memory_peak\": " + to_string(result.host_memory_peak) + ",\n";
+
+  json += indent + "\"scene_update\": {";
+  bool first = true;
+  for (const auto &it : result.scene_update) {
+    json += first ? "\n" : ",\n";
+    json += json_indent(level + 2) + json_string(it.first) + ": " +
+            json_time_map(it.second, level + 2);
+    first = false;
+  }
+  if (!first) {
+    json += "\n" + indent;
+  }
+  json += "},\n";
+
+  json += indent + "\"profiler\": " + json_time_map(result.profiler, level + 1) + "\n";
+
+  return json + json_indent(level) + "}";
+}
+
+string benchmark_results_to_json(const BenchmarkRunInfo &info,
+                                 const vector<BenchmarkResult> &results)
+{
+  string json = "{\n";
+  json += json_indent(1) + "\"version\": " + json_string(info.version) + ",\n";
+  json += json_indent(1) + "\"device\": " + json_string(info.device) + ",\n";
+  json += json_indent(1) + "\"threads\": " + to_string(info.threads) + ",\n";
+  json += json_indent(1) + "\"scenes\": {";
+
+  bool first = true;
+  for (const BenchmarkResult &result : results) {
+    json += first ? "\n" : ",\n";
+    json += json_indent(2) + json_string(result.name) + ": " + json_result(result, 2);
+    first = false;
+  }
+  if (!first) {
+    json += "\n" + json_indent(1);
+  }
+
+  json += "}\n}\n";
+  return json;
+}
+
+string kernel_benchmark_results_to_json(const BenchmarkRunInfo &info,
+                                        const vector<KernelBenchmarkResult> &results)
+{
+  /* Group results of all microarchitectures of a benchmark, preserving the order. */
+  vector<string> names;
+  map<string, vector<const KernelBenchmarkResult *>> results_by_name;
+  for (const KernelBenchmarkResult &result : results) {
+    vector<const KernelBenchmarkResult *> &name_results = results_by_name[result.name];
+    if (name_results.empty()) {
+      names.push_back(result.name);
+    }
+    name_results.push_back(&result);
+  }
+
+  string json = "{\n";
+  json += json_indent(1) + "\"version\": " + json_string(info.version) + ",\n";
+  json += json_indent(1) + "\"device\": " + json_string(info.device) + ",\n";
+  json += json_indent(1) + "\"benchmarks\": {";
+
+  bool first = true;
+  for (const string &name : names) {
+    json += first ? "\n" : ",\n";
+    json += json_indent(2) + json_string(name) + ": {";
+
+    bool first_uarch = true;
+    for (const KernelBenchmarkResult *result : results_by_name[name]) {
+      json += first_uarch ? "\n" : ",\n";
+      json += json_indent(3) + json_string(result->uarch) + ": {\"ns_per_op\": " +
+              json_number(result->ns_per_op) + ", \"ops\": " + to_string(result->num_ops) + "}";
+      first_uarch = false;
+    }
+
+    json += "\n" + json_indent(2) + "}";
+    first = false;
+  }
+  if (!first) {
+    json += "\n" + json_indent(1);
+  }
+
+  json += "}\n}\n";
+  return json;
+}
+
+/* --------------------------------------------------------------------
+ * JSON reading.
+ *
+ * Minimal parser which only collects numbers, which is all the comparison needs. Array elements
+ * are keyed by their index.
+ */
+
+class JSONMetricsReader {
+ public:
+  JSONMetricsReader(const string &json, map<string, double> &metrics)
+      : json_(json), metrics_(metrics)
+  {
+  }
+
+  bool parse()
+  {
+    if (!parse_value("")) {
+      return false;
+    }
+    skip_whitespace();
+    return pos_ == json_.size();
+  }
+
+ protected:
+  void skip_whitespace()
+  {
+    while (pos_ < json_.size() && isspace((unsigned char)json_[pos_])) {
+      ++pos_;
+    }
+  }
+
+  bool consume(const char c)
+  {
+    skip_whitespace();
+    if (pos_ < json_.size() && json_[pos_] == c) {
+      ++pos_;
+      return true;
+    }
+    return false;
+  }
+
+  static string join_key(const string &parent, const string &key)
+  {
+    return parent.empty() ? key : parent + "." + key;
+  }
+
+  bool parse_value(const string &key)
+  {
+    skip_whitespace();
+    if (pos_ >= json_.size()) {
+      return false;
+    }
+
+    const char c = json_[pos_];
+    if (c == '{') {
+      return parse_object(key);
+    }
+    if (c == '[') {
+      return parse_array(key);
+    }
+    if (c == '"') {
+      string value;
+      return parse_string(value);
+    }
+    if (c == 't') {
+      return parse_literal("true");
+    }
+    if (c == 'f') {
+      return parse_literal("false");
+    }
+    if (c == 'n') {
+      return parse_literal("null");
+    }
+    return parse_number(key);
+  }
+
+  bool parse_object(const string &key)
+  {
+    consume('{');
+    if (consume('}')) {
+      return true;
+    }
+    do {
+      skip_whitespace();
+      string member;
+      if (!parse_string(member) || !consume(':') || !parse_value(join_key(key, member))) {
+        return false;
+      }
+    } while (consume(','));
+    return consume('}');
+  }
+
+  bool parse_array(const string &key)
+  {
+    consume('[');
+    if (consume(']')) {
+      return true;
+    }
+    int index = 0;
+    do {
+      if (!parse_value(join_key(key, to_string(index++)))) {
+        return false;
+      }
+    } while (consume(','));
+    return consume(']');
+  }
+
+  bool parse_string(string &value)
+  {
+    if (pos_ >= json_.size() || json_[pos_] != '"') {
+      return false;
+    }
+    ++pos_;
+    while (pos_ < json_.size() && json_[pos_] != '"') {
+      char c = json_[pos_++];
+      if (c == '\\' && pos_ < json_.size()) {
+        c = json_[pos_++];
+        switch (c) {
+          case 'n':
+            c = '\n';
+            break;
+          case 't':
+            c = '\t';
+            break;
+          case 'u':
+            /* Only control characters are escaped by the writer. */
+            if (pos_ + 4 > json_.size()) {
+              return false;
+            }
+            c = (char)strtol(json_.substr(pos_, 4).c_str(), nullptr, 16);
+            pos_ += 4;
+            break;
+          default:
+            break;
+        }
+      }
+      value += c;
+    }
+    return consume('"');
+  }
+
+  bool parse_literal(const char *literal)
+  {
+    const size_t length = strlen(literal);
+    if (json_.compare(pos_, length, literal) != 0) {
+      return false;
+    }
+    pos_ += length;
+    return true;
+  }
+
+  bool parse_number(const string &key)
+  {
+    const char *begin = json_.c_str() + pos_;
+    char *end = nullptr;
+    const double value = strtod(begin, &end);
+    if (end == begin) {
+      return false;
+    }
+    pos_ += end - begin;
+    metrics_[key] = value;
+    return true;
+  }
+
+  const string &json_;
+  size_t pos_ = 0;
+  map<string, double> &metrics_;
+};
+
+bool benchmark_json_read_metrics(const string &json, map<string, double> &metrics)
+{
+  JSONMetricsReader reader(json, metrics);
+  return reader.parse();
+}
+
+/* --------------------------------------------------------------------
+ * Comparison.
+ */
+
+string benchmark_compare(const vector<BenchmarkResult> &results,
+                         const map<string, double> &baseline,
+                         const double tolerance,
+                         bool &has_regression)
+{
+  /* Timings shorter than this are dominated by noise and are not considered for regressions. */
+  const double min_time = 0.01;
+
+  has_regression = false;
+
+  string report = string_printf(
+      "%-20s %-26s %14s %14s %9s\n", "Scene", "Metric", "Baseline", "Current", "Change");
+
+  for (const BenchmarkResult &result : results) {
+    struct Metric {
+      const char *name;
+      double value;
+      bool higher_is_better;
+      bool is_time;
+    };
+    const Metric metrics[] = {
+        {"scene_update_time", result.scene_update_time, false, true},
+        {"bvh_build_time", result.bvh_build_time, false, true},
+        {"render_time", result.render_time, false, true},
+        {"samples_per_second", result.samples_per_second, true, false},
+        {"device_memory_peak", double(result.device_memory_peak), false, false},
+    };
+
+    for (const Metric &metric : metrics) {
+      auto it = baseline.find("scenes." + result.name + "." + metric.name);
+      if (it == baseline.end()) {
+        continue;
+      }
+
+      const double baseline_value = it->second;
+      if (baseline_value == 0.0) {
+        continue;
+      }
+
+      const double change = (metric.value - baseline_value) / baseline_value;
+      const double regression = metric.higher_is_better ? -change : change;
+
+      const bool is_noise = metric.is_time && max(metric.value, baseline_value) < min_time;
+      const bool is_regression = !is_noise && regression > tolerance;
+      has_regression |= is_regression;
+
+      report += string_printf("%-20s %-26s %14.6g %14.6g %+8.2f%%%s\n",
+                              result.name.c_str(),
+                              metric.name,
+                              baseline_value,
+                              metric.value,
+                              change * 100.0,
+                              is_regression ? "  REGRESSION" : "");
+    }
+  }
+
+  return report;
+}
+
+string kernel_benchmark_compare(const vector<KernelBenchmarkResult> &results,
+                                const map<string, double> &baseline,
+                                const double tolerance,
+                                bool &has_regression)
+{
+  has_regression = false;
+
+  string report = string_printf(
+      "%-36s %-8s %12s %12s %9s\n", "Benchmark", "Uarch", "Baseline ns", "Current ns", "Change");
+
+  for (const KernelBenchmarkResult &result : results) {
+    auto it = baseline.find("benchmarks." + result.name + "." + result.uarch + ".ns_per_op");
+    if (it == baseline.end() || it->second == 0.0) {
+      continue;
+    }
+
+    const double baseline_value = it->second;
+    const double change = (result.ns_per_op - baseline_value) / baseline_value;
+
+    const bool is_regression = change > tolerance;
+    has_regression |= is_regression;
+
+    report += string_printf("%-36s %-8s %12.3f %12.3f %+8.2f%%%s\n",
+                            result.name.c_str(),
+                            result.uarch.c_str(),
+                            baseline_value,
+                            result.ns_per_op,
+                            change * 100.0,
+                            is_regression ? "  REGRESSION" : "");
+  }
+
+  return report;
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,92 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#pragma once
+
+#include "util/map.h"
+#include "util/string.h"
+#include "util/types.h"
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Measurements of a single benchmark scene. */
+struct BenchmarkResult {
+  string name;
+
+  int width = 0;
+  int height = 0;
+  int samples = 0;
+
+  /* Wall time of the scene update, and the part of it spent on building BVHs, in seconds. */
+  double scene_update_time = 0.0;
+  double bvh_build_time = 0.0;
+
+  /* Wall time of path tracing, in seconds. */
+  double render_time = 0.0;
+
+  /* Throughput of path tracing. */
+  double samples_per_second = 0.0;
+  double pixel_samples_per_second = 0.0;
+
+  /* Peak of the memory allocated on the render device, and peak of the host memory allocated
+   * by Cycles since the start of the process. In bytes. */
+  size_t device_memory_peak = 0;
+  size_t host_memory_peak = 0;
+
+  /* Timing of the scene update phases, in seconds, keyed by manager and then by phase. */
+  map<string, map<string, double>> scene_update;
+
+  /* Time spent in the kernel profiler events, in seconds summed over all rendering threads, keyed
+   * by the event path such as "Shade Surface/Direct Light". */
+  map<string, double> profiler;
+};
+
+/* Measurement of a kernel microbenchmark on a single CPU microarchitecture. */
+struct KernelBenchmarkResult {
+  /* Identifier of the benchmark, such as "intersect_closest/hair". */
+  string name;
+  /* Microarchitecture of the kernel, such as "AVX2". */
+  string uarch;
+
+  /* Average time of a single operation, in nanoseconds. */
+  double ns_per_op = 0.0;
+  /* Number of measured operations. */
+  uint64_t num_ops = 0;
+};
+
+/* Information about the run which applies to all scenes. */
+struct BenchmarkRunInfo {
+  string version;
+  string device;
+  int threads = 0;
+};
+
+/* Serialize results into a JSON document. */
+string benchmark_results_to_json(const BenchmarkRunInfo &info,
+                                 const vector<BenchmarkResult> &results);
+
+/* Read numeric values of a JSON document written by `benchmark_results_to_json()`, flattened to
+ * dot-separated keys, such as "scenes.hair.render_time". Returns false if the document could not
+ * be parsed. */
+bool benchmark_json_read_metrics(const string &json, map<string, double> &metrics);
+
+/* Compare results against metrics of a baseline run.
+ *
+ * A metric is considered to be regressed when it got worse by more than the given relative
+ * tolerance. Returns human-readable report of the comparison. */
+string benchmark_compare(const vector<BenchmarkResult> &results,
+                         const map<string, double> &baseline,
+                         const double tolerance,
+                         bool &has_regression);
+
+/* Same as above, for the kernel microbenchmarks. Metrics of the baseline are keyed by
+ * "benchmarks.<name>.<uarch>.ns_per_op". */
+string kernel_benchmark_results_to_json(const BenchmarkRunInfo &info,
+                                        const vector<KernelBenchmarkResult> &results);
+string kernel_benchmark_compare(const vector<KernelBenchmarkResult> &results,
+                                const map<string, double> &baseline,
+                                const double tolerance,
+                                bool &has_regression);
+
+CCL_NAMESPACE_END
@@ -0,0 +1,783 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#include "benchmark/scenes.h"
+
+#include "scene/background.h"
+#include "scene/camera.h"
+#include "scene/hair.h"
+#include "scene/image.h"
+#include "scene/integrator.h"
+#include "scene/light.h"
+#include "scene/mesh.h"
+#include "scene/object.h"
+#include "scene/rhino_shader_nodes.h"
+#include "scene/scene.h"
+#include "scene/shader.h"
+#include "scene/shader_graph.h"
+#include "scene/shader_nodes.h"
+
+#include "util/algorithm.h"
+#include "util/hash.h"
+#include "util/math.h"
+#include "util/transform.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* --------------------------------------------------------------------
+ * Procedural image.
+ */
+
+/* Image loader which generates a colored checker pattern, so that texture-heavy scenes do not
+ * depend on image files on disk. Every seed gives a distinct image. */
+class BenchmarkImageLoader : public ImageLoader {
+ public:
+  BenchmarkImageLoader(const int seed, const int resolution)
+      : seed_(seed), resolution_(resolution)
+  {
+  }
+
+  bool load_metadata(const ImageDeviceFeatures & /*features*/, ImageMetaData &metadata) override
+  {
+    metadata.width = resolution_;
+    metadata.height = resolution_;
+    metadata.depth = 1;
+    metadata.channels = 4;
+    metadata.type = IMAGE_DATA_TYPE_BYTE4;
+    return true;
+  }
+
+  bool load_pixels(const ImageMetaData &metadata,
+                   void *pixels,
+                   const size_t /*pixels_size*/,
+                   const bool /*associate_alpha*/) override
+  {
+    const uchar4 color_a = color_from_hash(hash_uint2(seed_, 0));
+    const uchar4 color_b = color_from_hash(hash_uint2(seed_, 1));
+    const int checker_size = max(1, int(metadata.width) / 16);
+
+    uchar4 *pixel = (uchar4 *)pixels;
+    for (int y = 0; y < metadata.height; ++y) {
+      for (int x = 0; x < metadata.width; ++x, ++pixel) {
+        *pixel = ((x / checker_size + y / checker_size) & 1) ? color_a : color_b;
+      }
+    }
+
+    return true;
+  }
+
+  string name() const override
+  {
+    return "benchmark_image_" + to_string(seed_);
+  }
+
+  bool equals(const ImageLoader &other) const override
+  {
+    const BenchmarkImageLoader &other_loader = (const BenchmarkImageLoader &)other;
+    return seed_ == other_loader.seed_ && resolution_ == other_loader.resolution_;
+  }
+
+ protected:
+  static uchar4 color_from_hash(const uint hash)
+  {
+    return make_uchar4(hash & 0xff, (hash >> 8) & 0xff, (hash >> 16) & 0xff, 255);
+  }
+
+  int seed_;
+  int resolution_;
+};
+
+/* --------------------------------------------------------------------
+ * Utilities.
+ */
+
+static float random_float(const uint index, const uint dimension)
+{
+  return hash_uint2_to_float(index, dimension);
+}
+
+static float3 random_color(const uint index)
+{
+  return make_float3(random_float(index, 10), random_float(index, 11), random_float(index, 12));
+}
+
+/* Permutation of 0..255, repeated twice so that lookups of a permuted index plus another byte
+ * stay in range, like the tables Rhino provides. */
+static vector<float> rhino_permutation_table(const uint dimension)
+{
+  int perm[256];
+  for (int i = 0; i < 256; i++) {
+    perm[i] = i;
+  }
+  for (int i = 255; i > 0; i--) {
+    const int j = min(int(random_float(i, dimension) * (i + 1)), i);
+    swap(perm[i], perm[j]);
+  }
+
+  vector<float> table(512);
+  for (int i = 0; i < 512; i++) {
+    table[i] = float(perm[i & 255]);
+  }
+  return table;
+}
+
+/* The Rhino noise procedurals read from tables provided by the host application, generate
+ * deterministic ones of the same layout. */
+static void rhino_noise_tables_setup(Scene *scene)
+{
+  /* Impulse position and weight, and the value noise in the -1..1 range. */
+  vector<float> impulse_table(256 * 4);
+  for (int i = 0; i < 256; i++) {
+    impulse_table[i * 4 + 0] = random_float(i, 20);
+    impulse_table[i * 4 + 1] = random_float(i, 21);
+    impulse_table[i * 4 + 2] = random_float(i, 22);
+    impulse_table[i * 4 + 3] = random_float(i, 23) * 2.0f - 1.0f;
+  }
+  vector<float> vc_table(256);
+  for (int i = 0; i < 256; i++) {
+    vc_table[i] = random_float(i, 24) * 2.0f - 1.0f;
+  }
+
+  ShaderManager *shader_manager = scene->shader_manager;
+  shader_manager->set_rhino_perlin_noise_table(rhino_permutation_table(25));
+  shader_manager->set_rhino_impulse_noise_table(impulse_table);
+  shader_manager->set_rhino_vc_noise_table(vc_table);
+  shader_manager->set_rhino_aaltonen_noise_table(rhino_permutation_table(26));
+}
+
+static void camera_setup(Scene *scene, const Transform &tfm, const float fov)
+{
+  Camera *camera = scene->camera;
+  camera->set_matrix(tfm);
+  camera->set_fov(fov);
+  camera->need_flags_update = true;
+}
+
+static void background_setup(Scene *scene, const float3 color, const float strength)
+{
+  ShaderGraph *graph = new ShaderGraph();
+
+  BackgroundNode *background = graph->create_node<BackgroundNode>();
+  background->set_color(color);
+  background->set_strength(strength);
+  graph->add(background);
+
+  graph->connect(background->output("Background"), graph->output()->input("Surface"));
+
+  Shader *shader = scene->default_background;
+  shader->set_graph(graph);
+  shader->tag_update(scene);
+}
+
+static Shader *shader_create(Scene *scene, const string &name, ShaderGraph *graph)
+{
+  Shader *shader = scene->create_node<Shader>();
+  shader->name = name;
+  shader->set_graph(graph);
+  shader->tag_update(scene);
+  return shader;
+}
+
+static Shader *shader_create_diffuse(Scene *scene, const string &name, const float3 color)
+{
+  ShaderGraph *graph = new ShaderGraph();
+
+  DiffuseBsdfNode *diffuse = graph->create_node<DiffuseBsdfNode>();
+  diffuse->set_color(color);
+  graph->add(diffuse);
+
+  graph->connect(diffuse->output("BSDF"), graph->output()->input("Surface"));
+
+  return shader_create(scene, name, graph);
+}
+
+static Mesh *mesh_create(Scene *scene, Shader *shader)
+{
+  Mesh *mesh = scene->create_node<Mesh>();
+
+  array<Node *> used_shaders;
+  used_shaders.push_back_slow(shader);
+  mesh->set_used_shaders(used_shaders);
+
+  return mesh;
+}
+
+static Object *object_create(Scene *scene, Geometry *geometry, const Transform &tfm)
+{
+  Object *object = scene->create_node<Object>();
+  object->set_geometry(geometry);
+  object->set_tfm(tfm);
+  return object;
+}
+
+/* Unit quad in the XZ plane, facing up, with UV coordinates. */
+static Mesh *mesh_create_plane(Scene *scene, Shader *shader)
+{
+  Mesh *mesh = mesh_create(scene, shader);
+
+  mesh->reserve_mesh(4, 2);
+  mesh->add_vertex(make_float3(-0.5f, 0.0f, -0.5f));
+  mesh->add_vertex(make_float3(0.5f, 0.0f, -0.5f));
+  mesh->add_vertex(make_float3(0.5f, 0.0f, 0.5f));
+  mesh->add_vertex(make_float3(-0.5f, 0.0f, 0.5f));
+  mesh->add_triangle(0, 1, 2, 0, false);
+  mesh->add_triangle(0, 2, 3, 0, false);
+
+  Attribute *attr = mesh->attributes.add(ATTR_STD_UV, ustring("UVMap"));
+  float2 *uv = attr->data_float2();
+  const float2 corners[4] = {make_float2(0.0f, 0.0f),
+                             make_float2(1.0f, 0.0f),
+                             make_float2(1.0f, 1.0f),
+                             make_float2(0.0f, 1.0f)};
+  const int triangles[6] = {0, 1, 2, 0, 2, 3};
+  for (int i = 0; i < 6; ++i) {
+    uv[i] = corners[triangles[i]];
+  }
+
+  return mesh;
+}
+
+/* Unit cube centered at the origin. */
+static Mesh *mesh_create_box(Scene *scene, Shader *shader)
+{
+  Mesh *mesh = mesh_create(scene, shader);
+
+  mesh->reserve_mesh(8, 12);
+  for (int i = 0; i < 8; ++i) {
+    mesh->add_vertex(make_float3((i & 1) ? 0.5f : -0.5f,
+                                 (i & 2) ? 0.5f : -0.5f,
+                                 (i & 4) ? 0.5f : -0.5f));
+  }
+
+  const int quads[6][4] = {
+      {0, 2, 3, 1}, {4, 5, 7, 6}, {0, 1, 5, 4}, {2, 6, 7, 3}, {0, 4, 6, 2}, {1, 3, 7, 5}};
+  for (int i = 0; i < 6; ++i) {
+    mesh->add_triangle(quads[i][0], quads[i][1], quads[i][2], 0, false);
+    mesh->add_triangle(quads[i][0], quads[i][2], quads[i][3], 0, false);
+  }
+
+  return mesh;
+}
+
+/* UV sphere with the given radius centered at the origin. */
+static Mesh *mesh_create_sphere(Scene *scene,
+                                Shader *shader,
+                                const float radius,
+                                const int segments,
+                                const int rings)
+{
+  Mesh *mesh = mesh_create(scene, shader);
+
+  const int num_verts = segments * (rings - 1) + 2;
+  const int num_triangles = segments * (rings - 1) * 2;
+  mesh->reserve_mesh(num_verts, num_triangles);
+
+  /* Poles. */
+  mesh->add_vertex(make_float3(0.0f, radius, 0.0f));
+  mesh->add_vertex(make_float3(0.0f, -radius, 0.0f));
+
+  for (int ring = 1; ring < rings; ++ring) {
+    const float theta = M_PI_F * ring / rings;
+    for (int segment = 0; segment < segments; ++segment) {
+      const float phi = M_2PI_F * segment / segments;
+      mesh->add_vertex(make_float3(radius * sinf(theta) * cosf(phi),
+                                   radius * cosf(theta),
+                                   radius * sinf(theta) * sinf(phi)));
+    }
+  }
+
+  const auto ring_vertex = [segments](const int ring, const int segment) {
+    return 2 + (ring - 1) * segments + (segment % segments);
+  };
+
+  for (int segment = 0; segment < segments; ++segment) {
+    mesh->add_triangle(0, ring_vertex(1, segment + 1), ring_vertex(1, segment), 0, true);
+    mesh->add_triangle(
+        1, ring_vertex(rings - 1, segment), ring_vertex(rings - 1, segment + 1), 0, true);
+  }
+
+  for (int ring = 1; ring < rings - 1; ++ring) {
+    for (int segment = 0; segment < segments; ++segment) {
+      const int v0 = ring_vertex(ring, segment);
+      const int v1 = ring_vertex(ring, segment + 1);
+      const int v2 = ring_vertex(ring + 1, segment + 1);
+      const int v3 = ring_vertex(ring + 1, segment);
+      mesh->add_triangle(v0, v1, v2, 0, true);
+      mesh->add_triangle(v0, v2, v3, 0, true);
+    }
+  }
+
+  return mesh;
+}
+
+static void ground_create(Scene *scene, const float size)
+{
+  Shader *shader = shader_create_diffuse(scene, "ground", make_float3(0.5f, 0.5f, 0.5f));
+  Mesh *mesh = mesh_create_plane(scene, shader);
+  object_create(
+      scene, mesh, transform_translate(0.0f, -1.0f, 0.0f) * transform_scale(size, 1.0f, size));
+}
+
+static Light *point_light_create(Scene *scene, const float3 co, const float3 strength)
+{
+  Light *light = scene->create_node<Light>();
+  light->set_light_type(LIGHT_POINT);
+  light->set_co(co);
+  light->set_strength(strength);
+  light->set_size(0.1f);
+  light->set_shader(scene->default_light);
+  return light;
+}
+
+/* --------------------------------------------------------------------
+ * Scenes.
+ */
+
+/* Many instances of a moderately dense mesh: stresses BVH build of the top level and instance
+ * traversal. */
+static void scene_create_instancing(Scene *scene)
+{
+  camera_setup(scene, transform_translate(0.0f, 2.0f, -14.0f), 60.0f * (M_PI_F / 180.0f));
+  background_setup(scene, make_float3(0.6f, 0.7f, 0.9f), 1.0f);
+  ground_create(scene, 40.0f);
+
+  Shader *shader = shader_create_diffuse(scene, "instance", make_float3(0.8f, 0.3f, 0.2f));
+  Mesh *mesh = mesh_create_sphere(scene, shader, 0.15f, 32, 16);
+
+  const int grid_size = 48;
+  for (int z = 0; z < grid_size; ++z) {
+    for (int x = 0; x < grid_size; ++x) {
+      const uint index = z * grid_size + x;
+      const float height = random_float(index, 0) * 2.0f;
+      object_create(scene,
+                    mesh,
+                    transform_translate(
+                        (x - grid_size * 0.5f) * 0.4f, height - 0.8f, z * 0.4f - 2.0f));
+    }
+  }
+}
+
+/* Grid of planes with distinct image textures in the given colorspace. */
+static void image_textures_create(Scene *scene, const ustring colorspace)
+{
+  camera_setup(scene, transform_translate(0.0f, 4.0f, -8.0f), 60.0f * (M_PI_F / 180.0f));
+  background_setup(scene, make_float3(1.0f, 1.0f, 1.0f), 1.0f);
+
+  const int grid_size = 8;
+  const int resolution = 512;
+  for (int z = 0; z < grid_size; ++z) {
+    for (int x = 0; x < grid_size; ++x) {
+      const int index = z * grid_size + x;
+
+      ShaderGraph *graph = new ShaderGraph();
+
+      ImageTextureNode *image = graph->create_node<ImageTextureNode>();
+      image->set_colorspace(colorspace);
+      image->handle = scene->image_manager->add_image(
+          new BenchmarkImageLoader(index, resolution), image->image_params());
+      graph->add(image);
+
+      DiffuseBsdfNode *diffuse = graph->create_node<DiffuseBsdfNode>();
+      graph->add(diffuse);
+
+      graph->connect(image->output("Color"), diffuse->input("Color"));
+      graph->connect(diffuse->output("BSDF"), graph->output()->input("Surface"));
+
+      Shader *shader = shader_create(scene, "texture_" + to_string(index), graph);
+      Mesh *mesh = mesh_create_plane(scene, shader);
+      object_create(scene,
+                    mesh,
+                    transform_translate(x - grid_size * 0.5f + 0.5f, -1.0f, float(z)) *
+                        transform_scale(0.95f, 1.0f, 0.95f));
+    }
+  }
+}
+
+/* Many distinct image textures: stresses image loading and texture lookups. */
+static void scene_create_textures(Scene *scene)
+{
+  image_textures_create(scene, u_colorspace_auto);
+}
+
+/* Image textures in a colorspace that is not scene linear: stresses the colorspace conversion
+ * of 8 bit images while loading. Falls back to raw if the OCIO config lacks the colorspace. */
+static void scene_create_textures_colorspace(Scene *scene)
+{
+  image_textures_create(scene, ustring("Linear Rec.2020"));
+}
+
+/* Same as above with a colorspace that applies the sRGB transfer curve before its gamut matrix,
+ * which is the common case for textures painted in a wide gamut display colorspace. */
+static void scene_create_textures_colorspace_curve(Scene *scene)
+{
+  image_textures_create(scene, ustring("Display P3"));
+}
+
+/* Heterogeneous scattering volume: stresses volume stepping and shading. */
+static void scene_create_volume(Scene *scene)
+{
+  camera_setup(scene, transform_translate(0.0f, 0.5f, -6.0f), 50.0f * (M_PI_F / 180.0f));
+  background_setup(scene, make_float3(0.2f, 0.2f, 0.25f), 1.0f);
+  ground_create(scene, 20.0f);
+
+  ShaderGraph *graph = new ShaderGraph();
+
+  NoiseTextureNode *noise = graph->create_node<NoiseTextureNode>();
+  noise->set_scale(3.0f);
+  noise->set_detail(4.0f);
+  graph->add(noise);
+
+  PrincipledVolumeNode *volume = graph->create_node<PrincipledVolumeNode>();
+  volume->set_color(make_float3(0.8f, 0.8f, 0.8f));
+  graph->add(volume);
+
+  graph->connect(noise->output("Fac"), volume->input("Density"));
+  graph->connect(volume->output("Volume"), graph->output()->input("Volume"));
+
+  Shader *shader = shader_create(scene, "volume", graph);
+  Mesh *mesh = mesh_create_box(scene, shader);
+  object_create(scene, mesh, transform_scale(3.0f, 2.0f, 3.0f));
+
+  point_light_create(scene, make_float3(2.0f, 3.0f, -2.0f), make_float3(400.0f, 380.0f, 350.0f));
+}
+
+/* Dense patch of curves: stresses curve intersection and hair shading. */
+static void scene_create_hair(Scene *scene)
+{
+  camera_setup(scene, transform_translate(0.0f, 0.5f, -4.0f), 50.0f * (M_PI_F / 180.0f));
+  background_setup(scene, make_float3(0.8f, 0.8f, 0.8f), 1.0f);
+
+  ShaderGraph *graph = new ShaderGraph();
+  PrincipledHairBsdfNode *hair_bsdf = graph->create_node<PrincipledHairBsdfNode>();
+  graph->add(hair_bsdf);
+  graph->connect(hair_bsdf->output("BSDF"), graph->output()->input("Surface"));
+  Shader *shader = shader_create(scene, "hair", graph);
+
+  Hair *hair = scene->create_node<Hair>();
+  array<Node *> used_shaders;
+  used_shaders.push_back_slow(shader);
+  hair->set_used_shaders(used_shaders);
+
+  const int num_curves = 40000;
+  const int num_keys = 8;
+  hair->reserve_curves(num_curves, num_curves * num_keys);
+
+  for (int curve = 0; curve < num_curves; ++curve) {
+    const float3 root = make_float3(random_float(curve, 0) * 3.0f - 1.5f,
+                                    -1.0f,
+                                    random_float(curve, 1) * 3.0f - 1.5f);
+    const float3 bend = make_float3(
+        random_float(curve, 2) - 0.5f, 0.0f, random_float(curve, 3) - 0.5f);
+
+    hair->add_curve(curve * num_keys, 0);
+    for (int key = 0; key < num_keys; ++key) {
+      const float t = float(key) / (num_keys - 1);
+      hair->add_curve_key(root + make_float3(0.0f, t * 1.5f, 0.0f) + bend * (t * t),
+                          0.005f * (1.0f - t * 0.8f));
+    }
+  }
+
+  object_create(scene, hair, transform_identity());
+}
+
+/* Large number of small lights: stresses light tree build and light sampling. */
+static void scene_create_many_lights(Scene *scene)
+{
+  camera_setup(scene, transform_translate(0.0f, 3.0f, -10.0f), 60.0f * (M_PI_F / 180.0f));
+  background_setup(scene, make_float3(0.0f, 0.0f, 0.0f), 0.0f);
+  ground_create(scene, 30.0f);
+
+  Shader *shader = shader_create_diffuse(scene, "sphere", make_float3(0.8f, 0.8f, 0.8f));
+  Mesh *mesh = mesh_create_sphere(scene, shader, 0.5f, 32, 16);
+  for (int i = 0; i < 16; ++i) {
+    object_create(scene,
+                  mesh,
+                  transform_translate((i % 4) * 2.0f - 3.0f, -0.5f, (i / 4) * 2.0f - 1.0f));
+  }
+
+  const int num_lights = 2048;
+  for (int i = 0; i < num_lights; ++i) {
+    const float3 co = make_float3(random_float(i, 0) * 16.0f - 8.0f,
+                                  random_float(i, 1) * 2.0f - 0.8f,
+                                  random_float(i, 2) * 16.0f - 4.0f);
+    point_light_create(scene, co, random_color(i) * 2.0f);
+  }
+}
+
+/* Layered Rhino procedural textures: stresses the SVM interpreter with the Rhino nodes. */
+static void scene_create_rhino_procedurals(Scene *scene)
+{
+  camera_setup(scene, transform_translate(0.0f, 1.0f, -7.0f), 50.0f * (M_PI_F / 180.0f));
+  background_setup(scene, make_float3(0.9f, 0.9f, 0.9f), 1.0f);
+  ground_create(scene, 20.0f);
+  rhino_noise_tables_setup(scene);
+
+  ShaderGraph *graph = new ShaderGraph();
+
+  TextureCoordinateNode *texco = graph->create_node<TextureCoordinateNode>();
+  graph->add(texco);
+
+  RhinoCheckerTextureNode *checker = graph->create_node<RhinoCheckerTextureNode>();
+  checker->color1 = make_float3(0.9f, 0.9f, 0.9f);
+  checker->color2 = make_float3(0.1f, 0.1f, 0.1f);
+  graph->add(checker);
+
+  RhinoNoiseTextureNode *noise = graph->create_node<RhinoNoiseTextureNode>();
+  noise->noise_type = RHINO_NOISE_PERLIN;
+  noise->spec_synth_type = RHINO_SPEC_SYNTH_FRACTAL_SUM;
+  noise->octave_count = 6;
+  noise->frequency_multiplier = 2.0f;
+  noise->amplitude_multiplier = 0.5f;
+  noise->clamp_min = -1.0f;
+  noise->clamp_max = 1.0f;
+  noise->scale_to_clamp = false;
+  noise->inverse = false;
+  noise->gain = 0.5f;
+  noise->color2 = make_float3(0.2f, 0.4f, 0.8f);
+  graph->add(noise);
+
+  RhinoFbmTextureNode *fbm = graph->create_node<RhinoFbmTextureNode>();
+  fbm->is_turbulent = true;
+  fbm->max_octaves = 6;
+  fbm->gain = 0.5f;
+  fbm->roughness = 0.5f;
+  fbm->color2 = make_float3(0.8f, 0.5f, 0.2f);
+  graph->add(fbm);
+
+  DiffuseBsdfNode *diffuse = graph->create_node<DiffuseBsdfNode>();
+  graph->add(diffuse);
+
+  /* Chain the textures so that every one of them is evaluated for every shading point. */
+  graph->connect(texco->output("Object"), checker->input("UVW"));
+  graph->connect(texco->output("Object"), noise->input("UVW"));
+  graph->connect(texco->output("Object"), fbm->input("UVW"));
+  graph->connect(checker->output("Color"), noise->input("Color1"));
+  graph->connect(noise->output("Color"), fbm->input("Color1"));
+  graph->connect(fbm->output("Color"), diffuse->input("Color"));
+  graph->connect(diffuse->output("BSDF"), graph->output()->input("Surface"));
+
+  Shader *shader = shader_create(scene, "rhino_procedural", graph);
+  Mesh *mesh = mesh_create_sphere(scene, shader, 1.0f, 64, 32);
+  for (int i = 0; i < 3; ++i) {
+    object_create(scene, mesh, transform_translate((i - 1) * 2.2f, 0.0f, 0.0f));
+  }
+}
+
+/* --------------------------------------------------------------------
+ * Shader scenes.
+ *
+ * A single plane which fills the entire camera view, so that every camera ray hits a surface
+ * with the shader under test.
+ */
+
+static void shader_scene_create(Scene *scene, const string &name, ShaderGraph *graph)
+{
+  camera_setup(scene, transform_identity(), 50.0f * (M_PI_F / 180.0f));
+  background_setup(scene, make_float3(0.5f, 0.5f, 0.5f), 1.0f);
+
+  Shader *shader = shader_create(scene, name, graph);
+  Mesh *mesh = mesh_create_plane(scene, shader);
+  object_create(scene,
+                mesh,
+                transform_translate(0.0f, 0.0f, 2.0f) *
+                    transform_rotate(-M_PI_2_F, make_float3(1.0f, 0.0f, 0.0f)) *
+                    transform_scale(8.0f, 1.0f, 8.0f));
+}
+
+/* Connect color output of a texture node to a diffuse BSDF, with the object space texture
+ * coordinate as an input of the texture. */
+static ShaderGraph *texture_graph_create(ShaderNode *texture,
+                                         ShaderGraph *graph,
+                                         const char *vector_input,
+                                         const char *color_output)
+{
+  TextureCoordinateNode *texco = graph->create_node<TextureCoordinateNode>();
+  graph->add(texco);
+  graph->add(texture);
+
+  DiffuseBsdfNode *diffuse = graph->create_node<DiffuseBsdfNode>();
+  graph->add(diffuse);
+
+  graph->connect(texco->output("Object"), texture->input(vector_input));
+  graph->connect(texture->output(color_output), diffuse->input("Color"));
+  graph->connect(diffuse->output("BSDF"), graph->output()->input("Surface"));
+
+  return graph;
+}
+
+static ShaderGraph *bsdf_graph_create(ShaderGraph *graph, ShaderNode *bsdf)
+{
+  graph->add(bsdf);
+  graph->connect(bsdf->output("BSDF"), graph->output()->input("Surface"));
+  return graph;
+}
+
+static void shader_scene_create_diffuse(Scene *scene)
+{
+  ShaderGraph *graph = new ShaderGraph();
+  DiffuseBsdfNode *diffuse = graph->create_node<DiffuseBsdfNode>();
+  diffuse->set_color(make_float3(0.8f, 0.8f, 0.8f));
+  shader_scene_create(scene, "diffuse", bsdf_graph_create(graph, diffuse));
+}
+
+static void shader_scene_create_glossy(Scene *scene, const ClosureType distribution)
+{
+  ShaderGraph *graph = new ShaderGraph();
+  GlossyBsdfNode *glossy = graph->create_node<GlossyBsdfNode>();
+  glossy->set_distribution(distribution);
+  glossy->set_roughness(0.3f);
+  shader_scene_create(scene, "glossy", bsdf_graph_create(graph, glossy));
+}
+
+static void shader_scene_create_glass(Scene *scene)
+{
+  ShaderGraph *graph = new ShaderGraph();
+  GlassBsdfNode *glass = graph->create_node<GlassBsdfNode>();
+  glass->set_distribution(CLOSURE_BSDF_MICROFACET_GGX_GLASS_ID);
+  glass->set_roughness(0.2f);
+  glass->set_IOR(1.45f);
+  shader_scene_create(scene, "glass", bsdf_graph_create(graph, glass));
+}
+
+static void shader_scene_create_principled(Scene *scene)
+{
+  ShaderGraph *graph = new ShaderGraph();
+  PrincipledBsdfNode *principled = graph->create_node<PrincipledBsdfNode>();
+  principled->set_base_color(make_float3(0.8f, 0.4f, 0.2f));
+  principled->set_roughness(0.4f);
+  principled->set_metallic(0.3f);
+  principled->set_clearcoat(0.5f);
+  shader_scene_create(scene, "principled", bsdf_graph_create(graph, principled));
+}
+
+static void shader_scene_create_rhino_checker(Scene *scene)
+{
+  ShaderGraph *graph = new ShaderGraph();
+  RhinoCheckerTextureNode *checker = graph->create_node<RhinoCheckerTextureNode>();
+  checker->color1 = make_float3(0.9f, 0.9f, 0.9f);
+  checker->color2 = make_float3(0.1f, 0.1f, 0.1f);
+  shader_scene_create(
+      scene, "rhino_checker", texture_graph_create(checker, graph, "UVW", "Color"));
+}
+
+static void shader_scene_create_rhino_noise(Scene *scene)
+{
+  ShaderGraph *graph = new ShaderGraph();
+  RhinoNoiseTextureNode *noise = graph->create_node<RhinoNoiseTextureNode>();
+  noise->noise_type = RHINO_NOISE_PERLIN;
+  noise->spec_synth_type = RHINO_SPEC_SYNTH_FRACTAL_SUM;
+  noise->octave_count = 6;
+  noise->frequency_multiplier = 2.0f;
+  noise->amplitude_multiplier = 0.5f;
+  noise->clamp_min = -1.0f;
+  noise->clamp_max = 1.0f;
+  noise->scale_to_clamp = false;
+  noise->inverse = false;
+  noise->gain = 0.5f;
+  noise->color1 = make_float3(0.0f, 0.0f, 0.0f);
+  noise->color2 = make_float3(1.0f, 1.0f, 1.0f);
+  rhino_noise_tables_setup(scene);
+  shader_scene_create(scene, "rhino_noise", texture_graph_create(noise, graph, "UVW", "Color"));
+}
+
+static void shader_scene_create_rhino_fbm(Scene *scene)
+{
+  ShaderGraph *graph = new ShaderGraph();
+  RhinoFbmTextureNode *fbm = graph->create_node<RhinoFbmTextureNode>();
+  fbm->is_turbulent = false;
+  fbm->max_octaves = 6;
+  fbm->gain = 0.5f;
+  fbm->roughness = 0.5f;
+  fbm->color1 = make_float3(0.0f, 0.0f, 0.0f);
+  fbm->color2 = make_float3(1.0f, 1.0f, 1.0f);
+  rhino_noise_tables_setup(scene);
+  shader_scene_create(scene, "rhino_fbm", texture_graph_create(fbm, graph, "UVW", "Color"));
+}
+
+static void shader_scene_create_noise_texture(Scene *scene)
+{
+  ShaderGraph *graph = new ShaderGraph();
+  NoiseTextureNode *noise = graph->create_node<NoiseTextureNode>();
+  noise->set_scale(5.0f);
+  noise->set_detail(4.0f);
+  shader_scene_create(
+      scene, "noise_texture", texture_graph_create(noise, graph, "Vector", "Color"));
+}
+
+static void shader_scene_create_voronoi_texture(Scene *scene)
+{
+  ShaderGraph *graph = new ShaderGraph();
+  VoronoiTextureNode *voronoi = graph->create_node<VoronoiTextureNode>();
+  voronoi->set_scale(5.0f);
+  shader_scene_create(
+      scene, "voronoi_texture", texture_graph_create(voronoi, graph, "Vector", "Color"));
+}
+
+static void shader_scene_create_image_texture(Scene *scene)
+{
+  ShaderGraph *graph = new ShaderGraph();
+  ImageTextureNode *image = graph->create_node<ImageTextureNode>();
+  image->handle = scene->image_manager->add_image(new BenchmarkImageLoader(0, 1024),
+                                                  image->image_params());
+  shader_scene_create(
+      scene, "image_texture", texture_graph_create(image, graph, "Vector", "Color"));
+}
+
+const vector<BenchmarkScene> &benchmark_scenes()
+{
+  static const vector<BenchmarkScene> scenes = {
+      {"instancing", "Thousands of instances of a sphere mesh", scene_create_instancing},
+      {"textures", "Many distinct procedurally generated image textures", scene_create_textures},
+      {"textures_colorspace",
+       "Procedurally generated image textures converted from Linear Rec.2020",
+       scene_create_textures_colorspace},
+      {"textures_colorspace_curve",
+       "Procedurally generated image textures converted from Display P3",
+       scene_create_textures_colorspace_curve},
+      {"volume", "Heterogeneous scattering volume lit by a point light", scene_create_volume},
+      {"hair", "Dense patch of curves with principled hair shading", scene_create_hair},
+      {"many_lights",
+       "Thousands of point lights sampled with the light tree",
+       scene_create_many_lights},
+      {"rhino_procedurals", "Chained Rhino procedural textures", scene_create_rhino_procedurals},
+  };
+  return scenes;
+}
+
+const vector<BenchmarkScene> &benchmark_node_scenes()
+{
+  static const vector<BenchmarkScene> scenes = {
+      {"diffuse",
+       "Constant diffuse BSDF, the baseline of the other nodes",
+       shader_scene_create_diffuse},
+      {"rhino_checker", "Rhino checker texture", shader_scene_create_rhino_checker},
+      {"rhino_noise",
+       "Rhino Perlin noise texture with 6 octaves",
+       shader_scene_create_rhino_noise},
+      {"rhino_fbm", "Rhino fBm texture with 6 octaves", shader_scene_create_rhino_fbm},
+      {"noise_texture", "Noise texture with 4 octaves", shader_scene_create_noise_texture},
+      {"voronoi_texture", "Voronoi texture", shader_scene_create_voronoi_texture},
+      {"image_texture", "Byte image texture", shader_scene_create_image_texture},
+  };
+  return scenes;
+}
+
+const vector<BenchmarkScene> &benchmark_bsdf_scenes()
+{
+  static const vector<BenchmarkScene> scenes = {
+      {"diffuse", "Diffuse BSDF", shader_scene_create_diffuse},
+      {"glossy_ggx",
+       "GGX microfacet reflection",
+       [](Scene *scene) { shader_scene_create_glossy(scene, CLOSURE_BSDF_MICROFACET_GGX_ID); }},
+      {"glossy_multi_ggx",
+       "Multiple scattering GGX microfacet reflection",
+       [](Scene *scene) {
+         shader_scene_create_glossy(scene, CLOSURE_BSDF_MICROFACET_MULTI_GGX_ID);
+       }},
+      {"glass_ggx", "GGX microfacet glass", shader_scene_create_glass},
+      {"principled", "Principled BSDF with clearcoat", shader_scene_create_principled},
+  };
+  return scenes;
+}
+
+CCL_NAMESPACE_END
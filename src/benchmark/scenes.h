@@ -0,0 +1,40 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#pragma once
+
+#include "util/function.h"
+#include "util/string.h"
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+class Scene;
+
+/* Canonical scene of the benchmark suite.
+ *
+ * The scenes are generated procedurally, so that the suite does not depend on any external assets
+ * and produces the same geometry, shaders and lights on every run. Each scene stresses a specific
+ * part of the renderer. */
+struct BenchmarkScene {
+  /* Identifier of the scene, used in the results and on the command line. */
+  string name;
+
+  /* Short human readable description of what the scene is stressing. */
+  string description;
+
+  /* Populate the scene of a session. The camera resolution is set by the caller. */
+  function<void(Scene *scene)> create;
+};
+
+/* Get all scenes of the benchmark suite, in the order they are to be rendered. */
+const vector<BenchmarkScene> &benchmark_scenes();
+
+/* Scenes of the kernel microbenchmarks, consisting of a single plane which fills the camera view.
+ *
+ * Node scenes isolate a single SVM node feeding into a diffuse BSDF, BSDF scenes isolate a single
+ * closure. */
+const vector<BenchmarkScene> &benchmark_node_scenes();
+const vector<BenchmarkScene> &benchmark_bsdf_scenes();
+
+CCL_NAMESPACE_END
@@ -49,10 +49,10 @@ static bool rtc_memory_monitor_func(void *userPtr, const ssize_t bytes, const bo
   Stats *stats = (Stats *)userPtr;
   if (stats) {
     if (bytes > 0) {
-      stats->mem_alloc(bytes);
+      stats->mem_alloc(bytes, MEM_CATEGORY_BVH);
     }
     else {
-      stats->mem_free(-bytes);
+      stats->mem_free(-bytes, MEM_CATEGORY_BVH);
     }
   }
   else {
@@ -22,6 +22,7 @@ extern "C" {
 
 CCL_CAPI void CDECL cycles_scene_set_background_transparent(ccl::Session* session_id, bool transparent)
 {
+	CCYCLES_CAPTURE(cycles_scene_set_background_transparent, session_id, transparent);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->background->set_transparent(transparent);
@@ -32,6 +33,7 @@ CCL_CAPI void CDECL cycles_scene_set_background_transparent(ccl::Session* sessio
 
 CCL_CAPI void CDECL cycles_scene_set_background_visibility(ccl::Session* session_id, unsigned int path_ray_flag)
 {
+	CCYCLES_CAPTURE(cycles_scene_set_background_visibility, session_id, path_ray_flag);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->background->set_visibility((ccl::PathRayFlag)path_ray_flag);
@@ -44,3 +46,5 @@ CCL_CAPI void CDECL cycles_scene_set_background_visibility(ccl::Session* session
 }
 #endif
 
+CCYCLES_CAPTURE_REPLAY(cycles_scene_set_background_transparent);
+CCYCLES_CAPTURE_REPLAY(cycles_scene_set_background_visibility);
@@ -18,6 +18,7 @@ limitations under the License.
 
 void cycles_camera_set_size(ccl::Session* session_id, unsigned int width, unsigned int height)
 {
+	CCYCLES_CAPTURE(cycles_camera_set_size, session_id, width, height);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
         // TODO: find out if need to set full_width and full_height
@@ -50,6 +51,7 @@ unsigned int cycles_camera_get_height(ccl::Session* session_id)
 
 void cycles_camera_set_type(ccl::Session* session_id, camera_type type)
 {
+	CCYCLES_CAPTURE(cycles_camera_set_type, session_id, type);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->camera->set_camera_type((ccl::CameraType)type);
@@ -58,6 +60,7 @@ void cycles_camera_set_type(ccl::Session* session_id, camera_type type)
 
 void cycles_camera_set_panorama_type(ccl::Session* session_id, panorama_type type)
 {
+	CCYCLES_CAPTURE(cycles_camera_set_panorama_type, session_id, type);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->camera->set_panorama_type((ccl::PanoramaType)type);
@@ -70,6 +73,7 @@ void cycles_camera_set_matrix(ccl::Session* session_id,
 	float i, float j, float k, float l
 	)
 {
+	CCYCLES_CAPTURE(cycles_camera_set_matrix, session_id, a, b, c, d, e, f, g, h, i, j, k, l);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		ccl::Transform mat = ccl::make_transform(a, b, c, d, e, f, g, h, i, j, k, l);
@@ -79,6 +83,7 @@ void cycles_camera_set_matrix(ccl::Session* session_id,
 
 void cycles_camera_compute_auto_viewplane(ccl::Session* session_id)
 {
+	CCYCLES_CAPTURE(cycles_camera_compute_auto_viewplane, session_id);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->camera->compute_auto_viewplane();
@@ -87,6 +92,7 @@ void cycles_camera_compute_auto_viewplane(ccl::Session* session_id)
 
 void cycles_camera_set_viewplane(ccl::Session* session_id, float left, float right, float top, float bottom)
 {
+	CCYCLES_CAPTURE(cycles_camera_set_viewplane, session_id, left, right, top, bottom);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->camera->viewplane.left = left;
@@ -99,6 +105,7 @@ void cycles_camera_set_viewplane(ccl::Session* session_id, float left, float rig
 
 void cycles_camera_update(ccl::Session* session_id)
 {
+	CCYCLES_CAPTURE(cycles_camera_update, session_id);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->camera->update(sce);
@@ -122,6 +129,7 @@ void cycles_camera_update(ccl::Session* session_id)
 
 void cycles_camera_set_fov(ccl::Session* session_id, float fov)
 {
+	CCYCLES_CAPTURE(cycles_camera_set_fov, session_id, fov);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->camera->set_fov(fov);
@@ -130,6 +138,7 @@ void cycles_camera_set_fov(ccl::Session* session_id, float fov)
 
 void cycles_camera_set_sensor_width(ccl::Session* session_id, float sensor_width)
 {
+	CCYCLES_CAPTURE(cycles_camera_set_sensor_width, session_id, sensor_width);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->camera->set_sensorwidth(sensor_width);
@@ -138,6 +147,7 @@ void cycles_camera_set_sensor_width(ccl::Session* session_id, float sensor_width
 
 void cycles_camera_set_sensor_height(ccl::Session* session_id, float sensor_height)
 {
+	CCYCLES_CAPTURE(cycles_camera_set_sensor_height, session_id, sensor_height);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->camera->set_sensorheight(sensor_height);
@@ -146,6 +156,7 @@ void cycles_camera_set_sensor_height(ccl::Session* session_id, float sensor_heig
 
 void cycles_camera_set_nearclip(ccl::Session* session_id, float nearclip)
 {
+	CCYCLES_CAPTURE(cycles_camera_set_nearclip, session_id, nearclip);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->camera->set_nearclip(nearclip);
@@ -154,6 +165,7 @@ void cycles_camera_set_nearclip(ccl::Session* session_id, float nearclip)
 
 void cycles_camera_set_farclip(ccl::Session* session_id, float farclip)
 {
+	CCYCLES_CAPTURE(cycles_camera_set_farclip, session_id, farclip);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->camera->set_farclip(farclip);
@@ -162,6 +174,7 @@ void cycles_camera_set_farclip(ccl::Session* session_id, float farclip)
 
 void cycles_camera_set_aperturesize(ccl::Session* session_id, float aperturesize)
 {
+	CCYCLES_CAPTURE(cycles_camera_set_aperturesize, session_id, aperturesize);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->camera->set_aperturesize(aperturesize);
@@ -170,6 +183,7 @@ void cycles_camera_set_aperturesize(ccl::Session* session_id, float aperturesize
 
 void cycles_camera_set_aperture_ratio(ccl::Session* session_id, float aperture_ratio)
 {
+	CCYCLES_CAPTURE(cycles_camera_set_aperture_ratio, session_id, aperture_ratio);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->camera->set_aperture_ratio(aperture_ratio);
@@ -178,6 +192,7 @@ void cycles_camera_set_aperture_ratio(ccl::Session* session_id, float aperture_r
 
 void cycles_camera_set_blades(ccl::Session* session_id, unsigned int blades)
 {
+	CCYCLES_CAPTURE(cycles_camera_set_blades, session_id, blades);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->camera->set_blades(blades);
@@ -186,6 +201,7 @@ void cycles_camera_set_blades(ccl::Session* session_id, unsigned int blades)
 
 void cycles_camera_set_bladesrotation(ccl::Session* session_id, float bladesrotation)
 {
+	CCYCLES_CAPTURE(cycles_camera_set_bladesrotation, session_id, bladesrotation);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->camera->set_bladesrotation(bladesrotation);
@@ -194,6 +210,7 @@ void cycles_camera_set_bladesrotation(ccl::Session* session_id, float bladesrota
 
 void cycles_camera_set_focaldistance(ccl::Session* session_id, float focaldistance)
 {
+	CCYCLES_CAPTURE(cycles_camera_set_focaldistance, session_id, focaldistance);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->camera->set_focaldistance(focaldistance);
@@ -202,6 +219,7 @@ void cycles_camera_set_focaldistance(ccl::Session* session_id, float focaldistan
 
 void cycles_camera_set_shuttertime(ccl::Session* session_id, float shuttertime)
 {
+	CCYCLES_CAPTURE(cycles_camera_set_shuttertime, session_id, shuttertime);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->camera->set_shuttertime(shuttertime);
@@ -210,6 +228,7 @@ void cycles_camera_set_shuttertime(ccl::Session* session_id, float shuttertime)
 
 void cycles_camera_set_fisheye_fov(ccl::Session* session_id, float fisheye_fov)
 {
+	CCYCLES_CAPTURE(cycles_camera_set_fisheye_fov, session_id, fisheye_fov);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->camera->set_fisheye_fov(fisheye_fov);
@@ -218,8 +237,30 @@ void cycles_camera_set_fisheye_fov(ccl::Session* session_id, float fisheye_fov)
 
 void cycles_camera_set_fisheye_lens(ccl::Session* session_id, float fisheye_lens)
 {
+	CCYCLES_CAPTURE(cycles_camera_set_fisheye_lens, session_id, fisheye_lens);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->camera->set_fisheye_lens(fisheye_lens);
 	}
 }
+
+CCYCLES_CAPTURE_REPLAY(cycles_camera_set_size);
+CCYCLES_CAPTURE_REPLAY(cycles_camera_set_type);
+CCYCLES_CAPTURE_REPLAY(cycles_camera_set_panorama_type);
+CCYCLES_CAPTURE_REPLAY(cycles_camera_set_matrix);
+CCYCLES_CAPTURE_REPLAY(cycles_camera_compute_auto_viewplane);
+CCYCLES_CAPTURE_REPLAY(cycles_camera_set_viewplane);
+CCYCLES_CAPTURE_REPLAY(cycles_camera_update);
+CCYCLES_CAPTURE_REPLAY(cycles_camera_set_fov);
+CCYCLES_CAPTURE_REPLAY(cycles_camera_set_sensor_width);
+CCYCLES_CAPTURE_REPLAY(cycles_camera_set_sensor_height);
+CCYCLES_CAPTURE_REPLAY(cycles_camera_set_nearclip);
+CCYCLES_CAPTURE_REPLAY(cycles_camera_set_farclip);
+CCYCLES_CAPTURE_REPLAY(cycles_camera_set_aperturesize);
+CCYCLES_CAPTURE_REPLAY(cycles_camera_set_aperture_ratio);
+CCYCLES_CAPTURE_REPLAY(cycles_camera_set_blades);
+CCYCLES_CAPTURE_REPLAY(cycles_camera_set_bladesrotation);
+CCYCLES_CAPTURE_REPLAY(cycles_camera_set_focaldistance);
+CCYCLES_CAPTURE_REPLAY(cycles_camera_set_shuttertime);
+CCYCLES_CAPTURE_REPLAY(cycles_camera_set_fisheye_fov);
+CCYCLES_CAPTURE_REPLAY(cycles_camera_set_fisheye_lens);
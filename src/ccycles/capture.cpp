@@ -0,0 +1,371 @@
+/**
+Copyright 2014-2022 Robert McNeel and Associates
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+#include "internal_types.h"
+
+#include "capture.h"
+
+#include "util/mapped_file.h"
+#include "util/path.h"
+#include "util/time.h"
+
+/* Capture file layout: header, followed by records. A function record assigns an id to a
+ * function name the first time it is called, call records refer to that id. */
+static const char CAPTURE_MAGIC[8] = { 'C', 'C', 'Y', 'C', 'C', 'A', 'P', 'T' };
+static const uint32_t CAPTURE_VERSION = 2;
+
+enum CaptureRecord : uint8_t {
+	CAPTURE_RECORD_FUNCTION = 1,
+	CAPTURE_RECORD_CALL = 2,
+};
+
+std::atomic<bool> ccycles_capture_enabled{ false };
+
+/* Depth of captured calls on this thread, to skip calls made from within captured calls. */
+static thread_local int capture_depth = 0;
+
+static std::mutex capture_mutex;
+static FILE* capture_file = nullptr;
+static double capture_start_time = 0.0;
+static std::map<std::string, uint32_t> capture_function_ids;
+/* Set when a write failed, further records are not written as the file would be corrupt. */
+static bool capture_write_failed = false;
+
+static void capture_write(const void* data, size_t size)
+{
+	if (capture_write_failed || size == 0) {
+		return;
+	}
+	if (fwrite(data, 1, size, capture_file) != size) {
+		capture_write_failed = true;
+	}
+}
+
+template<typename T> static void capture_write_value(const T& value)
+{
+	capture_write(&value, sizeof(T));
+}
+
+/* Close the capture file, returns false if any of the records failed to be written. */
+static bool capture_close()
+{
+	/* Closing flushes the buffered records, which can fail as well. */
+	if (fclose(capture_file) != 0) {
+		capture_write_failed = true;
+	}
+	capture_file = nullptr;
+	ccycles_capture_enabled = false;
+	return !capture_write_failed;
+}
+
+double ccycles_capture_time()
+{
+	return ccl::time_dt() - capture_start_time;
+}
+
+bool ccycles_capture_begin_call()
+{
+	return capture_depth++ == 0;
+}
+
+void ccycles_capture_end_call(const char* name,
+							  double start_time,
+							  CCCaptureValueType result_type,
+							  uint64_t result,
+							  const std::vector<uint8_t>& args)
+{
+	capture_depth--;
+
+	if (name == nullptr) {
+		return;
+	}
+
+	const double duration = ccycles_capture_time() - start_time;
+
+	std::lock_guard<std::mutex> lock(capture_mutex);
+	if (capture_file == nullptr) {
+		return;
+	}
+
+	uint32_t id;
+	auto it = capture_function_ids.find(name);
+	if (it == capture_function_ids.end()) {
+		id = (uint32_t)capture_function_ids.size();
+		capture_function_ids[name] = id;
+
+		const uint64_t length = strlen(name);
+		capture_write_value(CAPTURE_RECORD_FUNCTION);
+		capture_write_value(id);
+		capture_write_value(length);
+		capture_write(name, length);
+	}
+	else {
+		id = it->second;
+	}
+
+	capture_write_value(CAPTURE_RECORD_CALL);
+	capture_write_value(id);
+	capture_write_value(start_time);
+	capture_write_value(duration);
+	capture_write_value(result_type);
+	capture_write_value(result);
+	capture_write_value<uint64_t>(args.size());
+	capture_write(args.data(), args.size());
+
+	if (capture_write_failed) {
+		capture_close();
+		logger.logit("Failed to write capture file, capture stopped after call to ", name);
+	}
+}
+
+/* Registry of replayable functions. Function local, as registration happens during static
+ * initialization of the other files. */
+static std::map<std::string, CCCaptureReplayFunc>& capture_registry()
+{
+	static std::map<std::string, CCCaptureReplayFunc> registry;
+	return registry;
+}
+
+void ccycles_capture_register(const char* name, CCCaptureReplayFunc func)
+{
+	capture_registry()[name] = func;
+}
+
+void* CCCaptureReader::read_handle()
+{
+	const uint64_t handle = read_value<uint64_t>();
+	if (handle == 0 || handles == nullptr) {
+		return nullptr;
+	}
+	auto it = handles->find(handle);
+	if (it == handles->end()) {
+		logger.logit("Capture replay: unknown handle ", handle);
+		return nullptr;
+	}
+	return it->second;
+}
+
+uint64_t CCCaptureReader::read_id(CCCaptureValueType type, uint64_t value)
+{
+	if (type == CAPTURE_VALUE || ids == nullptr) {
+		return value;
+	}
+	auto it = ids->find({ type, value });
+	if (it == ids->end()) {
+		logger.logit("Capture replay: unknown id ", value);
+		return value;
+	}
+	return it->second;
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+CCL_CAPI bool CDECL cycles_capture_start(const char* filepath)
+{
+	std::lock_guard<std::mutex> lock(capture_mutex);
+
+	if (capture_file) {
+		return false;
+	}
+
+	capture_file = ccl::path_fopen(filepath, "wb");
+	if (capture_file == nullptr) {
+		logger.logit("Failed to open capture file ", filepath);
+		return false;
+	}
+
+	capture_write_failed = false;
+	capture_write(CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC));
+	capture_write_value(CAPTURE_VERSION);
+	if (capture_write_failed) {
+		capture_close();
+		logger.logit("Failed to write capture file ", filepath);
+		return false;
+	}
+
+	capture_function_ids.clear();
+	capture_start_time = ccl::time_dt();
+	ccycles_capture_enabled = true;
+
+	logger.logit("Started capture to ", filepath);
+	return true;
+}
+
+CCL_CAPI bool CDECL cycles_capture_stop()
+{
+	std::lock_guard<std::mutex> lock(capture_mutex);
+
+	ccycles_capture_enabled = false;
+	if (capture_file == nullptr) {
+		/* Stopped earlier because of a failed write. */
+		return !capture_write_failed;
+	}
+
+	if (!capture_close()) {
+		logger.logit("Stopped capture, failed to write the capture file");
+		return false;
+	}
+
+	logger.logit("Stopped capture");
+	return true;
+}
+
+CCL_CAPI bool CDECL cycles_capture_replay(const char* filepath, bool realtime, bool print_stats)
+{
+	/* A running capture, such as the one started by CCYCLES_CAPTURE, is suspended on this thread
+	 * while replaying, so the replayed calls are not recorded again. */
+	struct CaptureSuspend {
+		CaptureSuspend()
+		{
+			capture_depth++;
+		}
+		~CaptureSuspend()
+		{
+			capture_depth--;
+		}
+	} capture_suspend;
+
+	ccl::MappedFile file;
+	if (!file.open(filepath)) {
+		logger.logit("Failed to open capture file ", filepath);
+		return false;
+	}
+
+	CCCaptureReader reader(file.data(), file.size());
+	const void* magic = reader.read(sizeof(CAPTURE_MAGIC));
+	if (magic == nullptr || memcmp(magic, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC)) != 0 ||
+		reader.read_value<uint32_t>() != CAPTURE_VERSION)
+	{
+		logger.logit("Not a supported capture file: ", filepath);
+		return false;
+	}
+
+	struct FunctionStats {
+		std::string name;
+		CCCaptureReplayFunc func = nullptr;
+		uint64_t calls = 0;
+		double capture_time = 0.0;
+		double replay_time = 0.0;
+	};
+	std::vector<FunctionStats> functions;
+	std::map<uint64_t, void*> handles;
+	std::map<std::pair<CCCaptureValueType, uint64_t>, uint64_t> ids;
+
+	const double replay_start_time = ccl::time_dt();
+	bool ok = true;
+
+	while (ok && !reader.at_end()) {
+		const uint8_t record = reader.read_value<uint8_t>();
+
+		if (record == CAPTURE_RECORD_FUNCTION) {
+			const uint32_t id = reader.read_value<uint32_t>();
+			const char* name = reader.read_string<char>();
+			if (reader.has_error() || id != functions.size()) {
+				ok = false;
+				break;
+			}
+
+			FunctionStats stats;
+			stats.name = name;
+			auto it = capture_registry().find(stats.name);
+			if (it != capture_registry().end()) {
+				stats.func = it->second;
+			}
+			else {
+				logger.logit("Capture replay: skipping unknown function ", name);
+			}
+			functions.push_back(stats);
+		}
+		else if (record == CAPTURE_RECORD_CALL) {
+			const uint32_t id = reader.read_value<uint32_t>();
+			const double start_time = reader.read_value<double>();
+			const double duration = reader.read_value<double>();
+			const CCCaptureValueType result_type = static_cast<CCCaptureValueType>(
+				reader.read_value<uint8_t>());
+			const uint64_t result = reader.read_value<uint64_t>();
+			const uint64_t args_size = reader.read_value<uint64_t>();
+			const void* args = reader.read(args_size);
+			if (reader.has_error() || id >= functions.size()) {
+				ok = false;
+				break;
+			}
+
+			FunctionStats& stats = functions[id];
+			if (stats.func == nullptr) {
+				continue;
+			}
+
+			if (realtime) {
+				const double wait_time = start_time - (ccl::time_dt() - replay_start_time);
+				if (wait_time > 0.0) {
+					ccl::time_sleep(wait_time);
+				}
+			}
+
+			CCCaptureReader args_reader(static_cast<const uint8_t*>(args), args_size);
+			args_reader.handles = &handles;
+			args_reader.ids = &ids;
+
+			const double call_start_time = ccl::time_dt();
+			stats.func(args_reader, result_type, result);
+			stats.replay_time += ccl::time_dt() - call_start_time;
+			stats.capture_time += duration;
+			stats.calls++;
+
+			if (args_reader.has_error()) {
+				logger.logit("Capture replay: invalid arguments for ", stats.name);
+			}
+		}
+		else {
+			ok = false;
+		}
+	}
+
+	if (!ok) {
+		logger.logit("Capture replay: corrupt capture file ", filepath);
+	}
+
+	if (print_stats) {
+		std::sort(functions.begin(), functions.end(), [](const FunctionStats& a, const FunctionStats& b) {
+			return a.replay_time > b.replay_time;
+		});
+
+		printf("%-52s %10s %14s %14s\n", "Function", "Calls", "Captured (ms)", "Replayed (ms)");
+		for (const FunctionStats& stats : functions) {
+			if (stats.calls) {
+				printf("%-52s %10llu %14.3f %14.3f\n",
+					   stats.name.c_str(),
+					   (unsigned long long)stats.calls,
+					   stats.capture_time * 1000.0,
+					   stats.replay_time * 1000.0);
+			}
+		}
+		printf("Total replay time: %.3fs\n", ccl::time_dt() - replay_start_time);
+	}
+
+	return ok;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,413 @@
+/**
+Copyright 2014-2022 Robert McNeel and Associates
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#ifndef __CCYCLES_CAPTURE_H__
+#define __CCYCLES_CAPTURE_H__
+
+/* Capture and replay of CCycles API calls.
+ *
+ * While a capture is running every call into the functions instrumented with CCYCLES_CAPTURE is
+ * appended to a binary log, together with its arguments, bulk data such as vertex arrays, the
+ * time it was made at and how long it took. Object pointers are stored as opaque handles which
+ * get mapped to the objects created during replay, integer ids marked with ccycles_capture_id are
+ * mapped the same way. Callbacks can not be replayed, replay passes a stub which does nothing.
+ *
+ * Calls made from within another captured call are not recorded, as replaying the outer call
+ * makes them again.
+ *
+ * Replay decodes the arguments based on the signature of the registered function, so a
+ * function only needs a CCYCLES_CAPTURE line at the start of its body and a
+ * CCYCLES_CAPTURE_REPLAY line in its source file to be supported.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ccycles.h"
+
+/* Kind of a captured value, ids are mapped separately for each kind of object they refer to. */
+enum CCCaptureValueType : uint8_t {
+	CAPTURE_VALUE = 0,
+	CAPTURE_HANDLE = 1,
+	CAPTURE_ID_SCENE_PARAMS = 2,
+	CAPTURE_ID_CLIPPING_PLANE = 3,
+};
+
+/* Integer id of an object, passed to a captured function. */
+struct CCCaptureId {
+	uint64_t value;
+	CCCaptureValueType type;
+};
+
+template<typename T> CCCaptureId ccycles_capture_id(T value, CCCaptureValueType type)
+{
+	return CCCaptureId{ static_cast<uint64_t>(value), type };
+}
+
+/* Bulk data passed to a captured function as a pointer, with the number of elements. */
+struct CCCaptureArray {
+	const void* data;
+	size_t size;
+};
+
+template<typename T> CCCaptureArray ccycles_capture_array(const T* data, size_t num)
+{
+	return CCCaptureArray{ data, (data) ? num * sizeof(T) : 0 };
+}
+
+/* Serialization of call arguments. */
+class CCCaptureWriter {
+public:
+	std::vector<uint8_t> buffer;
+
+	void write(const void* data, size_t size)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		buffer.insert(buffer.end(), bytes, bytes + size);
+	}
+
+	template<typename T> void write_value(const T& value)
+	{
+		write(&value, sizeof(T));
+	}
+
+	template<typename Char> void write_string(const Char* value)
+	{
+		if (value == nullptr) {
+			write_value<uint64_t>(UINT64_MAX);
+			return;
+		}
+		size_t length = 0;
+		while (value[length]) {
+			length++;
+		}
+		write_value<uint64_t>(length);
+		write(value, length * sizeof(Char));
+	}
+
+	void write_array(const CCCaptureArray& array)
+	{
+		write_value<uint64_t>(array.size);
+		write(array.data, array.size);
+	}
+
+	template<typename Param, typename Arg> void write_arg(const Arg& arg)
+	{
+		using T = std::decay_t<Param>;
+		if constexpr (std::is_pointer_v<T>) {
+			using Pointee = std::remove_cv_t<std::remove_pointer_t<T>>;
+			if constexpr (std::is_function_v<Pointee>) {
+				/* Callbacks are not stored. */
+			}
+			else if constexpr (std::is_same_v<Pointee, char> || std::is_same_v<Pointee, wchar_t>) {
+				write_string(static_cast<const Pointee*>(arg));
+			}
+			else if constexpr (std::is_arithmetic_v<Pointee>) {
+				static_assert(std::is_same_v<Arg, CCCaptureArray>,
+							  "Pass data pointers with ccycles_capture_array");
+				write_array(arg);
+			}
+			else {
+				/* Object handle. */
+				write_value<uint64_t>(reinterpret_cast<uintptr_t>(arg));
+			}
+		}
+		else if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool>) {
+			if constexpr (std::is_same_v<Arg, CCCaptureId>) {
+				write_value<uint8_t>(arg.type);
+				write_value(static_cast<T>(arg.value));
+			}
+			else {
+				write_value<uint8_t>(CAPTURE_VALUE);
+				write_value(static_cast<T>(arg));
+			}
+		}
+		else {
+			static_assert(std::is_trivially_copyable_v<T>, "Argument type can not be captured");
+			const T value = static_cast<T>(arg);
+			write_value(value);
+		}
+	}
+};
+
+/* True while a capture is running, checked on every API call. */
+extern std::atomic<bool> ccycles_capture_enabled;
+
+bool ccycles_capture_begin_call();
+void ccycles_capture_end_call(const char* name,
+							  double start_time,
+							  CCCaptureValueType result_type,
+							  uint64_t result,
+							  const std::vector<uint8_t>& args);
+double ccycles_capture_time();
+
+/* Records one call for the lifetime of the scope. */
+class CCCaptureScope {
+public:
+	template<typename R, typename... Params, typename... Args>
+	CCCaptureScope(const char* name, R(CDECL* func)(Params...), const Args&... args)
+		: name_(name)
+	{
+		static_assert(sizeof...(Params) == sizeof...(Args), "Argument count mismatch");
+		(void)func;
+
+		if (!ccycles_capture_enabled.load(std::memory_order_relaxed)) {
+			return;
+		}
+		if (!ccycles_capture_begin_call()) {
+			nested_ = true;
+			return;
+		}
+
+		active_ = true;
+		(writer_.write_arg<Params>(args), ...);
+		start_time_ = ccycles_capture_time();
+	}
+
+	~CCCaptureScope()
+	{
+		if (active_ || nested_) {
+			ccycles_capture_end_call(
+				(active_) ? name_ : nullptr, start_time_, result_type_, result_, writer_.buffer);
+		}
+	}
+
+	/* Record the object handle returned by the call, so replay can map it. */
+	template<typename T> T* result(T* value)
+	{
+		if (active_) {
+			result_type_ = CAPTURE_HANDLE;
+			result_ = reinterpret_cast<uintptr_t>(value);
+		}
+		return value;
+	}
+
+	/* Record the object id returned by the call, so replay can map it. */
+	template<typename T> T result_id(T value, CCCaptureValueType type)
+	{
+		static_assert(std::is_integral_v<T>, "Object ids must be integers");
+		if (active_) {
+			result_type_ = type;
+			result_ = static_cast<uint64_t>(value);
+		}
+		return value;
+	}
+
+private:
+	const char* name_;
+	bool active_ = false;
+	bool nested_ = false;
+	CCCaptureValueType result_type_ = CAPTURE_VALUE;
+	uint64_t result_ = 0;
+	double start_time_ = 0.0;
+	CCCaptureWriter writer_;
+};
+
+#define CCYCLES_CAPTURE(func, ...) CCCaptureScope ccycles_capture_scope(#func, func, ##__VA_ARGS__)
+#define CCYCLES_CAPTURE_RESULT(value) ccycles_capture_scope.result(value)
+#define CCYCLES_CAPTURE_RESULT_ID(value, type) ccycles_capture_scope.result_id(value, type)
+
+/* Callback which does nothing, passed in place of captured callbacks during replay. */
+template<typename F> struct CCCaptureStub;
+
+template<typename R, typename... Params> struct CCCaptureStub<R(CDECL*)(Params...)> {
+	static R CDECL call(Params...)
+	{
+		return R();
+	}
+};
+
+/* Deserialization of call arguments during replay. */
+class CCCaptureReader {
+public:
+	CCCaptureReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+	bool has_error() const
+	{
+		return error_;
+	}
+
+	bool at_end() const
+	{
+		return pos_ >= size_;
+	}
+
+	const void* read(size_t size)
+	{
+		if (error_ || size > size_ - pos_) {
+			error_ = true;
+			return nullptr;
+		}
+		const void* data = data_ + pos_;
+		pos_ += size;
+		return data;
+	}
+
+	template<typename T> T read_value()
+	{
+		T value;
+		const void* data = read(sizeof(T));
+		if (data) {
+			memcpy(&value, data, sizeof(T));
+		}
+		else {
+			memset(&value, 0, sizeof(T));
+		}
+		return value;
+	}
+
+	template<typename Char> const Char* read_string()
+	{
+		const uint64_t length = read_value<uint64_t>();
+		if (length == UINT64_MAX) {
+			return nullptr;
+		}
+		const void* data = read(length * sizeof(Char));
+		std::vector<uint8_t>& storage = storage_.emplace_back((length + 1) * sizeof(Char), 0);
+		if (data) {
+			memcpy(storage.data(), data, length * sizeof(Char));
+		}
+		return reinterpret_cast<const Char*>(storage.data());
+	}
+
+	void* read_array()
+	{
+		const uint64_t size = read_value<uint64_t>();
+		const void* data = read(size);
+		if (data == nullptr || size == 0) {
+			return nullptr;
+		}
+		/* Copy, to pass aligned and writable memory to the function. */
+		std::vector<uint8_t>& storage = storage_.emplace_back(data_cast(data), data_cast(data) + size);
+		return storage.data();
+	}
+
+	void* read_handle();
+	uint64_t read_id(CCCaptureValueType type, uint64_t value);
+
+	template<typename T> T read_arg()
+	{
+		if constexpr (std::is_pointer_v<T>) {
+			using Pointee = std::remove_cv_t<std::remove_pointer_t<T>>;
+			if constexpr (std::is_function_v<Pointee>) {
+				return &CCCaptureStub<T>::call;
+			}
+			else if constexpr (std::is_same_v<Pointee, char> || std::is_same_v<Pointee, wchar_t>) {
+				return const_cast<T>(read_string<Pointee>());
+			}
+			else if constexpr (std::is_arithmetic_v<Pointee>) {
+				return static_cast<T>(read_array());
+			}
+			else {
+				return static_cast<T>(read_handle());
+			}
+		}
+		else if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool>) {
+			const CCCaptureValueType type = static_cast<CCCaptureValueType>(read_value<uint8_t>());
+			return static_cast<T>(read_id(type, static_cast<uint64_t>(read_value<T>())));
+		}
+		else {
+			return read_value<T>();
+		}
+	}
+
+	/* Map handles of objects created during capture to the ones created during replay. */
+	std::map<uint64_t, void*>* handles = nullptr;
+	std::map<std::pair<CCCaptureValueType, uint64_t>, uint64_t>* ids = nullptr;
+
+private:
+	static const uint8_t* data_cast(const void* data)
+	{
+		return static_cast<const uint8_t*>(data);
+	}
+
+	const uint8_t* data_;
+	size_t size_;
+	size_t pos_ = 0;
+	bool error_ = false;
+	std::deque<std::vector<uint8_t>> storage_;
+};
+
+typedef void (*CCCaptureReplayFunc)(CCCaptureReader& reader,
+									CCCaptureValueType result_type,
+									uint64_t result);
+
+template<typename F> struct CCCaptureSignature;
+
+template<typename R, typename... Params> struct CCCaptureSignature<R(CDECL*)(Params...)> {
+	typedef R Result;
+	typedef std::tuple<std::decay_t<Params>...> Args;
+};
+
+template<auto Func> void ccycles_capture_replay_call(CCCaptureReader& reader,
+													 CCCaptureValueType result_type,
+													 uint64_t result)
+{
+	using Signature = CCCaptureSignature<decltype(Func)>;
+	using Result = typename Signature::Result;
+
+	/* Braced initialization guarantees the arguments are read in order. */
+	typename Signature::Args args = std::apply(
+		[&reader](auto... types) {
+			return typename Signature::Args{ reader.read_arg<decltype(types)>()... };
+		},
+		typename Signature::Args{});
+
+	if (reader.has_error()) {
+		return;
+	}
+
+	if constexpr (std::is_pointer_v<Result>) {
+		Result value = std::apply(Func, args);
+		if (result_type == CAPTURE_HANDLE && reader.handles) {
+			(*reader.handles)[result] = const_cast<void*>(static_cast<const void*>(value));
+		}
+	}
+	else if constexpr (std::is_integral_v<Result> && !std::is_same_v<Result, bool>) {
+		Result value = std::apply(Func, args);
+		if (result_type != CAPTURE_VALUE && result_type != CAPTURE_HANDLE && reader.ids) {
+			(*reader.ids)[{ result_type, result }] = static_cast<uint64_t>(value);
+		}
+	}
+	else {
+		std::apply(Func, args);
+	}
+}
+
+/* Registration of functions which can be replayed, by name. */
+void ccycles_capture_register(const char* name, CCCaptureReplayFunc func);
+
+class CCCaptureRegistrar {
+public:
+	CCCaptureRegistrar(const char* name, CCCaptureReplayFunc func)
+	{
+		ccycles_capture_register(name, func);
+	}
+};
+
+#define CCYCLES_CAPTURE_REPLAY(func) \
+	static CCCaptureRegistrar ccycles_capture_registrar_##func( \
+		#func, ccycles_capture_replay_call<&func>)
+
+#endif
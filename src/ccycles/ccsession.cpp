@@ -346,6 +346,13 @@ bool CCyclesOutputDriver::update_render_tile(const Tile &tile)
 	return write_or_update_render_tile(tile);
 }
 
+bool CCyclesOutputDriver::supports_tiled_write() const
+{
+	// tiles are copied into the full passes at their offset, so the
+	// full frame never has to be read from disk at once
+	return true;
+}
+
 static void log_print(const std::string& msg)
 {
 	std::cout << msg << std::endl;
@@ -441,6 +448,7 @@ extern "C" {
 
 CCL_CAPI ccl::Session* CDECL cycles_session_create(ccl::SessionParams* _session_parameters)
 {
+	CCYCLES_CAPTURE(cycles_session_create, _session_parameters);
 	ccl::thread_scoped_lock lock(session_mutex);
 
 	ccl::SessionParams *params = (*(session_params.find(_session_parameters)));
@@ -468,11 +476,12 @@ CCL_CAPI ccl::Session* CDECL cycles_session_create(ccl::SessionParams* _session_
 	sessions.insert(session);
 	csesid = (unsigned int)(sessions.size() - 1);
 
-	return session->session;
+	return CCYCLES_CAPTURE_RESULT(session->session);
 }
 
 CCL_CAPI void CDECL cycles_session_destroy(ccl::Session* session_id)
 {
+	CCYCLES_CAPTURE(cycles_session_destroy, session_id);
 	CCSession* ccsess = nullptr;
 	ccl::Session* session = nullptr;
 	if (session_find(session_id, &ccsess, &session)) {
@@ -487,6 +496,7 @@ CCL_CAPI void CDECL cycles_session_destroy(ccl::Session* session_id)
 
 CCL_CAPI void CDECL cycles_session_clear_passes(ccl::Session* session_id)
 {
+	CCYCLES_CAPTURE(cycles_session_clear_passes, session_id);
 	ccl::vector<ccl::Pass*>& passes = session_id->scene->passes;
 	for (ccl::Pass *pass : passes) {
 		session_id->scene->delete_node(pass);
@@ -503,6 +513,7 @@ CCL_CAPI void CDECL cycles_session_clear_passes(ccl::Session* session_id)
 
 CCL_CAPI void CDECL cycles_session_add_pass(ccl::Session *session_id, int pass_id)
 {
+	CCYCLES_CAPTURE(cycles_session_add_pass, session_id, pass_id);
 	ccl::PassType passtype = (ccl::PassType)pass_id;
 
 	ccl::Pass *pass = session_id->scene->create_node<ccl::Pass>();
@@ -522,6 +533,8 @@ CCL_CAPI void CDECL cycles_session_add_pass(ccl::Session *session_id, int pass_i
 
 CCL_CAPI int CDECL cycles_session_reset(ccl::Session* session_id, int width, int height, int samples, int full_x, int full_y, int full_width, int full_height, int pixel_size)
 {
+	CCYCLES_CAPTURE(cycles_session_reset, session_id, width, height, samples, full_x, full_y,
+		full_width, full_height, pixel_size);
 	int rc = 0;
 	CCSession* ccsess = nullptr;
 	ccl::Session* session = nullptr;
@@ -562,6 +575,7 @@ CCL_CAPI int CDECL cycles_session_reset(ccl::Session* session_id, int width, int
 
 CCL_CAPI void CDECL cycles_session_cancel(ccl::Session* session_id, const char *cancel_message)
 {
+	CCYCLES_CAPTURE(cycles_session_cancel, session_id, cancel_message);
 	CCSession* ccsess = nullptr;
 	ccl::Session* session = nullptr;
 	if (session_find(session_id, &ccsess, &session)) {
@@ -572,11 +586,13 @@ CCL_CAPI void CDECL cycles_session_cancel(ccl::Session* session_id, const char *
 
 CCL_CAPI void CDECL cycles_session_quickcancel(ccl::Session* sessionPtr)
 {
+	CCYCLES_CAPTURE(cycles_session_quickcancel, sessionPtr);
 	sessionPtr->cancel(true);
 }
 
 CCL_CAPI void CDECL cycles_session_start(ccl::Session* session_id)
 {
+	CCYCLES_CAPTURE(cycles_session_start, session_id);
 	CCSession* ccsess = nullptr;
 	ccl::Session* session = nullptr;
 	if (session_find(session_id, &ccsess, &session)) {
@@ -587,6 +603,7 @@ CCL_CAPI void CDECL cycles_session_start(ccl::Session* session_id)
 
 CCL_CAPI void CDECL cycles_session_wait(ccl::Session* session_id)
 {
+	CCYCLES_CAPTURE(cycles_session_wait, session_id);
 	CCSession* ccsess = nullptr;
 	ccl::Session* session = nullptr;
 	if (session_find(session_id, &ccsess, &session)) {
@@ -597,6 +614,7 @@ CCL_CAPI void CDECL cycles_session_wait(ccl::Session* session_id)
 
 CCL_CAPI void CDECL cycles_session_set_pause(ccl::Session* session_id, bool pause)
 {
+	CCYCLES_CAPTURE(cycles_session_set_pause, session_id, pause);
 	CCSession* ccsess = nullptr;
 	ccl::Session* session = nullptr;
 	if (session_find(session_id, &ccsess, &session)) {
@@ -606,6 +624,7 @@ CCL_CAPI void CDECL cycles_session_set_pause(ccl::Session* session_id, bool paus
 
 CCL_CAPI void CDECL cycles_session_set_samples(ccl::Session* session_id, int samples)
 {
+	CCYCLES_CAPTURE(cycles_session_set_samples, session_id, samples);
 	CCSession* ccsess = nullptr;
 	ccl::Session* session = nullptr;
 	if (session_find(session_id, &ccsess, &session)) {
@@ -652,6 +671,7 @@ CCL_CAPI void CDECL cycles_session_release_float_buffer(ccl::Session *session_id
 
 CCL_CAPI void CDECL cycles_progress_reset(ccl::Session *session_id)
 {
+	CCYCLES_CAPTURE(cycles_progress_reset, session_id);
 	CCSession* ccsess = nullptr;
 	ccl::Session* session = nullptr;
 	if (session_find(session_id, &ccsess, &session)) {
@@ -748,6 +768,245 @@ CCL_CAPI bool CDECL cycles_progress_get_substatus(ccl::Session* session_id, void
 	return false;
 }
 
+/* Profiling only works when rendering on the CPU. Changes take effect the next time the session
+ * is started. */
+CCL_CAPI void CDECL cycles_session_set_use_profiling(ccl::Session* session_id, bool use_profiling)
+{
+	CCYCLES_CAPTURE(cycles_session_set_use_profiling, session_id, use_profiling);
+	CCSession* ccsess = nullptr;
+	ccl::Session* session = nullptr;
+	if (session_find(session_id, &ccsess, &session)) {
+		ccsess->params.use_profiling = use_profiling;
+		session->params.use_profiling = use_profiling;
+	}
+}
+
+/* Copy statistics of the session for the cycles_session_stats_* functions. Profiling data is
+ * available once the render has finished, returns true if it was collected. */
+CCL_CAPI bool CDECL cycles_session_collect_stats(ccl::Session* session_id)
+{
+	CCSession* ccsess = nullptr;
+	ccl::Session* session = nullptr;
+	if (!session_find(session_id, &ccsess, &session)) {
+		return false;
+	}
+
+	CCSessionStats& stats = ccsess->stats;
+	stats = CCSessionStats();
+
+	ccl::Scene* scene = session->scene;
+	ccl::thread_scoped_lock scene_lock(scene->mutex);
+
+	ccl::RenderStats render_stats;
+	scene->collect_statistics(&render_stats);
+
+	stats.mem_used = session->stats.mem_used;
+	stats.mem_peak = session->stats.mem_peak;
+	stats.geometry_size = render_stats.mesh.geometry.total_size;
+	stats.texture_size = render_stats.image.textures.total_size;
+	const ccl::Stats& device_stats = session->stats;
+	stats.category_mem_used.assign(device_stats.category_mem_used, device_stats.category_mem_used + ccl::MEM_CATEGORY_NUM);
+	stats.category_mem_peak.assign(device_stats.category_mem_peak, device_stats.category_mem_peak + ccl::MEM_CATEGORY_NUM);
+
+	ccl::Profiler& profiler = session->profiler;
+	if (!session->params.use_profiling || profiler.active()) {
+		return false;
+	}
+
+	for (int event = 0; event < ccl::PROFILING_NUM_EVENTS; event++) {
+		stats.event_samples.push_back(profiler.get_event((ccl::ProfilingEvent)event));
+	}
+
+	for (ccl::Shader* shader : scene->shaders) {
+		uint64_t samples, hits;
+		if (profiler.get_shader(shader->id, samples, hits)) {
+			stats.shaders.push_back(shader);
+			stats.shader_samples.push_back(samples);
+			stats.shader_hits.push_back(hits);
+		}
+	}
+
+	for (ccl::Object* object : scene->objects) {
+		uint64_t samples, hits;
+		if (profiler.get_object(object->get_device_index(), samples, hits)) {
+			stats.objects.push_back(object);
+			stats.object_samples.push_back(samples);
+			stats.object_hits.push_back(hits);
+		}
+	}
+
+	stats.has_profiling = true;
+	return true;
+}
+
+/* Name of a profiling event, for the indices of cycles_session_stats_get_events. */
+CCL_CAPI const char* CDECL cycles_profiling_event_name(unsigned int event)
+{
+	switch ((ccl::ProfilingEvent)event) {
+		case ccl::PROFILING_UNKNOWN: return "unknown";
+		case ccl::PROFILING_RAY_SETUP: return "ray_setup";
+		case ccl::PROFILING_INTERSECT_CLOSEST: return "intersect_closest";
+		case ccl::PROFILING_INTERSECT_SUBSURFACE: return "intersect_subsurface";
+		case ccl::PROFILING_INTERSECT_SHADOW: return "intersect_shadow";
+		case ccl::PROFILING_INTERSECT_VOLUME_STACK: return "intersect_volume_stack";
+		case ccl::PROFILING_SHADE_SURFACE_SETUP: return "shade_surface_setup";
+		case ccl::PROFILING_SHADE_SURFACE_EVAL: return "shade_surface_eval";
+		case ccl::PROFILING_SHADE_SURFACE_DIRECT_LIGHT: return "shade_surface_direct_light";
+		case ccl::PROFILING_SHADE_SURFACE_INDIRECT_LIGHT: return "shade_surface_indirect_light";
+		case ccl::PROFILING_SHADE_SURFACE_AO: return "shade_surface_ao";
+		case ccl::PROFILING_SHADE_SURFACE_PASSES: return "shade_surface_passes";
+		case ccl::PROFILING_SHADE_VOLUME_SETUP: return "shade_volume_setup";
+		case ccl::PROFILING_SHADE_VOLUME_INTEGRATE: return "shade_volume_integrate";
+		case ccl::PROFILING_SHADE_VOLUME_DIRECT_LIGHT: return "shade_volume_direct_light";
+		case ccl::PROFILING_SHADE_VOLUME_INDIRECT_LIGHT: return "shade_volume_indirect_light";
+		case ccl::PROFILING_SHADE_SHADOW_SETUP: return "shade_shadow_setup";
+		case ccl::PROFILING_SHADE_SHADOW_SURFACE: return "shade_shadow_surface";
+		case ccl::PROFILING_SHADE_SHADOW_VOLUME: return "shade_shadow_volume";
+		case ccl::PROFILING_SHADE_LIGHT_SETUP: return "shade_light_setup";
+		case ccl::PROFILING_SHADE_LIGHT_EVAL: return "shade_light_eval";
+		case ccl::PROFILING_NUM_EVENTS: break;
+	}
+	return "";
+}
+
+/* The count functions return the number of entries, which the get functions copy into arrays
+ * allocated by the caller. Counts are zero without collected profiling data. */
+CCL_CAPI unsigned int CDECL cycles_session_stats_event_count(ccl::Session* session_id)
+{
+	CCSession* ccsess = nullptr;
+	ccl::Session* session = nullptr;
+	if (session_find(session_id, &ccsess, &session)) {
+		return (unsigned int)ccsess->stats.event_samples.size();
+	}
+	return 0;
+}
+
+CCL_CAPI void CDECL cycles_session_stats_get_events(ccl::Session* session_id, uint64_t* samples, unsigned int count)
+{
+	CCSession* ccsess = nullptr;
+	ccl::Session* session = nullptr;
+	if (session_find(session_id, &ccsess, &session)) {
+		const CCSessionStats& stats = ccsess->stats;
+		count = std::min(count, (unsigned int)stats.event_samples.size());
+		std::copy_n(stats.event_samples.begin(), count, samples);
+	}
+}
+
+CCL_CAPI unsigned int CDECL cycles_session_stats_shader_count(ccl::Session* session_id)
+{
+	CCSession* ccsess = nullptr;
+	ccl::Session* session = nullptr;
+	if (session_find(session_id, &ccsess, &session)) {
+		return (unsigned int)ccsess->stats.shaders.size();
+	}
+	return 0;
+}
+
+CCL_CAPI void CDECL cycles_session_stats_get_shaders(ccl::Session* session_id, ccl::Shader** shaders, uint64_t* samples, uint64_t* hits, unsigned int count)
+{
+	CCSession* ccsess = nullptr;
+	ccl::Session* session = nullptr;
+	if (session_find(session_id, &ccsess, &session)) {
+		const CCSessionStats& stats = ccsess->stats;
+		count = std::min(count, (unsigned int)stats.shaders.size());
+		std::copy_n(stats.shaders.begin(), count, shaders);
+		std::copy_n(stats.shader_samples.begin(), count, samples);
+		std::copy_n(stats.shader_hits.begin(), count, hits);
+	}
+}
+
+CCL_CAPI unsigned int CDECL cycles_session_stats_object_count(ccl::Session* session_id)
+{
+	CCSession* ccsess = nullptr;
+	ccl::Session* session = nullptr;
+	if (session_find(session_id, &ccsess, &session)) {
+		return (unsigned int)ccsess->stats.objects.size();
+	}
+	return 0;
+}
+
+CCL_CAPI void CDECL cycles_session_stats_get_objects(ccl::Session* session_id, ccl::Object** objects, uint64_t* samples, uint64_t* hits, unsigned int count)
+{
+	CCSession* ccsess = nullptr;
+	ccl::Session* session = nullptr;
+	if (session_find(session_id, &ccsess, &session)) {
+		const CCSessionStats& stats = ccsess->stats;
+		count = std::min(count, (unsigned int)stats.objects.size());
+		std::copy_n(stats.objects.begin(), count, objects);
+		std::copy_n(stats.object_samples.begin(), count, samples);
+		std::copy_n(stats.object_hits.begin(), count, hits);
+	}
+}
+
+/* Device memory in use and its peak, and the size of the geometry and textures of the scene. */
+CCL_CAPI void CDECL cycles_session_stats_get_memory(ccl::Session* session_id, size_t* mem_used, size_t* mem_peak, size_t* geometry_size, size_t* texture_size)
+{
+	CCSession* ccsess = nullptr;
+	ccl::Session* session = nullptr;
+	if (session_find(session_id, &ccsess, &session)) {
+		const CCSessionStats& stats = ccsess->stats;
+		*mem_used = stats.mem_used;
+		*mem_peak = stats.mem_peak;
+		*geometry_size = stats.geometry_size;
+		*texture_size = stats.texture_size;
+	}
+}
+
+/* Device memory is accounted to subsystems, numbered from zero to cycles_memory_category_count. */
+CCL_CAPI unsigned int CDECL cycles_memory_category_count()
+{
+	return ccl::MEM_CATEGORY_NUM;
+}
+
+CCL_CAPI const char* CDECL cycles_memory_category_name(unsigned int category)
+{
+	if (category >= ccl::MEM_CATEGORY_NUM) {
+		return "";
+	}
+	return ccl::memory_category_name((ccl::MemoryCategory)category);
+}
+
+/* Device memory in use and its peak per subsystem. */
+CCL_CAPI void CDECL cycles_session_stats_get_memory_categories(ccl::Session* session_id, size_t* mem_used, size_t* mem_peak, unsigned int count)
+{
+	CCSession* ccsess = nullptr;
+	ccl::Session* session = nullptr;
+	if (session_find(session_id, &ccsess, &session)) {
+		const CCSessionStats& stats = ccsess->stats;
+		count = std::min(count, (unsigned int)stats.category_mem_used.size());
+		std::copy_n(stats.category_mem_used.begin(), count, mem_used);
+		std::copy_n(stats.category_mem_peak.begin(), count, mem_peak);
+	}
+}
+
+/* Soft budget for the device memory of a subsystem in bytes, zero for none. Exceeding a budget
+ * makes subsystems use less memory where they can: textures are loaded at a lower resolution and
+ * render buffers are split into smaller tiles. Allocations beyond the budget still succeed. */
+CCL_CAPI void CDECL cycles_session_set_memory_budget(ccl::Session* session_id, unsigned int category, size_t budget)
+{
+	CCYCLES_CAPTURE(cycles_session_set_memory_budget, session_id, category, budget);
+	CCSession* ccsess = nullptr;
+	ccl::Session* session = nullptr;
+	if (category < ccl::MEM_CATEGORY_NUM && session_find(session_id, &ccsess, &session)) {
+		session->stats.set_mem_budget((ccl::MemoryCategory)category, budget);
+	}
+}
+
 #ifdef __cplusplus
 }
 #endif
+
+CCYCLES_CAPTURE_REPLAY(cycles_session_create);
+CCYCLES_CAPTURE_REPLAY(cycles_session_destroy);
+CCYCLES_CAPTURE_REPLAY(cycles_session_clear_passes);
+CCYCLES_CAPTURE_REPLAY(cycles_session_add_pass);
+CCYCLES_CAPTURE_REPLAY(cycles_session_reset);
+CCYCLES_CAPTURE_REPLAY(cycles_session_cancel);
+CCYCLES_CAPTURE_REPLAY(cycles_session_quickcancel);
+CCYCLES_CAPTURE_REPLAY(cycles_session_start);
+CCYCLES_CAPTURE_REPLAY(cycles_session_wait);
+CCYCLES_CAPTURE_REPLAY(cycles_session_set_pause);
+CCYCLES_CAPTURE_REPLAY(cycles_session_set_samples);
+CCYCLES_CAPTURE_REPLAY(cycles_progress_reset);
+CCYCLES_CAPTURE_REPLAY(cycles_session_set_use_profiling);
+CCYCLES_CAPTURE_REPLAY(cycles_session_set_memory_budget);
@@ -64,6 +64,11 @@ void cycles_initialise(unsigned int mask)
 		multi_devices.clear();
 		devices = ccl::Device::available_devices(mask);
 		initialised = true;
+
+		const char* capture_filepath = getenv("CCYCLES_CAPTURE");
+		if (capture_filepath && capture_filepath[0]) {
+			cycles_capture_start(capture_filepath);
+		}
 	}
 }
 
@@ -191,6 +196,7 @@ void cycles_tfm_lookat(const ccl::float3& position, const ccl::float3& look, con
 
 void cycles_set_rhino_perlin_noise_table(int* data, unsigned int count)
 {
+	CCYCLES_CAPTURE(cycles_set_rhino_perlin_noise_table, ccycles_capture_array(data, count), count);
 	ccycles_rhino_perlin_noise_table.resize(count);
 
 	for (int i = 0; i < count; i++)
@@ -201,6 +207,7 @@ void cycles_set_rhino_perlin_noise_table(int* data, unsigned int count)
 
 void cycles_set_rhino_impulse_noise_table(float* data, unsigned int count)
 {
+	CCYCLES_CAPTURE(cycles_set_rhino_impulse_noise_table, ccycles_capture_array(data, count), count);
 	ccycles_rhino_impulse_noise_table.resize(count);
 
 	for (int i = 0; i < count; i++)
@@ -211,6 +218,7 @@ void cycles_set_rhino_impulse_noise_table(float* data, unsigned int count)
 
 void cycles_set_rhino_vc_noise_table(float* data, unsigned int count)
 {
+	CCYCLES_CAPTURE(cycles_set_rhino_vc_noise_table, ccycles_capture_array(data, count), count);
 	ccycles_rhino_vc_noise_table.resize(count);
 
 	for (int i = 0; i < count; i++)
@@ -221,6 +229,8 @@ void cycles_set_rhino_vc_noise_table(float* data, unsigned int count)
 
 void cycles_set_rhino_aaltonen_noise_table(const int* data, unsigned int count)
 {
+	CCYCLES_CAPTURE(cycles_set_rhino_aaltonen_noise_table, ccycles_capture_array(data, count),
+		count);
 	ccycles_rhino_aaltonen_noise_table.resize(count);
 
 	for (int i = 0; i < count; i++)
@@ -228,3 +238,8 @@ void cycles_set_rhino_aaltonen_noise_table(const int* data, unsigned int count)
 		ccycles_rhino_aaltonen_noise_table[i] = (float)data[i];
 	}
 }
+
+CCYCLES_CAPTURE_REPLAY(cycles_set_rhino_perlin_noise_table);
+CCYCLES_CAPTURE_REPLAY(cycles_set_rhino_impulse_noise_table);
+CCYCLES_CAPTURE_REPLAY(cycles_set_rhino_vc_noise_table);
+CCYCLES_CAPTURE_REPLAY(cycles_set_rhino_aaltonen_noise_table);
@@ -192,6 +192,10 @@ CCL_CAPI void CDECL cycles_scene_params_set_qbvh(unsigned int scene_params_id, u
  * Note that currently SVM is only supported for RhinoCycles. No effort yet has been taken to enable OSL.
  */
 CCL_CAPI void CDECL cycles_scene_params_set_shadingsystem(unsigned int scene_params_id, unsigned int system);
+/** Set scene parameter: texture compression, to store textures in less memory on the CPU.
+ * 0 = none, 1 = color textures only, 2 = all textures.
+ */
+CCL_CAPI void CDECL cycles_scene_params_set_texture_compression(unsigned int scene_params_id, unsigned int texture_compression);
 /** Set scene parameter: use persistent data. */
 CCL_CAPI void CDECL cycles_scene_params_set_persistent_data(unsigned int scene_params_id, unsigned int use);
 
@@ -291,6 +295,18 @@ CCL_CAPI void CDECL cycles_scene_discard_clipping_plane(ccl::Session* session_id
  */
 CCL_CAPI void CDECL cycles_scene_set_clipping_plane(ccl::Session* session_id, unsigned int cp_id, float a, float b, float c, float d);
 
+/**
+ * Write the scene to a binary file which can be loaded with cycles_scene_read_binary or the
+ * standalone application. Write before rendering, as rendering simplifies the shader graphs.
+ * Returns false if writing failed.
+ */
+CCL_CAPI bool CDECL cycles_scene_write_binary(ccl::Session* session_id, const char* filepath);
+
+/**
+ * Add the contents of a binary scene file to the scene. Returns false if reading failed.
+ */
+CCL_CAPI bool CDECL cycles_scene_read_binary(ccl::Session* session_id, const char* filepath);
+
 enum class sampling_pattern : unsigned int {
 	SOBOL = 0,
 	CMJ
@@ -523,6 +539,29 @@ CCL_CAPI void CDECL cycles_tfm_rotate_around_axis(float angle, const ccl::float3
 CCL_CAPI void CDECL cycles_apply_gamma_to_byte_buffer(unsigned char* rgba_buffer, size_t size_in_bytes, float gamma);
 CCL_CAPI void CDECL cycles_apply_gamma_to_float_buffer(float* rgba_buffer, size_t size_in_bytes, float gamma);
 
+/**
+ * Start recording the API calls made to CCycles, and the data passed with them, to a capture file
+ * which can be replayed with cycles_capture_replay. Capture also starts in cycles_initialise when
+ * the CCYCLES_CAPTURE environment variable is set to a file path.
+ * Returns false if the file can't be written or a capture is already running.
+ */
+CCL_CAPI bool CDECL cycles_capture_start(const char* filepath);
+
+/**
+ * Stop recording API calls and close the capture file.
+ * Returns false if not all calls could be written, in which case the capture is truncated. A
+ * capture also stops by itself on the first failed write.
+ */
+CCL_CAPI bool CDECL cycles_capture_stop();
+
+/**
+ * Replay the calls of a capture file, one after another. When realtime is true the calls are
+ * made at the times they were captured at, otherwise as fast as possible. When print_stats is
+ * true, the number of calls and the time spent in each function during capture and replay are
+ * printed. A running capture does not record the replayed calls.
+ */
+CCL_CAPI bool CDECL cycles_capture_replay(const char* filepath, bool realtime, bool print_stats);
+
 CCL_CAPI void CDECL cycles_set_rhino_perlin_noise_table(int* data, unsigned int count);
 CCL_CAPI void CDECL cycles_set_rhino_impulse_noise_table(float* data, unsigned int count);
 CCL_CAPI void CDECL cycles_set_rhino_vc_noise_table(float* data, unsigned int count);
@@ -114,6 +114,7 @@ CCL_CAPI const char* CDECL cycles_device_capabilities() {
 }
 
 CCL_CAPI int CDECL cycles_create_multidevice(int count, int* idx) {
+	CCYCLES_CAPTURE(cycles_create_multidevice, count, ccycles_capture_array(idx, count));
 	int foundidx = -1;
 
 	ccl::vector<ccl::DeviceInfo> subdevices;
@@ -146,3 +147,5 @@ CCL_CAPI int CDECL cycles_create_multidevice(int count, int* idx) {
 #ifdef __cplusplus
 }
 #endif
+
+CCYCLES_CAPTURE_REPLAY(cycles_create_multidevice);
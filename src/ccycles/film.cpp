@@ -18,6 +18,7 @@ limitations under the License.
 
 void cycles_film_set_exposure(ccl::Session* session_id, float exposure)
 {
+	CCYCLES_CAPTURE(cycles_film_set_exposure, session_id, exposure);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->film->set_exposure(exposure);
@@ -27,6 +28,7 @@ void cycles_film_set_exposure(ccl::Session* session_id, float exposure)
 
 void cycles_film_set_filter(ccl::Session* session_id, unsigned int filter_type, float filter_width)
 {
+	CCYCLES_CAPTURE(cycles_film_set_filter, session_id, filter_type, filter_width);
 	CCScene* csce = nullptr;
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
@@ -38,6 +40,7 @@ void cycles_film_set_filter(ccl::Session* session_id, unsigned int filter_type,
 
 void cycles_film_set_use_sample_clamp(ccl::Session* session_id, bool use_sample_clamp)
 {
+	CCYCLES_CAPTURE(cycles_film_set_use_sample_clamp, session_id, use_sample_clamp);
 	CCScene* csce = nullptr;
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
@@ -48,6 +51,7 @@ void cycles_film_set_use_sample_clamp(ccl::Session* session_id, bool use_sample_
 
 void cycles_film_tag_update(ccl::Session* session_id)
 {
+	CCYCLES_CAPTURE(cycles_film_tag_update, session_id);
 	CCScene* csce = nullptr;
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
@@ -57,9 +61,16 @@ void cycles_film_tag_update(ccl::Session* session_id)
 
 void cycles_film_set_use_approximate_shadow_catcher(ccl::Session* session, bool use_approximate_shadow_catcher)
 {
+	CCYCLES_CAPTURE(cycles_film_set_use_approximate_shadow_catcher, session,
+		use_approximate_shadow_catcher);
 	ccl::Scene *sce = nullptr;
 	if (scene_find(session, &sce)) {
 		sce->film->set_use_approximate_shadow_catcher(use_approximate_shadow_catcher);
 	}
 }
 
+CCYCLES_CAPTURE_REPLAY(cycles_film_set_exposure);
+CCYCLES_CAPTURE_REPLAY(cycles_film_set_filter);
+CCYCLES_CAPTURE_REPLAY(cycles_film_set_use_sample_clamp);
+CCYCLES_CAPTURE_REPLAY(cycles_film_tag_update);
+CCYCLES_CAPTURE_REPLAY(cycles_film_set_use_approximate_shadow_catcher);
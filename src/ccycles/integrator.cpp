@@ -26,6 +26,7 @@ extern "C" {
 
 CCL_CAPI void CDECL cycles_integrator_tag_update(ccl::Session* session_id)
 {
+	CCYCLES_CAPTURE(cycles_integrator_tag_update, session_id);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->integrator->tag_update(sce, ccl::Integrator::UPDATE_ALL);
@@ -35,6 +36,7 @@ CCL_CAPI void CDECL cycles_integrator_tag_update(ccl::Session* session_id)
 // Integrator settings
 CCL_CAPI void CDECL cycles_integrator_set_max_bounce(ccl::Session* session_id, int max_bounce)
 {
+	CCYCLES_CAPTURE(cycles_integrator_set_max_bounce, session_id, max_bounce);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->integrator->set_max_bounce(max_bounce);
@@ -43,6 +45,7 @@ CCL_CAPI void CDECL cycles_integrator_set_max_bounce(ccl::Session* session_id, i
 
 CCL_CAPI void CDECL cycles_integrator_set_min_bounce(ccl::Session* session_id, int min_bounce)
 {
+	CCYCLES_CAPTURE(cycles_integrator_set_min_bounce, session_id, min_bounce);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->integrator->set_min_bounce(min_bounce);
@@ -51,6 +54,7 @@ CCL_CAPI void CDECL cycles_integrator_set_min_bounce(ccl::Session* session_id, i
 
 CCL_CAPI void CDECL cycles_integrator_set_no_caustics(ccl::Session* session_id, bool no_caustics)
 {
+	CCYCLES_CAPTURE(cycles_integrator_set_no_caustics, session_id, no_caustics);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->integrator->set_caustics_reflective(!no_caustics);
@@ -60,6 +64,7 @@ CCL_CAPI void CDECL cycles_integrator_set_no_caustics(ccl::Session* session_id,
 
 CCL_CAPI void CDECL cycles_integrator_set_ao_bounces(ccl::Session* session_id, int ao_bounces)
 {
+	CCYCLES_CAPTURE(cycles_integrator_set_ao_bounces, session_id, ao_bounces);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
         sce->integrator->set_ao_bounces(ao_bounces);
@@ -67,6 +72,7 @@ CCL_CAPI void CDECL cycles_integrator_set_ao_bounces(ccl::Session* session_id, i
 }
 CCL_CAPI void CDECL cycles_integrator_set_ao_factor(ccl::Session *session_id, float ao_factor)
 {
+	CCYCLES_CAPTURE(cycles_integrator_set_ao_factor, session_id, ao_factor);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
         sce->integrator->set_ao_factor(ao_factor);
@@ -74,6 +80,7 @@ CCL_CAPI void CDECL cycles_integrator_set_ao_factor(ccl::Session *session_id, fl
 }
 CCL_CAPI void CDECL cycles_integrator_set_ao_distance(ccl::Session *session_id, float ao_distance)
 {
+	CCYCLES_CAPTURE(cycles_integrator_set_ao_distance, session_id, ao_distance);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
         sce->integrator->set_ao_distance(ao_distance);
@@ -81,6 +88,7 @@ CCL_CAPI void CDECL cycles_integrator_set_ao_distance(ccl::Session *session_id,
 }
 CCL_CAPI void CDECL cycles_integrator_set_ao_additive_factor(ccl::Session *session_id, float ao_additive_factor)
 {
+	CCYCLES_CAPTURE(cycles_integrator_set_ao_additive_factor, session_id, ao_additive_factor);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
         sce->integrator->set_ao_additive_factor(ao_additive_factor);
@@ -89,6 +97,7 @@ CCL_CAPI void CDECL cycles_integrator_set_ao_additive_factor(ccl::Session *sessi
 
 CCL_CAPI void CDECL cycles_integrator_set_max_diffuse_bounce(ccl::Session* session_id, int max_diffuse_bounce)
 {
+	CCYCLES_CAPTURE(cycles_integrator_set_max_diffuse_bounce, session_id, max_diffuse_bounce);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->integrator->set_max_diffuse_bounce(max_diffuse_bounce);
@@ -97,6 +106,7 @@ CCL_CAPI void CDECL cycles_integrator_set_max_diffuse_bounce(ccl::Session* sessi
 
 CCL_CAPI void CDECL cycles_integrator_set_max_glossy_bounce(ccl::Session* session_id, int max_glossy_bounce)
 {
+	CCYCLES_CAPTURE(cycles_integrator_set_max_glossy_bounce, session_id, max_glossy_bounce);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->integrator->set_max_glossy_bounce(max_glossy_bounce);
@@ -105,6 +115,8 @@ CCL_CAPI void CDECL cycles_integrator_set_max_glossy_bounce(ccl::Session* sessio
 
 CCL_CAPI void CDECL cycles_integrator_set_max_transmission_bounce(ccl::Session* session_id, int max_transmission_bounce)
 {
+	CCYCLES_CAPTURE(cycles_integrator_set_max_transmission_bounce, session_id,
+		max_transmission_bounce);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->integrator->set_max_transmission_bounce(max_transmission_bounce);
@@ -113,6 +125,7 @@ CCL_CAPI void CDECL cycles_integrator_set_max_transmission_bounce(ccl::Session*
 
 CCL_CAPI void CDECL cycles_integrator_set_max_volume_bounce(ccl::Session* session_id, int max_volume_bounce)
 {
+	CCYCLES_CAPTURE(cycles_integrator_set_max_volume_bounce, session_id, max_volume_bounce);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->integrator->set_max_volume_bounce(max_volume_bounce);
@@ -121,6 +134,8 @@ CCL_CAPI void CDECL cycles_integrator_set_max_volume_bounce(ccl::Session* sessio
 
 CCL_CAPI void CDECL cycles_integrator_set_transparent_max_bounce(ccl::Session* session_id, int transparent_max_bounce)
 {
+	CCYCLES_CAPTURE(cycles_integrator_set_transparent_max_bounce, session_id,
+		transparent_max_bounce);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->integrator->set_transparent_max_bounce(transparent_max_bounce);
@@ -129,6 +144,8 @@ CCL_CAPI void CDECL cycles_integrator_set_transparent_max_bounce(ccl::Session* s
 
 CCL_CAPI void CDECL cycles_integrator_set_transparent_min_bounce(ccl::Session* session_id, int transparent_min_bounce)
 {
+	CCYCLES_CAPTURE(cycles_integrator_set_transparent_min_bounce, session_id,
+		transparent_min_bounce);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->integrator->set_transparent_min_bounce(transparent_min_bounce);
@@ -137,6 +154,7 @@ CCL_CAPI void CDECL cycles_integrator_set_transparent_min_bounce(ccl::Session* s
 
 CCL_CAPI void CDECL cycles_integrator_set_aa_samples(ccl::Session* session_id, int aa_samples)
 {
+	CCYCLES_CAPTURE(cycles_integrator_set_aa_samples, session_id, aa_samples);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->integrator->set_aa_samples(aa_samples);
@@ -145,6 +163,7 @@ CCL_CAPI void CDECL cycles_integrator_set_aa_samples(ccl::Session* session_id, i
 
 CCL_CAPI void CDECL cycles_integrator_set_filter_glossy(ccl::Session* session_id, float filter_glossy)
 {
+	CCYCLES_CAPTURE(cycles_integrator_set_filter_glossy, session_id, filter_glossy);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->integrator->set_filter_glossy(filter_glossy);
@@ -153,6 +172,7 @@ CCL_CAPI void CDECL cycles_integrator_set_filter_glossy(ccl::Session* session_id
 
 CCL_CAPI void CDECL cycles_integrator_set_use_direct_light(ccl::Session *session_id, bool use_direct_light)
 {
+	CCYCLES_CAPTURE(cycles_integrator_set_use_direct_light, session_id, use_direct_light);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->integrator->set_use_direct_light(use_direct_light);
@@ -161,6 +181,7 @@ CCL_CAPI void CDECL cycles_integrator_set_use_direct_light(ccl::Session *session
 
 CCL_CAPI void CDECL cycles_integrator_set_use_indirect_light(ccl::Session *session_id, bool use_indirect_light)
 {
+	CCYCLES_CAPTURE(cycles_integrator_set_use_indirect_light, session_id, use_indirect_light);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->integrator->set_use_indirect_light(use_indirect_light);
@@ -169,6 +190,7 @@ CCL_CAPI void CDECL cycles_integrator_set_use_indirect_light(ccl::Session *sessi
 
 CCL_CAPI void CDECL cycles_integrator_set_volume_step_rate(ccl::Session* session_id, float volume_step_rate)
 {
+	CCYCLES_CAPTURE(cycles_integrator_set_volume_step_rate, session_id, volume_step_rate);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->integrator->set_volume_step_rate(volume_step_rate);
@@ -177,6 +199,7 @@ CCL_CAPI void CDECL cycles_integrator_set_volume_step_rate(ccl::Session* session
 
 CCL_CAPI void CDECL cycles_integrator_set_volume_max_steps(ccl::Session* session_id, int volume_max_steps)
 {
+	CCYCLES_CAPTURE(cycles_integrator_set_volume_max_steps, session_id, volume_max_steps);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->integrator->set_volume_max_steps(volume_max_steps);
@@ -185,6 +208,7 @@ CCL_CAPI void CDECL cycles_integrator_set_volume_max_steps(ccl::Session* session
 
 CCL_CAPI void CDECL cycles_integrator_set_caustics_reflective(ccl::Session* session_id, bool caustics_reflective)
 {
+	CCYCLES_CAPTURE(cycles_integrator_set_caustics_reflective, session_id, caustics_reflective);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->integrator->set_caustics_reflective(caustics_reflective);
@@ -193,6 +217,7 @@ CCL_CAPI void CDECL cycles_integrator_set_caustics_reflective(ccl::Session* sess
 
 CCL_CAPI void CDECL cycles_integrator_set_caustics_refractive(ccl::Session* session_id, bool caustics_refractive)
 {
+	CCYCLES_CAPTURE(cycles_integrator_set_caustics_refractive, session_id, caustics_refractive);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->integrator->set_caustics_refractive(caustics_refractive);
@@ -201,6 +226,7 @@ CCL_CAPI void CDECL cycles_integrator_set_caustics_refractive(ccl::Session* sess
 
 CCL_CAPI void CDECL cycles_integrator_set_seed(ccl::Session* session_id, int seed)
 {
+	CCYCLES_CAPTURE(cycles_integrator_set_seed, session_id, seed);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->integrator->set_seed(seed);
@@ -209,6 +235,7 @@ CCL_CAPI void CDECL cycles_integrator_set_seed(ccl::Session* session_id, int see
 
 CCL_CAPI void CDECL cycles_integrator_set_sampling_pattern(ccl::Session* session_id, sampling_pattern pattern)
 {
+	CCYCLES_CAPTURE(cycles_integrator_set_sampling_pattern, session_id, pattern);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->integrator->set_sampling_pattern((ccl::SamplingPattern)pattern);
@@ -217,6 +244,7 @@ CCL_CAPI void CDECL cycles_integrator_set_sampling_pattern(ccl::Session* session
 
 CCL_CAPI void CDECL cycles_integrator_set_sample_clamp_direct(ccl::Session* session_id, float sample_clamp_direct)
 {
+	CCYCLES_CAPTURE(cycles_integrator_set_sample_clamp_direct, session_id, sample_clamp_direct);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->integrator->set_sample_clamp_direct(sample_clamp_direct);
@@ -225,6 +253,7 @@ CCL_CAPI void CDECL cycles_integrator_set_sample_clamp_direct(ccl::Session* sess
 
 CCL_CAPI void CDECL cycles_integrator_set_sample_clamp_indirect(ccl::Session* session_id, float sample_clamp_indirect)
 {
+	CCYCLES_CAPTURE(cycles_integrator_set_sample_clamp_indirect, session_id, sample_clamp_indirect);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->integrator->set_sample_clamp_indirect(sample_clamp_indirect);
@@ -233,6 +262,8 @@ CCL_CAPI void CDECL cycles_integrator_set_sample_clamp_indirect(ccl::Session* se
 
 CCL_CAPI void CDECL cycles_integrator_set_light_sampling_threshold(ccl::Session* session_id, float light_sampling_threshold)
 {
+	CCYCLES_CAPTURE(cycles_integrator_set_light_sampling_threshold, session_id,
+		light_sampling_threshold);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->integrator->set_light_sampling_threshold(light_sampling_threshold);
@@ -241,6 +272,7 @@ CCL_CAPI void CDECL cycles_integrator_set_light_sampling_threshold(ccl::Session*
 
 CCL_CAPI void CDECL cycles_integrators_set_use_light_tree(ccl::Session* session_id, bool use_light_tree)
 {
+	CCYCLES_CAPTURE(cycles_integrators_set_use_light_tree, session_id, use_light_tree);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->integrator->set_use_light_tree(use_light_tree);
@@ -249,6 +281,7 @@ CCL_CAPI void CDECL cycles_integrators_set_use_light_tree(ccl::Session* session_
 
 CCL_CAPI void CDECL cycles_integrator_set_use_adaptive_sampling(ccl::Session* session_id, bool use_adaptive_sampling)
 {
+	CCYCLES_CAPTURE(cycles_integrator_set_use_adaptive_sampling, session_id, use_adaptive_sampling);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->integrator->set_use_adaptive_sampling(use_adaptive_sampling);
@@ -257,6 +290,7 @@ CCL_CAPI void CDECL cycles_integrator_set_use_adaptive_sampling(ccl::Session* se
 
 CCL_CAPI void CDECL cycles_integrator_set_adaptive_min_samples(ccl::Session* session_id, int adaptive_min_samples)
 {
+	CCYCLES_CAPTURE(cycles_integrator_set_adaptive_min_samples, session_id, adaptive_min_samples);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->integrator->set_adaptive_min_samples(adaptive_min_samples);
@@ -265,12 +299,66 @@ CCL_CAPI void CDECL cycles_integrator_set_adaptive_min_samples(ccl::Session* ses
 
 CCL_CAPI void CDECL cycles_integrator_set_adaptive_threshold(ccl::Session* session_id, float adaptive_threshold)
 {
+	CCYCLES_CAPTURE(cycles_integrator_set_adaptive_threshold, session_id, adaptive_threshold);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->integrator->set_adaptive_threshold(adaptive_threshold);
 	}
 }
 
+CCL_CAPI void CDECL cycles_integrator_set_adaptive_block_size(ccl::Session* session_id, int adaptive_block_size)
+{
+	CCYCLES_CAPTURE(cycles_integrator_set_adaptive_block_size, session_id, adaptive_block_size);
+	ccl::Scene* sce = nullptr;
+	if(scene_find(session_id, &sce)) {
+		sce->integrator->set_adaptive_block_size(adaptive_block_size);
+	}
+}
+
+CCL_CAPI void CDECL cycles_integrator_set_adaptive_sample_budget(ccl::Session* session_id, float adaptive_sample_budget)
+{
+	CCYCLES_CAPTURE(cycles_integrator_set_adaptive_sample_budget, session_id,
+		adaptive_sample_budget);
+	ccl::Scene* sce = nullptr;
+	if(scene_find(session_id, &sce)) {
+		sce->integrator->set_adaptive_sample_budget(adaptive_sample_budget);
+	}
+}
+
 #ifdef __cplusplus
 }
 #endif
+
+CCYCLES_CAPTURE_REPLAY(cycles_integrator_tag_update);
+CCYCLES_CAPTURE_REPLAY(cycles_integrator_set_max_bounce);
+CCYCLES_CAPTURE_REPLAY(cycles_integrator_set_min_bounce);
+CCYCLES_CAPTURE_REPLAY(cycles_integrator_set_no_caustics);
+CCYCLES_CAPTURE_REPLAY(cycles_integrator_set_ao_bounces);
+CCYCLES_CAPTURE_REPLAY(cycles_integrator_set_ao_factor);
+CCYCLES_CAPTURE_REPLAY(cycles_integrator_set_ao_distance);
+CCYCLES_CAPTURE_REPLAY(cycles_integrator_set_ao_additive_factor);
+CCYCLES_CAPTURE_REPLAY(cycles_integrator_set_max_diffuse_bounce);
+CCYCLES_CAPTURE_REPLAY(cycles_integrator_set_max_glossy_bounce);
+CCYCLES_CAPTURE_REPLAY(cycles_integrator_set_max_transmission_bounce);
+CCYCLES_CAPTURE_REPLAY(cycles_integrator_set_max_volume_bounce);
+CCYCLES_CAPTURE_REPLAY(cycles_integrator_set_transparent_max_bounce);
+CCYCLES_CAPTURE_REPLAY(cycles_integrator_set_transparent_min_bounce);
+CCYCLES_CAPTURE_REPLAY(cycles_integrator_set_aa_samples);
+CCYCLES_CAPTURE_REPLAY(cycles_integrator_set_filter_glossy);
+CCYCLES_CAPTURE_REPLAY(cycles_integrator_set_use_direct_light);
+CCYCLES_CAPTURE_REPLAY(cycles_integrator_set_use_indirect_light);
+CCYCLES_CAPTURE_REPLAY(cycles_integrator_set_volume_step_rate);
+CCYCLES_CAPTURE_REPLAY(cycles_integrator_set_volume_max_steps);
+CCYCLES_CAPTURE_REPLAY(cycles_integrator_set_caustics_reflective);
+CCYCLES_CAPTURE_REPLAY(cycles_integrator_set_caustics_refractive);
+CCYCLES_CAPTURE_REPLAY(cycles_integrator_set_seed);
+CCYCLES_CAPTURE_REPLAY(cycles_integrator_set_sampling_pattern);
+CCYCLES_CAPTURE_REPLAY(cycles_integrator_set_sample_clamp_direct);
+CCYCLES_CAPTURE_REPLAY(cycles_integrator_set_sample_clamp_indirect);
+CCYCLES_CAPTURE_REPLAY(cycles_integrator_set_light_sampling_threshold);
+CCYCLES_CAPTURE_REPLAY(cycles_integrators_set_use_light_tree);
+CCYCLES_CAPTURE_REPLAY(cycles_integrator_set_use_adaptive_sampling);
+CCYCLES_CAPTURE_REPLAY(cycles_integrator_set_adaptive_min_samples);
+CCYCLES_CAPTURE_REPLAY(cycles_integrator_set_adaptive_threshold);
+CCYCLES_CAPTURE_REPLAY(cycles_integrator_set_adaptive_block_size);
+CCYCLES_CAPTURE_REPLAY(cycles_integrator_set_adaptive_sample_budget);
@@ -58,6 +58,7 @@ limitations under the License.
 #pragma warning ( pop )
 
 #include "ccycles.h"
+#include "capture.h"
 
 #define MULTIDEVICEOFFSET 100000
 #define ISMULTIDEVICE(id) (id>=MULTIDEVICEOFFSET)
@@ -205,6 +206,7 @@ class CCyclesOutputDriver : public ccl::OutputDriver {
 
 		virtual void write_render_tile(const Tile &tile) override;
 		virtual bool update_render_tile(const Tile & /* tile */) override;
+		virtual bool supports_tiled_write() const override;
 
 	protected:
 		bool write_or_update_render_tile(const Tile &tile);
@@ -247,6 +249,33 @@ class CCyclesDisplayDriver : public ccl::DisplayDriver {
 		std::vector<std::unique_ptr<CCyclesPassOutput>> *passes;
 };
 
+/* Statistics of a session, copied by cycles_session_collect_stats so that they can be read
+ * without holding on to the scene while the host displays them. */
+class CCSessionStats {
+public:
+	/* Profiling samples are taken every millisecond for each render thread. */
+	bool has_profiling{ false };
+	std::vector<uint64_t> event_samples;
+
+	std::vector<ccl::Shader*> shaders;
+	std::vector<uint64_t> shader_samples;
+	std::vector<uint64_t> shader_hits;
+
+	std::vector<ccl::Object*> objects;
+	std::vector<uint64_t> object_samples;
+	std::vector<uint64_t> object_hits;
+
+	/* Memory in bytes. */
+	size_t mem_used{ 0 };
+	size_t mem_peak{ 0 };
+	size_t geometry_size{ 0 };
+	size_t texture_size{ 0 };
+
+	/* Device memory per ccl::MemoryCategory. */
+	std::vector<size_t> category_mem_used;
+	std::vector<size_t> category_mem_peak;
+};
+
 class CCSession final {
 public:
 	unsigned int id{ 0 };
@@ -261,6 +290,8 @@ public:
 
 	std::vector<std::unique_ptr<CCyclesPassOutput>> passes;
 
+	CCSessionStats stats;
+
 	/* Create a new CCSession, initialise all necessary memory. */
 	static CCSession* create(int width, int height, unsigned int buffer_stride);
 
@@ -18,6 +18,7 @@ limitations under the License.
 
 ccl::Light *cycles_create_light(ccl::Session* session_id, ccl::Shader *light_shader_id)
 {
+	CCYCLES_CAPTURE(cycles_create_light, session_id, light_shader_id);
 	ccl::Light* l = new ccl::Light();
 	l->set_angle(0.009180f); // use default value as in Blender UI (0.526deg)
 	l->set_shader(light_shader_id);
@@ -25,12 +26,13 @@ ccl::Light *cycles_create_light(ccl::Session* session_id, ccl::Shader *light_sha
 	l->set_use_glossy(false);
 	l->set_use_transmission(true);
 	session_id->scene->lights.push_back(l);
-	return l;
+	return CCYCLES_CAPTURE_RESULT(l);
 }
 
 /* type = 0: point, 1: sun, 2: background, 3: area, 4: spot, 5: triangle. */
 void cycles_light_set_type(ccl::Session *session_id, ccl::Light *light, light_type type)
 {
+	CCYCLES_CAPTURE(cycles_light_set_type, session_id, light, type);
 	ccl::LightType ltype = (ccl::LightType)type;
 	light->set_light_type(ltype);
 	light->set_use_glossy(true); // too many cmomplaints about lights not working
@@ -39,80 +41,115 @@ void cycles_light_set_type(ccl::Session *session_id, ccl::Light *light, light_ty
 
 void cycles_light_set_cast_shadow(ccl::Session *session_id, ccl::Light *light, unsigned int cast_shadow)
 {
+	CCYCLES_CAPTURE(cycles_light_set_cast_shadow, session_id, light, cast_shadow);
 	light->set_cast_shadow(cast_shadow == 1);
 }
 
 void cycles_light_set_use_mis(ccl::Session *session_id, ccl::Light *light, unsigned int use_mis)
 {
+	CCYCLES_CAPTURE(cycles_light_set_use_mis, session_id, light, use_mis);
 	light->set_use_mis(use_mis == 1);
 }
 
 void cycles_light_set_samples(ccl::Session *session_id, ccl::Light *light, unsigned int samples)
 {
+	CCYCLES_CAPTURE(cycles_light_set_samples, session_id, light, samples);
 	light->set_max_bounces((int)samples);
 }
 
 void cycles_light_set_max_bounces(ccl::Session *session_id, ccl::Light *light, unsigned int max_bounces)
 {
+	CCYCLES_CAPTURE(cycles_light_set_max_bounces, session_id, light, max_bounces);
 	light->set_max_bounces(max_bounces);
 }
 
 void cycles_light_set_map_resolution(ccl::Session *session_id, ccl::Light *light, unsigned int map_resolution)
 {
+	CCYCLES_CAPTURE(cycles_light_set_map_resolution, session_id, light, map_resolution);
 	light->set_map_resolution(map_resolution);
 }
 
 void cycles_light_set_angle(ccl::Session *session_id, ccl::Light *light, float angle)
 {
+	CCYCLES_CAPTURE(cycles_light_set_angle, session_id, light, angle);
 	light->set_angle(angle);
 }
 
 void cycles_light_set_spot_angle(ccl::Session *session_id, ccl::Light *light, float spot_angle)
 {
+	CCYCLES_CAPTURE(cycles_light_set_spot_angle, session_id, light, spot_angle);
 	light->set_spot_angle(spot_angle);
 }
 
 void cycles_light_set_spot_smooth(ccl::Session *session_id, ccl::Light *light, float spot_smooth)
 {
+	CCYCLES_CAPTURE(cycles_light_set_spot_smooth, session_id, light, spot_smooth);
 	light->set_spot_smooth(spot_smooth);
 }
 
 void cycles_light_set_sizeu(ccl::Session *session_id, ccl::Light *light, float sizeu)
 {
+	CCYCLES_CAPTURE(cycles_light_set_sizeu, session_id, light, sizeu);
 	light->set_sizeu(sizeu);
 }
 
 void cycles_light_set_sizev(ccl::Session *session_id, ccl::Light *light, float sizev)
 {
+	CCYCLES_CAPTURE(cycles_light_set_sizev, session_id, light, sizev);
 	light->set_sizev(sizev);
 }
 
 void cycles_light_set_axisu(ccl::Session *session_id, ccl::Light *light, float axisux, float axisuy, float axisuz)
 {
+	CCYCLES_CAPTURE(cycles_light_set_axisu, session_id, light, axisux, axisuy, axisuz);
 	light->set_axisu(ccl::make_float3(axisux, axisuy, axisuz));
 }
 
 void cycles_light_set_axisv(ccl::Session *session_id, ccl::Light *light, float axisvx, float axisvy, float axisvz)
 {
+	CCYCLES_CAPTURE(cycles_light_set_axisv, session_id, light, axisvx, axisvy, axisvz);
 	light->set_axisv(ccl::make_float3(axisvx, axisvy, axisvz));
 }
 
 void cycles_light_set_size(ccl::Session *session_id, ccl::Light *light, float size)
 {
+	CCYCLES_CAPTURE(cycles_light_set_size, session_id, light, size);
 	light->set_size(size);
 }
 
 void cycles_light_set_dir(ccl::Session *session_id, ccl::Light *light, float dirx, float diry, float dirz)
 {
+	CCYCLES_CAPTURE(cycles_light_set_dir, session_id, light, dirx, diry, dirz);
 	light->set_dir(ccl::make_float3(dirx, diry, dirz));
 }
 
 void cycles_light_set_co(ccl::Session *session_id, ccl::Light *light, float cox, float coy, float coz)
 {
+	CCYCLES_CAPTURE(cycles_light_set_co, session_id, light, cox, coy, coz);
 	light->set_co(ccl::make_float3(cox, coy, coz));
 }
 
 void cycles_light_tag_update(ccl::Session *session_id, ccl::Light *light)
 {
+	CCYCLES_CAPTURE(cycles_light_tag_update, session_id, light);
 	light->tag_update(session_id->scene);
 }
+
+CCYCLES_CAPTURE_REPLAY(cycles_create_light);
+CCYCLES_CAPTURE_REPLAY(cycles_light_set_type);
+CCYCLES_CAPTURE_REPLAY(cycles_light_set_cast_shadow);
+CCYCLES_CAPTURE_REPLAY(cycles_light_set_use_mis);
+CCYCLES_CAPTURE_REPLAY(cycles_light_set_samples);
+CCYCLES_CAPTURE_REPLAY(cycles_light_set_max_bounces);
+CCYCLES_CAPTURE_REPLAY(cycles_light_set_map_resolution);
+CCYCLES_CAPTURE_REPLAY(cycles_light_set_angle);
+CCYCLES_CAPTURE_REPLAY(cycles_light_set_spot_angle);
+CCYCLES_CAPTURE_REPLAY(cycles_light_set_spot_smooth);
+CCYCLES_CAPTURE_REPLAY(cycles_light_set_sizeu);
+CCYCLES_CAPTURE_REPLAY(cycles_light_set_sizev);
+CCYCLES_CAPTURE_REPLAY(cycles_light_set_axisu);
+CCYCLES_CAPTURE_REPLAY(cycles_light_set_axisv);
+CCYCLES_CAPTURE_REPLAY(cycles_light_set_size);
+CCYCLES_CAPTURE_REPLAY(cycles_light_set_dir);
+CCYCLES_CAPTURE_REPLAY(cycles_light_set_co);
+CCYCLES_CAPTURE_REPLAY(cycles_light_tag_update);
@@ -25,6 +25,7 @@ using namespace OIIO;
 
 ccl::Geometry *cycles_scene_add_mesh(ccl::Session *session, ccl::Shader *shader_id)
 {
+	CCYCLES_CAPTURE(cycles_scene_add_mesh, session, shader_id);
 	ccl::Scene* sce = session->scene;
 	if(sce)
 	{
@@ -37,7 +38,7 @@ ccl::Geometry *cycles_scene_add_mesh(ccl::Session *session, ccl::Shader *shader_
 
 		logger.logit("Add mesh ", sce->geometry.size() - 1, " in scene ", session, " using default surface shader ", shader_id);
 
-		return mesh;
+		return CCYCLES_CAPTURE_RESULT(mesh);
 	}
 
 	return nullptr;
@@ -45,6 +46,7 @@ ccl::Geometry *cycles_scene_add_mesh(ccl::Session *session, ccl::Shader *shader_
 
 void cycles_geometry_set_shader(ccl::Session *session, ccl::Geometry *mesh_id, ccl::Shader *shader_id)
 {
+	CCYCLES_CAPTURE(cycles_geometry_set_shader, session, mesh_id, shader_id);
 	ccl::Scene* sce = session->scene;
 	if(sce) {
 
@@ -80,6 +82,7 @@ void cycles_geometry_set_shader(ccl::Session *session, ccl::Geometry *mesh_id, c
 
 void cycles_geometry_clear(ccl::Session* session, ccl::Geometry* geometry)
 {
+	CCYCLES_CAPTURE(cycles_geometry_clear, session, geometry);
 	ASSERT(geometry);
 
 	#if 0
@@ -92,6 +95,7 @@ void cycles_geometry_clear(ccl::Session* session, ccl::Geometry* geometry)
 
 void cycles_geometry_tag_rebuild(ccl::Session* session_id, ccl::Geometry* geometry)
 {
+	CCYCLES_CAPTURE(cycles_geometry_tag_rebuild, session_id, geometry);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce))
 	{
@@ -102,6 +106,7 @@ void cycles_geometry_tag_rebuild(ccl::Session* session_id, ccl::Geometry* geomet
 
 void cycles_mesh_set_smooth(ccl::Session* session_id, ccl::Geometry* geometry, unsigned int smooth)
 {
+	CCYCLES_CAPTURE(cycles_mesh_set_smooth, session_id, geometry, smooth);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce))
 	{
@@ -125,6 +130,7 @@ void cycles_mesh_set_smooth(ccl::Session* session_id, ccl::Geometry* geometry, u
 
 void cycles_mesh_reserve(ccl::Session* session_id, ccl::Geometry* geometry, unsigned vcount, unsigned fcount)
 {
+	CCYCLES_CAPTURE(cycles_mesh_reserve, session_id, geometry, vcount, fcount);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce))
 	{
@@ -141,6 +147,7 @@ void cycles_mesh_reserve(ccl::Session* session_id, ccl::Geometry* geometry, unsi
 
 void cycles_mesh_resize(ccl::Session* session_id, ccl::Geometry* geometry, unsigned vcount, unsigned fcount)
 {
+	CCYCLES_CAPTURE(cycles_mesh_resize, session_id, geometry, vcount, fcount);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce))
 	{
@@ -158,6 +165,8 @@ void cycles_mesh_resize(ccl::Session* session_id, ccl::Geometry* geometry, unsig
 
 void cycles_mesh_set_verts(ccl::Session* session_id, ccl::Geometry* geometry, float *in_verts, unsigned int in_vcount)
 {
+	CCYCLES_CAPTURE(cycles_mesh_set_verts, session_id, geometry,
+		ccycles_capture_array(in_verts, in_vcount * 3), in_vcount);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce))
 	{
@@ -193,6 +202,8 @@ void cycles_mesh_set_verts(ccl::Session* session_id, ccl::Geometry* geometry, fl
 
 void cycles_mesh_set_tris(ccl::Session *session_id, ccl::Geometry *geometry, int *faces, unsigned int fcount, ccl::Shader *shader_id, unsigned int smooth)
 {
+	CCYCLES_CAPTURE(cycles_mesh_set_tris, session_id, geometry,
+		ccycles_capture_array(faces, fcount * 3), fcount, shader_id, smooth);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce))
 	{
@@ -229,6 +240,8 @@ void cycles_mesh_set_tris(ccl::Session *session_id, ccl::Geometry *geometry, int
 
 void cycles_mesh_set_triangle(ccl::Session* session_id, ccl::Geometry* geometry, unsigned tri_idx, unsigned int v0, unsigned int v1, unsigned int v2, ccl::Shader *shader_id, unsigned int smooth)
 {
+	CCYCLES_CAPTURE(cycles_mesh_set_triangle, session_id, geometry, tri_idx, v0, v1, v2, shader_id,
+		smooth);
 	assert(false);
 
 	#if OLD_NOT_USED
@@ -262,6 +275,7 @@ void cycles_mesh_set_triangle(ccl::Session* session_id, ccl::Geometry* geometry,
 
 void cycles_mesh_add_triangle(ccl::Session* session_id, ccl::Geometry* geometry, unsigned int v0, unsigned int v1, unsigned int v2, ccl::Shader *shader_id, unsigned int smooth)
 {
+	CCYCLES_CAPTURE(cycles_mesh_add_triangle, session_id, geometry, v0, v1, v2, shader_id, smooth);
 	ASSERT(geometry);
 
 	ccl::Scene* sce = nullptr;
@@ -280,6 +294,8 @@ void cycles_mesh_add_triangle(ccl::Session* session_id, ccl::Geometry* geometry,
 
 void cycles_mesh_set_uvs(ccl::Session* session_id, ccl::Geometry* geometry, float *uvs, unsigned int uvcount, const char* uvmap_name)
 {
+	CCYCLES_CAPTURE(cycles_mesh_set_uvs, session_id, geometry,
+		ccycles_capture_array(uvs, uvcount * 2), uvcount, uvmap_name);
 	ASSERT(geometry);
 
 	ccl::Scene* sce = nullptr;
@@ -310,6 +326,8 @@ void cycles_mesh_set_uvs(ccl::Session* session_id, ccl::Geometry* geometry, floa
 
 void cycles_mesh_set_vertex_normals(ccl::Session* session_id, ccl::Geometry* geometry, float *vnormals, unsigned int vnormalcount)
 {
+	CCYCLES_CAPTURE(cycles_mesh_set_vertex_normals, session_id, geometry,
+		ccycles_capture_array(vnormals, vnormalcount * 3), vnormalcount);
 	ASSERT(geometry);
 
 	ccl::Scene* sce = nullptr;
@@ -342,6 +360,8 @@ void cycles_mesh_set_vertex_normals(ccl::Session* session_id, ccl::Geometry* geo
 
 void cycles_mesh_set_vertex_colors(ccl::Session* session_id, ccl::Geometry* geometry, float *vcolors, unsigned int vcolorcount)
 {
+	CCYCLES_CAPTURE(cycles_mesh_set_vertex_colors, session_id, geometry,
+		ccycles_capture_array(vcolors, vcolorcount * 3), vcolorcount);
 	ASSERT(geometry);
 
 	ccl::Scene* sce = nullptr;
@@ -536,6 +556,7 @@ static void mikk_compute_tangents(ccl::Mesh *mesh, ustring uvmap_name)
 
 void cycles_mesh_attr_tangentspace(ccl::Session* session_id, ccl::Geometry* geometry, const char* uvmap_name)
 {
+	CCYCLES_CAPTURE(cycles_mesh_attr_tangentspace, session_id, geometry, uvmap_name);
 	ASSERT(geometry);
 
 	ccl::Scene* sce = nullptr;
@@ -728,3 +749,19 @@ void attr_create_pointiness(ccl::Mesh *mesh)
 }
 
 #endif
+
+CCYCLES_CAPTURE_REPLAY(cycles_scene_add_mesh);
+CCYCLES_CAPTURE_REPLAY(cycles_geometry_set_shader);
+CCYCLES_CAPTURE_REPLAY(cycles_geometry_clear);
+CCYCLES_CAPTURE_REPLAY(cycles_geometry_tag_rebuild);
+CCYCLES_CAPTURE_REPLAY(cycles_mesh_set_smooth);
+CCYCLES_CAPTURE_REPLAY(cycles_mesh_reserve);
+CCYCLES_CAPTURE_REPLAY(cycles_mesh_resize);
+CCYCLES_CAPTURE_REPLAY(cycles_mesh_set_verts);
+CCYCLES_CAPTURE_REPLAY(cycles_mesh_set_tris);
+CCYCLES_CAPTURE_REPLAY(cycles_mesh_set_triangle);
+CCYCLES_CAPTURE_REPLAY(cycles_mesh_add_triangle);
+CCYCLES_CAPTURE_REPLAY(cycles_mesh_set_uvs);
+CCYCLES_CAPTURE_REPLAY(cycles_mesh_set_vertex_normals);
+CCYCLES_CAPTURE_REPLAY(cycles_mesh_set_vertex_colors);
+CCYCLES_CAPTURE_REPLAY(cycles_mesh_attr_tangentspace);
@@ -18,6 +18,7 @@ limitations under the License.
 
 ccl::Object* cycles_scene_add_object(ccl::Session* session_id)
 {
+	CCYCLES_CAPTURE(cycles_scene_add_object, session_id);
 	ccl::Scene* sce = session_id->scene;
 	if(sce) 
 	{
@@ -31,7 +32,7 @@ ccl::Object* cycles_scene_add_object(ccl::Session* session_id)
 		ob->tag_update(sce);
 		sce->light_manager->tag_update(sce, ccl::LightManager::UPDATE_ALL);
 
-		return ob;
+		return CCYCLES_CAPTURE_RESULT(ob);
 	}
 
 	return nullptr;
@@ -39,6 +40,7 @@ ccl::Object* cycles_scene_add_object(ccl::Session* session_id)
 
 void cycles_scene_object_delete(ccl::Session* session, ccl::Object* obj)
 {
+	CCYCLES_CAPTURE(cycles_scene_object_delete, session, obj);
 	#if 0
 	ccl::Scene* sce = session->scene;
 	if(sce)
@@ -50,6 +52,7 @@ void cycles_scene_object_delete(ccl::Session* session, ccl::Object* obj)
 
 void cycles_scene_object_set_geometry(ccl::Session* session_id, ccl::Object* object, ccl::Geometry* geometry)
 {
+	CCYCLES_CAPTURE(cycles_scene_object_set_geometry, session_id, object, geometry);
 	ASSERT(object);
 	ASSERT(geometry);
 
@@ -65,6 +68,7 @@ void cycles_scene_object_set_geometry(ccl::Session* session_id, ccl::Object* obj
 
 void cycles_object_tag_update(ccl::Session* session_id, ccl::Object* object)
 {
+	CCYCLES_CAPTURE(cycles_object_tag_update, session_id, object);
 	ASSERT(object);
 
 	ccl::Scene* sce = nullptr;
@@ -77,6 +81,7 @@ void cycles_object_tag_update(ccl::Session* session_id, ccl::Object* object)
 
 void cycles_scene_object_set_visibility(ccl::Session* session_id, ccl::Object* object, unsigned int visibility)
 {
+	CCYCLES_CAPTURE(cycles_scene_object_set_visibility, session_id, object, visibility);
 	ASSERT(object);
 
 	ccl::Scene* sce = nullptr;
@@ -92,6 +97,7 @@ void cycles_scene_object_set_shader(ccl::Session *session_id,
 									ccl::Object *object,
 									ccl::Shader *shader_id)
 {
+	CCYCLES_CAPTURE(cycles_scene_object_set_shader, session_id, object, shader_id);
 	ASSERT(object);
 
 	ccl::Scene* sce = session_id->scene;
@@ -138,6 +144,7 @@ void cycles_scene_object_set_shader(ccl::Session *session_id,
 
 void cycles_scene_object_set_is_shadowcatcher(ccl::Session* session_id, ccl::Object* object, bool is_shadowcatcher)
 {
+	CCYCLES_CAPTURE(cycles_scene_object_set_is_shadowcatcher, session_id, object, is_shadowcatcher);
 	ASSERT(object);
 
 	ccl::Scene* sce = nullptr;
@@ -150,6 +157,8 @@ void cycles_scene_object_set_is_shadowcatcher(ccl::Session* session_id, ccl::Obj
 
 void cycles_scene_object_set_mesh_light_no_cast_shadow(ccl::Session* session_id, ccl::Object* object, bool mesh_light_no_cast_shadow)
 {
+	CCYCLES_CAPTURE(cycles_scene_object_set_mesh_light_no_cast_shadow, session_id, object,
+		mesh_light_no_cast_shadow);
 	ASSERT(object);
 
 	ccl::Scene* sce = nullptr;
@@ -190,6 +199,8 @@ void cycles_scene_object_set_matrix(ccl::Session* session_id, ccl::Object* objec
 	float i, float j, float k, float l
 	)
 {
+	CCYCLES_CAPTURE(cycles_scene_object_set_matrix, session_id, object, a, b, c, d, e, f, g, h, i,
+		j, k, l);
 	ASSERT(object);
 
 	_cycles_scene_object_set_transform(session_id, object, 0,
@@ -204,6 +215,8 @@ void cycles_scene_object_set_ocs_frame(ccl::Session* session_id, ccl::Object* ob
 	float i, float j, float k, float l
 	)
 {
+	CCYCLES_CAPTURE(cycles_scene_object_set_ocs_frame, session_id, object, a, b, c, d, e, f, g, h,
+		i, j, k, l);
 	ASSERT(object);
 
 	_cycles_scene_object_set_transform(session_id, object, 1,
@@ -215,6 +228,7 @@ void cycles_scene_object_set_ocs_frame(ccl::Session* session_id, ccl::Object* ob
 
 void cycles_object_set_pass_id(ccl::Session* session_id, ccl::Object* object, int pass_id)
 {
+	CCYCLES_CAPTURE(cycles_object_set_pass_id, session_id, object, pass_id);
 	ASSERT(object);
 
 	ccl::Scene* sce = nullptr;
@@ -226,6 +240,7 @@ void cycles_object_set_pass_id(ccl::Session* session_id, ccl::Object* object, in
 
 void cycles_object_set_random_id(ccl::Session* session_id, ccl::Object* object, unsigned int random_id)
 {
+	CCYCLES_CAPTURE(cycles_object_set_random_id, session_id, object, random_id);
 	ASSERT(object);
 
 	ccl::Scene* sce = nullptr;
@@ -236,6 +251,7 @@ void cycles_object_set_random_id(ccl::Session* session_id, ccl::Object* object,
 
 void cycles_scene_clear_clipping_planes(ccl::Session* session_id)
 {
+	CCYCLES_CAPTURE(cycles_scene_clear_clipping_planes, session_id);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->clipping_planes.clear();
@@ -245,6 +261,7 @@ void cycles_scene_clear_clipping_planes(ccl::Session* session_id)
 
 unsigned int cycles_scene_add_clipping_plane(ccl::Session* session_id, float a, float b, float c, float d)
 {
+	CCYCLES_CAPTURE(cycles_scene_add_clipping_plane, session_id, a, b, c, d);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		ccl::float4 cp = ccl::make_float4(a, b, c, d);
@@ -254,7 +271,8 @@ unsigned int cycles_scene_add_clipping_plane(ccl::Session* session_id, float a,
 
 		sce->object_manager->need_clipping_plane_update = true;
 
-		return (unsigned int)(sce->clipping_planes.size() - 1);
+		return CCYCLES_CAPTURE_RESULT_ID((unsigned int)(sce->clipping_planes.size() - 1),
+			CAPTURE_ID_CLIPPING_PLANE);
 	}
 
 	return UINT_MAX;
@@ -262,11 +280,15 @@ unsigned int cycles_scene_add_clipping_plane(ccl::Session* session_id, float a,
 
 void cycles_scene_discard_clipping_plane(ccl::Session* session_id, unsigned int cp_id)
 {
+	CCYCLES_CAPTURE(cycles_scene_discard_clipping_plane, session_id,
+		ccycles_capture_id(cp_id, CAPTURE_ID_CLIPPING_PLANE));
 	cycles_scene_set_clipping_plane(session_id, cp_id, FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX);
 }
 
 void cycles_scene_set_clipping_plane(ccl::Session* session_id, unsigned int cp_id, float a, float b, float c, float d)
 {
+	CCYCLES_CAPTURE(cycles_scene_set_clipping_plane, session_id,
+		ccycles_capture_id(cp_id, CAPTURE_ID_CLIPPING_PLANE), a, b, c, d);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		ccl::float4 cp = ccl::make_float4(a, b, c, d);
@@ -277,3 +299,20 @@ void cycles_scene_set_clipping_plane(ccl::Session* session_id, unsigned int cp_i
 		sce->object_manager->need_clipping_plane_update = true;
 	}
 }
+
+CCYCLES_CAPTURE_REPLAY(cycles_scene_add_object);
+CCYCLES_CAPTURE_REPLAY(cycles_scene_object_delete);
+CCYCLES_CAPTURE_REPLAY(cycles_scene_object_set_geometry);
+CCYCLES_CAPTURE_REPLAY(cycles_object_tag_update);
+CCYCLES_CAPTURE_REPLAY(cycles_scene_object_set_visibility);
+CCYCLES_CAPTURE_REPLAY(cycles_scene_object_set_shader);
+CCYCLES_CAPTURE_REPLAY(cycles_scene_object_set_is_shadowcatcher);
+CCYCLES_CAPTURE_REPLAY(cycles_scene_object_set_mesh_light_no_cast_shadow);
+CCYCLES_CAPTURE_REPLAY(cycles_scene_object_set_matrix);
+CCYCLES_CAPTURE_REPLAY(cycles_scene_object_set_ocs_frame);
+CCYCLES_CAPTURE_REPLAY(cycles_object_set_pass_id);
+CCYCLES_CAPTURE_REPLAY(cycles_object_set_random_id);
+CCYCLES_CAPTURE_REPLAY(cycles_scene_clear_clipping_planes);
+CCYCLES_CAPTURE_REPLAY(cycles_scene_add_clipping_plane);
+CCYCLES_CAPTURE_REPLAY(cycles_scene_discard_clipping_plane);
+CCYCLES_CAPTURE_REPLAY(cycles_scene_set_clipping_plane);
@@ -0,0 +1,92 @@
+/**
+Copyright 2014-2022 Robert McNeel and Associates
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+/* Replays a capture of CCycles API calls in a headless session, recorded by setting the
+ * CCYCLES_CAPTURE environment variable or calling cycles_capture_start. */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+/* The API header relies on the Cycles types being declared. */
+#include "ccycles/internal_types.h"
+
+static void print_usage()
+{
+	printf("Usage: ccycles_replay [options] capture_file\n"
+		   "  --realtime     Make the calls at the times they were captured at\n"
+		   "  --no-stats     Do not print the time spent per function\n"
+		   "  --verbose      Print the CCycles log to stdout\n"
+		   "  --help         Print this message\n");
+}
+
+int main(int argc, const char** argv)
+{
+	std::string filepath;
+	bool realtime = false;
+	bool print_stats = true;
+	bool verbose = false;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--realtime") == 0) {
+			realtime = true;
+		}
+		else if (strcmp(argv[i], "--no-stats") == 0) {
+			print_stats = false;
+		}
+		else if (strcmp(argv[i], "--verbose") == 0) {
+			verbose = true;
+		}
+		else if (strcmp(argv[i], "--help") == 0) {
+			print_usage();
+			return EXIT_SUCCESS;
+		}
+		else if (argv[i][0] == '-' || !filepath.empty()) {
+			fprintf(stderr, "Invalid argument: %s\n", argv[i]);
+			print_usage();
+			return EXIT_FAILURE;
+		}
+		else {
+			filepath = argv[i];
+		}
+	}
+
+	if (filepath.empty()) {
+		print_usage();
+		return EXIT_FAILURE;
+	}
+
+	/* Kernels and data files are looked up next to the executable. */
+	std::string program_path = argv[0];
+	const size_t separator = program_path.find_last_of("/\\");
+	program_path = (separator == std::string::npos) ? "." : program_path.substr(0, separator);
+
+	cycles_log_to_stdout(verbose);
+	cycles_path_init(program_path.c_str(), "");
+	cycles_initialise();
+
+	const bool ok = cycles_capture_replay(filepath.c_str(), realtime, print_stats);
+
+	cycles_shutdown();
+
+	if (!ok) {
+		fprintf(stderr, "Failed to replay %s\n", filepath.c_str());
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -16,6 +16,8 @@ limitations under the License.
 
 #include "internal_types.h"
 
+#include "scene/binary.h"
+
 /* Find pointers for CCScene and ccl::Scene. Return false if either fails. */
 bool scene_find(ccl::Session* sid, ccl::Scene** sce)
 {
@@ -102,6 +104,7 @@ CCL_CAPI unsigned int CDECL cycles_scene_create(unsigned int scene_params_id, un
 
 CCL_CAPI void CDECL cycles_scene_set_default_surface_shader(ccl::Session *session_id, ccl::Shader *shader_id)
 {
+	CCYCLES_CAPTURE(cycles_scene_set_default_surface_shader, session_id, shader_id);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->default_surface = shader_id;
@@ -111,9 +114,10 @@ CCL_CAPI void CDECL cycles_scene_set_default_surface_shader(ccl::Session *sessio
 
 CCL_CAPI ccl::Shader* CDECL cycles_scene_get_default_surface_shader(ccl::Session *session_id)
 {
+	CCYCLES_CAPTURE(cycles_scene_get_default_surface_shader, session_id);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
-		return sce->default_surface;
+		return CCYCLES_CAPTURE_RESULT(sce->default_surface);
 	}
 
 	return nullptr;
@@ -121,9 +125,10 @@ CCL_CAPI ccl::Shader* CDECL cycles_scene_get_default_surface_shader(ccl::Session
 
 CCL_CAPI ccl::Shader* CDECL cycles_scene_get_background_shader(ccl::Session* session_id)
 {
+	CCYCLES_CAPTURE(cycles_scene_get_background_shader, session_id);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
-		return sce->default_background;
+		return CCYCLES_CAPTURE_RESULT(sce->default_background);
 	}
 	return nullptr;
 }
@@ -136,6 +141,7 @@ CCL_CAPI ccl::Shader* CDECL cycles_scene_get_background_shader(ccl::Session* ses
  */
 CCL_CAPI void CDECL cycles_scene_set_background_shader(ccl::Session *session_id, ccl::Shader *shader_id)
 {
+	CCYCLES_CAPTURE(cycles_scene_set_background_shader, session_id, shader_id);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->default_background = shader_id;
@@ -148,12 +154,36 @@ CCL_CAPI void CDECL cycles_scene_set_background_shader(ccl::Session *session_id,
 
 CCL_CAPI void CDECL cycles_scene_reset(ccl::Session* session_id)
 {
+	CCYCLES_CAPTURE(cycles_scene_reset, session_id);
 	ccl::Scene* sce = nullptr;
 	if(scene_find(session_id, &sce)) {
 		sce->reset();
 	}
 }
 
+CCL_CAPI bool CDECL cycles_scene_write_binary(ccl::Session* session_id, const char* filepath)
+{
+	ccl::Scene* sce = nullptr;
+	if(scene_find(session_id, &sce)) {
+		ccl::thread_scoped_lock scene_lock(sce->mutex);
+		logger.logit("Scene ", session_id, " write binary ", filepath);
+		return ccl::scene_write_binary(sce, filepath);
+	}
+	return false;
+}
+
+CCL_CAPI bool CDECL cycles_scene_read_binary(ccl::Session* session_id, const char* filepath)
+{
+	CCYCLES_CAPTURE(cycles_scene_read_binary, session_id, filepath);
+	ccl::Scene* sce = nullptr;
+	if(scene_find(session_id, &sce)) {
+		ccl::thread_scoped_lock scene_lock(sce->mutex);
+		logger.logit("Scene ", session_id, " read binary ", filepath);
+		return ccl::scene_read_binary(sce, filepath);
+	}
+	return false;
+}
+
 CCL_CAPI bool CDECL cycles_scene_try_lock(ccl::Session* session)
 {
 	return session->scene->mutex.try_lock();
@@ -161,14 +191,25 @@ CCL_CAPI bool CDECL cycles_scene_try_lock(ccl::Session* session)
 
 CCL_CAPI void CDECL cycles_scene_lock(ccl::Session* session)
 {
+	CCYCLES_CAPTURE(cycles_scene_lock, session);
 	session->scene->mutex.lock();
 }
 
 CCL_CAPI void CDECL cycles_scene_unlock(ccl::Session* session)
 {
+	CCYCLES_CAPTURE(cycles_scene_unlock, session);
 	session->scene->mutex.unlock();
 }
 
 #ifdef __cplusplus
 }
 #endif
+
+CCYCLES_CAPTURE_REPLAY(cycles_scene_set_default_surface_shader);
+CCYCLES_CAPTURE_REPLAY(cycles_scene_get_default_surface_shader);
+CCYCLES_CAPTURE_REPLAY(cycles_scene_get_background_shader);
+CCYCLES_CAPTURE_REPLAY(cycles_scene_set_background_shader);
+CCYCLES_CAPTURE_REPLAY(cycles_scene_reset);
+CCYCLES_CAPTURE_REPLAY(cycles_scene_read_binary);
+CCYCLES_CAPTURE_REPLAY(cycles_scene_lock);
+CCYCLES_CAPTURE_REPLAY(cycles_scene_unlock);
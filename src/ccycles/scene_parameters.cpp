@@ -30,6 +30,8 @@ unsigned int cycles_scene_params_create(
 	unsigned int use_bvh_spatial_split, 
 	int bvh_layout, unsigned int persistent_data)
 {
+	CCYCLES_CAPTURE(cycles_scene_params_create, shadingsystem, bvh_type, use_bvh_spatial_split,
+		bvh_layout, persistent_data);
 	ccl::SceneParams* params = new ccl::SceneParams();
 
 	params->shadingsystem = (ccl::ShadingSystem)shadingsystem;
@@ -44,21 +46,28 @@ unsigned int cycles_scene_params_create(
     /*
 	logger.logit("Created scene parameters ", scene_params.size() - 1, "\n\tshading system: ", params->shadingsystem, "\n\tbvh_type: ", params->bvh_type, "\n\tuse_bvh_spatial_split: ", params->use_bvh_spatial_split, "\n\tuse_qbvh: ", params->bvh_layout, "\n\tpersistent data: ", params->persistent_data);*/
 
-	return (unsigned int)(scene_params.size() - 1);
+	return CCYCLES_CAPTURE_RESULT_ID((unsigned int)(scene_params.size() - 1),
+		CAPTURE_ID_SCENE_PARAMS);
 }
 
 /* Set scene parameters*/
 void cycles_scene_params_set_bvh_type(unsigned int scene_params_id, unsigned int bvh_type)
 {
+	CCYCLES_CAPTURE(cycles_scene_params_set_bvh_type,
+		ccycles_capture_id(scene_params_id, CAPTURE_ID_SCENE_PARAMS), bvh_type);
 	SCENE_PARAM_CAST(scene_params_id, ccl::BVHType, bvh_type)
 }
 
 void cycles_scene_params_set_bvh_spatial_split(unsigned int scene_params_id, unsigned int use_bvh_spatial_split)
 {
+	CCYCLES_CAPTURE(cycles_scene_params_set_bvh_spatial_split,
+		ccycles_capture_id(scene_params_id, CAPTURE_ID_SCENE_PARAMS), use_bvh_spatial_split);
 	SCENE_PARAM_BOOL(scene_params_id, use_bvh_spatial_split)
 }
 void cycles_scene_params_set_qbvh(unsigned int scene_params_id, unsigned int use_qbvh)
 {
+	CCYCLES_CAPTURE(cycles_scene_params_set_qbvh,
+		ccycles_capture_id(scene_params_id, CAPTURE_ID_SCENE_PARAMS), use_qbvh);
     // TODO: XXXX revisit BVH settings, there are different ones now.
     // For now default to BVH_LAYOUT_BVH2, but there will be much better ones
 	ccl::BVHLayout bvh_layout = ccl::BVHLayout::BVH_LAYOUT_BVH2;
@@ -67,11 +76,30 @@ void cycles_scene_params_set_qbvh(unsigned int scene_params_id, unsigned int use
 
 void cycles_scene_params_set_shadingsystem(unsigned int scene_params_id, unsigned int shadingsystem)
 {
+	CCYCLES_CAPTURE(cycles_scene_params_set_shadingsystem,
+		ccycles_capture_id(scene_params_id, CAPTURE_ID_SCENE_PARAMS), shadingsystem);
 	SCENE_PARAM_CAST(scene_params_id, ccl::ShadingSystem, shadingsystem)
 }
+void cycles_scene_params_set_texture_compression(unsigned int scene_params_id, unsigned int texture_compression)
+{
+	CCYCLES_CAPTURE(cycles_scene_params_set_texture_compression,
+		ccycles_capture_id(scene_params_id, CAPTURE_ID_SCENE_PARAMS), texture_compression);
+	SCENE_PARAM_CAST(scene_params_id, ccl::ImageCompression, texture_compression)
+}
+
 void cycles_scene_params_set_persistent_data(unsigned int scene_params_id, unsigned int persistent_data)
 {
+	CCYCLES_CAPTURE(cycles_scene_params_set_persistent_data,
+		ccycles_capture_id(scene_params_id, CAPTURE_ID_SCENE_PARAMS), persistent_data);
 	assert(false);
     // TODO: XXXX no longer exists
 	//SCENE_PARAM_BOOL(scene_params_id, persistent_data)
 }
+
+CCYCLES_CAPTURE_REPLAY(cycles_scene_params_create);
+CCYCLES_CAPTURE_REPLAY(cycles_scene_params_set_bvh_type);
+CCYCLES_CAPTURE_REPLAY(cycles_scene_params_set_bvh_spatial_split);
+CCYCLES_CAPTURE_REPLAY(cycles_scene_params_set_qbvh);
+CCYCLES_CAPTURE_REPLAY(cycles_scene_params_set_shadingsystem);
+CCYCLES_CAPTURE_REPLAY(cycles_scene_params_set_texture_compression);
+CCYCLES_CAPTURE_REPLAY(cycles_scene_params_set_persistent_data);
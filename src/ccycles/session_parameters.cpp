@@ -37,17 +37,19 @@ extern "C" {
 
 CCL_CAPI ccl::SessionParams* CDECL cycles_session_params_create(unsigned int device_id)
 {
+	CCYCLES_CAPTURE(cycles_session_params_create, device_id);
 	ccl::SessionParams* params = new ccl::SessionParams();
 
 	GETDEVICE(params->device, device_id);
 	session_params.insert(params);
 	logger.logit("Created session parameters for device ", device_id);
 
-	return params;
+	return CCYCLES_CAPTURE_RESULT(params);
 }
 
 CCL_CAPI void CDECL cycles_session_params_set_device(ccl::SessionParams* session_params_id, unsigned int device)
 {
+	CCYCLES_CAPTURE(cycles_session_params_set_device, session_params_id, device);
 	if (auto search = session_params.find(session_params_id); search != session_params.end()) {
 		GETDEVICE((*search)->device, device)
 	}
@@ -55,6 +57,7 @@ CCL_CAPI void CDECL cycles_session_params_set_device(ccl::SessionParams* session
 
 CCL_CAPI void CDECL cycles_session_params_set_background(ccl::SessionParams* session_params_id, unsigned int background)
 {
+	CCYCLES_CAPTURE(cycles_session_params_set_background, session_params_id, background);
 	if (auto search = session_params.find(session_params_id); search != session_params.end()) {
 		(*search)->background = background != 0;
 	}
@@ -62,6 +65,7 @@ CCL_CAPI void CDECL cycles_session_params_set_background(ccl::SessionParams* ses
 
 CCL_CAPI void CDECL cycles_session_params_set_experimental(ccl::SessionParams* session_params_id, unsigned int experimental)
 {
+	CCYCLES_CAPTURE(cycles_session_params_set_experimental, session_params_id, experimental);
 	if (auto search = session_params.find(session_params_id); search != session_params.end()) {
 		(*search)->experimental = experimental != 0;
 	}
@@ -69,6 +73,7 @@ CCL_CAPI void CDECL cycles_session_params_set_experimental(ccl::SessionParams* s
 
 CCL_CAPI void CDECL cycles_session_params_set_samples(ccl::SessionParams* session_params_id, int samples)
 {
+	CCYCLES_CAPTURE(cycles_session_params_set_samples, session_params_id, samples);
 	if (auto search = session_params.find(session_params_id); search != session_params.end()) {
 		(*search)->samples = samples;
 	}
@@ -76,6 +81,7 @@ CCL_CAPI void CDECL cycles_session_params_set_samples(ccl::SessionParams* sessio
 
 CCL_CAPI void CDECL cycles_session_params_set_tile_size(ccl::SessionParams* session_params_id, unsigned int tile_size)
 {
+	CCYCLES_CAPTURE(cycles_session_params_set_tile_size, session_params_id, tile_size);
 	if (auto search = session_params.find(session_params_id); search != session_params.end()) {
 		(*search)->tile_size = tile_size;
 	}
@@ -83,13 +89,39 @@ CCL_CAPI void CDECL cycles_session_params_set_tile_size(ccl::SessionParams* sess
 
 CCL_CAPI void CDECL cycles_session_params_set_threads(ccl::SessionParams* session_params_id, unsigned int threads)
 {
+	CCYCLES_CAPTURE(cycles_session_params_set_threads, session_params_id, threads);
 	if (auto search = session_params.find(session_params_id); search != session_params.end()) {
 		(*search)->threads = threads;
 	}
 }
 
+CCL_CAPI void CDECL cycles_session_params_set_time_limit(ccl::SessionParams* session_params_id, double time_limit)
+{
+	CCYCLES_CAPTURE(cycles_session_params_set_time_limit, session_params_id, time_limit);
+	if (auto search = session_params.find(session_params_id); search != session_params.end()) {
+		(*search)->time_limit = time_limit;
+	}
+}
+
+CCL_CAPI void CDECL cycles_session_params_set_use_time_budget(ccl::SessionParams* session_params_id, bool use_time_budget)
+{
+	CCYCLES_CAPTURE(cycles_session_params_set_use_time_budget, session_params_id, use_time_budget);
+	if (auto search = session_params.find(session_params_id); search != session_params.end()) {
+		(*search)->use_time_budget = use_time_budget;
+	}
+}
+
+CCL_CAPI void CDECL cycles_session_params_set_use_numa(ccl::SessionParams* session_params_id, bool use_numa)
+{
+	CCYCLES_CAPTURE(cycles_session_params_set_use_numa, session_params_id, use_numa);
+	if (auto search = session_params.find(session_params_id); search != session_params.end()) {
+		(*search)->use_numa = use_numa;
+	}
+}
+
 CCL_CAPI void CDECL cycles_session_params_set_shadingsystem(ccl::SessionParams* session_params_id, unsigned int shadingsystem)
 {
+	CCYCLES_CAPTURE(cycles_session_params_set_shadingsystem, session_params_id, shadingsystem);
 	if (auto search = session_params.find(session_params_id); search != session_params.end()) {
 		(*search)->shadingsystem = (ccl::ShadingSystem)shadingsystem;
 	}
@@ -97,6 +129,7 @@ CCL_CAPI void CDECL cycles_session_params_set_shadingsystem(ccl::SessionParams*
 
 CCL_CAPI void CDECL cycles_session_params_set_pixel_size(ccl::SessionParams* session_params_id, unsigned int pixel_size)
 {
+	CCYCLES_CAPTURE(cycles_session_params_set_pixel_size, session_params_id, pixel_size);
 	if (auto search = session_params.find(session_params_id); search != session_params.end()) {
 		(*search)->pixel_size = pixel_size;
 	}
@@ -104,11 +137,36 @@ CCL_CAPI void CDECL cycles_session_params_set_pixel_size(ccl::SessionParams* ses
 
 CCL_CAPI void CDECL cycles_session_params_set_use_resolution_divider(ccl::SessionParams* session_params_id, bool use_resolution_divider)
 {
+	CCYCLES_CAPTURE(cycles_session_params_set_use_resolution_divider, session_params_id,
+		use_resolution_divider);
 	if (auto search = session_params.find(session_params_id); search != session_params.end()) {
 		(*search)->use_resolution_divider = use_resolution_divider;
 	}
 }
 
+CCL_CAPI void CDECL cycles_session_params_set_use_profiling(ccl::SessionParams* session_params_id, bool use_profiling)
+{
+	CCYCLES_CAPTURE(cycles_session_params_set_use_profiling, session_params_id, use_profiling);
+	if (auto search = session_params.find(session_params_id); search != session_params.end()) {
+		(*search)->use_profiling = use_profiling;
+	}
+}
+
 #ifdef __cplusplus
 }
 #endif
+
+CCYCLES_CAPTURE_REPLAY(cycles_session_params_create);
+CCYCLES_CAPTURE_REPLAY(cycles_session_params_set_device);
+CCYCLES_CAPTURE_REPLAY(cycles_session_params_set_background);
+CCYCLES_CAPTURE_REPLAY(cycles_session_params_set_experimental);
+CCYCLES_CAPTURE_REPLAY(cycles_session_params_set_samples);
+CCYCLES_CAPTURE_REPLAY(cycles_session_params_set_tile_size);
+CCYCLES_CAPTURE_REPLAY(cycles_session_params_set_threads);
+CCYCLES_CAPTURE_REPLAY(cycles_session_params_set_time_limit);
+CCYCLES_CAPTURE_REPLAY(cycles_session_params_set_use_time_budget);
+CCYCLES_CAPTURE_REPLAY(cycles_session_params_set_use_numa);
+CCYCLES_CAPTURE_REPLAY(cycles_session_params_set_shadingsystem);
+CCYCLES_CAPTURE_REPLAY(cycles_session_params_set_pixel_size);
+CCYCLES_CAPTURE_REPLAY(cycles_session_params_set_use_resolution_divider);
+CCYCLES_CAPTURE_REPLAY(cycles_session_params_set_use_profiling);
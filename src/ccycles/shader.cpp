@@ -64,11 +64,12 @@ extern "C" {
 
 CCL_CAPI ccl::Shader* CDECL cycles_create_shader(ccl::Session *session)
 {
+	CCYCLES_CAPTURE(cycles_create_shader, session);
 	ccl::Shader *shader = session->scene->create_node<ccl::Shader>();
 	shader->set_graph(new ccl::ShaderGraph());
 	shader->set_displacement_method(ccl::DisplacementMethod::DISPLACE_TRUE);
 	shader->has_displacement = true;
-	return shader;
+	return CCYCLES_CAPTURE_RESULT(shader);
 }
 
 CCL_CAPI int CDECL cycles_shader_node_count(ccl::Shader *shader)
@@ -78,11 +79,12 @@ CCL_CAPI int CDECL cycles_shader_node_count(ccl::Shader *shader)
 
 CCL_CAPI ccl::ShaderNode* CDECL cycles_shader_node_get(ccl::Shader *shader, int idx)
 {
+	CCYCLES_CAPTURE(cycles_shader_node_get, shader, idx);
 	int count = 0;
 	auto it = shader->graph->nodes.cbegin();
 	while (it != shader->graph->nodes.cend() && count < shader->graph->nodes.size()) {
 		if (count == idx)
-			return *it;
+			return CCYCLES_CAPTURE_RESULT(*it);
 		it++;
 		count++;
 	}
@@ -274,6 +276,7 @@ CCL_CAPI bool CDECL cycles_shader_get_name(ccl::Shader *sh, void *strholder)
 
 CCL_CAPI void CDECL cycles_scene_tag_shader(ccl::Session *session_id, ccl::Shader *shader_id, bool use)
 {
+	CCYCLES_CAPTURE(cycles_scene_tag_shader, session_id, shader_id, use);
 	ccl::Scene *sce = nullptr;
 	if (scene_find(session_id, &sce)) {
 		shader_id->tag_update(sce);
@@ -301,6 +304,7 @@ CCL_CAPI unsigned int CDECL cycles_scene_shader_id(ccl::Session *session_id, uns
 
 CCL_CAPI void CDECL cycles_shader_new_graph(ccl::Shader *shader)
 {
+	CCYCLES_CAPTURE(cycles_shader_new_graph, shader);
 	shader->set_graph(new ccl::ShaderGraph());
 }
 
@@ -311,11 +315,13 @@ CCL_CAPI void CDECL cycles_shader_dump_graph(ccl::Shader *shader, const char *fi
 
 CCL_CAPI void CDECL cycles_shader_set_name(ccl::Shader *shader, const char *_name)
 {
+	CCYCLES_CAPTURE(cycles_shader_set_name, shader, _name);
 	shader->name = _name;
 }
 
 CCL_CAPI void CDECL cycles_shader_set_pass_id(ccl::Shader *shader, int pass_id)
 {
+	CCYCLES_CAPTURE(cycles_shader_set_pass_id, shader, pass_id);
 	shader->set_pass_id(pass_id);
 }
 
@@ -328,6 +334,7 @@ CCL_CAPI void CDECL cycles_shader_set_use_mis(ccl::Session *session_id,
 							   ccl::Shader *shader_id,
 							   unsigned int use_mis)
 {
+	CCYCLES_CAPTURE(cycles_shader_set_use_mis, session_id, shader_id, use_mis);
 	// TODO: XXXX Look into this - we clearly need to change the signature of this method to
 	// support three different sampling methods.
 	// if (shader_id)
@@ -340,6 +347,8 @@ CCL_CAPI void CDECL cycles_shader_set_use_transparent_shadow(ccl::Session *sessi
 											  ccl::Shader *shader_id,
 											  unsigned int use_transparent_shadow)
 {
+	CCYCLES_CAPTURE(cycles_shader_set_use_transparent_shadow, session_id, shader_id,
+		use_transparent_shadow);
 	if (shader_id)
 		shader_id->set_use_transparent_shadow(use_transparent_shadow == 1);
 }
@@ -348,6 +357,8 @@ CCL_CAPI void CDECL cycles_shader_set_heterogeneous_volume(ccl::Session *session
 											ccl::Shader *shader_id,
 											unsigned int heterogeneous_volume)
 {
+	CCYCLES_CAPTURE(cycles_shader_set_heterogeneous_volume, session_id, shader_id,
+		heterogeneous_volume);
 	if (shader_id)
 		shader_id->set_heterogeneous_volume(heterogeneous_volume == 1);
 }
@@ -356,6 +367,7 @@ CCL_CAPI ccl::ShaderNode* CDECL cycles_add_shader_node(ccl::Shader *shader_id,
 										const char *node_type_name,
 										const char *name)
 {
+	CCYCLES_CAPTURE(cycles_add_shader_node, shader_id, node_type_name, name);
 	const ccl::NodeType *node_type = ccl::NodeType::find(ustring(node_type_name));
 	ccl::ShaderNode *node = (ccl::ShaderNode *)node_type->create(node_type);
 
@@ -373,7 +385,7 @@ CCL_CAPI ccl::ShaderNode* CDECL cycles_add_shader_node(ccl::Shader *shader_id,
 		}
 	}
 
-	return node;
+	return CCYCLES_CAPTURE_RESULT(node);
 }
 #ifdef __cplusplus
 }
@@ -443,6 +455,8 @@ extern "C" {
 CCL_CAPI void CDECL cycles_shadernode_texmapping_set_transformation(
 	ccl::ShaderNode *shnode, int transform_type, float x, float y, float z)
 {
+	CCYCLES_CAPTURE(cycles_shadernode_texmapping_set_transformation, shnode, transform_type, x, y,
+		z);
 	ccl::TextureNode *texnode = dynamic_cast<ccl::TextureNode *>(shnode);
 	_set_texture_mapping_transformation(texnode->tex_mapping, transform_type, x, y, z);
 }
@@ -452,6 +466,7 @@ CCL_CAPI void CDECL cycles_shadernode_texmapping_set_mapping(ccl::ShaderNode *sh
 											  ccl::TextureMapping::Mapping y,
 											  ccl::TextureMapping::Mapping z)
 {
+	CCYCLES_CAPTURE(cycles_shadernode_texmapping_set_mapping, shnode, x, y, z);
 	if (shnode) {
 	std::string shn_type = shnode->type->name.string();
 	if (shn_type == "mapping") {
@@ -506,6 +521,7 @@ CCL_CAPI void CDECL cycles_shadernode_texmapping_set_mapping(ccl::ShaderNode *sh
 CCL_CAPI void CDECL cycles_shadernode_texmapping_set_projection(ccl::ShaderNode *shnode,
 												 ccl::TextureMapping::Projection tm_projection)
 {
+	CCYCLES_CAPTURE(cycles_shadernode_texmapping_set_projection, shnode, tm_projection);
 	assert(false);
 	/*
 	ccl::ShaderNode* shnode = _shader_node_find(session_id, shader_id, shnode_id);
@@ -526,6 +542,7 @@ CCL_CAPI void CDECL cycles_shadernode_texmapping_set_projection(ccl::ShaderNode
 
 CCL_CAPI void CDECL cycles_shadernode_texmapping_set_type(ccl::ShaderNode *shnode, ccl::NodeMappingType tm_type)
 {
+	CCYCLES_CAPTURE(cycles_shadernode_texmapping_set_type, shnode, tm_type);
 	if (shnode) {
 	std::string shn_type = shnode->type->name.string();
 	if (shn_type == "mapping") {
@@ -539,6 +556,7 @@ CCL_CAPI void CDECL cycles_shadernode_texmapping_set_type(ccl::ShaderNode *shnod
  */
 CCL_CAPI void CDECL cycles_shadernode_set_enum(ccl::ShaderNode *shnode, const char *enum_name, int value)
 {
+	CCYCLES_CAPTURE(cycles_shadernode_set_enum, shnode, enum_name, value);
 	auto ename = std::string{enum_name};
 
 	auto shntype = shnode->type->name.string();
@@ -750,6 +768,7 @@ CCL_CAPI void CDECL cycles_shadernode_set_member_bool(ccl::ShaderNode *shnode,
 									   const char *member_name,
 									   bool value)
 {
+	CCYCLES_CAPTURE(cycles_shadernode_set_member_bool, shnode, member_name, value);
 	auto mname = std::string{member_name};
 	if (shnode) {
 		std::string shntype = shnode->type->name.string();
@@ -877,6 +896,7 @@ CCL_CAPI void CDECL cycles_shadernode_set_member_bool(ccl::ShaderNode *shnode,
 
 CCL_CAPI void CDECL cycles_shadernode_set_member_int(ccl::ShaderNode *shnode, const char *member_name, int value)
 {
+	CCYCLES_CAPTURE(cycles_shadernode_set_member_int, shnode, member_name, value);
 	auto mname = std::string{member_name};
 	if (shnode) {
 		std::string shn_type = shnode->type->name.string();
@@ -974,6 +994,7 @@ CCL_CAPI void CDECL cycles_shadernode_set_member_float(ccl::ShaderNode *shnode,
 										const char *member_name,
 										float value)
 {
+	CCYCLES_CAPTURE(cycles_shadernode_set_member_float, shnode, member_name, value);
 	auto mname = std::string{member_name};
 
 	if (shnode) {
@@ -1191,6 +1212,8 @@ CCL_CAPI void CDECL cycles_shadernode_set_member_vec4_at_index(ccl::ShaderNode *
 												float w,
 												int index)
 {
+	CCYCLES_CAPTURE(cycles_shadernode_set_member_vec4_at_index, shnode, member_name, x, y, z, w,
+		index);
 	auto mname = std::string{member_name};
 
 	if (shnode) {
@@ -1239,6 +1262,7 @@ CCL_CAPI void CDECL cycles_shadernode_set_member_vec4_at_index(ccl::ShaderNode *
 CCL_CAPI void CDECL cycles_shadernode_set_member_vec(
 	ccl::ShaderNode *shnode, const char *member_name, float x, float y, float z)
 {
+	CCYCLES_CAPTURE(cycles_shadernode_set_member_vec, shnode, member_name, x, y, z);
 	auto mname = std::string{member_name};
 
 	if (shnode) {
@@ -1320,6 +1344,7 @@ CCL_CAPI void CDECL cycles_shadernode_set_member_string(ccl::ShaderNode *shnode,
 										 const char *member_name,
 										 const char *value)
 {
+	CCYCLES_CAPTURE(cycles_shadernode_set_member_string, shnode, member_name, value);
 	auto mname = std::string{member_name};
 	auto mval = std::string{value};
 	ustring umval = ustring(mval);
@@ -1352,6 +1377,7 @@ CCL_CAPI void CDECL cycles_shadernode_set_attribute_int(ccl::ShaderNode *shnode_
 										 const char *attribute_name,
 										 int value)
 {
+	CCYCLES_CAPTURE(cycles_shadernode_set_attribute_int, shnode_id, attribute_name, value);
 	bool set = false;
 	std::string sockname{attribute_name};
 	for (const ccl::SocketType &socket : shnode_id->type->inputs) {
@@ -1374,6 +1400,7 @@ CCL_CAPI void CDECL cycles_shadernode_set_attribute_bool(ccl::ShaderNode *shnode
 										  const char *attribute_name,
 										  bool value)
 {
+	CCYCLES_CAPTURE(cycles_shadernode_set_attribute_bool, shnode_id, attribute_name, value);
 	bool set = false;
 	std::string sockname{attribute_name};
 	for (const ccl::SocketType &socket : shnode_id->type->inputs) {
@@ -1416,6 +1443,7 @@ CCL_CAPI void CDECL cycles_shadernode_set_attribute_string(ccl::ShaderNode *shno
 											const UTFCHAR *attribute_name,
 											const UTFCHAR *value)
 {
+	CCYCLES_CAPTURE(cycles_shadernode_set_attribute_string, shnode_id, attribute_name, value);
 	bool set = false;
 	std::string sockname = ws2s(attribute_name);
 	std::string nval = ws2s(value);
@@ -1446,6 +1474,7 @@ CCL_CAPI void CDECL cycles_shadernode_set_attribute_float(ccl::ShaderNode *shnod
 										   const char *attribute_name,
 										   float value)
 {
+	CCYCLES_CAPTURE(cycles_shadernode_set_attribute_float, shnode_id, attribute_name, value);
 	bool set = false;
 	std::string sockname{attribute_name};
 	for (const ccl::SocketType &socket : shnode_id->type->inputs) {
@@ -1470,6 +1499,7 @@ Set a vector of floats attribute with given name to x, y and z. shader_id is the
 CCL_CAPI void CDECL cycles_shadernode_set_attribute_vec(
 	ccl::ShaderNode *shnode_id, const char *attribute_name, float x, float y, float z)
 {
+	CCYCLES_CAPTURE(cycles_shadernode_set_attribute_vec, shnode_id, attribute_name, x, y, z);
 	bool set = false;
 	ccl::float3 f3 = ccl::make_float3(x, y, z);
 	std::string sockname{attribute_name};
@@ -1495,6 +1525,7 @@ CCL_CAPI bool CDECL cycles_shader_connect_nodes(ccl::Shader *shader_id,
 								 ccl::ShaderNode *to_id,
 								 const char *to)
 {
+	CCYCLES_CAPTURE(cycles_shader_connect_nodes, shader_id, from_id, from, to_id, to);
 	bool res = false;
 	assert(shader_id);
 	assert(from_id);
@@ -1519,6 +1550,7 @@ CCL_CAPI void CDECL cycles_shader_disconnect_node(ccl::Shader *shader_id,
 								   ccl::ShaderNode *from_id,
 								   const char *from)
 {
+	CCYCLES_CAPTURE(cycles_shader_disconnect_node, shader_id, from_id, from);
 	assert(shader_id);
 	assert(from_id);
 	if (shader_id && from_id)
@@ -1599,3 +1631,31 @@ CCL_CAPI void CDECL cycles_apply_gamma_to_float_buffer(float* rgba_buffer, size_
 }
 #endif
 
+CCYCLES_CAPTURE_REPLAY(cycles_create_shader);
+CCYCLES_CAPTURE_REPLAY(cycles_shader_node_get);
+CCYCLES_CAPTURE_REPLAY(cycles_scene_tag_shader);
+CCYCLES_CAPTURE_REPLAY(cycles_shader_new_graph);
+CCYCLES_CAPTURE_REPLAY(cycles_shader_set_name);
+CCYCLES_CAPTURE_REPLAY(cycles_shader_set_pass_id);
+CCYCLES_CAPTURE_REPLAY(cycles_shader_set_use_mis);
+CCYCLES_CAPTURE_REPLAY(cycles_shader_set_use_transparent_shadow);
+CCYCLES_CAPTURE_REPLAY(cycles_shader_set_heterogeneous_volume);
+CCYCLES_CAPTURE_REPLAY(cycles_add_shader_node);
+CCYCLES_CAPTURE_REPLAY(cycles_shadernode_texmapping_set_transformation);
+CCYCLES_CAPTURE_REPLAY(cycles_shadernode_texmapping_set_mapping);
+CCYCLES_CAPTURE_REPLAY(cycles_shadernode_texmapping_set_projection);
+CCYCLES_CAPTURE_REPLAY(cycles_shadernode_texmapping_set_type);
+CCYCLES_CAPTURE_REPLAY(cycles_shadernode_set_enum);
+CCYCLES_CAPTURE_REPLAY(cycles_shadernode_set_member_bool);
+CCYCLES_CAPTURE_REPLAY(cycles_shadernode_set_member_int);
+CCYCLES_CAPTURE_REPLAY(cycles_shadernode_set_member_float);
+CCYCLES_CAPTURE_REPLAY(cycles_shadernode_set_member_vec4_at_index);
+CCYCLES_CAPTURE_REPLAY(cycles_shadernode_set_member_vec);
+CCYCLES_CAPTURE_REPLAY(cycles_shadernode_set_member_string);
+CCYCLES_CAPTURE_REPLAY(cycles_shadernode_set_attribute_int);
+CCYCLES_CAPTURE_REPLAY(cycles_shadernode_set_attribute_bool);
+CCYCLES_CAPTURE_REPLAY(cycles_shadernode_set_attribute_string);
+CCYCLES_CAPTURE_REPLAY(cycles_shadernode_set_attribute_float);
+CCYCLES_CAPTURE_REPLAY(cycles_shadernode_set_attribute_vec);
+CCYCLES_CAPTURE_REPLAY(cycles_shader_connect_nodes);
+CCYCLES_CAPTURE_REPLAY(cycles_shader_disconnect_node);
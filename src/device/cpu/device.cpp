@@ -28,6 +28,8 @@ void device_cpu_info(vector<DeviceInfo> &devices)
   info.has_osl = true;
   info.has_nanovdb = true;
   info.has_profiling = true;
+  info.has_texture_compression = true;
+  info.has_texture_sharing = true;
   if (guiding_supported()) {
     info.has_guiding = true;
   }
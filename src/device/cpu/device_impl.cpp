@@ -73,6 +73,8 @@ CPUDevice::CPUDevice(const DeviceInfo &info_, Stats &stats_, Profiler &profiler_
 
 CPUDevice::~CPUDevice()
 {
+  numa_replicas_free();
+
 #ifdef WITH_EMBREE
   rtcReleaseDevice(embree_device);
 #endif
@@ -126,7 +128,7 @@ void CPUDevice::mem_alloc(device_memory &mem)
     }
 
     mem.device_size = mem.memory_size();
-    stats.mem_alloc(mem.device_size);
+    stats.mem_alloc(mem.device_size, mem.category());
   }
 }
 
@@ -179,7 +181,7 @@ void CPUDevice::mem_free(device_memory &mem)
       util_aligned_free((void *)mem.device_pointer);
     }
     mem.device_pointer = 0;
-    stats.mem_free(mem.device_size);
+    stats.mem_free(mem.device_size, mem.category());
     mem.device_size = 0;
   }
 }
@@ -210,17 +212,19 @@ void CPUDevice::global_alloc(device_memory &mem)
             << string_human_readable_size(mem.memory_size()) << ")";
 
   kernel_global_memory_copy(&kernel_globals, mem.name, mem.host_pointer, mem.data_size);
+  numa_replicas_free();
 
   mem.device_pointer = (device_ptr)mem.host_pointer;
   mem.device_size = mem.memory_size();
-  stats.mem_alloc(mem.device_size);
+  stats.mem_alloc(mem.device_size, mem.category());
 }
 
 void CPUDevice::global_free(device_memory &mem)
 {
   if (mem.device_pointer) {
+    numa_replicas_free();
     mem.device_pointer = 0;
-    stats.mem_free(mem.device_size);
+    stats.mem_free(mem.device_size, mem.category());
     mem.device_size = 0;
   }
 }
@@ -232,8 +236,9 @@ void CPUDevice::tex_alloc(device_texture &mem)
             << string_human_readable_size(mem.memory_size()) << ")";
 
   mem.device_pointer = (device_ptr)mem.host_pointer;
-  mem.device_size = mem.memory_size();
-  stats.mem_alloc(mem.device_size);
+  /* Shared memory is already accounted for by the texture that owns it. */
+  mem.device_size = (mem.is_host_memory_shared()) ? 0 : mem.memory_size();
+  stats.mem_alloc(mem.device_size, mem.category());
 
   const uint slot = mem.slot;
   if (slot >= texture_info.size()) {
@@ -250,7 +255,7 @@ void CPUDevice::tex_free(device_texture &mem)
 {
   if (mem.device_pointer) {
     mem.device_pointer = 0;
-    stats.mem_free(mem.device_size);
+    stats.mem_free(mem.device_size, mem.category());
     mem.device_size = 0;
     need_texture_info = true;
   }
@@ -309,6 +314,127 @@ void CPUDevice::get_cpu_kernel_thread_globals(
   }
 }
 
+/* Scene arrays which are accessed for every traced ray or shader evaluation, and which are small
+ * enough to be duplicated for every NUMA node. Image textures are not replicated. */
+static bool numa_replicate_array(const char *name)
+{
+  static const char *replicated_names[] = {"bvh_nodes",
+                                           "bvh_leaf_nodes",
+                                           "prim_type",
+                                           "prim_visibility",
+                                           "prim_index",
+                                           "prim_object",
+                                           "object_node",
+                                           "objects",
+                                           "object_flag",
+                                           "tri_shader",
+                                           "tri_vindex",
+                                           "tri_verts",
+                                           "tri_vnormal",
+                                           "svm_nodes",
+                                           "shaders"};
+  for (const char *replicated_name : replicated_names) {
+    if (strcmp(name, replicated_name) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/* Copy data from within an arena bound to the NUMA node, so that the first touch of the freshly
+ * allocated pages happens from the threads of that node and places them in its local memory. */
+static void *numa_local_copy(tbb::task_arena &arena, const void *data, const size_t size)
+{
+  char *copy = (char *)util_aligned_malloc(size, MIN_ALIGNMENT_CPU_DATA_TYPES);
+  arena.execute([&]() {
+    parallel_for(blocked_range<size_t>(0, size, 64 * 1024), [&](const blocked_range<size_t> &r) {
+      memcpy(copy + r.begin(), (const char *)data + r.begin(), r.size());
+    });
+  });
+  return copy;
+}
+
+const CPUDevice::NUMAReplica &CPUDevice::numa_replica_get(const int numa_node)
+{
+  thread_scoped_lock lock(numa_replicas_mutex_);
+
+  unique_ptr<NUMAReplica> &replica = numa_replicas_[numa_node];
+  if (replica) {
+    return *replica;
+  }
+
+  replica = make_unique<NUMAReplica>();
+  replica->kernel_globals = kernel_globals;
+
+#ifdef WITH_TBB_NUMA
+  const tbb::task_arena::constraints arena_constraints(numa_node);
+  tbb::task_arena arena(arena_constraints);
+#else
+  tbb::task_arena arena;
+#endif
+
+#define KERNEL_DATA_ARRAY(type, name) \
+  if (kernel_globals.name.data && numa_replicate_array(#name)) { \
+    const size_t size = sizeof(type) * kernel_globals.name.width; \
+    void *copy = numa_local_copy(arena, kernel_globals.name.data, size); \
+    replica->kernel_globals.name.data = (type *)copy; \
+    replica->allocations.push_back(copy); \
+    replica->memory_size += size; \
+    replica->category_memory_size[device_memory_category(#name)] += size; \
+  }
+#include "kernel/data_arrays.h"
+
+  for (int i = 0; i < MEM_CATEGORY_NUM; i++) {
+    stats.mem_alloc(replica->category_memory_size[i], MemoryCategory(i));
+  }
+
+  VLOG_INFO << "Replicated " << string_human_readable_size(replica->memory_size)
+            << " of scene data on NUMA node " << numa_node << ".";
+
+  return *replica;
+}
+
+void CPUDevice::numa_replicas_free()
+{
+  thread_scoped_lock lock(numa_replicas_mutex_);
+
+  for (auto &it : numa_replicas_) {
+    for (void *allocation : it.second->allocations) {
+      util_aligned_free(allocation);
+    }
+    for (int i = 0; i < MEM_CATEGORY_NUM; i++) {
+      stats.mem_free(it.second->category_memory_size[i], MemoryCategory(i));
+    }
+  }
+  numa_replicas_.clear();
+}
+
+void CPUDevice::get_cpu_numa_kernel_thread_globals(
+    vector<CPUKernelThreadGlobals> &kernel_thread_globals,
+    const int numa_node,
+    const int num_threads)
+{
+  /* Ensure latest texture info is loaded into kernel globals before creating the replica. */
+  load_texture_info();
+
+  /* Start from the device-wide kernel globals so that the latest kernel data is used, and only
+   * point the replicated arrays to their node-local copies. */
+  KernelGlobalsCPU node_kernel_globals = kernel_globals;
+  const NUMAReplica &replica = numa_replica_get(numa_node);
+
+#define KERNEL_DATA_ARRAY(type, name) \
+  if (numa_replicate_array(#name)) { \
+    node_kernel_globals.name = replica.kernel_globals.name; \
+  }
+#include "kernel/data_arrays.h"
+
+  kernel_thread_globals.clear();
+  void *osl_memory = get_cpu_osl_memory();
+  for (int i = 0; i < num_threads; i++) {
+    kernel_thread_globals.emplace_back(node_kernel_globals, osl_memory, profiler);
+  }
+}
+
 void *CPUDevice::get_cpu_osl_memory()
 {
 #ifdef WITH_OSL
@@ -318,6 +444,17 @@ void *CPUDevice::get_cpu_osl_memory()
 #endif
 }
 
+int CPUDevice::set_cpu_svm_specialized_shaders(const vector<string> &shader_hashes)
+{
+  const int num_specialized = svm_specialized.update(
+      shader_hashes, get_cpu_kernels().svm_specialized_isa());
+
+  kernel_globals.svm_specialized = svm_specialized.data();
+  kernel_globals.svm_specialized_size = svm_specialized.size();
+
+  return num_specialized;
+}
+
 bool CPUDevice::load_kernels(const uint /*kernel_features*/)
 {
   return true;
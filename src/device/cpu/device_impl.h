@@ -15,6 +15,7 @@
 #endif
 
 #include "device/cpu/kernel.h"
+#include "device/cpu/svm_specialized.h"
 #include "device/device.h"
 #include "device/memory.h"
 
@@ -27,6 +28,8 @@
 // clang-format on
 
 #include "util/guiding.h"
+#include "util/map.h"
+#include "util/thread.h"
 #include "util/unique_ptr.h"
 
 CCL_NAMESPACE_BEGIN
@@ -41,6 +44,7 @@ class CPUDevice : public Device {
 #ifdef WITH_OSL
   OSLGlobals osl_globals;
 #endif
+  CPUSVMSpecializedShaders svm_specialized;
 #ifdef WITH_EMBREE
   RTCScene embree_scene = NULL;
   RTCDevice embree_device;
@@ -82,10 +86,32 @@ class CPUDevice : public Device {
 
   virtual void get_cpu_kernel_thread_globals(
       vector<CPUKernelThreadGlobals> &kernel_thread_globals) override;
+  virtual void get_cpu_numa_kernel_thread_globals(
+      vector<CPUKernelThreadGlobals> &kernel_thread_globals,
+      int numa_node,
+      int num_threads) override;
   virtual void *get_cpu_osl_memory() override;
+  virtual int set_cpu_svm_specialized_shaders(const vector<string> &shader_hashes) override;
 
  protected:
   virtual bool load_kernels(uint /*kernel_features*/) override;
+
+  /* Copies of the scene arrays which are accessed for every ray, local to a single NUMA node.
+   * Only the replicated arrays of the kernel globals point to the copies, the rest of the kernel
+   * globals is taken from the device-wide kernel globals when thread globals are created. */
+  struct NUMAReplica {
+    KernelGlobalsCPU kernel_globals;
+    vector<void *> allocations;
+    size_t memory_size = 0;
+    size_t category_memory_size[MEM_CATEGORY_NUM] = {0};
+  };
+
+  /* Get replica of the hot scene arrays for the given NUMA node, creating it if needed. */
+  const NUMAReplica &numa_replica_get(int numa_node);
+  void numa_replicas_free();
+
+  map<int, unique_ptr<NUMAReplica>> numa_replicas_;
+  thread_mutex numa_replicas_mutex_;
 };
 
 CCL_NAMESPACE_END
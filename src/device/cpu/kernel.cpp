@@ -36,10 +36,13 @@ CPUKernels::CPUKernels()
       REGISTER_KERNEL(shader_eval_curve_shadow_transparency),
       /* Adaptive sampling. */
       REGISTER_KERNEL(adaptive_sampling_convergence_check),
+      REGISTER_KERNEL(adaptive_sampling_convergence_check_block),
       REGISTER_KERNEL(adaptive_sampling_filter_x),
       REGISTER_KERNEL(adaptive_sampling_filter_y),
       /* Cryptomatte. */
       REGISTER_KERNEL(cryptomatte_postprocess),
+      /* Specialized shaders. */
+      REGISTER_KERNEL(svm_specialized_isa),
       /* Film Convert. */
       REGISTER_KERNEL_FILM_CONVERT(depth),
       REGISTER_KERNEL_FILM_CONVERT(mist),
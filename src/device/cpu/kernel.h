@@ -61,6 +61,18 @@ class CPUKernels {
                                  int offset,
                                  int stride)>;
 
+  using AdaptiveSamplingConvergenceCheckBlockFunction =
+      CPUKernelFunction<uint (*)(const KernelGlobalsCPU *kg,
+                                 ccl_global float *render_buffer,
+                                 int region_index,
+                                 int start_x,
+                                 int start_y,
+                                 int width,
+                                 int height,
+                                 float threshold,
+                                 int offset,
+                                 int stride)>;
+
   using AdaptiveSamplingFilterXFunction =
       CPUKernelFunction<void (*)(const KernelGlobalsCPU *kg,
                                  ccl_global float *render_buffer,
@@ -80,6 +92,7 @@ class CPUKernels {
                                  int stride)>;
 
   AdaptiveSamplingConvergenceCheckFunction adaptive_sampling_convergence_check;
+  AdaptiveSamplingConvergenceCheckBlockFunction adaptive_sampling_convergence_check_block;
 
   AdaptiveSamplingFilterXFunction adaptive_sampling_filter_x;
   AdaptiveSamplingFilterYFunction adaptive_sampling_filter_y;
@@ -91,6 +104,13 @@ class CPUKernels {
 
   CryptomattePostprocessFunction cryptomatte_postprocess;
 
+  /* Specialized shaders. */
+
+  /* Instruction set the kernel is compiled for, see kernel/svm/specialized.h. */
+  using SVMSpecializedISAFunction = CPUKernelFunction<int (*)()>;
+
+  SVMSpecializedISAFunction svm_specialized_isa;
+
   /* Film Convert. */
   using FilmConvertFunction = CPUKernelFunction<void (*)(const KernelFilmConvert *kfilm_convert,
                                                          const float *buffer,
@@ -0,0 +1,208 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#include "device/cpu/svm_specialized.h"
+
+// clang-format off
+#include "kernel/device/cpu/compat.h"
+#include "kernel/device/cpu/globals.h"
+
+#include "kernel/integrator/state.h"
+#include "kernel/svm/types.h"
+#include "kernel/svm/specialized.h"
+// clang-format on
+
+#include "util/log.h"
+#include "util/system.h"
+
+#ifdef _WIN32
+#  include "util/windows.h"
+#else
+#  include <dlfcn.h>
+#endif
+
+CCL_NAMESPACE_BEGIN
+
+typedef bool (*SVMSpecializedRegisterFunction)(int abi_version, SVMSpecializedShader *r_shader);
+
+namespace {
+
+class SVMSpecializedLibrary {
+ public:
+  SVMSpecializedLibrary()
+  {
+    const char *filepath = getenv("CYCLES_SVM_SPECIALIZED_LIBRARY");
+    if (filepath == nullptr || filepath[0] == '\0') {
+      return;
+    }
+
+#ifdef _WIN32
+    handle_ = (void *)LoadLibraryA(filepath);
+#else
+    handle_ = dlopen(filepath, RTLD_NOW | RTLD_LOCAL);
+#endif
+
+    if (handle_ == nullptr) {
+      LOG(ERROR) << "Failed to load specialized shader library " << filepath;
+      return;
+    }
+
+    const int *isa = (const int *)find_symbol("cycles_svm_specialized_isa");
+    if (isa == nullptr) {
+      LOG(ERROR) << "Specialized shader library " << filepath
+                 << " does not export its instruction set, regenerate and rebuild it.";
+      close();
+      return;
+    }
+    isa_ = *isa;
+
+    if (!cpu_supports_isa(isa_)) {
+      LOG(ERROR) << "Specialized shader library " << filepath
+                 << " is built for an instruction set this CPU does not support.";
+      close();
+      return;
+    }
+
+    VLOG_INFO << "Loaded specialized shader library " << filepath;
+  }
+
+  bool loaded() const
+  {
+    return handle_ != nullptr;
+  }
+
+  /* Instruction set the library is built for, see kernel/svm/specialized.h. */
+  int isa() const
+  {
+    return isa_;
+  }
+
+  SVMSpecializedRegisterFunction find(const string &hash) const
+  {
+    if (handle_ == nullptr) {
+      return nullptr;
+    }
+
+    return (SVMSpecializedRegisterFunction)find_symbol("cycles_svm_specialized_" + hash);
+  }
+
+  /* Once loaded the library is never unloaded, as kernels may still reference its functions. */
+
+ protected:
+  void *find_symbol(const string &symbol) const
+  {
+#ifdef _WIN32
+    return (void *)GetProcAddress((HMODULE)handle_, symbol.c_str());
+#else
+    return dlsym(handle_, symbol.c_str());
+#endif
+  }
+
+  void close()
+  {
+#ifdef _WIN32
+    FreeLibrary((HMODULE)handle_);
+#else
+    dlclose(handle_);
+#endif
+    handle_ = nullptr;
+  }
+
+  /* The instruction sets which are implied by the checked ones, SSE3 and SSSE3 by SSE4.1 and AVX
+   * by AVX2, only differ from the kernel in native builds, and are covered by comparing with the
+   * instruction set of the kernel. */
+  static bool cpu_supports_isa(const int isa)
+  {
+    if ((isa & SVM_SPECIALIZED_ISA_AVX2) && !system_cpu_support_avx2()) {
+      return false;
+    }
+    if ((isa & SVM_SPECIALIZED_ISA_SSE41) && !system_cpu_support_sse41()) {
+      return false;
+    }
+    if ((isa & SVM_SPECIALIZED_ISA_SSE2) && !system_cpu_support_sse2()) {
+      return false;
+    }
+    return true;
+  }
+
+  void *handle_ = nullptr;
+  int isa_ = 0;
+};
+
+const SVMSpecializedLibrary &svm_specialized_library()
+{
+  static SVMSpecializedLibrary library;
+  return library;
+}
+
+}  // namespace
+
+CPUSVMSpecializedShaders::CPUSVMSpecializedShaders()
+{
+}
+
+CPUSVMSpecializedShaders::~CPUSVMSpecializedShaders()
+{
+}
+
+bool CPUSVMSpecializedShaders::library_loaded()
+{
+  return svm_specialized_library().loaded();
+}
+
+int CPUSVMSpecializedShaders::update(const vector<string> &shader_hashes, const int kernel_isa)
+{
+  shaders_.clear();
+
+  const SVMSpecializedLibrary &library = svm_specialized_library();
+  if (!library.loaded()) {
+    return 0;
+  }
+
+  if (library.isa() != kernel_isa) {
+    LOG(WARNING) << "Specialized shader library is built for a different instruction set than "
+                    "the kernel, ignoring.";
+    return 0;
+  }
+
+  int num_found = 0;
+  shaders_.resize(shader_hashes.size(), {nullptr, nullptr});
+
+  for (size_t i = 0; i < shader_hashes.size(); i++) {
+    if (shader_hashes[i].empty()) {
+      continue;
+    }
+
+    SVMSpecializedRegisterFunction register_function = library.find(shader_hashes[i]);
+    if (register_function == nullptr) {
+      continue;
+    }
+
+    if (!register_function(svm_specialized_abi_version(), &shaders_[i])) {
+      LOG(WARNING) << "Specialized shader " << shader_hashes[i]
+                   << " was built for a different kernel, ignoring.";
+      shaders_[i] = {nullptr, nullptr};
+      continue;
+    }
+
+    num_found++;
+  }
+
+  if (num_found == 0) {
+    shaders_.clear();
+  }
+
+  return num_found;
+}
+
+const SVMSpecializedShader *CPUSVMSpecializedShaders::data() const
+{
+  return (shaders_.empty()) ? nullptr : shaders_.data();
+}
+
+int CPUSVMSpecializedShaders::size() const
+{
+  return shaders_.size();
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,41 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#pragma once
+
+#include "util/string.h"
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+struct SVMSpecializedShader;
+
+/* Specialized shader functions for the CPU kernel, see kernel/svm/specialized.h.
+ *
+ * Functions are loaded from the plugin library given by the CYCLES_SVM_SPECIALIZED_LIBRARY
+ * environment variable, which exports one function per shader named after the hash of its SVM
+ * nodes. The library is loaded once and shared by all devices.
+ *
+ * The library also exports the instruction set it was built for. It is not loaded when the CPU
+ * does not support that instruction set, and not used by kernels built for another one. */
+class CPUSVMSpecializedShaders {
+ public:
+  CPUSVMSpecializedShaders();
+  ~CPUSVMSpecializedShaders();
+
+  /* Look up functions for shaders by hash of their nodes, indexed by shader ID. An empty hash
+   * means the shader can not be specialized. The kernel ISA is the instruction set of the kernel
+   * which calls the functions. Returns the number of shaders found. */
+  int update(const vector<string> &shader_hashes, const int kernel_isa);
+
+  const SVMSpecializedShader *data() const;
+  int size() const;
+
+  /* Test if a plugin library was loaded successfully. */
+  static bool library_loaded();
+
+ protected:
+  vector<SVMSpecializedShader> shaders_;
+};
+
+CCL_NAMESPACE_END
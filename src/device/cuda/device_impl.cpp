@@ -793,7 +793,7 @@ void CUDADevice::tex_alloc(device_texture &mem)
 
     mem.device_pointer = (device_ptr)array_3d;
     mem.device_size = size;
-    stats.mem_alloc(size);
+    stats.mem_alloc(size, mem.category());
 
     thread_scoped_lock lock(device_mem_map_mutex);
     cmem = &device_mem_map[&mem];
@@ -914,7 +914,7 @@ void CUDADevice::tex_free(device_texture &mem)
     else if (cmem.array) {
       /* Free array. */
       cuArrayDestroy(reinterpret_cast<CUarray>(cmem.array));
-      stats.mem_free(mem.device_size);
+      stats.mem_free(mem.device_size, mem.category());
       mem.device_pointer = 0;
       mem.device_size = 0;
 
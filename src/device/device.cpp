@@ -415,6 +415,8 @@ DeviceInfo Device::get_multi_device(const vector<DeviceInfo> &subdevices,
   info.has_osl = true;
   info.has_guiding = true;
   info.has_profiling = true;
+  info.has_texture_compression = true;
+  info.has_texture_sharing = true;
   info.has_peer_memory = false;
   info.use_metalrt = false;
   info.denoisers = DENOISER_ALL;
@@ -464,6 +466,8 @@ DeviceInfo Device::get_multi_device(const vector<DeviceInfo> &subdevices,
     info.has_osl &= device.has_osl;
     info.has_guiding &= device.has_guiding;
     info.has_profiling &= device.has_profiling;
+    info.has_texture_compression &= device.has_texture_compression;
+    info.has_texture_sharing &= device.has_texture_sharing;
     info.has_peer_memory |= device.has_peer_memory;
     info.use_metalrt |= device.use_metalrt;
     info.denoisers &= device.denoisers;
@@ -507,6 +511,14 @@ void Device::get_cpu_kernel_thread_globals(
   LOG(FATAL) << "Device does not support CPU kernels.";
 }
 
+void Device::get_cpu_numa_kernel_thread_globals(
+    vector<CPUKernelThreadGlobals> & /*kernel_thread_globals*/,
+    int /*numa_node*/,
+    int /*num_threads*/)
+{
+  LOG(FATAL) << "Device does not support CPU kernels.";
+}
+
 void *Device::get_cpu_osl_memory()
 {
   return nullptr;
@@ -733,7 +745,7 @@ GPUDevice::Mem *GPUDevice::generic_alloc(device_memory &mem, size_t pitch_paddin
 
   mem.device_pointer = (device_ptr)device_pointer;
   mem.device_size = size;
-  stats.mem_alloc(size);
+  stats.mem_alloc(size, mem.category());
 
   if (!mem.device_pointer) {
     return NULL;
@@ -803,7 +815,7 @@ void GPUDevice::generic_free(device_memory &mem)
       device_mem_in_use -= mem.device_size;
     }
 
-    stats.mem_free(mem.device_size);
+    stats.mem_free(mem.device_size, mem.category());
     mem.device_pointer = 0;
     mem.device_size = 0;
 
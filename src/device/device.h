@@ -83,6 +83,10 @@ class DeviceInfo {
   KernelOptimizationLevel kernel_optimization_level; /* Optimization level applied to path tracing
                                                         kernels (Metal only). */
   DenoiserTypeMask denoisers;                        /* Supported denoiser types. */
+  /* Support storing textures as half or block compressed, see util/texture_compress.h. */
+  bool has_texture_compression;
+  /* Textures with identical pixels can share host memory, which the device reads directly. */
+  bool has_texture_sharing;
   int cpu_threads;
   vector<DeviceInfo> multi_devices;
   string error_msg;
@@ -101,6 +105,8 @@ class DeviceInfo {
     has_profiling = false;
     has_peer_memory = false;
     has_gpu_queue = false;
+    has_texture_compression = false;
+    has_texture_sharing = false;
     use_metalrt = false;
     denoisers = DENOISER_NONE;
   }
@@ -213,8 +219,20 @@ class Device {
   /* Get kernel globals to pass to kernels. */
   virtual void get_cpu_kernel_thread_globals(
       vector<CPUKernelThreadGlobals> & /*kernel_thread_globals*/);
+  /* Get kernel globals for threads running on the given NUMA node. Frequently accessed scene
+   * arrays are replaced with copies which reside in the memory of that node. */
+  virtual void get_cpu_numa_kernel_thread_globals(
+      vector<CPUKernelThreadGlobals> & /*kernel_thread_globals*/,
+      int /*numa_node*/,
+      int /*num_threads*/);
   /* Get OpenShadingLanguage memory buffer. */
   virtual void *get_cpu_osl_memory();
+  /* Use specialized shader functions for shaders with the given hash of their SVM nodes, indexed
+   * by shader ID. Returns the number of shaders which are specialized. */
+  virtual int set_cpu_svm_specialized_shaders(const vector<string> & /*shader_hashes*/)
+  {
+    return 0;
+  }
 
   /* acceleration structure building */
   virtual void build_bvh(BVH *bvh, Progress &progress, bool refit);
@@ -37,6 +37,71 @@ device_memory::~device_memory()
   assert(shared_counter == 0);
 }
 
+static bool memory_name_has_prefix(const char *name, const char *prefix)
+{
+  return strncmp(name, prefix, strlen(prefix)) == 0;
+}
+
+MemoryCategory device_memory_category(const char *name)
+{
+  if (name == nullptr) {
+    return MEM_CATEGORY_OTHER;
+  }
+
+  /* Names of the arrays in DeviceScene and of the device specific acceleration structures. */
+  static const struct {
+    const char *prefix;
+    MemoryCategory category;
+  } prefixes[] = {
+      {"bvh_", MEM_CATEGORY_BVH},
+      {"object_node", MEM_CATEGORY_BVH},
+      {"prim_", MEM_CATEGORY_BVH},
+      {"optix", MEM_CATEGORY_BVH},
+      {"tri_", MEM_CATEGORY_GEOMETRY},
+      {"curve", MEM_CATEGORY_GEOMETRY},
+      {"patches", MEM_CATEGORY_GEOMETRY},
+      {"points", MEM_CATEGORY_GEOMETRY},
+      {"attributes_", MEM_CATEGORY_ATTRIBUTES},
+      {"object_lookup_offset", MEM_CATEGORY_LIGHTS},
+      {"object", MEM_CATEGORY_OBJECTS},
+      {"camera_motion", MEM_CATEGORY_OBJECTS},
+      {"particles", MEM_CATEGORY_OBJECTS},
+      {"volume_occupancy", MEM_CATEGORY_OBJECTS},
+      {"light", MEM_CATEGORY_LIGHTS},
+      {"triangle_to_tree", MEM_CATEGORY_LIGHTS},
+      {"ies", MEM_CATEGORY_LIGHTS},
+      {"svm_nodes", MEM_CATEGORY_SHADERS},
+      {"shaders", MEM_CATEGORY_SHADERS},
+      {"lookup_table", MEM_CATEGORY_SHADERS},
+      {"rhino_noise_perm", MEM_CATEGORY_SHADERS},
+      {"tex_image_", MEM_CATEGORY_TEXTURES},
+      {"RenderBuffers", MEM_CATEGORY_RENDER_BUFFERS},
+      {"display buffer", MEM_CATEGORY_RENDER_BUFFERS},
+      {"denoiser", MEM_CATEGORY_RENDER_BUFFERS},
+      {"integrator_", MEM_CATEGORY_INTEGRATOR_STATE},
+      {"queued_paths", MEM_CATEGORY_INTEGRATOR_STATE},
+      {"num_queued_paths", MEM_CATEGORY_INTEGRATOR_STATE},
+      {"work_tiles", MEM_CATEGORY_INTEGRATOR_STATE},
+  };
+
+  for (const auto &entry : prefixes) {
+    if (memory_name_has_prefix(name, entry.prefix)) {
+      return entry.category;
+    }
+  }
+
+  return MEM_CATEGORY_OTHER;
+}
+
+MemoryCategory device_memory::category() const
+{
+  if (type == MEM_TEXTURE) {
+    return MEM_CATEGORY_TEXTURES;
+  }
+
+  return device_memory_category(name);
+}
+
 void *device_memory::host_alloc(size_t size)
 {
   if (!size) {
@@ -147,7 +212,7 @@ device_texture::device_texture(Device *device,
                                ImageDataType image_data_type,
                                InterpolationType interpolation,
                                ExtensionType extension)
-    : device_memory(device, name, MEM_TEXTURE), slot(slot)
+    : device_memory(device, name, MEM_TEXTURE), slot(slot), host_memory_shared(false)
 {
   switch (image_data_type) {
     case IMAGE_DATA_TYPE_FLOAT4:
@@ -186,6 +251,18 @@ device_texture::device_texture(Device *device,
       data_type = TYPE_UINT16;
       data_elements = 1;
       break;
+    case IMAGE_DATA_TYPE_BC1:
+      data_type = TYPE_UCHAR;
+      data_elements = sizeof(TextureBlockBC1);
+      break;
+    case IMAGE_DATA_TYPE_BC3:
+      data_type = TYPE_UCHAR;
+      data_elements = sizeof(TextureBlockBC3);
+      break;
+    case IMAGE_DATA_TYPE_BC4:
+      data_type = TYPE_UCHAR;
+      data_elements = sizeof(TextureBlockBC4);
+      break;
     case IMAGE_DATA_NUM_TYPES:
       assert(0);
       return;
@@ -200,6 +277,9 @@ device_texture::device_texture(Device *device,
 device_texture::~device_texture()
 {
   device_free();
+  if (host_memory_shared) {
+    host_pointer = 0;
+  }
   host_free();
 }
 
@@ -208,6 +288,13 @@ void *device_texture::alloc(const size_t width, const size_t height, const size_
 {
   const size_t new_size = size(width, height, depth);
 
+  if (host_memory_shared) {
+    device_free();
+    host_pointer = 0;
+    data_size = 0;
+    host_memory_shared = false;
+  }
+
   if (new_size != data_size) {
     device_free();
     host_free();
@@ -232,4 +319,27 @@ void device_texture::copy_to_device()
   device_copy_to();
 }
 
+void device_texture::share_host_memory(const device_texture &other)
+{
+  assert(other.type == MEM_TEXTURE && other.data_type == data_type &&
+         other.data_elements == data_elements);
+
+  device_free();
+  if (!host_memory_shared) {
+    host_free();
+  }
+
+  host_pointer = other.host_pointer;
+  host_memory_shared = true;
+
+  data_size = other.data_size;
+  data_width = other.data_width;
+  data_height = other.data_height;
+  data_depth = other.data_depth;
+
+  info.width = other.info.width;
+  info.height = other.info.height;
+  info.depth = other.info.depth;
+}
+
 CCL_NAMESPACE_END
@@ -10,8 +10,10 @@
 
 #include "util/array.h"
 #include "util/half.h"
+#include "util/stats.h"
 #include "util/string.h"
 #include "util/texture.h"
+#include "util/texture_compress.h"
 #include "util/types.h"
 #include "util/vector.h"
 
@@ -204,6 +206,9 @@ template<> struct device_type_traits<uint64_t> {
   static_assert(sizeof(uint64_t) == num_elements * datatype_size(data_type));
 };
 
+/* Subsystem that memory with the given array name is accounted to in the device statistics. */
+MemoryCategory device_memory_category(const char *name);
+
 /* Device Memory
  *
  * Base class for all device memory. This should not be allocated directly,
@@ -246,6 +251,9 @@ class device_memory {
 
   bool is_resident(Device *sub_device) const;
 
+  /* Subsystem the memory is accounted to in the device statistics, derived from the name. */
+  MemoryCategory category() const;
+
  protected:
   friend class Device;
   friend class GPUDevice;
@@ -609,12 +617,26 @@ class device_texture : public device_memory {
   void *alloc(const size_t width, const size_t height, const size_t depth = 0);
   void copy_to_device();
 
+  /* Use the host memory of another texture with identical pixels instead of own memory. The other
+   * texture must outlive this one, only slot, interpolation and extension differ. */
+  void share_host_memory(const device_texture &other);
+  bool is_host_memory_shared() const
+  {
+    return host_memory_shared;
+  }
+
   uint slot;
   TextureInfo info;
 
  protected:
+  bool host_memory_shared;
+
   size_t size(const size_t width, const size_t height, const size_t depth)
   {
+    if (texture_is_block_compressed(info.data_type)) {
+      /* 2D only, with one element per block of 4x4 pixels. */
+      return texture_block_count(width, (height == 0) ? 1 : height);
+    }
     return width * ((height == 0) ? 1 : height) * ((depth == 0) ? 1 : depth);
   }
 };
@@ -34,7 +34,7 @@ BVHMetal::~BVHMetal()
 {
   if (@available(macos 12.0, *)) {
     if (accel_struct) {
-      stats.mem_free(accel_struct.allocatedSize);
+      stats.mem_free(accel_struct.allocatedSize, MEM_CATEGORY_BVH);
       [accel_struct release];
     }
   }
@@ -221,7 +221,7 @@ bool BVHMetal::build_BLAS_mesh(Progress &progress,
           [accelEnc endEncoding];
           [accelCommands addCompletedHandler:^(id<MTLCommandBuffer> command_buffer) {
             uint64_t allocated_size = [accel allocatedSize];
-            stats.mem_alloc(allocated_size);
+            stats.mem_alloc(allocated_size, MEM_CATEGORY_BVH);
             accel_struct = accel;
             [accel_uncompressed release];
             accel_struct_building = false;
@@ -234,7 +234,7 @@ bool BVHMetal::build_BLAS_mesh(Progress &progress,
         accel_struct = accel_uncompressed;
 
         uint64_t allocated_size = [accel_struct allocatedSize];
-        stats.mem_alloc(allocated_size);
+        stats.mem_alloc(allocated_size, MEM_CATEGORY_BVH);
         accel_struct_building = false;
       }
       [sizeBuf release];
@@ -439,7 +439,7 @@ bool BVHMetal::build_BLAS_hair(Progress &progress,
           [accelEnc endEncoding];
           [accelCommands addCompletedHandler:^(id<MTLCommandBuffer> command_buffer) {
             uint64_t allocated_size = [accel allocatedSize];
-            stats.mem_alloc(allocated_size);
+            stats.mem_alloc(allocated_size, MEM_CATEGORY_BVH);
             accel_struct = accel;
             [accel_uncompressed release];
             accel_struct_building = false;
@@ -452,7 +452,7 @@ bool BVHMetal::build_BLAS_hair(Progress &progress,
         accel_struct = accel_uncompressed;
 
         uint64_t allocated_size = [accel_struct allocatedSize];
-        stats.mem_alloc(allocated_size);
+        stats.mem_alloc(allocated_size, MEM_CATEGORY_BVH);
         accel_struct_building = false;
       }
       [sizeBuf release];
@@ -653,7 +653,7 @@ bool BVHMetal::build_BLAS_pointcloud(Progress &progress,
           [accelEnc endEncoding];
           [accelCommands addCompletedHandler:^(id<MTLCommandBuffer> command_buffer) {
             uint64_t allocated_size = [accel allocatedSize];
-            stats.mem_alloc(allocated_size);
+            stats.mem_alloc(allocated_size, MEM_CATEGORY_BVH);
             accel_struct = accel;
             [accel_uncompressed release];
             accel_struct_building = false;
@@ -666,7 +666,7 @@ bool BVHMetal::build_BLAS_pointcloud(Progress &progress,
         accel_struct = accel_uncompressed;
 
         uint64_t allocated_size = [accel_struct allocatedSize];
-        stats.mem_alloc(allocated_size);
+        stats.mem_alloc(allocated_size, MEM_CATEGORY_BVH);
         accel_struct_building = false;
       }
       [sizeBuf release];
@@ -985,7 +985,7 @@ bool BVHMetal::build_TLAS(Progress &progress,
     [scratchBuf release];
 
     uint64_t allocated_size = [accel allocatedSize];
-    stats.mem_alloc(allocated_size);
+    stats.mem_alloc(allocated_size, MEM_CATEGORY_BVH);
 
     /* Cache top and bottom-level acceleration structs */
     accel_struct = accel;
@@ -1011,7 +1011,7 @@ bool BVHMetal::build(Progress &progress,
     }
     else {
       if (accel_struct) {
-        stats.mem_free(accel_struct.allocatedSize);
+        stats.mem_free(accel_struct.allocatedSize, MEM_CATEGORY_BVH);
         [accel_struct release];
         accel_struct = nil;
       }
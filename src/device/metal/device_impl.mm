@@ -94,7 +94,8 @@ MetalDevice::MetalDevice(const DeviceInfo &info, Stats &stats, Profiler &profile
   texture_bindings_2d = [mtlDevice newBufferWithLength:4096 options:default_storage_mode];
   texture_bindings_3d = [mtlDevice newBufferWithLength:4096 options:default_storage_mode];
 
-  stats.mem_alloc(texture_bindings_2d.allocatedSize + texture_bindings_3d.allocatedSize);
+  stats.mem_alloc(texture_bindings_2d.allocatedSize + texture_bindings_3d.allocatedSize,
+                  MEM_CATEGORY_TEXTURES);
 
   switch (device_vendor) {
     default:
@@ -262,7 +263,8 @@ MetalDevice::~MetalDevice()
   flush_delayed_free_list();
 
   if (texture_bindings_2d) {
-    stats.mem_free(texture_bindings_2d.allocatedSize + texture_bindings_3d.allocatedSize);
+    stats.mem_free(texture_bindings_2d.allocatedSize + texture_bindings_3d.allocatedSize,
+                   MEM_CATEGORY_TEXTURES);
 
     [texture_bindings_2d release];
     [texture_bindings_3d release];
@@ -628,7 +630,7 @@ void MetalDevice::load_texture_info()
 
 void MetalDevice::erase_allocation(device_memory &mem)
 {
-  stats.mem_free(mem.device_size);
+  stats.mem_free(mem.device_size, mem.category());
   mem.device_pointer = 0;
   mem.device_size = 0;
 
@@ -688,7 +690,7 @@ MetalDevice::MetalMem *MetalDevice::generic_alloc(device_memory &mem)
   }
 
   mem.device_size = metal_buffer.allocatedSize;
-  stats.mem_alloc(mem.device_size);
+  stats.mem_alloc(mem.device_size, mem.category());
 
   metal_buffer.label = [[NSString alloc] initWithFormat:@"%s", mem.name];
 
@@ -1216,7 +1218,7 @@ void MetalDevice::tex_alloc(device_texture &mem)
 
   mem.device_pointer = (device_ptr)mtlTexture;
   mem.device_size = size;
-  stats.mem_alloc(size);
+  stats.mem_alloc(size, mem.category());
 
   std::lock_guard<std::recursive_mutex> lock(metal_mem_map_mutex);
   MetalMem *mmem = new MetalMem;
@@ -1238,14 +1240,16 @@ void MetalDevice::tex_alloc(device_texture &mem)
         delayed_free_list.push_back(texture_bindings_2d);
         delayed_free_list.push_back(texture_bindings_3d);
 
-        stats.mem_free(texture_bindings_2d.allocatedSize + texture_bindings_3d.allocatedSize);
+        stats.mem_free(texture_bindings_2d.allocatedSize + texture_bindings_3d.allocatedSize,
+                       MEM_CATEGORY_TEXTURES);
       }
       texture_bindings_2d = [mtlDevice newBufferWithLength:min_buffer_length
                                                    options:default_storage_mode];
       texture_bindings_3d = [mtlDevice newBufferWithLength:min_buffer_length
                                                    options:default_storage_mode];
 
-      stats.mem_alloc(texture_bindings_2d.allocatedSize + texture_bindings_3d.allocatedSize);
+      stats.mem_alloc(texture_bindings_2d.allocatedSize + texture_bindings_3d.allocatedSize,
+                      MEM_CATEGORY_TEXTURES);
     }
   }
 
@@ -1330,7 +1334,7 @@ void MetalDevice::build_bvh(BVH *bvh, Progress &progress, bool refit)
         uint64_t count = bvhMetalRT->blas_array.size();
         uint64_t bufferSize = mtlBlasArgEncoder.encodedLength * count;
         blas_buffer = [mtlDevice newBufferWithLength:bufferSize options:default_storage_mode];
-        stats.mem_alloc(blas_buffer.allocatedSize);
+        stats.mem_alloc(blas_buffer.allocatedSize, MEM_CATEGORY_BVH);
 
         for (uint64_t i = 0; i < count; ++i) {
           [mtlBlasArgEncoder setArgumentBuffer:blas_buffer
@@ -1342,7 +1346,7 @@ void MetalDevice::build_bvh(BVH *bvh, Progress &progress, bool refit)
         bufferSize = sizeof(uint32_t) * count;
         blas_lookup_buffer = [mtlDevice newBufferWithLength:bufferSize
                                                     options:default_storage_mode];
-        stats.mem_alloc(blas_lookup_buffer.allocatedSize);
+        stats.mem_alloc(blas_lookup_buffer.allocatedSize, MEM_CATEGORY_BVH);
 
         memcpy([blas_lookup_buffer contents],
                bvhMetalRT -> blas_lookup.data(),
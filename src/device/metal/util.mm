@@ -202,7 +202,8 @@ id<MTLBuffer> MetalBufferPool::get_buffer(id<MTLDevice> device,
 
   MetalBufferListEntry buffer_entry(buffer, command_buffer);
 
-  stats.mem_alloc(buffer.allocatedSize);
+  /* Temporary buffers for kernel arguments and copies of the device queue. */
+  stats.mem_alloc(buffer.allocatedSize, MEM_CATEGORY_INTEGRATOR_STATE);
 
   total_temp_mem_size += buffer.allocatedSize;
   buffer_in_use_list.push_back(buffer_entry);
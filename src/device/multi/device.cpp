@@ -221,6 +221,16 @@ class MultiDevice : public Device {
     return devices.back().device->get_cpu_osl_memory();
   }
 
+  int set_cpu_svm_specialized_shaders(const vector<string> &shader_hashes) override
+  {
+    int num_specialized = 0;
+    foreach (SubDevice &sub, devices) {
+      num_specialized = max(num_specialized,
+                            sub.device->set_cpu_svm_specialized_shaders(shader_hashes));
+    }
+    return num_specialized;
+  }
+
   bool is_resident(device_ptr key, Device *sub_device) override
   {
     foreach (SubDevice &sub, devices) {
@@ -286,7 +296,7 @@ class MultiDevice : public Device {
 
     mem.device = this;
     mem.device_pointer = key;
-    stats.mem_alloc(mem.device_size);
+    stats.mem_alloc(mem.device_size, mem.category());
   }
 
   void mem_copy_to(device_memory &mem) override
@@ -317,7 +327,7 @@ class MultiDevice : public Device {
 
     mem.device = this;
     mem.device_pointer = key;
-    stats.mem_alloc(mem.device_size - existing_size);
+    stats.mem_alloc(mem.device_size - existing_size, mem.category());
   }
 
   void mem_copy_from(device_memory &mem, size_t y, size_t w, size_t h, size_t elem) override
@@ -359,7 +369,7 @@ class MultiDevice : public Device {
 
     mem.device = this;
     mem.device_pointer = key;
-    stats.mem_alloc(mem.device_size - existing_size);
+    stats.mem_alloc(mem.device_size - existing_size, mem.category());
   }
 
   void mem_free(device_memory &mem) override
@@ -390,7 +400,7 @@ class MultiDevice : public Device {
     mem.device = this;
     mem.device_pointer = 0;
     mem.device_size = 0;
-    stats.mem_free(existing_size);
+    stats.mem_free(existing_size, mem.category());
   }
 
   void const_copy_to(const char *name, void *host, size_t size) override
@@ -0,0 +1,581 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#include "graph/node_binary.h"
+
+#include "util/foreach.h"
+#include "util/path.h"
+#include "util/transform.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* --------------------------------------------------------------------
+ * File header.
+ */
+
+static const char BINARY_MAGIC[8] = {'C', 'Y', 'C', 'L', 'E', 'S', 'B', 'N'};
+static const uint BINARY_VERSION = 1;
+
+/* Sizes of the types which are stored raw, to detect files written by an incompatible build. */
+static uint binary_layout_signature()
+{
+  return (uint)(sizeof(float3) | (sizeof(float2) << 8) | (sizeof(Transform) << 16) |
+                (sizeof(bool) << 24));
+}
+
+/* --------------------------------------------------------------------
+ * Writer.
+ */
+
+BinaryWriter::BinaryWriter()
+{
+}
+
+BinaryWriter::~BinaryWriter()
+{
+  close();
+}
+
+bool BinaryWriter::open(const string &filepath)
+{
+  close();
+
+  file_ = path_fopen(filepath, "wb");
+  if (!file_) {
+    return false;
+  }
+
+  offset_ = 0;
+  error_ = false;
+  node_map.clear();
+
+  write_data(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+  write_uint(BINARY_VERSION);
+  write_uint(binary_layout_signature());
+
+  return !error_;
+}
+
+bool BinaryWriter::close()
+{
+  if (!file_) {
+    return false;
+  }
+
+  if (fclose(file_) != 0) {
+    error_ = true;
+  }
+  file_ = nullptr;
+
+  return !error_;
+}
+
+void BinaryWriter::write_data(const void *data, const size_t size)
+{
+  if (size == 0 || error_) {
+    return;
+  }
+  if (fwrite(data, 1, size, file_) != size) {
+    error_ = true;
+    return;
+  }
+  offset_ += size;
+}
+
+void BinaryWriter::write_uint(const uint value)
+{
+  write_data(&value, sizeof(value));
+}
+
+void BinaryWriter::write_uint64(const uint64_t value)
+{
+  write_data(&value, sizeof(value));
+}
+
+void BinaryWriter::write_string(const string &value)
+{
+  write_uint(value.size());
+  write_data(value.data(), value.size());
+}
+
+void BinaryWriter::write_array(const void *data, const size_t num, const size_t element_size)
+{
+  write_uint64(num);
+
+  const size_t padding = align_up(offset_, BINARY_ARRAY_ALIGNMENT) - offset_;
+  if (padding) {
+    const uint8_t zeros[BINARY_ARRAY_ALIGNMENT] = {0};
+    write_data(zeros, padding);
+  }
+
+  write_data(data, num * element_size);
+}
+
+/* --------------------------------------------------------------------
+ * Reader.
+ */
+
+bool BinaryReader::open(const string &filepath)
+{
+  close();
+
+  if (!file_.open(filepath)) {
+    return false;
+  }
+
+  char magic[sizeof(BINARY_MAGIC)];
+  read_data(magic, sizeof(magic));
+  const uint version = read_uint();
+  const uint layout_signature = read_uint();
+
+  if (error_ || memcmp(magic, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0) {
+    fprintf(stderr, "%s is not a Cycles binary file.\n", filepath.c_str());
+    close();
+    return false;
+  }
+  if (version != BINARY_VERSION || layout_signature != binary_layout_signature()) {
+    fprintf(stderr,
+            "%s was written by an incompatible version of Cycles (version %u).\n",
+            filepath.c_str(),
+            version);
+    close();
+    return false;
+  }
+
+  return true;
+}
+
+void BinaryReader::close()
+{
+  file_.close();
+  pos_ = 0;
+  error_ = false;
+  nodes.clear();
+}
+
+void BinaryReader::read_data(void *data, const size_t size)
+{
+  if (error_ || size > file_.size() - pos_) {
+    error_ = true;
+    memset(data, 0, size);
+    return;
+  }
+  memcpy(data, file_.data() + pos_, size);
+  pos_ += size;
+}
+
+uint BinaryReader::read_uint()
+{
+  uint value;
+  read_data(&value, sizeof(value));
+  return value;
+}
+
+uint64_t BinaryReader::read_uint64()
+{
+  uint64_t value;
+  read_data(&value, sizeof(value));
+  return value;
+}
+
+string BinaryReader::read_string()
+{
+  const uint size = read_uint();
+  if (error_ || size > file_.size() - pos_) {
+    error_ = true;
+    return string();
+  }
+  string value((const char *)file_.data() + pos_, size);
+  pos_ += size;
+  return value;
+}
+
+const void *BinaryReader::read_array(size_t &num, const size_t element_size)
+{
+  num = read_uint64();
+
+  const size_t begin = align_up(pos_, BINARY_ARRAY_ALIGNMENT);
+  if (error_ || begin > file_.size() ||
+      (element_size && num > (file_.size() - begin) / element_size)) {
+    error_ = true;
+    num = 0;
+    return nullptr;
+  }
+
+  pos_ = begin + num * element_size;
+  return file_.data() + begin;
+}
+
+/* --------------------------------------------------------------------
+ * Nodes.
+ */
+
+static bool binary_socket_is_stored(const SocketType &socket)
+{
+  if (socket.type == SocketType::CLOSURE || socket.type == SocketType::UNDEFINED ||
+      socket.type == SocketType::COLOR2) {
+    return false;
+  }
+  if (socket.flags & SocketType::INTERNAL) {
+    return false;
+  }
+  return true;
+}
+
+template<typename T> static void binary_write_array(BinaryWriter &writer, const array<T> &value)
+{
+  writer.write_array(value.data(), value.size(), sizeof(T));
+}
+
+template<typename T> static void binary_read_array(BinaryReader &reader, array<T> &value)
+{
+  size_t num;
+  const void *data = reader.read_array(num, sizeof(T));
+  value.resize(num);
+  if (num) {
+    memcpy(value.data(), data, num * sizeof(T));
+  }
+}
+
+static uint binary_node_index(BinaryWriter &writer, const Node *node)
+{
+  /* Zero is used for no node, or for a node which has not been written. */
+  if (node == nullptr) {
+    return 0;
+  }
+  auto it = writer.node_map.find(node);
+  return (it != writer.node_map.end()) ? it->second + 1 : 0;
+}
+
+static Node *binary_node_from_index(BinaryReader &reader,
+                                    const uint index,
+                                    const NodeType *node_type)
+{
+  if (index == 0 || index > reader.nodes.size()) {
+    return nullptr;
+  }
+  Node *node = reader.nodes[index - 1];
+  return (node && node->is_a(node_type)) ? node : nullptr;
+}
+
+void binary_write_node(BinaryWriter &writer, const Node *node)
+{
+  vector<const SocketType *> sockets;
+  foreach (const SocketType &socket, node->type->inputs) {
+    if (binary_socket_is_stored(socket) && !node->has_default_value(socket)) {
+      sockets.push_back(&socket);
+    }
+  }
+
+  writer.write_string(node->name.string());
+  writer.write_uint(sockets.size());
+
+  foreach (const SocketType *socket_ptr, sockets) {
+    const SocketType &socket = *socket_ptr;
+
+    writer.write_string(socket.name.string());
+    writer.write_uint(socket.type);
+
+    switch (socket.type) {
+      case SocketType::BOOLEAN:
+        writer.write_uint(node->get_bool(socket));
+        break;
+      case SocketType::FLOAT: {
+        const float value = node->get_float(socket);
+        writer.write_data(&value, sizeof(value));
+        break;
+      }
+      case SocketType::INT: {
+        const int value = node->get_int(socket);
+        writer.write_data(&value, sizeof(value));
+        break;
+      }
+      case SocketType::UINT:
+        writer.write_uint(node->get_uint(socket));
+        break;
+      case SocketType::COLOR:
+      case SocketType::VECTOR:
+      case SocketType::POINT:
+      case SocketType::NORMAL: {
+        const float3 value = node->get_float3(socket);
+        const float values[3] = {value.x, value.y, value.z};
+        writer.write_data(values, sizeof(values));
+        break;
+      }
+      case SocketType::POINT2: {
+        const float2 value = node->get_float2(socket);
+        writer.write_data(&value, sizeof(value));
+        break;
+      }
+      case SocketType::STRING:
+      case SocketType::ENUM:
+        writer.write_string(node->get_string(socket).string());
+        break;
+      case SocketType::TRANSFORM: {
+        const Transform value = node->get_transform(socket);
+        writer.write_data(&value, sizeof(value));
+        break;
+      }
+      case SocketType::NODE:
+        writer.write_uint(binary_node_index(writer, node->get_node(socket)));
+        break;
+      case SocketType::BOOLEAN_ARRAY:
+        binary_write_array(writer, node->get_bool_array(socket));
+        break;
+      case SocketType::FLOAT_ARRAY:
+        binary_write_array(writer, node->get_float_array(socket));
+        break;
+      case SocketType::INT_ARRAY:
+        binary_write_array(writer, node->get_int_array(socket));
+        break;
+      case SocketType::COLOR_ARRAY:
+      case SocketType::VECTOR_ARRAY:
+      case SocketType::POINT_ARRAY:
+      case SocketType::NORMAL_ARRAY:
+        binary_write_array(writer, node->get_float3_array(socket));
+        break;
+      case SocketType::POINT2_ARRAY:
+        binary_write_array(writer, node->get_float2_array(socket));
+        break;
+      case SocketType::TRANSFORM_ARRAY:
+        binary_write_array(writer, node->get_transform_array(socket));
+        break;
+      case SocketType::STRING_ARRAY: {
+        const array<ustring> &value = node->get_string_array(socket);
+        writer.write_uint(value.size());
+        for (size_t i = 0; i < value.size(); i++) {
+          writer.write_string(value[i].string());
+        }
+        break;
+      }
+      case SocketType::NODE_ARRAY: {
+        const array<Node *> &value = node->get_node_array(socket);
+        array<uint> indices(value.size());
+        for (size_t i = 0; i < value.size(); i++) {
+          indices[i] = binary_node_index(writer, value[i]);
+        }
+        binary_write_array(writer, indices);
+        break;
+      }
+      case SocketType::COLOR2:
+      case SocketType::CLOSURE:
+      case SocketType::UNDEFINED:
+        break;
+    }
+  }
+
+  const uint index = writer.node_map.size();
+  writer.node_map[node] = index;
+}
+
+/* Read value of a socket of the given type. When the node is null the value is skipped. */
+static bool binary_read_value(BinaryReader &reader,
+                              const SocketType::Type type,
+                              Node *node,
+                              const SocketType *socket)
+{
+  switch (type) {
+    case SocketType::BOOLEAN: {
+      const bool value = reader.read_uint() != 0;
+      if (node) {
+        node->set(*socket, value);
+      }
+      break;
+    }
+    case SocketType::FLOAT: {
+      float value;
+      reader.read_data(&value, sizeof(value));
+      if (node) {
+        node->set(*socket, value);
+      }
+      break;
+    }
+    case SocketType::INT: {
+      int value;
+      reader.read_data(&value, sizeof(value));
+      if (node) {
+        node->set(*socket, value);
+      }
+      break;
+    }
+    case SocketType::UINT: {
+      const uint value = reader.read_uint();
+      if (node) {
+        node->set(*socket, value);
+      }
+      break;
+    }
+    case SocketType::COLOR:
+    case SocketType::VECTOR:
+    case SocketType::POINT:
+    case SocketType::NORMAL: {
+      float values[3];
+      reader.read_data(values, sizeof(values));
+      if (node) {
+        node->set(*socket, make_float3(values[0], values[1], values[2]));
+      }
+      break;
+    }
+    case SocketType::POINT2: {
+      float2 value;
+      reader.read_data(&value, sizeof(value));
+      if (node) {
+        node->set(*socket, value);
+      }
+      break;
+    }
+    case SocketType::STRING: {
+      const string value = reader.read_string();
+      if (node) {
+        node->set(*socket, ustring(value));
+      }
+      break;
+    }
+    case SocketType::ENUM: {
+      const ustring value(reader.read_string());
+      if (node) {
+        if (socket->enum_values->exists(value)) {
+          node->set(*socket, value);
+        }
+        else {
+          fprintf(stderr,
+                  "Unknown value \"%s\" for socket \"%s\".\n",
+                  value.c_str(),
+                  socket->name.c_str());
+        }
+      }
+      break;
+    }
+    case SocketType::TRANSFORM: {
+      Transform value;
+      reader.read_data(&value, sizeof(value));
+      if (node) {
+        node->set(*socket, value);
+      }
+      break;
+    }
+    case SocketType::NODE: {
+      const uint index = reader.read_uint();
+      if (node) {
+        node->set(*socket, binary_node_from_index(reader, index, socket->node_type));
+      }
+      break;
+    }
+    case SocketType::BOOLEAN_ARRAY: {
+      array<bool> value;
+      binary_read_array(reader, value);
+      if (node) {
+        node->set(*socket, value);
+      }
+      break;
+    }
+    case SocketType::FLOAT_ARRAY: {
+      array<float> value;
+      binary_read_array(reader, value);
+      if (node) {
+        node->set(*socket, value);
+      }
+      break;
+    }
+    case SocketType::INT_ARRAY: {
+      array<int> value;
+      binary_read_array(reader, value);
+      if (node) {
+        node->set(*socket, value);
+      }
+      break;
+    }
+    case SocketType::COLOR_ARRAY:
+    case SocketType::VECTOR_ARRAY:
+    case SocketType::POINT_ARRAY:
+    case SocketType::NORMAL_ARRAY: {
+      array<float3> value;
+      binary_read_array(reader, value);
+      if (node) {
+        node->set(*socket, value);
+      }
+      break;
+    }
+    case SocketType::POINT2_ARRAY: {
+      array<float2> value;
+      binary_read_array(reader, value);
+      if (node) {
+        node->set(*socket, value);
+      }
+      break;
+    }
+    case SocketType::TRANSFORM_ARRAY: {
+      array<Transform> value;
+      binary_read_array(reader, value);
+      if (node) {
+        node->set(*socket, value);
+      }
+      break;
+    }
+    case SocketType::STRING_ARRAY: {
+      const uint num = reader.read_uint();
+      array<ustring> value;
+      for (uint i = 0; i < num && !reader.has_error(); i++) {
+        value.push_back_slow(ustring(reader.read_string()));
+      }
+      if (node) {
+        node->set(*socket, value);
+      }
+      break;
+    }
+    case SocketType::NODE_ARRAY: {
+      array<uint> indices;
+      binary_read_array(reader, indices);
+      if (node) {
+        array<Node *> value(indices.size());
+        for (size_t i = 0; i < indices.size(); i++) {
+          value[i] = binary_node_from_index(reader, indices[i], socket->node_type);
+        }
+        node->set(*socket, value);
+      }
+      break;
+    }
+    default:
+      /* Types which are never stored, or unknown to this build. The size of the value is not
+       * known, so the rest of the file can't be read. */
+      return false;
+  }
+
+  return true;
+}
+
+void binary_read_node(BinaryReader &reader, Node *node)
+{
+  const string name = reader.read_string();
+  if (node && !name.empty()) {
+    node->name = ustring(name);
+  }
+
+  const uint num_sockets = reader.read_uint();
+  for (uint i = 0; i < num_sockets && !reader.has_error(); i++) {
+    const ustring socket_name(reader.read_string());
+    const SocketType::Type type = (SocketType::Type)reader.read_uint();
+
+    /* Values of sockets which no longer exist or changed their type are skipped. */
+    const SocketType *socket = (node) ? node->type->find_input(socket_name) : nullptr;
+    const bool use_socket = socket && socket->type == type && binary_socket_is_stored(*socket);
+
+    if (!binary_read_value(reader, type, (use_socket) ? node : nullptr, socket)) {
+      fprintf(stderr,
+              "Unknown type %u of socket \"%s\".\n",
+              (uint)type,
+              socket_name.c_str());
+      reader.set_error();
+      break;
+    }
+  }
+
+  reader.nodes.push_back(node);
+}
+
+void binary_skip_node(BinaryReader &reader)
+{
+  binary_read_node(reader, nullptr);
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,99 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#pragma once
+
+#include "graph/node.h"
+
+#include "util/map.h"
+#include "util/mapped_file.h"
+#include "util/string.h"
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Binary Node Container
+ *
+ * Compact binary counterpart of the XML node serialization. Nodes are written generically from
+ * their socket types, and bulk arrays are stored raw and aligned so that they can be copied
+ * straight from a memory mapped file into `array<T>`, without any parsing.
+ *
+ * The layout of the values matches the memory layout of the types in the build which wrote the
+ * file, so files are only meant to be exchanged between builds of the same architecture. A
+ * mismatch is detected when opening the file. */
+
+/* Alignment of array data in the file, relative to its start. */
+#define BINARY_ARRAY_ALIGNMENT 16
+
+class BinaryWriter {
+ public:
+  BinaryWriter();
+  ~BinaryWriter();
+
+  bool open(const string &filepath);
+  /* Returns false if any of the writes failed. */
+  bool close();
+
+  void write_data(const void *data, const size_t size);
+  void write_uint(const uint value);
+  void write_uint64(const uint64_t value);
+  void write_string(const string &value);
+  /* Write number of elements followed by the aligned data. */
+  void write_array(const void *data, const size_t num, const size_t element_size);
+
+  /* Index of nodes which have been written, used to store references between nodes. */
+  map<const Node *, uint> node_map;
+
+ protected:
+  FILE *file_ = nullptr;
+  size_t offset_ = 0;
+  bool error_ = false;
+};
+
+class BinaryReader {
+ public:
+  bool open(const string &filepath);
+  void close();
+
+  /* True when a read went past the end of the file or the data is invalid. All further reads
+   * return zero values. */
+  bool has_error() const
+  {
+    return error_;
+  }
+
+  /* Stop reading, for data which can't be interpreted. */
+  void set_error()
+  {
+    error_ = true;
+  }
+
+  bool at_end() const
+  {
+    return pos_ >= file_.size();
+  }
+
+  void read_data(void *data, const size_t size);
+  uint read_uint();
+  uint64_t read_uint64();
+  string read_string();
+  /* Returns pointer to the aligned array data inside of the mapped file, or nullptr if the file
+   * is too short. */
+  const void *read_array(size_t &num, const size_t element_size);
+
+  /* Nodes in the order they were read, node references are indices into this. Nodes which were
+   * skipped are stored as null. */
+  vector<Node *> nodes;
+
+ protected:
+  MappedFile file_;
+  size_t pos_ = 0;
+  bool error_ = false;
+};
+
+void binary_write_node(BinaryWriter &writer, const Node *node);
+void binary_read_node(BinaryReader &reader, Node *node);
+/* Read a node record without applying it to any node, for node types which are not available. */
+void binary_skip_node(BinaryReader &reader);
+
+CCL_NAMESPACE_END
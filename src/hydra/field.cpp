@@ -32,6 +32,7 @@ class HdCyclesVolumeLoader : public VDBImageLoader {
     file.setCopyMaxBytes(0);
     if (file.open(delay_load)) {
       grid = file.readGrid(gridName);
+      filepath = filePath;
     }
   }
 };
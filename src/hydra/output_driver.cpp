@@ -17,6 +17,11 @@ void HdCyclesOutputDriver::write_render_tile(const Tile &tile)
 {
   update_render_tile(tile);
 
+  // Only the last tile completes the frame
+  if (!(tile.offset + tile.size == tile.full_size)) {
+    return;
+  }
+
   // Update convergence state of all render buffers
   for (const HdRenderPassAovBinding &aovBinding : _renderParam->GetAovBindings()) {
     if (const auto renderBuffer = static_cast<HdCyclesRenderBuffer *>(aovBinding.renderBuffer)) {
@@ -25,6 +30,12 @@ void HdCyclesOutputDriver::write_render_tile(const Tile &tile)
   }
 }
 
+bool HdCyclesOutputDriver::supports_tiled_write() const
+{
+  // Tiles are written into the render buffers at their offset
+  return true;
+}
+
 bool HdCyclesOutputDriver::update_render_tile(const Tile &tile)
 {
   std::vector<float> pixels;
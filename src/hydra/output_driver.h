@@ -16,6 +16,7 @@ class HdCyclesOutputDriver final : public CCL_NS::OutputDriver {
  private:
   void write_render_tile(const Tile &tile) override;
   bool update_render_tile(const Tile &tile) override;
+  bool supports_tiled_write() const override;
 
   HdCyclesSession *const _renderParam;
 };
@@ -55,4 +55,33 @@ bool AdaptiveSampling::need_filter(int sample) const
   return (sample & (adaptive_step - 1)) == (adaptive_step - 1);
 }
 
+bool AdaptiveSampling::use_sample_budget() const
+{
+  return use && sample_budget > 0.0f;
+}
+
+float AdaptiveSampling::budget_threshold(float threshold,
+                                         int64_t num_pixels,
+                                         int64_t num_spent_samples,
+                                         int num_active_pixels,
+                                         int num_remaining_samples) const
+{
+  if (!use_sample_budget() || num_active_pixels <= 0 || num_remaining_samples <= 0) {
+    return threshold;
+  }
+
+  const double remaining_budget = double(sample_budget) * num_pixels - num_spent_samples;
+  if (remaining_budget <= 0.0) {
+    /* Budget is used up, all pixels are to be considered converged. */
+    return FLT_MAX;
+  }
+
+  const double predicted_samples = double(num_active_pixels) * num_remaining_samples;
+  if (predicted_samples <= remaining_budget) {
+    return threshold;
+  }
+
+  return threshold * float(sqrt(predicted_samples / remaining_budget));
+}
+
 CCL_NAMESPACE_END
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include "util/types.h"
+
 CCL_NAMESPACE_BEGIN
 
 class AdaptiveSampling {
@@ -33,10 +35,40 @@ class AdaptiveSampling {
    * `sample` is the 0-based index of sample. */
   bool need_filter(int sample) const;
 
+  /* Check whether the number of samples is limited by a global sample budget. */
+  bool use_sample_budget() const;
+
+  /* Get threshold which keeps the remaining render within the sample budget.
+   *
+   * The error of a pixel goes down with the square root of the number of samples, so when the
+   * active pixels are predicted to take more samples than there are left in the budget the
+   * threshold is raised accordingly. Pixels with the lowest error converge first, which leaves
+   * the remaining samples to the pixels where they reduce the error the most.
+   *
+   * `num_pixels` is the number of pixels in the image, `num_spent_samples` is the number of
+   * pixel samples rendered so far, `num_active_pixels` is the number of pixels which are still
+   * to be sampled and `num_remaining_samples` is the number of samples left to render.
+   *
+   * Returns the given threshold if the budget is not exceeded. */
+  float budget_threshold(float threshold,
+                         int64_t num_pixels,
+                         int64_t num_spent_samples,
+                         int num_active_pixels,
+                         int num_remaining_samples) const;
+
   bool use = false;
   int adaptive_step = 0;
   int min_samples = 0;
   float threshold = 0.0f;
+
+  /* Size of the smallest square blocks of pixels over which the error is estimated in addition
+   * to the per-pixel error, the larger blocks of the hierarchy are multiples of it. Values smaller
+   * than 2 disable hierarchical error estimation. */
+  int block_size = 0;
+
+  /* Number of samples per pixel, averaged over the image, which the render is allowed to take.
+   * Zero means no budget is applied. */
+  float sample_budget = 0.0f;
 };
 
 CCL_NAMESPACE_END
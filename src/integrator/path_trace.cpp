@@ -8,6 +8,7 @@
 #include "integrator/pass_accessor.h"
 #include "integrator/path_trace_display.h"
 #include "integrator/path_trace_tile.h"
+#include "integrator/path_trace_work_cpu.h"
 #include "integrator/render_scheduler.h"
 #include "scene/pass.h"
 #include "scene/scene.h"
@@ -15,8 +16,10 @@
 #include "util/algorithm.h"
 #include "util/log.h"
 #include "util/progress.h"
+#include "util/task.h"
 #include "util/tbb.h"
 #include "util/time.h"
+#include "util/trace.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -24,7 +27,8 @@ PathTrace::PathTrace(Device *device,
                      Film *film,
                      DeviceScene *device_scene,
                      RenderScheduler &render_scheduler,
-                     TileManager &tile_manager)
+                     TileManager &tile_manager,
+                     const bool use_numa)
     : device_(device),
       film_(film),
       device_scene_(device_scene),
@@ -43,6 +47,12 @@ PathTrace::PathTrace(Device *device,
   /* Create path tracing work in advance, so that it can be reused by incremental sampling as much
    * as possible. */
   device_->foreach_device([&](Device *path_trace_device) {
+    if (use_numa && path_trace_device->info.type == DEVICE_CPU) {
+      if (create_numa_path_trace_works(path_trace_device)) {
+        return;
+      }
+    }
+
     unique_ptr<PathTraceWork> work = PathTraceWork::create(
         path_trace_device, film, device_scene, &render_cancel_.is_requested);
     if (work) {
@@ -61,6 +71,40 @@ PathTrace::~PathTrace()
   destroy_gpu_resources();
 }
 
+bool PathTrace::create_numa_path_trace_works(Device *cpu_device)
+{
+  const vector<int> numa_nodes = TaskScheduler::numa_nodes();
+  if (numa_nodes.size() < 2) {
+    VLOG_INFO << "Single NUMA node detected, using one path trace work for CPU device.";
+    return false;
+  }
+
+  /* Distribute the threads of the device across nodes proportionally to their size, so that a
+   * reduced number of CPU threads (as in CPU + GPU rendering) is respected. */
+  int total_concurrency = 0;
+  for (const int numa_node : numa_nodes) {
+    total_concurrency += TaskScheduler::numa_node_concurrency(numa_node);
+  }
+
+  for (const int numa_node : numa_nodes) {
+    const int node_concurrency = TaskScheduler::numa_node_concurrency(numa_node);
+    const int num_threads = max(
+        1, (node_concurrency * cpu_device->info.cpu_threads) / max(total_concurrency, 1));
+
+    VLOG_INFO << "Creating path trace work for NUMA node " << numa_node << " with "
+              << num_threads << " threads.";
+
+    path_trace_works_.emplace_back(make_unique<PathTraceWorkCPU>(cpu_device,
+                                                                 film_,
+                                                                 device_scene_,
+                                                                 &render_cancel_.is_requested,
+                                                                 numa_node,
+                                                                 num_threads));
+  }
+
+  return true;
+}
+
 void PathTrace::load_kernels()
 {
   if (denoiser_) {
@@ -177,6 +221,8 @@ void PathTrace::render_pipeline(RenderWork render_work)
   /* NOTE: Only check for "instant" cancel here. The user-requested cancel via progress is
    * checked in Session and the work in the event of cancel is to be finished here. */
 
+  TRACE_SCOPE("Render Pipeline", "render");
+
   render_scheduler_.set_need_schedule_cryptomatte(device_scene_->data.film.cryptomatte_passes !=
                                                   0);
 
@@ -358,6 +404,16 @@ void PathTrace::update_work_buffer_params_if_needed(const RenderWork &render_wor
 
 void PathTrace::init_render_buffers(const RenderWork &render_work)
 {
+  /* Render buffers are about to be cleared, so the balance between works can be changed without
+   * copying any render result. Use the throughput measured so far, so that a new render starts
+   * with a split which matches performance of the devices. */
+  if (render_work.init_render_buffers && path_trace_works_.size() > 1) {
+    if (work_balance_do_from_throughput(work_balance_infos_)) {
+      VLOG_WORK << "Balance of path trace works changed based on the measured throughput.";
+      render_state_.need_reset_params = true;
+    }
+  }
+
   update_work_buffer_params_if_needed(render_work);
 
   /* Handle initialization scheduled by the render scheduler. */
@@ -379,6 +435,8 @@ void PathTrace::path_trace(RenderWork &render_work)
   VLOG_WORK << "Will path trace " << render_work.path_trace.num_samples
             << " samples at the resolution divider " << render_work.resolution_divider;
 
+  TRACE_SCOPE("Path Trace", "render");
+
   const double start_time = time_dt();
 
   const int num_works = path_trace_works_.size();
@@ -394,6 +452,8 @@ void PathTrace::path_trace(RenderWork &render_work)
       return;
     }
 
+    TRACE_SCOPE("Render Samples", "render", path_trace_work->get_device()->info.description);
+
     PathTraceWork::RenderStatistics statistics;
     path_trace_work->render_samples(statistics,
                                     render_work.path_trace.start_sample,
@@ -401,7 +461,14 @@ void PathTrace::path_trace(RenderWork &render_work)
                                     render_work.path_trace.sample_offset);
 
     const double work_time = time_dt() - work_start_time;
-    work_balance_infos_[i].time_spent += work_time;
+    const BufferParams &work_buffer_params = path_trace_work->get_effective_buffer_params();
+    /* Canceled work did not render all of its pixel samples, so its timing is not usable for
+     * balancing. */
+    if (!is_cancel_requested()) {
+      work_balance_infos_[i].time_spent += work_time;
+      work_balance_infos_[i].num_pixel_samples += double(work_buffer_params.width) *
+                                                  work_buffer_params.height * num_samples;
+    }
     work_balance_infos_[i].occupancy = statistics.occupancy;
 
     VLOG_INFO << "Rendered " << num_samples << " samples in " << work_time << " seconds ("
@@ -426,7 +493,10 @@ void PathTrace::adaptive_sample(RenderWork &render_work)
     return;
   }
 
+  TRACE_SCOPE("Adaptive Sampling", "render");
+
   bool did_reschedule_on_idle = false;
+  uint num_active_pixels = 0;
 
   while (true) {
     VLOG_WORK << "Will filter adaptive stopping buffer, threshold "
@@ -437,7 +507,7 @@ void PathTrace::adaptive_sample(RenderWork &render_work)
 
     const double start_time = time_dt();
 
-    uint num_active_pixels = 0;
+    num_active_pixels = 0;
     parallel_for_each(path_trace_works_, [&](unique_ptr<PathTraceWork> &path_trace_work) {
       const uint num_active_pixels_in_work =
           path_trace_work->adaptive_sampling_converge_filter_count_active(
@@ -477,6 +547,8 @@ void PathTrace::adaptive_sample(RenderWork &render_work)
       break;
     }
   }
+
+  render_scheduler_.report_adaptive_sampling_active_pixels(num_active_pixels);
 }
 
 void PathTrace::set_denoiser_params(const DenoiseParams &params)
@@ -534,6 +606,8 @@ void PathTrace::denoise(const RenderWork &render_work)
 
   VLOG_WORK << "Perform denoising work.";
 
+  TRACE_SCOPE("Denoise", "render");
+
   const double start_time = time_dt();
 
   RenderBuffers *buffer_to_denoise = nullptr;
@@ -633,6 +707,8 @@ void PathTrace::update_display(const RenderWork &render_work)
     return;
   }
 
+  TRACE_SCOPE("Update Display", "render");
+
   const double start_time = time_dt();
 
   if (output_driver_) {
@@ -736,10 +812,14 @@ void PathTrace::write_tile_buffer(const RenderWork &render_work)
 
   VLOG_WORK << "Write tile result.";
 
+  TRACE_SCOPE("Write Tile Buffer", "tile");
+
   render_state_.tile_written = true;
 
   const bool has_multiple_tiles = tile_manager_.has_multiple_tiles();
 
+  const double start_time = time_dt();
+
   /* Write render tile result, but only if not using tiled rendering.
    *
    * Tiles are written to a file during rendering, and written to the software at the end
@@ -757,6 +837,8 @@ void PathTrace::write_tile_buffer(const RenderWork &render_work)
     VLOG_WORK << "Write tile result to disk.";
     tile_buffer_write_to_disk();
   }
+
+  render_scheduler_.report_tile_write_time(render_work, time_dt() - start_time);
 }
 
 void PathTrace::finalize_full_buffer_on_disk(const RenderWork &render_work)
@@ -774,7 +856,9 @@ void PathTrace::finalize_full_buffer_on_disk(const RenderWork &render_work)
 
   /* Make sure writing to the file is fully finished.
    * This will include writing all possible missing tiles, ensuring validness of the file. */
-  tile_manager_.finish_write_tiles();
+  if (!tile_manager_.finish_write_tiles()) {
+    device_->set_error("Error writing tile to file");
+  }
 
   /* NOTE: The rest of full-frame post-processing (such as full-frame denoising) will be done after
    * all scenes and layers are rendered by the Session (which happens after freeing Session memory,
@@ -948,46 +1032,56 @@ bool PathTrace::copy_render_tile_from_device()
   return success;
 }
 
-static string get_layer_view_name(const RenderBuffers &buffers)
+static string get_layer_view_name(const BufferParams &params)
 {
   string result;
 
-  if (buffers.params.layer.size()) {
-    result += string(buffers.params.layer);
+  if (params.layer.size()) {
+    result += string(params.layer);
   }
 
-  if (buffers.params.view.size()) {
+  if (params.view.size()) {
     if (!result.empty()) {
       result += ", ";
     }
-    result += string(buffers.params.view);
+    result += string(params.view);
   }
 
   return result;
 }
 
+void PathTrace::full_buffer_read_error()
+{
+  const string error_message = "Error reading tiles from file";
+  if (progress_) {
+    progress_->set_error(error_message);
+    progress_->set_cancel(error_message);
+  }
+  else {
+    LOG(ERROR) << error_message;
+  }
+}
+
 void PathTrace::process_full_buffer_from_disk(string_view filename)
 {
   VLOG_WORK << "Processing full frame buffer file " << filename;
 
+  if (output_driver_ && output_driver_->supports_tiled_write()) {
+    process_full_buffer_from_disk_in_regions(filename);
+    return;
+  }
+
   progress_set_status("Reading full buffer from disk");
 
   RenderBuffers full_frame_buffers(cpu_device_.get());
 
   DenoiseParams denoise_params;
   if (!tile_manager_.read_full_buffer_from_disk(filename, &full_frame_buffers, &denoise_params)) {
-    const string error_message = "Error reading tiles from file";
-    if (progress_) {
-      progress_->set_error(error_message);
-      progress_->set_cancel(error_message);
-    }
-    else {
-      LOG(ERROR) << error_message;
-    }
+    full_buffer_read_error();
     return;
   }
 
-  const string layer_view_name = get_layer_view_name(full_frame_buffers);
+  const string layer_view_name = get_layer_view_name(full_frame_buffers.params);
 
   render_state_.has_denoised_result = false;
 
@@ -1009,6 +1103,7 @@ void PathTrace::process_full_buffer_from_disk(string_view filename)
   }
 
   full_frame_state_.render_buffers = &full_frame_buffers;
+  full_frame_state_.offset = make_int2(0, 0);
 
   progress_set_status(layer_view_name, "Finishing");
 
@@ -1019,6 +1114,70 @@ void PathTrace::process_full_buffer_from_disk(string_view filename)
   full_frame_state_.render_buffers = nullptr;
 }
 
+void PathTrace::process_full_buffer_from_disk_in_regions(string_view filename)
+{
+  progress_set_status("Reading full buffer from disk");
+
+  BufferParams full_params;
+  DenoiseParams denoise_params;
+  if (!tile_manager_.open_full_buffer_from_disk(filename, &full_params, &denoise_params)) {
+    full_buffer_read_error();
+    return;
+  }
+
+  const string layer_view_name = get_layer_view_name(full_params);
+
+  /* Regions are denoised with the neighboring pixels around them, so that the denoised result
+   * has no seams between regions. */
+  const int region_size = 8 * TileManager::IMAGE_TILE_SIZE;
+  const int padding = (denoise_params.use) ? TileManager::IMAGE_TILE_SIZE : 0;
+
+  render_state_.has_denoised_result = false;
+
+  if (denoise_params.use) {
+    /* Re-use the denoiser, see process_full_buffer_from_disk(). */
+    set_denoiser_params(denoise_params);
+  }
+
+  const int num_regions_x = divide_up(full_params.width, region_size);
+  const int num_regions_y = divide_up(full_params.height, region_size);
+  const int num_regions = num_regions_x * num_regions_y;
+
+  RenderBuffers region_buffers(cpu_device_.get());
+
+  for (int region_index = 0; region_index < num_regions; region_index++) {
+    const int x = (region_index % num_regions_x) * region_size;
+    const int y = (region_index / num_regions_x) * region_size;
+    const int width = min(region_size, full_params.width - x);
+    const int height = min(region_size, full_params.height - y);
+
+    progress_set_status(layer_view_name,
+                        string_printf("Finishing region %d/%d", region_index + 1, num_regions));
+
+    if (!tile_manager_.read_full_buffer_region_from_disk(
+            x, y, width, height, padding, &region_buffers)) {
+      full_buffer_read_error();
+      break;
+    }
+
+    if (denoise_params.use) {
+      /* Number of samples doesn't matter too much, since the samples count pass will be used. */
+      denoiser_->denoise_buffer(region_buffers.params, &region_buffers, 0, false);
+      render_state_.has_denoised_result = true;
+    }
+
+    full_frame_state_.render_buffers = &region_buffers;
+    full_frame_state_.offset = make_int2(x, y);
+
+    tile_buffer_write();
+  }
+
+  full_frame_state_.render_buffers = nullptr;
+  full_frame_state_.offset = make_int2(0, 0);
+
+  tile_manager_.close_full_buffer_from_disk();
+}
+
 int PathTrace::get_num_render_tile_samples() const
 {
   if (full_frame_state_.render_buffers) {
@@ -1084,7 +1243,7 @@ int2 PathTrace::get_render_tile_size() const
 int2 PathTrace::get_render_tile_offset() const
 {
   if (full_frame_state_.render_buffers) {
-    return make_int2(0, 0);
+    return full_frame_state_.offset;
   }
 
   const Tile &tile = tile_manager_.get_current_tile();
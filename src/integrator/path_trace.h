@@ -42,12 +42,16 @@ class TileManager;
 class PathTrace {
  public:
   /* Render scheduler is used to report timing information and access things like start/finish
-   * sample. */
+   * sample.
+   *
+   * When `use_numa` is true the CPU device is split into one path trace work per NUMA node, each
+   * using node-local copies of the hot scene data. */
   PathTrace(Device *device,
             Film *film,
             DeviceScene *device_scene,
             RenderScheduler &render_scheduler,
-            TileManager &tile_manager);
+            TileManager &tile_manager,
+            bool use_numa = false);
   ~PathTrace();
 
   /* Create devices and load kernels which are created on-demand (for example, denoising devices).
@@ -183,6 +187,10 @@ class PathTrace {
   function<void(void)> progress_update_cb;
 
  protected:
+  /* Create one path trace work per NUMA node for the given CPU device.
+   * Returns false if the machine has a single NUMA node, or the topology can not be detected. */
+  bool create_numa_path_trace_works(Device *cpu_device);
+
   /* Actual implementation of the rendering pipeline.
    * Calls steps in order, checking for the cancel to be requested in between.
    *
@@ -239,6 +247,13 @@ class PathTrace {
   /* Write current tile into the file on disk. */
   void tile_buffer_write_to_disk();
 
+  /* Read, process and write the full-frame file one region at a time, for output drivers which
+   * support tiled writes. */
+  void process_full_buffer_from_disk_in_regions(string_view filename);
+
+  /* Report an error reading the full-frame file. */
+  void full_buffer_read_error();
+
   /* Run the progress_update_cb callback if it is needed. */
   void progress_update_if_needed(const RenderWork &render_work);
 
@@ -349,6 +364,9 @@ class PathTrace {
   /* State of the full frame processing and writing to the software. */
   struct {
     RenderBuffers *render_buffers = nullptr;
+
+    /* Offset of the window of the render buffers in the full frame. */
+    int2 offset = make_int2(0, 0);
   } full_frame_state_;
 };
 
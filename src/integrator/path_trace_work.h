@@ -47,6 +47,12 @@ class PathTraceWork {
                                    const BufferParams &effective_big_tile_params,
                                    const BufferParams &effective_buffer_params);
 
+  /* Get effective parameters of the part of the big tile rendered by this work. */
+  const BufferParams &get_effective_buffer_params() const
+  {
+    return effective_buffer_params_;
+  }
+
   /* Check whether the big tile is being worked on by multiple path trace works. */
   bool has_multiple_works() const;
 
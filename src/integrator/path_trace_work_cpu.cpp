@@ -6,6 +6,7 @@
 #include "device/cpu/kernel.h"
 #include "device/device.h"
 
+#include "kernel/film/adaptive_sampling.h"
 #include "kernel/film/write.h"
 #include "kernel/integrator/path_state.h"
 
@@ -18,18 +19,10 @@
 #include "util/atomic.h"
 #include "util/log.h"
 #include "util/tbb.h"
+#include "util/time.h"
 
 CCL_NAMESPACE_BEGIN
 
-/* Create TBB arena for execution of path tracing and rendering tasks. */
-static inline tbb::task_arena local_tbb_arena_create(const Device *device)
-{
-  /* TODO: limit this to number of threads of CPU device, it may be smaller than
-   * the system number of threads when we reduce the number of CPU threads in
-   * CPU + GPU rendering to dedicate some cores to handling the GPU device. */
-  return tbb::task_arena(device->info.cpu_threads);
-}
-
 /* Get CPUKernelThreadGlobals for the current thread. */
 static inline CPUKernelThreadGlobals *kernel_thread_globals_get(
     vector<CPUKernelThreadGlobals> &kernel_thread_globals)
@@ -44,17 +37,41 @@ static inline CPUKernelThreadGlobals *kernel_thread_globals_get(
 PathTraceWorkCPU::PathTraceWorkCPU(Device *device,
                                    Film *film,
                                    DeviceScene *device_scene,
-                                   bool *cancel_requested_flag)
+                                   bool *cancel_requested_flag,
+                                   const int numa_node,
+                                   const int num_threads)
     : PathTraceWork(device, film, device_scene, cancel_requested_flag),
-      kernels_(Device::get_cpu_kernels())
+      kernels_(Device::get_cpu_kernels()),
+      numa_node_(numa_node),
+      num_threads_(num_threads)
 {
   DCHECK_EQ(device->info.type, DEVICE_CPU);
 }
 
+tbb::task_arena PathTraceWorkCPU::local_tbb_arena_create() const
+{
+#ifdef WITH_TBB_NUMA
+  if (numa_node_ != TaskScheduler::NUMA_NODE_ANY) {
+    tbb::task_arena::constraints arena_constraints(numa_node_, num_threads_);
+    return tbb::task_arena(arena_constraints);
+  }
+#endif
+
+  /* TODO: limit this to number of threads of CPU device, it may be smaller than
+   * the system number of threads when we reduce the number of CPU threads in
+   * CPU + GPU rendering to dedicate some cores to handling the GPU device. */
+  return tbb::task_arena(device_->info.cpu_threads);
+}
+
 void PathTraceWorkCPU::init_execution()
 {
   /* Cache per-thread kernel globals. */
-  device_->get_cpu_kernel_thread_globals(kernel_thread_globals_);
+  if (numa_node_ != TaskScheduler::NUMA_NODE_ANY) {
+    device_->get_cpu_numa_kernel_thread_globals(kernel_thread_globals_, numa_node_, num_threads_);
+  }
+  else {
+    device_->get_cpu_kernel_thread_globals(kernel_thread_globals_);
+  }
 }
 
 void PathTraceWorkCPU::render_samples(RenderStatistics &statistics,
@@ -72,31 +89,86 @@ void PathTraceWorkCPU::render_samples(RenderStatistics &statistics,
     }
   }
 
-  tbb::task_arena local_arena = local_tbb_arena_create(device_);
+  /* The render time pass is written here rather than in the kernel, as it measures the time spent
+   * on all kernels of the pixel samples. */
+  const int pass_stride = effective_buffer_params_.pass_stride;
+  const int pass_render_time = effective_buffer_params_.get_pass_offset(PASS_RENDER_TIME);
+
+  const auto render_pixel = [&](const int x, const int y) {
+    KernelWorkTile work_tile;
+    work_tile.x = effective_buffer_params_.full_x + x;
+    work_tile.y = effective_buffer_params_.full_y + y;
+    work_tile.w = 1;
+    work_tile.h = 1;
+    work_tile.start_sample = start_sample;
+    work_tile.sample_offset = sample_offset;
+    work_tile.num_samples = 1;
+    work_tile.offset = effective_buffer_params_.offset;
+    work_tile.stride = effective_buffer_params_.stride;
+
+    CPUKernelThreadGlobals *kernel_globals = kernel_thread_globals_get(kernel_thread_globals_);
+
+    if (pass_render_time == PASS_UNUSED) {
+      render_samples_full_pipeline(kernel_globals, work_tile, samples_num);
+      return;
+    }
+
+    /* Accumulate microseconds, the pass accessor divides by the number of samples. Pixels are
+     * only rendered by one thread at a time, so no atomics are needed. */
+    const double time_start = time_dt();
+    render_samples_full_pipeline(kernel_globals, work_tile, samples_num);
+    const double time = time_dt() - time_start;
+
+    const uint64_t render_pixel_index = uint64_t(work_tile.offset) + work_tile.x +
+                                        uint64_t(work_tile.y) * work_tile.stride;
+    float *buffer = buffers_->buffer.data() + render_pixel_index * pass_stride + pass_render_time;
+    *buffer += float(time * 1e6);
+  };
+
+  /* Only schedule blocks which have pixels to be sampled when the adaptive sampling state is
+   * known, so that converged regions of the image do not occupy threads with no-op tasks. */
+  const bool use_active_blocks = active_blocks_.is_valid &&
+                                 !active_blocks_.buffer_params.modified(effective_buffer_params_);
+
+  tbb::task_arena local_arena = local_tbb_arena_create();
   local_arena.execute([&]() {
-    parallel_for(int64_t(0), total_pixels_num, [&](int64_t work_index) {
-      if (is_cancel_requested()) {
-        return;
-      }
+    if (use_active_blocks) {
+      const int block_size = ADAPTIVE_SAMPLING_BLOCK_SIZE;
+      const int num_blocks_x = divide_up(image_width, block_size);
 
-      const int y = work_index / image_width;
-      const int x = work_index - y * image_width;
+      parallel_for(size_t(0), active_blocks_.blocks.size(), [&](size_t i) {
+        if (is_cancel_requested()) {
+          return;
+        }
 
-      KernelWorkTile work_tile;
-      work_tile.x = effective_buffer_params_.full_x + x;
-      work_tile.y = effective_buffer_params_.full_y + y;
-      work_tile.w = 1;
-      work_tile.h = 1;
-      work_tile.start_sample = start_sample;
-      work_tile.sample_offset = sample_offset;
-      work_tile.num_samples = 1;
-      work_tile.offset = effective_buffer_params_.offset;
-      work_tile.stride = effective_buffer_params_.stride;
+        const int block_index = active_blocks_.blocks[i];
+        const int block_y = block_index / num_blocks_x;
+        const int block_x = block_index - block_y * num_blocks_x;
 
-      CPUKernelThreadGlobals *kernel_globals = kernel_thread_globals_get(kernel_thread_globals_);
+        const int start_x = block_x * block_size;
+        const int start_y = block_y * block_size;
+        const int end_x = min(start_x + block_size, int(image_width));
+        const int end_y = min(start_y + block_size, int(image_height));
 
-      render_samples_full_pipeline(kernel_globals, work_tile, samples_num);
-    });
+        for (int y = start_y; y < end_y; ++y) {
+          for (int x = start_x; x < end_x; ++x) {
+            render_pixel(x, y);
+          }
+        }
+      });
+    }
+    else {
+      parallel_for(int64_t(0), total_pixels_num, [&](int64_t work_index) {
+        if (is_cancel_requested()) {
+          return;
+        }
+
+        const int y = work_index / image_width;
+        const int x = work_index - y * image_width;
+
+        render_pixel(x, y);
+      });
+    }
   });
   if (device_->profiler.active()) {
     for (CPUKernelThreadGlobals &kernel_globals : kernel_thread_globals_) {
@@ -104,7 +176,14 @@ void PathTraceWorkCPU::render_samples(RenderStatistics &statistics,
     }
   }
 
-  statistics.occupancy = 1.0f;
+  /* Occupancy is the fraction of the scheduled pixels which are actually sampled. */
+  if (use_active_blocks && active_blocks_.num_scheduled_pixels) {
+    statistics.occupancy = float(active_blocks_.num_active_pixels) /
+                           active_blocks_.num_scheduled_pixels;
+  }
+  else {
+    statistics.occupancy = 1.0f;
+  }
 }
 
 void PathTraceWorkCPU::render_samples_full_pipeline(KernelGlobalsCPU *kernel_globals,
@@ -181,7 +260,7 @@ void PathTraceWorkCPU::copy_to_display(PathTraceDisplay *display,
   PassAccessor::Destination destination = get_display_destination_template(display);
   destination.pixels_half_rgba = rgba_half;
 
-  tbb::task_arena local_arena = local_tbb_arena_create(device_);
+  tbb::task_arena local_arena = local_tbb_arena_create();
   local_arena.execute([&]() {
     pass_accessor.get_render_tile_pixels(buffers_.get(), effective_buffer_params_, destination);
   });
@@ -200,12 +279,17 @@ bool PathTraceWorkCPU::copy_render_buffers_from_device()
 
 bool PathTraceWorkCPU::copy_render_buffers_to_device()
 {
+  /* Adaptive sampling state of the pixels might have changed. */
+  adaptive_sampling_active_blocks_clear();
+
   buffers_->buffer.copy_to_device();
   return true;
 }
 
 bool PathTraceWorkCPU::zero_render_buffers()
 {
+  adaptive_sampling_active_blocks_clear();
+
   buffers_->zero();
   return true;
 }
@@ -223,7 +307,11 @@ int PathTraceWorkCPU::adaptive_sampling_converge_filter_count_active(float thres
 
   uint num_active_pixels = 0;
 
-  tbb::task_arena local_arena = local_tbb_arena_create(device_);
+  /* The blocks are checked once all pixels are, and before the pixels are filtered. */
+  const int block_size = device_scene_->data.integrator.adaptive_block_size;
+  const bool use_blocks = (block_size > 1);
+
+  tbb::task_arena local_arena = local_tbb_arena_create();
 
   /* Check convergency and do x-filter in a single `parallel_for`, to reduce threading overhead. */
   local_arena.execute([&]() {
@@ -242,13 +330,46 @@ int PathTraceWorkCPU::adaptive_sampling_converge_filter_count_active(float thres
 
       atomic_fetch_and_add_uint32(&num_active_pixels, num_row_pixels_active);
 
-      if (!row_converged) {
+      if (!row_converged && !use_blocks) {
         kernels_.adaptive_sampling_filter_x(
             kernel_globals, render_buffer, y, full_x, width, offset, stride);
       }
     });
   });
 
+  if (use_blocks) {
+    const int num_regions = film_adaptive_sampling_num_block_regions(full_x, width, block_size) *
+                            film_adaptive_sampling_num_block_regions(full_y, height, block_size);
+
+    local_arena.execute([&]() {
+      parallel_for(0, num_regions, [&](int region_index) {
+        CPUKernelThreadGlobals *kernel_globals = &kernel_thread_globals_[0];
+        const uint num_activated_pixels = kernels_.adaptive_sampling_convergence_check_block(
+            kernel_globals,
+            render_buffer,
+            region_index,
+            full_x,
+            full_y,
+            width,
+            height,
+            threshold,
+            offset,
+            stride);
+        atomic_fetch_and_add_uint32(&num_active_pixels, num_activated_pixels);
+      });
+    });
+
+    if (num_active_pixels) {
+      local_arena.execute([&]() {
+        parallel_for(full_y, full_y + height, [&](int y) {
+          CPUKernelThreadGlobals *kernel_globals = &kernel_thread_globals_[0];
+          kernels_.adaptive_sampling_filter_x(
+              kernel_globals, render_buffer, y, full_x, width, offset, stride);
+        });
+      });
+    }
+  }
+
   if (num_active_pixels) {
     local_arena.execute([&]() {
       parallel_for(full_x, full_x + width, [&](int x) {
@@ -259,9 +380,90 @@ int PathTraceWorkCPU::adaptive_sampling_converge_filter_count_active(float thres
     });
   }
 
+  adaptive_sampling_active_blocks_update(num_active_pixels);
+
   return num_active_pixels;
 }
 
+void PathTraceWorkCPU::adaptive_sampling_active_blocks_update(const uint num_active_pixels)
+{
+  const int full_x = effective_buffer_params_.full_x;
+  const int full_y = effective_buffer_params_.full_y;
+  const int width = effective_buffer_params_.width;
+  const int height = effective_buffer_params_.height;
+  const int offset = effective_buffer_params_.offset;
+  const int stride = effective_buffer_params_.stride;
+
+  const int block_size = ADAPTIVE_SAMPLING_BLOCK_SIZE;
+  const int num_blocks_x = divide_up(width, block_size);
+  const int num_blocks_y = divide_up(height, block_size);
+
+  active_blocks_.is_valid = true;
+  active_blocks_.buffer_params = effective_buffer_params_;
+  active_blocks_.blocks.clear();
+  active_blocks_.num_scheduled_pixels = 0;
+  active_blocks_.num_active_pixels = 0;
+
+  if (num_active_pixels == 0) {
+    return;
+  }
+
+  const KernelFilm &kfilm = device_scene_->data.film;
+  const int64_t pass_stride = kfilm.pass_stride;
+  const int aux_w_offset = kfilm.pass_adaptive_aux_buffer + 3;
+  const float *render_buffer = buffers_->buffer.data();
+
+  /* Number of pixels which are to be sampled in every block. The filter might have re-activated
+   * pixels, so the count is gathered from the buffer rather than from the convergence check. */
+  vector<int> num_block_active_pixels(num_blocks_x * num_blocks_y, 0);
+
+  tbb::task_arena local_arena = local_tbb_arena_create();
+  local_arena.execute([&]() {
+    parallel_for(0, num_blocks_y, [&](int block_y) {
+      const int start_y = block_y * block_size;
+      const int end_y = min(start_y + block_size, height);
+      int *block_active_pixels = num_block_active_pixels.data() + block_y * num_blocks_x;
+
+      for (int y = start_y; y < end_y; ++y) {
+        const int64_t row_pixel_index = int64_t(offset) + full_x + int64_t(full_y + y) * stride;
+        const float *buffer = render_buffer + row_pixel_index * pass_stride;
+        for (int x = 0; x < width; ++x, buffer += pass_stride) {
+          if (buffer[aux_w_offset] == 0.0f) {
+            ++block_active_pixels[x / block_size];
+          }
+        }
+      }
+    });
+  });
+
+  for (int block_y = 0; block_y < num_blocks_y; ++block_y) {
+    const int block_height = min(block_size, height - block_y * block_size);
+    for (int block_x = 0; block_x < num_blocks_x; ++block_x) {
+      const int block_index = block_y * num_blocks_x + block_x;
+      if (num_block_active_pixels[block_index] == 0) {
+        continue;
+      }
+
+      const int block_width = min(block_size, width - block_x * block_size);
+
+      active_blocks_.blocks.push_back(block_index);
+      active_blocks_.num_scheduled_pixels += block_width * block_height;
+      active_blocks_.num_active_pixels += num_block_active_pixels[block_index];
+    }
+  }
+
+  VLOG_WORK << "Adaptive sampling: " << active_blocks_.blocks.size() << " of "
+            << num_blocks_x * num_blocks_y << " blocks are active.";
+}
+
+void PathTraceWorkCPU::adaptive_sampling_active_blocks_clear()
+{
+  active_blocks_.is_valid = false;
+  active_blocks_.blocks.clear();
+  active_blocks_.num_scheduled_pixels = 0;
+  active_blocks_.num_active_pixels = 0;
+}
+
 void PathTraceWorkCPU::cryptomatte_postproces()
 {
   const int width = effective_buffer_params_.width;
@@ -269,7 +471,7 @@ void PathTraceWorkCPU::cryptomatte_postproces()
 
   float *render_buffer = buffers_->buffer.data();
 
-  tbb::task_arena local_arena = local_tbb_arena_create(device_);
+  tbb::task_arena local_arena = local_tbb_arena_create();
 
   /* Check convergency and do x-filter in a single `parallel_for`, to reduce threading overhead. */
   local_arena.execute([&]() {
@@ -10,6 +10,10 @@
 
 #include "integrator/path_trace_work.h"
 
+#include "session/buffers.h"
+
+#include "util/task.h"
+#include "util/tbb.h"
 #include "util/vector.h"
 
 CCL_NAMESPACE_BEGIN
@@ -24,13 +28,18 @@ class CPUKernels;
  * for CPU devices.
  *
  * NOTE: For the CPU rendering there are assumptions about TBB arena size and number of concurrent
- * queues on the render device which makes this work be only usable on CPU. */
+ * queues on the render device which makes this work be only usable on CPU.
+ *
+ * When a NUMA node is given the work only uses threads of that node, and the kernel globals of
+ * those threads point to node-local copies of the most frequently accessed scene arrays. */
 class PathTraceWorkCPU : public PathTraceWork {
  public:
   PathTraceWorkCPU(Device *device,
                    Film *film,
                    DeviceScene *device_scene,
-                   bool *cancel_requested_flag);
+                   bool *cancel_requested_flag,
+                   int numa_node = TaskScheduler::NUMA_NODE_ANY,
+                   int num_threads = 0);
 
   virtual void init_execution() override;
 
@@ -73,15 +82,47 @@ class PathTraceWorkCPU : public PathTraceWork {
                                     const KernelWorkTile &work_tile,
                                     const int samples_num);
 
+  /* Create TBB arena for execution of path tracing and rendering tasks. */
+  tbb::task_arena local_tbb_arena_create() const;
+
+  /* Build compacted list of pixel blocks which still have pixels to be sampled, from the
+   * adaptive sampling state stored in the render buffer. Is to be called after the adaptive
+   * sampling filter, as the filter might re-activate pixels next to active ones. */
+  void adaptive_sampling_active_blocks_update(const uint num_active_pixels);
+
+  /* Invalidate the list of active blocks, so that all pixels are scheduled for rendering. */
+  void adaptive_sampling_active_blocks_clear();
+
+  /* Size in pixels of a side of a square block used for scheduling of adaptive sampling work. */
+  static constexpr int ADAPTIVE_SAMPLING_BLOCK_SIZE = 8;
+
   /* CPU kernels. */
   const CPUKernels &kernels_;
 
+  /* NUMA node the work is bound to, and number of threads used on it. */
+  int numa_node_;
+  int num_threads_;
+
   /* Copy of kernel globals which is suitable for concurrent access from multiple threads.
    *
    * More specifically, the `kernel_globals_` is local to each threads and nobody else is
    * accessing it, but some "localization" is required to decouple from kernel globals stored
    * on the device level. */
   vector<CPUKernelThreadGlobals> kernel_thread_globals_;
+
+  /* Blocks of the effective buffer which have at least one pixel not converged yet. Only used
+   * when it was built for the current effective buffer parameters. */
+  struct {
+    bool is_valid = false;
+    BufferParams buffer_params;
+
+    /* Indices of blocks, in the order of scanlines of blocks. */
+    vector<int> blocks;
+
+    /* Number of pixels covered by the blocks, and number of pixels to be sampled in them. */
+    int64_t num_scheduled_pixels = 0;
+    int64_t num_active_pixels = 0;
+  } active_blocks_;
 };
 
 CCL_NAMESPACE_END
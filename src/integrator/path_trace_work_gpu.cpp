@@ -1048,6 +1048,33 @@ int PathTraceWorkGPU::adaptive_sampling_convergence_check_count_active(float thr
 
   queue_->enqueue(DEVICE_KERNEL_ADAPTIVE_SAMPLING_CONVERGENCE_CHECK, work_size, args);
 
+  /* The blocks are checked once all pixels are, in regions of the block hierarchy aligned to the
+   * full frame as in film_adaptive_sampling_num_block_regions(). */
+  const int block_size = device_scene_->data.integrator.adaptive_block_size;
+  if (block_size > 1) {
+    const int region_size = block_size << (ADAPTIVE_SAMPLING_BLOCK_LEVELS - 1);
+    const int full_x = effective_buffer_params_.full_x;
+    const int full_y = effective_buffer_params_.full_y;
+    const int num_regions_x = (full_x + effective_buffer_params_.width - 1) / region_size -
+                              full_x / region_size + 1;
+    const int num_regions_y = (full_y + effective_buffer_params_.height - 1) / region_size -
+                              full_y / region_size + 1;
+
+    DeviceKernelArguments block_args(&buffers_->buffer.device_pointer,
+                                     &effective_buffer_params_.full_x,
+                                     &effective_buffer_params_.full_y,
+                                     &effective_buffer_params_.width,
+                                     &effective_buffer_params_.height,
+                                     &threshold,
+                                     &effective_buffer_params_.offset,
+                                     &effective_buffer_params_.stride,
+                                     &num_active_pixels.device_pointer);
+
+    queue_->enqueue(DEVICE_KERNEL_ADAPTIVE_SAMPLING_CONVERGENCE_CHECK_BLOCK,
+                    num_regions_x * num_regions_y,
+                    block_args);
+  }
+
   queue_->copy_from_device(num_active_pixels);
   queue_->synchronize();
 
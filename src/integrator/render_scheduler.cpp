@@ -23,6 +23,7 @@ RenderScheduler::RenderScheduler(TileManager &tile_manager, const SessionParams
       default_start_resolution_divider_(params.use_resolution_divider ? pixel_size_ * 8 : 0)
 {
   use_progressive_noise_floor_ = !background_;
+  use_time_budget_ = params.use_time_budget;
 }
 
 void RenderScheduler::set_need_schedule_cryptomatte(bool need_schedule_cryptomatte)
@@ -147,6 +148,9 @@ void RenderScheduler::reset(const BufferParams &buffer_params, int num_samples,
   /* NOTE: The adaptive sampling settings might not be available here yet. */
   state_.adaptive_sampling_threshold = 0.4f;
 
+  state_.adaptive_sampling_num_spent_samples = 0;
+  state_.adaptive_sampling_budget_threshold = 0.0f;
+
   state_.last_work_tile_was_denoised = false;
   state_.tile_result_was_written = false;
   state_.postprocess_work_scheduled = false;
@@ -162,6 +166,13 @@ void RenderScheduler::reset(const BufferParams &buffer_params, int num_samples,
   state_.occupancy_num_samples = 0;
   state_.occupancy = 1.0f;
 
+  state_.num_active_pixels = -1;
+  state_.budget_time_per_sample = 0.0;
+  state_.budget_num_active_pixels = -1;
+  state_.budget_predicted_path_trace_time = 0.0;
+  state_.budget_prediction_error_accum = 0.0;
+  state_.budget_num_predictions = 0;
+
   first_render_time_.path_trace_per_sample = 0.0;
   first_render_time_.denoise_time = 0.0;
   first_render_time_.display_update_time = 0.0;
@@ -171,6 +182,7 @@ void RenderScheduler::reset(const BufferParams &buffer_params, int num_samples,
   adaptive_filter_time_.reset();
   display_update_time_.reset();
   rebalance_time_.reset();
+  tile_write_time_.reset();
 }
 
 void RenderScheduler::reset_for_next_tile()
@@ -214,9 +226,10 @@ bool RenderScheduler::render_work_reschedule_on_idle(RenderWork &render_work)
   }
 
   if (adaptive_sampling_.use) {
-    if (state_.adaptive_sampling_threshold > adaptive_sampling_.threshold) {
+    const float final_threshold = work_adaptive_final_threshold();
+    if (state_.adaptive_sampling_threshold > final_threshold) {
       state_.adaptive_sampling_threshold = max(state_.adaptive_sampling_threshold / 2,
-                                               adaptive_sampling_.threshold);
+                                               final_threshold);
 
       render_work.adaptive_sampling.threshold = state_.adaptive_sampling_threshold;
       render_work.adaptive_sampling.reset = true;
@@ -357,6 +370,21 @@ void RenderScheduler::update_state_for_render_work(const RenderWork &render_work
 {
   const double time_now = time_dt();
 
+  if (adaptive_sampling_.use_sample_budget() && render_work.resolution_divider == pixel_size_) {
+    const int64_t num_pixels = state_.num_active_pixels >= 0 ?
+                                   state_.num_active_pixels :
+                                   int64_t(buffer_params_.width) * buffer_params_.height;
+    state_.adaptive_sampling_num_spent_samples += num_pixels * render_work.path_trace.num_samples;
+  }
+
+  state_.budget_predicted_path_trace_time = 0.0;
+  if (use_time_budget_ && render_work.resolution_divider == pixel_size_ &&
+      render_work.path_trace.num_samples && state_.budget_time_per_sample != 0.0) {
+    state_.budget_predicted_path_trace_time = render_work.path_trace.num_samples *
+                                              (budget_get_time_per_sample() -
+                                               adaptive_filter_time_.get_average());
+  }
+
   if (render_work.rebalance) {
     state_.last_rebalance_time = time_now;
     ++state_.num_rebalance_requested;
@@ -481,6 +509,19 @@ void RenderScheduler::report_path_trace_time(const RenderWork &render_work,
   path_trace_time_.add_average(final_time_approx, render_work.path_trace.num_samples);
 
   VLOG_WORK << "Average path tracing time: " << path_trace_time_.get_average() << " seconds.";
+
+  if (render_work.resolution_divider == pixel_size_) {
+    if (state_.budget_predicted_path_trace_time != 0.0) {
+      const double prediction_error = (state_.budget_predicted_path_trace_time - time) / time;
+      state_.budget_prediction_error_accum += std::fabs(prediction_error);
+      ++state_.budget_num_predictions;
+
+      VLOG_WORK << "Path tracing time prediction error: " << prediction_error * 100.0 << "%.";
+    }
+
+    state_.budget_time_per_sample = time / render_work.path_trace.num_samples;
+    state_.budget_num_active_pixels = state_.num_active_pixels;
+  }
 }
 
 void RenderScheduler::report_path_trace_occupancy(const RenderWork &render_work, float occupancy)
@@ -556,6 +597,44 @@ void RenderScheduler::report_display_update_time(const RenderWork &render_work,
   state_.last_display_update_time = time_dt();
 }
 
+void RenderScheduler::report_tile_write_time(const RenderWork &render_work, double time)
+{
+  tile_write_time_.add_wall(time);
+
+  if (work_report_reset_average(render_work)) {
+    tile_write_time_.reset_average();
+  }
+
+  tile_write_time_.add_average(time);
+
+  VLOG_WORK << "Average tile write time: " << tile_write_time_.get_average() << " seconds.";
+}
+
+void RenderScheduler::report_adaptive_sampling_active_pixels(int num_active_pixels)
+{
+  state_.num_active_pixels = num_active_pixels;
+
+  if (!adaptive_sampling_.use_sample_budget() || state_.resolution_divider != pixel_size_) {
+    return;
+  }
+
+  const int64_t num_pixels = int64_t(buffer_params_.width) * buffer_params_.height;
+  const int num_remaining_samples = num_samples_ - state_.num_rendered_samples;
+  const float budget_threshold = adaptive_sampling_.budget_threshold(
+      adaptive_sampling_.threshold,
+      num_pixels,
+      state_.adaptive_sampling_num_spent_samples,
+      num_active_pixels,
+      num_remaining_samples);
+
+  /* Never lower the threshold again, as it would re-activate pixels which were given up on. */
+  if (budget_threshold > state_.adaptive_sampling_budget_threshold) {
+    state_.adaptive_sampling_budget_threshold = budget_threshold;
+    VLOG_WORK << "Adaptive sampling threshold raised to " << budget_threshold
+              << " to fit the sample budget.";
+  }
+}
+
 void RenderScheduler::report_rebalance_time(const RenderWork &render_work,
                                             double time,
                                             bool balance_changed)
@@ -607,6 +686,11 @@ string RenderScheduler::full_report() const
     result += "  Step: " + to_string(adaptive_sampling_.adaptive_step) + "\n";
     result += "  Min Samples: " + to_string(adaptive_sampling_.min_samples) + "\n";
     result += "  Threshold: " + to_string(adaptive_sampling_.threshold) + "\n";
+    result += "  Block Size: " + to_string(adaptive_sampling_.block_size) + "\n";
+    if (adaptive_sampling_.use_sample_budget()) {
+      result += "  Sample Budget: " + to_string(adaptive_sampling_.sample_budget) + "\n";
+      result += "  Final Threshold: " + to_string(work_adaptive_final_threshold()) + "\n";
+    }
   }
 
   result += "\nDenoiser:\n";
@@ -665,10 +749,29 @@ string RenderScheduler::full_report() const
                             rebalance_time_.get_average());
   }
 
+  if (tile_write_time_.get_wall() != 0.0) {
+    result += string_printf("  %20s %20f %20f\n",
+                            "Tile Write",
+                            tile_write_time_.get_wall(),
+                            tile_write_time_.get_average());
+  }
+
   const double total_time = path_trace_time_.get_wall() + adaptive_filter_time_.get_wall() +
-                            denoise_time_.get_wall() + display_update_time_.get_wall();
+                            denoise_time_.get_wall() + display_update_time_.get_wall() +
+                            tile_write_time_.get_wall();
   result += "\n  Total: " + to_string(total_time) + "\n";
 
+  if (use_time_budget_ && time_limit_ != 0.0) {
+    result += "\nTime budget:\n";
+    result += string_printf("  Budget: %f seconds\n", time_limit_);
+    result += string_printf("  Used:   %f seconds\n", render_wall_time);
+    if (state_.budget_num_predictions) {
+      result += string_printf("  Average path tracing prediction error: %.2f%%\n",
+                              100.0 * state_.budget_prediction_error_accum /
+                                  state_.budget_num_predictions);
+    }
+  }
+
   result += string_printf(
       "\nRendered %d samples in %f seconds\n", num_rendered_samples, render_wall_time);
 
@@ -868,6 +971,12 @@ int RenderScheduler::get_num_samples_to_path_trace() const
                                 min(num_samples_to_occupy, max_num_samples_to_render));
   }
 
+  /* Plan the samples so that the render and its post-processing fits into the budget, instead of
+   * detecting that the time limit has been exceeded after the fact. */
+  if (use_time_budget_ && time_limit_ != 0.0) {
+    num_samples_to_render = max(1, min(num_samples_to_render, budget_get_num_samples_fit()));
+  }
+
   /* If adaptive sampling is not use, render as many samples per update as possible, keeping the
    * device fully occupied, without much overhead of display updates. */
   if (!adaptive_sampling_.use) {
@@ -912,10 +1021,15 @@ bool RenderScheduler::work_need_adaptive_filter() const
 float RenderScheduler::work_adaptive_threshold() const
 {
   if (!use_progressive_noise_floor_) {
-    return adaptive_sampling_.threshold;
+    return work_adaptive_final_threshold();
   }
 
-  return max(state_.adaptive_sampling_threshold, adaptive_sampling_.threshold);
+  return max(state_.adaptive_sampling_threshold, work_adaptive_final_threshold());
+}
+
+float RenderScheduler::work_adaptive_final_threshold() const
+{
+  return max(adaptive_sampling_.threshold, state_.adaptive_sampling_budget_threshold);
 }
 
 bool RenderScheduler::work_need_denoise(bool &delayed, bool &ready_to_display)
@@ -1161,14 +1275,89 @@ void RenderScheduler::check_time_limit_reached()
   const double current_time = time_dt();
 
   if (current_time - state_.start_render_time < time_limit_) {
-    /* Time limit is not reached yet. */
-    return;
+    if (!use_time_budget_ || state_.resolution_divider != pixel_size_ ||
+        budget_get_num_samples_fit() > 0) {
+      /* Time limit is not reached yet. */
+      return;
+    }
+
+    VLOG_WORK << "No more samples fit into the time budget.";
   }
 
   state_.time_limit_reached = true;
   state_.end_render_time = current_time;
 }
 
+double RenderScheduler::budget_get_time_per_sample() const
+{
+  double time_per_sample = state_.budget_time_per_sample;
+
+  /* With adaptive sampling time per sample goes down as pixels converge. */
+  if (state_.num_active_pixels >= 0 && state_.budget_num_active_pixels > 0) {
+    time_per_sample *= double(state_.num_active_pixels) / state_.budget_num_active_pixels;
+  }
+
+  /* Adaptive filtering happens for the scheduled samples as well. */
+  time_per_sample += adaptive_filter_time_.get_average();
+
+  return time_per_sample;
+}
+
+double RenderScheduler::budget_get_postprocess_time() const
+{
+  /* Fraction of the budget reserved for the steps which did not happen yet, so that there are no
+   * timings available for them. */
+  static const double kUnmeasuredDenoiseFraction = 0.1;
+  static const double kUnmeasuredWriteFraction = 0.02;
+
+  double postprocess_time = 0.0;
+
+  if (denoiser_params_.use) {
+    /* With multiple tiles the full frame is denoised once all tiles are rendered, so there is no
+     * measurement of it while tiles are rendered. Each tile reserves its share of the estimate. */
+    const double denoise_time = tile_manager_.has_multiple_tiles() ?
+                                    0.0 :
+                                    denoise_time_.get_average();
+    postprocess_time += (denoise_time != 0.0) ? denoise_time :
+                                                time_limit_ * kUnmeasuredDenoiseFraction;
+  }
+
+  const double tile_write_time = tile_write_time_.get_average();
+  postprocess_time += (tile_write_time != 0.0) ? tile_write_time :
+                                                 time_limit_ * kUnmeasuredWriteFraction;
+
+  /* The final display update happens as part of post-processing. */
+  postprocess_time += display_update_time_.get_average();
+
+  return postprocess_time;
+}
+
+int RenderScheduler::budget_get_num_samples_fit() const
+{
+  /* Part of the budget which is kept as a safety margin for inaccuracy of the prediction. */
+  static const double kSafetyMarginFraction = 0.05;
+
+  if (state_.start_render_time == 0.0 || state_.budget_time_per_sample == 0.0) {
+    return INT_MAX;
+  }
+
+  const double time_per_sample = budget_get_time_per_sample();
+  if (time_per_sample <= 0.0) {
+    return INT_MAX;
+  }
+
+  const double elapsed_time = time_dt() - state_.start_render_time;
+  /* Display update which follows the next path tracing work is accounted for as well. */
+  const double remaining_time = time_limit_ * (1.0 - kSafetyMarginFraction) - elapsed_time -
+                                budget_get_postprocess_time() -
+                                display_update_time_.get_average();
+  if (remaining_time <= 0.0) {
+    return 0;
+  }
+
+  return int(min(remaining_time / time_per_sample, double(INT_MAX)));
+}
+
 /* --------------------------------------------------------------------
  * Utility functions.
  */
@@ -182,6 +182,10 @@ class RenderScheduler {
   void report_denoise_time(const RenderWork &render_work, double time);
   void report_display_update_time(const RenderWork &render_work, double time);
   void report_rebalance_time(const RenderWork &render_work, double time, bool balance_changed);
+  void report_tile_write_time(const RenderWork &render_work, double time);
+
+  /* Report number of pixels which are still active after the adaptive sampling filter. */
+  void report_adaptive_sampling_active_pixels(int num_active_pixels);
 
   /* Generate full multi-line report of the rendering process, including rendering parameters,
    * times, and so on. */
@@ -246,6 +250,10 @@ class RenderScheduler {
   /* Calculate threshold for adaptive sampling. */
   float work_adaptive_threshold() const;
 
+  /* Lowest threshold adaptive sampling is allowed to reach: the configured threshold, raised
+   * when needed to keep the render within the sample budget. */
+  float work_adaptive_final_threshold() const;
+
   /* Check whether current work needs denoising.
    * Denoising is not needed if the denoiser is not configured, or when denoising is happening too
    * often.
@@ -274,9 +282,24 @@ class RenderScheduler {
 
   /* Check whether render time limit has been reached (or exceeded), and if so store related
    * information in the state so that rendering is considered finished, and is possible to report
-   * average render time information. */
+   * average render time information.
+   *
+   * When the time limit is used as a budget the limit is also considered reached when the
+   * remaining time is predicted to not fit any more samples. */
   void check_time_limit_reached();
 
+  /* Time budget prediction.
+   *
+   * The budget covers path tracing as well as the post-processing of the result (final denoising
+   * and writing of the tile). Number of samples which fits into the remaining time is predicted
+   * from the most recent measured time per sample, scaled by the change in number of active
+   * pixels of adaptive sampling.
+   *
+   * Returns INT_MAX if there is not enough information to make a prediction yet. */
+  int budget_get_num_samples_fit() const;
+  double budget_get_time_per_sample() const;
+  double budget_get_postprocess_time() const;
+
   /* Helper class to keep track of task timing.
    *
    * Contains two parts: wall time and average. The wall time is an actual wall time of how long it
@@ -362,6 +385,11 @@ class RenderScheduler {
      * noise floor. */
     float adaptive_sampling_threshold = 0.0f;
 
+    /* Number of pixel samples scheduled at the final resolution, and the threshold below which
+     * adaptive sampling is not allowed to go to stay within the sample budget. */
+    int64_t adaptive_sampling_num_spent_samples = 0;
+    float adaptive_sampling_budget_threshold = 0.0f;
+
     bool last_work_tile_was_denoised = false;
     bool tile_result_was_written = false;
     bool postprocess_work_scheduled = false;
@@ -381,6 +409,21 @@ class RenderScheduler {
      * previous work was rendered. */
     int occupancy_num_samples = 0;
     float occupancy = 1.0f;
+
+    /* Number of pixels which are still to be sampled by adaptive sampling.
+     * Negative value means that the number is not known. */
+    int num_active_pixels = -1;
+
+    /* Time per sample measured for the most recent path tracing work at the final resolution, and
+     * the number of active pixels at the time the work was scheduled. */
+    double budget_time_per_sample = 0.0;
+    int budget_num_active_pixels = -1;
+
+    /* Predicted time of the currently scheduled path tracing work, and accumulated relative error
+     * of the predictions, for reporting. */
+    double budget_predicted_path_trace_time = 0.0;
+    double budget_prediction_error_accum = 0.0;
+    int budget_num_predictions = 0;
   } state_;
 
   /* Timing of tasks which were performed at the very first render work at 100% of the
@@ -397,6 +440,7 @@ class RenderScheduler {
   TimeWithAverage denoise_time_;
   TimeWithAverage display_update_time_;
   TimeWithAverage rebalance_time_;
+  TimeWithAverage tile_write_time_;
 
   /* Whether cryptomatte-related work will be scheduled. */
   bool need_schedule_cryptomatte_ = false;
@@ -418,6 +462,9 @@ class RenderScheduler {
    * Zero means no limit is applied. */
   double time_limit_ = 0.0;
 
+  /* Treat the time limit as a hard budget for the whole render, including post-processing. */
+  bool use_time_budget_ = false;
+
   /* Headless rendering without interface. */
   bool headless_;
 
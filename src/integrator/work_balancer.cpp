@@ -37,11 +37,87 @@ static double calculate_total_time(const vector<WorkBalanceInfo> &work_balance_i
   return total_time;
 }
 
+/* Weight of the latest measurement when updating the smoothed throughput. */
+static const double kThroughputSmoothingFactor = 0.5;
+
+/* Minimal relative change of a weight for the balance to be considered changed. */
+static const double kWeightChangeThreshold = 0.02;
+
+static bool has_throughput_measurements(const vector<WorkBalanceInfo> &work_balance_infos)
+{
+  for (const WorkBalanceInfo &info : work_balance_infos) {
+    if (info.num_pixel_samples <= 0 || info.time_spent <= 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool has_throughput_estimates(const vector<WorkBalanceInfo> &work_balance_infos)
+{
+  for (const WorkBalanceInfo &info : work_balance_infos) {
+    if (info.throughput <= 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void update_throughput(vector<WorkBalanceInfo> &work_balance_infos)
+{
+  for (WorkBalanceInfo &info : work_balance_infos) {
+    const double measured_throughput = info.num_pixel_samples / info.time_spent;
+    if (info.throughput <= 0) {
+      info.throughput = measured_throughput;
+    }
+    else {
+      info.throughput = lerp(info.throughput, measured_throughput, kThroughputSmoothingFactor);
+    }
+  }
+}
+
+/* Assign weights proportional to throughput of the works: this equalizes the time which the
+ * works need to render their part of the big tile.
+ * Returns true if any of the weights changed noticeably. */
+static bool assign_weights_from_throughput(vector<WorkBalanceInfo> &work_balance_infos)
+{
+  double total_throughput = 0;
+  for (const WorkBalanceInfo &info : work_balance_infos) {
+    total_throughput += info.throughput;
+  }
+
+  bool has_big_difference = false;
+  for (const WorkBalanceInfo &info : work_balance_infos) {
+    const double new_weight = info.throughput / total_throughput;
+    if (std::fabs(1.0 - new_weight / info.weight) > kWeightChangeThreshold) {
+      has_big_difference = true;
+    }
+  }
+
+  if (!has_big_difference) {
+    return false;
+  }
+
+  for (WorkBalanceInfo &info : work_balance_infos) {
+    info.weight = info.throughput / total_throughput;
+  }
+
+  return true;
+}
+
+static void reset_statistics(vector<WorkBalanceInfo> &work_balance_infos)
+{
+  for (WorkBalanceInfo &info : work_balance_infos) {
+    info.time_spent = 0;
+    info.num_pixel_samples = 0;
+  }
+}
+
 /* The balance is based on equalizing time which devices spent performing a task. Assume that
  * average of the observed times is usable for estimating whether more or less work is to be
  * scheduled, and how difference in the work scheduling is needed. */
 
-bool work_balance_do_rebalance(vector<WorkBalanceInfo> &work_balance_infos)
+static bool work_balance_do_rebalance_from_time(vector<WorkBalanceInfo> &work_balance_infos)
 {
   const int num_infos = work_balance_infos.size();
 
@@ -67,7 +143,7 @@ bool work_balance_do_rebalance(vector<WorkBalanceInfo> &work_balance_infos)
     new_weights.push_back(new_weight);
     total_weight += new_weight;
 
-    if (std::fabs(1.0 - time_target / time_average) > 0.02) {
+    if (std::fabs(1.0 - time_target / time_average) > kWeightChangeThreshold) {
       has_big_difference = true;
     }
   }
@@ -80,10 +156,47 @@ bool work_balance_do_rebalance(vector<WorkBalanceInfo> &work_balance_infos)
   for (int i = 0; i < num_infos; ++i) {
     WorkBalanceInfo &info = work_balance_infos[i];
     info.weight = new_weights[i] * total_weight_inv;
-    info.time_spent = 0;
   }
 
+  reset_statistics(work_balance_infos);
+
   return true;
 }
 
+/* When the amount of rendered pixel samples is known the throughput of every work is measured
+ * directly, which allows to jump to the balanced state in a single step instead of converging to
+ * it over multiple rebalances. */
+
+bool work_balance_do_rebalance(vector<WorkBalanceInfo> &work_balance_infos)
+{
+  if (!has_throughput_measurements(work_balance_infos)) {
+    return work_balance_do_rebalance_from_time(work_balance_infos);
+  }
+
+  update_throughput(work_balance_infos);
+  reset_statistics(work_balance_infos);
+
+  return assign_weights_from_throughput(work_balance_infos);
+}
+
+bool work_balance_do_from_throughput(vector<WorkBalanceInfo> &work_balance_infos)
+{
+  if (work_balance_infos.size() < 2) {
+    return false;
+  }
+
+  /* Fold in statistics accumulated since the last rebalance, as they belong to the previous split
+   * of the work and will not be usable after the split changes. */
+  if (has_throughput_measurements(work_balance_infos)) {
+    update_throughput(work_balance_infos);
+  }
+  reset_statistics(work_balance_infos);
+
+  if (!has_throughput_estimates(work_balance_infos)) {
+    return false;
+  }
+
+  return assign_weights_from_throughput(work_balance_infos);
+}
+
 CCL_NAMESPACE_END
@@ -11,9 +11,20 @@ struct WorkBalanceInfo {
   /* Time spent performing corresponding work. */
   double time_spent = 0;
 
+  /* Number of pixel samples rendered by the corresponding work during `time_spent`. */
+  double num_pixel_samples = 0;
+
   /* Average occupancy of the device while performing the work. */
   float occupancy = 1.0f;
 
+  /* Smoothed estimate of the work throughput, in pixel samples per second. Zero means that no
+   * measurement is available yet.
+   *
+   * The throughput does not depend on the resolution or number of samples of a particular render,
+   * so it is kept across render resets and allows to start a new render with a split which
+   * already matches the performance of the devices. */
+  double throughput = 0;
+
   /* Normalized weight, which is ready to be used for work balancing (like calculating fraction of
    * the big tile which is to be rendered on the device). */
   double weight = 1.0;
@@ -26,4 +37,10 @@ void work_balance_do_initial(vector<WorkBalanceInfo> &work_balance_infos);
  * Returns true if the balancing did change. */
 bool work_balance_do_rebalance(vector<WorkBalanceInfo> &work_balance_infos);
 
+/* Balance work based on the throughput measured during previous renders, without requiring any
+ * new statistics. Intended to be used when render buffers are re-initialized, where changing the
+ * balance comes at no cost.
+ * Returns true if the balancing did change. */
+bool work_balance_do_from_throughput(vector<WorkBalanceInfo> &work_balance_infos);
+
 CCL_NAMESPACE_END
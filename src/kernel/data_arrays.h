@@ -24,6 +24,8 @@ KERNEL_DATA_ARRAY(Transform, object_motion_pass)
 KERNEL_DATA_ARRAY(DecomposedTransform, object_motion)
 KERNEL_DATA_ARRAY(uint, object_flag)
 KERNEL_DATA_ARRAY(float, object_volume_step)
+KERNEL_DATA_ARRAY(KernelVolumeOccupancy, object_volume_occupancy)
+KERNEL_DATA_ARRAY(uint, volume_occupancy)
 KERNEL_DATA_ARRAY(uint, object_prim_offset)
 
 /* cameras */
@@ -80,6 +82,9 @@ KERNEL_DATA_ARRAY(KernelShader, shaders)
 /* lookup tables */
 KERNEL_DATA_ARRAY(float, lookup_table)
 
+/* rhino procedural noise permutations */
+KERNEL_DATA_ARRAY(uchar, rhino_noise_perm)
+
 /* tabulated Sobol sample pattern */
 KERNEL_DATA_ARRAY(float, sample_pattern_lut)
 
@@ -24,6 +24,8 @@ struct OSLThreadData;
 struct OSLShadingSystem;
 #endif
 
+struct SVMSpecializedShader;
+
 /* Array for kernel data, with size to be able to assert on invalid data access. */
 template<typename T> struct kernel_array {
   ccl_always_inline const T &fetch(int index) const
@@ -50,6 +52,10 @@ typedef struct KernelGlobalsCPU {
   OSLThreadData *osl_tdata = nullptr;
 #endif
 
+  /* Specialized shader functions, indexed by shader ID. */
+  const SVMSpecializedShader *svm_specialized = nullptr;
+  int svm_specialized_size = 0;
+
 #ifdef __PATH_GUIDING__
   /* Pointers to global data structures. */
   openpgl::cpp::SampleStorage *opgl_sample_data_storage = nullptr;
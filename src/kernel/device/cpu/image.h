@@ -9,6 +9,8 @@
 #  include <nanovdb/util/SampleFromVoxels.h>
 #endif
 
+#include "util/texture_compress.h"
+
 CCL_NAMESPACE_BEGIN
 
 /* Make template functions private so symbols don't conflict between kernels with different
@@ -33,6 +35,11 @@ ccl_device_inline float frac(float x, int *ix)
 
 template<typename TexT, typename OutT = float4> struct TextureInterpolator {
 
+  /* Block compressed textures store 4x4 pixels per element. */
+  static constexpr bool is_block_compressed = std::is_same<TexT, TextureBlockBC1>::value ||
+                                              std::is_same<TexT, TextureBlockBC3>::value ||
+                                              std::is_same<TexT, TextureBlockBC4>::value;
+
   static ccl_always_inline OutT zero()
   {
     if constexpr (std::is_same<OutT, float4>::value) {
@@ -85,11 +92,31 @@ template<typename TexT, typename OutT = float4> struct TextureInterpolator {
     return make_float4(r.x * f, r.y * f, r.z * f, r.w * f);
   }
 
+  static ccl_always_inline float4 read(const TextureBlockBC1 &block, int x, int y)
+  {
+    return texture_block_bc1_decode(block, x, y);
+  }
+
+  static ccl_always_inline float4 read(const TextureBlockBC3 &block, int x, int y)
+  {
+    return texture_block_bc3_decode(block, x, y);
+  }
+
+  static ccl_always_inline float read(const TextureBlockBC4 &block, int x, int y)
+  {
+    return texture_block_bc4_decode(block, x, y);
+  }
+
   /* Read 2D Texture Data
    * Does not check if data request is in bounds. */
   static ccl_always_inline OutT read(const TexT *data, int x, int y, int width, int height)
   {
-    return read(data[y * width + x]);
+    if constexpr (is_block_compressed) {
+      return read(data[(y >> 2) * ((width + 3) >> 2) + (x >> 2)], x & 3, y & 3);
+    }
+    else {
+      return read(data[y * width + x]);
+    }
   }
 
   /* Read 2D Texture Data Clip
@@ -99,7 +126,7 @@ template<typename TexT, typename OutT = float4> struct TextureInterpolator {
     if (x < 0 || x >= width || y < 0 || y >= height) {
       return zero();
     }
-    return read(data[y * width + x]);
+    return read(data, x, y, width, height);
   }
 
   /* Read 3D Texture Data
@@ -824,6 +851,14 @@ ccl_device float4 kernel_tex_image_interp(KernelGlobals kg, int id, float x, flo
       return TextureInterpolator<ushort4>::interp(info, x, y);
     case IMAGE_DATA_TYPE_FLOAT4:
       return TextureInterpolator<float4>::interp(info, x, y);
+    case IMAGE_DATA_TYPE_BC1:
+      return TextureInterpolator<TextureBlockBC1>::interp(info, x, y);
+    case IMAGE_DATA_TYPE_BC3:
+      return TextureInterpolator<TextureBlockBC3>::interp(info, x, y);
+    case IMAGE_DATA_TYPE_BC4: {
+      const float f = TextureInterpolator<TextureBlockBC4, float>::interp(info, x, y);
+      return make_float4(f, f, f, 1.0f);
+    }
     default:
       assert(0);
       return make_float4(
@@ -104,6 +104,18 @@ bool KERNEL_FUNCTION_FULL_NAME(adaptive_sampling_convergence_check)(
     int offset,
     int stride);
 
+uint KERNEL_FUNCTION_FULL_NAME(adaptive_sampling_convergence_check_block)(
+    const KernelGlobalsCPU *kg,
+    ccl_global float *render_buffer,
+    int region_index,
+    int start_x,
+    int start_y,
+    int width,
+    int height,
+    float threshold,
+    int offset,
+    int stride);
+
 void KERNEL_FUNCTION_FULL_NAME(adaptive_sampling_filter_x)(const KernelGlobalsCPU *kg,
                                                            ccl_global float *render_buffer,
                                                            int y,
@@ -127,4 +139,10 @@ void KERNEL_FUNCTION_FULL_NAME(cryptomatte_postprocess)(const KernelGlobalsCPU *
                                                         ccl_global float *render_buffer,
                                                         int pixel_index);
 
+/* --------------------------------------------------------------------
+ * Specialized shaders.
+ */
+
+int KERNEL_FUNCTION_FULL_NAME(svm_specialized_isa)();
+
 #undef KERNEL_ARCH
@@ -174,6 +174,27 @@ bool KERNEL_FUNCTION_FULL_NAME(adaptive_sampling_convergence_check)(
 #endif
 }
 
+uint KERNEL_FUNCTION_FULL_NAME(adaptive_sampling_convergence_check_block)(
+    const KernelGlobalsCPU *kg,
+    ccl_global float *render_buffer,
+    int region_index,
+    int start_x,
+    int start_y,
+    int width,
+    int height,
+    float threshold,
+    int offset,
+    int stride)
+{
+#ifdef KERNEL_STUB
+  STUB_ASSERT(KERNEL_ARCH, adaptive_sampling_convergence_check_block);
+  return 0;
+#else
+  return film_adaptive_sampling_convergence_check_block(
+      kg, render_buffer, region_index, start_x, start_y, width, height, threshold, offset, stride);
+#endif
+}
+
 void KERNEL_FUNCTION_FULL_NAME(adaptive_sampling_filter_x)(const KernelGlobalsCPU *kg,
                                                            ccl_global float *render_buffer,
                                                            int y,
@@ -219,6 +240,20 @@ void KERNEL_FUNCTION_FULL_NAME(cryptomatte_postprocess)(const KernelGlobalsCPU *
 #endif
 }
 
+/* --------------------------------------------------------------------
+ * Specialized shaders.
+ */
+
+int KERNEL_FUNCTION_FULL_NAME(svm_specialized_isa)()
+{
+#ifdef KERNEL_STUB
+  STUB_ASSERT(KERNEL_ARCH, svm_specialized_isa);
+  return 0;
+#else
+  return svm_specialized_isa();
+#endif
+}
+
 /* --------------------------------------------------------------------
  * Film Convert.
  */
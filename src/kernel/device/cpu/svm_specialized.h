@@ -0,0 +1,75 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+/* Common part of specialized shader functions generated from SVM nodes, see
+ * kernel/svm/specialized.h. Generated files include this and are compiled into a plugin library
+ * with the flags of one of the CPU kernels. */
+
+#pragma once
+
+/* Use the instruction set of the kernel the functions are built for, which is defined by the
+ * build of the plugin library in the same way as the optimized kernel entry points do. Without it
+ * the instruction set of the default kernel is used, see kernel/device/cpu/kernel.cpp. The
+ * resulting instruction set is exported by a generated file and checked when loading. */
+#ifndef __KERNEL_SSE2__
+#  if defined(__x86_64__) || defined(_M_X64)
+#    define __KERNEL_SSE__
+#    define __KERNEL_SSE2__
+#  endif
+
+#  ifdef WITH_KERNEL_NATIVE
+#    ifdef __SSE3__
+#      define __KERNEL_SSE3__
+#    endif
+#    ifdef __SSSE3__
+#      define __KERNEL_SSSE3__
+#    endif
+#    ifdef __SSE4_1__
+#      define __KERNEL_SSE41__
+#    endif
+#    ifdef __AVX__
+#      define __KERNEL_AVX__
+#    endif
+#    ifdef __AVX2__
+#      define __KERNEL_AVX2__
+#    endif
+#  endif
+#endif
+
+// clang-format off
+#include "kernel/device/cpu/compat.h"
+#include "kernel/device/cpu/globals.h"
+#include "kernel/device/cpu/image.h"
+
+#include "kernel/integrator/state.h"
+#include "kernel/integrator/state_flow.h"
+#include "kernel/integrator/state_util.h"
+
+/* Same order as the CPU kernel, as not all headers include their dependencies. */
+#include "kernel/integrator/init_from_camera.h"
+#include "kernel/integrator/init_from_bake.h"
+#include "kernel/integrator/intersect_closest.h"
+#include "kernel/integrator/intersect_shadow.h"
+#include "kernel/integrator/intersect_subsurface.h"
+#include "kernel/integrator/intersect_volume_stack.h"
+#include "kernel/integrator/shade_background.h"
+#include "kernel/integrator/shade_light.h"
+#include "kernel/integrator/shade_shadow.h"
+#include "kernel/integrator/shade_surface.h"
+// clang-format on
+
+#ifdef _WIN32
+#  define SVM_SPECIALIZED_EXPORT extern "C" __declspec(dllexport)
+#else
+#  define SVM_SPECIALIZED_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+/* Execute the node at the given index relative to the start of the surface nodes, with the node
+ * known at compile time. Extra data of the node is still read from the SVM nodes. */
+#define SVM_SPECIALIZED_NODE(index, type, y, z, w) \
+  offset = base + (index) + 1; \
+  if (!svm_eval_node<node_feature_mask, SHADER_TYPE_SURFACE>( \
+          kg, state, sd, stack, render_buffer, path_flag, make_uint4(type, y, z, w), offset)) \
+  { \
+    return; \
+  }
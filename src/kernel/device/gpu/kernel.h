@@ -579,6 +579,30 @@ ccl_gpu_kernel(GPU_KERNEL_BLOCK_NUM_THREADS, GPU_KERNEL_MAX_REGISTERS)
 }
 ccl_gpu_kernel_postfix
 
+ccl_gpu_kernel(GPU_KERNEL_BLOCK_NUM_THREADS, GPU_KERNEL_MAX_REGISTERS)
+    ccl_gpu_kernel_signature(adaptive_sampling_convergence_check_block,
+                             ccl_global float *render_buffer,
+                             int sx,
+                             int sy,
+                             int sw,
+                             int sh,
+                             float threshold,
+                             int offset,
+                             int stride,
+                             ccl_global uint *num_active_pixels)
+{
+  const int region_index = ccl_gpu_global_id_x();
+
+  const uint num_activated_pixels = ccl_gpu_kernel_call(
+      film_adaptive_sampling_convergence_check_block(
+          nullptr, render_buffer, region_index, sx, sy, sw, sh, threshold, offset, stride));
+
+  if (num_activated_pixels) {
+    atomic_fetch_and_add_uint32(num_active_pixels, num_activated_pixels);
+  }
+}
+ccl_gpu_kernel_postfix
+
 ccl_gpu_kernel(GPU_KERNEL_BLOCK_NUM_THREADS, GPU_KERNEL_MAX_REGISTERS)
     ccl_gpu_kernel_signature(adaptive_sampling_filter_x,
                              ccl_global float *render_buffer,
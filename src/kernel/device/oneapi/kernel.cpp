@@ -409,6 +409,15 @@ bool oneapi_enqueue_kernel(KernelContext *kernel_context,
                       oneapi_kernel_adaptive_sampling_convergence_check);
           break;
         }
+        case DEVICE_KERNEL_ADAPTIVE_SAMPLING_CONVERGENCE_CHECK_BLOCK: {
+          oneapi_call(kg,
+                      cgh,
+                      global_size,
+                      local_size,
+                      args,
+                      oneapi_kernel_adaptive_sampling_convergence_check_block);
+          break;
+        }
         case DEVICE_KERNEL_ADAPTIVE_SAMPLING_CONVERGENCE_FILTER_X: {
           oneapi_call(
               kg, cgh, global_size, local_size, args, oneapi_kernel_adaptive_sampling_filter_x);
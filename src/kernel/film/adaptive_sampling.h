@@ -7,6 +7,10 @@
 
 CCL_NAMESPACE_BEGIN
 
+/* Blocks of the hierarchy with an error up to this factor above the threshold are split into
+ * smaller blocks, blocks with a higher error are sampled as a whole. */
+#define ADAPTIVE_SAMPLING_BLOCK_SPLIT_FACTOR 4.0f
+
 /* Check whether the pixel has converged and should not be sampled anymore. */
 
 ccl_device_forceinline bool film_need_sample_pixel(KernelGlobals kg,
@@ -26,6 +30,49 @@ ccl_device_forceinline bool film_need_sample_pixel(KernelGlobals kg,
   return buffer[aux_w_offset] == 0.0f;
 }
 
+/* Accumulate terms of the convergence error of a pixel: difference between the full and half
+ * buffer estimates, and intensity of the pixel. Both are normalized by the number of samples. */
+
+ccl_device_inline void film_adaptive_sampling_error_terms(KernelGlobals kg,
+                                                          ccl_global float *buffer,
+                                                          ccl_private float *error_difference,
+                                                          ccl_private float *intensity)
+{
+  const float4 A = kernel_read_pass_float4(buffer + kernel_data.film.pass_adaptive_aux_buffer);
+  const float4 I = kernel_read_pass_float4(buffer + kernel_data.film.pass_combined);
+
+  const float sample = __float_as_uint(buffer[kernel_data.film.pass_sample_count]);
+  const float intensity_scale = kernel_data.film.exposure / sample;
+
+  /* The per pixel error as seen in section 2.1 of
+   * "A hierarchical automatic stopping condition for Monte Carlo global illumination" */
+  *error_difference += (fabsf(I.x - A.x) + fabsf(I.y - A.y) + fabsf(I.z - A.z)) *
+                       intensity_scale;
+  *intensity += (I.x + I.y + I.z) * intensity_scale;
+}
+
+ccl_device_inline float film_adaptive_sampling_error(const float error_difference,
+                                                     const float intensity)
+{
+  /* Anything with R+G+B > 1 is highly exposed - even in sRGB it's a range that
+   * some displays aren't even able to display without significant losses in
+   * detalization. Everything with R+G+B > 3 is overexposed and should receive
+   * even less samples. Filmic-like curves need maximum sampling rate at
+   * intensity near 0.1-0.2, so threshold of 1 for R+G+B leaves an additional
+   * fstop in case it is needed for compositing.
+   */
+  float error_normalize;
+  if (intensity < 1.0f) {
+    error_normalize = sqrtf(intensity);
+  }
+  else {
+    error_normalize = intensity;
+  }
+
+  /* A small epsilon is added to the divisor to prevent division by zero. */
+  return error_difference / (0.0001f + error_normalize);
+}
+
 /* Determines whether to continue sampling a given pixel or if it has sufficiently converged. */
 
 ccl_device bool film_adaptive_sampling_convergence_check(KernelGlobals kg,
@@ -46,8 +93,8 @@ ccl_device bool film_adaptive_sampling_convergence_check(KernelGlobals kg,
 
   /* TODO(Stefan): Is this better in linear, sRGB or something else? */
 
-  const float4 A = kernel_read_pass_float4(buffer + kernel_data.film.pass_adaptive_aux_buffer);
-  if (!reset && A.w != 0.0f) {
+  const uint aux_w_offset = kernel_data.film.pass_adaptive_aux_buffer + 3;
+  if (!reset && buffer[aux_w_offset] != 0.0f) {
     /* If the pixel was considered converged, its state will not change in this kernel. Early
      * output before doing any math.
      *
@@ -55,40 +102,165 @@ ccl_device bool film_adaptive_sampling_convergence_check(KernelGlobals kg,
     return true;
   }
 
-  const float4 I = kernel_read_pass_float4(buffer + kernel_data.film.pass_combined);
+  float error_difference = 0.0f;
+  float intensity = 0.0f;
+  film_adaptive_sampling_error_terms(kg, buffer, &error_difference, &intensity);
 
-  const float sample = __float_as_uint(buffer[kernel_data.film.pass_sample_count]);
-  const float intensity_scale = kernel_data.film.exposure / sample;
+  const bool did_converge = (film_adaptive_sampling_error(error_difference, intensity) <
+                             threshold);
 
-  /* The per pixel error as seen in section 2.1 of
-   * "A hierarchical automatic stopping condition for Monte Carlo global illumination" */
-  const float error_difference = (fabsf(I.x - A.x) + fabsf(I.y - A.y) + fabsf(I.z - A.z)) *
-                                 intensity_scale;
-  const float intensity = (I.x + I.y + I.z) * intensity_scale;
+  buffer[aux_w_offset] = did_converge;
 
-  /* Anything with R+G+B > 1 is highly exposed - even in sRGB it's a range that
-   * some displays aren't even able to display without significant losses in
-   * detalization. Everything with R+G+B > 3 is overexposed and should receive
-   * even less samples. Filmic-like curves need maximum sampling rate at
-   * intensity near 0.1-0.2, so threshold of 1 for R+G+B leaves an additional
-   * fstop in case it is needed for compositing.
-   */
-  float error_normalize;
-  if (intensity < 1.0f) {
-    error_normalize = sqrtf(intensity);
-  }
-  else {
-    error_normalize = intensity;
+  return did_converge;
+}
+
+/* Number of regions of the block hierarchy along one axis of the buffer. The regions are aligned
+ * to the full frame, so the first and last region may be clipped by the bounds of the buffer. */
+
+ccl_device_inline int film_adaptive_sampling_num_block_regions(int start, int size, int block_size)
+{
+  const int region_size = block_size << (ADAPTIVE_SAMPLING_BLOCK_LEVELS - 1);
+  return (start + size - 1) / region_size - start / region_size + 1;
+}
+
+/* Convergence check of the blocks of pixels in a region of the block hierarchy, done once the
+ * convergence check of all pixels in the buffer is finished.
+ *
+ * The error is estimated over square blocks of pixels (section 2.2 of the same paper), on several
+ * levels. The region is split into blocks of adaptive_block_size pixels, which are grouped 2x2
+ * into the blocks of the next level, up to the region itself. Walking down from the region, a
+ * block with an error below the threshold leaves the decision to its pixels. A block with an
+ * error far above the threshold is sampled as a whole, and other blocks are split further. The
+ * smallest blocks are sampled as a whole while their error is above the threshold.
+ *
+ * So a feature with high error keeps a neighborhood sampled that grows with the error, while
+ * flat regions stop as soon as their pixels do.
+ *
+ * Returns the number of pixels which were considered converged and are sampled again. */
+
+ccl_device uint film_adaptive_sampling_convergence_check_block(KernelGlobals kg,
+                                                               ccl_global float *render_buffer,
+                                                               int region_index,
+                                                               int start_x,
+                                                               int start_y,
+                                                               int width,
+                                                               int height,
+                                                               float threshold,
+                                                               int offset,
+                                                               int stride)
+{
+  kernel_assert(kernel_data.film.pass_adaptive_aux_buffer != PASS_UNUSED);
+  kernel_assert(kernel_data.film.pass_sample_count != PASS_UNUSED);
+
+  const int num_blocks = 1 << (ADAPTIVE_SAMPLING_BLOCK_LEVELS - 1);
+  const int block_size = kernel_data.integrator.adaptive_block_size;
+  const int region_size = block_size * num_blocks;
+
+  const int num_regions_x = film_adaptive_sampling_num_block_regions(start_x, width, block_size);
+  const int num_regions_y = film_adaptive_sampling_num_block_regions(
+      start_y, height, block_size);
+  const int region_y = region_index / num_regions_x;
+  const int region_x = region_index - region_y * num_regions_x;
+  if (region_y >= num_regions_y) {
+    return 0;
   }
 
-  /* A small epsilon is added to the divisor to prevent division by zero. */
-  const float error = error_difference / (0.0001f + error_normalize);
-  const bool did_converge = (error < threshold);
+  const int region_start_x = (start_x / region_size + region_x) * region_size;
+  const int region_start_y = (start_y / region_size + region_y) * region_size;
+
+  /* Sum the error terms of the smallest blocks, clipped by the bounds of the buffer. */
+  float block_error_difference[num_blocks * num_blocks];
+  float block_intensity[num_blocks * num_blocks];
+  int block_num_pixels[num_blocks * num_blocks];
+
+  for (int block_y = 0; block_y < num_blocks; ++block_y) {
+    for (int block_x = 0; block_x < num_blocks; ++block_x) {
+      const int block_index = block_x + block_y * num_blocks;
+      const int block_start_x = max(region_start_x + block_x * block_size, start_x);
+      const int block_start_y = max(region_start_y + block_y * block_size, start_y);
+      const int block_end_x = min(region_start_x + (block_x + 1) * block_size, start_x + width);
+      const int block_end_y = min(region_start_y + (block_y + 1) * block_size, start_y + height);
+
+      block_error_difference[block_index] = 0.0f;
+      block_intensity[block_index] = 0.0f;
+      block_num_pixels[block_index] = max(block_end_x - block_start_x, 0) *
+                                      max(block_end_y - block_start_y, 0);
+
+      for (int y = block_start_y; y < block_end_y; ++y) {
+        for (int x = block_start_x; x < block_end_x; ++x) {
+          const int render_pixel_index = offset + x + y * stride;
+          ccl_global float *buffer = render_buffer +
+                                     (uint64_t)render_pixel_index * kernel_data.film.pass_stride;
+          film_adaptive_sampling_error_terms(kg,
+                                             buffer,
+                                             &block_error_difference[block_index],
+                                             &block_intensity[block_index]);
+        }
+      }
+    }
+  }
 
   const uint aux_w_offset = kernel_data.film.pass_adaptive_aux_buffer + 3;
-  buffer[aux_w_offset] = did_converge;
+  uint num_activated_pixels = 0;
 
-  return did_converge;
+  for (int block_y = 0; block_y < num_blocks; ++block_y) {
+    for (int block_x = 0; block_x < num_blocks; ++block_x) {
+      if (block_num_pixels[block_x + block_y * num_blocks] == 0) {
+        continue;
+      }
+
+      /* Walk down the levels of the blocks containing this smallest block. */
+      bool sample_block = false;
+      for (int level = ADAPTIVE_SAMPLING_BLOCK_LEVELS - 1; level >= 0; --level) {
+        const int level_start_x = (block_x >> level) << level;
+        const int level_start_y = (block_y >> level) << level;
+        float error_difference = 0.0f;
+        float intensity = 0.0f;
+        int num_pixels = 0;
+        for (int y = level_start_y; y < level_start_y + (1 << level); ++y) {
+          for (int x = level_start_x; x < level_start_x + (1 << level); ++x) {
+            error_difference += block_error_difference[x + y * num_blocks];
+            intensity += block_intensity[x + y * num_blocks];
+            num_pixels += block_num_pixels[x + y * num_blocks];
+          }
+        }
+
+        const float inv_num_pixels = 1.0f / num_pixels;
+        const float error = film_adaptive_sampling_error(error_difference * inv_num_pixels,
+                                                         intensity * inv_num_pixels);
+        if (error < threshold) {
+          break;
+        }
+        if (level == 0 || error >= threshold * ADAPTIVE_SAMPLING_BLOCK_SPLIT_FACTOR) {
+          sample_block = true;
+          break;
+        }
+      }
+
+      if (!sample_block) {
+        continue;
+      }
+
+      const int block_start_x = max(region_start_x + block_x * block_size, start_x);
+      const int block_start_y = max(region_start_y + block_y * block_size, start_y);
+      const int block_end_x = min(region_start_x + (block_x + 1) * block_size, start_x + width);
+      const int block_end_y = min(region_start_y + (block_y + 1) * block_size, start_y + height);
+
+      for (int y = block_start_y; y < block_end_y; ++y) {
+        for (int x = block_start_x; x < block_end_x; ++x) {
+          const int render_pixel_index = offset + x + y * stride;
+          ccl_global float *buffer = render_buffer +
+                                     (uint64_t)render_pixel_index * kernel_data.film.pass_stride;
+          if (buffer[aux_w_offset] != 0.0f) {
+            buffer[aux_w_offset] = 0.0f;
+            ++num_activated_pixels;
+          }
+        }
+      }
+    }
+  }
+
+  return num_activated_pixels;
 }
 
 /* This is a simple box filter in two passes.
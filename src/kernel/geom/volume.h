@@ -36,6 +36,95 @@ ccl_device_inline float3 volume_normalized_position(KernelGlobals kg,
   return P;
 }
 
+/* Distance along the ray from t until the occupancy grid of the object has a cell with volume
+ * data, walking at most a fixed number of cells. Returns t if the cell at t is occupied, and
+ * tmax if the ray leaves the grid through empty cells. */
+
+#  define VOLUME_OCCUPANCY_MAX_CELLS 64
+
+ccl_device float volume_occupancy_empty_end(KernelGlobals kg,
+                                            const ccl_global KernelVolumeOccupancy *occ,
+                                            const float3 P,
+                                            const float3 D,
+                                            const float t,
+                                            const float tmax)
+{
+  const float3 p0 = transform_point(&occ->itfm, P);
+  float3 d = transform_direction(&occ->itfm, D);
+  d = make_float3((d.x != 0.0f) ? d.x : 1e-20f,
+                  (d.y != 0.0f) ? d.y : 1e-20f,
+                  (d.z != 0.0f) ? d.z : 1e-20f);
+  const float3 inv_d = rcp(d);
+
+  /* Clip to the grid bounds, outside of which the volume is empty. */
+  const int res_x = occ->resolution_x;
+  const int res_y = occ->resolution_y;
+  const int res_z = occ->resolution_z;
+  const float3 t0 = -p0 * inv_d;
+  const float3 t1 = (make_float3(res_x, res_y, res_z) - p0) * inv_d;
+  const float t_enter = reduce_max(min(t0, t1));
+  const float t_exit = reduce_min(max(t0, t1));
+
+  float t_cell = max(t, t_enter);
+  if (t_cell >= min(t_exit, tmax)) {
+    return tmax;
+  }
+
+  /* Walk the cells along the ray. */
+  const float3 p = p0 + d * t_cell;
+  int x = clamp(floor_to_int(p.x), 0, res_x - 1);
+  int y = clamp(floor_to_int(p.y), 0, res_y - 1);
+  int z = clamp(floor_to_int(p.z), 0, res_z - 1);
+
+  const int step_x = (d.x > 0.0f) ? 1 : -1;
+  const int step_y = (d.y > 0.0f) ? 1 : -1;
+  const int step_z = (d.z > 0.0f) ? 1 : -1;
+  float next_x = ((x + (step_x > 0)) - p0.x) * inv_d.x;
+  float next_y = ((y + (step_y > 0)) - p0.y) * inv_d.y;
+  float next_z = ((z + (step_z > 0)) - p0.z) * inv_d.z;
+  const float delta_x = fabsf(inv_d.x);
+  const float delta_y = fabsf(inv_d.y);
+  const float delta_z = fabsf(inv_d.z);
+
+  for (int i = 0; i < VOLUME_OCCUPANCY_MAX_CELLS; i++) {
+    const uint cell = ((uint)z * res_y + y) * res_x + x;
+    if (kernel_data_fetch(volume_occupancy, occ->offset + (cell >> 5)) & (1u << (cell & 31))) {
+      return t_cell;
+    }
+
+    if (next_x <= next_y && next_x <= next_z) {
+      t_cell = next_x;
+      next_x += delta_x;
+      x += step_x;
+      if (x < 0 || x >= res_x) {
+        return tmax;
+      }
+    }
+    else if (next_y <= next_z) {
+      t_cell = next_y;
+      next_y += delta_y;
+      y += step_y;
+      if (y < 0 || y >= res_y) {
+        return tmax;
+      }
+    }
+    else {
+      t_cell = next_z;
+      next_z += delta_z;
+      z += step_z;
+      if (z < 0 || z >= res_z) {
+        return tmax;
+      }
+    }
+
+    if (t_cell >= tmax) {
+      return tmax;
+    }
+  }
+
+  return t_cell;
+}
+
 ccl_device float volume_attribute_value_to_float(const float4 value)
 {
   return average(float4_to_float3(value));
@@ -178,6 +178,20 @@ ccl_device void volume_shadow_homogeneous(KernelGlobals kg, IntegratorState stat
 }
 #  endif
 
+/* First step with its shading point past the end of empty space, for skipping steps where the
+ * volume has no density. Step i ends at tmin + (i + steps_offset) * step_size. */
+ccl_device_inline int volume_step_after_empty_space(const float tmin,
+                                                    const float empty_end,
+                                                    const float step_size,
+                                                    const float steps_offset,
+                                                    const float step_shade_offset,
+                                                    const int i,
+                                                    const int max_steps)
+{
+  const float step = (empty_end - tmin) / step_size + 1.0f - steps_offset - step_shade_offset;
+  return max(i + 1, (int)ceilf(fminf(step, (float)max_steps)));
+}
+
 /* heterogeneous volume: integrate stepping through the volume until we
  * reach the end, get absorbed entirely, or run out of iterations */
 ccl_device void volume_shadow_heterogeneous(KernelGlobals kg,
@@ -215,12 +229,30 @@ ccl_device void volume_shadow_heterogeneous(KernelGlobals kg,
 
   Spectrum sum = zero_spectrum();
 
+  VOLUME_READ_LAMBDA(integrator_state_read_shadow_volume_stack(state, i))
+
   for (int i = 0; i < max_steps; i++) {
     /* advance to new position */
     float new_t = min(ray->tmax, ray->tmin + (i + steps_offset) * step_size);
     float dt = new_t - t;
 
-    float3 new_P = ray->P + ray->D * (t + dt * step_shade_offset);
+    /* skip steps in empty space, they do not attenuate */
+    const float shade_t = t + dt * step_shade_offset;
+    const float empty_end = volume_stack_empty_space_end(
+        kg, ray, shade_t, volume_read_lambda_pass);
+    if (empty_end > shade_t) {
+      const int next_i = volume_step_after_empty_space(
+          ray->tmin, empty_end, step_size, steps_offset, step_shade_offset, i, max_steps);
+      t = min(ray->tmax, ray->tmin + (next_i - 1 + steps_offset) * step_size);
+      if (t == ray->tmax) {
+        tp = *throughput * exp(sum);
+        break;
+      }
+      i = next_i - 1;
+      continue;
+    }
+
+    float3 new_P = ray->P + ray->D * shade_t;
     Spectrum sigma_t = zero_spectrum();
 
     /* compute attenuation over segment */
@@ -594,10 +626,27 @@ ccl_device_forceinline void volume_integrate_heterogeneous(
 #  endif
   Spectrum accum_emission = zero_spectrum();
 
+  VOLUME_READ_LAMBDA(integrator_state_read_volume_stack(state, i))
+
   for (int i = 0; i < max_steps; i++) {
     /* Advance to new position */
     vstate.tmax = min(ray->tmax, ray->tmin + (i + steps_offset) * step_size);
     const float shade_t = vstate.tmin + (vstate.tmax - vstate.tmin) * step_shade_offset;
+
+    /* Skip steps in empty space, which have no absorption, scattering or emission. */
+    const float empty_end = volume_stack_empty_space_end(
+        kg, ray, shade_t, volume_read_lambda_pass);
+    if (empty_end > shade_t) {
+      const int next_i = volume_step_after_empty_space(
+          ray->tmin, empty_end, step_size, steps_offset, step_shade_offset, i, max_steps);
+      vstate.tmin = min(ray->tmax, ray->tmin + (next_i - 1 + steps_offset) * step_size);
+      if (vstate.tmin == ray->tmax) {
+        break;
+      }
+      i = next_i - 1;
+      continue;
+    }
+
     sd->P = ray->P + ray->D * shade_t;
 
     /* compute segment */
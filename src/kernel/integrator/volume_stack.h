@@ -163,6 +163,45 @@ ccl_device float volume_stack_step_size(KernelGlobals kg, StackReadOp stack_read
   return step_size;
 }
 
+/* Distance along the ray from t until any volume in the stack may have non-zero density, based
+ * on the occupancy grids of volume objects. Returns t when this is not known, for the world and
+ * for volumes without a grid. */
+template<typename StackReadOp>
+ccl_device float volume_stack_empty_space_end(KernelGlobals kg,
+                                              ccl_private const Ray *ccl_restrict ray,
+                                              const float t,
+                                              StackReadOp stack_read)
+{
+  float t_end = ray->tmax;
+
+  for (int i = 0;; i++) {
+    VolumeStack entry = stack_read(i);
+    if (entry.shader == SHADER_NONE) {
+      /* Not expected to be called outside of volumes, but be safe. */
+      if (i == 0) {
+        return t;
+      }
+      break;
+    }
+    if (entry.object == OBJECT_NONE) {
+      return t;
+    }
+
+    const ccl_global KernelVolumeOccupancy *occ = &kernel_data_fetch(object_volume_occupancy,
+                                                                     entry.object);
+    if (occ->offset < 0) {
+      return t;
+    }
+
+    t_end = volume_occupancy_empty_end(kg, occ, ray->P, ray->D, t, t_end);
+    if (t_end <= t) {
+      return t;
+    }
+  }
+
+  return t_end;
+}
+
 typedef enum VolumeSampleMethod {
   VOLUME_SAMPLE_NONE = 0,
   VOLUME_SAMPLE_DISTANCE = (1 << 0),
@@ -132,6 +132,12 @@ SHADER_NODE_TYPE(RHINO_NODE_DOTS_TEXTURE)
 SHADER_NODE_TYPE(RHINO_NODE_NORMAL_PART1_TEXTURE)
 SHADER_NODE_TYPE(RHINO_NODE_NORMAL_PART2_TEXTURE)
 
+/* Pairs of nodes fused by the SVM compiler, executing both in a single dispatch. */
+SHADER_NODE_TYPE(RHINO_NODE_FUSED_TEX_COORD_MATRIX_MATH)
+SHADER_NODE_TYPE(RHINO_NODE_FUSED_ATTR_MATRIX_MATH)
+SHADER_NODE_TYPE(RHINO_NODE_FUSED_MATRIX_MATH_TEX_IMAGE)
+SHADER_NODE_TYPE(RHINO_NODE_FUSED_TEX_IMAGE_TEXTURE_ADJUSTMENT)
+
 /* Padding for struct alignment. */
 SHADER_NODE_TYPE(NODE_PAD1)
 SHADER_NODE_TYPE(NODE_PAD2)
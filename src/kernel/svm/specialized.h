@@ -0,0 +1,121 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#pragma once
+
+#include <type_traits>
+
+CCL_NAMESPACE_BEGIN
+
+/* Specialized Shaders
+ *
+ * On the CPU, the SVM nodes of a shader can be replaced by a C++ function generated ahead of time
+ * from the same nodes, with every node known at compile time. This removes the interpreter
+ * dispatch and lets the compiler fold constants of each node. Functions are loaded from a plugin
+ * library and matched to shaders by a hash of their nodes, falling back to the interpreter for
+ * all other shaders.
+ *
+ * Only surface shading of the main path is specialized. Shadow, light, background, volume and
+ * displacement evaluation use a different node feature mask and always run the interpreter. */
+
+typedef void (*SVMSpecializedFunction)(KernelGlobals kg,
+                                       ConstIntegratorState state,
+                                       ccl_private ShaderData *sd,
+                                       ccl_global float *render_buffer,
+                                       uint32_t path_flag,
+                                       int offset);
+
+struct SVMSpecializedShader {
+  /* Surface shading without and with ray-tracing nodes, or null if not specialized. */
+  SVMSpecializedFunction eval_surface;
+  SVMSpecializedFunction eval_surface_raytrace;
+};
+
+/* Plugin libraries must be built against the same kernel, check this when loading. */
+ccl_device_inline int svm_specialized_abi_version()
+{
+  return (int)(NODE_NUM * 1000003 + sizeof(KernelData) * 131 + sizeof(ShaderData) * 7 +
+               sizeof(KernelGlobalsCPU));
+}
+
+/* Instruction sets the code is compiled for. The floating point results of the specialized
+ * functions only match the interpreter when the plugin library is built for the instruction set
+ * of the kernel which calls it, this is checked when loading. */
+enum SVMSpecializedISA {
+  SVM_SPECIALIZED_ISA_SSE2 = (1 << 0),
+  SVM_SPECIALIZED_ISA_SSE3 = (1 << 1),
+  SVM_SPECIALIZED_ISA_SSSE3 = (1 << 2),
+  SVM_SPECIALIZED_ISA_SSE41 = (1 << 3),
+  SVM_SPECIALIZED_ISA_AVX = (1 << 4),
+  SVM_SPECIALIZED_ISA_AVX2 = (1 << 5),
+};
+
+ccl_device_inline int svm_specialized_isa()
+{
+  int isa = 0;
+#ifdef __KERNEL_SSE2__
+  isa |= SVM_SPECIALIZED_ISA_SSE2;
+#endif
+#ifdef __KERNEL_SSE3__
+  isa |= SVM_SPECIALIZED_ISA_SSE3;
+#endif
+#ifdef __KERNEL_SSSE3__
+  isa |= SVM_SPECIALIZED_ISA_SSSE3;
+#endif
+#ifdef __KERNEL_SSE41__
+  isa |= SVM_SPECIALIZED_ISA_SSE41;
+#endif
+#ifdef __KERNEL_AVX__
+  isa |= SVM_SPECIALIZED_ISA_AVX;
+#endif
+#ifdef __KERNEL_AVX2__
+  isa |= SVM_SPECIALIZED_ISA_AVX2;
+#endif
+  return isa;
+}
+
+/* Only evaluation with the state of the main path is specialized, shadow and null states always
+ * use the interpreter. */
+template<uint node_feature_mask, ShaderType type, typename ConstIntegratorGenericState>
+ccl_device_inline bool svm_eval_specialized(KernelGlobals kg,
+                                            ConstIntegratorGenericState state,
+                                            ccl_private ShaderData *sd,
+                                            ccl_global float *render_buffer,
+                                            uint32_t path_flag)
+{
+  typedef std::remove_cv_t<std::remove_pointer_t<ConstIntegratorGenericState>> StateType;
+
+  if constexpr (type != SHADER_TYPE_SURFACE || !std::is_same_v<StateType, IntegratorStateCPU>) {
+    return false;
+  }
+  else {
+    if (kg->svm_specialized == nullptr) {
+      return false;
+    }
+
+    const int shader = sd->shader & SHADER_MASK;
+    if (shader >= kg->svm_specialized_size) {
+      return false;
+    }
+
+    SVMSpecializedFunction function = nullptr;
+    if (node_feature_mask == KERNEL_FEATURE_NODE_MASK_SURFACE) {
+      function = kg->svm_specialized[shader].eval_surface_raytrace;
+    }
+    else if (node_feature_mask ==
+             (KERNEL_FEATURE_NODE_MASK_SURFACE & ~KERNEL_FEATURE_NODE_RAYTRACE))
+    {
+      function = kg->svm_specialized[shader].eval_surface;
+    }
+
+    if (function == nullptr) {
+      return false;
+    }
+
+    /* Start of the surface nodes, from the jump table. */
+    function(kg, state, sd, render_buffer, path_flag, kernel_data_fetch(svm_nodes, shader).y);
+    return true;
+  }
+}
+
+CCL_NAMESPACE_END
@@ -206,6 +206,10 @@ CCL_NAMESPACE_END
 #  include "kernel/svm/bevel.h"
 #endif
 
+#ifndef __KERNEL_GPU__
+#  include "kernel/svm/specialized.h"
+#endif
+
 CCL_NAMESPACE_BEGIN
 
 #ifdef __KERNEL_USE_DATA_CONSTANTS__
@@ -217,462 +221,517 @@ CCL_NAMESPACE_BEGIN
 #  define SVM_CASE(node) case node:
 #endif
 
-/* Main Interpreter Loop */
+/* Execute a single node. Returns false when evaluation of the shader ends. */
 template<uint node_feature_mask, ShaderType type, typename ConstIntegratorGenericState>
-ccl_device void svm_eval_nodes(KernelGlobals kg,
-                               ConstIntegratorGenericState state,
-                               ccl_private ShaderData *sd,
-                               ccl_global float *render_buffer,
-                               uint32_t path_flag)
+ccl_device_forceinline bool svm_eval_node(KernelGlobals kg,
+                                          ConstIntegratorGenericState state,
+                                          ccl_private ShaderData *sd,
+                                          ccl_private float *stack,
+                                          ccl_global float *render_buffer,
+                                          uint32_t path_flag,
+                                          const uint4 node,
+                                          ccl_private int &offset)
 {
-  float stack[SVM_STACK_SIZE];
-  int offset = sd->shader & SHADER_MASK;
-
-  while (1) {
-    uint4 node = read_node(kg, &offset);
-
-    switch (node.x) {
-      SVM_CASE(NODE_END)
-      return;
-      SVM_CASE(NODE_SHADER_JUMP)
-      {
-        if (type == SHADER_TYPE_SURFACE)
-          offset = node.y;
-        else if (type == SHADER_TYPE_VOLUME)
-          offset = node.z;
-        else if (type == SHADER_TYPE_DISPLACEMENT)
-          offset = node.w;
-        else
-          return;
-        break;
-      }
-      SVM_CASE(NODE_CLOSURE_BSDF)
-      offset = svm_node_closure_bsdf<node_feature_mask, type>(
-          kg, sd, stack, node, path_flag, offset);
-      break;
-      SVM_CASE(NODE_CLOSURE_EMISSION)
-      IF_KERNEL_NODES_FEATURE(EMISSION)
-      {
-        svm_node_closure_emission(sd, stack, node);
-      }
-      break;
-      SVM_CASE(NODE_CLOSURE_BACKGROUND)
-      IF_KERNEL_NODES_FEATURE(EMISSION)
-      {
-        svm_node_closure_background(sd, stack, node);
-      }
-      break;
-      SVM_CASE(NODE_CLOSURE_SET_WEIGHT)
-      svm_node_closure_set_weight(sd, node.y, node.z, node.w);
-      break;
-      SVM_CASE(NODE_CLOSURE_WEIGHT)
-      svm_node_closure_weight(sd, stack, node.y);
-      break;
-      SVM_CASE(NODE_EMISSION_WEIGHT)
-      IF_KERNEL_NODES_FEATURE(EMISSION)
-      {
-        svm_node_emission_weight(kg, sd, stack, node);
-      }
-      break;
-      SVM_CASE(NODE_MIX_CLOSURE)
-      svm_node_mix_closure(sd, stack, node);
-      break;
-      SVM_CASE(NODE_JUMP_IF_ZERO)
-      if (stack_load_float(stack, node.z) <= 0.0f)
-        offset += node.y;
-      break;
-      SVM_CASE(NODE_JUMP_IF_ONE)
-      if (stack_load_float(stack, node.z) >= 1.0f)
-        offset += node.y;
+  switch (node.x) {
+    SVM_CASE(NODE_END)
+    return false;
+    SVM_CASE(NODE_SHADER_JUMP)
+    {
+      if (type == SHADER_TYPE_SURFACE)
+        offset = node.y;
+      else if (type == SHADER_TYPE_VOLUME)
+        offset = node.z;
+      else if (type == SHADER_TYPE_DISPLACEMENT)
+        offset = node.w;
+      else
+        return false;
       break;
-      SVM_CASE(NODE_GEOMETRY)
-      svm_node_geometry(kg, sd, stack, node.y, node.z);
-      break;
-      SVM_CASE(NODE_CONVERT)
-      svm_node_convert(kg, sd, stack, node.y, node.z, node.w);
-      break;
-      SVM_CASE(NODE_TEX_COORD)
-      offset = svm_node_tex_coord(kg, sd, path_flag, stack, node, offset);
-      break;
-      SVM_CASE(NODE_VALUE_F)
-      svm_node_value_f(kg, sd, stack, node.y, node.z);
-      break;
-      SVM_CASE(NODE_VALUE_V)
-      offset = svm_node_value_v(kg, sd, stack, node.y, offset);
+    }
+    SVM_CASE(NODE_CLOSURE_BSDF)
+    offset = svm_node_closure_bsdf<node_feature_mask, type>(
+        kg, sd, stack, node, path_flag, offset);
+    break;
+    SVM_CASE(NODE_CLOSURE_EMISSION)
+    IF_KERNEL_NODES_FEATURE(EMISSION)
+    {
+      svm_node_closure_emission(sd, stack, node);
+    }
+    break;
+    SVM_CASE(NODE_CLOSURE_BACKGROUND)
+    IF_KERNEL_NODES_FEATURE(EMISSION)
+    {
+      svm_node_closure_background(sd, stack, node);
+    }
+    break;
+    SVM_CASE(NODE_CLOSURE_SET_WEIGHT)
+    svm_node_closure_set_weight(sd, node.y, node.z, node.w);
+    break;
+    SVM_CASE(NODE_CLOSURE_WEIGHT)
+    svm_node_closure_weight(sd, stack, node.y);
+    break;
+    SVM_CASE(NODE_EMISSION_WEIGHT)
+    IF_KERNEL_NODES_FEATURE(EMISSION)
+    {
+      svm_node_emission_weight(kg, sd, stack, node);
+    }
+    break;
+    SVM_CASE(NODE_MIX_CLOSURE)
+    svm_node_mix_closure(sd, stack, node);
+    break;
+    SVM_CASE(NODE_JUMP_IF_ZERO)
+    if (stack_load_float(stack, node.z) <= 0.0f)
+      offset += node.y;
+    break;
+    SVM_CASE(NODE_JUMP_IF_ONE)
+    if (stack_load_float(stack, node.z) >= 1.0f)
+      offset += node.y;
+    break;
+    SVM_CASE(NODE_GEOMETRY)
+    svm_node_geometry(kg, sd, stack, node.y, node.z);
+    break;
+    SVM_CASE(NODE_CONVERT)
+    svm_node_convert(kg, sd, stack, node.y, node.z, node.w);
+    break;
+    SVM_CASE(NODE_TEX_COORD)
+    offset = svm_node_tex_coord(kg, sd, path_flag, stack, node, offset);
+    break;
+    SVM_CASE(NODE_VALUE_F)
+    svm_node_value_f(kg, sd, stack, node.y, node.z);
+    break;
+    SVM_CASE(NODE_VALUE_V)
+    offset = svm_node_value_v(kg, sd, stack, node.y, offset);
+    break;
+    SVM_CASE(NODE_ATTR)
+    svm_node_attr<node_feature_mask>(kg, sd, stack, node);
+    break;
+    SVM_CASE(NODE_VERTEX_COLOR)
+    svm_node_vertex_color(kg, sd, stack, node.y, node.z, node.w);
+    break;
+    SVM_CASE(NODE_GEOMETRY_BUMP_DX)
+    IF_KERNEL_NODES_FEATURE(BUMP)
+    {
+      svm_node_geometry_bump_dx(kg, sd, stack, node.y, node.z);
+    }
+    break;
+    SVM_CASE(NODE_GEOMETRY_BUMP_DY)
+    IF_KERNEL_NODES_FEATURE(BUMP)
+    {
+      svm_node_geometry_bump_dy(kg, sd, stack, node.y, node.z);
+    }
+    break;
+    SVM_CASE(NODE_SET_DISPLACEMENT)
+    svm_node_set_displacement<node_feature_mask>(kg, sd, stack, node.y);
+    break;
+    SVM_CASE(NODE_DISPLACEMENT)
+    svm_node_displacement<node_feature_mask>(kg, sd, stack, node);
+    break;
+    SVM_CASE(NODE_VECTOR_DISPLACEMENT)
+    offset = svm_node_vector_displacement<node_feature_mask>(kg, sd, stack, node, offset);
+    break;
+    SVM_CASE(NODE_TEX_IMAGE)
+    offset = svm_node_tex_image(kg, sd, stack, node, offset);
+    break;
+    SVM_CASE(NODE_TEX_IMAGE_BOX)
+    svm_node_tex_image_box(kg, sd, stack, node);
+    break;
+    SVM_CASE(NODE_TEX_NOISE)
+    offset = svm_node_tex_noise(kg, sd, stack, node.y, node.z, node.w, offset);
+    break;
+    SVM_CASE(NODE_SET_BUMP)
+    svm_node_set_bump<node_feature_mask>(kg, sd, stack, node);
+    break;
+    SVM_CASE(RHINO_NODE_TEX_COORD)
+    offset = svm_rhino_node_tex_coord(kg, sd, path_flag, stack, node, offset);
+    break;
+    SVM_CASE(RHINO_NODE_MATRIX_MATH)
+    svm_rhino_node_matrix_math(kg, sd, stack, node.y, node.z, node.w, &offset);
+    break;
+    SVM_CASE(RHINO_NODE_AZIMUTH_ALTITUDE_TRANSFORM)
+    svm_rhino_node_azimuth_altitude_transform(kg, sd, stack, node, &offset);
+    break;
+    SVM_CASE(RHINO_NODE_CHECKER_TEXTURE)
+    svm_rhino_node_checker_texture(kg, sd, stack, node, &offset);
+    break;
+    SVM_CASE(RHINO_NODE_NOISE_TEXTURE)
+    svm_rhino_node_noise_texture(kg, sd, stack, node, &offset);
+    break;
+    SVM_CASE(RHINO_NODE_WAVES_TEXTURE)
+    svm_rhino_node_waves_texture(kg, sd, stack, node, &offset);
+    break;
+    SVM_CASE(RHINO_NODE_WAVES_WIDTH_TEXTURE)
+    svm_rhino_node_waves_width_texture(kg, sd, stack, node, &offset);
+    break;
+    SVM_CASE(RHINO_NODE_PERTURBING_PART1_TEXTURE)
+    svm_rhino_node_perturbing_part1_texture(kg, sd, stack, node, &offset);
+    break;
+    SVM_CASE(RHINO_NODE_PERTURBING_PART2_TEXTURE)
+    svm_rhino_node_perturbing_part2_texture(kg, sd, stack, node, &offset);
+    break;
+    SVM_CASE(RHINO_NODE_GRADIENT_TEXTURE)
+    svm_rhino_node_gradient_texture(kg, sd, stack, node, &offset);
+    break;
+    SVM_CASE(RHINO_NODE_BLEND_TEXTURE)
+    svm_rhino_node_blend_texture(kg, sd, stack, node, &offset);
+    break;
+    SVM_CASE(RHINO_NODE_EXPOSURE_TEXTURE)
+    svm_rhino_node_exposure_texture(kg, sd, stack, node, &offset);
+    break;
+    SVM_CASE(RHINO_NODE_FBM_TEXTURE)
+    svm_rhino_node_fbm_texture(kg, sd, stack, node, &offset);
+    break;
+    SVM_CASE(RHINO_NODE_GRID_TEXTURE)
+    svm_rhino_node_grid_texture(kg, sd, stack, node, &offset);
+    break;
+    SVM_CASE(RHINO_NODE_PROJECTION_CHANGER_TEXTURE)
+    svm_rhino_node_projection_changer_texture(kg, sd, stack, node, &offset);
+    break;
+    SVM_CASE(RHINO_NODE_MASK_TEXTURE)
+    svm_rhino_node_mask_texture(kg, sd, stack, node, &offset);
+    break;
+    SVM_CASE(RHINO_NODE_PERLIN_MARBLE_TEXTURE)
+    svm_rhino_node_perlin_marble_texture(kg, sd, stack, node, &offset);
+    break;
+    SVM_CASE(RHINO_NODE_PHYSICAL_SKY_TEXTURE)
+    svm_rhino_node_physical_sky_texture(kg, sd, stack, node, &offset);
+    break;
+    SVM_CASE(RHINO_NODE_TEXTURE_ADJUSTMENT_TEXTURE)
+    svm_rhino_node_texture_adjustment_texture(kg, sd, stack, node, &offset);
+    break;
+    SVM_CASE(RHINO_NODE_TILE_TEXTURE)
+    svm_rhino_node_tile_texture(kg, sd, stack, node, &offset);
+    break;
+    SVM_CASE(RHINO_NODE_DOTS_TEXTURE)
+    svm_rhino_node_dots_texture(kg, sd, stack, node, &offset);
+    break;
+    SVM_CASE(RHINO_NODE_NORMAL_PART1_TEXTURE)
+    svm_rhino_node_normal_part1_texture(kg, sd, stack, node, &offset);
+    break;
+    SVM_CASE(RHINO_NODE_NORMAL_PART2_TEXTURE)
+    svm_rhino_node_normal_part2_texture(kg, sd, stack, node, &offset);
+    break;
+    /* Fused nodes are encoded as the first node with a different type, directly followed by
+     * the second node unchanged. */
+    SVM_CASE(RHINO_NODE_FUSED_TEX_COORD_MATRIX_MATH)
+    {
+      offset = svm_rhino_node_tex_coord(kg, sd, path_flag, stack, node, offset);
+      const uint4 node2 = read_node(kg, &offset);
+      svm_rhino_node_matrix_math(kg, sd, stack, node2.y, node2.z, node2.w, &offset);
       break;
-      SVM_CASE(NODE_ATTR)
+    }
+    SVM_CASE(RHINO_NODE_FUSED_ATTR_MATRIX_MATH)
+    {
       svm_node_attr<node_feature_mask>(kg, sd, stack, node);
+      const uint4 node2 = read_node(kg, &offset);
+      svm_rhino_node_matrix_math(kg, sd, stack, node2.y, node2.z, node2.w, &offset);
       break;
-      SVM_CASE(NODE_VERTEX_COLOR)
-      svm_node_vertex_color(kg, sd, stack, node.y, node.z, node.w);
-      break;
-      SVM_CASE(NODE_GEOMETRY_BUMP_DX)
-      IF_KERNEL_NODES_FEATURE(BUMP)
-      {
-        svm_node_geometry_bump_dx(kg, sd, stack, node.y, node.z);
-      }
-      break;
-      SVM_CASE(NODE_GEOMETRY_BUMP_DY)
-      IF_KERNEL_NODES_FEATURE(BUMP)
-      {
-        svm_node_geometry_bump_dy(kg, sd, stack, node.y, node.z);
-      }
-      break;
-      SVM_CASE(NODE_SET_DISPLACEMENT)
-      svm_node_set_displacement<node_feature_mask>(kg, sd, stack, node.y);
-      break;
-      SVM_CASE(NODE_DISPLACEMENT)
-      svm_node_displacement<node_feature_mask>(kg, sd, stack, node);
-      break;
-      SVM_CASE(NODE_VECTOR_DISPLACEMENT)
-      offset = svm_node_vector_displacement<node_feature_mask>(kg, sd, stack, node, offset);
-      break;
-      SVM_CASE(NODE_TEX_IMAGE)
-      offset = svm_node_tex_image(kg, sd, stack, node, offset);
-      break;
-      SVM_CASE(NODE_TEX_IMAGE_BOX)
-      svm_node_tex_image_box(kg, sd, stack, node);
-      break;
-      SVM_CASE(NODE_TEX_NOISE)
-      offset = svm_node_tex_noise(kg, sd, stack, node.y, node.z, node.w, offset);
-      break;
-      SVM_CASE(NODE_SET_BUMP)
-      svm_node_set_bump<node_feature_mask>(kg, sd, stack, node);
-      break;
-      SVM_CASE(RHINO_NODE_TEX_COORD)
-      offset = svm_rhino_node_tex_coord(kg, sd, path_flag, stack, node, offset);
-      break;
-      SVM_CASE(RHINO_NODE_MATRIX_MATH)
+    }
+    SVM_CASE(RHINO_NODE_FUSED_MATRIX_MATH_TEX_IMAGE)
+    {
       svm_rhino_node_matrix_math(kg, sd, stack, node.y, node.z, node.w, &offset);
+      const uint4 node2 = read_node(kg, &offset);
+      offset = svm_node_tex_image(kg, sd, stack, node2, offset);
       break;
-      SVM_CASE(RHINO_NODE_AZIMUTH_ALTITUDE_TRANSFORM)
-      svm_rhino_node_azimuth_altitude_transform(kg, sd, stack, node, &offset);
-      break;
-      SVM_CASE(RHINO_NODE_CHECKER_TEXTURE)
-      svm_rhino_node_checker_texture(kg, sd, stack, node, &offset);
-      break;
-      SVM_CASE(RHINO_NODE_NOISE_TEXTURE)
-      svm_rhino_node_noise_texture(kg, sd, stack, node, &offset);
-      break;
-      SVM_CASE(RHINO_NODE_WAVES_TEXTURE)
-      svm_rhino_node_waves_texture(kg, sd, stack, node, &offset);
-      break;
-      SVM_CASE(RHINO_NODE_WAVES_WIDTH_TEXTURE)
-      svm_rhino_node_waves_width_texture(kg, sd, stack, node, &offset);
-      break;
-      SVM_CASE(RHINO_NODE_PERTURBING_PART1_TEXTURE)
-      svm_rhino_node_perturbing_part1_texture(kg, sd, stack, node, &offset);
-      break;
-      SVM_CASE(RHINO_NODE_PERTURBING_PART2_TEXTURE)
-      svm_rhino_node_perturbing_part2_texture(kg, sd, stack, node, &offset);
-      break;
-      SVM_CASE(RHINO_NODE_GRADIENT_TEXTURE)
-      svm_rhino_node_gradient_texture(kg, sd, stack, node, &offset);
-      break;
-      SVM_CASE(RHINO_NODE_BLEND_TEXTURE)
-      svm_rhino_node_blend_texture(kg, sd, stack, node, &offset);
-      break;
-      SVM_CASE(RHINO_NODE_EXPOSURE_TEXTURE)
-      svm_rhino_node_exposure_texture(kg, sd, stack, node, &offset);
-      break;
-      SVM_CASE(RHINO_NODE_FBM_TEXTURE)
-      svm_rhino_node_fbm_texture(kg, sd, stack, node, &offset);
-      break;
-      SVM_CASE(RHINO_NODE_GRID_TEXTURE)
-      svm_rhino_node_grid_texture(kg, sd, stack, node, &offset);
-      break;
-      SVM_CASE(RHINO_NODE_PROJECTION_CHANGER_TEXTURE)
-      svm_rhino_node_projection_changer_texture(kg, sd, stack, node, &offset);
-      break;
-      SVM_CASE(RHINO_NODE_MASK_TEXTURE)
-      svm_rhino_node_mask_texture(kg, sd, stack, node, &offset);
-      break;
-      SVM_CASE(RHINO_NODE_PERLIN_MARBLE_TEXTURE)
-      svm_rhino_node_perlin_marble_texture(kg, sd, stack, node, &offset);
-      break;
-      SVM_CASE(RHINO_NODE_PHYSICAL_SKY_TEXTURE)
-      svm_rhino_node_physical_sky_texture(kg, sd, stack, node, &offset);
-      break;
-      SVM_CASE(RHINO_NODE_TEXTURE_ADJUSTMENT_TEXTURE)
-      svm_rhino_node_texture_adjustment_texture(kg, sd, stack, node, &offset);
-      break;
-      SVM_CASE(RHINO_NODE_TILE_TEXTURE)
-      svm_rhino_node_tile_texture(kg, sd, stack, node, &offset);
-      break;
-      SVM_CASE(RHINO_NODE_DOTS_TEXTURE)
-      svm_rhino_node_dots_texture(kg, sd, stack, node, &offset);
-      break;
-      SVM_CASE(RHINO_NODE_NORMAL_PART1_TEXTURE)
-      svm_rhino_node_normal_part1_texture(kg, sd, stack, node, &offset);
-      break;
-      SVM_CASE(RHINO_NODE_NORMAL_PART2_TEXTURE)
-      svm_rhino_node_normal_part2_texture(kg, sd, stack, node, &offset);
-      break;
-      SVM_CASE(NODE_ATTR_BUMP_DX)
-      IF_KERNEL_NODES_FEATURE(BUMP)
-      {
-        svm_node_attr_bump_dx(kg, sd, stack, node);
-      }
-      break;
-      SVM_CASE(NODE_ATTR_BUMP_DY)
-      IF_KERNEL_NODES_FEATURE(BUMP)
-      {
-        svm_node_attr_bump_dy(kg, sd, stack, node);
-      }
-      break;
-      SVM_CASE(NODE_VERTEX_COLOR_BUMP_DX)
-      IF_KERNEL_NODES_FEATURE(BUMP)
-      {
-        svm_node_vertex_color_bump_dx(kg, sd, stack, node.y, node.z, node.w);
-      }
-      break;
-      SVM_CASE(NODE_VERTEX_COLOR_BUMP_DY)
-      IF_KERNEL_NODES_FEATURE(BUMP)
-      {
-        svm_node_vertex_color_bump_dy(kg, sd, stack, node.y, node.z, node.w);
-      }
-      break;
-      SVM_CASE(NODE_TEX_COORD_BUMP_DX)
-      IF_KERNEL_NODES_FEATURE(BUMP)
-      {
-        offset = svm_node_tex_coord_bump_dx(kg, sd, path_flag, stack, node, offset);
-      }
-      break;
-      SVM_CASE(NODE_TEX_COORD_BUMP_DY)
-      IF_KERNEL_NODES_FEATURE(BUMP)
-      {
-        offset = svm_node_tex_coord_bump_dy(kg, sd, path_flag, stack, node, offset);
-      }
-      break;
-      SVM_CASE(NODE_CLOSURE_SET_NORMAL)
-      IF_KERNEL_NODES_FEATURE(BUMP)
-      {
-        svm_node_set_normal(kg, sd, stack, node.y, node.z);
-      }
-      break;
-      SVM_CASE(NODE_ENTER_BUMP_EVAL)
-      IF_KERNEL_NODES_FEATURE(BUMP_STATE)
-      {
-        svm_node_enter_bump_eval(kg, sd, stack, node.y);
-      }
-      break;
-      SVM_CASE(NODE_LEAVE_BUMP_EVAL)
-      IF_KERNEL_NODES_FEATURE(BUMP_STATE)
-      {
-        svm_node_leave_bump_eval(kg, sd, stack, node.y);
-      }
-      break;
-      SVM_CASE(NODE_HSV)
-      svm_node_hsv(kg, sd, stack, node);
-      break;
-      SVM_CASE(NODE_CLOSURE_HOLDOUT)
-      svm_node_closure_holdout(sd, stack, node);
-      break;
-      SVM_CASE(NODE_FRESNEL)
-      svm_node_fresnel(sd, stack, node.y, node.z, node.w);
-      break;
-      SVM_CASE(NODE_LAYER_WEIGHT)
-      svm_node_layer_weight(sd, stack, node);
-      break;
-      SVM_CASE(NODE_CLOSURE_VOLUME)
-      IF_KERNEL_NODES_FEATURE(VOLUME)
-      {
-        svm_node_closure_volume<type>(kg, sd, stack, node);
-      }
-      break;
-      SVM_CASE(NODE_PRINCIPLED_VOLUME)
-      IF_KERNEL_NODES_FEATURE(VOLUME)
-      {
-        offset = svm_node_principled_volume<type>(kg, sd, stack, node, path_flag, offset);
-      }
-      break;
-      SVM_CASE(NODE_MATH)
-      svm_node_math(kg, sd, stack, node.y, node.z, node.w);
-      break;
-      SVM_CASE(NODE_VECTOR_MATH)
-      offset = svm_node_vector_math(kg, sd, stack, node.y, node.z, node.w, offset);
-      break;
-      SVM_CASE(NODE_RGB_RAMP)
-      offset = svm_node_rgb_ramp(kg, sd, stack, node, offset);
-      break;
-      SVM_CASE(NODE_GAMMA)
-      svm_node_gamma(sd, stack, node.y, node.z, node.w);
-      break;
-      SVM_CASE(NODE_BRIGHTCONTRAST)
-      svm_node_brightness(sd, stack, node.y, node.z, node.w);
-      break;
-      SVM_CASE(NODE_LIGHT_PATH)
-      svm_node_light_path<node_feature_mask>(kg, state, sd, stack, node.y, node.z, path_flag);
-      break;
-      SVM_CASE(NODE_OBJECT_INFO)
-      svm_node_object_info(kg, sd, stack, node.y, node.z);
-      break;
-      SVM_CASE(NODE_PARTICLE_INFO)
-      svm_node_particle_info(kg, sd, stack, node.y, node.z);
+    }
+    SVM_CASE(RHINO_NODE_FUSED_TEX_IMAGE_TEXTURE_ADJUSTMENT)
+    {
+      offset = svm_node_tex_image(kg, sd, stack, node, offset);
+      const uint4 node2 = read_node(kg, &offset);
+      svm_rhino_node_texture_adjustment_texture(kg, sd, stack, node2, &offset);
       break;
+    }
+    SVM_CASE(NODE_ATTR_BUMP_DX)
+    IF_KERNEL_NODES_FEATURE(BUMP)
+    {
+      svm_node_attr_bump_dx(kg, sd, stack, node);
+    }
+    break;
+    SVM_CASE(NODE_ATTR_BUMP_DY)
+    IF_KERNEL_NODES_FEATURE(BUMP)
+    {
+      svm_node_attr_bump_dy(kg, sd, stack, node);
+    }
+    break;
+    SVM_CASE(NODE_VERTEX_COLOR_BUMP_DX)
+    IF_KERNEL_NODES_FEATURE(BUMP)
+    {
+      svm_node_vertex_color_bump_dx(kg, sd, stack, node.y, node.z, node.w);
+    }
+    break;
+    SVM_CASE(NODE_VERTEX_COLOR_BUMP_DY)
+    IF_KERNEL_NODES_FEATURE(BUMP)
+    {
+      svm_node_vertex_color_bump_dy(kg, sd, stack, node.y, node.z, node.w);
+    }
+    break;
+    SVM_CASE(NODE_TEX_COORD_BUMP_DX)
+    IF_KERNEL_NODES_FEATURE(BUMP)
+    {
+      offset = svm_node_tex_coord_bump_dx(kg, sd, path_flag, stack, node, offset);
+    }
+    break;
+    SVM_CASE(NODE_TEX_COORD_BUMP_DY)
+    IF_KERNEL_NODES_FEATURE(BUMP)
+    {
+      offset = svm_node_tex_coord_bump_dy(kg, sd, path_flag, stack, node, offset);
+    }
+    break;
+    SVM_CASE(NODE_CLOSURE_SET_NORMAL)
+    IF_KERNEL_NODES_FEATURE(BUMP)
+    {
+      svm_node_set_normal(kg, sd, stack, node.y, node.z);
+    }
+    break;
+    SVM_CASE(NODE_ENTER_BUMP_EVAL)
+    IF_KERNEL_NODES_FEATURE(BUMP_STATE)
+    {
+      svm_node_enter_bump_eval(kg, sd, stack, node.y);
+    }
+    break;
+    SVM_CASE(NODE_LEAVE_BUMP_EVAL)
+    IF_KERNEL_NODES_FEATURE(BUMP_STATE)
+    {
+      svm_node_leave_bump_eval(kg, sd, stack, node.y);
+    }
+    break;
+    SVM_CASE(NODE_HSV)
+    svm_node_hsv(kg, sd, stack, node);
+    break;
+    SVM_CASE(NODE_CLOSURE_HOLDOUT)
+    svm_node_closure_holdout(sd, stack, node);
+    break;
+    SVM_CASE(NODE_FRESNEL)
+    svm_node_fresnel(sd, stack, node.y, node.z, node.w);
+    break;
+    SVM_CASE(NODE_LAYER_WEIGHT)
+    svm_node_layer_weight(sd, stack, node);
+    break;
+    SVM_CASE(NODE_CLOSURE_VOLUME)
+    IF_KERNEL_NODES_FEATURE(VOLUME)
+    {
+      svm_node_closure_volume<type>(kg, sd, stack, node);
+    }
+    break;
+    SVM_CASE(NODE_PRINCIPLED_VOLUME)
+    IF_KERNEL_NODES_FEATURE(VOLUME)
+    {
+      offset = svm_node_principled_volume<type>(kg, sd, stack, node, path_flag, offset);
+    }
+    break;
+    SVM_CASE(NODE_MATH)
+    svm_node_math(kg, sd, stack, node.y, node.z, node.w);
+    break;
+    SVM_CASE(NODE_VECTOR_MATH)
+    offset = svm_node_vector_math(kg, sd, stack, node.y, node.z, node.w, offset);
+    break;
+    SVM_CASE(NODE_RGB_RAMP)
+    offset = svm_node_rgb_ramp(kg, sd, stack, node, offset);
+    break;
+    SVM_CASE(NODE_GAMMA)
+    svm_node_gamma(sd, stack, node.y, node.z, node.w);
+    break;
+    SVM_CASE(NODE_BRIGHTCONTRAST)
+    svm_node_brightness(sd, stack, node.y, node.z, node.w);
+    break;
+    SVM_CASE(NODE_LIGHT_PATH)
+    svm_node_light_path<node_feature_mask>(kg, state, sd, stack, node.y, node.z, path_flag);
+    break;
+    SVM_CASE(NODE_OBJECT_INFO)
+    svm_node_object_info(kg, sd, stack, node.y, node.z);
+    break;
+    SVM_CASE(NODE_PARTICLE_INFO)
+    svm_node_particle_info(kg, sd, stack, node.y, node.z);
+    break;
 #if defined(__HAIR__)
-      SVM_CASE(NODE_HAIR_INFO)
-      svm_node_hair_info(kg, sd, stack, node.y, node.z);
-      break;
+    SVM_CASE(NODE_HAIR_INFO)
+    svm_node_hair_info(kg, sd, stack, node.y, node.z);
+    break;
 #endif
 #if defined(__POINTCLOUD__)
-      SVM_CASE(NODE_POINT_INFO)
-      svm_node_point_info(kg, sd, stack, node.y, node.z);
-      break;
+    SVM_CASE(NODE_POINT_INFO)
+    svm_node_point_info(kg, sd, stack, node.y, node.z);
+    break;
 #endif
-      SVM_CASE(NODE_TEXTURE_MAPPING)
-      offset = svm_node_texture_mapping(kg, sd, stack, node.y, node.z, offset);
-      break;
-      SVM_CASE(NODE_MAPPING)
-      svm_node_mapping(kg, sd, stack, node.y, node.z, node.w);
-      break;
-      SVM_CASE(NODE_MIN_MAX)
-      offset = svm_node_min_max(kg, sd, stack, node.y, node.z, offset);
-      break;
-      SVM_CASE(NODE_CAMERA)
-      svm_node_camera(kg, sd, stack, node.y, node.z, node.w);
-      break;
-      SVM_CASE(NODE_TEX_ENVIRONMENT)
-      svm_node_tex_environment(kg, sd, stack, node);
-      break;
-      SVM_CASE(NODE_TEX_SKY)
-      offset = svm_node_tex_sky(kg, sd, path_flag, stack, node, offset);
-      break;
-      SVM_CASE(NODE_TEX_GRADIENT)
-      svm_node_tex_gradient(sd, stack, node);
-      break;
-      SVM_CASE(NODE_TEX_VORONOI)
-      offset = svm_node_tex_voronoi<node_feature_mask>(
-          kg, sd, stack, node.y, node.z, node.w, offset);
-      break;
-      SVM_CASE(NODE_TEX_MUSGRAVE)
-      offset = svm_node_tex_musgrave(kg, sd, stack, node.y, node.z, node.w, offset);
-      break;
-      SVM_CASE(NODE_TEX_WAVE)
-      offset = svm_node_tex_wave(kg, sd, stack, node, offset);
-      break;
-      SVM_CASE(NODE_TEX_MAGIC)
-      offset = svm_node_tex_magic(kg, sd, stack, node, offset);
-      break;
-      SVM_CASE(NODE_TEX_CHECKER)
-      svm_node_tex_checker(kg, sd, stack, node);
-      break;
-      SVM_CASE(NODE_TEX_BRICK)
-      offset = svm_node_tex_brick(kg, sd, stack, node, offset);
-      break;
-      SVM_CASE(NODE_TEX_WHITE_NOISE)
-      svm_node_tex_white_noise(kg, sd, stack, node.y, node.z, node.w);
-      break;
-      SVM_CASE(NODE_NORMAL)
-      offset = svm_node_normal(kg, sd, stack, node.y, node.z, node.w, offset);
-      break;
-      SVM_CASE(NODE_LIGHT_FALLOFF)
-      svm_node_light_falloff(sd, stack, node);
-      break;
-      SVM_CASE(NODE_IES)
-      svm_node_ies(kg, sd, stack, node);
-      break;
-      SVM_CASE(NODE_CURVES)
-      offset = svm_node_curves(kg, sd, stack, node, offset);
-      break;
-      SVM_CASE(NODE_FLOAT_CURVE)
-      offset = svm_node_curve(kg, sd, stack, node, offset);
-      break;
-      SVM_CASE(NODE_TANGENT)
-      svm_node_tangent(kg, sd, stack, node);
-      break;
-      SVM_CASE(NODE_NORMAL_MAP)
-      svm_node_normal_map(kg, sd, stack, node);
-      break;
-      SVM_CASE(NODE_INVERT)
-      svm_node_invert(sd, stack, node.y, node.z, node.w);
-      break;
-      SVM_CASE(NODE_MIX)
-      offset = svm_node_mix(kg, sd, stack, node.y, node.z, node.w, offset);
-      break;
-      SVM_CASE(NODE_SEPARATE_COLOR)
-      svm_node_separate_color(kg, sd, stack, node.y, node.z, node.w);
-      break;
-      SVM_CASE(NODE_COMBINE_COLOR)
-      svm_node_combine_color(kg, sd, stack, node.y, node.z, node.w);
-      break;
-      SVM_CASE(NODE_SEPARATE_VECTOR)
-      svm_node_separate_vector(sd, stack, node.y, node.z, node.w);
-      break;
-      SVM_CASE(NODE_COMBINE_VECTOR)
-      svm_node_combine_vector(sd, stack, node.y, node.z, node.w);
-      break;
-      SVM_CASE(NODE_SEPARATE_HSV)
-      offset = svm_node_separate_hsv(kg, sd, stack, node.y, node.z, node.w, offset);
-      break;
-      SVM_CASE(NODE_COMBINE_HSV)
-      offset = svm_node_combine_hsv(kg, sd, stack, node.y, node.z, node.w, offset);
-      break;
-      SVM_CASE(NODE_VECTOR_ROTATE)
-      svm_node_vector_rotate(sd, stack, node.y, node.z, node.w);
-      break;
-      SVM_CASE(NODE_VECTOR_TRANSFORM)
-      svm_node_vector_transform(kg, sd, stack, node);
-      break;
-      SVM_CASE(NODE_WIREFRAME)
-      svm_node_wireframe(kg, sd, stack, node);
-      break;
-      SVM_CASE(NODE_WAVELENGTH)
-      svm_node_wavelength(kg, sd, stack, node.y, node.z);
-      break;
-      SVM_CASE(NODE_BLACKBODY)
-      svm_node_blackbody(kg, sd, stack, node.y, node.z);
-      break;
-      SVM_CASE(NODE_MAP_RANGE)
-      offset = svm_node_map_range(kg, sd, stack, node.y, node.z, node.w, offset);
-      break;
-      SVM_CASE(NODE_VECTOR_MAP_RANGE)
-      offset = svm_node_vector_map_range(kg, sd, stack, node.y, node.z, node.w, offset);
-      break;
-      SVM_CASE(NODE_CLAMP)
-      offset = svm_node_clamp(kg, sd, stack, node.y, node.z, node.w, offset);
-      break;
+    SVM_CASE(NODE_TEXTURE_MAPPING)
+    offset = svm_node_texture_mapping(kg, sd, stack, node.y, node.z, offset);
+    break;
+    SVM_CASE(NODE_MAPPING)
+    svm_node_mapping(kg, sd, stack, node.y, node.z, node.w);
+    break;
+    SVM_CASE(NODE_MIN_MAX)
+    offset = svm_node_min_max(kg, sd, stack, node.y, node.z, offset);
+    break;
+    SVM_CASE(NODE_CAMERA)
+    svm_node_camera(kg, sd, stack, node.y, node.z, node.w);
+    break;
+    SVM_CASE(NODE_TEX_ENVIRONMENT)
+    svm_node_tex_environment(kg, sd, stack, node);
+    break;
+    SVM_CASE(NODE_TEX_SKY)
+    offset = svm_node_tex_sky(kg, sd, path_flag, stack, node, offset);
+    break;
+    SVM_CASE(NODE_TEX_GRADIENT)
+    svm_node_tex_gradient(sd, stack, node);
+    break;
+    SVM_CASE(NODE_TEX_VORONOI)
+    offset = svm_node_tex_voronoi<node_feature_mask>(
+        kg, sd, stack, node.y, node.z, node.w, offset);
+    break;
+    SVM_CASE(NODE_TEX_MUSGRAVE)
+    offset = svm_node_tex_musgrave(kg, sd, stack, node.y, node.z, node.w, offset);
+    break;
+    SVM_CASE(NODE_TEX_WAVE)
+    offset = svm_node_tex_wave(kg, sd, stack, node, offset);
+    break;
+    SVM_CASE(NODE_TEX_MAGIC)
+    offset = svm_node_tex_magic(kg, sd, stack, node, offset);
+    break;
+    SVM_CASE(NODE_TEX_CHECKER)
+    svm_node_tex_checker(kg, sd, stack, node);
+    break;
+    SVM_CASE(NODE_TEX_BRICK)
+    offset = svm_node_tex_brick(kg, sd, stack, node, offset);
+    break;
+    SVM_CASE(NODE_TEX_WHITE_NOISE)
+    svm_node_tex_white_noise(kg, sd, stack, node.y, node.z, node.w);
+    break;
+    SVM_CASE(NODE_NORMAL)
+    offset = svm_node_normal(kg, sd, stack, node.y, node.z, node.w, offset);
+    break;
+    SVM_CASE(NODE_LIGHT_FALLOFF)
+    svm_node_light_falloff(sd, stack, node);
+    break;
+    SVM_CASE(NODE_IES)
+    svm_node_ies(kg, sd, stack, node);
+    break;
+    SVM_CASE(NODE_CURVES)
+    offset = svm_node_curves(kg, sd, stack, node, offset);
+    break;
+    SVM_CASE(NODE_FLOAT_CURVE)
+    offset = svm_node_curve(kg, sd, stack, node, offset);
+    break;
+    SVM_CASE(NODE_TANGENT)
+    svm_node_tangent(kg, sd, stack, node);
+    break;
+    SVM_CASE(NODE_NORMAL_MAP)
+    svm_node_normal_map(kg, sd, stack, node);
+    break;
+    SVM_CASE(NODE_INVERT)
+    svm_node_invert(sd, stack, node.y, node.z, node.w);
+    break;
+    SVM_CASE(NODE_MIX)
+    offset = svm_node_mix(kg, sd, stack, node.y, node.z, node.w, offset);
+    break;
+    SVM_CASE(NODE_SEPARATE_COLOR)
+    svm_node_separate_color(kg, sd, stack, node.y, node.z, node.w);
+    break;
+    SVM_CASE(NODE_COMBINE_COLOR)
+    svm_node_combine_color(kg, sd, stack, node.y, node.z, node.w);
+    break;
+    SVM_CASE(NODE_SEPARATE_VECTOR)
+    svm_node_separate_vector(sd, stack, node.y, node.z, node.w);
+    break;
+    SVM_CASE(NODE_COMBINE_VECTOR)
+    svm_node_combine_vector(sd, stack, node.y, node.z, node.w);
+    break;
+    SVM_CASE(NODE_SEPARATE_HSV)
+    offset = svm_node_separate_hsv(kg, sd, stack, node.y, node.z, node.w, offset);
+    break;
+    SVM_CASE(NODE_COMBINE_HSV)
+    offset = svm_node_combine_hsv(kg, sd, stack, node.y, node.z, node.w, offset);
+    break;
+    SVM_CASE(NODE_VECTOR_ROTATE)
+    svm_node_vector_rotate(sd, stack, node.y, node.z, node.w);
+    break;
+    SVM_CASE(NODE_VECTOR_TRANSFORM)
+    svm_node_vector_transform(kg, sd, stack, node);
+    break;
+    SVM_CASE(NODE_WIREFRAME)
+    svm_node_wireframe(kg, sd, stack, node);
+    break;
+    SVM_CASE(NODE_WAVELENGTH)
+    svm_node_wavelength(kg, sd, stack, node.y, node.z);
+    break;
+    SVM_CASE(NODE_BLACKBODY)
+    svm_node_blackbody(kg, sd, stack, node.y, node.z);
+    break;
+    SVM_CASE(NODE_MAP_RANGE)
+    offset = svm_node_map_range(kg, sd, stack, node.y, node.z, node.w, offset);
+    break;
+    SVM_CASE(NODE_VECTOR_MAP_RANGE)
+    offset = svm_node_vector_map_range(kg, sd, stack, node.y, node.z, node.w, offset);
+    break;
+    SVM_CASE(NODE_CLAMP)
+    offset = svm_node_clamp(kg, sd, stack, node.y, node.z, node.w, offset);
+    break;
 #ifdef __SHADER_RAYTRACE__
-      SVM_CASE(NODE_BEVEL)
-      svm_node_bevel<node_feature_mask>(kg, state, sd, stack, node);
-      break;
-      SVM_CASE(NODE_AMBIENT_OCCLUSION)
-      svm_node_ao<node_feature_mask>(kg, state, sd, stack, node);
-      break;
+    SVM_CASE(NODE_BEVEL)
+    svm_node_bevel<node_feature_mask>(kg, state, sd, stack, node);
+    break;
+    SVM_CASE(NODE_AMBIENT_OCCLUSION)
+    svm_node_ao<node_feature_mask>(kg, state, sd, stack, node);
+    break;
 #endif
 
-      SVM_CASE(NODE_TEX_VOXEL)
-      IF_KERNEL_NODES_FEATURE(VOLUME)
-      {
-        offset = svm_node_tex_voxel(kg, sd, stack, node, offset);
-      }
-      break;
-      SVM_CASE(NODE_AOV_START)
-      if (!svm_node_aov_check(path_flag, render_buffer)) {
-        return;
-      }
-      break;
-      SVM_CASE(NODE_AOV_COLOR)
-      svm_node_aov_color<node_feature_mask>(kg, state, sd, stack, node, render_buffer);
-      break;
-      SVM_CASE(NODE_AOV_VALUE)
-      svm_node_aov_value<node_feature_mask>(kg, state, sd, stack, node, render_buffer);
-      break;
-      SVM_CASE(NODE_MIX_COLOR)
-      svm_node_mix_color(sd, stack, node.y, node.z, node.w);
-      break;
-      SVM_CASE(NODE_MIX_FLOAT)
-      svm_node_mix_float(sd, stack, node.y, node.z, node.w);
-      break;
-      SVM_CASE(NODE_MIX_VECTOR)
-      svm_node_mix_vector(sd, stack, node.y, node.z);
-      break;
-      SVM_CASE(NODE_MIX_VECTOR_NON_UNIFORM)
-      svm_node_mix_vector_non_uniform(sd, stack, node.y, node.z);
-      break;
-      default:
-        kernel_assert(!"Unknown node type was passed to the SVM machine");
-        return;
+    SVM_CASE(NODE_TEX_VOXEL)
+    IF_KERNEL_NODES_FEATURE(VOLUME)
+    {
+      offset = svm_node_tex_voxel(kg, sd, stack, node, offset);
+    }
+    break;
+    SVM_CASE(NODE_AOV_START)
+    if (!svm_node_aov_check(path_flag, render_buffer)) {
+      return false;
+    }
+    break;
+    SVM_CASE(NODE_AOV_COLOR)
+    svm_node_aov_color<node_feature_mask>(kg, state, sd, stack, node, render_buffer);
+    break;
+    SVM_CASE(NODE_AOV_VALUE)
+    svm_node_aov_value<node_feature_mask>(kg, state, sd, stack, node, render_buffer);
+    break;
+    SVM_CASE(NODE_MIX_COLOR)
+    svm_node_mix_color(sd, stack, node.y, node.z, node.w);
+    break;
+    SVM_CASE(NODE_MIX_FLOAT)
+    svm_node_mix_float(sd, stack, node.y, node.z, node.w);
+    break;
+    SVM_CASE(NODE_MIX_VECTOR)
+    svm_node_mix_vector(sd, stack, node.y, node.z);
+    break;
+    SVM_CASE(NODE_MIX_VECTOR_NON_UNIFORM)
+    svm_node_mix_vector_non_uniform(sd, stack, node.y, node.z);
+    break;
+    default:
+      kernel_assert(!"Unknown node type was passed to the SVM machine");
+      return false;
+  }
+
+  return true;
+}
+
+/* Main Interpreter Loop */
+template<uint node_feature_mask, ShaderType type, typename ConstIntegratorGenericState>
+ccl_device void svm_eval_nodes(KernelGlobals kg,
+                               ConstIntegratorGenericState state,
+                               ccl_private ShaderData *sd,
+                               ccl_global float *render_buffer,
+                               uint32_t path_flag)
+{
+#ifndef __KERNEL_GPU__
+  if (svm_eval_specialized<node_feature_mask, type>(kg, state, sd, render_buffer, path_flag)) {
+    return;
+  }
+#endif
+
+  float stack[SVM_STACK_SIZE];
+  int offset = sd->shader & SHADER_MASK;
+
+  while (1) {
+    const uint4 node = read_node(kg, &offset);
+    if (!svm_eval_node<node_feature_mask, type>(
+            kg, state, sd, stack, render_buffer, path_flag, node, offset))
+    {
+      return;
     }
   }
 }
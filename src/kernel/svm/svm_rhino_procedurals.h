@@ -158,10 +158,7 @@ ccl_device float gain_func(float x, float gain)
 
 ccl_device int perlin_noise(KernelGlobals kg, int x)
 {
-  int perlin_noise_value = (int)kernel_data_fetch(lookup_table,
-                                                 kernel_data.tables.rhino_perlin_noise_offset + x);
-
-  return perlin_noise_value;
+  return kernel_data_fetch(rhino_noise_perm, kernel_data.tables.rhino_perlin_noise_offset + x);
 }
 
 ccl_device float gradient(int h, float dx, float dy, float dz)
@@ -246,151 +243,20 @@ ccl_device float noise1(KernelGlobals kg, float x, float y, float z)
   return y0 + wz * (y1 - y0);
 }
 
-ccl_device float noise2(KernelGlobals kg, float x, float y, float z)
+/* Rhino has separate instances of the same noise for some textures. */
+ccl_device_inline float noise2(KernelGlobals kg, float x, float y, float z)
 {
-  float cx = floorf(x);
-  float cy = floorf(y);
-  float cz = floorf(z);
-
-  float dx = x - cx;
-  float dy = y - cy;
-  float dz = z - cz;
-
-  int ix = int(cx) & (RHINO_PERLIN_NOISE_PERM_SIZE - 1);
-  int iy = int(cy) & (RHINO_PERLIN_NOISE_PERM_SIZE - 1);
-  int iz = int(cz) & (RHINO_PERLIN_NOISE_PERM_SIZE - 1);
-
-  int h0 = perlin_noise(kg, ix);
-  int h1 = perlin_noise(kg, ix + 1);
-  int h00 = perlin_noise(kg, h0 + iy) + iz;
-  int h01 = perlin_noise(kg, h1 + iy) + iz;
-  int h10 = perlin_noise(kg, h0 + iy + 1) + iz;
-  int h11 = perlin_noise(kg, h1 + iy + 1) + iz;
-
-  int h000 = perlin_noise(kg, h00) & 15;
-  int h001 = perlin_noise(kg, h01) & 15;
-  int h010 = perlin_noise(kg, h10) & 15;
-  int h011 = perlin_noise(kg, h11) & 15;
-  int h100 = perlin_noise(kg, h00 + 1) & 15;
-  int h101 = perlin_noise(kg, h01 + 1) & 15;
-  int h110 = perlin_noise(kg, h10 + 1) & 15;
-  int h111 = perlin_noise(kg, h11 + 1) & 15;
-
-  float w000 = gradient(h000, dx, dy, dz);
-  float w100 = gradient(h001, dx - 1, dy, dz);
-  float w010 = gradient(h010, dx, dy - 1, dz);
-  float w110 = gradient(h011, dx - 1, dy - 1, dz);
-  float w001 = gradient(h100, dx, dy, dz - 1);
-  float w101 = gradient(h101, dx - 1, dy, dz - 1);
-  float w011 = gradient(h110, dx, dy - 1, dz - 1);
-  float w111 = gradient(h111, dx - 1, dy - 1, dz - 1);
-
-  float wx = noise_weight(dx);
-  float wy = noise_weight(dy);
-  float wz = noise_weight(dz);
-
-  float y0 = w000 + wx * (w100 - w000 + wy * (w110 - w010 + w000 - w100)) + wy * (w010 - w000);
-  float y1 = w001 + wx * (w101 - w001 + wy * (w111 - w011 + w001 - w101)) + wy * (w011 - w001);
-
-  return y0 + wz * (y1 - y0);
+  return noise1(kg, x, y, z);
 }
 
-ccl_device float noise3(KernelGlobals kg, float x, float y, float z)
+ccl_device_inline float noise3(KernelGlobals kg, float x, float y, float z)
 {
-  float cx = floorf(x);
-  float cy = floorf(y);
-  float cz = floorf(z);
-
-  float dx = x - cx;
-  float dy = y - cy;
-  float dz = z - cz;
-
-  int ix = int(cx) & (RHINO_PERLIN_NOISE_PERM_SIZE - 1);
-  int iy = int(cy) & (RHINO_PERLIN_NOISE_PERM_SIZE - 1);
-  int iz = int(cz) & (RHINO_PERLIN_NOISE_PERM_SIZE - 1);
-
-  int h0 = perlin_noise(kg, ix);
-  int h1 = perlin_noise(kg, ix + 1);
-  int h00 = perlin_noise(kg, h0 + iy) + iz;
-  int h01 = perlin_noise(kg, h1 + iy) + iz;
-  int h10 = perlin_noise(kg, h0 + iy + 1) + iz;
-  int h11 = perlin_noise(kg, h1 + iy + 1) + iz;
-
-  int h000 = perlin_noise(kg, h00) & 15;
-  int h001 = perlin_noise(kg, h01) & 15;
-  int h010 = perlin_noise(kg, h10) & 15;
-  int h011 = perlin_noise(kg, h11) & 15;
-  int h100 = perlin_noise(kg, h00 + 1) & 15;
-  int h101 = perlin_noise(kg, h01 + 1) & 15;
-  int h110 = perlin_noise(kg, h10 + 1) & 15;
-  int h111 = perlin_noise(kg, h11 + 1) & 15;
-
-  float w000 = gradient(h000, dx, dy, dz);
-  float w100 = gradient(h001, dx - 1, dy, dz);
-  float w010 = gradient(h010, dx, dy - 1, dz);
-  float w110 = gradient(h011, dx - 1, dy - 1, dz);
-  float w001 = gradient(h100, dx, dy, dz - 1);
-  float w101 = gradient(h101, dx - 1, dy, dz - 1);
-  float w011 = gradient(h110, dx, dy - 1, dz - 1);
-  float w111 = gradient(h111, dx - 1, dy - 1, dz - 1);
-
-  float wx = noise_weight(dx);
-  float wy = noise_weight(dy);
-  float wz = noise_weight(dz);
-
-  float y0 = w000 + wx * (w100 - w000 + wy * (w110 - w010 + w000 - w100)) + wy * (w010 - w000);
-  float y1 = w001 + wx * (w101 - w001 + wy * (w111 - w011 + w001 - w101)) + wy * (w011 - w001);
-
-  return y0 + wz * (y1 - y0);
+  return noise1(kg, x, y, z);
 }
 
-ccl_device float noise4(KernelGlobals kg, float x, float y, float z)
+ccl_device_inline float noise4(KernelGlobals kg, float x, float y, float z)
 {
-  float cx = floorf(x);
-  float cy = floorf(y);
-  float cz = floorf(z);
-
-  float dx = x - cx;
-  float dy = y - cy;
-  float dz = z - cz;
-
-  int ix = int(cx) & (RHINO_PERLIN_NOISE_PERM_SIZE - 1);
-  int iy = int(cy) & (RHINO_PERLIN_NOISE_PERM_SIZE - 1);
-  int iz = int(cz) & (RHINO_PERLIN_NOISE_PERM_SIZE - 1);
-
-  int h0 = perlin_noise(kg, ix);
-  int h1 = perlin_noise(kg, ix + 1);
-  int h00 = perlin_noise(kg, h0 + iy) + iz;
-  int h01 = perlin_noise(kg, h1 + iy) + iz;
-  int h10 = perlin_noise(kg, h0 + iy + 1) + iz;
-  int h11 = perlin_noise(kg, h1 + iy + 1) + iz;
-
-  int h000 = perlin_noise(kg, h00) & 15;
-  int h001 = perlin_noise(kg, h01) & 15;
-  int h010 = perlin_noise(kg, h10) & 15;
-  int h011 = perlin_noise(kg, h11) & 15;
-  int h100 = perlin_noise(kg, h00 + 1) & 15;
-  int h101 = perlin_noise(kg, h01 + 1) & 15;
-  int h110 = perlin_noise(kg, h10 + 1) & 15;
-  int h111 = perlin_noise(kg, h11 + 1) & 15;
-
-  float w000 = gradient(h000, dx, dy, dz);
-  float w100 = gradient(h001, dx - 1, dy, dz);
-  float w010 = gradient(h010, dx, dy - 1, dz);
-  float w110 = gradient(h011, dx - 1, dy - 1, dz);
-  float w001 = gradient(h100, dx, dy, dz - 1);
-  float w101 = gradient(h101, dx - 1, dy, dz - 1);
-  float w011 = gradient(h110, dx, dy - 1, dz - 1);
-  float w111 = gradient(h111, dx - 1, dy - 1, dz - 1);
-
-  float wx = noise_weight(dx);
-  float wy = noise_weight(dy);
-  float wz = noise_weight(dz);
-
-  float y0 = w000 + wx * (w100 - w000 + wy * (w110 - w010 + w000 - w100)) + wy * (w010 - w000);
-  float y1 = w001 + wx * (w101 - w001 + wy * (w111 - w011 + w001 - w101)) + wy * (w011 - w001);
-
-  return y0 + wz * (y1 - y0);
+  return noise1(kg, x, y, z);
 }
 
 ccl_device float value_noise(KernelGlobals kg, float x, float y, float z)
@@ -747,29 +613,33 @@ ccl_device float wards_hermite_noise(float x, float y, float z)
 
 ccl_device int aaltonen_value(KernelGlobals kg, int x)
 {
-  float value = kernel_data_fetch(lookup_table, kernel_data.tables.rhino_aaltonen_noise_offset + x);
-
-  return int(value);
+  return kernel_data_fetch(rhino_noise_perm, kernel_data.tables.rhino_aaltonen_noise_offset + x);
 }
 
-ccl_device float aaltonen_noise(KernelGlobals kg, float x, float y, float z)
+/* Squared radius and its inverse for a value of the permutation table. */
+ccl_device_inline float2 aaltonen_radius(int i)
 {
   // clang-format off
-  float ANsquaredRadius[16] = {
-	  1.5000000f, 1.8262500f, 2.1524999f, 2.4787498f,
+  const float squared_radius[16] = {
+      1.5000000f, 1.8262500f, 2.1524999f, 2.4787498f,
       2.8049998f, 3.1312499f, 1.7175000f, 2.0437498f,
       2.3699999f, 2.6962500f, 3.0224998f, 1.6087500f,
       1.9349999f, 2.2612500f, 2.5874999f, 2.9137497f
   };
 
-  float ANinverseOfSquaredRadius[16] = {
-	  0.66666669f, 0.54757017f, 0.46457610f, 0.40342918f,
+  const float inverse_squared_radius[16] = {
+      0.66666669f, 0.54757017f, 0.46457610f, 0.40342918f,
       0.35650626f, 0.31936130f, 0.58224165f, 0.48929667f,
       0.42194095f, 0.37088549f, 0.33085197f, 0.62160063f,
       0.51679587f, 0.44223326f, 0.38647345f, 0.34320039f
   };
   // clang-format on
 
+  return make_float2(squared_radius[i], inverse_squared_radius[i]);
+}
+
+ccl_device float aaltonen_noise(KernelGlobals kg, float x, float y, float z)
+{
 #define maxRadius 1.8f
 #define maxRadiusInt 1
 
@@ -803,8 +673,9 @@ ccl_device float aaltonen_noise(KernelGlobals kg, float x, float y, float z)
         float sqdx = dx * dx;
         float dsq = sqdx + sqdydz;
         int prn = aaltonen_value(kg, permY + (ix & 255));
-        if (ANsquaredRadius[prn & 15] >= dsq) {
-          float t = 1.0f - dsq * ANinverseOfSquaredRadius[prn & 15];
+        const float2 radius = aaltonen_radius(prn & 15);
+        if (radius.x >= dsq) {
+          float t = 1.0f - dsq * radius.y;
           if ((prn & 128) == 128)
             result -= t;
           else
@@ -817,63 +688,433 @@ ccl_device float aaltonen_noise(KernelGlobals kg, float x, float y, float z)
   return result / 10.333334f;
 }
 
-ccl_device float4 noise_texture(KernelGlobals kg,
-                                float3 uvw,
-                                float4 color1,
-                                float4 color2,
-                                RhinoProceduralNoiseType noise_type,
-                                RhinoProceduralSpecSynthType spec_synth_type,
-                                int octave_count,
-                                float frequency_multiplier,
-                                float amplitude_multiplier,
-                                float clamp_min,
-                                float clamp_max,
-                                bool scale_to_clamp,
-                                bool inverse,
-                                float gain)
+ccl_device float noise_texture_value(
+    KernelGlobals kg, RhinoProceduralNoiseType noise_type, float x, float y, float z)
+{
+  switch (noise_type) {
+    case RHINO_NOISE_PERLIN:
+      return noise1(kg, x, y, z);
+    case RHINO_NOISE_VALUE_NOISE:
+      return value_noise(kg, x, y, z);
+    case RHINO_NOISE_PERLIN_PLUS_VALUE:
+      return 0.5f * value_noise(kg, x, y, z) + 0.5f * noise2(kg, x, y, z);
+    case RHINO_NOISE_SIMPLEX:
+      return simplex_noise(x, y, z);
+    case RHINO_NOISE_SPARSE_CONVOLUTION:
+      return sparse_convolution_noise(kg, x, y, z);
+    case RHINO_NOISE_LATTICE_CONVOLUTION:
+      return lattice_convolution_noise(kg, x, y, z);
+    case RHINO_NOISE_WARDS_HERMITE:
+      return wards_hermite_noise(x, y, z);
+    case RHINO_NOISE_AALTONEN:
+      return aaltonen_noise(kg, x, y, z);
+    default:
+      return 0.0f;
+  }
+}
+
+/* SIMD Noise
+ *
+ * Evaluate the noise at four points at once, one point per lane. The octaves of the noise
+ * textures are independent, so evaluating them together overlaps their chains of dependent table
+ * lookups. Every lane performs the same operations in the same order as the scalar functions
+ * above, and gives the same result. Divisions are by a float4, as dividing by a float multiplies
+ * by the reciprocal. */
+#if defined(__KERNEL_SSE__)
+
+ccl_device_inline int4 perlin_noise(KernelGlobals kg, const int4 x)
 {
-  float4 color_out = make_float4(0.0f, 0.0f, 0.0f, 1.0f);
+  const int offset = kernel_data.tables.rhino_perlin_noise_offset;
+  return make_int4(kernel_data_fetch(rhino_noise_perm, offset + x.x),
+                   kernel_data_fetch(rhino_noise_perm, offset + x.y),
+                   kernel_data_fetch(rhino_noise_perm, offset + x.z),
+                   kernel_data_fetch(rhino_noise_perm, offset + x.w));
+}
+
+ccl_device_inline int4 aaltonen_value(KernelGlobals kg, const int4 x)
+{
+  const int offset = kernel_data.tables.rhino_aaltonen_noise_offset;
+  return make_int4(kernel_data_fetch(rhino_noise_perm, offset + x.x),
+                   kernel_data_fetch(rhino_noise_perm, offset + x.y),
+                   kernel_data_fetch(rhino_noise_perm, offset + x.z),
+                   kernel_data_fetch(rhino_noise_perm, offset + x.w));
+}
+
+/* Hash of the lattice point, SCNINDEX and VCNINDEX. */
+ccl_device_inline int4 perlin_noise_index(KernelGlobals kg,
+                                          const int4 ix,
+                                          const int4 iy,
+                                          const int4 iz)
+{
+  const int mask = RHINO_PERLIN_NOISE_PERM_SIZE - 1;
+  return perlin_noise(kg, (ix + perlin_noise(kg, (iy + perlin_noise(kg, iz & mask)) & mask)) & mask);
+}
+
+ccl_device_inline float4 gradient(const int4 h, const float4 dx, const float4 dy, const float4 dz)
+{
+  /* 12 and 13 are the only values without the second bit set which pick other coordinates. */
+  const int4 h12 = (h == 12) | (h == 13);
+  const float4 u = select((h < 8) | h12, dx, dy);
+  const float4 v = select((h < 4) | h12, dy, dz);
+  /* Negate u if the first bit is set, and v if the second bit is set. */
+  return (u ^ cast((h & 1) << 31)) + (v ^ cast((h & 2) << 30));
+}
+
+ccl_device_inline float4 noise_weight(const float4 t)
+{
+  return t * t * t * (t * (6.0f * t - 15.0f) + 10.0f);
+}
+
+ccl_device float4 noise1(KernelGlobals kg, const float4 x, const float4 y, const float4 z)
+{
+  const float4 cx = floor(x);
+  const float4 cy = floor(y);
+  const float4 cz = floor(z);
+
+  const float4 dx = x - cx;
+  const float4 dy = y - cy;
+  const float4 dz = z - cz;
+
+  const int4 ix = make_int4(cx) & (RHINO_PERLIN_NOISE_PERM_SIZE - 1);
+  const int4 iy = make_int4(cy) & (RHINO_PERLIN_NOISE_PERM_SIZE - 1);
+  const int4 iz = make_int4(cz) & (RHINO_PERLIN_NOISE_PERM_SIZE - 1);
+  const int4 one = make_int4(1);
+
+  const int4 h0 = perlin_noise(kg, ix);
+  const int4 h1 = perlin_noise(kg, ix + one);
+  const int4 h00 = perlin_noise(kg, h0 + iy) + iz;
+  const int4 h01 = perlin_noise(kg, h1 + iy) + iz;
+  const int4 h10 = perlin_noise(kg, h0 + iy + one) + iz;
+  const int4 h11 = perlin_noise(kg, h1 + iy + one) + iz;
+
+  const int4 h000 = perlin_noise(kg, h00) & 15;
+  const int4 h001 = perlin_noise(kg, h01) & 15;
+  const int4 h010 = perlin_noise(kg, h10) & 15;
+  const int4 h011 = perlin_noise(kg, h11) & 15;
+  const int4 h100 = perlin_noise(kg, h00 + one) & 15;
+  const int4 h101 = perlin_noise(kg, h01 + one) & 15;
+  const int4 h110 = perlin_noise(kg, h10 + one) & 15;
+  const int4 h111 = perlin_noise(kg, h11 + one) & 15;
+
+  const float4 w000 = gradient(h000, dx, dy, dz);
+  const float4 w100 = gradient(h001, dx - 1.0f, dy, dz);
+  const float4 w010 = gradient(h010, dx, dy - 1.0f, dz);
+  const float4 w110 = gradient(h011, dx - 1.0f, dy - 1.0f, dz);
+  const float4 w001 = gradient(h100, dx, dy, dz - 1.0f);
+  const float4 w101 = gradient(h101, dx - 1.0f, dy, dz - 1.0f);
+  const float4 w011 = gradient(h110, dx, dy - 1.0f, dz - 1.0f);
+  const float4 w111 = gradient(h111, dx - 1.0f, dy - 1.0f, dz - 1.0f);
+
+  const float4 wx = noise_weight(dx);
+  const float4 wy = noise_weight(dy);
+  const float4 wz = noise_weight(dz);
+
+  const float4 y0 = w000 + wx * (w100 - w000 + wy * (w110 - w010 + w000 - w100)) +
+                    wy * (w010 - w000);
+  const float4 y1 = w001 + wx * (w101 - w001 + wy * (w111 - w011 + w001 - w101)) +
+                    wy * (w011 - w001);
+
+  return y0 + wz * (y1 - y0);
+}
+
+ccl_device_inline float4 value_noise_corner(KernelGlobals kg,
+                                            const int4 ix,
+                                            const int4 iy,
+                                            const int4 iz)
+{
+  const int4 prn = perlin_noise(
+      kg, perlin_noise(kg, perlin_noise(kg, perlin_noise(kg, ix & 255) + (iy & 255)) + (iz & 255)));
+  return 2.0f * (make_float4(prn) / make_float4(255.0f)) + -1.0f;
+}
+
+ccl_device float4 value_noise(KernelGlobals kg, const float4 x, const float4 y, const float4 z)
+{
+  const float4 cx = floor(x);
+  const float4 cy = floor(y);
+  const float4 cz = floor(z);
+
+  const float4 dx = x - cx;
+  const float4 dy = y - cy;
+  const float4 dz = z - cz;
+
+  const int4 ix = make_int4(cx);
+  const int4 iy = make_int4(cy);
+  const int4 iz = make_int4(cz);
+  const int4 one = make_int4(1);
+
+  const float4 prn000 = value_noise_corner(kg, ix, iy, iz);
+  const float4 prn001 = value_noise_corner(kg, ix, iy, iz + one);
+  const float4 prn010 = value_noise_corner(kg, ix, iy + one, iz);
+  const float4 prn011 = value_noise_corner(kg, ix, iy + one, iz + one);
+  const float4 prn100 = value_noise_corner(kg, ix + one, iy, iz);
+  const float4 prn101 = value_noise_corner(kg, ix + one, iy, iz + one);
+  const float4 prn110 = value_noise_corner(kg, ix + one, iy + one, iz);
+  const float4 prn111 = value_noise_corner(kg, ix + one, iy + one, iz + one);
 
+  const float4 wx = (2.0f * dx - 3.0f) * dx * dx + 1.0f;
+  const float4 wy = (2.0f * dy - 3.0f) * dy * dy + 1.0f;
+  const float4 wz = (2.0f * dz - 3.0f) * dz * dz + 1.0f;
+  const float4 one_wx = one_float4() - wx;
+  const float4 one_wy = one_float4() - wy;
+  const float4 one_wz = one_float4() - wz;
+
+  const float4 prn00X = prn000 * wz + prn001 * one_wz;
+  const float4 prn01X = prn010 * wz + prn011 * one_wz;
+  const float4 prn10X = prn100 * wz + prn101 * one_wz;
+  const float4 prn11X = prn110 * wz + prn111 * one_wz;
+
+  const float4 prn0XX = prn00X * wy + prn01X * one_wy;
+  const float4 prn1XX = prn10X * wy + prn11X * one_wy;
+
+  return prn0XX * wx + prn1XX * one_wx;
+}
+
+ccl_device_inline float4 catrom2(float4 d)
+{
+  const float4 one = one_float4();
+
+  float4 factor = select(d < make_float4(4.0f), zero_float4(), one);
+  d = (one - factor) * d + factor;
+
+  d = d * float(SAMPRATE) + 0.5f;
+  const int4 i = make_int4(floor(d));
+
+  const float4 x = sqrt(make_float4(i) / make_float4(float(SAMPRATE)));
+
+  factor = select(x < one, zero_float4(), one);
+  return (one - factor) * (0.5f * (x * x * (x * 3.0f + -5.0f) + 2.0f)) +
+         factor * (0.5f * (x * (x * (make_float4(5.0f) - x) + -8.0f) + 4.0f));
+}
+
+ccl_device float4 sparse_convolution_noise(KernelGlobals kg,
+                                           const float4 x,
+                                           const float4 y,
+                                           const float4 z)
+{
+  const int4 ix = make_int4(floor(x));
+  const int4 iy = make_int4(floor(y));
+  const int4 iz = make_int4(floor(z));
+
+  const float4 fx = x - make_float4(ix);
+  const float4 fy = y - make_float4(iy);
+  const float4 fz = z - make_float4(iz);
+
+  const int offset = kernel_data.tables.rhino_impulse_noise_offset;
+  float4 sum = zero_float4();
+
+  for (int i = -2; i <= 2; i++) {
+    for (int j = -2; j <= 2; j++) {
+      for (int k = -2; k <= 2; k++) {
+        int4 h = perlin_noise_index(
+            kg, ix + make_int4(i), iy + make_int4(j), iz + make_int4(k));
+
+        for (int n = SCNNIMPULSES; n > 0; n--, h = (h + make_int4(1)) & 255) {
+          /* Impulses are stored as four consecutive floats, transpose them to one per lane. */
+          float4 fpx = load_float4(&kernel_data_fetch(lookup_table, offset + h.x * 4));
+          float4 fpy = load_float4(&kernel_data_fetch(lookup_table, offset + h.y * 4));
+          float4 fpz = load_float4(&kernel_data_fetch(lookup_table, offset + h.z * 4));
+          float4 fpw = load_float4(&kernel_data_fetch(lookup_table, offset + h.w * 4));
+          _MM_TRANSPOSE4_PS(fpx.m128, fpy.m128, fpz.m128, fpw.m128);
+
+          const float4 dx = fx - (fpx + float(i));
+          const float4 dy = fy - (fpy + float(j));
+          const float4 dz = fz - (fpz + float(k));
+          const float4 distsq = dx * dx + dy * dy + dz * dz;
+          sum += catrom2(distsq) * fpw;
+        }
+      }
+    }
+  }
+
+  return sum / make_float4(float(SCNNIMPULSES));
+}
+
+ccl_device float4 lattice_convolution_noise(KernelGlobals kg,
+                                            const float4 x,
+                                            const float4 y,
+                                            const float4 z)
+{
+  const int4 ix = make_int4(floor(x));
+  const int4 iy = make_int4(floor(y));
+  const int4 iz = make_int4(floor(z));
+
+  const float4 fx = x - make_float4(ix);
+  const float4 fy = y - make_float4(iy);
+  const float4 fz = z - make_float4(iz);
+
+  const int offset = kernel_data.tables.rhino_vc_noise_offset;
+  float4 sum = zero_float4();
+
+  for (int k = -1; k <= 2; k++) {
+    float4 dz = make_float4(float(k)) - fz;
+    dz = dz * dz;
+
+    for (int j = -1; j <= 2; j++) {
+      float4 dy = make_float4(float(j)) - fy;
+      dy = dy * dy;
+
+      for (int i = -1; i <= 2; i++) {
+        float4 dx = make_float4(float(i)) - fx;
+        dx = dx * dx;
+
+        const int4 h = perlin_noise_index(
+            kg, ix + make_int4(i), iy + make_int4(j), iz + make_int4(k));
+        const float4 noise = make_float4(kernel_data_fetch(lookup_table, offset + h.x),
+                                         kernel_data_fetch(lookup_table, offset + h.y),
+                                         kernel_data_fetch(lookup_table, offset + h.z),
+                                         kernel_data_fetch(lookup_table, offset + h.w));
+        sum += noise * catrom2(dx + dy + dz);
+      }
+    }
+  }
+
+  return sum;
+}
+
+ccl_device float4 aaltonen_noise(KernelGlobals kg, const float4 x, const float4 y, const float4 z)
+{
+  /* Same as ceilf, but without an SSE4.1 instruction for it. */
+  const int4 sx = make_int4(-floor(-(x - maxRadius)));
+  const int4 ex = make_int4(floor(x + maxRadius));
+  const int4 sy = make_int4(-floor(-(y - maxRadius)));
+  const int4 ey = make_int4(floor(y + maxRadius));
+  const int4 sz = make_int4(-floor(-(z - maxRadius)));
+  const int4 ez = make_int4(floor(z + maxRadius));
+
+  /* Lanes with an empty or too large range of lattice points have no noise. Other lanes visit up
+   * to four points along every axis, starting from the first one. */
+  const int4 four = make_int4(4);
+  const int4 valid = (ex < sx + four) & (ex >= sx) & (ey < sy + four) & (ey >= sy) &
+                     (ez < sz + four) & (ez >= sz);
+
+  float4 result = zero_float4();
+  for (int oz = 0; oz < 4; oz++) {
+    const int4 iz = sz + make_int4(oz);
+    const int4 valid_z = valid & (ez >= iz);
+    const float4 dz = make_float4(iz) - z;
+    const float4 sqdz = dz * dz;
+    const int4 permZ = aaltonen_value(kg, iz & 255);
+
+    for (int oy = 0; oy < 4; oy++) {
+      const int4 iy = sy + make_int4(oy);
+      const int4 valid_y = valid_z & (ey >= iy);
+      const float4 dy = make_float4(iy) - y;
+      const float4 sqdy = dy * dy;
+      const float4 sqdydz = sqdy + sqdz;
+      const int4 permY = aaltonen_value(kg, permZ + (iy & 255));
+
+      for (int ox = 0; ox < 4; ox++) {
+        const int4 ix = sx + make_int4(ox);
+        const int4 valid_x = valid_y & (ex >= ix);
+        const float4 dx = make_float4(ix) - x;
+        const float4 sqdx = dx * dx;
+        const float4 dsq = sqdx + sqdydz;
+        const int4 prn = aaltonen_value(kg, permY + (ix & 255));
+
+        const float2 radius_x = aaltonen_radius(prn.x & 15);
+        const float2 radius_y = aaltonen_radius(prn.y & 15);
+        const float2 radius_z = aaltonen_radius(prn.z & 15);
+        const float2 radius_w = aaltonen_radius(prn.w & 15);
+        const float4 squared_radius = make_float4(radius_x.x, radius_y.x, radius_z.x, radius_w.x);
+        const float4 inverse_squared_radius = make_float4(
+            radius_x.y, radius_y.y, radius_z.y, radius_w.y);
+
+        const float4 t = one_float4() - dsq * inverse_squared_radius;
+        const int4 inside = valid_x & (dsq <= squared_radius);
+        const float4 signed_result = select(
+            (prn & 128) == 128, result - t, result + t);
+        result = select(inside, signed_result, result);
+      }
+    }
+  }
+
+  return result / make_float4(10.333334f);
+}
+
+/* Value noise on its own is bound by dependent permutation lookups, and the noises without
+ * tables have nothing to share between lanes, so those are faster one point at a time. */
+ccl_device_inline bool noise_texture_has_simd(RhinoProceduralNoiseType noise_type)
+{
+  return noise_type != RHINO_NOISE_VALUE_NOISE && noise_type != RHINO_NOISE_SIMPLEX &&
+         noise_type != RHINO_NOISE_WARDS_HERMITE;
+}
+
+ccl_device float4 noise_texture_value(KernelGlobals kg,
+                                      RhinoProceduralNoiseType noise_type,
+                                      const float4 x,
+                                      const float4 y,
+                                      const float4 z)
+{
+  switch (noise_type) {
+    case RHINO_NOISE_PERLIN:
+      return noise1(kg, x, y, z);
+    case RHINO_NOISE_VALUE_NOISE:
+      return value_noise(kg, x, y, z);
+    case RHINO_NOISE_PERLIN_PLUS_VALUE:
+      return 0.5f * value_noise(kg, x, y, z) + 0.5f * noise1(kg, x, y, z);
+    case RHINO_NOISE_SPARSE_CONVOLUTION:
+      return sparse_convolution_noise(kg, x, y, z);
+    case RHINO_NOISE_LATTICE_CONVOLUTION:
+      return lattice_convolution_noise(kg, x, y, z);
+    case RHINO_NOISE_AALTONEN:
+      return aaltonen_noise(kg, x, y, z);
+    default:
+      return make_float4(noise_texture_value(kg, noise_type, x.x, y.x, z.x),
+                         noise_texture_value(kg, noise_type, x.y, y.y, z.y),
+                         noise_texture_value(kg, noise_type, x.z, y.z, z.z),
+                         noise_texture_value(kg, noise_type, x.w, y.w, z.w));
+  }
+}
+
+#endif /* __KERNEL_SSE__ */
+
+/* Weighted average of the octaves of the noise. */
+ccl_device float noise_texture_octaves(KernelGlobals kg,
+                                       float3 uvw,
+                                       RhinoProceduralNoiseType noise_type,
+                                       RhinoProceduralSpecSynthType spec_synth_type,
+                                       int octave_count,
+                                       float frequency_multiplier,
+                                       float amplitude_multiplier)
+{
   float total_value = 0.0;
   float freq = 1.0;
   float weight = 1.0;
   float total_weight = 0.0;
 
+#if defined(__KERNEL_SSE__)
+  float4 octave_values = zero_float4();
+  bool use_octave_values = false;
+#endif
+
   for (int o = 0; o < octave_count; o++) {
     float fo = float(o);
-    float value = 0.0;
     float x = uvw.x * freq + fo;
     float y = uvw.y * freq + fo * 2.0f;
     float z = uvw.z * freq - fo;
 
-    switch (noise_type) {
-      case RHINO_NOISE_PERLIN:
-        value = noise1(kg, x, y, z);
-        break;
-      case RHINO_NOISE_VALUE_NOISE:
-        value = value_noise(kg, x, y, z);
-        break;
-      case RHINO_NOISE_PERLIN_PLUS_VALUE:
-        value = 0.5f * value_noise(kg, x, y, z) + 0.5f * noise2(kg, x, y, z);
-        break;
-      case RHINO_NOISE_SIMPLEX:
-        value = simplex_noise(x, y, z);
-        break;
-      case RHINO_NOISE_SPARSE_CONVOLUTION:
-        value = sparse_convolution_noise(kg, x, y, z);
-        break;
-      case RHINO_NOISE_LATTICE_CONVOLUTION:
-        value = lattice_convolution_noise(kg, x, y, z);
-        break;
-      case RHINO_NOISE_WARDS_HERMITE:
-        value = wards_hermite_noise(x, y, z);
-        break;
-      case RHINO_NOISE_AALTONEN:
-        value = aaltonen_noise(kg, x, y, z);
-        break;
-      default:
-        break;
+#if defined(__KERNEL_SSE__)
+    /* Evaluate the next four octaves at once, unless only one is left. */
+    if ((o & 3) == 0) {
+      use_octave_values = (octave_count - o > 1) && noise_texture_has_simd(noise_type);
+      if (use_octave_values) {
+        float4 octave_x = zero_float4(), octave_y = zero_float4(), octave_z = zero_float4();
+        float octave_freq = freq;
+        for (int i = 0; i < min(octave_count - o, 4); i++) {
+          float octave_fo = float(o + i);
+          octave_x[i] = uvw.x * octave_freq + octave_fo;
+          octave_y[i] = uvw.y * octave_freq + octave_fo * 2.0f;
+          octave_z[i] = uvw.z * octave_freq - octave_fo;
+          octave_freq *= frequency_multiplier;
+        }
+        octave_values = noise_texture_value(kg, noise_type, octave_x, octave_y, octave_z);
+      }
     }
+    float value = (use_octave_values) ? octave_values[o & 3] :
+                                        noise_texture_value(kg, noise_type, x, y, z);
+#else
+    float value = noise_texture_value(kg, noise_type, x, y, z);
+#endif
 
     if (spec_synth_type == RHINO_SPEC_SYNTH_TURBULENCE && (value < 0.0f))
       value = -value;
@@ -888,6 +1129,34 @@ ccl_device float4 noise_texture(KernelGlobals kg,
   if (total_weight > 0.0f)
     total_value /= total_weight;
 
+  return total_value;
+}
+
+ccl_device float4 noise_texture(KernelGlobals kg,
+                                float3 uvw,
+                                float4 color1,
+                                float4 color2,
+                                RhinoProceduralNoiseType noise_type,
+                                RhinoProceduralSpecSynthType spec_synth_type,
+                                int octave_count,
+                                float frequency_multiplier,
+                                float amplitude_multiplier,
+                                float clamp_min,
+                                float clamp_max,
+                                bool scale_to_clamp,
+                                bool inverse,
+                                float gain)
+{
+  float4 color_out = make_float4(0.0f, 0.0f, 0.0f, 1.0f);
+
+  float total_value = noise_texture_octaves(kg,
+                                            uvw,
+                                            noise_type,
+                                            spec_synth_type,
+                                            octave_count,
+                                            frequency_multiplier,
+                                            amplitude_multiplier);
+
   if (spec_synth_type == RHINO_SPEC_SYNTH_TURBULENCE)
     total_value = 2.0f * total_value - 1.0f;
 
@@ -1518,9 +1787,36 @@ ccl_device void svm_rhino_node_exposure_texture(
 ccl_device float fbm(KernelGlobals kg, float3 P, bool is_turbulent, float omega, int maxOctaves)
 {
   float sum = 0.0f, lambda = 1.0f, o = 1.0f;
+#if defined(__KERNEL_SSE__)
+  float4 octave_values = zero_float4();
+  bool use_octave_values = false;
+#endif
+
   for (int i = 0; i < maxOctaves; ++i) {
     float3 lambda_p = lambda * P;
+
+#if defined(__KERNEL_SSE__)
+    /* Evaluate the next four octaves at once, unless only one is left. */
+    if ((i & 3) == 0) {
+      use_octave_values = (maxOctaves - i > 1);
+      if (use_octave_values) {
+        float4 x = zero_float4(), y = zero_float4(), z = zero_float4();
+        float octave_lambda = lambda;
+        for (int j = 0; j < min(maxOctaves - i, 4); j++) {
+          float3 octave_p = octave_lambda * P;
+          x[j] = octave_p.x;
+          y[j] = octave_p.y;
+          z[j] = octave_p.z;
+          octave_lambda *= 1.99f;
+        }
+        octave_values = noise1(kg, x, y, z);
+      }
+    }
+    float noise_value = (use_octave_values) ? octave_values[i & 3] :
+                                              noise3(kg, lambda_p.x, lambda_p.y, lambda_p.z);
+#else
     float noise_value = noise3(kg, lambda_p.x, lambda_p.y, lambda_p.z);
+#endif
 
     if (is_turbulent)
       noise_value = fabsf(noise_value);
@@ -2504,11 +2800,37 @@ ccl_device float4 perlin_marble_texture(KernelGlobals kg,
   float totalValue = 0.0f;
   float freq = 1.0f;
   float weight = noise_amount;
+#if defined(__KERNEL_SSE__)
+  float4 octave_values = zero_float4();
+  bool use_octave_values = false;
+#endif
+
   for (int o = 0; o < levels; o++) {
     float x = uvw.x * freq + float(o);
     float y = uvw.y * freq + float(o) * 2.0f;
     float z = uvw.z * freq - float(o);
+
+#if defined(__KERNEL_SSE__)
+    /* Evaluate the next four octaves at once, unless only one is left. */
+    if ((o & 3) == 0) {
+      use_octave_values = (levels - o > 1);
+      if (use_octave_values) {
+        float4 octave_x = zero_float4(), octave_y = zero_float4(), octave_z = zero_float4();
+        float octave_freq = freq;
+        for (int i = 0; i < min(levels - o, 4); i++) {
+          octave_x[i] = uvw.x * octave_freq + float(o + i);
+          octave_y[i] = uvw.y * octave_freq + float(o + i) * 2.0f;
+          octave_z[i] = uvw.z * octave_freq - float(o + i);
+          octave_freq *= 2.17f;
+        }
+        octave_values = noise1(kg, octave_x * size, octave_y * size, octave_z * size);
+      }
+    }
+    float value = (use_octave_values) ? octave_values[o & 3] :
+                                        noise4(kg, x * size, y * size, z * size);
+#else
     float value = noise4(kg, x * size, y * size, z * size);
+#endif
     totalValue += weight * value;
     freq *= 2.17f;
     weight *= 0.5f;
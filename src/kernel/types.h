@@ -45,6 +45,10 @@ CCL_NAMESPACE_BEGIN
 #define INTEGRATOR_SHADOW_ISECT_SIZE_CPU 1024U
 #define INTEGRATOR_SHADOW_ISECT_SIZE_GPU 4U
 
+/* Number of levels of the block hierarchy of adaptive sampling, the blocks of each level are
+ * twice the size of the blocks of the level below. */
+#define ADAPTIVE_SAMPLING_BLOCK_LEVELS 3
+
 #define RHINO_PERLIN_NOISE_PERM_SIZE 256
 #define RHINO_PERLIN_NOISE_TABLE_SIZE (2 * RHINO_PERLIN_NOISE_PERM_SIZE)
 
@@ -418,6 +422,9 @@ typedef enum PassType {
   PASS_GUIDING_PROBABILITY,
   /* The avg. roughness at the first bounce. */
   PASS_GUIDING_AVG_ROUGHNESS,
+  /* Average time in microseconds spent on a sample of the pixel, to find expensive parts of the
+   * image. Only written when rendering on the CPU. */
+  PASS_RENDER_TIME,
   PASS_CATEGORY_DATA_END = 63,
 
   PASS_BAKE_PRIMITIVE,
@@ -1200,10 +1207,12 @@ typedef enum KernelBVHLayout {
 
 typedef struct KernelTables {
   int filter_table_offset;
+  /* Offsets in rhino_noise_perm. */
   int rhino_perlin_noise_offset;
+  int rhino_aaltonen_noise_offset;
+  /* Offsets in lookup_table. */
   int rhino_impulse_noise_offset;
   int rhino_vc_noise_offset;
-  int rhino_aaltonen_noise_offset;
   int rhino_dots_tree_data_offset;
   int rhino_dots_dot_data_offset;
   int pad;
@@ -1304,6 +1313,19 @@ typedef struct KernelObject {
 } KernelObject;
 static_assert_align(KernelObject, 16);
 
+/* Coarse grid of cells of a volume object with a bit set for cells that contain volume data,
+ * to skip empty space when ray marching. Cells are stored row by row along x, 32 per uint. */
+typedef struct KernelVolumeOccupancy {
+  /* World space to cell space, where cells are unit cubes. */
+  Transform itfm;
+  /* Offset into the volume_occupancy array, -1 if the object has no occupancy grid. */
+  int offset;
+  int resolution_x;
+  int resolution_y;
+  int resolution_z;
+} KernelVolumeOccupancy;
+static_assert_align(KernelVolumeOccupancy, 16);
+
 typedef struct KernelCurve {
   int shader_id;
   int first_key;
@@ -1572,6 +1594,7 @@ typedef enum DeviceKernel : int {
 #undef DECLARE_FILM_CONVERT_KERNEL
 
   DEVICE_KERNEL_ADAPTIVE_SAMPLING_CONVERGENCE_CHECK,
+  DEVICE_KERNEL_ADAPTIVE_SAMPLING_CONVERGENCE_CHECK_BLOCK,
   DEVICE_KERNEL_ADAPTIVE_SAMPLING_CONVERGENCE_FILTER_X,
   DEVICE_KERNEL_ADAPTIVE_SAMPLING_CONVERGENCE_FILTER_Y,
 
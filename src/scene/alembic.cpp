@@ -15,6 +15,8 @@
 #include "util/foreach.h"
 #include "util/log.h"
 #include "util/progress.h"
+#include "util/task.h"
+#include "util/tbb.h"
 #include "util/transform.h"
 #include "util/vector.h"
 
@@ -96,6 +98,7 @@ void CachedData::clear()
   }
 
   attributes.clear();
+  is_animated = false;
 }
 
 CachedData::CachedAttribute &CachedData::add_attribute(const ustring &name,
@@ -456,7 +459,7 @@ bool AlembicObject::has_data_loaded() const
 }
 
 void AlembicObject::load_data_in_cache(CachedData &cached_data,
-                                       AlembicProcedural *proc,
+                                       const CacheLoadParams &params,
                                        IPolyMeshSchema &schema,
                                        Progress &progress)
 {
@@ -475,9 +478,9 @@ void AlembicObject::load_data_in_cache(CachedData &cached_data,
   data.face_indices = schema.getFaceIndicesProperty();
   data.normals = schema.getNormalsParam();
   data.num_samples = schema.getNumSamples();
-  data.shader_face_sets = parse_face_sets_for_shader_assignment(schema, get_used_shaders());
+  data.shader_face_sets = parse_face_sets_for_shader_assignment(schema, params.used_shaders);
 
-  read_geometry_data(proc, cached_data, data, progress);
+  read_geometry_data(cached_data, data, progress);
 
   if (progress.get_cancel()) {
     return;
@@ -486,18 +489,17 @@ void AlembicObject::load_data_in_cache(CachedData &cached_data,
   /* Use the schema as the base compound property to also be able to look for top level properties.
    */
   read_attributes(
-      proc, cached_data, schema, schema.getUVsParam(), get_requested_attributes(), progress);
+      cached_data, schema, schema.getUVsParam(), params.requested_attributes, progress);
 
   if (progress.get_cancel()) {
     return;
   }
 
   cached_data.invalidate_last_loaded_time(true);
-  data_loaded = true;
 }
 
 void AlembicObject::load_data_in_cache(CachedData &cached_data,
-                                       AlembicProcedural *proc,
+                                       const CacheLoadParams &params,
                                        ISubDSchema &schema,
                                        Progress &progress)
 {
@@ -508,7 +510,7 @@ void AlembicObject::load_data_in_cache(CachedData &cached_data,
 
   cached_data.clear();
 
-  if (this->get_ignore_subdivision()) {
+  if (params.ignore_subdivision) {
     PolyMeshSchemaData data;
     data.topology_variance = schema.getTopologyVariance();
     data.time_sampling = schema.getTimeSampling();
@@ -517,9 +519,9 @@ void AlembicObject::load_data_in_cache(CachedData &cached_data,
     data.face_indices = schema.getFaceIndicesProperty();
     data.num_samples = schema.getNumSamples();
     data.velocities = schema.getVelocitiesProperty();
-    data.shader_face_sets = parse_face_sets_for_shader_assignment(schema, get_used_shaders());
+    data.shader_face_sets = parse_face_sets_for_shader_assignment(schema, params.used_shaders);
 
-    read_geometry_data(proc, cached_data, data, progress);
+    read_geometry_data(cached_data, data, progress);
 
     if (progress.get_cancel()) {
       return;
@@ -528,10 +530,9 @@ void AlembicObject::load_data_in_cache(CachedData &cached_data,
     /* Use the schema as the base compound property to also be able to look for top level
      * properties. */
     read_attributes(
-        proc, cached_data, schema, schema.getUVsParam(), get_requested_attributes(), progress);
+        cached_data, schema, schema.getUVsParam(), params.requested_attributes, progress);
 
     cached_data.invalidate_last_loaded_time(true);
-    data_loaded = true;
     return;
   }
 
@@ -553,9 +554,9 @@ void AlembicObject::load_data_in_cache(CachedData &cached_data,
   data.holes = schema.getHolesProperty();
   data.subdivision_scheme = schema.getSubdivisionSchemeProperty();
   data.velocities = schema.getVelocitiesProperty();
-  data.shader_face_sets = parse_face_sets_for_shader_assignment(schema, get_used_shaders());
+  data.shader_face_sets = parse_face_sets_for_shader_assignment(schema, params.used_shaders);
 
-  read_geometry_data(proc, cached_data, data, progress);
+  read_geometry_data(cached_data, data, progress);
 
   if (progress.get_cancel()) {
     return;
@@ -564,14 +565,13 @@ void AlembicObject::load_data_in_cache(CachedData &cached_data,
   /* Use the schema as the base compound property to also be able to look for top level properties.
    */
   read_attributes(
-      proc, cached_data, schema, schema.getUVsParam(), get_requested_attributes(), progress);
+      cached_data, schema, schema.getUVsParam(), params.requested_attributes, progress);
 
   cached_data.invalidate_last_loaded_time(true);
-  data_loaded = true;
 }
 
 void AlembicObject::load_data_in_cache(CachedData &cached_data,
-                                       AlembicProcedural *proc,
+                                       const CacheLoadParams &params,
                                        const ICurvesSchema &schema,
                                        Progress &progress)
 {
@@ -594,10 +594,10 @@ void AlembicObject::load_data_in_cache(CachedData &cached_data,
   data.topology_variance = schema.getTopologyVariance();
   data.num_samples = schema.getNumSamples();
   data.num_vertices = schema.getNumVerticesProperty();
-  data.default_radius = proc->get_default_radius();
-  data.radius_scale = get_radius_scale();
+  data.default_radius = params.default_radius;
+  data.radius_scale = params.radius_scale;
 
-  read_geometry_data(proc, cached_data, data, progress);
+  read_geometry_data(cached_data, data, progress);
 
   if (progress.get_cancel()) {
     return;
@@ -606,10 +606,96 @@ void AlembicObject::load_data_in_cache(CachedData &cached_data,
   /* Use the schema as the base compound property to also be able to look for top level properties.
    */
   read_attributes(
-      proc, cached_data, schema, schema.getUVsParam(), get_requested_attributes(), progress);
+      cached_data, schema, schema.getUVsParam(), params.requested_attributes, progress);
 
   cached_data.invalidate_last_loaded_time(true);
-  data_loaded = true;
+}
+
+void AlembicObject::load_data_in_cache(CachedData &cached_data,
+                                       const CacheLoadParams &params,
+                                       const IPointsSchema &schema,
+                                       Progress &progress)
+{
+  /* Only load data for the original Geometry. */
+  if (instance_of) {
+    return;
+  }
+
+  cached_data.clear();
+
+  PointsSchemaData data;
+  data.positions = schema.getPositionsProperty();
+  data.radiuses = schema.getWidthsParam();
+  data.velocities = schema.getVelocitiesProperty();
+  data.time_sampling = schema.getTimeSampling();
+  data.num_samples = schema.getNumSamples();
+  data.default_radius = params.default_radius;
+  data.radius_scale = params.radius_scale;
+
+  read_geometry_data(cached_data, data, progress);
+
+  if (progress.get_cancel()) {
+    return;
+  }
+
+  /* Use the schema as the base compound property to also be able to look for top level properties.
+   */
+  read_attributes(cached_data, schema, IV2fGeomParam(), params.requested_attributes, progress);
+
+  cached_data.invalidate_last_loaded_time(true);
+}
+
+void AlembicObject::load_cache(CachedData &cached_data,
+                               const CacheLoadParams &params,
+                               Progress &progress)
+{
+  if (schema_type == POLY_MESH) {
+    IPolyMesh polymesh(iobject, Alembic::Abc::kWrapExisting);
+    IPolyMeshSchema schema = polymesh.getSchema();
+    load_data_in_cache(cached_data, params, schema, progress);
+  }
+  else if (schema_type == CURVES) {
+    ICurves curves(iobject, Alembic::Abc::kWrapExisting);
+    ICurvesSchema schema = curves.getSchema();
+    load_data_in_cache(cached_data, params, schema, progress);
+  }
+  else if (schema_type == POINTS) {
+    IPoints points(iobject, Alembic::Abc::kWrapExisting);
+    IPointsSchema schema = points.getSchema();
+    load_data_in_cache(cached_data, params, schema, progress);
+  }
+  else if (schema_type == SUBD) {
+    ISubD subd_mesh(iobject, Alembic::Abc::kWrapExisting);
+    ISubDSchema schema = subd_mesh.getSchema();
+    load_data_in_cache(cached_data, params, schema, progress);
+  }
+}
+
+void AlembicObject::load_cache_attributes(const CacheLoadParams &params, Progress &progress)
+{
+  if (schema_type == POLY_MESH) {
+    IPolyMesh polymesh(iobject, Alembic::Abc::kWrapExisting);
+    IPolyMeshSchema schema = polymesh.getSchema();
+    read_attributes(
+        cached_data_, schema, schema.getUVsParam(), params.requested_attributes, progress);
+  }
+  else if (schema_type == SUBD) {
+    ISubD subd_mesh(iobject, Alembic::Abc::kWrapExisting);
+    ISubDSchema schema = subd_mesh.getSchema();
+    read_attributes(
+        cached_data_, schema, schema.getUVsParam(), params.requested_attributes, progress);
+  }
+}
+
+CacheLoadParams AlembicObject::get_cache_load_params(AlembicProcedural *proc)
+{
+  CacheLoadParams params;
+  params.used_shaders = get_used_shaders();
+  params.requested_attributes = get_requested_attributes();
+  params.ignore_subdivision = get_ignore_subdivision();
+  params.default_radius = proc->get_default_radius();
+  params.radius_scale = get_radius_scale();
+  return params;
 }
 
 void AlembicObject::setup_transform_cache(CachedData &cached_data, float scale)
@@ -745,6 +831,7 @@ NODE_DEFINE(AlembicProcedural)
 
   SOCKET_BOOLEAN(use_prefetch, "Use Prefetch", true);
   SOCKET_INT(prefetch_cache_size, "Prefetch Cache Size", 4096);
+  SOCKET_INT(prefetch_window, "Prefetch Window", 0);
 
   return type;
 }
@@ -757,6 +844,8 @@ AlembicProcedural::AlembicProcedural() : Procedural(get_node_type())
 
 AlembicProcedural::~AlembicProcedural()
 {
+  cancel_prefetch();
+
   ccl::set<Geometry *> geometries_set;
   ccl::set<Object *> objects_set;
   ccl::set<AlembicObject *> abc_objects_set;
@@ -830,9 +919,33 @@ void AlembicProcedural::generate(Scene *scene, Progress &progress)
     return;
   }
 
+  /* The data loaded in the background is only used if nothing but the frame changed. */
+  if (need_shader_updates || need_data_updates || filepath_is_modified() ||
+      layers_is_modified() || objects_is_modified() || default_radius_is_modified() ||
+      prefetch_cache_size_is_modified()) {
+    cancel_prefetch();
+  }
+
+  /* The windows of frames are laid out differently, so all the data needs to be reloaded. */
+  if (use_prefetch_is_modified() || prefetch_window_is_modified() || start_frame_is_modified() ||
+      end_frame_is_modified() || frame_rate_is_modified() || frame_offset_is_modified()) {
+    cancel_prefetch();
+
+    for (Node *node : objects) {
+      AlembicObject *object = static_cast<AlembicObject *>(node);
+      object->clear_cache();
+    }
+
+    window_start_frame = 0.0f;
+    window_end_frame = -1.0f;
+    frame_memory_used = 0;
+  }
+
   if (!archive.valid() || filepath_is_modified() || layers_is_modified()) {
     Alembic::AbcCoreFactory::IFactory factory;
     factory.setPolicy(Alembic::Abc::ErrorHandler::kQuietNoopPolicy);
+    /* Objects are loaded from multiple threads. */
+    factory.setOgawaNumStreams(TaskScheduler::max_concurrency());
 
     std::vector<std::string> filenames;
     filenames.push_back(filepath.c_str());
@@ -875,30 +988,6 @@ void AlembicProcedural::generate(Scene *scene, Progress &progress)
     }
   }
 
-  if (use_prefetch_is_modified()) {
-    if (!use_prefetch) {
-      for (Node *node : objects) {
-        AlembicObject *object = static_cast<AlembicObject *>(node);
-        object->clear_cache();
-      }
-    }
-  }
-
-  if (prefetch_cache_size_is_modified()) {
-    /* Check whether the current memory usage fits in the new requested size,
-     * abort the render if it is any higher. */
-    size_t memory_used = 0ul;
-    for (Node *node : objects) {
-      AlembicObject *object = static_cast<AlembicObject *>(node);
-      memory_used += object->get_cached_data().memory_used();
-    }
-
-    if (memory_used > get_prefetch_cache_size_in_bytes()) {
-      progress.set_error("Error: Alembic Procedural memory limit reached");
-      return;
-    }
-  }
-
   build_caches(progress);
 
   foreach (Node *node, objects) {
@@ -910,7 +999,7 @@ void AlembicProcedural::generate(Scene *scene, Progress &progress)
 
     /* skip constant objects */
     if (object->is_constant() && !object->is_modified() && !object->need_shader_update &&
-        !scale_is_modified()) {
+        !object->cache_reloaded && !scale_is_modified()) {
       continue;
     }
 
@@ -928,6 +1017,7 @@ void AlembicProcedural::generate(Scene *scene, Progress &progress)
     }
 
     object->need_shader_update = false;
+    object->cache_reloaded = false;
     object->clear_modified();
   }
 
@@ -1443,81 +1533,250 @@ void AlembicProcedural::walk_hierarchy(
 
 void AlembicProcedural::build_caches(Progress &progress)
 {
-  size_t memory_used = 0;
+  finish_prefetch();
+
+  const chrono_t frame_time = (chrono_t)((frame - frame_offset) / frame_rate);
+
+  /* Start a new window at the current frame if it moved outside of the loaded one. */
+  if (frame < window_start_frame || frame > window_end_frame) {
+    const int num_frames = (use_prefetch) ? get_window_num_frames() : 1;
+    window_start_frame = frame;
+    window_end_frame = min(frame + num_frames - 1, end_frame);
+  }
+
+  /* Gather the objects whose data needs to be loaded, so they can be loaded in parallel. */
+  vector<AlembicObject *> objects_to_load;
+  vector<CacheLoadParams> load_params;
+  vector<bool> load_attributes_only;
 
   for (Node *node : objects) {
     AlembicObject *object = static_cast<AlembicObject *>(node);
 
-    if (progress.get_cancel()) {
-      return;
+    if (object->instance_of || object->schema_type == AlembicObject::INVALID) {
+      continue;
     }
 
-    if (object->schema_type == AlembicObject::POLY_MESH) {
-      if (!object->has_data_loaded()) {
-        IPolyMesh polymesh(object->iobject, Alembic::Abc::kWrapExisting);
-        IPolyMeshSchema schema = polymesh.getSchema();
-        object->load_data_in_cache(object->get_cached_data(), this, schema, progress);
-      }
-      else if (object->need_shader_update) {
-        IPolyMesh polymesh(object->iobject, Alembic::Abc::kWrapExisting);
-        IPolyMeshSchema schema = polymesh.getSchema();
-        read_attributes(this,
-                        object->get_cached_data(),
-                        schema,
-                        schema.getUVsParam(),
-                        object->get_requested_attributes(),
-                        progress);
-      }
-    }
-    else if (object->schema_type == AlembicObject::CURVES) {
-      if (!object->has_data_loaded() || default_radius_is_modified() ||
-          object->radius_scale_is_modified()) {
-        ICurves curves(object->iobject, Alembic::Abc::kWrapExisting);
-        ICurvesSchema schema = curves.getSchema();
-        object->load_data_in_cache(object->get_cached_data(), this, schema, progress);
-      }
+    bool need_load = !object->has_data_loaded() ||
+                     !object->get_cached_data().has_time(frame_time);
+
+    if (object->schema_type == AlembicObject::CURVES ||
+        object->schema_type == AlembicObject::POINTS) {
+      need_load |= default_radius_is_modified() || object->radius_scale_is_modified();
     }
-    else if (object->schema_type == AlembicObject::POINTS) {
-      if (!object->has_data_loaded() || default_radius_is_modified() ||
-          object->radius_scale_is_modified()) {
-        IPoints points(object->iobject, Alembic::Abc::kWrapExisting);
-        IPointsSchema schema = points.getSchema();
-        object->load_data_in_cache(object->get_cached_data(), this, schema, progress);
+
+    const bool need_attributes = !need_load && object->need_shader_update &&
+                                 (object->schema_type == AlembicObject::POLY_MESH ||
+                                  object->schema_type == AlembicObject::SUBD);
+
+    if (need_load || need_attributes) {
+      if (need_load) {
+        set_window(object->get_cached_data(), window_start_frame, window_end_frame);
       }
+
+      objects_to_load.push_back(object);
+      load_params.push_back(object->get_cache_load_params(this));
+      load_attributes_only.push_back(!need_load);
     }
-    else if (object->schema_type == AlembicObject::SUBD) {
-      if (!object->has_data_loaded()) {
-        ISubD subd_mesh(object->iobject, Alembic::Abc::kWrapExisting);
-        ISubDSchema schema = subd_mesh.getSchema();
-        object->load_data_in_cache(object->get_cached_data(), this, schema, progress);
-      }
-      else if (object->need_shader_update) {
-        ISubD subd_mesh(object->iobject, Alembic::Abc::kWrapExisting);
-        ISubDSchema schema = subd_mesh.getSchema();
-        read_attributes(this,
-                        object->get_cached_data(),
-                        schema,
-                        schema.getUVsParam(),
-                        object->get_requested_attributes(),
-                        progress);
-      }
+  }
+
+  parallel_for(blocked_range<size_t>(0, objects_to_load.size(), 1),
+               [&](const blocked_range<size_t> &r) {
+                 for (size_t i = r.begin(); i != r.end(); i++) {
+                   AlembicObject *object = objects_to_load[i];
+
+                   if (load_attributes_only[i]) {
+                     object->load_cache_attributes(load_params[i], progress);
+                   }
+                   else {
+                     object->load_cache(object->get_cached_data(), load_params[i], progress);
+                   }
+                 }
+               });
+
+  if (progress.get_cancel()) {
+    return;
+  }
+
+  for (size_t i = 0; i < objects_to_load.size(); i++) {
+    if (!load_attributes_only[i]) {
+      objects_to_load[i]->data_loaded = true;
+      objects_to_load[i]->cache_reloaded = true;
     }
+  }
+
+  size_t memory_used = 0;
+  size_t animated_memory_used = 0;
+
+  for (Node *node : objects) {
+    AlembicObject *object = static_cast<AlembicObject *>(node);
 
     if (scale_is_modified() || object->get_cached_data().transforms.size() == 0) {
       object->setup_transform_cache(object->get_cached_data(), scale);
     }
 
-    memory_used += object->get_cached_data().memory_used();
+    const size_t object_memory_used = object->get_cached_data().memory_used();
+    memory_used += object_memory_used;
 
-    if (use_prefetch) {
-      if (memory_used > get_prefetch_cache_size_in_bytes()) {
-        progress.set_error("Error: Alembic Procedural memory limit reached");
-        return;
-      }
+    if (object->get_cached_data().is_animated) {
+      animated_memory_used += object_memory_used;
     }
   }
 
+  const size_t window_num_frames = (size_t)(window_end_frame - window_start_frame) + 1;
+  frame_memory_used = animated_memory_used / window_num_frames;
+
+  if (use_prefetch && memory_used > get_prefetch_cache_size_in_bytes()) {
+    VLOG_WARNING << "AlembicProcedural memory usage exceeds the cache size, loading fewer frames "
+                    "at once";
+  }
+
   VLOG_WORK << "AlembicProcedural memory usage : " << string_human_readable_size(memory_used);
+
+  start_prefetch();
+}
+
+int AlembicProcedural::get_window_num_frames() const
+{
+  /* Until the memory used by a frame is known, only load the current frame. */
+  if (frame_memory_used == 0) {
+    return 1;
+  }
+
+  int num_frames = (prefetch_window > 0) ? prefetch_window : (int)(end_frame - start_frame) + 1;
+
+  /* Leave room for the window which is loaded in the background. */
+  const size_t max_num_frames = get_prefetch_cache_size_in_bytes() / 2 / frame_memory_used;
+  num_frames = (int)min((size_t)num_frames, max_num_frames);
+
+  return max(num_frames, 1);
+}
+
+void AlembicProcedural::set_window(CachedData &cached_data,
+                                   float first_frame,
+                                   float last_frame) const
+{
+  cached_data.start_time = (chrono_t)((first_frame - frame_offset) / frame_rate);
+  cached_data.end_time = (chrono_t)((last_frame + 1.0f - frame_offset) / frame_rate);
+}
+
+void AlembicProcedural::start_prefetch()
+{
+  if (!use_prefetch || window_end_frame >= end_frame || frame_memory_used == 0) {
+    return;
+  }
+
+  /* The next window is already being loaded, it is only used or discarded once the frame moves
+   * out of the current window. */
+  if (!prefetch_objects.empty()) {
+    return;
+  }
+
+  size_t memory_used = 0;
+  for (Node *node : objects) {
+    AlembicObject *object = static_cast<AlembicObject *>(node);
+    memory_used += object->get_cached_data().memory_used();
+  }
+
+  /* Only load the next window if it fits next to the current one, otherwise its data is loaded
+   * when the frame moves past the current window. */
+  const size_t cache_size = get_prefetch_cache_size_in_bytes();
+  if (memory_used >= cache_size) {
+    return;
+  }
+
+  const size_t max_num_frames = (cache_size - memory_used) / frame_memory_used;
+  const int num_frames = (int)min((size_t)get_window_num_frames(), max_num_frames);
+  if (num_frames < 1) {
+    return;
+  }
+
+  prefetch_start_frame = window_end_frame + 1.0f;
+  prefetch_end_frame = min(prefetch_start_frame + num_frames - 1, end_frame);
+
+  /* Constant data is valid for every frame, so only animated objects need to be loaded. */
+  vector<CacheLoadParams> load_params;
+
+  for (Node *node : objects) {
+    AlembicObject *object = static_cast<AlembicObject *>(node);
+
+    if (object->instance_of || !object->has_data_loaded() ||
+        !object->get_cached_data().is_animated) {
+      continue;
+    }
+
+    set_window(object->prefetched_data_, prefetch_start_frame, prefetch_end_frame);
+    prefetch_objects.push_back(object);
+    load_params.push_back(object->get_cache_load_params(this));
+  }
+
+  if (prefetch_objects.empty()) {
+    return;
+  }
+
+  VLOG_WORK << "AlembicProcedural prefetching frames " << prefetch_start_frame << " to "
+            << prefetch_end_frame;
+
+  if (!prefetch_pool) {
+    prefetch_pool = make_unique<DedicatedTaskPool>();
+  }
+
+  prefetch_progress.reset();
+
+  /* The task gets its own copy of the objects, so that it never sees the list change. */
+  Progress &progress = prefetch_progress;
+  prefetch_pool->push([objects = prefetch_objects, load_params, &progress]() {
+    parallel_for(blocked_range<size_t>(0, objects.size(), 1),
+                 [&](const blocked_range<size_t> &r) {
+                   for (size_t i = r.begin(); i != r.end(); i++) {
+                     AlembicObject *object = objects[i];
+                     object->load_cache(object->prefetched_data_, load_params[i], progress);
+                   }
+                 });
+  });
+}
+
+void AlembicProcedural::finish_prefetch()
+{
+  if (prefetch_objects.empty()) {
+    return;
+  }
+
+  /* Keep loading in the background while the frame is still in the current window. */
+  if (frame >= window_start_frame && frame <= window_end_frame) {
+    return;
+  }
+
+  if (frame < prefetch_start_frame || frame > prefetch_end_frame) {
+    cancel_prefetch();
+    return;
+  }
+
+  prefetch_pool->wait();
+
+  for (AlembicObject *object : prefetch_objects) {
+    object->use_prefetched_data();
+  }
+
+  prefetch_objects.clear();
+
+  window_start_frame = prefetch_start_frame;
+  window_end_frame = prefetch_end_frame;
+}
+
+void AlembicProcedural::cancel_prefetch()
+{
+  if (prefetch_objects.empty()) {
+    return;
+  }
+
+  prefetch_progress.set_cancel("Alembic prefetch canceled");
+  prefetch_pool->cancel();
+
+  for (AlembicObject *object : prefetch_objects) {
+    object->prefetched_data_.clear();
+  }
+
+  prefetch_objects.clear();
 }
 
 CCL_NAMESPACE_END
@@ -6,8 +6,10 @@
 #include "graph/node.h"
 #include "scene/attribute.h"
 #include "scene/procedural.h"
+#include "util/progress.h"
 #include "util/set.h"
 #include "util/transform.h"
+#include "util/unique_ptr.h"
 #include "util/vector.h"
 
 #ifdef WITH_ALEMBIC
@@ -18,9 +20,9 @@
 CCL_NAMESPACE_BEGIN
 
 class AlembicProcedural;
+class DedicatedTaskPool;
 class Geometry;
 class Object;
-class Progress;
 class Shader;
 
 using MatrixSampleMap = std::map<Alembic::Abc::chrono_t, Alembic::Abc::M44d>;
@@ -277,9 +279,23 @@ template<typename T> class DataStore {
  private:
   const TimeIndexPair &get_index_for_time(double time) const
   {
-    std::pair<size_t, Alembic::Abc::chrono_t> index_pair;
-    index_pair = time_sampling.getNearIndex(time, index_data_map.size());
-    return index_data_map[index_pair.first];
+    /* The entries are in chronological order, but may only cover a window of the samples of the
+     * time sampling, so look for the nearest entry instead of using the sample index. */
+    auto it = std::lower_bound(
+        index_data_map.begin(),
+        index_data_map.end(),
+        time,
+        [](const TimeIndexPair &pair, double value) { return pair.time < value; });
+
+    if (it == index_data_map.end()) {
+      return index_data_map.back();
+    }
+
+    if (it != index_data_map.begin() && (time - (it - 1)->time) < (it->time - time)) {
+      return *(it - 1);
+    }
+
+    return *it;
   }
 };
 
@@ -331,6 +347,21 @@ struct CachedData {
 
   vector<CachedAttribute> attributes{};
 
+  /* Range of frame times in seconds to load the data for, set before loading. Data for sample
+   * times within [start_time, end_time) is loaded. */
+  double start_time = 0.0;
+  double end_time = 0.0;
+
+  /* Whether any of the loaded data varies over time. If not, the data is valid for all frames
+   * regardless of the range it was loaded for. */
+  bool is_animated = false;
+
+  /* Check whether the data was loaded for the given frame time. */
+  bool has_time(double time) const
+  {
+    return !is_animated || (time >= start_time && time < end_time);
+  }
+
   void clear();
 
   CachedAttribute &add_attribute(const ustring &name,
@@ -345,6 +376,16 @@ struct CachedData {
   size_t memory_used() const;
 };
 
+/* Settings used to load the data of an AlembicObject into a cache. They are gathered on the main
+ * thread, so that the data can be loaded on other threads while the scene is being edited. */
+struct CacheLoadParams {
+  array<Node *> used_shaders;
+  AttributeRequestSet requested_attributes;
+  bool ignore_subdivision = false;
+  float default_radius = 0.0f;
+  float radius_scale = 1.0f;
+};
+
 /* Representation of an Alembic object for the AlembicProcedural.
  *
  * The AlembicObject holds the path to the Alembic IObject inside of the archive that is desired
@@ -387,17 +428,30 @@ class AlembicObject : public Node {
   Object *get_object();
 
   void load_data_in_cache(CachedData &cached_data,
-                          AlembicProcedural *proc,
+                          const CacheLoadParams &params,
                           Alembic::AbcGeom::IPolyMeshSchema &schema,
                           Progress &progress);
   void load_data_in_cache(CachedData &cached_data,
-                          AlembicProcedural *proc,
+                          const CacheLoadParams &params,
                           Alembic::AbcGeom::ISubDSchema &schema,
                           Progress &progress);
   void load_data_in_cache(CachedData &cached_data,
-                          AlembicProcedural *proc,
+                          const CacheLoadParams &params,
                           const Alembic::AbcGeom::ICurvesSchema &schema,
                           Progress &progress);
+  void load_data_in_cache(CachedData &cached_data,
+                          const CacheLoadParams &params,
+                          const Alembic::AbcGeom::IPointsSchema &schema,
+                          Progress &progress);
+
+  /* Load the data for the range of frame times set in the cached data, dispatching on the schema
+   * type. Safe to call from any thread. */
+  void load_cache(CachedData &cached_data, const CacheLoadParams &params, Progress &progress);
+
+  /* Read the attributes newly requested by the shaders into the current cache. */
+  void load_cache_attributes(const CacheLoadParams &params, Progress &progress);
+
+  CacheLoadParams get_cache_load_params(AlembicProcedural *proc);
 
   bool has_data_loaded() const;
 
@@ -435,14 +489,32 @@ class AlembicObject : public Node {
   void clear_cache()
   {
     cached_data_.clear();
+    prefetched_data_.clear();
+    data_loaded = false;
+  }
+
+  /* Replace the current cache with the data that was loaded in the background, the transforms
+   * are kept as they are loaded for the entire animation. */
+  void use_prefetched_data()
+  {
+    prefetched_data_.transforms = std::move(cached_data_.transforms);
+    std::swap(cached_data_, prefetched_data_);
+    prefetched_data_.clear();
+    cache_reloaded = true;
   }
 
   Object *object = nullptr;
 
   bool data_loaded = false;
 
+  /* Set when the cache was replaced, so the data is copied to the nodes even if it is constant. */
+  bool cache_reloaded = false;
+
   CachedData cached_data_;
 
+  /* Data for the next window of frames, loaded in the background while rendering. */
+  CachedData prefetched_data_;
+
   void setup_transform_cache(CachedData &cached_data, float scale);
 
   AttributeRequestSet get_requested_attributes();
@@ -453,9 +525,12 @@ class AlembicObject : public Node {
  * Every object desired to be rendered should be passed as an AlembicObject through the objects
  * socket.
  *
- * This procedural will load the data set for the entire animation in memory on the first frame,
- * and directly set the data for the new frames on the created Nodes if needed. This allows for
- * faster updates between frames as it avoids reseeking the data on disk.
+ * When prefetching, this procedural loads the data for a window of frames starting at the current
+ * frame in memory, and directly sets the data for the new frames on the created Nodes if needed.
+ * This allows for faster updates between frames as it avoids reseeking the data on disk. While a
+ * frame renders, the data for the next window is loaded in the background, so that it is ready
+ * when the frame moves past the current window. The size of the windows is limited so that both
+ * fit in the memory budget of the cache.
  */
 class AlembicProcedural : public Procedural {
   Alembic::AbcGeom::IArchive archive;
@@ -501,10 +576,14 @@ class AlembicProcedural : public Procedural {
   /* Cache controls */
   NODE_SOCKET_API(bool, use_prefetch)
 
-  /* Memory limit for the cache, if the data does not fit within this limit, rendering is aborted.
-   */
+  /* Memory limit for the cache in megabytes, the number of frames kept in memory is reduced to
+   * keep the data within this limit. */
   NODE_SOCKET_API(int, prefetch_cache_size)
 
+  /* Number of frames to load at once when prefetching, starting at the current frame. If zero,
+   * as many frames as fit within the memory limit are loaded. */
+  NODE_SOCKET_API(int, prefetch_window)
+
   AlembicProcedural();
   ~AlembicProcedural();
 
@@ -559,11 +638,41 @@ class AlembicProcedural : public Procedural {
 
   void build_caches(Progress &progress);
 
+  /* Load the data for the next window of frames in the background. */
+  void start_prefetch();
+
+  /* Wait for the data loaded in the background, and use it if the frame moved into its window. */
+  void finish_prefetch();
+
+  /* Stop loading data in the background, and discard the data loaded so far. */
+  void cancel_prefetch();
+
+  /* Number of frames to load in a window, estimated from the memory used by the last one. */
+  int get_window_num_frames() const;
+
+  /* Set the range of frame times to load for the window of frames starting at first_frame. */
+  void set_window(CachedData &cached_data, float first_frame, float last_frame) const;
+
   size_t get_prefetch_cache_size_in_bytes() const
   {
     /* prefetch_cache_size is in megabytes, so convert to bytes. */
     return static_cast<size_t>(prefetch_cache_size) * 1024 * 1024;
   }
+
+  /* Frames of the window the objects' caches were loaded for. */
+  float window_start_frame = 0.0f;
+  float window_end_frame = -1.0f;
+
+  /* Frames of the window being loaded in the background, and the objects it is loaded for. */
+  float prefetch_start_frame = 0.0f;
+  float prefetch_end_frame = -1.0f;
+  vector<AlembicObject *> prefetch_objects;
+
+  /* Estimate of the memory used by the caches for a single frame. */
+  size_t frame_memory_used = 0;
+
+  unique_ptr<DedicatedTaskPool> prefetch_pool;
+  Progress prefetch_progress;
 };
 
 CCL_NAMESPACE_END
@@ -0,0 +1,451 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#include "scene/binary.h"
+
+#include "graph/node_binary.h"
+
+#include "scene/background.h"
+#include "scene/camera.h"
+#include "scene/film.h"
+#include "scene/hair.h"
+#include "scene/integrator.h"
+#include "scene/light.h"
+#include "scene/mesh.h"
+#include "scene/object.h"
+#include "scene/pass.h"
+#include "scene/pointcloud.h"
+#include "scene/scene.h"
+#include "scene/shader.h"
+#include "scene/shader_graph.h"
+#include "scene/shader_nodes.h"
+#include "scene/volume.h"
+
+#include "util/foreach.h"
+#include "util/map.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Chunks in the file, each starting with its identifier. The order in which they are written
+ * ensures node references always point to nodes which have already been read. */
+enum BinaryChunk {
+  BINARY_CHUNK_END = 0,
+  BINARY_CHUNK_INTEGRATOR = 1,
+  BINARY_CHUNK_FILM = 2,
+  BINARY_CHUNK_CAMERA = 3,
+  BINARY_CHUNK_BACKGROUND = 4,
+  BINARY_CHUNK_SHADER = 5,
+  BINARY_CHUNK_GEOMETRY = 6,
+  BINARY_CHUNK_OBJECT = 7,
+  BINARY_CHUNK_LIGHT = 8,
+  BINARY_CHUNK_PASS = 9,
+  BINARY_CHUNK_CLIPPING_PLANES = 10,
+};
+
+/* Which of the default shaders of the scene a shader is. */
+enum BinaryDefaultShader {
+  BINARY_SHADER_NONE = 0,
+  BINARY_SHADER_DEFAULT_SURFACE = 1,
+  BINARY_SHADER_DEFAULT_VOLUME = 2,
+  BINARY_SHADER_DEFAULT_LIGHT = 3,
+  BINARY_SHADER_DEFAULT_BACKGROUND = 4,
+  BINARY_SHADER_DEFAULT_EMPTY = 5,
+};
+
+static Shader **binary_default_shader_slot(Scene *scene, const uint slot)
+{
+  switch (slot) {
+    case BINARY_SHADER_DEFAULT_SURFACE:
+      return &scene->default_surface;
+    case BINARY_SHADER_DEFAULT_VOLUME:
+      return &scene->default_volume;
+    case BINARY_SHADER_DEFAULT_LIGHT:
+      return &scene->default_light;
+    case BINARY_SHADER_DEFAULT_BACKGROUND:
+      return &scene->default_background;
+    case BINARY_SHADER_DEFAULT_EMPTY:
+      return &scene->default_empty;
+  }
+  return nullptr;
+}
+
+/* --------------------------------------------------------------------
+ * Writing.
+ */
+
+static void binary_write_shader_graph(BinaryWriter &writer, ShaderGraph *graph)
+{
+  /* The output node has index zero, other nodes are numbered in the order they are written. */
+  map<const ShaderNode *, uint> node_index;
+  node_index[graph->output()] = 0;
+
+  vector<ShaderNode *> nodes;
+  foreach (ShaderNode *node, graph->nodes) {
+    if (node != graph->output()) {
+      node_index[node] = nodes.size() + 1;
+      nodes.push_back(node);
+    }
+  }
+
+  writer.write_uint(nodes.size());
+  foreach (ShaderNode *node, nodes) {
+    writer.write_string(node->type->name.string());
+    binary_write_node(writer, node);
+  }
+  binary_write_node(writer, graph->output());
+
+  /* Links. */
+  uint num_links = 0;
+  foreach (ShaderNode *node, graph->nodes) {
+    foreach (ShaderInput *input, node->inputs) {
+      if (input->link) {
+        num_links++;
+      }
+    }
+  }
+
+  writer.write_uint(num_links);
+  foreach (ShaderNode *node, graph->nodes) {
+    foreach (ShaderInput *input, node->inputs) {
+      if (input->link) {
+        writer.write_uint(node_index[input->link->parent]);
+        writer.write_string(input->link->name().string());
+        writer.write_uint(node_index[node]);
+        writer.write_string(input->name().string());
+      }
+    }
+  }
+}
+
+static void binary_write_attributes(BinaryWriter &writer, const AttributeSet &attributes)
+{
+  /* Voxel attributes reference images, which can't be stored. */
+  vector<const Attribute *> stored;
+  foreach (const Attribute &attr, attributes.attributes) {
+    if (attr.element != ATTR_ELEMENT_VOXEL) {
+      stored.push_back(&attr);
+    }
+  }
+
+  writer.write_uint(stored.size());
+  foreach (const Attribute *attr, stored) {
+    writer.write_string(attr->name.string());
+    writer.write_uint(attr->std);
+    writer.write_uint(attr->element);
+    writer.write_uint(attr->flags);
+    writer.write_uint(attr->type.basetype);
+    writer.write_uint(attr->type.aggregate);
+    writer.write_uint(attr->type.vecsemantics);
+    writer.write_uint(attr->type.arraylen);
+    writer.write_array(attr->buffer.data(), attr->buffer.size(), 1);
+  }
+}
+
+bool scene_write_binary(Scene *scene, const string &filepath)
+{
+  BinaryWriter writer;
+  if (!writer.open(filepath)) {
+    fprintf(stderr, "Failed to open %s for writing.\n", filepath.c_str());
+    return false;
+  }
+
+  writer.write_uint(BINARY_CHUNK_INTEGRATOR);
+  binary_write_node(writer, scene->integrator);
+  writer.write_uint(BINARY_CHUNK_FILM);
+  binary_write_node(writer, scene->film);
+  writer.write_uint(BINARY_CHUNK_CAMERA);
+  binary_write_node(writer, scene->camera);
+  writer.write_uint(BINARY_CHUNK_BACKGROUND);
+  binary_write_node(writer, scene->background);
+
+  foreach (Shader *shader, scene->shaders) {
+    uint slot = BINARY_SHADER_NONE;
+    for (uint i = BINARY_SHADER_DEFAULT_SURFACE; i <= BINARY_SHADER_DEFAULT_EMPTY; i++) {
+      if (*binary_default_shader_slot(scene, i) == shader) {
+        slot = i;
+      }
+    }
+
+    writer.write_uint(BINARY_CHUNK_SHADER);
+    writer.write_uint(slot);
+    binary_write_node(writer, shader);
+    binary_write_shader_graph(writer, shader->graph);
+  }
+
+  foreach (Geometry *geom, scene->geometry) {
+    writer.write_uint(BINARY_CHUNK_GEOMETRY);
+    writer.write_uint(geom->geometry_type);
+    binary_write_node(writer, geom);
+    binary_write_attributes(writer, geom->attributes);
+    if (geom->is_mesh()) {
+      binary_write_attributes(writer, static_cast<Mesh *>(geom)->subd_attributes);
+    }
+  }
+
+  foreach (Object *object, scene->objects) {
+    writer.write_uint(BINARY_CHUNK_OBJECT);
+    binary_write_node(writer, object);
+  }
+
+  foreach (Light *light, scene->lights) {
+    writer.write_uint(BINARY_CHUNK_LIGHT);
+    binary_write_node(writer, light);
+  }
+
+  foreach (Pass *pass, scene->passes) {
+    /* Automatic passes are added again by the film when the scene is updated. */
+    if (pass->is_auto()) {
+      continue;
+    }
+    writer.write_uint(BINARY_CHUNK_PASS);
+    binary_write_node(writer, pass);
+  }
+
+  if (!scene->clipping_planes.empty()) {
+    writer.write_uint(BINARY_CHUNK_CLIPPING_PLANES);
+    writer.write_array(
+        scene->clipping_planes.data(), scene->clipping_planes.size(), sizeof(float4));
+  }
+
+  writer.write_uint(BINARY_CHUNK_END);
+
+  if (!writer.close()) {
+    fprintf(stderr, "Failed to write %s.\n", filepath.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+/* --------------------------------------------------------------------
+ * Reading.
+ */
+
+static ShaderNode *binary_create_shader_node(const string &name)
+{
+  const NodeType *node_type = NodeType::find(ustring(name));
+
+  if (!node_type) {
+    fprintf(stderr, "Unknown shader node \"%s\".\n", name.c_str());
+    return nullptr;
+  }
+  else if (node_type->type != NodeType::SHADER) {
+    fprintf(stderr, "Node type \"%s\" is not a shader node.\n", node_type->name.c_str());
+    return nullptr;
+  }
+  else if (node_type->create == NULL) {
+    fprintf(stderr, "Can't create abstract node type \"%s\".\n", node_type->name.c_str());
+    return nullptr;
+  }
+
+  return (ShaderNode *)node_type->create(node_type);
+}
+
+static ShaderGraph *binary_read_shader_graph(BinaryReader &reader)
+{
+  ShaderGraph *graph = new ShaderGraph();
+
+  vector<ShaderNode *> nodes;
+  nodes.push_back(graph->output());
+
+  const uint num_nodes = reader.read_uint();
+  for (uint i = 0; i < num_nodes && !reader.has_error(); i++) {
+    ShaderNode *node = binary_create_shader_node(reader.read_string());
+    if (node) {
+      node->set_owner(graph);
+      binary_read_node(reader, node);
+      graph->add(node);
+    }
+    else {
+      binary_skip_node(reader);
+    }
+    nodes.push_back(node);
+  }
+  binary_read_node(reader, graph->output());
+
+  const uint num_links = reader.read_uint();
+  for (uint i = 0; i < num_links && !reader.has_error(); i++) {
+    const uint from_index = reader.read_uint();
+    const ustring from_name(reader.read_string());
+    const uint to_index = reader.read_uint();
+    const ustring to_name(reader.read_string());
+
+    ShaderNode *from_node = (from_index < nodes.size()) ? nodes[from_index] : nullptr;
+    ShaderNode *to_node = (to_index < nodes.size()) ? nodes[to_index] : nullptr;
+    if (!from_node || !to_node) {
+      continue;
+    }
+
+    ShaderOutput *output = from_node->output(from_name);
+    ShaderInput *input = to_node->input(to_name);
+    if (output && input) {
+      graph->connect(output, input);
+    }
+    else {
+      fprintf(stderr,
+              "Invalid link from \"%s\" to \"%s\".\n",
+              from_name.c_str(),
+              to_name.c_str());
+    }
+  }
+
+  return graph;
+}
+
+static void binary_read_shader(BinaryReader &reader, Scene *scene)
+{
+  Shader **default_slot = binary_default_shader_slot(scene, reader.read_uint());
+  Shader *shader = (default_slot) ? *default_slot : scene->create_node<Shader>();
+
+  binary_read_node(reader, shader);
+  shader->set_graph(binary_read_shader_graph(reader));
+  shader->tag_update(scene);
+}
+
+static void binary_read_pass(BinaryReader &reader, Scene *scene)
+{
+  Pass *pass = scene->create_node<Pass>();
+  binary_read_node(reader, pass);
+
+  /* Passes the scene already has, when reading into an existing scene, are not added again. */
+  foreach (const Pass *other, scene->passes) {
+    if (other != pass && other->get_type() == pass->get_type() &&
+        other->get_mode() == pass->get_mode() && other->get_name() == pass->get_name() &&
+        other->get_lightgroup() == pass->get_lightgroup()) {
+      scene->delete_node(pass);
+      return;
+    }
+  }
+}
+
+static void binary_read_attributes(BinaryReader &reader, AttributeSet &attributes)
+{
+  const uint num_attributes = reader.read_uint();
+  for (uint i = 0; i < num_attributes && !reader.has_error(); i++) {
+    const ustring name(reader.read_string());
+    const AttributeStandard std = (AttributeStandard)reader.read_uint();
+    const AttributeElement element = (AttributeElement)reader.read_uint();
+    const uint flags = reader.read_uint();
+
+    TypeDesc type;
+    type.basetype = reader.read_uint();
+    type.aggregate = reader.read_uint();
+    type.vecsemantics = reader.read_uint();
+    type.arraylen = reader.read_uint();
+
+    size_t size;
+    const void *data = reader.read_array(size, 1);
+    if (reader.has_error()) {
+      break;
+    }
+
+    Attribute *attr = attributes.add(name, type, element);
+    attr->std = std;
+    attr->flags = flags;
+    attr->buffer.resize(size);
+    if (size) {
+      memcpy(attr->buffer.data(), data, size);
+    }
+  }
+}
+
+static Geometry *binary_create_geometry(Scene *scene, const uint type)
+{
+  switch (type) {
+    case Geometry::MESH:
+      return scene->create_node<Mesh>();
+    case Geometry::HAIR:
+      return scene->create_node<Hair>();
+    case Geometry::VOLUME:
+      return scene->create_node<Volume>();
+    case Geometry::POINTCLOUD:
+      return scene->create_node<PointCloud>();
+  }
+  return nullptr;
+}
+
+static bool binary_read_geometry(BinaryReader &reader, Scene *scene)
+{
+  const uint type = reader.read_uint();
+  Geometry *geom = binary_create_geometry(scene, type);
+  if (!geom) {
+    fprintf(stderr, "Unknown geometry type %u.\n", type);
+    return false;
+  }
+
+  binary_read_node(reader, geom);
+  binary_read_attributes(reader, geom->attributes);
+  if (geom->is_mesh()) {
+    binary_read_attributes(reader, static_cast<Mesh *>(geom)->subd_attributes);
+  }
+
+  return true;
+}
+
+bool scene_read_binary(Scene *scene, const string &filepath)
+{
+  BinaryReader reader;
+  if (!reader.open(filepath)) {
+    return false;
+  }
+
+  bool ok = true;
+
+  while (ok && !reader.has_error()) {
+    const uint chunk = reader.read_uint();
+    if (chunk == BINARY_CHUNK_END) {
+      break;
+    }
+
+    switch (chunk) {
+      case BINARY_CHUNK_INTEGRATOR:
+        binary_read_node(reader, scene->integrator);
+        break;
+      case BINARY_CHUNK_FILM:
+        binary_read_node(reader, scene->film);
+        break;
+      case BINARY_CHUNK_CAMERA:
+        binary_read_node(reader, scene->camera);
+        break;
+      case BINARY_CHUNK_BACKGROUND:
+        binary_read_node(reader, scene->background);
+        break;
+      case BINARY_CHUNK_SHADER:
+        binary_read_shader(reader, scene);
+        break;
+      case BINARY_CHUNK_GEOMETRY:
+        ok = binary_read_geometry(reader, scene);
+        break;
+      case BINARY_CHUNK_OBJECT:
+        binary_read_node(reader, scene->create_node<Object>());
+        break;
+      case BINARY_CHUNK_LIGHT:
+        binary_read_node(reader, scene->create_node<Light>());
+        break;
+      case BINARY_CHUNK_PASS:
+        binary_read_pass(reader, scene);
+        break;
+      case BINARY_CHUNK_CLIPPING_PLANES: {
+        size_t num;
+        const float4 *planes = (const float4 *)reader.read_array(num, sizeof(float4));
+        scene->clipping_planes.assign(planes, planes + num);
+        scene->object_manager->need_clipping_plane_update = true;
+        break;
+      }
+      default:
+        fprintf(stderr, "Unknown chunk %u in %s.\n", chunk, filepath.c_str());
+        ok = false;
+        break;
+    }
+  }
+
+  if (reader.has_error()) {
+    fprintf(stderr, "Truncated or invalid file %s.\n", filepath.c_str());
+    ok = false;
+  }
+
+  reader.close();
+  return ok;
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,28 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#pragma once
+
+#include "util/string.h"
+
+CCL_NAMESPACE_BEGIN
+
+class Scene;
+
+/* Binary Scene Files
+ *
+ * Stores the shaders, geometry, objects, lights and passes of a scene along with the integrator,
+ * film, camera and background settings, using the binary node container. Geometry arrays are
+ * read straight from the memory mapped file, which makes this much faster to load than XML for
+ * scenes with large meshes.
+ *
+ * Shader graphs are stored as given by the host application, so scenes must be written before
+ * they are rendered for the first time, as rendering simplifies the graphs. Images from
+ * in-memory loaders, OSL nodes, particle systems and procedurals are not stored.
+ *
+ * The scene mutex must be locked by the caller. */
+
+bool scene_write_binary(Scene *scene, const string &filepath);
+bool scene_read_binary(Scene *scene, const string &filepath);
+
+CCL_NAMESPACE_END
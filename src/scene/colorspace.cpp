@@ -5,10 +5,13 @@
 
 #include "util/color.h"
 #include "util/half.h"
+#include "util/hash.h"
 #include "util/image.h"
 #include "util/log.h"
 #include "util/math.h"
+#include "util/string.h"
 #include "util/thread.h"
+#include "util/unique_ptr.h"
 #include "util/vector.h"
 
 #ifdef WITH_OCIO
@@ -25,10 +28,25 @@ ustring u_colorspace_srgb("__builtin_srgb");
 
 /* Cached data. */
 #ifdef WITH_OCIO
+/* Lookup table with the converted values for every value of a 8 or 16 bit pixel format. */
+struct ColorSpaceLUT {
+  /* Converted value of a gray pixel, averaged over the channels, for every input value. */
+  vector<float> gray;
+
+  /* Contribution of every input value of the red, green and blue channels to the converted
+   * color, which is the sum of the contributions. This covers per channel curves followed by a
+   * matrix. Empty if the processor mixes channels in other ways, for example with a 3D LUT. */
+  vector<float4> red;
+  vector<float4> green;
+  vector<float4> blue;
+};
+
 static thread_mutex cache_colorspaces_mutex;
 static thread_mutex cache_processors_mutex;
+static thread_mutex cache_luts_mutex;
 static unordered_map<ustring, ustring, ustringHash> cached_colorspaces;
 static unordered_map<ustring, OCIO::ConstProcessorRcPtr, ustringHash> cached_processors;
+static unordered_map<string, unique_ptr<ColorSpaceLUT>> cached_luts;
 #endif
 
 ColorSpaceProcessor *ColorSpaceManager::get_processor(ustring colorspace)
@@ -304,6 +322,192 @@ inline void processor_apply_pixels_rgba(const OCIO::Processor *processor,
   }
 }
 
+/* Lookup tables are indexed by the bits of the pixel value. */
+template<typename T> inline size_t lut_index(T value)
+{
+  return size_t(value);
+}
+
+/* Build the lookup table for all values of the pixel type T. */
+template<typename T> static unique_ptr<ColorSpaceLUT> lut_build(const OCIO::Processor *processor)
+{
+  const size_t size = size_t(1) << (sizeof(T) * 8);
+
+  OCIO::ConstCPUProcessorRcPtr device_processor = processor->getDefaultCPUProcessor();
+  unique_ptr<ColorSpaceLUT> lut = make_unique<ColorSpaceLUT>();
+
+  /* Convert a gray ramp and a ramp for every channel, with all input values at once. Index 0 has
+   * black, for the offset of the conversion. */
+  vector<float4> ramps((size + 1) * 4, zero_float4());
+  for (size_t i = 0; i < size; i++) {
+    const float value = util_image_cast_to_float(T(i));
+    float4 *ramp = &ramps[(i + 1) * 4];
+    ramp[0] = make_float4(value, value, value, 0.0f);
+    ramp[1].x = value;
+    ramp[2].y = value;
+    ramp[3].z = value;
+  }
+
+  OCIO::PackedImageDesc ramps_desc((float *)ramps.data(), ramps.size(), 1, 4);
+  device_processor->apply(ramps_desc);
+
+  const float4 black = ramps[0];
+
+  lut->gray.resize(size);
+  lut->red.resize(size);
+  lut->green.resize(size);
+  lut->blue.resize(size);
+
+  for (size_t i = 0; i < size; i++) {
+    const float4 *ramp = &ramps[(i + 1) * 4];
+    lut->gray[i] = average(make_float3(ramp[0].x, ramp[0].y, ramp[0].z));
+    /* Include the offset once, in the red contribution. */
+    lut->red[i] = ramp[1];
+    lut->green[i] = ramp[2] - black;
+    lut->blue[i] = ramp[3] - black;
+  }
+
+  /* Verify that the channels are converted independently, by comparing the processor output for
+   * colors with random channel values against the sum of the contributions. Some colors have a
+   * channel set to zero, to also catch crosstalk between primaries. */
+  const int num_colors = 1024;
+  vector<float4> colors(num_colors);
+  vector<float4> expected(num_colors);
+  for (int i = 0; i < num_colors; i++) {
+    T channels[3];
+    for (int c = 0; c < 3; c++) {
+      const uint hash = hash_uint2(i, c);
+      const float value = ((hash >> 16) % 4 == c) ? 0.0f : (hash & 0xffff) / 65535.0f;
+      channels[c] = util_image_cast_from_float<T>(value);
+    }
+
+    colors[i] = make_float4(util_image_cast_to_float(channels[0]),
+                            util_image_cast_to_float(channels[1]),
+                            util_image_cast_to_float(channels[2]),
+                            0.0f);
+    expected[i] = lut->red[lut_index(channels[0])] + lut->green[lut_index(channels[1])] +
+                  lut->blue[lut_index(channels[2])];
+  }
+
+  OCIO::PackedImageDesc colors_desc((float *)colors.data(), num_colors, 1, 4);
+  device_processor->apply(colors_desc);
+
+  for (int i = 0; i < num_colors; i++) {
+    for (int c = 0; c < 3; c++) {
+      if (fabsf(colors[i][c] - expected[i][c]) > 1e-5f + 1e-4f * fabsf(colors[i][c])) {
+        lut->red.clear();
+        lut->green.clear();
+        lut->blue.clear();
+        return lut;
+      }
+    }
+  }
+
+  return lut;
+}
+
+/* Get the lookup table for converting pixels of type T from the colorspace. */
+template<typename T>
+static const ColorSpaceLUT *lut_get(ustring colorspace, const OCIO::Processor *processor)
+{
+  const char *type_name = (std::is_same_v<T, half>) ? "half" :
+                          (std::is_same_v<T, ushort>) ? "ushort" :
+                                                        "uchar";
+  const string key = string_printf("%s:%s", colorspace.c_str(), type_name);
+
+  /* Hold the lock while building, so images using the same colorspace wait for the table
+   * instead of building it again. */
+  thread_scoped_lock cache_luts_lock(cache_luts_mutex);
+  unique_ptr<ColorSpaceLUT> &lut = cached_luts[key];
+  if (!lut) {
+    lut = lut_build<T>(processor);
+    VLOG_INFO << "Colorspace " << colorspace.string() << " lookup table for " << type_name
+              << " pixels "
+              << ((lut->red.empty()) ? "is grayscale only, channels are not independent" :
+                                       "is used for all pixels");
+  }
+
+  return lut.get();
+}
+
+template<typename T, bool compress_as_srgb = false>
+inline void lut_apply_pixels_rgba(const ColorSpaceLUT &lut,
+                                  const OCIO::Processor *processor,
+                                  T *pixels,
+                                  size_t num_pixels)
+{
+  const float4 *red = lut.red.data();
+  const float4 *green = lut.green.data();
+  const float4 *blue = lut.blue.data();
+
+  /* Pixels with alpha are un-associated before conversion, so their values are not in the table.
+   * They are gathered and converted with the processor. */
+  vector<float4> alpha_pixels;
+  vector<size_t> alpha_pixel_indices;
+
+  for (size_t i = 0; i < num_pixels; i++) {
+    T *pixel = pixels + 4 * i;
+    const float alpha = util_image_cast_to_float(pixel[3]);
+
+    if (!(alpha <= 0.0f || alpha == 1.0f)) {
+      float4 value = cast_to_float4(pixel);
+      const float inv_alpha = 1.0f / alpha;
+      value.x *= inv_alpha;
+      value.y *= inv_alpha;
+      value.z *= inv_alpha;
+      alpha_pixels.push_back(value);
+      alpha_pixel_indices.push_back(i);
+      continue;
+    }
+
+    float4 value = red[lut_index(pixel[0])] + green[lut_index(pixel[1])] +
+                   blue[lut_index(pixel[2])];
+    value.w = alpha;
+
+    if (compress_as_srgb) {
+      value = color_linear_to_srgb_v4(value);
+    }
+
+    cast_from_float4(pixel, value);
+  }
+
+  if (alpha_pixels.empty()) {
+    return;
+  }
+
+  OCIO::ConstCPUProcessorRcPtr device_processor = processor->getDefaultCPUProcessor();
+  OCIO::PackedImageDesc desc((float *)alpha_pixels.data(), alpha_pixels.size(), 1, 4);
+  device_processor->apply(desc);
+
+  for (size_t i = 0; i < alpha_pixels.size(); i++) {
+    float4 value = alpha_pixels[i];
+
+    if (compress_as_srgb) {
+      value = color_linear_to_srgb_v4(value);
+    }
+
+    value.x *= value.w;
+    value.y *= value.w;
+    value.z *= value.w;
+
+    cast_from_float4(pixels + 4 * alpha_pixel_indices[i], value);
+  }
+}
+
+template<typename T, bool compress_as_srgb = false>
+inline void lut_apply_pixels_grayscale(const ColorSpaceLUT &lut, T *pixels, size_t num_pixels)
+{
+  const float *gray = lut.gray.data();
+
+  for (size_t i = 0; i < num_pixels; i++) {
+    float f = gray[lut_index(pixels[i])];
+    if (compress_as_srgb) {
+      f = color_linear_to_srgb(f);
+    }
+    pixels[i] = util_image_cast_from_float<T>(f);
+  }
+}
+
 template<typename T, bool compress_as_srgb = false>
 inline void processor_apply_pixels_grayscale(const OCIO::Processor *processor,
                                              T *pixels,
@@ -357,6 +561,29 @@ void ColorSpaceManager::to_scene_linear(
   const OCIO::Processor *processor = (const OCIO::Processor *)get_processor(colorspace);
 
   if (processor) {
+    /* Pixel formats with at most 16 bits have few enough values to convert all of them once. */
+    if constexpr (sizeof(T) <= 2) {
+      const ColorSpaceLUT *lut = lut_get<T>(colorspace, processor);
+      if (is_rgba && !lut->red.empty()) {
+        if (compress_as_srgb) {
+          lut_apply_pixels_rgba<T, true>(*lut, processor, pixels, num_pixels);
+        }
+        else {
+          lut_apply_pixels_rgba<T>(*lut, processor, pixels, num_pixels);
+        }
+        return;
+      }
+      if (!is_rgba) {
+        if (compress_as_srgb) {
+          lut_apply_pixels_grayscale<T, true>(*lut, pixels, num_pixels);
+        }
+        else {
+          lut_apply_pixels_grayscale<T>(*lut, pixels, num_pixels);
+        }
+        return;
+      }
+    }
+
     if (is_rgba) {
       if (compress_as_srgb) {
         /* Compress output as sRGB. */
@@ -439,6 +666,7 @@ void ColorSpaceManager::free_memory()
 #ifdef WITH_OCIO
   map_free_memory(cached_colorspaces);
   map_free_memory(cached_processors);
+  map_free_memory(cached_luts);
 #endif
 }
 
@@ -399,6 +399,9 @@ void Film::device_update(Device *device, DeviceScene *dscene, Scene *scene)
       case PASS_GUIDING_AVG_ROUGHNESS:
         kfilm->pass_guiding_avg_roughness = kfilm->pass_stride;
         break;
+      case PASS_RENDER_TIME:
+        /* Written by the CPU path trace work, not by the kernel. */
+        break;
       default:
         assert(false);
         break;
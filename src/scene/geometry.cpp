@@ -32,6 +32,7 @@
 #include "util/log.h"
 #include "util/progress.h"
 #include "util/task.h"
+#include "util/trace.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -217,6 +218,8 @@ void Geometry::compute_bvh(Device *device,
     vector<Object *> objects;
     objects.push_back(&object);
 
+    TRACE_SCOPE("Geometry BVH", "bvh", name.string());
+
     if (bvh && !need_update_rebuild) {
       progress->set_status(msg, "Refitting BVH");
 
@@ -1273,7 +1276,10 @@ void GeometryManager::device_update_bvh(Device *device,
     bvh = scene->bvh = BVH::create(bparams, scene->geometry, scene->objects, device);
   }
 
-  device->build_bvh(bvh, progress, can_refit);
+  {
+    TRACE_SCOPE("Scene BVH", "bvh");
+    device->build_bvh(bvh, progress, can_refit);
+  }
 
   if (progress.get_cancel()) {
     return;
@@ -13,10 +13,13 @@
 #include "util/image.h"
 #include "util/image_impl.h"
 #include "util/log.h"
+#include "util/md5.h"
 #include "util/path.h"
 #include "util/progress.h"
 #include "util/task.h"
 #include "util/texture.h"
+#include "util/texture_compress.h"
+#include "util/trace.h"
 #include "util/unique_ptr.h"
 
 #ifdef WITH_OSL
@@ -68,6 +71,12 @@ const char *name_from_type(ImageDataType type)
       return "nanovdb_fpn";
     case IMAGE_DATA_TYPE_NANOVDB_FP16:
       return "nanovdb_fp16";
+    case IMAGE_DATA_TYPE_BC1:
+      return "bc1";
+    case IMAGE_DATA_TYPE_BC3:
+      return "bc3";
+    case IMAGE_DATA_TYPE_BC4:
+      return "bc4";
     case IMAGE_DATA_NUM_TYPES:
       assert(!"System enumerator type, should never be used");
       return "";
@@ -76,6 +85,64 @@ const char *name_from_type(ImageDataType type)
   return "";
 }
 
+/* Convert loaded pixels to a storage type with smaller pixels. */
+template<typename StorageType>
+void image_convert_pixels(const ImageDataType storage_type,
+                          const StorageType *pixels,
+                          void *texture_pixels,
+                          const size_t width,
+                          const size_t height,
+                          const size_t depth)
+{
+  if constexpr (std::is_same_v<StorageType, float>) {
+    const size_t num_pixels = width * height * ((depth == 0) ? 1 : depth);
+    const size_t num_values = num_pixels * ((storage_type == IMAGE_DATA_TYPE_HALF4) ? 4 : 1);
+    half *texture_values = (half *)texture_pixels;
+    for (size_t i = 0; i < num_values; i++) {
+      texture_values[i] = util_image_cast_from_float<half>(pixels[i]);
+    }
+  }
+  else if constexpr (std::is_same_v<StorageType, uchar>) {
+    switch (storage_type) {
+      case IMAGE_DATA_TYPE_BC1:
+        texture_compress_bc1(
+            (const uchar4 *)pixels, width, height, (TextureBlockBC1 *)texture_pixels);
+        break;
+      case IMAGE_DATA_TYPE_BC3:
+        texture_compress_bc3(
+            (const uchar4 *)pixels, width, height, (TextureBlockBC3 *)texture_pixels);
+        break;
+      case IMAGE_DATA_TYPE_BC4:
+        texture_compress_bc4(pixels, width, height, (TextureBlockBC4 *)texture_pixels);
+        break;
+      default:
+        assert(!"Unsupported image storage type");
+        break;
+    }
+  }
+  else {
+    assert(!"Unsupported image storage type");
+  }
+}
+
+/* Set a 1x1 pixels image with the color of missing images, converted to the storage type. */
+template<typename StorageType>
+void image_set_missing_pixel(device_texture *mem,
+                             const ImageDataType type,
+                             const StorageType missing_pixel[4])
+{
+  const ImageDataType storage_type = (ImageDataType)mem->info.data_type;
+  void *texture_pixels = mem->alloc(1, 1);
+
+  if (storage_type == type) {
+    const bool is_rgba = (type == IMAGE_DATA_TYPE_FLOAT4 || type == IMAGE_DATA_TYPE_BYTE4);
+    memcpy(texture_pixels, missing_pixel, sizeof(StorageType) * ((is_rgba) ? 4 : 1));
+  }
+  else {
+    image_convert_pixels(storage_type, missing_pixel, texture_pixels, 1, 1, 1);
+  }
+}
+
 }  // namespace
 
 /* Image Handle */
@@ -304,6 +371,11 @@ int ImageLoader::get_tile_number() const
   return 0;
 }
 
+string ImageLoader::content_hash() const
+{
+  return "";
+}
+
 bool ImageLoader::equals(const ImageLoader *a, const ImageLoader *b)
 {
   if (a == NULL && b == NULL) {
@@ -329,12 +401,15 @@ ImageManager::ImageManager(const DeviceInfo &info)
 
   /* Set image limits */
   features.has_nanovdb = info.has_nanovdb;
+  features.has_texture_compression = info.has_texture_compression;
+  features.has_texture_sharing = info.has_texture_sharing;
 }
 
 ImageManager::~ImageManager()
 {
   for (size_t slot = 0; slot < images.size(); slot++)
     assert(!images[slot]);
+  assert(shared_textures.empty());
 }
 
 void ImageManager::set_osl_texture_system(void *texture_system)
@@ -389,6 +464,43 @@ void ImageManager::load_image_metadata(Image *img)
   img->need_metadata = false;
 }
 
+ImageDataType ImageManager::image_storage_type(const Image *img,
+                                               const ImageCompression compression) const
+{
+  const ImageMetaData &metadata = img->metadata;
+
+  if (compression == IMAGE_COMPRESSION_NONE || !features.has_texture_compression) {
+    return metadata.type;
+  }
+  /* Only 2D images, which are not empty. Images that fail to load are replaced by a 1x1 pixels
+   * image, which is converted to the storage type the same way. */
+  if (img->loader->is_vdb_loader() || metadata.depth > 1 || metadata.channels <= 0 ||
+      metadata.width == 0 || metadata.height == 0)
+  {
+    return metadata.type;
+  }
+  if (compression == IMAGE_COMPRESSION_COLOR && metadata.colorspace == u_colorspace_raw) {
+    return metadata.type;
+  }
+
+  switch (metadata.type) {
+    case IMAGE_DATA_TYPE_FLOAT4:
+      return IMAGE_DATA_TYPE_HALF4;
+    case IMAGE_DATA_TYPE_FLOAT:
+      return IMAGE_DATA_TYPE_HALF;
+    case IMAGE_DATA_TYPE_BYTE4: {
+      /* Drop the alpha channel if the image is opaque, for half the size. */
+      const bool has_alpha = (metadata.channels == 2 || metadata.channels >= 4) &&
+                             img->params.alpha_type != IMAGE_ALPHA_IGNORE;
+      return (has_alpha) ? IMAGE_DATA_TYPE_BC3 : IMAGE_DATA_TYPE_BC1;
+    }
+    case IMAGE_DATA_TYPE_BYTE:
+      return IMAGE_DATA_TYPE_BC4;
+    default:
+      return metadata.type;
+  }
+}
+
 ImageHandle ImageManager::add_image(const string &filename, const ImageParams &params)
 {
   const size_t slot = add_image_slot(new OIIOImageLoader(filename), params, false);
@@ -488,6 +600,7 @@ size_t ImageManager::add_image_slot(ImageLoader *loader,
   img->builtin = builtin;
   img->users = 1;
   img->mem = NULL;
+  img->shared = NULL;
 
   images[slot] = img;
 
@@ -521,7 +634,7 @@ void ImageManager::remove_image_user(size_t slot)
     need_update_ = true;
 }
 
-static bool image_associate_alpha(ImageManager::Image *img)
+static bool image_associate_alpha(const ImageManager::Image *img)
 {
   /* For typical RGBA images we let OIIO convert to associated alpha,
    * but some types we want to leave the RGB channels untouched. */
@@ -553,8 +666,13 @@ bool ImageManager::file_load_image(Image *img, int texture_limit)
     return false;
   }
 
+  /* Images stored in another type are converted after loading. */
+  const ImageDataType storage_type = (ImageDataType)img->mem->info.data_type;
+  const bool convert = (storage_type != img->metadata.type);
+  const bool scale = (texture_limit > 0 && max_size > texture_limit);
+
   /* Allocate memory as needed, may be smaller to resize down. */
-  if (texture_limit > 0 && max_size > texture_limit) {
+  if (scale || convert) {
     pixels_storage.resize(((size_t)width) * height * depth * 4);
     pixels = &pixels_storage[0];
   }
@@ -653,7 +771,7 @@ bool ImageManager::file_load_image(Image *img, int texture_limit)
   }
 
   /* Scale image down if needed. */
-  if (pixels_storage.size() > 0) {
+  if (scale) {
     float scale_factor = 1.0f;
     while (max_size * scale_factor > texture_limit) {
       scale_factor *= 0.5f;
@@ -673,19 +791,95 @@ bool ImageManager::file_load_image(Image *img, int texture_limit)
                              &scaled_height,
                              &scaled_depth);
 
-    StorageType *texture_pixels;
+    if (convert) {
+      pixels_storage.swap(scaled_pixels);
+      width = scaled_width;
+      height = scaled_height;
+      depth = scaled_depth;
+    }
+    else {
+      StorageType *texture_pixels;
+
+      {
+        thread_scoped_lock device_lock(device_mutex);
+        texture_pixels = (StorageType *)img->mem->alloc(
+            scaled_width, scaled_height, scaled_depth);
+      }
+
+      memcpy(texture_pixels, &scaled_pixels[0], scaled_pixels.size() * sizeof(StorageType));
+    }
+  }
+
+  /* Convert to the storage type. */
+  if (convert) {
+    void *texture_pixels;
 
     {
       thread_scoped_lock device_lock(device_mutex);
-      texture_pixels = (StorageType *)img->mem->alloc(scaled_width, scaled_height, scaled_depth);
+      texture_pixels = img->mem->alloc(width, height, depth);
+    }
+
+    if (texture_pixels == NULL) {
+      return false;
     }
 
-    memcpy(texture_pixels, &scaled_pixels[0], scaled_pixels.size() * sizeof(StorageType));
+    image_convert_pixels(
+        storage_type, pixels_storage.data(), texture_pixels, width, height, depth);
   }
 
   return true;
 }
 
+/* Reduce the resolution of images that do not fit in the remaining texture memory budget. The
+ * resolution is halved as in file_load_image(), so that the limit results in the same size. */
+static int image_budget_texture_limit(const Stats &stats,
+                                      const ImageMetaData &metadata,
+                                      const device_texture *mem,
+                                      const string &name,
+                                      int texture_limit)
+{
+  const size_t budget = stats.get_mem_budget(MEM_CATEGORY_TEXTURES);
+  if (budget == 0) {
+    return texture_limit;
+  }
+
+  size_t width = metadata.width;
+  size_t height = metadata.height;
+  size_t depth = metadata.depth;
+  size_t max_size = max(max(width, height), depth);
+  if (max_size == 0) {
+    return texture_limit;
+  }
+
+  while (texture_limit > 0 && max_size > size_t(texture_limit)) {
+    width = max(width / 2, size_t(1));
+    height = max(height / 2, size_t(1));
+    depth = max(depth / 2, size_t(1));
+    max_size /= 2;
+  }
+
+  const size_t pixel_size = mem->data_elements * datatype_size(mem->data_type);
+
+  const size_t min_size = 64;
+  size_t budget_max_size = max_size;
+  while (budget_max_size > min_size &&
+         stats.mem_exceeds_budget(MEM_CATEGORY_TEXTURES, width * height * depth * pixel_size))
+  {
+    width = max(width / 2, size_t(1));
+    height = max(height / 2, size_t(1));
+    depth = max(depth / 2, size_t(1));
+    budget_max_size /= 2;
+  }
+
+  if (budget_max_size == max_size) {
+    return texture_limit;
+  }
+
+  VLOG_INFO << "Reducing resolution of " << name << " to " << budget_max_size
+            << " to fit texture memory budget of " << string_human_readable_size(budget);
+  return int(budget_max_size);
+}
+
 void ImageManager::device_load_image(Device *device, Scene *scene, size_t slot, Progress *progress)
 {
   if (progress->get_cancel()) {
@@ -696,67 +890,78 @@ void ImageManager::device_load_image(Device *device, Scene *scene, size_t slot,
 
   progress->set_status("Updating Images", "Loading " + img->loader->name());
 
-  const int texture_limit = scene->params.texture_limit;
+  TRACE_SCOPE("Image Load", "image", img->loader->name());
+
+  int texture_limit = scene->params.texture_limit;
 
   load_image_metadata(img);
   ImageDataType type = img->metadata.type;
+  const ImageDataType storage_type = image_storage_type(img, scene->params.texture_compression);
 
   /* Name for debugging. */
-  img->mem_name = string_printf("tex_image_%s_%03d", name_from_type(type), (int)slot);
+  img->mem_name = string_printf("tex_image_%s_%03d", name_from_type(storage_type), (int)slot);
 
   /* Free previous texture in slot. */
-  if (img->mem) {
-    thread_scoped_lock device_lock(device_mutex);
-    delete img->mem;
-    img->mem = NULL;
-  }
-
-  img->mem = new device_texture(
-      device, img->mem_name.c_str(), slot, type, img->params.interpolation, img->params.extension);
+  device_free_image_memory(img);
+
+  img->mem = new device_texture(device,
+                                img->mem_name.c_str(),
+                                slot,
+                                storage_type,
+                                img->params.interpolation,
+                                img->params.extension);
   img->mem->info.use_transform_3d = img->metadata.use_transform_3d;
   img->mem->info.transform_3d = img->metadata.transform_3d;
 
+  if (!img->loader->is_vdb_loader()) {
+    texture_limit = image_budget_texture_limit(
+        device->stats, img->metadata, img->mem, img->loader->name(), texture_limit);
+  }
+
+  /* Images with identical pixels share memory. Try the hash of the source data first, which
+   * avoids loading the pixels, and then the hash of the pixels once loaded. */
+  const bool use_sharing = features.has_texture_sharing && !img->loader->is_vdb_loader();
+  const string file_key = (use_sharing) ? image_file_key(img, storage_type, texture_limit) : "";
+  const bool is_shared = !file_key.empty() && device_share_image(img, file_key, "");
+
   /* Create new texture. */
-  if (type == IMAGE_DATA_TYPE_FLOAT4) {
+  if (is_shared) {
+    /* Pixels already loaded by another image. */
+  }
+  else if (type == IMAGE_DATA_TYPE_FLOAT4) {
     if (!file_load_image<TypeDesc::FLOAT, float>(img, texture_limit)) {
       /* on failure to load, we set a 1x1 pixels pink image */
+      const float pixels[4] = {
+          TEX_IMAGE_MISSING_R, TEX_IMAGE_MISSING_G, TEX_IMAGE_MISSING_B, TEX_IMAGE_MISSING_A};
       thread_scoped_lock device_lock(device_mutex);
-      float *pixels = (float *)img->mem->alloc(1, 1);
-
-      pixels[0] = TEX_IMAGE_MISSING_R;
-      pixels[1] = TEX_IMAGE_MISSING_G;
-      pixels[2] = TEX_IMAGE_MISSING_B;
-      pixels[3] = TEX_IMAGE_MISSING_A;
+      image_set_missing_pixel(img->mem, type, pixels);
     }
   }
   else if (type == IMAGE_DATA_TYPE_FLOAT) {
     if (!file_load_image<TypeDesc::FLOAT, float>(img, texture_limit)) {
       /* on failure to load, we set a 1x1 pixels pink image */
+      const float pixels[4] = {TEX_IMAGE_MISSING_R, 0.0f, 0.0f, 0.0f};
       thread_scoped_lock device_lock(device_mutex);
-      float *pixels = (float *)img->mem->alloc(1, 1);
-
-      pixels[0] = TEX_IMAGE_MISSING_R;
+      image_set_missing_pixel(img->mem, type, pixels);
     }
   }
   else if (type == IMAGE_DATA_TYPE_BYTE4) {
     if (!file_load_image<TypeDesc::UINT8, uchar>(img, texture_limit)) {
       /* on failure to load, we set a 1x1 pixels pink image */
+      const uchar pixels[4] = {(TEX_IMAGE_MISSING_R * 255),
+                               (TEX_IMAGE_MISSING_G * 255),
+                               (TEX_IMAGE_MISSING_B * 255),
+                               (TEX_IMAGE_MISSING_A * 255)};
       thread_scoped_lock device_lock(device_mutex);
-      uchar *pixels = (uchar *)img->mem->alloc(1, 1);
-
-      pixels[0] = (TEX_IMAGE_MISSING_R * 255);
-      pixels[1] = (TEX_IMAGE_MISSING_G * 255);
-      pixels[2] = (TEX_IMAGE_MISSING_B * 255);
-      pixels[3] = (TEX_IMAGE_MISSING_A * 255);
+      image_set_missing_pixel(img->mem, type, pixels);
     }
   }
   else if (type == IMAGE_DATA_TYPE_BYTE) {
     if (!file_load_image<TypeDesc::UINT8, uchar>(img, texture_limit)) {
       /* on failure to load, we set a 1x1 pixels pink image */
+      const uchar pixels[4] = {(TEX_IMAGE_MISSING_R * 255), 0, 0, 0};
       thread_scoped_lock device_lock(device_mutex);
-      uchar *pixels = (uchar *)img->mem->alloc(1, 1);
-
-      pixels[0] = (TEX_IMAGE_MISSING_R * 255);
+      image_set_missing_pixel(img->mem, type, pixels);
     }
   }
   else if (type == IMAGE_DATA_TYPE_HALF4) {
@@ -813,6 +1018,22 @@ void ImageManager::device_load_image(Device *device, Scene *scene, size_t slot,
   }
 #endif
 
+  if (use_sharing && !is_shared && img->mem->host_pointer) {
+    MD5Hash md5;
+    const uint8_t *data = (const uint8_t *)img->mem->host_pointer;
+    const size_t size = img->mem->memory_size();
+    for (size_t offset = 0; offset < size; offset += INT_MAX) {
+      md5.append(data + offset, (int)min(size - offset, size_t(INT_MAX)));
+    }
+    const string key = string_printf("pixels:%s:%s:%dx%dx%d",
+                                     md5.get_hex().c_str(),
+                                     name_from_type(storage_type),
+                                     (int)img->mem->data_width,
+                                     (int)img->mem->data_height,
+                                     (int)img->mem->data_depth);
+    device_share_image(img, key, file_key);
+  }
+
   {
     thread_scoped_lock device_lock(device_mutex);
     img->mem->copy_to_device();
@@ -839,16 +1060,97 @@ void ImageManager::device_free_image(Device *, size_t slot)
 #endif
   }
 
-  if (img->mem) {
-    thread_scoped_lock device_lock(device_mutex);
-    delete img->mem;
-  }
+  device_free_image_memory(img);
 
   delete img->loader;
   delete img;
   images[slot] = NULL;
 }
 
+/* Key for the pixels an image loads from its source data, which includes the parameters that
+ * affect the pixels but not how they are sampled. */
+string ImageManager::image_file_key(const Image *img,
+                                    const ImageDataType storage_type,
+                                    const int texture_limit) const
+{
+  const string hash = img->loader->content_hash();
+  if (hash.empty()) {
+    return "";
+  }
+
+  return string_printf("file:%s:%s:%s:%d:%d:%d:%d",
+                       hash.c_str(),
+                       name_from_type(storage_type),
+                       img->metadata.colorspace.c_str(),
+                       (int)img->metadata.compress_as_srgb,
+                       (int)img->params.alpha_type,
+                       (int)image_associate_alpha(img),
+                       texture_limit);
+}
+
+/* Use the memory of another image with the same key, or make the memory of this image available
+ * to others if it has pixels. Returns true if the memory of another image is used. The file key
+ * is added to the keys of the memory, so images from the same source data can skip loading. */
+bool ImageManager::device_share_image(Image *img, const string &key, const string &file_key)
+{
+  thread_scoped_lock device_lock(device_mutex);
+
+  SharedTexture *shared;
+  auto it = shared_textures.find(key);
+  if (it != shared_textures.end()) {
+    shared = it->second;
+    img->mem->share_host_memory(*shared->mem);
+    VLOG_WORK << "Sharing pixels of image " << img->loader->name() << " with "
+              << shared->mem->name << ".";
+  }
+  else if (img->mem->host_pointer) {
+    shared = new SharedTexture();
+    shared->mem = img->mem;
+    shared->users = 0;
+    shared->keys.push_back(key);
+    shared_textures[key] = shared;
+  }
+  else {
+    return false;
+  }
+
+  shared->users++;
+  img->shared = shared;
+
+  if (!file_key.empty() && shared_textures.find(file_key) == shared_textures.end()) {
+    shared->keys.push_back(file_key);
+    shared_textures[file_key] = shared;
+  }
+
+  return (shared->mem != img->mem);
+}
+
+void ImageManager::device_free_image_memory(Image *img)
+{
+  thread_scoped_lock device_lock(device_mutex);
+
+  SharedTexture *shared = img->shared;
+  if (shared) {
+    /* Memory that other images still use is kept, until the last of them is freed. */
+    if (img->mem != shared->mem) {
+      delete img->mem;
+    }
+    if (--shared->users == 0) {
+      foreach (const string &key, shared->keys) {
+        shared_textures.erase(key);
+      }
+      delete shared->mem;
+      delete shared;
+    }
+    img->shared = NULL;
+  }
+  else {
+    delete img->mem;
+  }
+
+  img->mem = NULL;
+}
+
 void ImageManager::device_update(Device *device, Scene *scene, Progress &progress)
 {
   if (!need_update()) {
@@ -939,8 +1241,13 @@ void ImageManager::collect_statistics(RenderStats *stats)
       /* Image may have been freed due to lack of users. */
       continue;
     }
-    stats->image.textures.add_entry(
-        NamedSizeEntry(image->loader->name(), image->mem->memory_size()));
+    const NamedSizeEntry entry(image->loader->name(), image->mem->memory_size());
+    if (image->mem->is_host_memory_shared()) {
+      stats->image.shared_textures.add_entry(entry);
+    }
+    else {
+      stats->image.textures.add_entry(entry);
+    }
   }
 }
 
@@ -8,6 +8,7 @@
 
 #include "scene/colorspace.h"
 
+#include "util/map.h"
 #include "util/string.h"
 #include "util/thread.h"
 #include "util/transform.h"
@@ -28,6 +29,23 @@ class Scene;
 class ColorSpaceProcessor;
 class VDBImageLoader;
 
+/* Image Compression
+ *
+ * Storage of textures in memory, trading a small decoding cost for lower memory usage. Float
+ * images are stored as half and 8 bit images block compressed. Images with non-color data, like
+ * normal and displacement maps, are sensitive to the loss of precision and can be excluded. Only
+ * used on devices that support it, 3D images are always stored as loaded. */
+enum ImageCompression {
+  /* Store all images as loaded. */
+  IMAGE_COMPRESSION_NONE = 0,
+  /* Compress color images, store non-color data as loaded. */
+  IMAGE_COMPRESSION_COLOR = 1,
+  /* Compress all images. */
+  IMAGE_COMPRESSION_ALL = 2,
+
+  IMAGE_COMPRESSION_NUM_TYPES,
+};
+
 /* Image Parameters */
 class ImageParams {
  public:
@@ -89,6 +107,8 @@ class ImageMetaData {
 class ImageDeviceFeatures {
  public:
   bool has_nanovdb;
+  bool has_texture_compression;
+  bool has_texture_sharing;
 };
 
 /* Image loader base class, that can be subclassed to load image data
@@ -116,6 +136,10 @@ class ImageLoader {
   /* Optional for tiled textures loaded externally. */
   virtual int get_tile_number() const;
 
+  /* Optional hash of the source data, to share the texture with images loaded from identical
+   * data without loading the pixels again. Empty if not available. */
+  virtual string content_hash() const;
+
   /* Free any memory used for loading metadata and pixels. */
   virtual void cleanup(){};
 
@@ -194,6 +218,15 @@ class ImageManager {
 
   bool need_update() const;
 
+  /* Texture memory shared by images with identical pixels, looked up by content. The memory is
+   * owned by the texture of the image that loaded it first, which is kept until the last image
+   * using it is freed. */
+  struct SharedTexture {
+    device_texture *mem;
+    int users;
+    vector<string> keys;
+  };
+
   struct Image {
     ImageParams params;
     ImageMetaData metadata;
@@ -206,6 +239,8 @@ class ImageManager {
 
     string mem_name;
     device_texture *mem;
+    /* Set if the pixels are shared with other images, mem may then use the memory of another. */
+    SharedTexture *shared;
 
     int users;
     thread_mutex mutex;
@@ -223,11 +258,15 @@ class ImageManager {
   vector<Image *> images;
   void *osl_texture_system;
 
+  /* Protected by device_mutex. */
+  map<string, SharedTexture *> shared_textures;
+
   size_t add_image_slot(ImageLoader *loader, const ImageParams &params, const bool builtin);
   void add_image_user(size_t slot);
   void remove_image_user(size_t slot);
 
   void load_image_metadata(Image *img);
+  ImageDataType image_storage_type(const Image *img, ImageCompression compression) const;
 
   template<TypeDesc::BASETYPE FileFormat, typename StorageType>
   bool file_load_image(Image *img, int texture_limit);
@@ -235,6 +274,10 @@ class ImageManager {
   void device_load_image(Device *device, Scene *scene, size_t slot, Progress *progress);
   void device_free_image(Device *device, size_t slot);
 
+  string image_file_key(const Image *img, ImageDataType storage_type, int texture_limit) const;
+  bool device_share_image(Image *img, const string &key, const string &file_key);
+  void device_free_image_memory(Image *img);
+
   friend class ImageHandle;
 };
 
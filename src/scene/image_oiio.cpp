@@ -5,6 +5,7 @@
 
 #include "util/image.h"
 #include "util/log.h"
+#include "util/md5.h"
 #include "util/path.h"
 
 CCL_NAMESPACE_BEGIN
@@ -241,6 +242,9 @@ bool OIIOImageLoader::load_pixels(const ImageMetaData &metadata,
     case IMAGE_DATA_TYPE_NANOVDB_FLOAT3:
     case IMAGE_DATA_TYPE_NANOVDB_FPN:
     case IMAGE_DATA_TYPE_NANOVDB_FP16:
+    case IMAGE_DATA_TYPE_BC1:
+    case IMAGE_DATA_TYPE_BC3:
+    case IMAGE_DATA_TYPE_BC4:
     case IMAGE_DATA_NUM_TYPES:
       break;
   }
@@ -259,6 +263,16 @@ ustring OIIOImageLoader::osl_filepath() const
   return filepath;
 }
 
+string OIIOImageLoader::content_hash() const
+{
+  /* Reading the file is cheap compared to decoding it, and finds copies of the same file. */
+  MD5Hash md5;
+  if (!md5.append_file(filepath.string())) {
+    return "";
+  }
+  return md5.get_hex();
+}
+
 bool OIIOImageLoader::equals(const ImageLoader &other) const
 {
   const OIIOImageLoader &other_loader = (const OIIOImageLoader &)other;
@@ -24,6 +24,8 @@ class OIIOImageLoader : public ImageLoader {
 
   ustring osl_filepath() const override;
 
+  string content_hash() const override;
+
   bool equals(const ImageLoader &other) const override;
 
  protected:
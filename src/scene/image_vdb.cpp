@@ -4,12 +4,16 @@
 #include "scene/image_vdb.h"
 
 #include "util/log.h"
+#include "util/md5.h"
 #include "util/openvdb.h"
+#include "util/path.h"
+#include "util/time.h"
 
 #ifdef WITH_OPENVDB
 #  include <openvdb/tools/Dense.h>
 #endif
 #ifdef WITH_NANOVDB
+#  include <nanovdb/util/IO.h>
 #  include <nanovdb/util/OpenToNanoVDB.h>
 #endif
 
@@ -51,23 +55,15 @@ struct ToNanoOp {
   {
     if constexpr (!std::is_same_v<GridType, openvdb::MaskGrid>) {
       try {
-        FloatGridType floatgrid(*openvdb::gridConstPtrCast<GridType>(grid));
-        if constexpr (std::is_same_v<FloatGridType, openvdb::FloatGrid>) {
-          if (precision == 0) {
-            nanogrid = nanovdb::openToNanoVDB<nanovdb::HostBuffer,
-                                              typename FloatGridType::TreeType,
-                                              nanovdb::FpN>(floatgrid);
-            return true;
-          }
-          else if (precision == 16) {
-            nanogrid = nanovdb::openToNanoVDB<nanovdb::HostBuffer,
-                                              typename FloatGridType::TreeType,
-                                              nanovdb::Fp16>(floatgrid);
-            return true;
-          }
+        /* Only copy the grid if it needs to be converted to another type, which is slow for
+         * large grids. The conversion to NanoVDB itself is threaded. */
+        if constexpr (std::is_same_v<GridType, FloatGridType>) {
+          convert(*openvdb::gridConstPtrCast<GridType>(grid));
+        }
+        else {
+          const FloatGridType floatgrid(*openvdb::gridConstPtrCast<GridType>(grid));
+          convert(floatgrid);
         }
-
-        nanogrid = nanovdb::openToNanoVDB(floatgrid);
       }
       catch (const std::exception &e) {
         VLOG_WARNING << "Error converting OpenVDB to NanoVDB grid: " << e.what();
@@ -78,7 +74,86 @@ struct ToNanoOp {
       return false;
     }
   }
+
+  template<typename FloatGridType> void convert(const FloatGridType &floatgrid)
+  {
+    if constexpr (std::is_same_v<FloatGridType, openvdb::FloatGrid>) {
+      if (precision == 0) {
+        nanogrid = nanovdb::openToNanoVDB<nanovdb::HostBuffer,
+                                          typename FloatGridType::TreeType,
+                                          nanovdb::FpN>(floatgrid);
+        return;
+      }
+      else if (precision == 16) {
+        nanogrid = nanovdb::openToNanoVDB<nanovdb::HostBuffer,
+                                          typename FloatGridType::TreeType,
+                                          nanovdb::Fp16>(floatgrid);
+        return;
+      }
+    }
+
+    nanogrid = nanovdb::openToNanoVDB(floatgrid);
+  }
 };
+
+/* Converted grids are cached on disk for grids read from a file, keyed by the file, its
+ * modification time and the grid name. Reading the converted grid is much faster than
+ * converting large grids again. */
+static string nanovdb_cache_filepath(const string &filepath,
+                                     const string &grid_name,
+                                     const int precision)
+{
+  if (filepath.empty() || !path_exists(filepath)) {
+    return "";
+  }
+
+  const string key = string_printf("%s:%llu:%llu:%s:%d:%d.%d",
+                                   filepath.c_str(),
+                                   (unsigned long long)path_file_size(filepath),
+                                   (unsigned long long)path_modified_time(filepath),
+                                   grid_name.c_str(),
+                                   precision,
+                                   NANOVDB_MAJOR_VERSION_NUMBER,
+                                   NANOVDB_MINOR_VERSION_NUMBER);
+
+  return path_cache_get(path_join("nanovdb", util_md5_string(key) + ".nvdb"));
+}
+
+static nanovdb::GridHandle<> nanovdb_cache_read(const string &cache_filepath)
+{
+  if (!path_exists(cache_filepath)) {
+    return nanovdb::GridHandle<>();
+  }
+
+  try {
+    return nanovdb::io::readGrid(cache_filepath);
+  }
+  catch (const std::exception &e) {
+    VLOG_WARNING << "Error reading cached NanoVDB grid " << cache_filepath << ": " << e.what();
+  }
+  return nanovdb::GridHandle<>();
+}
+
+static void nanovdb_cache_write(const string &cache_filepath, const nanovdb::GridHandle<> &grid)
+{
+  /* Write to a temporary file first, so other processes never read an incomplete file. */
+  const string temp_filepath = string_printf(
+      "%s.%llu.tmp", cache_filepath.c_str(), (unsigned long long)(time_dt() * 1e6));
+
+  try {
+    path_create_directories(cache_filepath);
+    nanovdb::io::writeGrid(temp_filepath, grid);
+  }
+  catch (const std::exception &e) {
+    VLOG_WARNING << "Error writing cached NanoVDB grid " << cache_filepath << ": " << e.what();
+    path_remove(temp_filepath);
+    return;
+  }
+
+  if (!path_rename(temp_filepath, cache_filepath)) {
+    path_remove(temp_filepath);
+  }
+}
 #  endif
 
 VDBImageLoader::VDBImageLoader(openvdb::GridBase::ConstPtr grid_, const string &grid_name)
@@ -119,12 +194,23 @@ bool VDBImageLoader::load_metadata(const ImageDeviceFeatures &features, ImageMet
     openvdb::tools::pruneInactive(pruned_grid.tree());
     nanogrid = nanovdb::openToNanoVDB(pruned_grid);
 #    endif
-    ToNanoOp op;
-    op.precision = precision;
-    if (!openvdb::grid_type_operation(grid, op)) {
-      return false;
+    const string cache_filepath = nanovdb_cache_filepath(filepath, grid_name, precision);
+    if (!cache_filepath.empty()) {
+      nanogrid = nanovdb_cache_read(cache_filepath);
+    }
+
+    if (!nanogrid) {
+      ToNanoOp op;
+      op.precision = precision;
+      if (!openvdb::grid_type_operation(grid, op)) {
+        return false;
+      }
+      nanogrid = std::move(op.nanogrid);
+
+      if (nanogrid && !cache_filepath.empty()) {
+        nanovdb_cache_write(cache_filepath, nanogrid);
+      }
     }
-    nanogrid = std::move(op.nanogrid);
   }
 #  endif
 
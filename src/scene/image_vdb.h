@@ -45,6 +45,8 @@ class VDBImageLoader : public ImageLoader {
 
  protected:
   string grid_name;
+  /* File the grid was read from if any, to cache the converted NanoVDB grid. */
+  string filepath;
 #ifdef WITH_OPENVDB
   openvdb::GridBase::ConstPtr grid;
   openvdb::CoordBBox bbox;
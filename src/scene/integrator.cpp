@@ -101,6 +101,8 @@ NODE_DEFINE(Integrator)
   SOCKET_BOOLEAN(use_adaptive_sampling, "Use Adaptive Sampling", true);
   SOCKET_FLOAT(adaptive_threshold, "Adaptive Threshold", 0.01f);
   SOCKET_INT(adaptive_min_samples, "Adaptive Min Samples", 0);
+  SOCKET_INT(adaptive_block_size, "Adaptive Block Size", 0);
+  SOCKET_FLOAT(adaptive_sample_budget, "Adaptive Sample Budget", 0.0f);
 
   SOCKET_BOOLEAN(use_light_tree, "Use light tree to optimize many light sampling", true);
   SOCKET_FLOAT(light_sampling_threshold, "Light Sampling Threshold", 0.0f);
@@ -245,6 +247,8 @@ void Integrator::device_update(Device *device, DeviceScene *dscene, Scene *scene
 
   kintegrator->seed = seed;
 
+  kintegrator->adaptive_block_size = use_adaptive_sampling ? adaptive_block_size : 0;
+
   kintegrator->sample_clamp_direct = (sample_clamp_direct == 0.0f) ? FLT_MAX :
                                                                      sample_clamp_direct * 3.0f;
   kintegrator->sample_clamp_indirect = (sample_clamp_indirect == 0.0f) ?
@@ -374,6 +378,9 @@ AdaptiveSampling Integrator::get_adaptive_sampling() const
 
   adaptive_sampling.adaptive_step = 16;
 
+  adaptive_sampling.block_size = adaptive_block_size;
+  adaptive_sampling.sample_budget = adaptive_sample_budget;
+
   DCHECK(is_power_of_two(adaptive_sampling.adaptive_step))
       << "Adaptive step must be a power of two for bitwise operations to work";
 
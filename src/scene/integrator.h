@@ -85,6 +85,8 @@ class Integrator : public Node {
   NODE_SOCKET_API(bool, use_adaptive_sampling)
   NODE_SOCKET_API(int, adaptive_min_samples)
   NODE_SOCKET_API(float, adaptive_threshold)
+  NODE_SOCKET_API(int, adaptive_block_size)
+  NODE_SOCKET_API(float, adaptive_sample_budget)
 
   NODE_SOCKET_API(SamplingPattern, sampling_pattern)
   NODE_SOCKET_API(float, scrambling_distance)
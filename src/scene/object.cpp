@@ -12,6 +12,7 @@
 #include "scene/particles.h"
 #include "scene/pointcloud.h"
 #include "scene/scene.h"
+#include "scene/shader.h"
 #include "scene/stats.h"
 #include "scene/volume.h"
 
@@ -740,6 +741,7 @@ void ObjectManager::device_update(Device *device,
     dscene->object_motion.tag_realloc();
     dscene->object_flag.tag_realloc();
     dscene->object_volume_step.tag_realloc();
+    dscene->object_volume_occupancy.tag_realloc();
   }
 
   if (update_flags & HOLDOUT_MODIFIED) {
@@ -781,6 +783,7 @@ void ObjectManager::device_update(Device *device,
         dscene->object_motion.tag_modified();
         dscene->object_flag.tag_modified();
         dscene->object_volume_step.tag_modified();
+        dscene->object_volume_occupancy.tag_modified();
       }
     }
   }
@@ -858,6 +861,8 @@ void ObjectManager::device_update_flags(
     }
   }
 
+  device_update_volume_occupancy(dscene, scene);
+
   foreach (Object *object, scene->objects) {
     if (object->geometry->has_volume) {
       object_flag[object->index] |= SD_OBJECT_HAS_VOLUME;
@@ -916,6 +921,92 @@ void ObjectManager::device_update_flags(
   dscene->object_volume_step.clear_modified();
 }
 
+/* Check if the volume shader is zero wherever the grids of the volume are zero. */
+static bool volume_shader_is_empty_outside_grids(const Shader *shader, const Volume *volume)
+{
+  if (!shader->has_volume_attribute_density) {
+    return false;
+  }
+
+  for (const ustring &name : shader->volume_density_attributes) {
+    const AttributeStandard std = Attribute::name_standard(name.c_str());
+    const Attribute *attr = (std != ATTR_STD_NONE) ? volume->attributes.find(std) :
+                                                     volume->attributes.find(name);
+    /* Other attributes, like generated coordinates, are not zero outside the grids. */
+    if (attr == nullptr || attr->element != ATTR_ELEMENT_VOXEL) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void ObjectManager::device_update_volume_occupancy(DeviceScene *dscene, Scene *scene)
+{
+  KernelVolumeOccupancy *kocc = dscene->object_volume_occupancy.alloc(scene->objects.size());
+
+  /* Pack the occupancy bits of all volumes, shared between instances of the same volume. */
+  vector<uint> bits;
+  map<const Volume *, int> volume_offsets;
+
+  foreach (Object *object, scene->objects) {
+    KernelVolumeOccupancy &occ = kocc[object->index];
+    occ.itfm = transform_identity();
+    occ.offset = -1;
+    occ.resolution_x = 0;
+    occ.resolution_y = 0;
+    occ.resolution_z = 0;
+
+    /* The grid is in object space, which does not work for motion blurred volumes. */
+    if (!object->geometry->is_volume() || object->use_motion()) {
+      continue;
+    }
+
+    const Volume *volume = static_cast<const Volume *>(object->geometry);
+    if (volume->occupancy.empty()) {
+      continue;
+    }
+
+    /* Space outside the grids is only empty if the shaders get their density from the grids. */
+    bool use_occupancy = true;
+    foreach (Node *node, volume->get_used_shaders()) {
+      const Shader *shader = static_cast<const Shader *>(node);
+      if (shader->has_volume && !volume_shader_is_empty_outside_grids(shader, volume)) {
+        use_occupancy = false;
+      }
+    }
+    if (!use_occupancy) {
+      continue;
+    }
+
+    auto it = volume_offsets.find(volume);
+    if (it == volume_offsets.end()) {
+      it = volume_offsets.insert({volume, (int)bits.size()}).first;
+      bits.insert(bits.end(), volume->occupancy.begin(), volume->occupancy.end());
+    }
+
+    occ.itfm = volume->occupancy_tfm * transform_inverse(object->tfm);
+    occ.offset = it->second;
+    occ.resolution_x = volume->occupancy_resolution.x;
+    occ.resolution_y = volume->occupancy_resolution.y;
+    occ.resolution_z = volume->occupancy_resolution.z;
+  }
+
+  /* Avoid an empty array, device vectors of size zero are not allocated. */
+  if (bits.empty()) {
+    bits.push_back(0);
+  }
+
+  uint *volume_occupancy = dscene->volume_occupancy.alloc(bits.size());
+  std::copy(bits.begin(), bits.end(), volume_occupancy);
+
+  dscene->object_volume_occupancy.copy_to_device();
+  dscene->volume_occupancy.copy_to_device();
+
+  dscene->object_volume_occupancy.clear_modified();
+  dscene->volume_occupancy.clear_modified();
+}
+
 void ObjectManager::device_update_geom_offsets(Device *, DeviceScene *dscene, Scene *scene)
 {
   if (dscene->objects.size() == 0) {
@@ -968,6 +1059,8 @@ void ObjectManager::device_free(Device *, DeviceScene *dscene, bool force_free)
   dscene->object_motion.free_if_need_realloc(force_free);
   dscene->object_flag.free_if_need_realloc(force_free);
   dscene->object_volume_step.free_if_need_realloc(force_free);
+  dscene->object_volume_occupancy.free_if_need_realloc(force_free);
+  dscene->volume_occupancy.free_if_need_realloc(force_free);
   dscene->object_prim_offset.free_if_need_realloc(force_free);
 }
 
@@ -173,6 +173,7 @@ class ObjectManager {
                            Progress &progress,
                            bool bounds_valid = true);
   void device_update_geom_offsets(Device *device, DeviceScene *dscene, Scene *scene);
+  void device_update_volume_occupancy(DeviceScene *dscene, Scene *scene);
 
   void device_free(Device *device, DeviceScene *dscene, bool force_free);
 
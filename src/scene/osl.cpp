@@ -1307,6 +1307,10 @@ void OSLCompiler::compile(OSLGlobals *og, Shader *shader)
 
     /* Estimate emission for MIS. */
     shader->estimate_emission();
+
+    /* Detect empty space for volume occupancy. */
+    shader->has_volume_attribute_density = shader->graph->volume_is_zero_without_attributes(
+        shader->volume_density_attributes);
   }
 
   /* push state to array for lookup */
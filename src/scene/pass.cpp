@@ -95,6 +95,8 @@ const NodeEnum *Pass::get_type_enum()
     pass_type_enum.insert("shadow_catcher_sample_count", PASS_SHADOW_CATCHER_SAMPLE_COUNT);
     pass_type_enum.insert("shadow_catcher_matte", PASS_SHADOW_CATCHER_MATTE);
 
+    pass_type_enum.insert("render_time", PASS_RENDER_TIME);
+
     pass_type_enum.insert("bake_primitive", PASS_BAKE_PRIMITIVE);
     pass_type_enum.insert("bake_differential", PASS_BAKE_DIFFERENTIAL);
 
@@ -150,6 +152,11 @@ bool Pass::is_written() const
   return get_info().is_written;
 }
 
+bool Pass::is_auto() const
+{
+  return is_auto_;
+}
+
 PassInfo Pass::get_info(const PassType type, const bool include_albedo, const bool is_lightgroup)
 {
   PassInfo pass_info;
@@ -325,6 +332,13 @@ PassInfo Pass::get_info(const PassType type, const bool include_albedo, const bo
       pass_info.use_exposure = false;
       break;
 
+    case PASS_RENDER_TIME:
+      pass_info.num_components = 1;
+      pass_info.use_exposure = false;
+      /* Accumulated over all samples, read as the time per sample. */
+      pass_info.use_filter = true;
+      break;
+
     case PASS_AOV_COLOR:
       pass_info.num_components = 4;
       break;
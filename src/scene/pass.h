@@ -64,6 +64,10 @@ class Pass : public Node {
    * pixels allocated to save memory. */
   bool is_written() const;
 
+  /* The pass was added by the film as a requirement of other passes or settings, rather than
+   * requested by the host application. */
+  bool is_auto() const;
+
  protected:
   /* The has been created automatically as a requirement to various rendering functionality (such
    * as adaptive sampling). */
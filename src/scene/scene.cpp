@@ -30,6 +30,7 @@
 #include "util/guarded_allocator.h"
 #include "util/log.h"
 #include "util/progress.h"
+#include "util/trace.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -59,6 +60,8 @@ DeviceScene::DeviceScene(Device *device)
       object_motion(device, "object_motion", MEM_GLOBAL),
       object_flag(device, "object_flag", MEM_GLOBAL),
       object_volume_step(device, "object_volume_step", MEM_GLOBAL),
+      object_volume_occupancy(device, "object_volume_occupancy", MEM_GLOBAL),
+      volume_occupancy(device, "volume_occupancy", MEM_GLOBAL),
       object_prim_offset(device, "object_prim_offset", MEM_GLOBAL),
       camera_motion(device, "camera_motion", MEM_GLOBAL),
       attributes_map(device, "attributes_map", MEM_GLOBAL),
@@ -80,6 +83,7 @@ DeviceScene::DeviceScene(Device *device)
       svm_nodes(device, "svm_nodes", MEM_GLOBAL),
       shaders(device, "shaders", MEM_GLOBAL),
       lookup_table(device, "lookup_table", MEM_GLOBAL),
+      rhino_noise_perm(device, "rhino_noise_perm", MEM_GLOBAL),
       sample_pattern_lut(device, "sample_pattern_lut", MEM_GLOBAL),
       ies_lights(device, "ies", MEM_GLOBAL),
       clipping_planes(device, "clipping_planes", MEM_GLOBAL)
@@ -246,6 +250,10 @@ void Scene::device_update(Device *device_, Progress &progress)
     }
   });
 
+  TRACE_SCOPE("Scene::device_update", "scene");
+  /* Phases of the update, the current one ends with the next or when returning. */
+  TraceScope trace_phase("Prune", "scene");
+
   object_manager->prune(this);
   geometry_manager->prune(this);
 
@@ -268,109 +276,128 @@ void Scene::device_update(Device *device_, Progress &progress)
   }
 
   progress.set_status("Updating Shaders");
+  trace_phase.next("Shaders");
   shader_manager->device_update(device, dscene, this, progress);
 
   if (progress.get_cancel() || device->have_error())
     return;
 
   progress.set_status("Updating Clipping Planes");
+  trace_phase.next("Clipping Planes");
   object_manager->device_update_clipping_planes(device, dscene, this, progress);
 
+  trace_phase.next("Procedurals");
   procedural_manager->update(this, progress);
 
   if (progress.get_cancel())
     return;
 
   progress.set_status("Updating Background");
+  trace_phase.next("Background");
   background->device_update(device, dscene, this);
 
   if (progress.get_cancel() || device->have_error())
     return;
 
   progress.set_status("Updating Camera");
+  trace_phase.next("Camera");
   camera->device_update(device, dscene, this);
 
   if (progress.get_cancel() || device->have_error())
     return;
 
+  trace_phase.next("Geometry Preprocess");
   geometry_manager->device_update_preprocess(device, this, progress);
 
   if (progress.get_cancel() || device->have_error())
     return;
 
   progress.set_status("Updating Objects");
+  trace_phase.next("Objects");
   object_manager->device_update(device, dscene, this, progress);
 
   if (progress.get_cancel() || device->have_error())
     return;
 
   progress.set_status("Updating Particle Systems");
+  trace_phase.next("Particle Systems");
   particle_system_manager->device_update(device, dscene, this, progress);
 
   if (progress.get_cancel() || device->have_error())
     return;
 
   progress.set_status("Updating Lookup Tables");
+  trace_phase.next("Lookup Tables");
   lookup_tables->device_update(device, dscene, this);
 
   if (progress.get_cancel() || device->have_error())
     return;
 
   progress.set_status("Updating Meshes");
+  trace_phase.next("Meshes");
   geometry_manager->device_update(device, dscene, this, progress);
 
   if (progress.get_cancel() || device->have_error())
     return;
 
   progress.set_status("Updating Objects Flags");
+  trace_phase.next("Objects Flags");
   object_manager->device_update_flags(device, dscene, this, progress);
 
   if (progress.get_cancel() || device->have_error())
     return;
 
   progress.set_status("Updating Primitive Offsets");
+  trace_phase.next("Primitive Offsets");
   object_manager->device_update_prim_offsets(device, dscene, this);
 
   if (progress.get_cancel() || device->have_error())
     return;
 
   progress.set_status("Updating Images");
+  trace_phase.next("Images");
   image_manager->device_update(device, this, progress);
 
   if (progress.get_cancel() || device->have_error())
     return;
 
   progress.set_status("Updating Camera Volume");
+  trace_phase.next("Camera Volume");
   camera->device_update_volume(device, dscene, this);
 
   if (progress.get_cancel() || device->have_error())
     return;
 
   progress.set_status("Updating Lights");
+  trace_phase.next("Lights");
   light_manager->device_update(device, dscene, this, progress);
 
   if (progress.get_cancel() || device->have_error())
     return;
 
   progress.set_status("Updating Integrator");
+  trace_phase.next("Integrator");
   integrator->device_update(device, dscene, this);
 
   if (progress.get_cancel() || device->have_error())
     return;
 
   progress.set_status("Updating Film");
+  trace_phase.next("Film");
   film->device_update(device, dscene, this);
 
   if (progress.get_cancel() || device->have_error())
     return;
 
   progress.set_status("Updating Lookup Tables");
+  trace_phase.next("Lookup Tables");
   lookup_tables->device_update(device, dscene, this);
 
   if (progress.get_cancel() || device->have_error())
     return;
 
   progress.set_status("Updating Baking");
+  trace_phase.next("Baking");
   bake_manager->device_update(device, dscene, this, progress);
 
   if (progress.get_cancel() || device->have_error())
@@ -380,9 +407,11 @@ void Scene::device_update(Device *device_, Progress &progress)
     dscene->data.volume_stack_size = get_volume_stack_size();
 
     progress.set_status("Updating Device", "Writing constant memory");
+    trace_phase.next("Device Constant Memory");
     device->const_copy_to("data", &(dscene->data), sizeof(dscene->data));
   }
 
+  trace_phase.next("Optimize For Scene");
   device->optimize_for_scene(this);
 
   if (print_stats) {
@@ -95,6 +95,8 @@ class DeviceScene {
   device_vector<DecomposedTransform> object_motion;
   device_vector<uint> object_flag;
   device_vector<float> object_volume_step;
+  device_vector<KernelVolumeOccupancy> object_volume_occupancy;
+  device_vector<uint> volume_occupancy;
   device_vector<uint> object_prim_offset;
 
   /* cameras */
@@ -131,6 +133,9 @@ class DeviceScene {
   /* lookup tables */
   device_vector<float> lookup_table;
 
+  /* rhino procedural noise */
+  device_vector<uchar> rhino_noise_perm;
+
   /* integrator */
   device_vector<float> sample_pattern_lut;
 
@@ -163,6 +168,7 @@ class SceneParams {
   int hair_subdivisions;
   CurveShapeType hair_shape;
   int texture_limit;
+  ImageCompression texture_compression;
 
   bool background;
 
@@ -178,6 +184,7 @@ class SceneParams {
     hair_subdivisions = 3;
     hair_shape = CURVE_RIBBON;
     texture_limit = 0;
+    texture_compression = IMAGE_COMPRESSION_NONE;
     background = true;
   }
 
@@ -190,7 +197,8 @@ class SceneParams {
              use_bvh_unaligned_nodes == params.use_bvh_unaligned_nodes &&
              num_bvh_time_steps == params.num_bvh_time_steps &&
              hair_subdivisions == params.hair_subdivisions && hair_shape == params.hair_shape &&
-             texture_limit == params.texture_limit);
+             texture_limit == params.texture_limit &&
+             texture_compression == params.texture_compression);
   }
 
   int curve_subdivisions()
@@ -20,6 +20,7 @@
 #include "scene/tables.h"
 
 #include "util/foreach.h"
+#include "util/log.h"
 #include "util/murmurhash.h"
 #include "util/task.h"
 #include "util/transform.h"
@@ -108,6 +109,7 @@ Shader::Shader() : Node(get_node_type())
   has_volume_spatial_varying = false;
   has_volume_attribute_dependency = false;
   has_integrator_dependency = false;
+  has_volume_attribute_density = false;
   has_volume_connected = false;
   prev_volume_step_rate = 0.0f;
 
@@ -397,14 +399,27 @@ bool Shader::need_update_geometry() const
 
 /* Shader Manager */
 
+/* Permutation tables are passed as floats, with values from 0 to 255. */
+static void rhino_noise_perm_copy(uchar *perm, const vector<float> &table)
+{
+  bool out_of_range = false;
+  for (size_t i = 0; i < table.size(); i++) {
+    const int value = (int)table[i];
+    out_of_range |= (value < 0 || value > 255);
+    perm[i] = (uchar)clamp(value, 0, 255);
+  }
+
+  if (out_of_range) {
+    LOG(WARNING) << "Rhino noise permutation table has values out of range, clamping.";
+  }
+}
+
 ShaderManager::ShaderManager()
 {
   update_flags = UPDATE_ALL;
 
-  rhino_perlin_noise_table_offset = TABLE_OFFSET_INVALID;
   rhino_impulse_noise_table_offset = TABLE_OFFSET_INVALID;
   rhino_vc_noise_table_offset = TABLE_OFFSET_INVALID;
-  rhino_aaltonen_noise_table_offset = TABLE_OFFSET_INVALID;
   rhino_dots_tree_data_table_offset = TABLE_OFFSET_INVALID;
   rhino_dots_dot_data_table_offset = TABLE_OFFSET_INVALID;
   init_xyz_transforms();
@@ -596,12 +611,19 @@ void ShaderManager::device_update_common(Device * /*device*/,
   kfilm->rec709_to_b = float3_to_float4(rec709_to_b);
   kfilm->is_rec709 = is_rec709;
 
-  /* Rhino procedural noise tables */
-  if (rhino_perlin_noise_table_offset == TABLE_OFFSET_INVALID) {
-    rhino_perlin_noise_table_offset = scene->lookup_tables->add_table(dscene,
-                                                                      rhino_perlin_noise_table);
+  /* Rhino procedural noise tables. The permutations are bytes in their own array, so that the
+   * chains of lookups of the noise functions stay in cache. */
+  if (dscene->rhino_noise_perm.size() == 0) {
+    const size_t num_perm = rhino_perlin_noise_table.size() + rhino_aaltonen_noise_table.size();
+    if (num_perm > 0) {
+      uchar *perm = dscene->rhino_noise_perm.alloc(num_perm);
+      rhino_noise_perm_copy(perm, rhino_perlin_noise_table);
+      rhino_noise_perm_copy(perm + rhino_perlin_noise_table.size(), rhino_aaltonen_noise_table);
+      dscene->rhino_noise_perm.copy_to_device();
+    }
   }
-  dscene->data.tables.rhino_perlin_noise_offset = (int)rhino_perlin_noise_table_offset;
+  dscene->data.tables.rhino_perlin_noise_offset = 0;
+  dscene->data.tables.rhino_aaltonen_noise_offset = (int)rhino_perlin_noise_table.size();
 
   if (rhino_impulse_noise_table_offset == TABLE_OFFSET_INVALID) {
     rhino_impulse_noise_table_offset = scene->lookup_tables->add_table(dscene,
@@ -614,12 +636,6 @@ void ShaderManager::device_update_common(Device * /*device*/,
   }
   dscene->data.tables.rhino_vc_noise_offset = (int)rhino_vc_noise_table_offset;
 
-  if (rhino_aaltonen_noise_table_offset == TABLE_OFFSET_INVALID) {
-    rhino_aaltonen_noise_table_offset = scene->lookup_tables->add_table(
-        dscene, rhino_aaltonen_noise_table);
-  }
-  dscene->data.tables.rhino_aaltonen_noise_offset = (int)rhino_aaltonen_noise_table_offset;
-
   if (rhino_dots_tree_data_table_offset == TABLE_OFFSET_INVALID &&
       rhino_dots_tree_data_table.size() > 0) {
     rhino_dots_tree_data_table_offset = scene->lookup_tables->add_table(
@@ -638,8 +654,7 @@ void ShaderManager::device_update_common(Device * /*device*/,
 void ShaderManager::device_free_common(Device * /*device*/, DeviceScene *dscene, Scene * scene)
 {
   dscene->shaders.free();
-  scene->lookup_tables->remove_table(&rhino_aaltonen_noise_table_offset);
-  scene->lookup_tables->remove_table(&rhino_perlin_noise_table_offset);
+  dscene->rhino_noise_perm.free();
   scene->lookup_tables->remove_table(&rhino_vc_noise_table_offset);
   scene->lookup_tables->remove_table(&rhino_impulse_noise_table_offset);
   scene->lookup_tables->remove_table(&rhino_dots_dot_data_table_offset);
@@ -114,6 +114,11 @@ class Shader : public Node {
   bool has_volume_attribute_dependency;
   bool has_integrator_dependency;
 
+  /* The volume is empty wherever the volume attributes are zero, provided that the attributes
+   * in volume_density_attributes exist as voxel attributes. */
+  bool has_volume_attribute_density;
+  vector<ustring> volume_density_attributes;
+
   float3 emission_estimate;
   EmissionSampling emission_sampling;
   bool emission_is_constant;
@@ -262,10 +267,8 @@ class ShaderManager {
   static vector<float> rhino_aaltonen_noise_table;
   static vector<float> rhino_dots_tree_data_table;
   static vector<float> rhino_dots_dot_data_table;
-  size_t rhino_perlin_noise_table_offset;
   size_t rhino_impulse_noise_table_offset;
   size_t rhino_vc_noise_table_offset;
-  size_t rhino_aaltonen_noise_table_offset;
   size_t rhino_dots_tree_data_table_offset;
   size_t rhino_dots_dot_data_table_offset;
 };
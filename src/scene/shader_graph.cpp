@@ -1117,6 +1117,144 @@ void ShaderGraph::transform_multi_closure(ShaderNode *node, ShaderOutput *weight
   }
 }
 
+static bool output_is_zero_without_attributes(ShaderOutput *output,
+                                              vector<ustring> &required_attributes);
+
+static bool input_is_zero_without_attributes(ShaderInput *input,
+                                             vector<ustring> &required_attributes)
+{
+  if (input->link) {
+    return output_is_zero_without_attributes(input->link, required_attributes);
+  }
+
+  const ShaderNode *node = input->parent;
+  switch (input->type()) {
+    case SocketType::CLOSURE:
+      return true;
+    case SocketType::FLOAT:
+      return node->get_float(input->socket_type) == 0.0f;
+    case SocketType::COLOR:
+    case SocketType::VECTOR:
+    case SocketType::POINT:
+    case SocketType::NORMAL:
+      return is_zero(node->get_float3(input->socket_type));
+    default:
+      return false;
+  }
+}
+
+static bool output_is_zero_without_attributes(ShaderOutput *output,
+                                              vector<ustring> &required_attributes)
+{
+  ShaderNode *node = output->parent;
+
+  if (node->type == AttributeNode::get_node_type()) {
+    /* Only voxel attributes are zero outside the grids, which is checked for the attributes added
+     * here. Alpha is one for volume grids. */
+    if (output->name() == "Alpha") {
+      return false;
+    }
+    required_attributes.push_back(static_cast<AttributeNode *>(node)->get_attribute());
+    return true;
+  }
+  else if (node->type == MathNode::get_node_type()) {
+    MathNode *math_node = static_cast<MathNode *>(node);
+    ShaderInput *value1_in = node->input("Value1");
+    ShaderInput *value2_in = node->input("Value2");
+
+    switch (math_node->get_math_type()) {
+      case NODE_MATH_MULTIPLY:
+        return input_is_zero_without_attributes(value1_in, required_attributes) ||
+               input_is_zero_without_attributes(value2_in, required_attributes);
+      case NODE_MATH_ADD:
+      case NODE_MATH_SUBTRACT:
+        return input_is_zero_without_attributes(value1_in, required_attributes) &&
+               input_is_zero_without_attributes(value2_in, required_attributes);
+      default:
+        return false;
+    }
+  }
+  else if (node->type == ClampNode::get_node_type()) {
+    ShaderInput *min_in = node->input("Min");
+    ShaderInput *max_in = node->input("Max");
+
+    return !min_in->link && !max_in->link && node->get_float(min_in->socket_type) <= 0.0f &&
+           node->get_float(max_in->socket_type) >= 0.0f &&
+           input_is_zero_without_attributes(node->input("Value"), required_attributes);
+  }
+  else if (node->special_type == SHADER_SPECIAL_TYPE_AUTOCONVERT) {
+    /* Conversions between float, color and vector keep zero values zero. */
+    return output->type() != SocketType::STRING &&
+           input_is_zero_without_attributes(node->inputs[0], required_attributes);
+  }
+  else if (node->type == AddClosureNode::get_node_type() ||
+           node->type == MixClosureNode::get_node_type()) {
+    /* The mix factor only weights the closures. */
+    return input_is_zero_without_attributes(node->input("Closure1"), required_attributes) &&
+           input_is_zero_without_attributes(node->input("Closure2"), required_attributes);
+  }
+  else if (node->type == ScatterVolumeNode::get_node_type() ||
+           node->type == AbsorptionVolumeNode::get_node_type()) {
+    return input_is_zero_without_attributes(node->input("Density"), required_attributes) ||
+           input_is_zero_without_attributes(node->input("Color"), required_attributes);
+  }
+  else if (node->type == EmissionNode::get_node_type()) {
+    return input_is_zero_without_attributes(node->input("Strength"), required_attributes) ||
+           input_is_zero_without_attributes(node->input("Color"), required_attributes);
+  }
+  else if (node->type == PrincipledVolumeNode::get_node_type()) {
+    PrincipledVolumeNode *volume_node = static_cast<PrincipledVolumeNode *>(node);
+
+    /* Density is multiplied by the density attribute, if it exists. */
+    if (!input_is_zero_without_attributes(node->input("Density"), required_attributes)) {
+      if (volume_node->get_density_attribute().empty()) {
+        return false;
+      }
+      required_attributes.push_back(volume_node->get_density_attribute());
+    }
+
+    if (!input_is_zero_without_attributes(node->input("Emission Strength"),
+                                          required_attributes) &&
+        !input_is_zero_without_attributes(node->input("Emission Color"), required_attributes))
+    {
+      return false;
+    }
+
+    /* Blackbody emission vanishes at zero temperature, which is multiplied by the temperature
+     * attribute if it exists. */
+    if (!input_is_zero_without_attributes(node->input("Blackbody Intensity"),
+                                          required_attributes) &&
+        !input_is_zero_without_attributes(node->input("Temperature"), required_attributes))
+    {
+      if (volume_node->get_temperature_attribute().empty()) {
+        return false;
+      }
+      required_attributes.push_back(volume_node->get_temperature_attribute());
+    }
+
+    return true;
+  }
+
+  return false;
+}
+
+bool ShaderGraph::volume_is_zero_without_attributes(vector<ustring> &required_attributes)
+{
+  required_attributes.clear();
+
+  ShaderInput *volume_in = output()->input("Volume");
+  if (!volume_in->link) {
+    return true;
+  }
+
+  if (!output_is_zero_without_attributes(volume_in->link, required_attributes)) {
+    required_attributes.clear();
+    return false;
+  }
+
+  return true;
+}
+
 int ShaderGraph::get_num_closures()
 {
   int num_closures = 0;
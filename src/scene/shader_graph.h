@@ -325,6 +325,13 @@ class ShaderGraph : public NodeOwner {
 
   int get_num_closures();
 
+  /* Check if the volume output is zero wherever all volume attributes are zero, which makes the
+   * space outside the active voxels of the grids empty. Only a few nodes are understood, others
+   * are assumed to be non-zero. Attribute nodes and the attributes Principled Volume nodes
+   * multiply by are added to required_attributes, these have to be voxel attributes of the
+   * volume for the result to hold. */
+  bool volume_is_zero_without_attributes(vector<ustring> &required_attributes);
+
   void dump_graph(const char *filename);
 
   /* This function is used to create a node of a specified type instead of
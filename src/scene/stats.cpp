@@ -236,6 +236,27 @@ string ImageStats::full_report(int indent_level)
   const string indent(indent_level * kIndentNumSpaces, ' ');
   string result = "";
   result += indent + "Textures:\n" + textures.full_report(indent_level + 1);
+  if (!shared_textures.entries.empty()) {
+    result += indent + "Shared Textures:\n" + shared_textures.full_report(indent_level + 1);
+  }
+  return result;
+}
+
+/* Device memory statistics. */
+
+DeviceMemoryStats::DeviceMemoryStats()
+{
+}
+
+string DeviceMemoryStats::full_report(int indent_level)
+{
+  const string indent(indent_level * kIndentNumSpaces, ' ');
+  string result = "";
+  result += indent + "Used:\n" + used.full_report(indent_level + 1);
+  result += indent + "Peak:\n" + peak.full_report(indent_level + 1);
+  if (!budget.entries.empty()) {
+    result += indent + "Budget:\n" + budget.full_report(indent_level + 1);
+  }
   return result;
 }
 
@@ -297,11 +318,27 @@ void RenderStats::collect_profiling(Scene *scene, Profiler &prof)
   }
 }
 
+void RenderStats::collect_device_memory(const Stats &stats)
+{
+  device_memory = DeviceMemoryStats();
+
+  for (int i = 0; i < MEM_CATEGORY_NUM; i++) {
+    const MemoryCategory category = MemoryCategory(i);
+    const string name = memory_category_name(category);
+    device_memory.used.add_entry(NamedSizeEntry(name, stats.category_mem_used[i]));
+    device_memory.peak.add_entry(NamedSizeEntry(name, stats.category_mem_peak[i]));
+    if (stats.category_mem_budget[i]) {
+      device_memory.budget.add_entry(NamedSizeEntry(name, stats.category_mem_budget[i]));
+    }
+  }
+}
+
 string RenderStats::full_report()
 {
   string result = "";
   result += "Mesh statistics:\n" + mesh.full_report(1);
   result += "Image statistics:\n" + image.full_report(1);
+  result += "Device memory statistics:\n" + device_memory.full_report(1);
   if (has_profiling) {
     result += "Kernel statistics:\n" + kernel.full_report(1);
     result += "Shader statistics:\n" + shaders.full_report(1);
@@ -158,6 +158,21 @@ class ImageStats {
   string full_report(int indent_level = 0);
 
   NamedSizeStats textures;
+  /* Textures using the memory of another texture with identical pixels, by the size saved. */
+  NamedSizeStats shared_textures;
+};
+
+/* Statistics about device memory per subsystem. */
+class DeviceMemoryStats {
+ public:
+  DeviceMemoryStats();
+
+  /* Generate full human-readable report. */
+  string full_report(int indent_level = 0);
+
+  NamedSizeStats used;
+  NamedSizeStats peak;
+  NamedSizeStats budget;
 };
 
 /* Render process statistics. */
@@ -171,10 +186,14 @@ class RenderStats {
   /* Collect kernel sampling information from Stats. */
   void collect_profiling(Scene *scene, Profiler &prof);
 
+  /* Collect device memory usage per subsystem from Stats. */
+  void collect_device_memory(const Stats &stats);
+
   bool has_profiling;
 
   MeshStats mesh;
   ImageStats image;
+  DeviceMemoryStats device_memory;
   NamedNestedSampleStats kernel;
   NamedSampleCountStats shaders;
   NamedSampleCountStats objects;
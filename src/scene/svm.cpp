@@ -12,6 +12,7 @@
 #include "scene/shader_nodes.h"
 #include "scene/stats.h"
 #include "scene/svm.h"
+#include "scene/svm_specialized.h"
 
 #include "util/foreach.h"
 #include "util/log.h"
@@ -37,7 +38,9 @@ void SVMShaderManager::reset(Scene * /*scene*/)
 void SVMShaderManager::device_update_shader(Scene *scene,
                                             Shader *shader,
                                             Progress *progress,
-                                            array<int4> *svm_nodes)
+                                            array<int4> *svm_nodes,
+                                            int *num_fused_nodes,
+                                            string *specialized_hash)
 {
   if (progress->get_cancel()) {
     return;
@@ -48,6 +51,20 @@ void SVMShaderManager::device_update_shader(Scene *scene,
   SVMCompiler compiler(scene);
   compiler.background = (shader == scene->background->get_shader(scene));
   compiler.compile(shader, *svm_nodes, 0, &summary);
+  *num_fused_nodes = summary.num_fused_nodes;
+
+  /* Identify the shader for specialized CPU functions, and optionally generate them. */
+  *specialized_hash = svm_specialized_hash(*svm_nodes, compiler.node_starts);
+  if (!specialized_hash->empty()) {
+    const char *specialized_dirpath = getenv("CYCLES_SVM_SPECIALIZED_WRITE");
+    if (specialized_dirpath && specialized_dirpath[0] != '\0') {
+      svm_specialized_write(specialized_dirpath,
+                            *svm_nodes,
+                            compiler.node_starts,
+                            *specialized_hash,
+                            shader->name.string());
+    }
+  }
 
   VLOG_WORK << "Compilation summary:\n"
             << "Shader name: " << shader->name << "\n"
@@ -80,13 +97,17 @@ void SVMShaderManager::device_update_specific(Device *device,
   /* Build all shaders. */
   TaskPool task_pool;
   vector<array<int4>> shader_svm_nodes(num_shaders);
+  vector<int> shader_num_fused_nodes(num_shaders, 0);
+  vector<string> shader_specialized_hashes(num_shaders);
   for (int i = 0; i < num_shaders; i++) {
     task_pool.push(function_bind(&SVMShaderManager::device_update_shader,
                                  this,
                                  scene,
                                  scene->shaders[i],
                                  &progress,
-                                 &shader_svm_nodes[i]));
+                                 &shader_svm_nodes[i],
+                                 &shader_num_fused_nodes[i],
+                                 &shader_specialized_hashes[i]));
   }
   task_pool.wait_work();
 
@@ -127,6 +148,26 @@ void SVMShaderManager::device_update_specific(Device *device,
     node_offset += shader_svm_nodes[i].size() - 1;
   }
 
+  if (VLOG_INFO_IS_ON) {
+    int num_fused_nodes = 0;
+    for (int i = 0; i < num_shaders; i++) {
+      num_fused_nodes += shader_num_fused_nodes[i];
+    }
+    VLOG_INFO << "Fused " << num_fused_nodes << " SVM node pairs, of " << svm_nodes_size
+              << " nodes in total.";
+  }
+
+  /* Specialized functions are looked up by shader ID. */
+  vector<string> specialized_hashes(num_shaders);
+  for (int i = 0; i < num_shaders; i++) {
+    specialized_hashes[scene->shaders[i]->id] = shader_specialized_hashes[i];
+  }
+  const int num_specialized = device->set_cpu_svm_specialized_shaders(specialized_hashes);
+  if (num_specialized > 0) {
+    VLOG_INFO << "Using specialized CPU functions for " << num_specialized << " of "
+              << num_shaders << " shaders.";
+  }
+
   /* Copy the nodes of each shader into the correct location. */
   svm_nodes += num_shaders;
   for (int i = 0; i < num_shaders; i++) {
@@ -152,6 +193,7 @@ void SVMShaderManager::device_update_specific(Device *device,
 
 void SVMShaderManager::device_free(Device *device, DeviceScene *dscene, Scene *scene)
 {
+  device->set_cpu_svm_specialized_shaders(vector<string>());
   device_free_common(device, dscene, scene);
 
   dscene->svm_nodes.free();
@@ -168,6 +210,9 @@ SVMCompiler::SVMCompiler(Scene *scene) : scene(scene)
   background = false;
   mix_weight_offset = SVM_STACK_INVALID;
   compile_failed = false;
+  fuse_prev_node = -1;
+  fuse_last_node = -1;
+  num_fused_nodes = 0;
 
   /* This struct has one entry for every node, in order of ShaderNodeType definition. */
   svm_node_types_used = (std::atomic_int *)&scene->dscene->data.svm_usage;
@@ -379,12 +424,26 @@ void SVMCompiler::add_node(int a, int b, int c, int d)
 
 void SVMCompiler::add_node(ShaderNodeType type, int a, int b, int c)
 {
+  fuse_nodes();
+  fuse_prev_node = fuse_last_node;
+  fuse_last_node = current_svm_nodes.size();
+  current_svm_node_starts.push_back(current_svm_nodes.size());
+
   svm_node_types_used[type] = true;
   current_svm_nodes.push_back_slow(make_int4(type, a, b, c));
 }
 
 void SVMCompiler::add_node(ShaderNodeType type, const float3 &f)
 {
+  fuse_nodes();
+  fuse_prev_node = fuse_last_node;
+  fuse_last_node = current_svm_nodes.size();
+  /* NODE_VALUE_V is added with an output offset first, followed by its value in a second node
+   * of the same type. */
+  if (type != NODE_VALUE_V) {
+    current_svm_node_starts.push_back(current_svm_nodes.size());
+  }
+
   svm_node_types_used[type] = true;
   current_svm_nodes.push_back_slow(
       make_int4(type, __float_as_int(f.x), __float_as_int(f.y), __float_as_int(f.z)));
@@ -396,6 +455,104 @@ void SVMCompiler::add_node(const float4 &f)
       __float_as_int(f.x), __float_as_int(f.y), __float_as_int(f.z), __float_as_int(f.w)));
 }
 
+/* Node pairs which are fused into a single node. The first node gets the type of the fused node,
+ * the second node and any data following either node are left unchanged. This keeps the size of
+ * the program and jump offsets the same, and nodes jumped to directly still work. */
+static const struct {
+  ShaderNodeType first;
+  ShaderNodeType second;
+  ShaderNodeType fused;
+  /* Number of int4 used by the first node, or 0 if it varies. */
+  int first_size;
+  const char *name;
+} svm_fused_node_pairs[] = {
+    {RHINO_NODE_TEX_COORD,
+     RHINO_NODE_MATRIX_MATH,
+     RHINO_NODE_FUSED_TEX_COORD_MATRIX_MATH,
+     0,
+     "Texture Coordinate + Matrix Math"},
+    {NODE_ATTR,
+     RHINO_NODE_MATRIX_MATH,
+     RHINO_NODE_FUSED_ATTR_MATRIX_MATH,
+     1,
+     "Attribute + Matrix Math"},
+    {RHINO_NODE_MATRIX_MATH,
+     NODE_TEX_IMAGE,
+     RHINO_NODE_FUSED_MATRIX_MATH_TEX_IMAGE,
+     4,
+     "Matrix Math + Image Texture"},
+    {NODE_TEX_IMAGE,
+     RHINO_NODE_TEXTURE_ADJUSTMENT_TEXTURE,
+     RHINO_NODE_FUSED_TEX_IMAGE_TEXTURE_ADJUSTMENT,
+     0,
+     "Image Texture + Texture Adjustment"},
+};
+
+void SVMCompiler::fuse_nodes()
+{
+  if (fuse_prev_node == -1 || fuse_last_node == -1) {
+    return;
+  }
+
+  int4 &first = current_svm_nodes[fuse_prev_node];
+  const int4 &second = current_svm_nodes[fuse_last_node];
+
+  for (const auto &pair : svm_fused_node_pairs) {
+    if (first.x != pair.first || second.x != pair.second) {
+      continue;
+    }
+    /* Nodes with a fixed size must be directly followed by the second node, anything else in
+     * between was not added as a node with a type and can't be skipped over. */
+    if (pair.first_size != 0 && fuse_last_node - fuse_prev_node != pair.first_size) {
+      break;
+    }
+
+    first.x = pair.fused;
+    svm_node_types_used[pair.fused] = true;
+    fused_nodes[pair.name]++;
+    num_fused_nodes++;
+
+    /* The second node can not be fused again as the first of another pair. */
+    fuse_last_node = -1;
+    break;
+  }
+}
+
+ShaderNodeType SVMCompiler::unfused_node_type(ShaderNodeType type)
+{
+  for (const auto &pair : svm_fused_node_pairs) {
+    if (type == pair.fused) {
+      return pair.first;
+    }
+  }
+  return type;
+}
+
+void SVMCompiler::fuse_nodes_barrier()
+{
+  fuse_nodes();
+  fuse_prev_node = -1;
+  fuse_last_node = -1;
+}
+
+int SVMCompiler::add_jump_node(ShaderNodeType type, int offset)
+{
+  /* Jump nodes are not fused, and end any chain of nodes before them. */
+  fuse_nodes_barrier();
+  svm_node_types_used[type] = true;
+  current_svm_node_starts.push_back(current_svm_nodes.size());
+  current_svm_nodes.push_back_slow(make_int4(type, 0, offset, 0));
+  return current_svm_nodes.size() - 1;
+}
+
+void SVMCompiler::set_jump_target(int jump_index)
+{
+  current_svm_nodes[jump_index].y = current_svm_nodes.size() - jump_index - 1;
+  /* The next node is executed on its own when jumped to, it is not fused with the last node
+   * before it. */
+  fuse_nodes_barrier();
+}
+
 uint SVMCompiler::attribute(ustring name)
 {
   return scene->shader_manager->get_attribute_id(name);
@@ -664,15 +821,12 @@ void SVMCompiler::generate_multi_closure(ShaderNode *root_node,
         /* Add instruction to skip closure and its dependencies if mix
          * weight is zero.
          */
-        svm_node_types_used[NODE_JUMP_IF_ONE] = true;
-        current_svm_nodes.push_back_slow(make_int4(NODE_JUMP_IF_ONE, 0, stack_assign(facin), 0));
-        int node_jump_skip_index = current_svm_nodes.size() - 1;
+        int node_jump_skip_index = add_jump_node(NODE_JUMP_IF_ONE, stack_assign(facin));
 
         generate_multi_closure(root_node, cl1in->link->parent, state);
 
         /* Fill in jump instruction location to be after closure. */
-        current_svm_nodes[node_jump_skip_index].y = current_svm_nodes.size() -
-                                                    node_jump_skip_index - 1;
+        set_jump_target(node_jump_skip_index);
       }
 
       /* generate instructions for input closure 2 */
@@ -680,15 +834,12 @@ void SVMCompiler::generate_multi_closure(ShaderNode *root_node,
         /* Add instruction to skip closure and its dependencies if mix
          * weight is zero.
          */
-        svm_node_types_used[NODE_JUMP_IF_ZERO] = true;
-        current_svm_nodes.push_back_slow(make_int4(NODE_JUMP_IF_ZERO, 0, stack_assign(facin), 0));
-        int node_jump_skip_index = current_svm_nodes.size() - 1;
+        int node_jump_skip_index = add_jump_node(NODE_JUMP_IF_ZERO, stack_assign(facin));
 
         generate_multi_closure(root_node, cl2in->link->parent, state);
 
         /* Fill in jump instruction location to be after closure. */
-        current_svm_nodes[node_jump_skip_index].y = current_svm_nodes.size() -
-                                                    node_jump_skip_index - 1;
+        set_jump_target(node_jump_skip_index);
       }
 
       /* unassign */
@@ -758,6 +909,9 @@ void SVMCompiler::compile_type(Shader *shader, ShaderGraph *graph, ShaderType ty
   /* clear all compiler state */
   memset((void *)&active_stack, 0, sizeof(active_stack));
   current_svm_nodes.clear();
+  current_svm_node_starts.clear();
+  fuse_prev_node = -1;
+  fuse_last_node = -1;
 
   foreach (ShaderNode *node, graph->nodes) {
     foreach (ShaderInput *input, node->inputs)
@@ -835,7 +989,10 @@ void SVMCompiler::compile_type(Shader *shader, ShaderGraph *graph, ShaderType ty
   /* if compile failed, generate empty shader */
   if (compile_failed) {
     current_svm_nodes.clear();
+    current_svm_node_starts.clear();
     compile_failed = false;
+    fuse_prev_node = -1;
+    fuse_last_node = -1;
   }
 
   /* for bump shaders we fall thru to the surface shader, but if this is any other kind of shader
@@ -843,13 +1000,29 @@ void SVMCompiler::compile_type(Shader *shader, ShaderGraph *graph, ShaderType ty
   if (type != SHADER_TYPE_BUMP) {
     add_node(NODE_END, 0, 0, 0);
   }
+
+  fuse_nodes_barrier();
+}
+
+void SVMCompiler::append_svm_nodes(array<int4> &svm_nodes)
+{
+  for (const int start : current_svm_node_starts) {
+    node_starts.push_back(svm_nodes.size() + start);
+  }
+  svm_nodes.append(current_svm_nodes);
 }
 
 void SVMCompiler::compile(Shader *shader, array<int4> &svm_nodes, int index, Summary *summary)
 {
+  node_starts.clear();
+  node_starts.push_back(svm_nodes.size());
+
   svm_node_types_used[NODE_SHADER_JUMP] = true;
   svm_nodes.push_back_slow(make_int4(NODE_SHADER_JUMP, 0, 0, 0));
 
+  fused_nodes.clear();
+  num_fused_nodes = 0;
+
   /* copy graph for shader with bump mapping */
   ShaderNode *output = shader->graph->output();
   int start_num_svm_nodes = svm_nodes.size();
@@ -888,7 +1061,7 @@ void SVMCompiler::compile(Shader *shader, array<int4> &svm_nodes, int index, Sum
     scoped_timer timer((summary != NULL) ? &summary->time_generate_bump : NULL);
     compile_type(shader, shader->graph, SHADER_TYPE_BUMP);
     svm_nodes[index].y = svm_nodes.size();
-    svm_nodes.append(current_svm_nodes);
+    append_svm_nodes(svm_nodes);
   }
 
   /* generate surface shader */
@@ -900,7 +1073,7 @@ void SVMCompiler::compile(Shader *shader, array<int4> &svm_nodes, int index, Sum
     if (!has_bump) {
       svm_nodes[index].y = svm_nodes.size();
     }
-    svm_nodes.append(current_svm_nodes);
+    append_svm_nodes(svm_nodes);
   }
 
   /* generate volume shader */
@@ -908,7 +1081,7 @@ void SVMCompiler::compile(Shader *shader, array<int4> &svm_nodes, int index, Sum
     scoped_timer timer((summary != NULL) ? &summary->time_generate_volume : NULL);
     compile_type(shader, shader->graph, SHADER_TYPE_VOLUME);
     svm_nodes[index].z = svm_nodes.size();
-    svm_nodes.append(current_svm_nodes);
+    append_svm_nodes(svm_nodes);
   }
 
   /* generate displacement shader */
@@ -916,7 +1089,7 @@ void SVMCompiler::compile(Shader *shader, array<int4> &svm_nodes, int index, Sum
     scoped_timer timer((summary != NULL) ? &summary->time_generate_displacement : NULL);
     compile_type(shader, shader->graph, SHADER_TYPE_DISPLACEMENT);
     svm_nodes[index].w = svm_nodes.size();
-    svm_nodes.append(current_svm_nodes);
+    append_svm_nodes(svm_nodes);
   }
 
   /* Fill in summary information. */
@@ -924,10 +1097,16 @@ void SVMCompiler::compile(Shader *shader, array<int4> &svm_nodes, int index, Sum
     summary->time_total = time_dt() - time_start;
     summary->peak_stack_usage = max_stack_use;
     summary->num_svm_nodes = svm_nodes.size() - start_num_svm_nodes;
+    summary->fused_nodes = fused_nodes;
+    summary->num_fused_nodes = num_fused_nodes;
   }
 
   /* Estimate emission for MIS. */
   shader->estimate_emission();
+
+  /* Detect empty space for volume occupancy. */
+  shader->has_volume_attribute_density = shader->graph->volume_is_zero_without_attributes(
+      shader->volume_density_attributes);
 }
 
 /* Compiler summary implementation. */
@@ -935,6 +1114,7 @@ void SVMCompiler::compile(Shader *shader, array<int4> &svm_nodes, int index, Sum
 SVMCompiler::Summary::Summary()
     : num_svm_nodes(0),
       peak_stack_usage(0),
+      num_fused_nodes(0),
       time_finalize(0.0),
       time_generate_surface(0.0),
       time_generate_bump(0.0),
@@ -949,6 +1129,10 @@ string SVMCompiler::Summary::full_report() const
   string report = "";
   report += string_printf("Number of SVM nodes: %d\n", num_svm_nodes);
   report += string_printf("Peak stack usage:    %d\n", peak_stack_usage);
+  report += string_printf("Fused SVM nodes:     %d\n", num_fused_nodes);
+  for (const auto &it : fused_nodes) {
+    report += string_printf("  %s: %d\n", it.first.c_str(), it.second);
+  }
 
   report += string_printf("Time (in seconds):\n");
   report += string_printf("Finalize:            %f\n", time_finalize);
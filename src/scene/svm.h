@@ -9,6 +9,7 @@
 #include "scene/shader_graph.h"
 
 #include "util/array.h"
+#include "util/map.h"
 #include "util/set.h"
 #include "util/string.h"
 #include "util/thread.h"
@@ -43,7 +44,9 @@ class SVMShaderManager : public ShaderManager {
   void device_update_shader(Scene *scene,
                             Shader *shader,
                             Progress *progress,
-                            array<int4> *svm_nodes);
+                            array<int4> *svm_nodes,
+                            int *num_fused_nodes,
+                            string *specialized_hash);
 };
 
 /* Graph Compiler */
@@ -59,6 +62,11 @@ class SVMCompiler {
     /* Peak stack usage during shader evaluation. */
     int peak_stack_usage;
 
+    /* Number of node pairs fused into a single node, by type of fused node. Each saves one
+     * dispatch of the SVM interpreter loop. */
+    map<string, int> fused_nodes;
+    int num_fused_nodes;
+
     /* Time spent on surface graph finalization. */
     double time_finalize;
 
@@ -111,10 +119,17 @@ class SVMCompiler {
     return current_type;
   }
 
+  /* Type of the first node of a fused node pair, or the type itself for other nodes. */
+  static ShaderNodeType unfused_node_type(ShaderNodeType type);
+
   Scene *scene;
   ShaderGraph *current_graph;
   bool background;
 
+  /* Offsets of every node of the last compiled shader, excluding the extra data of nodes, relative
+   * to the start of the nodes passed to compile(). */
+  vector<int> node_starts;
+
  protected:
   /* stack */
   struct Stack {
@@ -210,15 +225,33 @@ class SVMCompiler {
 
   /* compile */
   void compile_type(Shader *shader, ShaderGraph *graph, ShaderType type);
+  void append_svm_nodes(array<int4> &svm_nodes);
+
+  /* Fuse the last two nodes added if they form a common chain, and stop fusing across nodes
+   * which are not added with add_node(). */
+  void fuse_nodes();
+  void fuse_nodes_barrier();
+
+  /* Add a jump node with the offset of its condition on the stack, returning its index. The jump
+   * target is set to the next node added after the call to set_jump_target(). */
+  int add_jump_node(ShaderNodeType type, int offset);
+  void set_jump_target(int jump_index);
 
   std::atomic_int *svm_node_types_used;
   array<int4> current_svm_nodes;
+  vector<int> current_svm_node_starts;
   ShaderType current_type;
   Shader *current_shader;
   Stack active_stack;
   int max_stack_use;
   uint mix_weight_offset;
   bool compile_failed;
+
+  /* Offsets of the last two nodes added with a type, -1 if they can not be fused. */
+  int fuse_prev_node;
+  int fuse_last_node;
+  map<string, int> fused_nodes;
+  int num_fused_nodes;
 };
 
 CCL_NAMESPACE_END
@@ -0,0 +1,224 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#include "scene/svm_specialized.h"
+#include "scene/svm.h"
+
+#include "kernel/svm/types.h"
+
+#include "util/log.h"
+#include "util/md5.h"
+#include "util/path.h"
+#include "util/set.h"
+#include "util/thread.h"
+
+CCL_NAMESPACE_BEGIN
+
+static const char *svm_node_type_names[] = {
+#define SHADER_NODE_TYPE(name) #name,
+#include "kernel/svm/node_types_template.h"
+};
+
+/* Nodes from the start of the surface nodes up to and including the end node, with offsets
+ * relative to the start. */
+struct SVMSpecializedNodes {
+  int begin = 0;
+  vector<int> starts;
+  set<int> jump_targets;
+};
+
+static bool svm_specialized_nodes(const array<int4> &svm_nodes,
+                                  const vector<int> &node_starts,
+                                  SVMSpecializedNodes &nodes)
+{
+  /* Shaders are compiled with their own jump node first. */
+  if (svm_nodes.empty() || svm_nodes[0].x != NODE_SHADER_JUMP) {
+    return false;
+  }
+
+  nodes.begin = svm_nodes[0].y;
+
+  bool has_end = false;
+  for (const int start : node_starts) {
+    if (start < nodes.begin) {
+      continue;
+    }
+
+    const int4 &node = svm_nodes[start];
+    if (node.x < 0 || node.x >= NODE_NUM || node.x == NODE_SHADER_JUMP) {
+      return false;
+    }
+
+    nodes.starts.push_back(start - nodes.begin);
+    if (node.x == NODE_JUMP_IF_ZERO || node.x == NODE_JUMP_IF_ONE) {
+      nodes.jump_targets.insert(start - nodes.begin + 1 + node.y);
+    }
+    else if (node.x == NODE_END) {
+      has_end = true;
+      break;
+    }
+  }
+
+  /* Nothing to gain for shaders without surface nodes. */
+  if (!has_end || nodes.starts.size() < 2) {
+    return false;
+  }
+
+  /* Jumps must land on a node. */
+  const set<int> starts(nodes.starts.begin(), nodes.starts.end());
+  for (const int target : nodes.jump_targets) {
+    if (starts.find(target) == starts.end()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+string svm_specialized_hash(const array<int4> &svm_nodes, const vector<int> &node_starts)
+{
+  SVMSpecializedNodes nodes;
+  if (!svm_specialized_nodes(svm_nodes, node_starts, nodes)) {
+    return "";
+  }
+
+  const int end = nodes.begin + nodes.starts.back() + 1;
+
+  MD5Hash md5;
+  md5.append((const uint8_t *)&svm_nodes[nodes.begin], sizeof(int4) * (end - nodes.begin));
+  md5.append((const uint8_t *)nodes.starts.data(), sizeof(int) * nodes.starts.size());
+  return md5.get_hex();
+}
+
+string svm_specialized_source(const array<int4> &svm_nodes,
+                              const vector<int> &node_starts,
+                              const string &hash,
+                              const string &shader_name)
+{
+  SVMSpecializedNodes nodes;
+  if (!svm_specialized_nodes(svm_nodes, node_starts, nodes)) {
+    return "";
+  }
+
+  /* Keep the name from ending the comment. */
+  string name = shader_name;
+  string_replace(name, "*/", "* /");
+  string_replace(name, "\n", " ");
+
+  string source;
+  source += "/* Specialized surface nodes of shader \"" + name + "\".\n";
+  source += " * Generated from SVM nodes, do not edit. */\n\n";
+  source += "#include \"kernel/device/cpu/svm_specialized.h\"\n\n";
+  source += "CCL_NAMESPACE_BEGIN\n\n";
+  source += "template<uint node_feature_mask>\n";
+  source += "static void svm_specialized_eval(KernelGlobals kg,\n";
+  source += "                                 ConstIntegratorState state,\n";
+  source += "                                 ccl_private ShaderData *sd,\n";
+  source += "                                 ccl_global float *render_buffer,\n";
+  source += "                                 uint32_t path_flag,\n";
+  source += "                                 const int base)\n";
+  source += "{\n";
+  source += "  float stack[SVM_STACK_SIZE];\n";
+  source += "  int offset;\n\n";
+
+  for (const int start : nodes.starts) {
+    const int4 &node = svm_nodes[nodes.begin + start];
+
+    if (nodes.jump_targets.find(start) != nodes.jump_targets.end()) {
+      source += string_printf("node_%d:\n", start);
+    }
+
+    switch (node.x) {
+      case NODE_END:
+        source += "  return;\n";
+        break;
+      case NODE_JUMP_IF_ZERO:
+        source += string_printf("  if (stack_load_float(stack, %uu) <= 0.0f) {\n", uint(node.z));
+        source += string_printf("    goto node_%d;\n  }\n", start + 1 + node.y);
+        break;
+      case NODE_JUMP_IF_ONE:
+        source += string_printf("  if (stack_load_float(stack, %uu) >= 1.0f) {\n", uint(node.z));
+        source += string_printf("    goto node_%d;\n  }\n", start + 1 + node.y);
+        break;
+      default: {
+        /* Fused nodes only save dispatch, which the specialized function does not have. The
+         * second node of the pair is executed on its own. */
+        const ShaderNodeType type = SVMCompiler::unfused_node_type((ShaderNodeType)node.x);
+        source += string_printf("  SVM_SPECIALIZED_NODE(%d, %s, %uu, %uu, %uu)\n",
+                                start,
+                                svm_node_type_names[type],
+                                uint(node.y),
+                                uint(node.z),
+                                uint(node.w));
+        break;
+      }
+    }
+  }
+
+  source += "}\n\n";
+  source += "SVM_SPECIALIZED_EXPORT bool cycles_svm_specialized_" + hash +
+            "(int abi_version, SVMSpecializedShader *r_shader)\n";
+  source += "{\n";
+  source += "  if (abi_version != svm_specialized_abi_version()) {\n";
+  source += "    return false;\n";
+  source += "  }\n";
+  source += "  r_shader->eval_surface = svm_specialized_eval<KERNEL_FEATURE_NODE_MASK_SURFACE &\n";
+  source += "                                                 ~KERNEL_FEATURE_NODE_RAYTRACE>;\n";
+  source += "  r_shader->eval_surface_raytrace =\n";
+  source += "      svm_specialized_eval<KERNEL_FEATURE_NODE_MASK_SURFACE>;\n";
+  source += "  return true;\n";
+  source += "}\n\n";
+  source += "CCL_NAMESPACE_END\n";
+
+  return source;
+}
+
+bool svm_specialized_write(const string &dirpath,
+                           const array<int4> &svm_nodes,
+                           const vector<int> &node_starts,
+                           const string &hash,
+                           const string &shader_name)
+{
+  /* Shaders are compiled in parallel, and different shaders may compile to the same nodes. */
+  static thread_mutex mutex;
+  thread_scoped_lock lock(mutex);
+
+  /* Export the instruction set the library is built for, once per directory, so devices can
+   * reject a library that does not match their CPU or kernel. */
+  const string isa_filepath = path_join(dirpath, "svm_specialized_isa.cpp");
+  if (!path_exists(isa_filepath)) {
+    string isa_source;
+    isa_source += "/* Instruction set of the specialized shader library.\n";
+    isa_source += " * Generated, do not edit. */\n\n";
+    isa_source += "#include \"kernel/device/cpu/svm_specialized.h\"\n\n";
+    isa_source += "CCL_NAMESPACE_BEGIN\n\n";
+    isa_source += "SVM_SPECIALIZED_EXPORT const int cycles_svm_specialized_isa = ";
+    isa_source += "svm_specialized_isa();\n\n";
+    isa_source += "CCL_NAMESPACE_END\n";
+
+    if (!path_write_text(isa_filepath, isa_source)) {
+      LOG(ERROR) << "Error writing specialized shader " << isa_filepath;
+      return false;
+    }
+  }
+
+  const string filepath = path_join(dirpath, "svm_specialized_" + hash + ".cpp");
+  if (path_exists(filepath)) {
+    return true;
+  }
+
+  string source = svm_specialized_source(svm_nodes, node_starts, hash, shader_name);
+  if (source.empty()) {
+    return false;
+  }
+
+  if (!path_write_text(filepath, source)) {
+    LOG(ERROR) << "Error writing specialized shader " << filepath;
+    return false;
+  }
+
+  VLOG_INFO << "Wrote specialized shader " << shader_name << " to " << filepath;
+  return true;
+}
+
+CCL_NAMESPACE_END
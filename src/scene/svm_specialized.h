@@ -0,0 +1,42 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#ifndef __SVM_SPECIALIZED_H__
+#define __SVM_SPECIALIZED_H__
+
+#include "util/array.h"
+#include "util/string.h"
+#include "util/types.h"
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Specialized Shaders
+ *
+ * Generates C++ code executing the surface nodes of a compiled shader, for the plugin library of
+ * the CPU kernel described in kernel/svm/specialized.h. The nodes and offsets of every node are
+ * those of the shader as compiled by SVMCompiler. */
+
+/* Hash identifying the surface nodes of a shader, or an empty string if they can not be
+ * specialized. Nodes do not depend on their location in the global node array, so the hash is
+ * the same for any scene which compiles the shader to the same nodes. */
+string svm_specialized_hash(const array<int4> &svm_nodes, const vector<int> &node_starts);
+
+/* Generate source code of the specialized function for the nodes. */
+string svm_specialized_source(const array<int4> &svm_nodes,
+                              const vector<int> &node_starts,
+                              const string &hash,
+                              const string &shader_name);
+
+/* Write source code to a file named after the hash in the given directory, unless it already
+ * exists, along with a file exporting the instruction set the library is built for. Returns false
+ * if the files could not be written. */
+bool svm_specialized_write(const string &dirpath,
+                           const array<int4> &svm_nodes,
+                           const vector<int> &node_starts,
+                           const string &hash,
+                           const string &shader_name);
+
+CCL_NAMESPACE_END
+
+#endif /* __SVM_SPECIALIZED_H__ */
@@ -13,10 +13,13 @@
 #  include <openvdb/tools/Statistics.h>
 #endif
 
+#include "util/algorithm.h"
+#include "util/atomic.h"
 #include "util/hash.h"
 #include "util/log.h"
 #include "util/openvdb.h"
 #include "util/progress.h"
+#include "util/tbb.h"
 #include "util/types.h"
 
 CCL_NAMESPACE_BEGIN
@@ -38,11 +41,15 @@ Volume::Volume() : Mesh(get_node_type(), Geometry::VOLUME)
   clipping = 0.001f;
   step_size = 0.0f;
   object_space = false;
+  occupancy_resolution = make_int3(0, 0, 0);
+  occupancy_tfm = transform_identity();
 }
 
 void Volume::clear(bool preserve_shaders)
 {
   Mesh::clear(preserve_shaders, true);
+  occupancy.clear();
+  occupancy_resolution = make_int3(0, 0, 0);
 }
 
 struct QuadData {
@@ -91,39 +98,20 @@ const float3 quads_normals[6] = {
     make_float3(0.0f, 0.0f, 1.0f),
 };
 
-static int add_vertex(int3 v,
-                      vector<int3> &vertices,
-                      int3 res,
-                      unordered_map<size_t, int> &used_verts)
+/* Vertices are identified by their index in the grid of vertices spanning the bounding box. */
+static size_t vertex_key(const int3 v, const int3 bbox_min, const int3 res)
 {
-  size_t vert_key = v.x + v.y * (res.x + 1) + v.z * (res.x + 1) * (res.y + 1);
-  unordered_map<size_t, int>::iterator it = used_verts.find(vert_key);
-
-  if (it != used_verts.end()) {
-    return it->second;
-  }
-
-  int vertex_offset = vertices.size();
-  used_verts[vert_key] = vertex_offset;
-  vertices.push_back(v);
-  return vertex_offset;
+  return size_t(v.x - bbox_min.x) + size_t(v.y - bbox_min.y) * (res.x + 1) +
+         size_t(v.z - bbox_min.z) * (res.x + 1) * (res.y + 1);
 }
 
-static void create_quad(int3 corners[8],
-                        vector<int3> &vertices,
-                        vector<QuadData> &quads,
-                        int3 res,
-                        unordered_map<size_t, int> &used_verts,
-                        int face_index)
+static int3 vertex_from_key(const size_t key, const int3 bbox_min, const int3 res)
 {
-  QuadData quad;
-  quad.v0 = add_vertex(corners[quads_indices[face_index][0]], vertices, res, used_verts);
-  quad.v1 = add_vertex(corners[quads_indices[face_index][1]], vertices, res, used_verts);
-  quad.v2 = add_vertex(corners[quads_indices[face_index][2]], vertices, res, used_verts);
-  quad.v3 = add_vertex(corners[quads_indices[face_index][3]], vertices, res, used_verts);
-  quad.normal = quads_normals[face_index];
-
-  quads.push_back(quad);
+  const size_t row = size_t(res.x + 1);
+  const size_t slice = row * (res.y + 1);
+  return make_int3(int(key % row) + bbox_min.x,
+                   int((key % slice) / row) + bbox_min.y,
+                   int(key / slice) + bbox_min.z);
 }
 #endif
 
@@ -169,6 +157,8 @@ class VolumeMeshBuilder {
                              vector<int> &tris,
                              vector<float3> &face_normals);
 
+  void create_occupancy(array<uint> &occupancy, int3 &resolution, Transform &tfm);
+
   bool empty_grid() const;
 
 #ifdef WITH_OPENVDB
@@ -180,13 +170,14 @@ class VolumeMeshBuilder {
     if (do_clipping) {
       using ValueType = typename GridType::ValueType;
       typename GridType::Ptr copy = typed_grid->deepCopy();
-      typename GridType::ValueOnIter iter = copy->beginValueOn();
 
-      for (; iter; ++iter) {
-        if (openvdb::math::Abs(iter.getValue()) < ValueType(volume_clipping)) {
-          iter.setValueOff();
-        }
-      }
+      /* Threaded over the nodes of the tree. */
+      openvdb::tools::foreach (
+          copy->beginValueOn(), [volume_clipping](const typename GridType::ValueOnIter &iter) {
+            if (openvdb::math::Abs(iter.getValue()) < ValueType(volume_clipping)) {
+              iter.setValueOff();
+            }
+          });
 
       typed_grid = copy;
     }
@@ -295,9 +286,11 @@ void VolumeMeshBuilder::create_mesh(vector<float3> &vertices,
 }
 
 #ifdef WITH_OPENVDB
-static bool is_non_empty_leaf(const openvdb::MaskGrid::TreeType &tree, const openvdb::Coord coord)
+static bool is_non_empty_leaf(
+    const openvdb::tree::ValueAccessor<const openvdb::MaskGrid::TreeType> &accessor,
+    const openvdb::Coord coord)
 {
-  auto *leaf_node = tree.probeLeaf(coord);
+  auto *leaf_node = accessor.probeConstLeaf(coord);
   return (leaf_node && !leaf_node->isEmpty());
 }
 #endif
@@ -310,8 +303,11 @@ void VolumeMeshBuilder::generate_vertices_and_quads(vector<ccl::int3> &vertices_
   tree.evalLeafBoundingBox(bbox);
 
   const int3 resolution = make_int3(bbox.dim().x(), bbox.dim().y(), bbox.dim().z());
+  const int3 bbox_min = make_int3(bbox.min().x(), bbox.min().y(), bbox.min().z());
 
-  unordered_map<size_t, int> used_verts;
+  /* Gather the leaves, to process them in parallel. */
+  vector<openvdb::CoordBBox> leaf_bboxes;
+  leaf_bboxes.reserve(tree.leafCount());
 
   for (auto iter = tree.cbeginLeaf(); iter; ++iter) {
     if (iter->isEmpty()) {
@@ -321,54 +317,111 @@ void VolumeMeshBuilder::generate_vertices_and_quads(vector<ccl::int3> &vertices_
     openvdb::CoordBBox leaf_bbox = iter->getNodeBoundingBox();
     /* +1 to convert from exclusive to include bounds. */
     leaf_bbox.max() = leaf_bbox.max().offsetBy(1);
-
-    int3 min = make_int3(leaf_bbox.min().x(), leaf_bbox.min().y(), leaf_bbox.min().z());
-    int3 max = make_int3(leaf_bbox.max().x(), leaf_bbox.max().y(), leaf_bbox.max().z());
-
-    int3 corners[8] = {
-        make_int3(min[0], min[1], min[2]),
-        make_int3(max[0], min[1], min[2]),
-        make_int3(max[0], max[1], min[2]),
-        make_int3(min[0], max[1], min[2]),
-        make_int3(min[0], min[1], max[2]),
-        make_int3(max[0], min[1], max[2]),
-        make_int3(max[0], max[1], max[2]),
-        make_int3(min[0], max[1], max[2]),
-    };
-
-    /* Only create a quad if on the border between an active and an inactive leaf.
-     *
-     * We verify that a leaf exists by probing a coordinate that is at its center,
-     * to do so we compute the center of the current leaf and offset this coordinate
-     * by the size of a leaf in each direction.
-     */
-    static const int LEAF_DIM = openvdb::MaskGrid::TreeType::LeafNodeType::DIM;
-    auto center = leaf_bbox.min() + openvdb::Coord(LEAF_DIM / 2);
-
-    if (!is_non_empty_leaf(tree, openvdb::Coord(center.x() - LEAF_DIM, center.y(), center.z()))) {
-      create_quad(corners, vertices_is, quads, resolution, used_verts, QUAD_X_MIN);
-    }
-
-    if (!is_non_empty_leaf(tree, openvdb::Coord(center.x() + LEAF_DIM, center.y(), center.z()))) {
-      create_quad(corners, vertices_is, quads, resolution, used_verts, QUAD_X_MAX);
-    }
-
-    if (!is_non_empty_leaf(tree, openvdb::Coord(center.x(), center.y() - LEAF_DIM, center.z()))) {
-      create_quad(corners, vertices_is, quads, resolution, used_verts, QUAD_Y_MIN);
-    }
-
-    if (!is_non_empty_leaf(tree, openvdb::Coord(center.x(), center.y() + LEAF_DIM, center.z()))) {
-      create_quad(corners, vertices_is, quads, resolution, used_verts, QUAD_Y_MAX);
-    }
-
-    if (!is_non_empty_leaf(tree, openvdb::Coord(center.x(), center.y(), center.z() - LEAF_DIM))) {
-      create_quad(corners, vertices_is, quads, resolution, used_verts, QUAD_Z_MIN);
-    }
-
-    if (!is_non_empty_leaf(tree, openvdb::Coord(center.x(), center.y(), center.z() + LEAF_DIM))) {
-      create_quad(corners, vertices_is, quads, resolution, used_verts, QUAD_Z_MAX);
+    leaf_bboxes.push_back(leaf_bbox);
+  }
+
+  /* Only create a quad if on the border between an active and an inactive leaf.
+   *
+   * We verify that a leaf exists by probing a coordinate that is at its center,
+   * to do so we compute the center of the current leaf and offset this coordinate
+   * by the size of a leaf in each direction.
+   */
+  vector<uint8_t> leaf_faces(leaf_bboxes.size());
+
+  parallel_for(blocked_range<size_t>(0, leaf_bboxes.size()),
+               [&](const blocked_range<size_t> &range) {
+                 static const int LEAF_DIM = openvdb::MaskGrid::TreeType::LeafNodeType::DIM;
+                 const openvdb::Coord offsets[6] = {openvdb::Coord(-LEAF_DIM, 0, 0),
+                                                    openvdb::Coord(LEAF_DIM, 0, 0),
+                                                    openvdb::Coord(0, -LEAF_DIM, 0),
+                                                    openvdb::Coord(0, LEAF_DIM, 0),
+                                                    openvdb::Coord(0, 0, -LEAF_DIM),
+                                                    openvdb::Coord(0, 0, LEAF_DIM)};
+
+                 /* Accessors cache the path to the last leaf, one per task. */
+                 openvdb::tree::ValueAccessor<const openvdb::MaskGrid::TreeType> accessor(tree);
+
+                 for (size_t i = range.begin(); i != range.end(); i++) {
+                   const openvdb::Coord center = leaf_bboxes[i].min() +
+                                                 openvdb::Coord(LEAF_DIM / 2);
+                   uint8_t faces = 0;
+                   for (int face_index = 0; face_index < 6; face_index++) {
+                     if (!is_non_empty_leaf(accessor, center + offsets[face_index])) {
+                       faces |= 1 << face_index;
+                     }
+                   }
+                   leaf_faces[i] = faces;
+                 }
+               });
+
+  /* Offset of the quads of each leaf. */
+  vector<size_t> leaf_quad_offsets(leaf_bboxes.size() + 1);
+  leaf_quad_offsets[0] = 0;
+  for (size_t i = 0; i < leaf_bboxes.size(); i++) {
+    leaf_quad_offsets[i + 1] = leaf_quad_offsets[i] + popcount(leaf_faces[i]);
+  }
+
+  const size_t num_quads = leaf_quad_offsets.back();
+  quads.resize(num_quads);
+  vector<size_t> quad_vertex_keys(num_quads * 4);
+
+  parallel_for(blocked_range<size_t>(0, leaf_bboxes.size()),
+               [&](const blocked_range<size_t> &range) {
+                 for (size_t i = range.begin(); i != range.end(); i++) {
+                   const openvdb::CoordBBox &leaf_bbox = leaf_bboxes[i];
+                   const int3 min = make_int3(
+                       leaf_bbox.min().x(), leaf_bbox.min().y(), leaf_bbox.min().z());
+                   const int3 max = make_int3(
+                       leaf_bbox.max().x(), leaf_bbox.max().y(), leaf_bbox.max().z());
+
+                   const int3 corners[8] = {
+                       make_int3(min[0], min[1], min[2]),
+                       make_int3(max[0], min[1], min[2]),
+                       make_int3(max[0], max[1], min[2]),
+                       make_int3(min[0], max[1], min[2]),
+                       make_int3(min[0], min[1], max[2]),
+                       make_int3(max[0], min[1], max[2]),
+                       make_int3(max[0], max[1], max[2]),
+                       make_int3(min[0], max[1], max[2]),
+                   };
+
+                   size_t quad_index = leaf_quad_offsets[i];
+                   for (int face_index = 0; face_index < 6; face_index++) {
+                     if (!(leaf_faces[i] & (1 << face_index))) {
+                       continue;
+                     }
+                     for (int j = 0; j < 4; j++) {
+                       quad_vertex_keys[quad_index * 4 + j] = vertex_key(
+                           corners[quads_indices[face_index][j]], bbox_min, resolution);
+                     }
+                     quads[quad_index].normal = quads_normals[face_index];
+                     quad_index++;
+                   }
+                 }
+               });
+
+  /* Merge vertices shared between quads, by sorting their keys. */
+  vector<size_t> vertex_keys(quad_vertex_keys);
+  parallel_sort(vertex_keys.begin(), vertex_keys.end());
+  vertex_keys.erase(std::unique(vertex_keys.begin(), vertex_keys.end()), vertex_keys.end());
+
+  vertices_is.resize(vertex_keys.size());
+  parallel_for(size_t(0), vertex_keys.size(), [&](const size_t i) {
+    vertices_is[i] = vertex_from_key(vertex_keys[i], bbox_min, resolution);
+  });
+
+  parallel_for(size_t(0), num_quads, [&](const size_t i) {
+    int v[4];
+    for (int j = 0; j < 4; j++) {
+      v[j] = int(std::lower_bound(
+                     vertex_keys.begin(), vertex_keys.end(), quad_vertex_keys[i * 4 + j]) -
+                 vertex_keys.begin());
     }
-  }
+    quads[i].v0 = v[0];
+    quads[i].v1 = v[1];
+    quads[i].v2 = v[2];
+    quads[i].v3 = v[3];
+  });
 #else
   (void)vertices_is;
   (void)quads;
@@ -387,14 +440,14 @@ void VolumeMeshBuilder::convert_object_space(const vector<int3> &vertices,
   float3 cell_size = make_float3(1.0f / dim.x(), 1.0f / dim.y(), 1.0f / dim.z());
   float3 point_offset = cell_size * face_overlap_avoidance;
 
-  out_vertices.reserve(vertices.size());
+  out_vertices.resize(vertices.size());
 
-  for (size_t i = 0; i < vertices.size(); ++i) {
+  parallel_for(size_t(0), vertices.size(), [&](const size_t i) {
     openvdb::math::Vec3d p = topology_grid->indexToWorld(
         openvdb::math::Vec3d(vertices[i].x, vertices[i].y, vertices[i].z));
     float3 vertex = make_float3((float)p.x(), (float)p.y(), (float)p.z());
-    out_vertices.push_back(vertex + point_offset);
-  }
+    out_vertices[i] = vertex + point_offset;
+  });
 #else
   (void)vertices;
   (void)out_vertices;
@@ -406,23 +459,106 @@ void VolumeMeshBuilder::convert_quads_to_tris(const vector<QuadData> &quads,
                                               vector<int> &tris,
                                               vector<float3> &face_normals)
 {
-  int index_offset = 0;
   tris.resize(quads.size() * 6);
-  face_normals.reserve(quads.size() * 2);
+  face_normals.resize(quads.size() * 2);
 
-  for (size_t i = 0; i < quads.size(); ++i) {
-    tris[index_offset++] = quads[i].v0;
-    tris[index_offset++] = quads[i].v2;
-    tris[index_offset++] = quads[i].v1;
+  parallel_for(size_t(0), quads.size(), [&](const size_t i) {
+    int *tri = &tris[i * 6];
+    tri[0] = quads[i].v0;
+    tri[1] = quads[i].v2;
+    tri[2] = quads[i].v1;
 
-    face_normals.push_back(quads[i].normal);
+    tri[3] = quads[i].v0;
+    tri[4] = quads[i].v3;
+    tri[5] = quads[i].v2;
 
-    tris[index_offset++] = quads[i].v0;
-    tris[index_offset++] = quads[i].v3;
-    tris[index_offset++] = quads[i].v2;
+    face_normals[i * 2 + 0] = quads[i].normal;
+    face_normals[i * 2 + 1] = quads[i].normal;
+  });
+}
 
-    face_normals.push_back(quads[i].normal);
+/* Occupancy grid with cells of a few voxels, with a bit set for cells that contain an active
+ * voxel of the topology grid. Active voxels are dilated by two voxels, as cubic interpolation
+ * reads voxels up to two voxels away. Must be called after create_mesh(). */
+void VolumeMeshBuilder::create_occupancy(array<uint> &occupancy,
+                                         int3 &resolution,
+                                         Transform &tfm)
+{
+#ifdef WITH_OPENVDB
+  const openvdb::CoordBBox active_bbox = topology_grid->evalActiveVoxelBoundingBox();
+  const int dilation = 2;
+  const openvdb::Coord origin = active_bbox.min().offsetBy(-dilation);
+  const openvdb::Coord dim = active_bbox.dim().offsetBy(2 * dilation);
+
+  /* Grow cells for very large volumes, to keep the grid small. */
+  const size_t max_cells = size_t(1) << 24;
+  int cell_size = 4;
+  while (divide_up(size_t(dim.x()), size_t(cell_size)) *
+             divide_up(size_t(dim.y()), size_t(cell_size)) *
+             divide_up(size_t(dim.z()), size_t(cell_size)) >
+         max_cells)
+  {
+    cell_size *= 2;
+  }
+
+  resolution = make_int3(divide_up(dim.x(), cell_size),
+                         divide_up(dim.y(), cell_size),
+                         divide_up(dim.z(), cell_size));
+  const size_t num_cells = size_t(resolution.x) * resolution.y * resolution.z;
+
+  occupancy.resize(divide_up(num_cells, size_t(32)));
+  occupancy.zero_fill();
+  uint *occupancy_data = occupancy.data();
+
+  vector<const openvdb::MaskGrid::TreeType::LeafNodeType *> leaves;
+  leaves.reserve(topology_grid->tree().leafCount());
+  for (auto iter = topology_grid->tree().cbeginLeaf(); iter; ++iter) {
+    leaves.push_back(iter.getLeaf());
+  }
+
+  parallel_for(size_t(0), leaves.size(), [&](const size_t i) {
+    for (auto iter = leaves[i]->cbeginValueOn(); iter; ++iter) {
+      const openvdb::Coord voxel = iter.getCoord() - origin;
+      const openvdb::Coord cell_min((voxel.x() - dilation) / cell_size,
+                                    (voxel.y() - dilation) / cell_size,
+                                    (voxel.z() - dilation) / cell_size);
+      const openvdb::Coord cell_max(min((voxel.x() + dilation) / cell_size, resolution.x - 1),
+                                    min((voxel.y() + dilation) / cell_size, resolution.y - 1),
+                                    min((voxel.z() + dilation) / cell_size, resolution.z - 1));
+
+      for (int z = cell_min.z(); z <= cell_max.z(); z++) {
+        for (int y = cell_min.y(); y <= cell_max.y(); y++) {
+          for (int x = cell_min.x(); x <= cell_max.x(); x++) {
+            const size_t cell = (size_t(z) * resolution.y + y) * resolution.x + x;
+            const uint bit = 1u << (cell & 31);
+            /* Avoid the atomic for cells already set by neighboring voxels. */
+            if (!(occupancy_data[cell >> 5] & bit)) {
+              atomic_fetch_and_or_uint32(&occupancy_data[cell >> 5], bit);
+            }
+          }
+        }
+      }
+    }
+  });
+
+  /* Object space to index space, as for the mesh vertices, and index space to cell space. */
+  const openvdb::math::Mat4f grid_matrix =
+      topology_grid->transform().baseMap()->getAffineMap()->getMat4();
+  Transform index_to_object;
+  for (int col = 0; col < 4; col++) {
+    for (int row = 0; row < 3; row++) {
+      index_to_object[row][col] = (float)grid_matrix[col][row];
+    }
   }
+
+  tfm = transform_scale(make_float3(1.0f / cell_size)) *
+        transform_translate(-make_float3(origin.x(), origin.y(), origin.z())) *
+        transform_inverse(index_to_object);
+#else
+  occupancy.clear();
+  resolution = make_int3(0, 0, 0);
+  tfm = transform_identity();
+#endif
 }
 
 bool VolumeMeshBuilder::empty_grid() const
@@ -765,6 +901,9 @@ void GeometryManager::create_volume_mesh(const Scene *scene, Volume *volume, Pro
     fN[i] = face_normals[i];
   }
 
+  builder.create_occupancy(
+      volume->occupancy, volume->occupancy_resolution, volume->occupancy_tfm);
+
   /* Print stats. */
   VLOG_WORK << "Memory usage volume mesh: "
             << ((vertices.size() + face_normals.size()) * sizeof(float3) +
@@ -21,6 +21,13 @@ class Volume : public Mesh {
   NODE_SOCKET_API(float, velocity_scale)
 
   virtual void clear(bool preserve_shaders = false) override;
+
+  /* Coarse grid of cells that contain volume data, to skip empty space when ray marching. One
+   * bit per cell, stored row by row along x with 32 cells per uint. Empty if not available. */
+  array<uint> occupancy;
+  int3 occupancy_resolution;
+  /* Object space to cell space, where cells are unit cubes. */
+  Transform occupancy_tfm;
 };
 
 CCL_NAMESPACE_END
@@ -55,6 +55,15 @@ class OutputDriver {
   /* Write tile once it has finished rendering. */
   virtual void write_render_tile(const Tile &tile) = 0;
 
+  /* Whether the final result of a render in multiple tiles can be written as a number of tiles
+   * which together cover the full frame, instead of a single tile with the full frame. This
+   * avoids holding the full frame in memory at the end of the render. The last tile written
+   * ends at the full size. */
+  virtual bool supports_tiled_write() const
+  {
+    return false;
+  }
+
   /* Update tile while rendering is in progress. Return true if any update
    * was performed. */
   virtual bool update_render_tile(const Tile & /* tile */)
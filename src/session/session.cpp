@@ -28,6 +28,7 @@
 #include "util/math.h"
 #include "util/task.h"
 #include "util/time.h"
+#include "util/trace.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -36,6 +37,14 @@ Session::Session(const SessionParams &params_, const SceneParams &scene_params)
 {
   TaskScheduler::init(params.threads);
 
+  string trace_filepath = params.trace_filepath;
+  if (trace_filepath.empty() && getenv("CYCLES_TRACE") != NULL) {
+    trace_filepath = getenv("CYCLES_TRACE");
+  }
+  if (!trace_filepath.empty()) {
+    trace_started_ = trace_begin(trace_filepath);
+  }
+
   delayed_reset_.do_reset = false;
 
   pause_ = false;
@@ -51,7 +60,7 @@ Session::Session(const SessionParams &params_, const SceneParams &scene_params)
 
   /* Configure path tracer. */
   path_trace_ = make_unique<PathTrace>(
-      device, scene->film, scene->dscene, render_scheduler_, tile_manager_);
+      device, scene->film, scene->dscene, render_scheduler_, tile_manager_, params.use_numa);
   path_trace_->set_progress(&progress);
   path_trace_->progress_update_cb = [&]() { update_status_time(); };
 
@@ -92,6 +101,10 @@ Session::~Session()
   delete scene;
   delete device;
 
+  if (trace_started_) {
+    trace_end();
+  }
+
   /* Stop task scheduler. */
   TaskScheduler::exit();
 }
@@ -491,7 +504,34 @@ int2 Session::get_effective_tile_size() const
   /* TODO(sergey): Take available memory into account, and if there is enough memory do not
    * tile and prefer optimal performance. */
 
-  const int tile_size = tile_manager_.compute_render_tile_size(params.tile_size);
+  int tile_size = tile_manager_.compute_render_tile_size(params.tile_size);
+
+  /* Use smaller tiles when the render buffers would exceed their memory budget. The passes are
+   * not updated for the new tile size yet, so the size per pixel is an estimate. */
+  const size_t buffers_budget = stats.get_mem_budget(MEM_CATEGORY_RENDER_BUFFERS);
+  if (buffers_budget) {
+    BufferParams estimate_params = buffer_params_;
+    estimate_params.update_passes(scene->passes);
+    const int64_t pixel_size = max(estimate_params.pass_stride, 1) * sizeof(float);
+    const int64_t budget_area = buffers_budget / pixel_size;
+
+    const int min_tile_size = 128;
+    int budget_tile_size = tile_size;
+    while (budget_tile_size > min_tile_size &&
+           static_cast<int64_t>(budget_tile_size) * budget_tile_size > budget_area)
+    {
+      budget_tile_size /= 2;
+    }
+    budget_tile_size = max(budget_tile_size, min_tile_size);
+
+    if (budget_tile_size < tile_size && image_area > budget_area) {
+      VLOG_INFO << "Reducing tile size from " << tile_size << " to " << budget_tile_size
+                << " to fit render buffers memory budget of "
+                << string_human_readable_size(buffers_budget);
+      tile_size = tile_manager_.compute_render_tile_size(budget_tile_size);
+    }
+  }
+
   const int64_t actual_tile_area = static_cast<int64_t>(tile_size) * tile_size;
 
   if (actual_tile_area >= image_area && image_width <= TileManager::MAX_TILE_SIZE &&
@@ -539,6 +579,7 @@ void Session::do_delayed_reset()
    * temporary
    * directory in the host software and switch to a new temp directory when new render starts. */
   tile_manager_.set_temp_dir(params.temp_dir);
+  tile_manager_.set_file_format(params.tile_file_format);
 
   /* Progress. */
   progress.reset_sample();
@@ -743,6 +784,7 @@ void Session::device_free()
 void Session::collect_statistics(RenderStats *render_stats)
 {
   scene->collect_statistics(render_stats);
+  render_stats->collect_device_memory(stats);
   if (params.use_profiling && (params.device.type == DEVICE_CPU)) {
     render_stats->collect_profiling(scene, profiler);
   }
@@ -49,8 +49,21 @@ class SessionParams {
    * Zero means no limit is applied. */
   double time_limit;
 
+  /* Treat the time limit as a hard budget for the whole render, including final denoising and
+   * writing of the result. Samples are planned ahead from the measured timings instead of
+   * stopping once the limit has been exceeded. */
+  bool use_time_budget;
+
   bool use_profiling;
 
+  /* Write a timeline of scene updates and render work to this file in Chrome trace format when
+   * the session ends. The CYCLES_TRACE environment variable is used when empty. */
+  string trace_filepath;
+
+  /* Split CPU rendering into one path trace work per NUMA node, each with its own thread arena
+   * and node-local copies of the hot scene data. Has no effect on single-node machines. */
+  bool use_numa;
+
   bool use_auto_tile;
   int tile_size;
 
@@ -58,9 +71,12 @@ class SessionParams {
 
   ShadingSystem shadingsystem;
 
-  /* Session-specific temporary directory to store in-progress EXR files in. */
+  /* Session-specific temporary directory to store in-progress tile files in. */
   string temp_dir;
 
+  /* Format of the in-progress tile files. */
+  TileFileFormat tile_file_format;
+
   SessionParams()
   {
     headless = false;
@@ -72,11 +88,15 @@ class SessionParams {
     pixel_size = 1;
     threads = 0;
     time_limit = 0.0;
+    use_time_budget = false;
 
     use_profiling = false;
 
+    use_numa = false;
+
     use_auto_tile = true;
     tile_size = 2048;
+    tile_file_format = TILE_FILE_FORMAT_RAW;
 
     use_resolution_divider = true;
 
@@ -90,7 +110,8 @@ class SessionParams {
     return !(device == params.device && headless == params.headless &&
              background == params.background && experimental == params.experimental &&
              pixel_size == params.pixel_size && threads == params.threads &&
-             use_profiling == params.use_profiling && shadingsystem == params.shadingsystem &&
+             use_profiling == params.use_profiling && use_numa == params.use_numa &&
+             shadingsystem == params.shadingsystem &&
              use_auto_tile == params.use_auto_tile && tile_size == params.tile_size);
   }
 };
@@ -216,6 +237,9 @@ class Session {
   bool pause_ = false;
   bool new_work_added_ = false;
 
+  /* Timeline tracing was started by this session, and is to be written when it ends. */
+  bool trace_started_ = false;
+
   thread_condition_variable pause_cond_;
   thread_mutex pause_mutex_;
   thread_mutex tile_mutex_;
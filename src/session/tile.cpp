@@ -19,6 +19,7 @@
 #include "util/string.h"
 #include "util/system.h"
 #include "util/time.h"
+#include "util/trace.h"
 #include "util/types.h"
 
 CCL_NAMESPACE_BEGIN
@@ -302,6 +303,110 @@ static bool configure_image_spec_from_buffer(ImageSpec *image_spec,
   return true;
 }
 
+/* Serialize the metadata attributes of the image specification, to store them in raw tile
+ * files. Each attribute is stored as a type character, the null terminated name and the value.
+ * Only the attribute types used for the buffer and denoise parameters are supported. */
+static string image_spec_attributes_to_string(const ImageSpec &image_spec)
+{
+  string result;
+
+  for (const ParamValue &param : image_spec.extra_attribs) {
+    const TypeDesc type = param.type();
+    char type_char;
+    if (type == TypeInt) {
+      type_char = 'i';
+    }
+    else if (type == TypeFloat) {
+      type_char = 'f';
+    }
+    else if (type == TypeString) {
+      type_char = 's';
+    }
+    else {
+      LOG(DFATAL) << "Unsupported type of image attribute " << param.name();
+      continue;
+    }
+
+    result += type_char;
+    result += param.name().string();
+    result += '\0';
+
+    if (type_char == 'i') {
+      const int value = param.get<int>();
+      result.append(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+    else if (type_char == 'f') {
+      const float value = param.get<float>();
+      result.append(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+    else {
+      result += param.get<ustring>().string();
+      result += '\0';
+    }
+  }
+
+  return result;
+}
+
+static bool image_spec_attributes_from_string(ImageSpec *image_spec, const string &str)
+{
+  size_t pos = 0;
+
+  auto read_string = [&](string *value) {
+    const size_t end = str.find('\0', pos);
+    if (end == string::npos) {
+      return false;
+    }
+    *value = str.substr(pos, end - pos);
+    pos = end + 1;
+    return true;
+  };
+
+  auto read_value = [&](void *value, const size_t size) {
+    if (size > str.size() - pos) {
+      return false;
+    }
+    memcpy(value, str.data() + pos, size);
+    pos += size;
+    return true;
+  };
+
+  while (pos < str.size()) {
+    const char type_char = str[pos++];
+    string name;
+    if (!read_string(&name)) {
+      return false;
+    }
+
+    if (type_char == 'i') {
+      int value;
+      if (!read_value(&value, sizeof(value))) {
+        return false;
+      }
+      image_spec->attribute(name, value);
+    }
+    else if (type_char == 'f') {
+      float value;
+      if (!read_value(&value, sizeof(value))) {
+        return false;
+      }
+      image_spec->attribute(name, value);
+    }
+    else if (type_char == 's') {
+      string value;
+      if (!read_string(&value)) {
+        return false;
+      }
+      image_spec->attribute(name, value);
+    }
+    else {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 /* --------------------------------------------------------------------
  * Tile Manager.
  */
@@ -321,6 +426,7 @@ TileManager::TileManager()
 
 TileManager::~TileManager()
 {
+  wait_queued_tiles();
 }
 
 int TileManager::compute_render_tile_size(const int suggested_tile_size) const
@@ -388,6 +494,11 @@ void TileManager::set_temp_dir(const string &temp_dir)
   temp_dir_ = temp_dir;
 }
 
+void TileManager::set_file_format(const TileFileFormat file_format)
+{
+  file_format_ = file_format;
+}
+
 bool TileManager::done()
 {
   return tile_state_.next_tile_index == tile_state_.num_tiles;
@@ -446,29 +557,63 @@ const int2 TileManager::get_size() const
 
 bool TileManager::open_tile_output()
 {
+  const bool use_exr = (file_format_ == TILE_FILE_FORMAT_EXR);
+
   write_state_.filename = path_join(temp_dir_,
                                     "cycles-tile-buffer-" + tile_file_unique_part_ + "-" +
-                                        to_string(write_state_.tile_file_index) + ".exr");
+                                        to_string(write_state_.tile_file_index) +
+                                        ((use_exr) ? ".exr" : ".tiles"));
 
-  write_state_.tile_out = ImageOutput::create(write_state_.filename);
-  if (!write_state_.tile_out) {
-    LOG(ERROR) << "Error creating image output for " << write_state_.filename;
-    return false;
-  }
+  if (use_exr) {
+    write_state_.tile_out = ImageOutput::create(write_state_.filename);
+    if (!write_state_.tile_out) {
+      LOG(ERROR) << "Error creating image output for " << write_state_.filename;
+      return false;
+    }
 
-  if (!write_state_.tile_out->supports("tiles")) {
-    LOG(ERROR) << "Progress tile file format does not support tiling.";
-    return false;
-  }
+    if (!write_state_.tile_out->supports("tiles")) {
+      LOG(ERROR) << "Progress tile file format does not support tiling.";
+      return false;
+    }
 
-  if (!write_state_.tile_out->open(write_state_.filename, write_state_.image_spec)) {
-    LOG(ERROR) << "Error opening tile file: " << write_state_.tile_out->geterror();
-    write_state_.tile_out = nullptr;
-    return false;
+    if (!write_state_.tile_out->open(write_state_.filename, write_state_.image_spec)) {
+      LOG(ERROR) << "Error opening tile file: " << write_state_.tile_out->geterror();
+      write_state_.tile_out = nullptr;
+      return false;
+    }
+  }
+  else {
+    write_state_.tile_file_out = make_unique<TileFileWriter>();
+    if (!write_state_.tile_file_out->open(
+            write_state_.filename,
+            buffer_params_.width,
+            buffer_params_.height,
+            buffer_params_.pass_stride,
+            image_spec_attributes_to_string(write_state_.image_spec),
+            file_format_ == TILE_FILE_FORMAT_RAW_COMPRESSED))
+    {
+      LOG(ERROR) << "Error opening tile file " << write_state_.filename;
+      write_state_.tile_file_out = nullptr;
+      return false;
+    }
   }
 
+  write_state_.num_tiles_queued = 0;
   write_state_.num_tiles_written = 0;
 
+  {
+    thread_scoped_lock lock(write_queue_.mutex);
+    write_queue_.error = false;
+    write_queue_.max_queue_depth = 0;
+    write_queue_.bytes_written = 0;
+    write_queue_.write_time = 0.0;
+    write_queue_.wait_time = 0.0;
+
+    /* Allow queued tiles to use a part of the memory, to not compete with rendering. */
+    const size_t physical_ram = system_physical_ram();
+    write_queue_.max_queued_bytes = (physical_ram) ? physical_ram / 8 : size_t(1) << 30;
+  }
+
   VLOG_WORK << "Opened tile file " << write_state_.filename;
 
   return true;
@@ -476,12 +621,14 @@ bool TileManager::open_tile_output()
 
 bool TileManager::close_tile_output()
 {
-  if (!write_state_.tile_out) {
+  if (!has_tile_output()) {
     return true;
   }
 
-  const bool success = write_state_.tile_out->close();
+  const bool success = (write_state_.tile_out) ? write_state_.tile_out->close() :
+                                                 write_state_.tile_file_out->close();
   write_state_.tile_out = nullptr;
+  write_state_.tile_file_out = nullptr;
 
   if (!success) {
     LOG(ERROR) << "Error closing tile file.";
@@ -495,96 +642,215 @@ bool TileManager::close_tile_output()
 
 bool TileManager::write_tile(const RenderBuffers &tile_buffers)
 {
-  if (!write_state_.tile_out) {
+  if (!has_tile_output()) {
     if (!open_tile_output()) {
       return false;
     }
   }
 
-  const double time_start = time_dt();
-
   DCHECK_EQ(tile_buffers.params.pass_stride, buffer_params_.pass_stride);
 
   const BufferParams &tile_params = tile_buffers.params;
 
-  const int tile_x = tile_params.full_x - buffer_params_.full_x + tile_params.window_x;
-  const int tile_y = tile_params.full_y - buffer_params_.full_y + tile_params.window_y;
-
   const int64_t pass_stride = tile_params.pass_stride;
   const int64_t tile_row_stride = tile_params.width * pass_stride;
+  const size_t num_bytes = sizeof(float) * pass_stride * tile_params.window_width *
+                           tile_params.window_height;
+
+  const int tile_x = tile_params.full_x - buffer_params_.full_x + tile_params.window_x;
+  const int tile_y = tile_params.full_y - buffer_params_.full_y + tile_params.window_y;
 
-  vector<float> pixel_storage;
   const float *pixels = tile_buffers.buffer.data() + tile_params.window_x * pass_stride +
                         tile_params.window_y * tile_row_stride;
 
-  /* If there is an overscan used for the tile copy pixels into single continuous block of memory
+  /* Wait for earlier tiles to be written when they use too much memory. */
+  {
+    thread_scoped_lock lock(write_queue_.mutex);
+
+    const double time_start = time_dt();
+    while (!write_queue_.error && write_queue_.queued_bytes != 0 &&
+           write_queue_.queued_bytes + num_bytes > write_queue_.max_queued_bytes)
+    {
+      write_queue_.cond.wait(lock);
+    }
+    write_queue_.wait_time += time_dt() - time_start;
+
+    if (write_queue_.error) {
+      return false;
+    }
+
+    write_queue_.queued_bytes += num_bytes;
+  }
+
+  /* The writer thread owns a copy of the pixels, since the render buffers are re-used for the
+   * next tile while this one is written.
+   *
+   * If there is an overscan used for the tile the copy is a single continuous block of memory
    * without any "gaps".
    * This is a workaround for bug in OIIO (https://github.com/OpenImageIO/oiio/pull/3176).
    * Our task reference: #93008. */
-  if (tile_params.window_x || tile_params.window_y ||
-      tile_params.window_width != tile_params.width ||
-      tile_params.window_height != tile_params.height) {
-    pixel_storage.resize(pass_stride * tile_params.window_width * tile_params.window_height);
-    float *pixels_continuous = pixel_storage.data();
-
-    const int64_t pixels_row_stride = pass_stride * tile_params.width;
-    const int64_t pixels_continuous_row_stride = pass_stride * tile_params.window_width;
-
+  TileWriteJob job;
+  job.x = tile_x;
+  job.y = tile_y;
+  job.width = tile_params.window_width;
+  job.height = tile_params.window_height;
+  job.pass_stride = pass_stride;
+  job.pixels.resize(pass_stride * tile_params.window_width * tile_params.window_height);
+
+  float *pixels_continuous = job.pixels.data();
+  const int64_t pixels_continuous_row_stride = pass_stride * tile_params.window_width;
+
+  if (pixels_continuous_row_stride == tile_row_stride) {
+    memcpy(pixels_continuous, pixels, num_bytes);
+  }
+  else {
     for (int i = 0; i < tile_params.window_height; ++i) {
       memcpy(pixels_continuous, pixels, sizeof(float) * pixels_continuous_row_stride);
-      pixels += pixels_row_stride;
+      pixels += tile_row_stride;
       pixels_continuous += pixels_continuous_row_stride;
     }
+  }
+
+  VLOG_WORK << "Queue tile at " << job.x << ", " << job.y << " for writing";
 
-    pixels = pixel_storage.data();
+  {
+    thread_scoped_lock lock(write_queue_.mutex);
+    write_queue_.jobs.push_back(std::move(job));
+    write_queue_.max_queue_depth = max(write_queue_.max_queue_depth,
+                                       int(write_queue_.jobs.size()));
   }
 
-  VLOG_WORK << "Write tile at " << tile_x << ", " << tile_y;
+  if (!write_queue_.pool) {
+    write_queue_.pool = make_unique<DedicatedTaskPool>();
+  }
+  write_queue_.pool->push([this]() { write_queued_tile(); });
 
-  /* The image tile sizes in the OpenEXR file are different from the size of our big tiles. The
-   * write_tiles() method expects a contiguous image region that will be split into tiles
-   * internally. OpenEXR expects the size of this region to be a multiple of the tile size,
-   * however OpenImageIO automatically adds the required padding.
-   *
-   * The only thing we have to ensure is that the tile_x and tile_y are a multiple of the
-   * image tile size, which happens in compute_render_tile_size. */
+  ++write_state_.num_tiles_queued;
+
+  return true;
+}
 
-  const int64_t xstride = pass_stride * sizeof(float);
-  const int64_t ystride = xstride * tile_params.window_width;
-  const int64_t zstride = ystride * tile_params.window_height;
+void TileManager::write_queued_tile()
+{
+  TileWriteJob job;
+  bool error;
+  {
+    thread_scoped_lock lock(write_queue_.mutex);
+    job = std::move(write_queue_.jobs.front());
+    write_queue_.jobs.pop_front();
+    error = write_queue_.error;
+  }
 
-  if (!write_state_.tile_out->write_tiles(tile_x,
-                                          tile_x + tile_params.window_width,
-                                          tile_y,
-                                          tile_y + tile_params.window_height,
-                                          0,
-                                          1,
-                                          TypeDesc::FLOAT,
-                                          pixels,
-                                          xstride,
-                                          ystride,
-                                          zstride)) {
-    LOG(ERROR) << "Error writing tile " << write_state_.tile_out->geterror();
-    return false;
+  const size_t num_bytes = job.pixels.size() * sizeof(float);
+  const double time_start = time_dt();
+
+  if (!error) {
+    error = !write_tile_pixels(
+        job.x, job.y, job.width, job.height, job.pass_stride, job.pixels.data());
+  }
+
+  /* Free the pixels before the memory is made available to the next tile. */
+  job.pixels.clear();
+  job.pixels.shrink_to_fit();
+
+  thread_scoped_lock lock(write_queue_.mutex);
+  write_queue_.queued_bytes -= num_bytes;
+  write_queue_.error |= error;
+  if (!error) {
+    write_queue_.bytes_written += num_bytes;
+    write_queue_.write_time += time_dt() - time_start;
+  }
+  write_queue_.cond.notify_all();
+}
+
+bool TileManager::write_tile_pixels(const int x,
+                                    const int y,
+                                    const int width,
+                                    const int height,
+                                    const int pass_stride,
+                                    const float *pixels)
+{
+  TRACE_SCOPE("Write Tile To Disk", "tile");
+
+  const double time_start = time_dt();
+
+  if (write_state_.tile_file_out) {
+    if (!write_state_.tile_file_out->write_tile(x, y, width, height, pixels)) {
+      LOG(ERROR) << "Error writing tile to " << write_state_.filename;
+      return false;
+    }
+  }
+  else {
+    /* The image tile sizes in the OpenEXR file are different from the size of our big tiles. The
+     * write_tiles() method expects a contiguous image region that will be split into tiles
+     * internally. OpenEXR expects the size of this region to be a multiple of the tile size,
+     * however OpenImageIO automatically adds the required padding.
+     *
+     * The only thing we have to ensure is that the tile_x and tile_y are a multiple of the
+     * image tile size, which happens in compute_render_tile_size. */
+
+    const int64_t xstride = pass_stride * sizeof(float);
+    const int64_t ystride = xstride * width;
+    const int64_t zstride = ystride * height;
+
+    if (!write_state_.tile_out->write_tiles(x,
+                                            x + width,
+                                            y,
+                                            y + height,
+                                            0,
+                                            1,
+                                            TypeDesc::FLOAT,
+                                            pixels,
+                                            xstride,
+                                            ystride,
+                                            zstride)) {
+      LOG(ERROR) << "Error writing tile " << write_state_.tile_out->geterror();
+      return false;
+    }
   }
 
   ++write_state_.num_tiles_written;
 
-  VLOG_WORK << "Tile written in " << time_dt() - time_start << " seconds.";
+  VLOG_WORK << "Tile at " << x << ", " << y << " written in " << time_dt() - time_start
+            << " seconds.";
 
   return true;
 }
 
-void TileManager::finish_write_tiles()
+void TileManager::wait_queued_tiles()
+{
+  if (write_queue_.pool) {
+    write_queue_.pool->wait();
+  }
+}
+
+bool TileManager::finish_write_tiles()
 {
-  if (!write_state_.tile_out) {
+  if (!has_tile_output()) {
     /* None of the tiles were written hence the file was not created.
      * Avoid creation of fully empty file since it is redundant. */
-    return;
+    return true;
+  }
+
+  wait_queued_tiles();
+
+  bool success;
+  {
+    thread_scoped_lock lock(write_queue_.mutex);
+    success = !write_queue_.error;
+    const double write_time = write_queue_.write_time;
+    VLOG_INFO << "Tile writer: " << write_state_.num_tiles_written << " tiles, "
+              << string_human_readable_size(write_queue_.bytes_written) << " written in "
+              << write_time << " seconds ("
+              << string_human_readable_size(
+                     (write_time > 0.0) ? size_t(write_queue_.bytes_written / write_time) : 0)
+              << "/s), maximum queue depth " << write_queue_.max_queue_depth << ", waited "
+              << write_queue_.wait_time << " seconds for queued tiles.";
   }
 
-  /* EXR expects all tiles to present in file. So explicitly write missing tiles as all-zero. */
-  if (write_state_.num_tiles_written < tile_state_.num_tiles) {
+  /* EXR expects all tiles to present in file. So explicitly write missing tiles as all-zero.
+   * Raw tile files read missing tiles as zero. */
+  if (write_state_.tile_out && write_state_.num_tiles_written < tile_state_.num_tiles) {
     vector<float> pixel_storage(tile_size_.x * tile_size_.y * buffer_params_.pass_stride);
 
     for (int tile_index = write_state_.num_tiles_written; tile_index < tile_state_.num_tiles;
@@ -607,7 +873,7 @@ void TileManager::finish_write_tiles()
     }
   }
 
-  close_tile_output();
+  success &= close_tile_output();
 
   if (full_buffer_written_cb) {
     full_buffer_written_cb(write_state_.filename);
@@ -622,42 +888,180 @@ void TileManager::finish_write_tiles()
   ++write_state_.tile_file_index;
 
   write_state_.filename = "";
+
+  return success;
 }
 
 bool TileManager::read_full_buffer_from_disk(const string_view filename,
                                              RenderBuffers *buffers,
                                              DenoiseParams *denoise_params)
 {
-  unique_ptr<ImageInput> in(ImageInput::open(filename));
-  if (!in) {
-    LOG(ERROR) << "Error opening tile file " << filename;
+  BufferParams buffer_params;
+  if (!open_full_buffer_from_disk(filename, &buffer_params, denoise_params)) {
     return false;
   }
 
-  const ImageSpec &image_spec = in->spec();
+  const bool success = read_full_buffer_region_from_disk(
+      0, 0, buffer_params.width, buffer_params.height, 0, buffers);
 
-  BufferParams buffer_params;
-  if (!buffer_params_from_image_spec_atttributes(&buffer_params, image_spec)) {
+  return close_full_buffer_from_disk() && success;
+}
+
+bool TileManager::open_full_buffer_from_disk(const string_view filename,
+                                             BufferParams *buffer_params,
+                                             DenoiseParams *denoise_params)
+{
+  close_full_buffer_from_disk();
+
+  /* Files are read in the format they were written in, which is known from the extension. */
+  unique_ptr<ImageInput> in;
+  unique_ptr<TileFileReader> file_in;
+  ImageSpec raw_image_spec;
+
+  if (string_endswith(filename, ".exr")) {
+    in = ImageInput::open(filename);
+    if (!in) {
+      LOG(ERROR) << "Error opening tile file " << filename;
+      return false;
+    }
+  }
+  else {
+    file_in = make_unique<TileFileReader>();
+    if (!file_in->open(string(filename))) {
+      LOG(ERROR) << "Error opening tile file " << filename;
+      return false;
+    }
+    if (!image_spec_attributes_from_string(&raw_image_spec, file_in->get_metadata())) {
+      LOG(ERROR) << "Error reading metadata of the tile file " << filename;
+      return false;
+    }
+  }
+
+  const ImageSpec &image_spec = (in) ? in->spec() : raw_image_spec;
+
+  BufferParams full_buffer_params;
+  if (!buffer_params_from_image_spec_atttributes(&full_buffer_params, image_spec)) {
     return false;
   }
-  buffers->reset(buffer_params);
 
   if (!node_from_image_spec_atttributes(denoise_params, image_spec, ATTR_DENOISE_SOCKET_PREFIX)) {
     return false;
   }
 
-  const int num_channels = in->spec().nchannels;
-  if (!in->read_image(0, 0, 0, num_channels, TypeDesc::FLOAT, buffers->buffer.data())) {
-    LOG(ERROR) << "Error reading pixels from the tile file " << in->geterror();
+  if (file_in && (file_in->get_width() != full_buffer_params.width ||
+                  file_in->get_height() != full_buffer_params.height ||
+                  file_in->get_pass_stride() != full_buffer_params.pass_stride))
+  {
+    LOG(ERROR) << "Mismatched buffer parameters in the tile file " << filename;
     return false;
   }
 
-  if (!in->close()) {
-    LOG(ERROR) << "Error closing tile file " << in->geterror();
+  *buffer_params = full_buffer_params;
+
+  read_state_.tile_in = std::move(in);
+  read_state_.tile_file_in = std::move(file_in);
+  read_state_.buffer_params = std::move(full_buffer_params);
+
+  return true;
+}
+
+bool TileManager::read_full_buffer_region_from_disk(const int x,
+                                                    const int y,
+                                                    const int width,
+                                                    const int height,
+                                                    const int padding,
+                                                    RenderBuffers *buffers)
+{
+  TRACE_SCOPE("Read Tile Region", "tile");
+
+  ImageInput *in = read_state_.tile_in.get();
+  TileFileReader *file_in = read_state_.tile_file_in.get();
+  if (!in && !file_in) {
+    return false;
+  }
+
+  const BufferParams &full_params = read_state_.buffer_params;
+
+  /* Add the padding, aligned to tiles of the file to read whole tiles only. */
+  const int tile_width = (in && in->spec().tile_width) ? in->spec().tile_width : IMAGE_TILE_SIZE;
+  const int tile_height = (in && in->spec().tile_height) ? in->spec().tile_height :
+                                                           IMAGE_TILE_SIZE;
+  const int x_begin = (max(x - padding, 0) / tile_width) * tile_width;
+  const int y_begin = (max(y - padding, 0) / tile_height) * tile_height;
+  const int x_end = min(int(align_up(x + width + padding, tile_width)), full_params.width);
+  const int y_end = min(int(align_up(y + height + padding, tile_height)), full_params.height);
+
+  BufferParams buffer_params = full_params;
+  buffer_params.width = x_end - x_begin;
+  buffer_params.height = y_end - y_begin;
+  buffer_params.full_x = full_params.full_x + x_begin;
+  buffer_params.full_y = full_params.full_y + y_begin;
+  buffer_params.window_x = x - x_begin;
+  buffer_params.window_y = y - y_begin;
+  buffer_params.window_width = width;
+  buffer_params.window_height = height;
+  buffer_params.update_offset_stride();
+
+  buffers->reset(buffer_params);
+
+  if (file_in) {
+    if (!file_in->read_region(x_begin,
+                              y_begin,
+                              buffer_params.width,
+                              buffer_params.height,
+                              buffers->buffer.data()))
+    {
+      LOG(ERROR) << "Error reading pixels from the tile file";
+      return false;
+    }
+    return true;
+  }
+
+  const ImageSpec &image_spec = in->spec();
+  const int num_channels = image_spec.nchannels;
+  const bool success = (x_begin == 0 && y_begin == 0 && x_end == image_spec.width &&
+                        y_end == image_spec.height) ?
+                           in->read_image(
+                               0, 0, 0, num_channels, TypeDesc::FLOAT, buffers->buffer.data()) :
+                           in->read_tiles(0,
+                                          0,
+                                          x_begin,
+                                          x_end,
+                                          y_begin,
+                                          y_end,
+                                          0,
+                                          1,
+                                          0,
+                                          num_channels,
+                                          TypeDesc::FLOAT,
+                                          buffers->buffer.data());
+  if (!success) {
+    LOG(ERROR) << "Error reading pixels from the tile file " << in->geterror();
     return false;
   }
 
   return true;
 }
 
+bool TileManager::close_full_buffer_from_disk()
+{
+  if (read_state_.tile_file_in) {
+    read_state_.tile_file_in->close();
+    read_state_.tile_file_in = nullptr;
+  }
+
+  if (!read_state_.tile_in) {
+    return true;
+  }
+
+  const bool success = read_state_.tile_in->close();
+  if (!success) {
+    LOG(ERROR) << "Error closing tile file " << read_state_.tile_in->geterror();
+  }
+
+  read_state_.tile_in = nullptr;
+
+  return success;
+}
+
 CCL_NAMESPACE_END
@@ -4,8 +4,12 @@
 #pragma once
 
 #include "session/buffers.h"
+#include "session/tile_file.h"
+#include "util/deque.h"
 #include "util/image.h"
 #include "util/string.h"
+#include "util/task.h"
+#include "util/thread.h"
 #include "util/unique_ptr.h"
 
 CCL_NAMESPACE_BEGIN
@@ -13,6 +17,16 @@ CCL_NAMESPACE_BEGIN
 class DenoiseParams;
 class Scene;
 
+/* Format of the file on disk which stores tiles of a render in progress. */
+enum TileFileFormat {
+  /* Raw float pixels, which are fast to write and to read back. */
+  TILE_FILE_FORMAT_RAW = 0,
+  /* Raw float pixels compressed with LZ4, for when disk bandwidth or space is limited. */
+  TILE_FILE_FORMAT_RAW_COMPRESSED,
+  /* Multi-layer OpenEXR, which can be inspected with other software. */
+  TILE_FILE_FORMAT_EXR,
+};
+
 /* --------------------------------------------------------------------
  * Tile.
  */
@@ -60,6 +74,10 @@ class TileManager {
 
   void set_temp_dir(const string &temp_dir);
 
+  /* Format of tile files opened after this call. Files are read back in the format they were
+   * written in. */
+  void set_file_format(TileFileFormat file_format);
+
   inline int get_num_tiles() const
   {
     return tile_state_.num_tiles;
@@ -85,17 +103,25 @@ class TileManager {
    *
    * Opens file for write when first tile is written.
    *
-   * Returns true on success. */
+   * The pixels are copied without the overscan, and written to the file by a background thread
+   * while the next tile renders. Blocks while the tiles waiting to be written use too much
+   * memory.
+   *
+   * Returns true on success, false if the file could not be opened or writing of an earlier tile
+   * has failed. */
   bool write_tile(const RenderBuffers &tile_buffers);
 
   /* Inform the tile manager that no more tiles will be written to disk.
-   * The file will be considered final, all handles to it will be closed. */
-  void finish_write_tiles();
+   * Waits for all queued tiles to be written.
+   * The file will be considered final, all handles to it will be closed.
+   *
+   * Returns false if writing of a queued tile has failed. */
+  bool finish_write_tiles();
 
   /* Check whether any tile has been written to disk. */
   inline bool has_written_tiles() const
   {
-    return write_state_.num_tiles_written != 0;
+    return write_state_.num_tiles_queued != 0;
   }
 
   /* Read full frame render buffer from tiles file on disk.
@@ -105,6 +131,21 @@ class TileManager {
                                   RenderBuffers *buffers,
                                   DenoiseParams *denoise_params);
 
+  /* Read the full frame render buffer from tiles file on disk one region at a time, so that the
+   * full frame does not need to fit in memory.
+   *
+   * Opening provides the parameters of the full frame buffer. Regions are given in pixels of the
+   * full frame buffer, and read with extra pixels around them as overscan, up to the given
+   * padding. The window of the read buffer is the requested region.
+   *
+   * Return true on success. */
+  bool open_full_buffer_from_disk(string_view filename,
+                                  BufferParams *buffer_params,
+                                  DenoiseParams *denoise_params);
+  bool read_full_buffer_region_from_disk(
+      int x, int y, int width, int height, int padding, RenderBuffers *buffers);
+  bool close_full_buffer_from_disk();
+
   /* Compute valid tile size compatible with image saving. */
   int compute_render_tile_size(const int suggested_tile_size) const;
 
@@ -125,8 +166,23 @@ class TileManager {
   bool open_tile_output();
   bool close_tile_output();
 
+  inline bool has_tile_output() const
+  {
+    return write_state_.tile_out || write_state_.tile_file_out;
+  }
+
+  /* Write continuous pixels of a tile to the file. */
+  bool write_tile_pixels(
+      int x, int y, int width, int height, int pass_stride, const float *pixels);
+  /* Write the oldest tile of the write queue to the file, runs on the writer thread. */
+  void write_queued_tile();
+  /* Wait until all queued tiles are written to the file. */
+  void wait_queued_tiles();
+
   string temp_dir_;
 
+  TileFileFormat file_format_ = TILE_FILE_FORMAT_RAW;
+
   /* Part of an on-disk tile file name which avoids conflicts between several Cycles instances or
    * several sessions. */
   string tile_file_unique_part_;
@@ -172,8 +228,53 @@ class TileManager {
      * the state and is created whenever writing is requested. */
     unique_ptr<ImageOutput> tile_out;
 
+    /* Output handle for raw tile files, used instead of the image output for the raw formats. */
+    unique_ptr<TileFileWriter> tile_file_out;
+
+    /* Number of tiles passed to write_tile(), and the number of tiles written to the file. */
+    int num_tiles_queued = 0;
     int num_tiles_written = 0;
   } write_state_;
+
+  /* State of reading the full frame buffer from a tiles file. */
+  struct {
+    unique_ptr<ImageInput> tile_in;
+    unique_ptr<TileFileReader> tile_file_in;
+    BufferParams buffer_params;
+  } read_state_;
+
+  /* Pixels of a tile waiting to be written to the file, stored without gaps. */
+  struct TileWriteJob {
+    int x = 0, y = 0;
+    int width = 0, height = 0;
+    int pass_stride = 0;
+    vector<float> pixels;
+  };
+
+  /* Queue of tiles for the writer thread.
+   * The mutex protects all members except for the pool. */
+  struct {
+    unique_ptr<DedicatedTaskPool> pool;
+
+    thread_mutex mutex;
+    thread_condition_variable cond;
+    deque<TileWriteJob> jobs;
+
+    /* Memory used by queued tiles, including the tile being written. write_tile() waits for
+     * tiles to be written when adding a tile would go over the maximum, unless the queue is
+     * empty. */
+    size_t queued_bytes = 0;
+    size_t max_queued_bytes = 0;
+
+    /* Writing of a tile has failed, later tiles are not written. */
+    bool error = false;
+
+    /* Statistics of the current file. */
+    int max_queue_depth = 0;
+    size_t bytes_written = 0;
+    double write_time = 0.0;
+    double wait_time = 0.0;
+  } write_queue_;
 };
 
 CCL_NAMESPACE_END
@@ -0,0 +1,356 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#include "session/tile_file.h"
+
+#include <atomic>
+
+#include "util/algorithm.h"
+#include "util/lz4.h"
+#include "util/math.h"
+#include "util/path.h"
+#include "util/tbb.h"
+
+CCL_NAMESPACE_BEGIN
+
+static const char TILE_FILE_MAGIC[8] = {'C', 'Y', 'C', 'L', 'T', 'I', 'L', 'E'};
+static const uint32_t TILE_FILE_VERSION = 1;
+
+/* Number of floats in a compressed chunk. */
+static const size_t TILE_FILE_CHUNK_SIZE = size_t(1) << 18;
+
+/* Flag in the chunk size table for chunks which did not compress, and are stored as is. */
+static const uint32_t TILE_FILE_CHUNK_RAW = 0x80000000u;
+
+/* The bytes of the floats of a chunk are split into planes, so that the sign and exponent bytes
+ * which are mostly the same for neighboring values end up next to each other. The low mantissa
+ * bytes are mostly noise and barely compress either way. */
+static void tile_file_split_bytes(const float *values, const size_t num_values, uint8_t *planes)
+{
+  const uint8_t *bytes = reinterpret_cast<const uint8_t *>(values);
+  for (size_t i = 0; i < num_values; i++) {
+    for (size_t b = 0; b < sizeof(float); b++) {
+      planes[b * num_values + i] = bytes[i * sizeof(float) + b];
+    }
+  }
+}
+
+static void tile_file_merge_bytes(const uint8_t *planes, const size_t num_values, float *values)
+{
+  uint8_t *bytes = reinterpret_cast<uint8_t *>(values);
+  for (size_t i = 0; i < num_values; i++) {
+    for (size_t b = 0; b < sizeof(float); b++) {
+      bytes[i * sizeof(float) + b] = planes[b * num_values + i];
+    }
+  }
+}
+
+/* --------------------------------------------------------------------
+ * Writer.
+ */
+
+TileFileWriter::~TileFileWriter()
+{
+  if (file_) {
+    fclose(file_);
+  }
+}
+
+bool TileFileWriter::open(const string &filepath,
+                          const int width,
+                          const int height,
+                          const int pass_stride,
+                          const string &metadata,
+                          const bool use_compression)
+{
+  file_ = path_fopen(filepath, "wb");
+  if (!file_) {
+    return false;
+  }
+
+  memset(&header_, 0, sizeof(header_));
+  memcpy(header_.magic, TILE_FILE_MAGIC, sizeof(TILE_FILE_MAGIC));
+  header_.version = TILE_FILE_VERSION;
+  header_.width = width;
+  header_.height = height;
+  header_.pass_stride = pass_stride;
+
+  entries_.clear();
+  metadata_ = metadata;
+  use_compression_ = use_compression;
+  offset_ = 0;
+
+  /* Written again with the final offsets on close. */
+  return write(&header_, sizeof(header_));
+}
+
+bool TileFileWriter::write(const void *data, const size_t size)
+{
+  if (size && fwrite(data, 1, size, file_) != size) {
+    return false;
+  }
+  offset_ += size;
+  return true;
+}
+
+bool TileFileWriter::write_tile(
+    const int x, const int y, const int width, const int height, const float *pixels)
+{
+  if (!file_) {
+    return false;
+  }
+
+  const size_t num_values = size_t(width) * height * header_.pass_stride;
+
+  TileFileEntry entry;
+  memset(&entry, 0, sizeof(entry));
+  entry.x = x;
+  entry.y = y;
+  entry.width = width;
+  entry.height = height;
+  entry.offset = offset_;
+
+  if (!use_compression_) {
+    if (!write(pixels, num_values * sizeof(float))) {
+      return false;
+    }
+  }
+  else {
+    const size_t num_chunks = divide_up(num_values, TILE_FILE_CHUNK_SIZE);
+    vector<vector<uint8_t>> chunks(num_chunks);
+    vector<uint32_t> chunk_sizes(num_chunks);
+
+    parallel_for(size_t(0), num_chunks, [&](const size_t chunk) {
+      const size_t begin = chunk * TILE_FILE_CHUNK_SIZE;
+      const size_t chunk_values = min(TILE_FILE_CHUNK_SIZE, num_values - begin);
+      const size_t chunk_bytes = chunk_values * sizeof(float);
+
+      vector<uint8_t> planes(chunk_bytes);
+      tile_file_split_bytes(pixels + begin, chunk_values, planes.data());
+
+      /* Only keep the compressed data when it is smaller. */
+      vector<uint8_t> &compressed = chunks[chunk];
+      compressed.resize(lz4_compress_bound(chunk_bytes));
+      const size_t compressed_size = lz4_compress(
+          planes.data(), chunk_bytes, compressed.data(), chunk_bytes - 1);
+
+      if (compressed_size) {
+        compressed.resize(compressed_size);
+        chunk_sizes[chunk] = uint32_t(compressed_size);
+      }
+      else {
+        compressed = std::move(planes);
+        chunk_sizes[chunk] = uint32_t(chunk_bytes) | TILE_FILE_CHUNK_RAW;
+      }
+    });
+
+    if (!write(chunk_sizes.data(), chunk_sizes.size() * sizeof(uint32_t))) {
+      return false;
+    }
+    for (const vector<uint8_t> &chunk : chunks) {
+      if (!write(chunk.data(), chunk.size())) {
+        return false;
+      }
+    }
+
+    entry.compressed = 1;
+    entry.num_chunks = uint32_t(num_chunks);
+  }
+
+  entry.size = offset_ - entry.offset;
+  entries_.push_back(entry);
+
+  return true;
+}
+
+bool TileFileWriter::close()
+{
+  if (!file_) {
+    return false;
+  }
+
+  header_.metadata_offset = offset_;
+  header_.metadata_size = metadata_.size();
+  bool success = write(metadata_.data(), metadata_.size());
+
+  header_.index_offset = offset_;
+  header_.num_tiles = entries_.size();
+  success &= write(entries_.data(), entries_.size() * sizeof(TileFileEntry));
+
+  success &= fseek(file_, 0, SEEK_SET) == 0 &&
+             fwrite(&header_, sizeof(header_), 1, file_) == 1;
+  success &= fclose(file_) == 0;
+  file_ = nullptr;
+
+  entries_.clear();
+  metadata_.clear();
+
+  return success;
+}
+
+/* --------------------------------------------------------------------
+ * Reader.
+ */
+
+bool TileFileReader::open(const string &filepath)
+{
+  close();
+
+  if (!file_.open(filepath)) {
+    return false;
+  }
+
+  const uint8_t *data = file_.data();
+  const size_t size = file_.size();
+
+  if (size < sizeof(TileFileHeader)) {
+    close();
+    return false;
+  }
+
+  memcpy(&header_, data, sizeof(header_));
+  if (memcmp(header_.magic, TILE_FILE_MAGIC, sizeof(TILE_FILE_MAGIC)) != 0 ||
+      header_.version != TILE_FILE_VERSION || header_.pass_stride <= 0 ||
+      header_.metadata_offset > size || header_.metadata_size > size - header_.metadata_offset ||
+      header_.index_offset > size ||
+      header_.num_tiles > (size - header_.index_offset) / sizeof(TileFileEntry))
+  {
+    close();
+    return false;
+  }
+
+  metadata_.assign(reinterpret_cast<const char *>(data + header_.metadata_offset),
+                   header_.metadata_size);
+
+  entries_.resize(header_.num_tiles);
+  memcpy(entries_.data(), data + header_.index_offset, entries_.size() * sizeof(TileFileEntry));
+
+  /* Validate tiles here, so reading does not need to. */
+  for (const TileFileEntry &entry : entries_) {
+    const uint64_t num_bytes = uint64_t(entry.width) * entry.height * header_.pass_stride *
+                               sizeof(float);
+    const uint64_t min_size = (entry.compressed) ? uint64_t(entry.num_chunks) * sizeof(uint32_t) :
+                                                   num_bytes;
+    if (entry.x < 0 || entry.y < 0 || entry.width < 0 || entry.height < 0 ||
+        entry.x + int64_t(entry.width) > header_.width ||
+        entry.y + int64_t(entry.height) > header_.height || entry.offset > size ||
+        entry.size > size - entry.offset || entry.size < min_size ||
+        (entry.compressed &&
+         entry.num_chunks != divide_up(num_bytes / sizeof(float), TILE_FILE_CHUNK_SIZE)))
+    {
+      close();
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void TileFileReader::close()
+{
+  file_.close();
+  header_ = {};
+  entries_.clear();
+  metadata_.clear();
+}
+
+bool TileFileReader::read_tile(const TileFileEntry &entry, float *pixels) const
+{
+  const uint8_t *data = file_.data() + entry.offset;
+  const size_t num_values = size_t(entry.width) * entry.height * header_.pass_stride;
+
+  /* Offsets of the chunks, from the table of chunk sizes. */
+  const size_t num_chunks = entry.num_chunks;
+  vector<uint64_t> chunk_offsets(num_chunks + 1);
+  chunk_offsets[0] = num_chunks * sizeof(uint32_t);
+  for (size_t chunk = 0; chunk < num_chunks; chunk++) {
+    uint32_t chunk_size;
+    memcpy(&chunk_size, data + chunk * sizeof(uint32_t), sizeof(chunk_size));
+    chunk_offsets[chunk + 1] = chunk_offsets[chunk] + (chunk_size & ~TILE_FILE_CHUNK_RAW);
+  }
+  if (chunk_offsets[num_chunks] > entry.size) {
+    return false;
+  }
+
+  std::atomic<bool> success = true;
+
+  parallel_for(size_t(0), num_chunks, [&](const size_t chunk) {
+    const size_t begin = chunk * TILE_FILE_CHUNK_SIZE;
+    const size_t chunk_values = min(TILE_FILE_CHUNK_SIZE, num_values - begin);
+    const size_t chunk_bytes = chunk_values * sizeof(float);
+
+    const uint8_t *chunk_data = data + chunk_offsets[chunk];
+    const size_t chunk_size = chunk_offsets[chunk + 1] - chunk_offsets[chunk];
+
+    uint32_t flags;
+    memcpy(&flags, data + chunk * sizeof(uint32_t), sizeof(flags));
+
+    if (flags & TILE_FILE_CHUNK_RAW) {
+      if (chunk_size != chunk_bytes) {
+        success = false;
+        return;
+      }
+      tile_file_merge_bytes(chunk_data, chunk_values, pixels + begin);
+    }
+    else {
+      vector<uint8_t> planes(chunk_bytes);
+      if (!lz4_decompress(chunk_data, chunk_size, planes.data(), chunk_bytes)) {
+        success = false;
+        return;
+      }
+      tile_file_merge_bytes(planes.data(), chunk_values, pixels + begin);
+    }
+  });
+
+  return success;
+}
+
+bool TileFileReader::read_region(
+    const int x, const int y, const int width, const int height, float *pixels)
+{
+  if (!file_.is_open()) {
+    return false;
+  }
+
+  const size_t pass_stride = header_.pass_stride;
+  const size_t row_size = size_t(width) * pass_stride;
+  std::fill(pixels, pixels + row_size * height, 0.0f);
+
+  vector<float> tile_pixels;
+
+  for (const TileFileEntry &entry : entries_) {
+    const int x_begin = max(x, entry.x);
+    const int y_begin = max(y, entry.y);
+    const int x_end = min(x + width, entry.x + entry.width);
+    const int y_end = min(y + height, entry.y + entry.height);
+    if (x_begin >= x_end || y_begin >= y_end) {
+      continue;
+    }
+
+    /* Uncompressed pixels are copied straight from the mapped file. */
+    const float *src;
+    if (entry.compressed) {
+      tile_pixels.resize(size_t(entry.width) * entry.height * pass_stride);
+      if (!read_tile(entry, tile_pixels.data())) {
+        return false;
+      }
+      src = tile_pixels.data();
+    }
+    else {
+      src = reinterpret_cast<const float *>(file_.data() + entry.offset);
+    }
+
+    const size_t tile_row_size = size_t(entry.width) * pass_stride;
+    const size_t copy_size = size_t(x_end - x_begin) * pass_stride * sizeof(float);
+
+    for (int row = y_begin; row < y_end; row++) {
+      memcpy(pixels + (row - y) * row_size + (x_begin - x) * pass_stride,
+             src + (row - entry.y) * tile_row_size + (x_begin - entry.x) * pass_stride,
+             copy_size);
+    }
+  }
+
+  return true;
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,113 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#pragma once
+
+#include "util/mapped_file.h"
+#include "util/string.h"
+#include "util/types.h"
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Files with the tiles of a render in progress, in a raw format for fast writing and reading.
+ *
+ * The file starts with a header, followed by the float pixels of the tiles in the order they were
+ * written, the metadata and an index of the tiles. The pixels of a tile are stored as is, so they
+ * can be copied straight out of the memory mapped file, or compressed with LZ4 in independent
+ * chunks which are compressed and decompressed in parallel.
+ *
+ * The files are only meant to be read back by the same build that wrote them, there is no
+ * conversion between platforms or versions. */
+
+struct TileFileHeader {
+  char magic[8];
+  uint32_t version;
+  int32_t width;
+  int32_t height;
+  int32_t pass_stride;
+  uint64_t metadata_offset;
+  uint64_t metadata_size;
+  uint64_t index_offset;
+  uint64_t num_tiles;
+};
+
+struct TileFileEntry {
+  int32_t x, y;
+  int32_t width, height;
+  /* Pixels compressed in chunks, with a table of chunk sizes in front of the chunks. */
+  uint32_t compressed;
+  uint32_t num_chunks;
+  uint64_t offset;
+  uint64_t size;
+};
+
+class TileFileWriter {
+ public:
+  TileFileWriter() = default;
+  ~TileFileWriter();
+
+  TileFileWriter(const TileFileWriter &other) = delete;
+  TileFileWriter &operator=(const TileFileWriter &other) = delete;
+
+  /* Open file for writing, with metadata which is returned as is by the reader. */
+  bool open(const string &filepath,
+            const int width,
+            const int height,
+            const int pass_stride,
+            const string &metadata,
+            const bool use_compression);
+
+  /* Write pixels of a tile, stored without gaps. Tiles must not overlap. */
+  bool write_tile(const int x, const int y, const int width, const int height, const float *pixels);
+
+  /* Write metadata and index, and close the file. */
+  bool close();
+
+ protected:
+  bool write(const void *data, const size_t size);
+
+  FILE *file_ = nullptr;
+  TileFileHeader header_;
+  vector<TileFileEntry> entries_;
+  uint64_t offset_ = 0;
+  string metadata_;
+  bool use_compression_ = false;
+};
+
+class TileFileReader {
+ public:
+  bool open(const string &filepath);
+  void close();
+
+  int get_width() const
+  {
+    return header_.width;
+  }
+  int get_height() const
+  {
+    return header_.height;
+  }
+  int get_pass_stride() const
+  {
+    return header_.pass_stride;
+  }
+  const string &get_metadata() const
+  {
+    return metadata_;
+  }
+
+  /* Read pixels of a region into a buffer without gaps. Pixels which are not covered by any of
+   * the written tiles are set to zero. */
+  bool read_region(const int x, const int y, const int width, const int height, float *pixels);
+
+ protected:
+  bool read_tile(const TileFileEntry &entry, float *pixels) const;
+
+  MappedFile file_;
+  TileFileHeader header_ = {};
+  vector<TileFileEntry> entries_;
+  string metadata_;
+};
+
+CCL_NAMESPACE_END
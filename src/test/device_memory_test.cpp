@@ -0,0 +1,95 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#include "testing/testing.h"
+
+#include "device/device.h"
+#include "device/memory.h"
+
+#include "util/profiling.h"
+#include "util/stats.h"
+
+CCL_NAMESPACE_BEGIN
+
+TEST(device_memory, category)
+{
+  EXPECT_EQ(device_memory_category("bvh_nodes"), MEM_CATEGORY_BVH);
+  EXPECT_EQ(device_memory_category("prim_index"), MEM_CATEGORY_BVH);
+  EXPECT_EQ(device_memory_category("tri_verts"), MEM_CATEGORY_GEOMETRY);
+  EXPECT_EQ(device_memory_category("attributes_float3"), MEM_CATEGORY_ATTRIBUTES);
+  EXPECT_EQ(device_memory_category("objects"), MEM_CATEGORY_OBJECTS);
+  /* Matched before the objects prefix. */
+  EXPECT_EQ(device_memory_category("object_lookup_offset"), MEM_CATEGORY_LIGHTS);
+  EXPECT_EQ(device_memory_category("lights"), MEM_CATEGORY_LIGHTS);
+  EXPECT_EQ(device_memory_category("svm_nodes"), MEM_CATEGORY_SHADERS);
+  EXPECT_EQ(device_memory_category("RenderBuffers"), MEM_CATEGORY_RENDER_BUFFERS);
+  EXPECT_EQ(device_memory_category("integrator_state_path_flag"),
+            MEM_CATEGORY_INTEGRATOR_STATE);
+  EXPECT_EQ(device_memory_category("unknown"), MEM_CATEGORY_OTHER);
+  EXPECT_EQ(device_memory_category(nullptr), MEM_CATEGORY_OTHER);
+}
+
+TEST(device_memory, category_stats)
+{
+  Stats stats;
+  Profiler profiler;
+  DeviceInfo device_info;
+  unique_ptr<Device> device(Device::create(device_info, stats, profiler));
+
+  device_vector<float> buffers(device.get(), "RenderBuffers", MEM_READ_WRITE);
+  device_vector<float> bvh_nodes(device.get(), "bvh_nodes", MEM_READ_ONLY);
+  EXPECT_EQ(buffers.category(), MEM_CATEGORY_RENDER_BUFFERS);
+  EXPECT_EQ(bvh_nodes.category(), MEM_CATEGORY_BVH);
+
+  const size_t base_mem_used = stats.mem_used;
+
+  buffers.alloc(256);
+  buffers.copy_to_device();
+  bvh_nodes.alloc(64);
+  bvh_nodes.copy_to_device();
+
+  EXPECT_EQ(stats.category_mem_used[MEM_CATEGORY_RENDER_BUFFERS], 256 * sizeof(float));
+  EXPECT_EQ(stats.category_mem_used[MEM_CATEGORY_BVH], 64 * sizeof(float));
+  EXPECT_EQ(stats.mem_used, base_mem_used + (256 + 64) * sizeof(float));
+
+  buffers.free();
+
+  EXPECT_EQ(stats.category_mem_used[MEM_CATEGORY_RENDER_BUFFERS], size_t(0));
+  EXPECT_EQ(stats.category_mem_peak[MEM_CATEGORY_RENDER_BUFFERS], 256 * sizeof(float));
+  EXPECT_EQ(stats.category_mem_used[MEM_CATEGORY_BVH], 64 * sizeof(float));
+  EXPECT_EQ(stats.mem_used, base_mem_used + 64 * sizeof(float));
+
+  bvh_nodes.free();
+
+  EXPECT_EQ(stats.category_mem_used[MEM_CATEGORY_BVH], size_t(0));
+  EXPECT_EQ(stats.mem_used, base_mem_used);
+}
+
+/* Budgets are soft limits that are only checked, never enforced. */
+TEST(Stats, mem_budget)
+{
+  Stats stats;
+
+  stats.set_mem_budget(MEM_CATEGORY_TEXTURES, 1000);
+  stats.mem_alloc(600, MEM_CATEGORY_TEXTURES);
+  stats.mem_alloc(800, MEM_CATEGORY_GEOMETRY);
+
+  EXPECT_FALSE(stats.mem_exceeds_budget(MEM_CATEGORY_TEXTURES));
+  EXPECT_FALSE(stats.mem_exceeds_budget(MEM_CATEGORY_TEXTURES, 400));
+  EXPECT_TRUE(stats.mem_exceeds_budget(MEM_CATEGORY_TEXTURES, 401));
+  /* No budget for the category. */
+  EXPECT_FALSE(stats.mem_exceeds_budget(MEM_CATEGORY_GEOMETRY, 1000000));
+
+  EXPECT_EQ(stats.mem_used, size_t(1400));
+  EXPECT_EQ(stats.mem_peak, size_t(1400));
+
+  stats.mem_free(600, MEM_CATEGORY_TEXTURES);
+
+  EXPECT_EQ(stats.category_mem_used[MEM_CATEGORY_TEXTURES], size_t(0));
+  EXPECT_EQ(stats.category_mem_peak[MEM_CATEGORY_TEXTURES], size_t(600));
+  EXPECT_EQ(stats.category_mem_used[MEM_CATEGORY_GEOMETRY], size_t(800));
+  EXPECT_EQ(stats.mem_used, size_t(800));
+  EXPECT_EQ(stats.mem_peak, size_t(1400));
+}
+
+CCL_NAMESPACE_END
@@ -3,7 +3,13 @@
 
 #include "testing/testing.h"
 
+#include "device/cpu/kernel.h"
+
 #include "integrator/adaptive_sampling.h"
+
+#include "kernel/device/cpu/compat.h"
+#include "kernel/device/cpu/globals.h"
+
 #include "util/vector.h"
 
 CCL_NAMESPACE_BEGIN
@@ -100,4 +106,136 @@ TEST(AdaptiveSampling, need_filter)
   EXPECT_EQ(actual_samples_to_filter, expected_samples_to_filter);
 }
 
+TEST(AdaptiveSampling, budget_threshold)
+{
+  AdaptiveSampling adaptive_sampling;
+  adaptive_sampling.use = true;
+  adaptive_sampling.sample_budget = 16.0f;
+
+  /* 100 pixels with the budget of 16 samples per pixel: 1600 samples in total. */
+
+  /* Remaining samples of the active pixels fit into the budget. */
+  EXPECT_EQ(adaptive_sampling.budget_threshold(0.1f, 100, 800, 50, 16), 0.1f);
+
+  /* Active pixels need 4 times more samples than left in the budget: threshold is raised by the
+   * square root of it. */
+  EXPECT_NEAR(adaptive_sampling.budget_threshold(0.1f, 100, 1200, 100, 16), 0.2f, 1e-6f);
+
+  /* Budget is used up. */
+  EXPECT_EQ(adaptive_sampling.budget_threshold(0.1f, 100, 1600, 10, 16), FLT_MAX);
+
+  /* No budget. */
+  adaptive_sampling.sample_budget = 0.0f;
+  EXPECT_EQ(adaptive_sampling.budget_threshold(0.1f, 100, 1600, 100, 16), 0.1f);
+}
+
+/* Render buffer with the combined and adaptive auxiliary passes and the sample count, in which
+ * every pixel has converged except for one pixel with the given error. */
+class AdaptiveSamplingBlocks : public testing::Test {
+ protected:
+  static constexpr int size = 16;
+  static constexpr int pass_stride = 9;
+  static constexpr int num_samples = 4;
+
+  KernelGlobalsCPU kg;
+  CPUKernels kernels;
+  vector<float> render_buffer;
+
+  virtual void SetUp()
+  {
+    memset(&kg.data, 0, sizeof(kg.data));
+    kg.data.film.pass_stride = pass_stride;
+    kg.data.film.pass_combined = 0;
+    kg.data.film.pass_adaptive_aux_buffer = 4;
+    kg.data.film.pass_sample_count = 8;
+    kg.data.film.exposure = 1.0f;
+    /* Blocks of 4, 8 and 16 pixels. */
+    kg.data.integrator.adaptive_block_size = 4;
+
+    render_buffer.resize(size * size * pass_stride);
+    for (int i = 0; i < size * size; i++) {
+      float *pixel = &render_buffer[i * pass_stride];
+      for (int c = 0; c < 4; c++) {
+        pixel[c] = num_samples;
+        pixel[4 + c] = num_samples;
+      }
+      pixel[4 + 3] = 0.0f;
+      *(uint *)(pixel + 8) = num_samples;
+    }
+  }
+
+  /* The difference is per channel and relative to the intensity of the pixel, which makes it the
+   * error of the pixel. */
+  void set_pixel_error(const int x, const int y, const float error)
+  {
+    float *pixel = &render_buffer[(x + y * size) * pass_stride];
+    for (int c = 0; c < 3; c++) {
+      pixel[4 + c] = num_samples * (1.0f - error);
+    }
+  }
+
+  /* Check the pixels and then the blocks, returns the number of active pixels. */
+  int converge(const float threshold)
+  {
+    int num_active_pixels = 0;
+    for (int y = 0; y < size; y++) {
+      for (int x = 0; x < size; x++) {
+        if (!kernels.adaptive_sampling_convergence_check(
+                &kg, render_buffer.data(), x, y, threshold, false, 0, size))
+        {
+          num_active_pixels++;
+        }
+      }
+    }
+    num_active_pixels += kernels.adaptive_sampling_convergence_check_block(
+        &kg, render_buffer.data(), 0, 0, 0, size, size, threshold, 0, size);
+    return num_active_pixels;
+  }
+
+  bool is_active(const int x, const int y)
+  {
+    return render_buffer[(x + y * size) * pass_stride + 4 + 3] == 0.0f;
+  }
+};
+
+/* Error of the pixel is below the threshold when averaged over the whole region, so only the
+ * pixel itself is sampled. */
+TEST_F(AdaptiveSamplingBlocks, converged_region)
+{
+  set_pixel_error(5, 6, 0.1f);
+
+  EXPECT_EQ(converge(0.01f), 1);
+  EXPECT_TRUE(is_active(5, 6));
+  EXPECT_FALSE(is_active(4, 6));
+}
+
+/* Error of the pixel is far above the threshold when averaged over the blocks of 8x8 pixels, so
+ * that block is sampled as a whole. */
+TEST_F(AdaptiveSamplingBlocks, active_block)
+{
+  set_pixel_error(5, 6, 5.0f);
+
+  EXPECT_EQ(converge(0.01f), 64);
+  EXPECT_TRUE(is_active(0, 0));
+  EXPECT_TRUE(is_active(7, 7));
+  EXPECT_FALSE(is_active(8, 7));
+  EXPECT_FALSE(is_active(7, 8));
+}
+
+/* Error of the smallest block of 4x4 pixels is above the threshold, while the larger blocks are
+ * below the threshold or close enough to it to be split. */
+TEST_F(AdaptiveSamplingBlocks, active_smallest_block)
+{
+  set_pixel_error(5, 6, 1.0f);
+  set_pixel_error(12, 12, 1.0f);
+  set_pixel_error(13, 13, 1.0f);
+
+  EXPECT_EQ(converge(0.01f), 16 + 16);
+  EXPECT_TRUE(is_active(4, 4));
+  EXPECT_TRUE(is_active(7, 7));
+  EXPECT_FALSE(is_active(3, 7));
+  EXPECT_FALSE(is_active(8, 7));
+  EXPECT_TRUE(is_active(12, 15));
+}
+
 CCL_NAMESPACE_END
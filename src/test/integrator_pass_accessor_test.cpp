@@ -0,0 +1,71 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#include "testing/testing.h"
+
+#include "device/device.h"
+
+#include "integrator/pass_accessor_cpu.h"
+
+#include "scene/pass.h"
+
+#include "session/buffers.h"
+
+#include "util/profiling.h"
+#include "util/stats.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* The render time pass accumulates the time of all samples, and is read as the time per
+ * sample. */
+TEST(PassAccessor, render_time_per_sample)
+{
+  Stats stats;
+  Profiler profiler;
+  DeviceInfo device_info;
+  unique_ptr<Device> device(Device::create(device_info, stats, profiler));
+
+  Pass render_time_pass;
+  render_time_pass.set_type(PASS_RENDER_TIME);
+  render_time_pass.set_name(ustring("Render Time"));
+  Pass sample_count_pass;
+  sample_count_pass.set_type(PASS_SAMPLE_COUNT);
+  sample_count_pass.set_name(ustring("Sample Count"));
+
+  BufferParams buffer_params;
+  buffer_params.width = buffer_params.window_width = buffer_params.full_width = 2;
+  buffer_params.height = buffer_params.window_height = buffer_params.full_height = 1;
+  buffer_params.update_passes({&render_time_pass, &sample_count_pass});
+
+  RenderBuffers render_buffers(device.get());
+  render_buffers.reset(buffer_params);
+  render_buffers.zero();
+
+  const int pass_stride = buffer_params.pass_stride;
+  const int render_time_offset = buffer_params.get_pass_offset(PASS_RENDER_TIME);
+  const int sample_count_offset = buffer_params.get_pass_offset(PASS_SAMPLE_COUNT);
+  ASSERT_NE(render_time_offset, PASS_UNUSED);
+  ASSERT_NE(sample_count_offset, PASS_UNUSED);
+
+  /* Pixels with a different number of samples, as with adaptive sampling. */
+  float *buffer = render_buffers.buffer.data();
+  buffer[render_time_offset] = 60.0f;
+  *(uint *)(buffer + sample_count_offset) = 4;
+  buffer[pass_stride + render_time_offset] = 8.0f;
+  *(uint *)(buffer + pass_stride + sample_count_offset) = 1;
+
+  const BufferPass *buffer_pass = buffer_params.find_pass(PASS_RENDER_TIME);
+  ASSERT_NE(buffer_pass, nullptr);
+
+  PassAccessor::PassAccessInfo pass_access_info(*buffer_pass);
+  const PassAccessorCPU pass_accessor(pass_access_info, 1.0f, 4);
+
+  float pixels[2] = {0.0f, 0.0f};
+  ASSERT_TRUE(pass_accessor.get_render_tile_pixels(&render_buffers,
+                                                   PassAccessor::Destination(pixels, 1)));
+
+  EXPECT_FLOAT_EQ(pixels[0], 15.0f);
+  EXPECT_FLOAT_EQ(pixels[1], 8.0f);
+}
+
+CCL_NAMESPACE_END
@@ -3,7 +3,11 @@
 
 #include "testing/testing.h"
 
+#include "device/denoise.h"
 #include "integrator/render_scheduler.h"
+#include "session/buffers.h"
+#include "session/session.h"
+#include "session/tile.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -21,4 +25,120 @@ TEST(IntegratorRenderScheduler, calculate_resolution_for_divider)
   EXPECT_EQ(calculate_resolution_for_divider(1920, 1080, 4), 360);
 }
 
+namespace {
+
+class BudgetRenderScheduler : public RenderScheduler {
+ public:
+  using RenderScheduler::RenderScheduler;
+  using RenderScheduler::budget_get_num_samples_fit;
+};
+
+class RenderSchedulerBudget : public testing::Test {
+ protected:
+  RenderSchedulerBudget() : scheduler(tile_manager, session_params())
+  {
+    buffer_params.width = buffer_params.full_width = 64;
+    buffer_params.height = buffer_params.full_height = 64;
+
+    work.path_trace.start_sample = 0;
+    work.path_trace.num_samples = 1;
+  }
+
+  static SessionParams session_params()
+  {
+    SessionParams params;
+    params.background = true;
+    params.use_time_budget = true;
+    return params;
+  }
+
+  void use_denoiser()
+  {
+    DenoiseParams denoise_params;
+    denoise_params.use = true;
+    scheduler.set_denoiser_params(denoise_params);
+  }
+
+  /* Start render with a 10 seconds budget. */
+  void begin_render()
+  {
+    tile_manager.reset_scheduling(buffer_params, tile_size);
+    scheduler.set_time_limit(10.0);
+    scheduler.reset(buffer_params, 1000, 0);
+    scheduler.report_work_begin(work);
+  }
+
+  /* Render the first sample, which took 0.1 seconds. */
+  void render_first_sample()
+  {
+    begin_render();
+    scheduler.report_path_trace_time(work, 0.1, false);
+  }
+
+  TileManager tile_manager;
+  BudgetRenderScheduler scheduler;
+  BufferParams buffer_params;
+  int2 tile_size = make_int2(64, 64);
+  RenderWork work;
+};
+
+}  // namespace
+
+TEST_F(RenderSchedulerBudget, not_measured)
+{
+  begin_render();
+
+  EXPECT_EQ(scheduler.budget_get_num_samples_fit(), INT_MAX);
+}
+
+TEST_F(RenderSchedulerBudget, no_denoise)
+{
+  render_first_sample();
+
+  /* 9.5 seconds without the safety margin, 0.2 of which are reserved for the tile write. */
+  EXPECT_NEAR(scheduler.budget_get_num_samples_fit(), 93, 1);
+}
+
+TEST_F(RenderSchedulerBudget, denoise_not_measured)
+{
+  use_denoiser();
+  render_first_sample();
+
+  /* 1 second is reserved for the denoiser which did not run yet. */
+  EXPECT_NEAR(scheduler.budget_get_num_samples_fit(), 83, 1);
+}
+
+TEST_F(RenderSchedulerBudget, denoise_measured)
+{
+  use_denoiser();
+  render_first_sample();
+  scheduler.report_denoise_time(work, 0.5);
+
+  EXPECT_NEAR(scheduler.budget_get_num_samples_fit(), 88, 1);
+}
+
+TEST_F(RenderSchedulerBudget, denoise_multiple_tiles)
+{
+  tile_size = make_int2(32, 32);
+  use_denoiser();
+  render_first_sample();
+
+  ASSERT_TRUE(tile_manager.has_multiple_tiles());
+
+  /* The full frame is denoised after the tiles, and every tile reserves its share of it. */
+  EXPECT_NEAR(scheduler.budget_get_num_samples_fit(), 83, 1);
+}
+
+TEST_F(RenderSchedulerBudget, adaptive_sampling_active_pixels)
+{
+  begin_render();
+  scheduler.report_adaptive_sampling_active_pixels(1000);
+  scheduler.report_path_trace_time(work, 0.1, false);
+  EXPECT_NEAR(scheduler.budget_get_num_samples_fit(), 93, 1);
+
+  /* A quarter of the pixels is left active, so a sample takes a quarter of the time. */
+  scheduler.report_adaptive_sampling_active_pixels(250);
+  EXPECT_NEAR(scheduler.budget_get_num_samples_fit(), 372, 4);
+}
+
 CCL_NAMESPACE_END
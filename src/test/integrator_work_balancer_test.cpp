@@ -0,0 +1,54 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#include "testing/testing.h"
+
+#include "integrator/work_balancer.h"
+
+CCL_NAMESPACE_BEGIN
+
+TEST(IntegratorWorkBalancer, rebalance_from_throughput)
+{
+  vector<WorkBalanceInfo> infos(2);
+  work_balance_do_initial(infos);
+
+  /* First work renders twice as fast as the second one. */
+  infos[0].time_spent = 1.0;
+  infos[0].num_pixel_samples = 2000.0;
+  infos[1].time_spent = 1.0;
+  infos[1].num_pixel_samples = 1000.0;
+
+  EXPECT_TRUE(work_balance_do_rebalance(infos));
+  EXPECT_NEAR(infos[0].weight, 2.0 / 3.0, 1e-6);
+  EXPECT_NEAR(infos[1].weight, 1.0 / 3.0, 1e-6);
+  EXPECT_EQ(infos[0].time_spent, 0.0);
+  EXPECT_EQ(infos[0].num_pixel_samples, 0.0);
+
+  /* Same measured throughput keeps the balance. */
+  infos[0].time_spent = 1.0;
+  infos[0].num_pixel_samples = 2000.0;
+  infos[1].time_spent = 1.0;
+  infos[1].num_pixel_samples = 1000.0;
+
+  EXPECT_FALSE(work_balance_do_rebalance(infos));
+}
+
+TEST(IntegratorWorkBalancer, balance_from_throughput)
+{
+  vector<WorkBalanceInfo> infos(2);
+  work_balance_do_initial(infos);
+
+  /* Nothing is known about the works yet. */
+  EXPECT_FALSE(work_balance_do_from_throughput(infos));
+  EXPECT_EQ(infos[0].weight, 0.5);
+
+  /* Throughput kept from a previous render is used for the initial split. */
+  infos[0].throughput = 3000.0;
+  infos[1].throughput = 1000.0;
+
+  EXPECT_TRUE(work_balance_do_from_throughput(infos));
+  EXPECT_NEAR(infos[0].weight, 0.75, 1e-6);
+  EXPECT_NEAR(infos[1].weight, 0.25, 1e-6);
+}
+
+CCL_NAMESPACE_END
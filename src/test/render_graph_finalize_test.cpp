@@ -1523,4 +1523,105 @@ TEST_F(RenderGraph, constant_fold_convert_color_float_color)
   graph.finalize(scene);
 }
 
+/*
+ * Tests:
+ *  - Volume density read from an attribute is zero outside of the grids, if the attribute is a
+ *    voxel attribute.
+ */
+TEST_F(RenderGraph, volume_zero_without_attributes_density)
+{
+  EXPECT_ANY_MESSAGE(log);
+
+  builder.add_attribute("Attribute")
+      .add_node(ShaderNodeBuilder<MathNode>(graph, "Math")
+                    .set_param("math_type", NODE_MATH_MULTIPLY)
+                    .set("Value2", 10.0f))
+      .add_node(ShaderNodeBuilder<ScatterVolumeNode>(graph, "Scatter"))
+      .add_connection("Attribute::Fac", "Math::Value1")
+      .add_connection("Math::Value", "Scatter::Density")
+      .add_connection("Scatter::Volume", "Output::Volume");
+
+  graph.finalize(scene);
+
+  vector<ustring> required_attributes;
+  EXPECT_TRUE(graph.volume_is_zero_without_attributes(required_attributes));
+  ASSERT_EQ(required_attributes.size(), size_t(1));
+  EXPECT_EQ(required_attributes[0], ustring("Attribute"));
+}
+
+/*
+ * Tests:
+ *  - Volume density with a constant offset is not zero outside of the grids.
+ */
+TEST_F(RenderGraph, volume_zero_without_attributes_density_offset)
+{
+  EXPECT_ANY_MESSAGE(log);
+
+  builder.add_attribute("Attribute")
+      .add_node(ShaderNodeBuilder<MathNode>(graph, "Math")
+                    .set_param("math_type", NODE_MATH_ADD)
+                    .set("Value2", 0.1f))
+      .add_node(ShaderNodeBuilder<ScatterVolumeNode>(graph, "Scatter"))
+      .add_connection("Attribute::Fac", "Math::Value1")
+      .add_connection("Math::Value", "Scatter::Density")
+      .add_connection("Scatter::Volume", "Output::Volume");
+
+  graph.finalize(scene);
+
+  vector<ustring> required_attributes;
+  EXPECT_FALSE(graph.volume_is_zero_without_attributes(required_attributes));
+  EXPECT_TRUE(required_attributes.empty());
+}
+
+/*
+ * Tests:
+ *  - Principled volume density multiplied by the density attribute requires that attribute.
+ */
+TEST_F(RenderGraph, volume_zero_without_attributes_principled)
+{
+  EXPECT_ANY_MESSAGE(log);
+
+  builder
+      .add_node(ShaderNodeBuilder<PrincipledVolumeNode>(graph, "Principled")
+                    .set_param("density_attribute", ustring("density"))
+                    .set_param("temperature_attribute", ustring())
+                    .set("Density", 1.0f)
+                    .set("Emission Strength", 0.0f)
+                    .set("Blackbody Intensity", 0.0f))
+      .add_connection("Principled::Volume", "Output::Volume");
+
+  graph.finalize(scene);
+
+  vector<ustring> required_attributes;
+  EXPECT_TRUE(graph.volume_is_zero_without_attributes(required_attributes));
+  ASSERT_EQ(required_attributes.size(), size_t(1));
+  EXPECT_EQ(required_attributes[0], ustring("density"));
+}
+
+/*
+ * Tests:
+ *  - Principled volume with constant density is not zero outside of the grids, even if other
+ *    inputs are read from attributes.
+ */
+TEST_F(RenderGraph, volume_zero_without_attributes_principled_constant_density)
+{
+  EXPECT_ANY_MESSAGE(log);
+
+  builder.add_attribute("Attribute")
+      .add_node(ShaderNodeBuilder<PrincipledVolumeNode>(graph, "Principled")
+                    .set_param("density_attribute", ustring())
+                    .set_param("temperature_attribute", ustring())
+                    .set("Density", 1.0f)
+                    .set("Emission Strength", 0.0f)
+                    .set("Blackbody Intensity", 0.0f))
+      .add_connection("Attribute::Color", "Principled::Color")
+      .add_connection("Principled::Volume", "Output::Volume");
+
+  graph.finalize(scene);
+
+  vector<ustring> required_attributes;
+  EXPECT_FALSE(graph.volume_is_zero_without_attributes(required_attributes));
+  EXPECT_TRUE(required_attributes.empty());
+}
+
 CCL_NAMESPACE_END
@@ -0,0 +1,309 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#include "testing/testing.h"
+
+#include "device/device.h"
+
+#include "scene/rhino_shader_nodes.h"
+#include "scene/scene.h"
+#include "scene/shader.h"
+#include "scene/shader_graph.h"
+#include "scene/shader_nodes.h"
+#include "scene/svm.h"
+
+#include "util/array.h"
+#include "util/stats.h"
+#include "util/string.h"
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+namespace {
+
+template<typename T> class ShaderNodeBuilder {
+ public:
+  ShaderNodeBuilder(ShaderGraph &graph, const string &name) : name_(name)
+  {
+    node_ = graph.create_node<T>();
+    node_->name = name;
+  }
+
+  const string &name() const
+  {
+    return name_;
+  }
+
+  ShaderNode *node() const
+  {
+    return node_;
+  }
+
+  template<typename V> ShaderNodeBuilder &set_param(const string &input_name, V value)
+  {
+    const SocketType *input_socket = node_->type->find_input(ustring(input_name.c_str()));
+    EXPECT_NE((void *)NULL, input_socket);
+    node_->set(*input_socket, value);
+    return *this;
+  }
+
+ protected:
+  string name_;
+  ShaderNode *node_;
+};
+
+class ShaderGraphBuilder {
+ public:
+  ShaderGraphBuilder(ShaderGraph *graph) : graph_(graph)
+  {
+    node_map_["Output"] = graph->output();
+  }
+
+  ShaderNode *find_node(const string &name)
+  {
+    map<string, ShaderNode *>::iterator it = node_map_.find(name);
+    if (it == node_map_.end()) {
+      return NULL;
+    }
+    return it->second;
+  }
+
+  template<typename T> ShaderGraphBuilder &add_node(const T &node)
+  {
+    EXPECT_EQ(find_node(node.name()), (void *)NULL);
+    graph_->add(node.node());
+    node_map_[node.name()] = node.node();
+    return *this;
+  }
+
+  ShaderGraphBuilder &add_connection(const string &from, const string &to)
+  {
+    vector<string> tokens_from, tokens_to;
+    string_split(tokens_from, from, "::");
+    string_split(tokens_to, to, "::");
+    EXPECT_EQ(tokens_from.size(), 2);
+    EXPECT_EQ(tokens_to.size(), 2);
+    ShaderNode *node_from = find_node(tokens_from[0]), *node_to = find_node(tokens_to[0]);
+    EXPECT_NE((void *)NULL, node_from);
+    EXPECT_NE((void *)NULL, node_to);
+    ShaderOutput *socket_from = node_from->output(tokens_from[1].c_str());
+    ShaderInput *socket_to = node_to->input(tokens_to[1].c_str());
+    EXPECT_NE((void *)NULL, socket_from);
+    EXPECT_NE((void *)NULL, socket_to);
+    graph_->connect(socket_from, socket_to);
+    return *this;
+  }
+
+  ShaderGraphBuilder &output_color(const string &from)
+  {
+    return (*this)
+        .add_node(ShaderNodeBuilder<EmissionNode>(*graph_, "EmissionNode"))
+        .add_connection(from, "EmissionNode::Color")
+        .add_connection("EmissionNode::Emission", "Output::Surface");
+  }
+
+ protected:
+  ShaderGraph *graph_;
+  map<string, ShaderNode *> node_map_;
+};
+
+/* Compiler giving access to the nodes it generates, to add nodes without a shader graph. */
+class SVMCompilerNodes : public SVMCompiler {
+ public:
+  explicit SVMCompilerNodes(Scene *scene) : SVMCompiler(scene)
+  {
+  }
+
+  using SVMCompiler::add_jump_node;
+  using SVMCompiler::current_svm_nodes;
+  using SVMCompiler::fuse_nodes_barrier;
+  using SVMCompiler::num_fused_nodes;
+  using SVMCompiler::set_jump_target;
+};
+
+}  // namespace
+
+class RenderSVMFuseNodes : public testing::Test {
+ protected:
+  Stats stats;
+  Profiler profiler;
+  DeviceInfo device_info;
+  Device *device_cpu;
+  SceneParams scene_params;
+  Scene *scene;
+  Shader *shader;
+  ShaderGraph *graph;
+  ShaderGraphBuilder *builder;
+  SVMCompiler::Summary summary;
+  array<int4> svm_nodes;
+  vector<int> node_starts;
+
+  virtual void SetUp()
+  {
+    device_cpu = Device::create(device_info, stats, profiler);
+    scene = new Scene(scene_params, device_cpu);
+    shader = scene->create_node<Shader>();
+    graph = new ShaderGraph();
+    builder = new ShaderGraphBuilder(graph);
+  }
+
+  virtual void TearDown()
+  {
+    delete builder;
+    delete scene;
+    delete device_cpu;
+  }
+
+  void compile()
+  {
+    shader->set_graph(graph);
+
+    SVMCompiler compiler(scene);
+    compiler.compile(shader, svm_nodes, 0, &summary);
+    node_starts = compiler.node_starts;
+  }
+
+  /* Check the pair is fused into a single node directly followed by the second node, in place of
+   * the first node. */
+  void expect_fused(ShaderNodeType first,
+                    ShaderNodeType second,
+                    ShaderNodeType fused,
+                    const string &name)
+  {
+    EXPECT_EQ(summary.num_fused_nodes, 1);
+    EXPECT_EQ(summary.fused_nodes[name], 1);
+    EXPECT_EQ(SVMCompiler::unfused_node_type(fused), first);
+
+    int num_found = 0;
+    for (size_t i = 0; i < node_starts.size(); i++) {
+      const int4 &node = svm_nodes[node_starts[i]];
+      EXPECT_NE(node.x, first);
+      if (node.x == fused) {
+        /* The second node and the data of both nodes are left in place, so the program size and
+         * offsets of nodes are the same as without fusing. */
+        ASSERT_LT(i + 1, node_starts.size());
+        EXPECT_EQ(svm_nodes[node_starts[i + 1]].x, second);
+        num_found++;
+      }
+    }
+    EXPECT_EQ(num_found, 1);
+  }
+};
+
+TEST_F(RenderSVMFuseNodes, tex_coord_matrix_math)
+{
+  (*builder)
+      .add_node(ShaderNodeBuilder<RhinoTextureCoordinateNode>(*graph, "TextureCoordinate"))
+      .add_node(ShaderNodeBuilder<MatrixMathNode>(*graph, "MatrixMath"))
+      .add_connection("TextureCoordinate::Normal", "MatrixMath::Vector")
+      .output_color("MatrixMath::Vector");
+
+  compile();
+
+  expect_fused(RHINO_NODE_TEX_COORD,
+               RHINO_NODE_MATRIX_MATH,
+               RHINO_NODE_FUSED_TEX_COORD_MATRIX_MATH,
+               "Texture Coordinate + Matrix Math");
+}
+
+TEST_F(RenderSVMFuseNodes, attr_matrix_math)
+{
+  (*builder)
+      .add_node(ShaderNodeBuilder<AttributeNode>(*graph, "Attribute")
+                    .set_param("attribute", ustring("Attribute")))
+      .add_node(ShaderNodeBuilder<MatrixMathNode>(*graph, "MatrixMath"))
+      .add_connection("Attribute::Vector", "MatrixMath::Vector")
+      .output_color("MatrixMath::Vector");
+
+  compile();
+
+  expect_fused(NODE_ATTR,
+               RHINO_NODE_MATRIX_MATH,
+               RHINO_NODE_FUSED_ATTR_MATRIX_MATH,
+               "Attribute + Matrix Math");
+}
+
+TEST_F(RenderSVMFuseNodes, matrix_math_tex_image)
+{
+  (*builder)
+      .add_node(ShaderNodeBuilder<MatrixMathNode>(*graph, "MatrixMath"))
+      .add_node(ShaderNodeBuilder<ImageTextureNode>(*graph, "ImageTexture"))
+      .add_connection("MatrixMath::Vector", "ImageTexture::Vector")
+      .output_color("ImageTexture::Color");
+
+  compile();
+
+  expect_fused(RHINO_NODE_MATRIX_MATH,
+               NODE_TEX_IMAGE,
+               RHINO_NODE_FUSED_MATRIX_MATH_TEX_IMAGE,
+               "Matrix Math + Image Texture");
+}
+
+TEST_F(RenderSVMFuseNodes, tex_image_texture_adjustment)
+{
+  (*builder)
+      .add_node(ShaderNodeBuilder<ImageTextureNode>(*graph, "ImageTexture"))
+      .add_node(
+          ShaderNodeBuilder<RhinoTextureAdjustmentTextureNode>(*graph, "TextureAdjustment"))
+      .add_connection("ImageTexture::Color", "TextureAdjustment::Color")
+      .output_color("TextureAdjustment::Color");
+
+  compile();
+
+  expect_fused(NODE_TEX_IMAGE,
+               RHINO_NODE_TEXTURE_ADJUSTMENT_TEXTURE,
+               RHINO_NODE_FUSED_TEX_IMAGE_TEXTURE_ADJUSTMENT,
+               "Image Texture + Texture Adjustment");
+}
+
+/* Data between a node of fixed size and the next node was not added by the first node. */
+TEST_F(RenderSVMFuseNodes, data_gap)
+{
+  SVMCompilerNodes compiler(scene);
+  compiler.add_node(NODE_ATTR, 0, 0, NODE_ATTR_OUTPUT_FLOAT3);
+  compiler.add_node(0, 0, 0, 0);
+  compiler.add_node(RHINO_NODE_MATRIX_MATH, NODE_MATRIX_MATH_POINT, 0, 1);
+  compiler.add_node(zero_float4());
+  compiler.add_node(zero_float4());
+  compiler.add_node(zero_float4());
+  compiler.fuse_nodes_barrier();
+
+  EXPECT_EQ(compiler.num_fused_nodes, 0);
+  ASSERT_EQ(compiler.current_svm_nodes.size(), 6);
+  EXPECT_EQ(compiler.current_svm_nodes[0].x, NODE_ATTR);
+  EXPECT_EQ(compiler.current_svm_nodes[2].x, RHINO_NODE_MATRIX_MATH);
+}
+
+/* Nodes are not fused across a jump node, or with a node which is the target of a jump. */
+TEST_F(RenderSVMFuseNodes, jump)
+{
+  SVMCompilerNodes compiler(scene);
+  compiler.add_node(NODE_ATTR, 0, 0, NODE_ATTR_OUTPUT_FLOAT3);
+  const int jump_index = compiler.add_jump_node(NODE_JUMP_IF_ZERO, 0);
+  compiler.add_node(RHINO_NODE_MATRIX_MATH, NODE_MATRIX_MATH_POINT, 0, 1);
+  compiler.add_node(zero_float4());
+  compiler.add_node(zero_float4());
+  compiler.add_node(zero_float4());
+  compiler.set_jump_target(jump_index);
+  compiler.add_node(NODE_TEX_IMAGE, -1, 0, 0);
+  compiler.add_node(0, 0, 0, 0);
+  compiler.add_node(RHINO_NODE_TEXTURE_ADJUSTMENT_TEXTURE, 0);
+  compiler.add_node(0, 0, 0, 0);
+  compiler.add_node(0, 0, 0, 0);
+  compiler.add_node(0, 0, 0, 0);
+  compiler.fuse_nodes_barrier();
+
+  /* Only the nodes after the jump target are fused, the program size and jump offset are
+   * unchanged. */
+  const array<int4> &nodes = compiler.current_svm_nodes;
+  EXPECT_EQ(compiler.num_fused_nodes, 1);
+  ASSERT_EQ(nodes.size(), 12);
+  EXPECT_EQ(nodes[0].x, NODE_ATTR);
+  EXPECT_EQ(nodes[1].x, NODE_JUMP_IF_ZERO);
+  EXPECT_EQ(nodes[1].y, 4);
+  EXPECT_EQ(nodes[2].x, RHINO_NODE_MATRIX_MATH);
+  EXPECT_EQ(nodes[6].x, RHINO_NODE_FUSED_TEX_IMAGE_TEXTURE_ADJUSTMENT);
+  EXPECT_EQ(nodes[8].x, RHINO_NODE_TEXTURE_ADJUSTMENT_TEXTURE);
+}
+
+CCL_NAMESPACE_END
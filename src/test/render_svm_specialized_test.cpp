@@ -0,0 +1,125 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#include "testing/testing.h"
+
+#include "scene/svm_specialized.h"
+
+#include "kernel/svm/types.h"
+
+#include "util/array.h"
+#include "util/path.h"
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+namespace {
+
+/* Builds nodes the way SVMCompiler does, with the shader jump node first. */
+class SVMNodesBuilder {
+ public:
+  SVMNodesBuilder()
+  {
+    add_node(NODE_SHADER_JUMP, 1, 0, 0);
+  }
+
+  SVMNodesBuilder &add_node(const int type, const int a = 0, const int b = 0, const int c = 0)
+  {
+    starts.push_back(nodes.size());
+    nodes.push_back_slow(make_int4(type, a, b, c));
+    return *this;
+  }
+
+  SVMNodesBuilder &add_data(const int a = 0, const int b = 0, const int c = 0, const int d = 0)
+  {
+    nodes.push_back_slow(make_int4(a, b, c, d));
+    return *this;
+  }
+
+  array<int4> nodes;
+  vector<int> starts;
+};
+
+}  // namespace
+
+TEST(render_svm_specialized, hash)
+{
+  SVMNodesBuilder a;
+  a.add_node(NODE_VALUE_F, 0, 1).add_node(NODE_CLOSURE_WEIGHT, 1).add_node(NODE_END);
+  SVMNodesBuilder b;
+  b.add_node(NODE_VALUE_F, 0, 1).add_node(NODE_CLOSURE_WEIGHT, 1).add_node(NODE_END);
+  SVMNodesBuilder c;
+  c.add_node(NODE_VALUE_F, 0, 2).add_node(NODE_CLOSURE_WEIGHT, 2).add_node(NODE_END);
+
+  const string hash = svm_specialized_hash(a.nodes, a.starts);
+  EXPECT_FALSE(hash.empty());
+  EXPECT_EQ(hash, svm_specialized_hash(b.nodes, b.starts));
+  EXPECT_NE(hash, svm_specialized_hash(c.nodes, c.starts));
+}
+
+TEST(render_svm_specialized, not_specialized)
+{
+  /* No end node. */
+  SVMNodesBuilder a;
+  a.add_node(NODE_VALUE_F, 0, 1);
+  EXPECT_TRUE(svm_specialized_hash(a.nodes, a.starts).empty());
+
+  /* No surface nodes. */
+  SVMNodesBuilder b;
+  b.add_node(NODE_END);
+  EXPECT_TRUE(svm_specialized_hash(b.nodes, b.starts).empty());
+
+  /* Jump into the data of a node. */
+  SVMNodesBuilder c;
+  c.add_node(NODE_JUMP_IF_ZERO, 1, 0).add_node(NODE_VALUE_V, 1).add_data().add_node(NODE_END);
+  EXPECT_TRUE(svm_specialized_hash(c.nodes, c.starts).empty());
+}
+
+TEST(render_svm_specialized, source)
+{
+  SVMNodesBuilder a;
+  a.add_node(NODE_JUMP_IF_ZERO, 2, 0)
+      .add_node(NODE_VALUE_V, 1)
+      .add_data()
+      .add_node(NODE_CLOSURE_WEIGHT, 1)
+      .add_node(NODE_END);
+
+  const string hash = svm_specialized_hash(a.nodes, a.starts);
+  ASSERT_FALSE(hash.empty());
+
+  const string source = svm_specialized_source(a.nodes, a.starts, hash, "Material");
+  EXPECT_NE(source.find("cycles_svm_specialized_" + hash), string::npos);
+  EXPECT_NE(source.find("goto node_3;"), string::npos);
+  EXPECT_NE(source.find("node_3:\n  SVM_SPECIALIZED_NODE(3, NODE_CLOSURE_WEIGHT, 1u, 0u, 0u)"),
+            string::npos);
+  EXPECT_NE(source.find("SVM_SPECIALIZED_NODE(1, NODE_VALUE_V, 1u, 0u, 0u)"), string::npos);
+  /* Data of nodes is not executed. */
+  EXPECT_EQ(source.find("SVM_SPECIALIZED_NODE(2,"), string::npos);
+}
+
+TEST(render_svm_specialized, write)
+{
+  SVMNodesBuilder a;
+  a.add_node(NODE_CLOSURE_WEIGHT, 1).add_node(NODE_END);
+
+  const string hash = svm_specialized_hash(a.nodes, a.starts);
+  ASSERT_FALSE(hash.empty());
+
+  const string dirpath = path_join(testing::TempDir(), "render_svm_specialized_test");
+  ASSERT_TRUE(svm_specialized_write(dirpath, a.nodes, a.starts, hash, "Material"));
+
+  const string filepath = path_join(dirpath, "svm_specialized_" + hash + ".cpp");
+  const string isa_filepath = path_join(dirpath, "svm_specialized_isa.cpp");
+  EXPECT_TRUE(path_exists(filepath));
+
+  /* The library exports the instruction set it is built for. */
+  string isa_source;
+  ASSERT_TRUE(path_read_text(isa_filepath, isa_source));
+  EXPECT_NE(isa_source.find("cycles_svm_specialized_isa = svm_specialized_isa();"),
+            string::npos);
+
+  path_remove(filepath);
+  path_remove(isa_filepath);
+}
+
+CCL_NAMESPACE_END
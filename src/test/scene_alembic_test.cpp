@@ -0,0 +1,106 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#ifdef WITH_ALEMBIC
+
+#  include <Alembic/AbcCoreOgawa/All.h>
+
+#  include "testing/testing.h"
+
+#  include "device/device.h"
+
+#  include "scene/alembic.h"
+#  include "scene/mesh.h"
+#  include "scene/object.h"
+#  include "scene/scene.h"
+
+#  include "util/path.h"
+#  include "util/progress.h"
+#  include "util/stats.h"
+
+CCL_NAMESPACE_BEGIN
+
+using namespace Alembic::AbcGeom;
+
+static const int NUM_FRAMES = 24;
+
+/* Archive with a single triangle, whose first vertex is at x equal to the frame number. */
+static void write_triangle_archive(const string &filepath)
+{
+  OArchive archive(Alembic::AbcCoreOgawa::WriteArchive(), filepath);
+  const uint32_t time_sampling = archive.addTimeSampling(TimeSampling(1.0 / 24.0, 0.0));
+
+  OPolyMesh mesh(archive.getTop(), "triangle", time_sampling);
+  OPolyMeshSchema &schema = mesh.getSchema();
+
+  const int32_t indices[3] = {0, 1, 2};
+  const int32_t counts[1] = {3};
+  for (int frame = 0; frame <= NUM_FRAMES; frame++) {
+    const V3f positions[3] = {
+        V3f(float(frame), 0.0f, 0.0f), V3f(frame + 1.0f, 0.0f, 0.0f), V3f(0.0f, 1.0f, 0.0f)};
+    schema.set(OPolyMeshSchema::Sample(P3fArraySample(positions, 3),
+                                       Int32ArraySample(indices, 3),
+                                       Int32ArraySample(counts, 1)));
+  }
+}
+
+class SceneAlembic : public testing::Test {
+ protected:
+  Stats stats;
+  Profiler profiler;
+  DeviceInfo device_info;
+  Device *device_cpu;
+  SceneParams scene_params;
+  Scene *scene;
+  string filepath;
+
+  virtual void SetUp()
+  {
+    filepath = path_join(testing::TempDir(), "alembic_prefetch_test.abc");
+    write_triangle_archive(filepath);
+
+    device_cpu = Device::create(device_info, stats, profiler);
+    scene = new Scene(scene_params, device_cpu);
+  }
+
+  virtual void TearDown()
+  {
+    delete scene;
+    delete device_cpu;
+    path_remove(filepath);
+  }
+};
+
+/* Step through every frame of the animation with prefetching, most of the frames are inside the
+ * window that was loaded while the next window is loaded in the background. */
+TEST_F(SceneAlembic, prefetch_frame_steps)
+{
+  AlembicProcedural *procedural = scene->create_node<AlembicProcedural>();
+  procedural->set_filepath(ustring(filepath));
+  procedural->set_start_frame(0.0f);
+  procedural->set_end_frame(float(NUM_FRAMES));
+  procedural->set_frame_rate(24.0f);
+  procedural->set_use_prefetch(true);
+  procedural->set_prefetch_window(4);
+
+  AlembicObject *object = procedural->get_or_create_object(ustring("/triangle"));
+  array<Node *> used_shaders;
+  used_shaders.push_back_slow(scene->default_surface);
+  object->set_used_shaders(used_shaders);
+
+  Progress progress;
+  for (int frame = 0; frame <= NUM_FRAMES; frame++) {
+    procedural->set_frame(float(frame));
+    procedural->generate(scene, progress);
+    ASSERT_FALSE(progress.get_cancel());
+
+    ASSERT_NE(object->get_object(), nullptr);
+    const Mesh *mesh = static_cast<const Mesh *>(object->get_object()->get_geometry());
+    ASSERT_EQ(mesh->get_verts().size(), size_t(3));
+    EXPECT_EQ(mesh->get_verts()[0].x, float(frame));
+  }
+}
+
+CCL_NAMESPACE_END
+
+#endif /* WITH_ALEMBIC */
@@ -0,0 +1,240 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#include "testing/testing.h"
+
+#include "device/device.h"
+
+#include "graph/node_xml.h"
+
+#include "scene/background.h"
+#include "scene/binary.h"
+#include "scene/camera.h"
+#include "scene/film.h"
+#include "scene/integrator.h"
+#include "scene/light.h"
+#include "scene/mesh.h"
+#include "scene/object.h"
+#include "scene/pass.h"
+#include "scene/scene.h"
+#include "scene/shader.h"
+#include "scene/shader_graph.h"
+#include "scene/shader_nodes.h"
+
+#include "util/foreach.h"
+#include "util/path.h"
+#include "util/progress.h"
+#include "util/stats.h"
+
+CCL_NAMESPACE_BEGIN
+
+static const char *SCENE_XML =
+    "<cycles>"
+    "  <integrator max_bounce='3' seed='7' />"
+    "  <film exposure='1.5' />"
+    "  <camera full_width='320' full_height='240' fov='0.6' />"
+    "  <background transparent='true' />"
+    "  <shader name='red' use_transparent_shadow='false'>"
+    "    <emission name='emit' color='0.8 0.1 0.1' strength='2' />"
+    "  </shader>"
+    "  <mesh name='tri' verts='0 0 0  1 0 0  0 1 0' triangles='0 1 2' shader='0'"
+    "        smooth='true' used_shaders='red' />"
+    "  <object name='tri_object' geometry='tri' tfm='1 0 0 1  0 1 0 2  0 0 1 3'"
+    "          color='0.5 0.25 1' pass_id='3' />"
+    "  <light name='sun' light_type='distant' strength='2 2 2' dir='0 0 -1' angle='0.1' />"
+    "  <pass name='diffuse' type='diffuse_color' mode='noisy' />"
+    "</cycles>";
+
+class SceneBinary : public testing::Test {
+ protected:
+  Stats stats;
+  Profiler profiler;
+  DeviceInfo device_info;
+  Device *device_cpu;
+  SceneParams scene_params;
+  Scene *scene;
+  Scene *read_scene;
+  string filepath;
+
+  virtual void SetUp()
+  {
+    filepath = path_join(testing::TempDir(), "scene_binary_test.cyb");
+
+    device_cpu = Device::create(device_info, stats, profiler);
+    scene = new Scene(scene_params, device_cpu);
+    read_scene = new Scene(scene_params, device_cpu);
+  }
+
+  virtual void TearDown()
+  {
+    delete read_scene;
+    delete scene;
+    delete device_cpu;
+    path_remove(filepath);
+  }
+
+  /* Create the scene nodes from XML, the way the standalone application does. */
+  void read_xml(const char *xml)
+  {
+    xml_document doc;
+    ASSERT_TRUE(doc.load_string(xml));
+
+    XMLReader reader;
+    foreach (xml_node node, doc.child("cycles").children()) {
+      const string name = node.name();
+
+      if (name == "integrator") {
+        xml_read_node(reader, scene->integrator, node);
+      }
+      else if (name == "film") {
+        xml_read_node(reader, scene->film, node);
+      }
+      else if (name == "camera") {
+        xml_read_node(reader, scene->camera, node);
+      }
+      else if (name == "background") {
+        xml_read_node(reader, scene->background, node);
+      }
+      else if (name == "shader") {
+        Shader *shader = scene->create_node<Shader>();
+        xml_read_node(reader, shader, node);
+        reader.node_map[shader->name] = shader;
+
+        ShaderGraph *graph = new ShaderGraph();
+        foreach (xml_node graph_node, node.children()) {
+          const NodeType *node_type = NodeType::find(ustring(graph_node.name()));
+          ASSERT_NE(node_type, nullptr);
+
+          ShaderNode *shader_node = (ShaderNode *)node_type->create(node_type);
+          shader_node->set_owner(graph);
+          xml_read_node(reader, shader_node, graph_node);
+          graph->add(shader_node);
+          graph->connect(shader_node->outputs[0], graph->output()->input("Surface"));
+        }
+        shader->set_graph(graph);
+      }
+      else if (name == "mesh") {
+        Mesh *mesh = scene->create_node<Mesh>();
+        xml_read_node(reader, mesh, node);
+        reader.node_map[mesh->name] = mesh;
+      }
+      else if (name == "object") {
+        xml_read_node(reader, scene->create_node<Object>(), node);
+      }
+      else if (name == "light") {
+        xml_read_node(reader, scene->create_node<Light>(), node);
+      }
+      else if (name == "pass") {
+        xml_read_node(reader, scene->create_node<Pass>(), node);
+      }
+    }
+  }
+};
+
+/* Compare all stored sockets of two nodes. Node references are compared by name, as they point
+ * to nodes of different scenes. */
+static void expect_sockets_equal(const Node *a, const Node *b)
+{
+  ASSERT_EQ(a->type, b->type);
+  EXPECT_EQ(a->name, b->name);
+
+  foreach (const SocketType &socket, a->type->inputs) {
+    if (socket.type == SocketType::CLOSURE || socket.type == SocketType::UNDEFINED ||
+        (socket.flags & SocketType::INTERNAL)) {
+      continue;
+    }
+
+    if (socket.type == SocketType::NODE) {
+      const Node *node_a = a->get_node(socket);
+      const Node *node_b = b->get_node(socket);
+      EXPECT_EQ(node_a == nullptr, node_b == nullptr) << socket.name;
+      if (node_a && node_b) {
+        EXPECT_EQ(node_a->name, node_b->name) << socket.name;
+      }
+    }
+    else if (socket.type == SocketType::NODE_ARRAY) {
+      const array<Node *> &nodes_a = a->get_node_array(socket);
+      const array<Node *> &nodes_b = b->get_node_array(socket);
+      ASSERT_EQ(nodes_a.size(), nodes_b.size()) << socket.name;
+      for (size_t i = 0; i < nodes_a.size(); i++) {
+        EXPECT_EQ(nodes_a[i]->name, nodes_b[i]->name) << socket.name;
+      }
+    }
+    else {
+      EXPECT_TRUE(a->equals_value(*b, socket)) << socket.name;
+    }
+  }
+}
+
+static ShaderNode *find_shader_node(ShaderGraph *graph, const char *name)
+{
+  foreach (ShaderNode *node, graph->nodes) {
+    if (node->name == name) {
+      return node;
+    }
+  }
+  return nullptr;
+}
+
+TEST_F(SceneBinary, xml_round_trip)
+{
+  read_xml(SCENE_XML);
+
+  ASSERT_TRUE(scene_write_binary(scene, filepath));
+  ASSERT_TRUE(scene_read_binary(read_scene, filepath));
+
+  expect_sockets_equal(scene->integrator, read_scene->integrator);
+  expect_sockets_equal(scene->film, read_scene->film);
+  expect_sockets_equal(scene->camera, read_scene->camera);
+  expect_sockets_equal(scene->background, read_scene->background);
+
+  ASSERT_EQ(scene->shaders.size(), read_scene->shaders.size());
+  for (size_t i = 0; i < scene->shaders.size(); i++) {
+    expect_sockets_equal(scene->shaders[i], read_scene->shaders[i]);
+  }
+
+  ShaderGraph *graph = read_scene->shaders.back()->graph;
+  ShaderNode *emission = find_shader_node(graph, "emit");
+  ASSERT_NE(emission, nullptr);
+  expect_sockets_equal(find_shader_node(scene->shaders.back()->graph, "emit"), emission);
+
+  ShaderInput *surface = graph->output()->input("Surface");
+  ASSERT_NE(surface->link, nullptr);
+  EXPECT_EQ(surface->link->parent, emission);
+
+  ASSERT_EQ(read_scene->geometry.size(), 1);
+  expect_sockets_equal(scene->geometry[0], read_scene->geometry[0]);
+  ASSERT_EQ(read_scene->objects.size(), 1);
+  expect_sockets_equal(scene->objects[0], read_scene->objects[0]);
+  EXPECT_EQ(read_scene->objects[0]->get_geometry(), read_scene->geometry[0]);
+  ASSERT_EQ(read_scene->lights.size(), 1);
+  expect_sockets_equal(scene->lights[0], read_scene->lights[0]);
+  ASSERT_EQ(read_scene->passes.size(), 1);
+  expect_sockets_equal(scene->passes[0], read_scene->passes[0]);
+}
+
+TEST_F(SceneBinary, read_existing_passes)
+{
+  read_xml(SCENE_XML);
+  ASSERT_TRUE(scene_write_binary(scene, filepath));
+
+  ASSERT_TRUE(scene_read_binary(read_scene, filepath));
+  ASSERT_TRUE(scene_read_binary(read_scene, filepath));
+
+  EXPECT_EQ(read_scene->passes.size(), 1);
+}
+
+TEST_F(SceneBinary, read_truncated)
+{
+  read_xml(SCENE_XML);
+  ASSERT_TRUE(scene_write_binary(scene, filepath));
+
+  vector<uint8_t> data;
+  ASSERT_TRUE(path_read_binary(filepath, data));
+  data.resize(data.size() / 2);
+  ASSERT_TRUE(path_write_binary(filepath, data));
+
+  EXPECT_FALSE(scene_read_binary(read_scene, filepath));
+}
+
+CCL_NAMESPACE_END
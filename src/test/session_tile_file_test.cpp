@@ -0,0 +1,109 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#include "testing/testing.h"
+
+#include "session/tile_file.h"
+#include "util/hash.h"
+#include "util/path.h"
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+static const int PASS_STRIDE = 3;
+
+/* Smooth values with some noise, unique for every pixel of the frame. */
+static float test_value(const int x, const int y, const int pass)
+{
+  return x * 0.25f + y * 0.5f + pass + (hash_uint3(x, y, pass) & 255) * (1.0f / 1024.0f);
+}
+
+static vector<float> test_tile(const int x, const int y, const int width, const int height)
+{
+  vector<float> pixels(size_t(width) * height * PASS_STRIDE);
+  for (int j = 0; j < height; j++) {
+    for (int i = 0; i < width; i++) {
+      for (int pass = 0; pass < PASS_STRIDE; pass++) {
+        pixels[(size_t(j) * width + i) * PASS_STRIDE + pass] = test_value(x + i, y + j, pass);
+      }
+    }
+  }
+  return pixels;
+}
+
+static void test_tile_file(const bool use_compression)
+{
+  const string filepath = path_join(testing::TempDir(),
+                                    (use_compression) ? "tile_file_test_lz4.tiles" :
+                                                        "tile_file_test.tiles");
+  const int width = 300, height = 200, tile_size = 128;
+
+  TileFileWriter writer;
+  ASSERT_TRUE(writer.open(filepath, width, height, PASS_STRIDE, "metadata", use_compression));
+  /* Leave out the last tile, which is read back as zeros. */
+  for (int y = 0; y < height; y += tile_size) {
+    for (int x = 0; x < width; x += tile_size) {
+      if (x + tile_size >= width && y + tile_size >= height) {
+        continue;
+      }
+      const int tile_width = min(tile_size, width - x);
+      const int tile_height = min(tile_size, height - y);
+      const vector<float> pixels = test_tile(x, y, tile_width, tile_height);
+      ASSERT_TRUE(writer.write_tile(x, y, tile_width, tile_height, pixels.data()));
+    }
+  }
+  ASSERT_TRUE(writer.close());
+
+  TileFileReader reader;
+  ASSERT_TRUE(reader.open(filepath));
+  EXPECT_EQ(reader.get_width(), width);
+  EXPECT_EQ(reader.get_height(), height);
+  EXPECT_EQ(reader.get_pass_stride(), PASS_STRIDE);
+  EXPECT_EQ(reader.get_metadata(), "metadata");
+
+  /* Region which spans several tiles. */
+  const int region_x = 100, region_y = 50, region_width = 200, region_height = 150;
+  vector<float> pixels(size_t(region_width) * region_height * PASS_STRIDE, -1.0f);
+  ASSERT_TRUE(
+      reader.read_region(region_x, region_y, region_width, region_height, pixels.data()));
+
+  for (int j = 0; j < region_height; j++) {
+    for (int i = 0; i < region_width; i++) {
+      const int x = region_x + i, y = region_y + j;
+      const bool is_written = x < 2 * tile_size || y < tile_size;
+      for (int pass = 0; pass < PASS_STRIDE; pass++) {
+        const float value = pixels[(size_t(j) * region_width + i) * PASS_STRIDE + pass];
+        EXPECT_EQ(value, (is_written) ? test_value(x, y, pass) : 0.0f);
+      }
+    }
+  }
+
+  reader.close();
+  path_remove(filepath);
+}
+
+TEST(session, tile_file)
+{
+  test_tile_file(false);
+}
+
+TEST(session, tile_file_compressed)
+{
+  test_tile_file(true);
+}
+
+TEST(session, tile_file_invalid)
+{
+  const string filepath = path_join(testing::TempDir(), "tile_file_invalid.tiles");
+  FILE *file = path_fopen(filepath, "wb");
+  ASSERT_NE(file, nullptr);
+  fputs("not a tile file", file);
+  fclose(file);
+
+  TileFileReader reader;
+  EXPECT_FALSE(reader.open(filepath));
+
+  path_remove(filepath);
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,83 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#include "testing/testing.h"
+
+#include "util/hash.h"
+#include "util/lz4.h"
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+static void lz4_round_trip(const vector<uint8_t> &data, const size_t max_compressed_size)
+{
+  vector<uint8_t> compressed(lz4_compress_bound(data.size()));
+  const size_t compressed_size = lz4_compress(
+      data.data(), data.size(), compressed.data(), compressed.size());
+  ASSERT_NE(compressed_size, 0);
+  EXPECT_LE(compressed_size, max_compressed_size);
+
+  vector<uint8_t> decompressed(data.size());
+  EXPECT_TRUE(lz4_decompress(
+      compressed.data(), compressed_size, decompressed.data(), decompressed.size()));
+  EXPECT_EQ(decompressed, data);
+}
+
+TEST(util, lz4_empty)
+{
+  lz4_round_trip(vector<uint8_t>(), 1);
+}
+
+TEST(util, lz4_constant)
+{
+  lz4_round_trip(vector<uint8_t>(100000, 7), 1000);
+}
+
+TEST(util, lz4_random)
+{
+  vector<uint8_t> data(70000);
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = uint8_t(hash_uint(i));
+  }
+  lz4_round_trip(data, lz4_compress_bound(data.size()));
+
+  /* Short inputs, all literals with a token and a length byte from 15 literals on. */
+  for (size_t size = 1; size < 20; size++) {
+    lz4_round_trip(vector<uint8_t>(data.begin(), data.begin() + size), size + 2);
+  }
+}
+
+TEST(util, lz4_repeated)
+{
+  /* Repeating random runs, with matches at various distances and overlapping matches. */
+  vector<uint8_t> data;
+  for (uint i = 0; data.size() < 300000; i++) {
+    const size_t run = hash_uint(i) % 300;
+    const size_t distance = 1 + hash_uint(i + 1000000) % min(data.size() + 1, size_t(80000));
+    for (size_t j = 0; j < run; j++) {
+      data.push_back((data.size() >= distance) ? data[data.size() - distance] :
+                                                 uint8_t(hash_uint(j)));
+    }
+    data.push_back(uint8_t(i));
+  }
+  lz4_round_trip(data, data.size() / 2);
+}
+
+TEST(util, lz4_invalid)
+{
+  vector<uint8_t> data(1000, 3);
+  vector<uint8_t> compressed(lz4_compress_bound(data.size()));
+  const size_t compressed_size = lz4_compress(
+      data.data(), data.size(), compressed.data(), compressed.size());
+
+  vector<uint8_t> decompressed(data.size());
+  /* Truncated input and wrong output size. */
+  EXPECT_FALSE(lz4_decompress(
+      compressed.data(), compressed_size - 1, decompressed.data(), decompressed.size()));
+  EXPECT_FALSE(lz4_decompress(
+      compressed.data(), compressed_size, decompressed.data(), decompressed.size() - 1));
+  /* Not enough space to compress. */
+  EXPECT_EQ(lz4_compress(data.data(), data.size(), compressed.data(), 2), 0);
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,134 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#include "testing/testing.h"
+
+#include "util/hash.h"
+#include "util/texture_compress.h"
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Gradient between two colors with some noise, with a size that is not a multiple of the block
+ * size. */
+static vector<uchar4> test_image(const int width, const int height)
+{
+  vector<uchar4> pixels(width * height);
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      const int t = ((x + y) * 255) / (width + height);
+      const int noise = hash_uint2(x, y) & 7;
+      pixels[y * width + x] = make_uchar4(t, 255 - t, 128 + noise, (x * 255) / width);
+    }
+  }
+  return pixels;
+}
+
+TEST(util, texture_compress_bc1)
+{
+  const int width = 37, height = 19;
+  const vector<uchar4> pixels = test_image(width, height);
+
+  vector<TextureBlockBC1> blocks(texture_block_count(width, height));
+  texture_compress_bc1(pixels.data(), width, height, blocks.data());
+
+  const int blocks_x = divide_up(width, 4);
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      const float4 color = texture_block_bc1_decode(
+          blocks[(y / 4) * blocks_x + x / 4], x % 4, y % 4);
+      const uchar4 pixel = pixels[y * width + x];
+      EXPECT_NEAR(color.x, pixel.x / 255.0f, 0.03f);
+      EXPECT_NEAR(color.y, pixel.y / 255.0f, 0.03f);
+      EXPECT_NEAR(color.z, pixel.z / 255.0f, 0.03f);
+      EXPECT_EQ(color.w, 1.0f);
+    }
+  }
+}
+
+TEST(util, texture_compress_bc3)
+{
+  const int width = 37, height = 19;
+  const vector<uchar4> pixels = test_image(width, height);
+
+  vector<TextureBlockBC3> blocks(texture_block_count(width, height));
+  texture_compress_bc3(pixels.data(), width, height, blocks.data());
+
+  const int blocks_x = divide_up(width, 4);
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      const float4 color = texture_block_bc3_decode(
+          blocks[(y / 4) * blocks_x + x / 4], x % 4, y % 4);
+      const uchar4 pixel = pixels[y * width + x];
+      EXPECT_NEAR(color.x, pixel.x / 255.0f, 0.03f);
+      EXPECT_NEAR(color.y, pixel.y / 255.0f, 0.03f);
+      EXPECT_NEAR(color.z, pixel.z / 255.0f, 0.03f);
+      EXPECT_NEAR(color.w, pixel.w / 255.0f, 0.02f);
+    }
+  }
+}
+
+TEST(util, texture_compress_bc4)
+{
+  const int width = 21, height = 42;
+  vector<uchar> pixels(width * height);
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      pixels[y * width + x] = uchar((x * 255) / width + (hash_uint2(x, y) & 3));
+    }
+  }
+  /* Constant block. */
+  for (int y = 0; y < 4; y++) {
+    for (int x = 0; x < 4; x++) {
+      pixels[y * width + x] = 77;
+    }
+  }
+
+  vector<TextureBlockBC4> blocks(texture_block_count(width, height));
+  texture_compress_bc4(pixels.data(), width, height, blocks.data());
+
+  const int blocks_x = divide_up(width, 4);
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      const float value = texture_block_bc4_decode(
+          blocks[(y / 4) * blocks_x + x / 4], x % 4, y % 4);
+      EXPECT_NEAR(value, pixels[y * width + x] / 255.0f, 0.02f);
+    }
+  }
+
+  EXPECT_EQ(texture_block_bc4_decode(blocks[0], 2, 3), 77 / 255.0f);
+}
+
+/* Single pixel, as used for images that failed to load, is decoded exactly in the whole block. */
+TEST(util, texture_compress_single_pixel)
+{
+  const uchar4 pixel = make_uchar4(255, 0, 255, 255);
+
+  TextureBlockBC1 bc1;
+  texture_compress_bc1(&pixel, 1, 1, &bc1);
+  TextureBlockBC3 bc3;
+  texture_compress_bc3(&pixel, 1, 1, &bc3);
+  const uchar value = 255;
+  TextureBlockBC4 bc4;
+  texture_compress_bc4(&value, 1, 1, &bc4);
+
+  for (int y = 0; y < 4; y++) {
+    for (int x = 0; x < 4; x++) {
+      const float4 color_bc1 = texture_block_bc1_decode(bc1, x, y);
+      EXPECT_EQ(color_bc1.x, 1.0f);
+      EXPECT_EQ(color_bc1.y, 0.0f);
+      EXPECT_EQ(color_bc1.z, 1.0f);
+      EXPECT_EQ(color_bc1.w, 1.0f);
+
+      const float4 color_bc3 = texture_block_bc3_decode(bc3, x, y);
+      EXPECT_EQ(color_bc3.x, 1.0f);
+      EXPECT_EQ(color_bc3.y, 0.0f);
+      EXPECT_EQ(color_bc3.z, 1.0f);
+      EXPECT_EQ(color_bc3.w, 1.0f);
+
+      EXPECT_EQ(texture_block_bc4_decode(bc4, x, y), 1.0f);
+    }
+  }
+}
+
+CCL_NAMESPACE_END
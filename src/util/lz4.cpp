@@ -0,0 +1,205 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#include "util/lz4.h"
+#include "util/math.h"
+
+#include <cstring>
+
+CCL_NAMESPACE_BEGIN
+
+/* Constants of the block format. Matches are at least 4 bytes, the last 5 bytes of a block are
+ * literals and the last match starts at least 12 bytes before the end of the block. */
+static const size_t LZ4_MIN_MATCH = 4;
+static const size_t LZ4_LAST_LITERALS = 5;
+static const size_t LZ4_MATCH_FIND_LIMIT = 12;
+static const size_t LZ4_MAX_DISTANCE = 65535;
+
+static const int LZ4_HASH_BITS = 12;
+
+static inline uint32_t lz4_read32(const uint8_t *p)
+{
+  uint32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+static inline uint32_t lz4_hash(const uint32_t value)
+{
+  return (value * 2654435761u) >> (32 - LZ4_HASH_BITS);
+}
+
+/* Write the remainder of a length that did not fit in the token. */
+static inline uint8_t *lz4_write_length(uint8_t *op, size_t length)
+{
+  while (length >= 255) {
+    *op++ = 255;
+    length -= 255;
+  }
+  *op++ = uint8_t(length);
+  return op;
+}
+
+/* Read the remainder of a length that did not fit in the token. */
+static inline bool lz4_read_length(const uint8_t *&ip, const uint8_t *iend, size_t &length)
+{
+  uint8_t byte;
+  do {
+    if (ip >= iend) {
+      return false;
+    }
+    byte = *ip++;
+    length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+size_t lz4_compress_bound(const size_t size)
+{
+  return size + size / 255 + 16;
+}
+
+size_t lz4_compress(const uint8_t *src,
+                    const size_t src_size,
+                    uint8_t *dst,
+                    const size_t dst_capacity)
+{
+  uint32_t table[1 << LZ4_HASH_BITS];
+  memset(table, 0, sizeof(table));
+
+  uint8_t *op = dst;
+  uint8_t *const oend = dst + dst_capacity;
+
+  size_t anchor = 0;
+
+  if (src_size > LZ4_MATCH_FIND_LIMIT) {
+    const size_t match_start_limit = src_size - LZ4_MATCH_FIND_LIMIT;
+    const size_t match_end_limit = src_size - LZ4_LAST_LITERALS;
+
+    size_t ip = 0;
+    while (ip < match_start_limit) {
+      const uint32_t sequence = lz4_read32(src + ip);
+      const uint32_t hash = lz4_hash(sequence);
+      const size_t ref = table[hash];
+      table[hash] = uint32_t(ip);
+
+      if (ref >= ip || ip - ref > LZ4_MAX_DISTANCE || lz4_read32(src + ref) != sequence) {
+        ip++;
+        continue;
+      }
+
+      size_t match_length = LZ4_MIN_MATCH;
+      while (ip + match_length < match_end_limit &&
+             src[ref + match_length] == src[ip + match_length])
+      {
+        match_length++;
+      }
+
+      const size_t literal_length = ip - anchor;
+      const size_t length = match_length - LZ4_MIN_MATCH;
+      const size_t max_sequence_size = 1 + literal_length + literal_length / 255 + 1 + 2 +
+                                       length / 255 + 1;
+      if (size_t(oend - op) < max_sequence_size) {
+        return 0;
+      }
+
+      uint8_t *token = op++;
+      *token = uint8_t(min(literal_length, size_t(15)) << 4);
+      if (literal_length >= 15) {
+        op = lz4_write_length(op, literal_length - 15);
+      }
+      memcpy(op, src + anchor, literal_length);
+      op += literal_length;
+
+      const size_t offset = ip - ref;
+      *op++ = uint8_t(offset & 255);
+      *op++ = uint8_t(offset >> 8);
+
+      *token |= uint8_t(min(length, size_t(15)));
+      if (length >= 15) {
+        op = lz4_write_length(op, length - 15);
+      }
+
+      ip += match_length;
+      anchor = ip;
+    }
+  }
+
+  /* Remaining literals. */
+  const size_t literal_length = src_size - anchor;
+  if (size_t(oend - op) < 1 + literal_length + literal_length / 255 + 1) {
+    return 0;
+  }
+
+  uint8_t *token = op++;
+  *token = uint8_t(min(literal_length, size_t(15)) << 4);
+  if (literal_length >= 15) {
+    op = lz4_write_length(op, literal_length - 15);
+  }
+  memcpy(op, src + anchor, literal_length);
+  op += literal_length;
+
+  return op - dst;
+}
+
+bool lz4_decompress(const uint8_t *src, const size_t src_size, uint8_t *dst, const size_t dst_size)
+{
+  const uint8_t *ip = src;
+  const uint8_t *const iend = src + src_size;
+  uint8_t *op = dst;
+  uint8_t *const oend = dst + dst_size;
+
+  while (ip < iend) {
+    const uint8_t token = *ip++;
+
+    size_t literal_length = token >> 4;
+    if (literal_length == 15 && !lz4_read_length(ip, iend, literal_length)) {
+      return false;
+    }
+    if (literal_length > size_t(iend - ip) || literal_length > size_t(oend - op)) {
+      return false;
+    }
+    memcpy(op, ip, literal_length);
+    ip += literal_length;
+    op += literal_length;
+
+    /* The last sequence has literals only. */
+    if (ip == iend) {
+      break;
+    }
+
+    if (iend - ip < 2) {
+      return false;
+    }
+    const size_t offset = size_t(ip[0]) | (size_t(ip[1]) << 8);
+    ip += 2;
+    if (offset == 0 || offset > size_t(op - dst)) {
+      return false;
+    }
+
+    size_t match_length = token & 15;
+    if (match_length == 15 && !lz4_read_length(ip, iend, match_length)) {
+      return false;
+    }
+    match_length += LZ4_MIN_MATCH;
+    if (match_length > size_t(oend - op)) {
+      return false;
+    }
+
+    const uint8_t *match = op - offset;
+    if (offset >= match_length) {
+      memcpy(op, match, match_length);
+    }
+    else {
+      /* Overlapping match, repeating the last offset bytes. */
+      for (size_t i = 0; i < match_length; i++) {
+        op[i] = match[i];
+      }
+    }
+    op += match_length;
+  }
+
+  return op == oend;
+}
+
+CCL_NAMESPACE_END
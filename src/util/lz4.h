@@ -0,0 +1,29 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#ifndef __UTIL_LZ4_H__
+#define __UTIL_LZ4_H__
+
+#include "util/types.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Compression in the LZ4 block format.
+ *
+ * Uses a greedy single pass match finder, which favors speed over compression ratio. Meant for
+ * temporary data that is read back by the same process, where the time spent compressing has to
+ * be small compared to the time saved on disk IO. */
+
+/* Maximum compressed size of the given number of bytes. */
+size_t lz4_compress_bound(size_t size);
+
+/* Compress src into dst. Returns the compressed size, or 0 if it does not fit in dst_capacity. */
+size_t lz4_compress(const uint8_t *src, size_t src_size, uint8_t *dst, size_t dst_capacity);
+
+/* Decompress src into dst, which must be exactly the size of the uncompressed data.
+ * Returns false if the compressed data is invalid. */
+bool lz4_decompress(const uint8_t *src, size_t src_size, uint8_t *dst, size_t dst_size);
+
+CCL_NAMESPACE_END
+
+#endif /* __UTIL_LZ4_H__ */
@@ -0,0 +1,148 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#include "util/mapped_file.h"
+
+#include "util/path.h"
+#include "util/windows.h"
+
+#ifndef _WIN32
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+CCL_NAMESPACE_BEGIN
+
+MappedFile::MappedFile()
+{
+}
+
+MappedFile::~MappedFile()
+{
+  close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const string &filepath)
+{
+  close();
+
+  const wstring filepath_wc = string_to_wstring(filepath);
+  HANDLE file = CreateFileW(filepath_wc.c_str(),
+                            GENERIC_READ,
+                            FILE_SHARE_READ,
+                            NULL,
+                            OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL,
+                            NULL);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file, &file_size)) {
+    CloseHandle(file);
+    return false;
+  }
+
+  file_handle_ = file;
+  size_ = (size_t)file_size.QuadPart;
+  is_open_ = true;
+
+  /* Empty files can not be mapped. */
+  if (size_ == 0) {
+    return true;
+  }
+
+  HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (mapping == NULL) {
+    close();
+    return false;
+  }
+  mapping_handle_ = mapping;
+
+  data_ = (const uint8_t *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (data_ == nullptr) {
+    close();
+    return false;
+  }
+
+  return true;
+}
+
+void MappedFile::close()
+{
+  if (data_) {
+    UnmapViewOfFile(data_);
+  }
+  if (mapping_handle_) {
+    CloseHandle((HANDLE)mapping_handle_);
+  }
+  if (file_handle_) {
+    CloseHandle((HANDLE)file_handle_);
+  }
+
+  data_ = nullptr;
+  size_ = 0;
+  file_handle_ = nullptr;
+  mapping_handle_ = nullptr;
+  is_open_ = false;
+}
+
+#else /* _WIN32 */
+
+bool MappedFile::open(const string &filepath)
+{
+  close();
+
+  const int fd = ::open(filepath.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return false;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    ::close(fd);
+    return false;
+  }
+
+  fd_ = fd;
+  size_ = (size_t)st.st_size;
+  is_open_ = true;
+
+  /* Empty files can not be mapped. */
+  if (size_ == 0) {
+    return true;
+  }
+
+  void *data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (data == MAP_FAILED) {
+    close();
+    return false;
+  }
+  data_ = (const uint8_t *)data;
+
+  return true;
+}
+
+void MappedFile::close()
+{
+  if (data_) {
+    munmap((void *)data_, size_);
+  }
+  if (fd_ != -1) {
+    ::close(fd_);
+  }
+
+  data_ = nullptr;
+  size_ = 0;
+  fd_ = -1;
+  is_open_ = false;
+}
+
+#endif /* _WIN32 */
+
+CCL_NAMESPACE_END
@@ -0,0 +1,54 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#pragma once
+
+#include "util/string.h"
+#include "util/types.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Read-only memory mapping of an entire file.
+ *
+ * Pages of the file are only loaded on access, so that bulk data can be copied out of the file
+ * without reading it into an intermediate buffer first. */
+class MappedFile {
+ public:
+  MappedFile();
+  ~MappedFile();
+
+  MappedFile(const MappedFile &other) = delete;
+  MappedFile &operator=(const MappedFile &other) = delete;
+
+  bool open(const string &filepath);
+  void close();
+
+  bool is_open() const
+  {
+    return is_open_;
+  }
+
+  const uint8_t *data() const
+  {
+    return data_;
+  }
+
+  size_t size() const
+  {
+    return size_;
+  }
+
+ protected:
+  bool is_open_ = false;
+  const uint8_t *data_ = nullptr;
+  size_t size_ = 0;
+
+#ifdef _WIN32
+  void *file_handle_ = nullptr;
+  void *mapping_handle_ = nullptr;
+#else
+  int fd_ = -1;
+#endif
+};
+
+CCL_NAMESPACE_END
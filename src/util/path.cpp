@@ -730,6 +730,11 @@ bool path_remove(const string &path)
   return remove(path.c_str()) == 0;
 }
 
+bool path_rename(const string &old_path, const string &new_path)
+{
+  return rename(old_path.c_str(), new_path.c_str()) == 0;
+}
+
 struct SourceReplaceState {
   typedef map<string, string> ProcessedMapping;
   /* Base director for all relative include headers. */
@@ -51,6 +51,7 @@ bool path_read_text(const string &path, string &text);
 
 /* File manipulation. */
 bool path_remove(const string &path);
+bool path_rename(const string &old_path, const string &new_path);
 
 /* source code utility */
 string path_source_replace_includes(const string &source, const string &path);
@@ -133,13 +133,17 @@ void Profiler::remove_state(ProfilingState *state)
 uint64_t Profiler::get_event(ProfilingEvent event)
 {
   assert(worker == NULL);
+  /* No samples when the profiler was never reset for a scene. */
+  if (event >= event_samples.size()) {
+    return 0;
+  }
   return event_samples[event];
 }
 
 bool Profiler::get_shader(int shader, uint64_t &samples, uint64_t &hits)
 {
   assert(worker == NULL);
-  if (shader_samples[shader] == 0) {
+  if (shader < 0 || shader >= shader_samples.size() || shader_samples[shader] == 0) {
     return false;
   }
   samples = shader_samples[shader];
@@ -150,7 +154,7 @@ bool Profiler::get_shader(int shader, uint64_t &samples, uint64_t &hits)
 bool Profiler::get_object(int object, uint64_t &samples, uint64_t &hits)
 {
   assert(worker == NULL);
-  if (object_samples[object] == 0) {
+  if (object < 0 || object >= object_samples.size() || object_samples[object] == 0) {
     return false;
   }
   samples = object_samples[object];
@@ -9,31 +9,110 @@
 
 CCL_NAMESPACE_BEGIN
 
+/* Subsystems that device memory is accounted to. */
+enum MemoryCategory {
+  MEM_CATEGORY_OTHER = 0,
+  MEM_CATEGORY_BVH,
+  MEM_CATEGORY_GEOMETRY,
+  MEM_CATEGORY_ATTRIBUTES,
+  MEM_CATEGORY_OBJECTS,
+  MEM_CATEGORY_LIGHTS,
+  MEM_CATEGORY_SHADERS,
+  MEM_CATEGORY_TEXTURES,
+  MEM_CATEGORY_RENDER_BUFFERS,
+  MEM_CATEGORY_INTEGRATOR_STATE,
+
+  MEM_CATEGORY_NUM,
+};
+
+inline const char *memory_category_name(const MemoryCategory category)
+{
+  switch (category) {
+    case MEM_CATEGORY_OTHER:
+      return "Other";
+    case MEM_CATEGORY_BVH:
+      return "BVH";
+    case MEM_CATEGORY_GEOMETRY:
+      return "Geometry";
+    case MEM_CATEGORY_ATTRIBUTES:
+      return "Attributes";
+    case MEM_CATEGORY_OBJECTS:
+      return "Objects";
+    case MEM_CATEGORY_LIGHTS:
+      return "Lights";
+    case MEM_CATEGORY_SHADERS:
+      return "Shaders";
+    case MEM_CATEGORY_TEXTURES:
+      return "Textures";
+    case MEM_CATEGORY_RENDER_BUFFERS:
+      return "Render Buffers";
+    case MEM_CATEGORY_INTEGRATOR_STATE:
+      return "Integrator State";
+    case MEM_CATEGORY_NUM:
+      break;
+  }
+  return "Unknown";
+}
+
 class Stats {
  public:
   enum static_init_t { static_init = 0 };
 
   Stats() : mem_used(0), mem_peak(0)
   {
+    for (int i = 0; i < MEM_CATEGORY_NUM; i++) {
+      category_mem_used[i] = 0;
+      category_mem_peak[i] = 0;
+      category_mem_budget[i] = 0;
+    }
   }
   explicit Stats(static_init_t)
   {
   }
 
-  void mem_alloc(size_t size)
+  void mem_alloc(size_t size, const MemoryCategory category = MEM_CATEGORY_OTHER)
   {
     atomic_add_and_fetch_z(&mem_used, size);
     atomic_fetch_and_update_max_z(&mem_peak, mem_used);
+
+    const size_t used = atomic_add_and_fetch_z(&category_mem_used[category], size);
+    atomic_fetch_and_update_max_z(&category_mem_peak[category], used);
   }
 
-  void mem_free(size_t size)
+  void mem_free(size_t size, const MemoryCategory category = MEM_CATEGORY_OTHER)
   {
     assert(mem_used >= size);
     atomic_sub_and_fetch_z(&mem_used, size);
+
+    assert(category_mem_used[category] >= size);
+    atomic_sub_and_fetch_z(&category_mem_used[category], size);
+  }
+
+  /* Soft budget for the memory of a category, zero for no budget. Exceeding it does not fail
+   * allocations, but subsystems check it to fall back to using less memory. */
+  void set_mem_budget(const MemoryCategory category, const size_t size)
+  {
+    category_mem_budget[category] = size;
+  }
+
+  size_t get_mem_budget(const MemoryCategory category) const
+  {
+    return category_mem_budget[category];
+  }
+
+  /* Check whether allocating additional memory would exceed the budget of a category. */
+  bool mem_exceeds_budget(const MemoryCategory category, const size_t additional_size = 0) const
+  {
+    const size_t budget = category_mem_budget[category];
+    return budget != 0 && category_mem_used[category] + additional_size > budget;
   }
 
   size_t mem_used;
   size_t mem_peak;
+
+  size_t category_mem_used[MEM_CATEGORY_NUM];
+  size_t category_mem_peak[MEM_CATEGORY_NUM];
+  size_t category_mem_budget[MEM_CATEGORY_NUM];
 };
 
 CCL_NAMESPACE_END
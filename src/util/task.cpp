@@ -102,6 +102,35 @@ int TaskScheduler::max_concurrency()
   return (users > 0) ? active_num_threads : tbb::this_task_arena::max_concurrency();
 }
 
+vector<int> TaskScheduler::numa_nodes()
+{
+  vector<int> nodes;
+#ifdef WITH_TBB_NUMA
+  for (const tbb::numa_node_id node : tbb::info::numa_nodes()) {
+    /* TBB reports a single automatic node when HWLOC based topology detection is unavailable. */
+    if (node != tbb::task_arena::automatic) {
+      nodes.push_back(node);
+    }
+  }
+#endif
+  if (nodes.empty()) {
+    nodes.push_back(NUMA_NODE_ANY);
+  }
+  return nodes;
+}
+
+int TaskScheduler::numa_node_concurrency(const int numa_node)
+{
+#ifdef WITH_TBB_NUMA
+  if (numa_node != NUMA_NODE_ANY) {
+    return tbb::info::default_concurrency(numa_node);
+  }
+#else
+  (void)numa_node;
+#endif
+  return max_concurrency();
+}
+
 /* Dedicated Task Pool */
 
 DedicatedTaskPool::DedicatedTaskPool()
@@ -77,6 +77,17 @@ class TaskScheduler {
    * possible and leave scheduling and splitting up tasks to the scheduler. */
   static int max_concurrency();
 
+  /* Identifier of a NUMA node which lets the operating system pick where threads run. */
+  static constexpr int NUMA_NODE_ANY = -1;
+
+  /* Identifiers of NUMA nodes of this machine, usable for constraining task arenas.
+   * When the topology can not be detected (TBB without HWLOC support or an older TBB version)
+   * a single NUMA_NODE_ANY node is returned. */
+  static vector<int> numa_nodes();
+
+  /* Number of threads which can run concurrently on the given NUMA node. */
+  static int numa_node_concurrency(int numa_node);
+
  protected:
   static thread_mutex mutex;
   static int users;
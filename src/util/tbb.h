@@ -11,6 +11,7 @@
 #include <tbb/enumerable_thread_specific.h>
 #include <tbb/parallel_for.h>
 #include <tbb/parallel_for_each.h>
+#include <tbb/parallel_sort.h>
 #include <tbb/task_arena.h>
 #include <tbb/task_group.h>
 
@@ -20,12 +21,18 @@
 #  include <tbb/global_control.h>
 #endif
 
+#if TBB_INTERFACE_VERSION_MAJOR >= 12
+#  define WITH_TBB_NUMA
+#  include <tbb/info.h>
+#endif
+
 CCL_NAMESPACE_BEGIN
 
 using tbb::blocked_range;
 using tbb::enumerable_thread_specific;
 using tbb::parallel_for;
 using tbb::parallel_for_each;
+using tbb::parallel_sort;
 
 static inline void thread_capture_fp_settings()
 {
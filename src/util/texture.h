@@ -39,6 +39,10 @@ typedef enum ImageDataType {
   IMAGE_DATA_TYPE_NANOVDB_FLOAT3 = 9,
   IMAGE_DATA_TYPE_NANOVDB_FPN = 10,
   IMAGE_DATA_TYPE_NANOVDB_FP16 = 11,
+  /* Block compressed 8 bit images, see util/texture_compress.h. */
+  IMAGE_DATA_TYPE_BC1 = 12,
+  IMAGE_DATA_TYPE_BC3 = 13,
+  IMAGE_DATA_TYPE_BC4 = 14,
 
   IMAGE_DATA_NUM_TYPES
 } ImageDataType;
@@ -0,0 +1,236 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#include "util/texture_compress.h"
+#include "util/algorithm.h"
+#include "util/tbb.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Encoders based on the bounding box of the block, which is fast enough to compress textures
+ * while loading them and close to the quality of a least squares fit for most blocks. */
+
+namespace {
+
+/* Gather the pixels of a block, repeating the last row and column at the image border. */
+template<typename T>
+void block_gather(const T *pixels,
+                  const size_t width,
+                  const size_t height,
+                  const size_t block_x,
+                  const size_t block_y,
+                  T block[16])
+{
+  for (int y = 0; y < 4; y++) {
+    const size_t py = min(block_y * 4 + y, height - 1);
+    for (int x = 0; x < 4; x++) {
+      const size_t px = min(block_x * 4 + x, width - 1);
+      block[y * 4 + x] = pixels[py * width + px];
+    }
+  }
+}
+
+uint16_t rgb_to_565(const int r, const int g, const int b)
+{
+  return uint16_t(((r * 31 + 127) / 255) << 11 | ((g * 63 + 127) / 255) << 5 |
+                  ((b * 31 + 127) / 255));
+}
+
+int3 rgb565_to_rgb(const uint16_t color)
+{
+  const int r = (color >> 11) & 31;
+  const int g = (color >> 5) & 63;
+  const int b = color & 31;
+  return make_int3((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2));
+}
+
+TextureBlockBC1 encode_bc1(const uchar4 pixels[16])
+{
+  int min_color[3] = {255, 255, 255};
+  int max_color[3] = {0, 0, 0};
+  for (int i = 0; i < 16; i++) {
+    const uchar color[3] = {pixels[i].x, pixels[i].y, pixels[i].z};
+    for (int c = 0; c < 3; c++) {
+      min_color[c] = min(min_color[c], int(color[c]));
+      max_color[c] = max(max_color[c], int(color[c]));
+    }
+  }
+
+  /* Use the diagonal of the bounding box that follows the colors, by flipping the channels that
+   * decrease while the channel with the largest extent increases. */
+  int axis = 0;
+  for (int c = 1; c < 3; c++) {
+    if (max_color[c] - min_color[c] > max_color[axis] - min_color[axis]) {
+      axis = c;
+    }
+  }
+
+  int covariance[3] = {0, 0, 0};
+  for (int i = 0; i < 16; i++) {
+    const uchar color[3] = {pixels[i].x, pixels[i].y, pixels[i].z};
+    const int d = 2 * color[axis] - min_color[axis] - max_color[axis];
+    for (int c = 0; c < 3; c++) {
+      covariance[c] += d * (2 * color[c] - min_color[c] - max_color[c]);
+    }
+  }
+
+  for (int c = 0; c < 3; c++) {
+    /* Inset the box a little, the extremes are rarely hit exactly. */
+    const int inset = (max_color[c] - min_color[c]) >> 4;
+    min_color[c] += inset;
+    max_color[c] -= inset;
+
+    if (covariance[c] < 0) {
+      swap(min_color[c], max_color[c]);
+    }
+  }
+
+  TextureBlockBC1 block;
+  block.color0 = rgb_to_565(max_color[0], max_color[1], max_color[2]);
+  block.color1 = rgb_to_565(min_color[0], min_color[1], min_color[2]);
+  block.indices = 0;
+
+  if (block.color0 == block.color1) {
+    return block;
+  }
+  /* Keep the four color mode. */
+  if (block.color0 < block.color1) {
+    swap(block.color0, block.color1);
+  }
+
+  const int3 color0 = rgb565_to_rgb(block.color0);
+  const int3 color1 = rgb565_to_rgb(block.color1);
+  const int3 palette[4] = {color0,
+                           color1,
+                           make_int3((2 * color0.x + color1.x) / 3,
+                                     (2 * color0.y + color1.y) / 3,
+                                     (2 * color0.z + color1.z) / 3),
+                           make_int3((color0.x + 2 * color1.x) / 3,
+                                     (color0.y + 2 * color1.y) / 3,
+                                     (color0.z + 2 * color1.z) / 3)};
+
+  for (int i = 0; i < 16; i++) {
+    int best_index = 0;
+    int best_distance = INT_MAX;
+    for (int index = 0; index < 4; index++) {
+      const int dr = pixels[i].x - palette[index].x;
+      const int dg = pixels[i].y - palette[index].y;
+      const int db = pixels[i].z - palette[index].z;
+      const int distance = dr * dr + dg * dg + db * db;
+      if (distance < best_distance) {
+        best_distance = distance;
+        best_index = index;
+      }
+    }
+    block.indices |= uint32_t(best_index) << (2 * i);
+  }
+
+  return block;
+}
+
+TextureBlockBC4 encode_bc4(const uchar values[16])
+{
+  int min_value = 255;
+  int max_value = 0;
+  for (int i = 0; i < 16; i++) {
+    min_value = min(min_value, int(values[i]));
+    max_value = max(max_value, int(values[i]));
+  }
+
+  TextureBlockBC4 block;
+  block.value0 = uchar(max_value);
+  block.value1 = uchar(min_value);
+  for (int i = 0; i < 6; i++) {
+    block.indices[i] = 0;
+  }
+
+  if (max_value == min_value) {
+    return block;
+  }
+
+  /* Eight value mode, index 0 and 1 are the endpoints followed by 6 interpolated values. */
+  int palette[8];
+  palette[0] = max_value;
+  palette[1] = min_value;
+  for (int index = 2; index < 8; index++) {
+    palette[index] = ((8 - index) * max_value + (index - 1) * min_value + 3) / 7;
+  }
+
+  uint64_t bits = 0;
+  for (int i = 0; i < 16; i++) {
+    int best_index = 0;
+    int best_distance = INT_MAX;
+    for (int index = 0; index < 8; index++) {
+      const int distance = abs(int(values[i]) - palette[index]);
+      if (distance < best_distance) {
+        best_distance = distance;
+        best_index = index;
+      }
+    }
+    bits |= uint64_t(best_index) << (3 * i);
+  }
+
+  for (int i = 0; i < 6; i++) {
+    block.indices[i] = uchar(bits >> (8 * i));
+  }
+
+  return block;
+}
+
+/* Compress all blocks, in parallel over block rows. */
+template<typename PixelT, typename BlockT, typename EncodeFunc>
+void compress_blocks(const PixelT *pixels,
+                     const size_t width,
+                     const size_t height,
+                     BlockT *blocks,
+                     const EncodeFunc &encode)
+{
+  const size_t blocks_x = divide_up(width, 4);
+  const size_t blocks_y = divide_up(height, 4);
+
+  parallel_for(size_t(0), blocks_y, [&](const size_t block_y) {
+    for (size_t block_x = 0; block_x < blocks_x; block_x++) {
+      PixelT block_pixels[16];
+      block_gather(pixels, width, height, block_x, block_y, block_pixels);
+      blocks[block_y * blocks_x + block_x] = encode(block_pixels);
+    }
+  });
+}
+
+}  // namespace
+
+void texture_compress_bc1(const uchar4 *pixels,
+                          const size_t width,
+                          const size_t height,
+                          TextureBlockBC1 *blocks)
+{
+  compress_blocks(pixels, width, height, blocks, encode_bc1);
+}
+
+void texture_compress_bc3(const uchar4 *pixels,
+                          const size_t width,
+                          const size_t height,
+                          TextureBlockBC3 *blocks)
+{
+  compress_blocks(pixels, width, height, blocks, [](const uchar4 block_pixels[16]) {
+    uchar alpha[16];
+    for (int i = 0; i < 16; i++) {
+      alpha[i] = block_pixels[i].w;
+    }
+
+    TextureBlockBC3 block;
+    block.alpha = encode_bc4(alpha);
+    block.color = encode_bc1(block_pixels);
+    return block;
+  });
+}
+
+void texture_compress_bc4(const uchar *pixels,
+                          const size_t width,
+                          const size_t height,
+                          TextureBlockBC4 *blocks)
+{
+  compress_blocks(pixels, width, height, blocks, encode_bc4);
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,136 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#ifndef __UTIL_TEXTURE_COMPRESS_H__
+#define __UTIL_TEXTURE_COMPRESS_H__
+
+#include "util/math.h"
+#include "util/texture.h"
+#include "util/types.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Block compression of 8 bit textures, with the same layout as the BC1, BC3 and BC4 formats of
+ * GPUs. Images are split in blocks of 4x4 pixels, which store two endpoints and an index per
+ * pixel to choose between values interpolated from the endpoints. A pixel is decoded from its
+ * own block only, so the textures can be sampled without decompressing them first. */
+
+/* RGB with two RGB565 endpoints and 2 bit indices, 8 bytes for 16 pixels. */
+typedef struct TextureBlockBC1 {
+  uint16_t color0;
+  uint16_t color1;
+  uint32_t indices;
+} TextureBlockBC1;
+
+/* Single channel with two 8 bit endpoints and 3 bit indices, 8 bytes for 16 pixels. */
+typedef struct TextureBlockBC4 {
+  uchar value0;
+  uchar value1;
+  uchar indices[6];
+} TextureBlockBC4;
+
+/* RGBA as BC4 alpha followed by BC1 color, 16 bytes for 16 pixels. */
+typedef struct TextureBlockBC3 {
+  TextureBlockBC4 alpha;
+  TextureBlockBC1 color;
+} TextureBlockBC3;
+
+ccl_device_inline bool texture_is_block_compressed(const uint data_type)
+{
+  return (data_type == IMAGE_DATA_TYPE_BC1 || data_type == IMAGE_DATA_TYPE_BC3 ||
+          data_type == IMAGE_DATA_TYPE_BC4);
+}
+
+ccl_device_inline float3 texture_block_rgb565_to_float3(const uint color)
+{
+  return make_float3(((color >> 11) & 31) * (1.0f / 31.0f),
+                     ((color >> 5) & 63) * (1.0f / 63.0f),
+                     (color & 31) * (1.0f / 31.0f));
+}
+
+/* Decode pixel x, y of the block. Blocks with color0 <= color1 have a transparent black index,
+ * unless they are part of a BC3 block. */
+ccl_device_inline float4 texture_block_bc1_decode(const TextureBlockBC1 &block,
+                                                  const int x,
+                                                  const int y,
+                                                  const bool use_transparent = true)
+{
+  const uint index = (block.indices >> (2 * (y * 4 + x))) & 3;
+  const float3 color0 = texture_block_rgb565_to_float3(block.color0);
+  const float3 color1 = texture_block_rgb565_to_float3(block.color1);
+
+  float t;
+  if (block.color0 > block.color1 || !use_transparent) {
+    const float weights[4] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+    t = weights[index];
+  }
+  else {
+    if (index == 3) {
+      return zero_float4();
+    }
+    const float weights[3] = {0.0f, 1.0f, 0.5f};
+    t = weights[index];
+  }
+
+  return float3_to_float4(color0 + t * (color1 - color0), 1.0f);
+}
+
+ccl_device_inline float texture_block_bc4_decode(const TextureBlockBC4 &block,
+                                                 const int x,
+                                                 const int y)
+{
+  /* 3 bit index, which can straddle two bytes. */
+  const int bit = 3 * (y * 4 + x);
+  const int byte = bit >> 3;
+  const uint bits = block.indices[byte] | ((byte < 5) ? (block.indices[byte + 1] << 8) : 0);
+  const int index = (bits >> (bit & 7)) & 7;
+
+  const float value0 = block.value0 * (1.0f / 255.0f);
+  const float value1 = block.value1 * (1.0f / 255.0f);
+
+  if (index < 2) {
+    return (index == 0) ? value0 : value1;
+  }
+  if (block.value0 > block.value1) {
+    return value0 + (value1 - value0) * ((index - 1) * (1.0f / 7.0f));
+  }
+  if (index >= 6) {
+    return (index == 6) ? 0.0f : 1.0f;
+  }
+  return value0 + (value1 - value0) * ((index - 1) * (1.0f / 5.0f));
+}
+
+ccl_device_inline float4 texture_block_bc3_decode(const TextureBlockBC3 &block,
+                                                  const int x,
+                                                  const int y)
+{
+  float4 color = texture_block_bc1_decode(block.color, x, y, false);
+  color.w = texture_block_bc4_decode(block.alpha, x, y);
+  return color;
+}
+
+#ifndef __KERNEL_GPU__
+/* Number of blocks needed for an image, which need not have a size that is a multiple of 4. */
+inline size_t texture_block_count(const size_t width, const size_t height)
+{
+  return divide_up(width, 4) * divide_up(height, 4);
+}
+
+/* Compress images with 8 bit pixels, stored row by row. Blocks are stored row by row as well. */
+void texture_compress_bc1(const uchar4 *pixels,
+                          const size_t width,
+                          const size_t height,
+                          TextureBlockBC1 *blocks);
+void texture_compress_bc3(const uchar4 *pixels,
+                          const size_t width,
+                          const size_t height,
+                          TextureBlockBC3 *blocks);
+void texture_compress_bc4(const uchar *pixels,
+                          const size_t width,
+                          const size_t height,
+                          TextureBlockBC4 *blocks);
+#endif
+
+CCL_NAMESPACE_END
+
+#endif /* __UTIL_TEXTURE_COMPRESS_H__ */
@@ -0,0 +1,199 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#include "util/trace.h"
+
+#include "util/log.h"
+#include "util/path.h"
+#include "util/system.h"
+#include "util/thread.h"
+#include "util/time.h"
+#include "util/unique_ptr.h"
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+std::atomic<bool> trace_active_flag = false;
+
+namespace {
+
+struct TraceEvent {
+  const char *name;
+  const char *category;
+  double time_begin;
+  double time_end;
+  string detail;
+};
+
+/* Events of a single thread. The mutex is only contended while the trace is written. */
+struct TraceThreadBuffer {
+  thread_mutex mutex;
+  vector<TraceEvent> events;
+  int thread_index = 0;
+};
+
+struct TraceState {
+  thread_mutex mutex;
+  string filepath;
+  double time_start = 0.0;
+
+  /* Buffers of all threads which recorded events, kept after threads exit. Trace sessions only
+   * clear the events, so that threads can keep the pointer to their buffer. */
+  vector<unique_ptr<TraceThreadBuffer>> buffers;
+};
+
+TraceState &trace_state()
+{
+  static TraceState state;
+  return state;
+}
+
+TraceThreadBuffer *trace_thread_buffer()
+{
+  static thread_local TraceThreadBuffer *buffer = nullptr;
+  if (buffer == nullptr) {
+    TraceState &state = trace_state();
+    thread_scoped_lock lock(state.mutex);
+    state.buffers.push_back(make_unique<TraceThreadBuffer>());
+    buffer = state.buffers.back().get();
+    buffer->thread_index = int(state.buffers.size());
+  }
+  return buffer;
+}
+
+void trace_write_string(FILE *file, const char *str)
+{
+  fputc('"', file);
+  for (const char *c = str; *c; c++) {
+    if (*c == '"' || *c == '\\') {
+      fputc('\\', file);
+      fputc(*c, file);
+    }
+    else if (uchar(*c) < 0x20) {
+      fprintf(file, "\\u%04x", uchar(*c));
+    }
+    else {
+      fputc(*c, file);
+    }
+  }
+  fputc('"', file);
+}
+
+}  // namespace
+
+bool trace_begin(const string &filepath)
+{
+  TraceState &state = trace_state();
+  thread_scoped_lock lock(state.mutex);
+
+  if (trace_active()) {
+    return false;
+  }
+
+  for (unique_ptr<TraceThreadBuffer> &buffer : state.buffers) {
+    thread_scoped_lock buffer_lock(buffer->mutex);
+    buffer->events.clear();
+  }
+
+  state.filepath = filepath;
+  state.time_start = time_dt();
+  trace_active_flag = true;
+
+  VLOG_INFO << "Tracing to " << filepath;
+
+  return true;
+}
+
+bool trace_end()
+{
+  TraceState &state = trace_state();
+  thread_scoped_lock lock(state.mutex);
+
+  if (!trace_active()) {
+    return true;
+  }
+  trace_active_flag = false;
+
+  FILE *file = path_fopen(state.filepath, "wb");
+  if (!file) {
+    LOG(ERROR) << "Error opening trace file " << state.filepath;
+    return false;
+  }
+
+  const int process_id = int(system_self_process_id());
+
+  fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+  fprintf(file,
+          "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"Cycles\"}}",
+          process_id);
+
+  size_t num_events = 0;
+  for (unique_ptr<TraceThreadBuffer> &buffer : state.buffers) {
+    thread_scoped_lock buffer_lock(buffer->mutex);
+    for (const TraceEvent &event : buffer->events) {
+      /* Complete events, with times in microseconds. */
+      fprintf(file, ",\n{\"name\":");
+      trace_write_string(file, event.name);
+      fprintf(file, ",\"cat\":");
+      trace_write_string(file, event.category);
+      fprintf(file,
+              ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d",
+              (event.time_begin - state.time_start) * 1e6,
+              (event.time_end - event.time_begin) * 1e6,
+              process_id,
+              buffer->thread_index);
+      if (!event.detail.empty()) {
+        fprintf(file, ",\"args\":{\"detail\":");
+        trace_write_string(file, event.detail.c_str());
+        fprintf(file, "}");
+      }
+      fprintf(file, "}");
+    }
+    num_events += buffer->events.size();
+    buffer->events.clear();
+    buffer->events.shrink_to_fit();
+  }
+
+  fprintf(file, "\n]}\n");
+
+  const bool success = (ferror(file) == 0);
+  fclose(file);
+
+  if (!success) {
+    LOG(ERROR) << "Error writing trace file " << state.filepath;
+    return false;
+  }
+
+  VLOG_INFO << "Wrote " << num_events << " trace events to " << state.filepath;
+
+  return true;
+}
+
+void trace_add_event(const char *name,
+                     const char *category,
+                     const double time_begin,
+                     const double time_end,
+                     const string &detail)
+{
+  if (!trace_active()) {
+    return;
+  }
+
+  TraceThreadBuffer *buffer = trace_thread_buffer();
+  thread_scoped_lock lock(buffer->mutex);
+  buffer->events.push_back({name, category, time_begin, time_end, detail});
+}
+
+void TraceScope::begin()
+{
+  time_begin_ = time_dt();
+  is_recording_ = true;
+}
+
+void TraceScope::end_recording()
+{
+  trace_add_event(name_, category_, time_begin_, time_dt(), detail_);
+  is_recording_ = false;
+}
+
+CCL_NAMESPACE_END
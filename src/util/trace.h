@@ -0,0 +1,101 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#ifndef __UTIL_TRACE_H__
+#define __UTIL_TRACE_H__
+
+#include <atomic>
+
+#include "util/string.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Timeline tracing.
+ *
+ * Records begin and end times of scopes with the thread they ran on, and writes them as Chrome
+ * trace event JSON which can be viewed in Perfetto or chrome://tracing. Unlike the update
+ * statistics this shows ordering and overlap between threads.
+ *
+ * Events are appended to buffers of the thread that records them. When tracing is not active a
+ * scope only costs a relaxed atomic load. Names and categories must be string literals, details
+ * are copied. */
+
+extern std::atomic<bool> trace_active_flag;
+
+inline bool trace_active()
+{
+  return trace_active_flag.load(std::memory_order_relaxed);
+}
+
+/* Start recording events, which are written to the file when tracing ends. Returns false if
+ * tracing is already active. */
+bool trace_begin(const string &filepath);
+
+/* Stop recording and write the trace file. Returns false if the file could not be written. */
+bool trace_end();
+
+/* Add an event with begin and end time from time_dt(). */
+void trace_add_event(const char *name,
+                     const char *category,
+                     const double time_begin,
+                     const double time_end,
+                     const string &detail = string());
+
+class TraceScope {
+ public:
+  TraceScope(const char *name, const char *category) : name_(name), category_(category)
+  {
+    if (trace_active()) {
+      begin();
+    }
+  }
+
+  TraceScope(const char *name, const char *category, const string &detail)
+      : name_(name), category_(category)
+  {
+    if (trace_active()) {
+      detail_ = detail;
+      begin();
+    }
+  }
+
+  ~TraceScope()
+  {
+    end();
+  }
+
+  /* End the current event and begin the next one, for tracing a sequence of steps. */
+  void next(const char *name)
+  {
+    end();
+    name_ = name;
+    detail_.clear();
+    if (trace_active()) {
+      begin();
+    }
+  }
+
+ protected:
+  void begin();
+  void end()
+  {
+    if (is_recording_) {
+      end_recording();
+    }
+  }
+  void end_recording();
+
+  const char *name_;
+  const char *category_;
+  string detail_;
+  double time_begin_ = 0.0;
+  bool is_recording_ = false;
+};
+
+#define TRACE_SCOPE_NAME_JOIN(a, b) a##b
+#define TRACE_SCOPE_NAME(line) TRACE_SCOPE_NAME_JOIN(trace_scope_, line)
+#define TRACE_SCOPE(...) TraceScope TRACE_SCOPE_NAME(__LINE__)(__VA_ARGS__)
+
+CCL_NAMESPACE_END
+
+#endif /* __UTIL_TRACE_H__ */